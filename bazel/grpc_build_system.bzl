@@ -155,6 +155,13 @@ def grpc_cc_library(
     if language.upper() == "C":
         copts = copts + if_not_windows(["-std=c99"])
     linkopts = if_not_windows(["-pthread"]) + if_windows(["-defaultlib:ws2_32.lib"])
+    linkopts = linkopts + select({
+        "//:grpc_zstd": ["-lzstd"],
+        "//conditions:default": [],
+    }) + select({
+        "//:grpc_lz4": ["-llz4"],
+        "//conditions:default": [],
+    })
     if select_deps:
         for select_deps_entry in select_deps:
             deps += select(select_deps_entry)
@@ -166,6 +173,14 @@ def grpc_cc_library(
                       "//:grpc_no_ares": ["GRPC_ARES=0"],
                       "//conditions:default": [],
                   }) +
+                  select({
+                      "//:grpc_zstd": ["GRPC_HAVE_ZSTD=1"],
+                      "//conditions:default": [],
+                  }) +
+                  select({
+                      "//:grpc_lz4": ["GRPC_HAVE_LZ4=1"],
+                      "//conditions:default": [],
+                  }) +
                   select({
                       "//:remote_execution": ["GRPC_PORT_ISOLATED_RUNTIME=1"],
                       "//conditions:default": [],
@@ -0,0 +1,29 @@
+# Copyright 2022 gRPC authors.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+# lz4 is optional: with the default "none" provider, the lz4 message
+# compression algorithm is not built in and is never advertised to peers.
+
+if(gRPC_LZ4_PROVIDER STREQUAL "package")
+  # lz4 installation directory can be configured by setting LZ4_ROOT_DIR
+  find_path(LZ4_INCLUDE_DIR lz4frame.h HINTS ${LZ4_ROOT_DIR}/include)
+  find_library(LZ4_LIBRARY lz4 HINTS ${LZ4_ROOT_DIR}/lib)
+  if(NOT LZ4_INCLUDE_DIR OR NOT LZ4_LIBRARY)
+    message(FATAL_ERROR "gRPC_LZ4_PROVIDER is \"package\" but lz4 was not found")
+  endif()
+
+  add_definitions(-DGRPC_HAVE_LZ4=1)
+  include_directories(${LZ4_INCLUDE_DIR})
+  set(_gRPC_LZ4_LIBRARIES ${LZ4_LIBRARY})
+endif()
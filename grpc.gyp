@@ -361,9 +361,11 @@
       'type': 'static_library',
       'dependencies': [
         'absl/container:flat_hash_map',
+        'absl/container:flat_hash_set',
         'absl/container:inlined_vector',
         'absl/functional:bind_front',
         'absl/hash:hash',
+        'absl/numeric:bits',
         'absl/status:statusor',
         'absl/types:variant',
         'absl/utility:utility',
@@ -396,11 +398,14 @@
         'src/core/ext/filters/client_channel/lb_policy/grpclb/grpclb_client_stats.cc',
         'src/core/ext/filters/client_channel/lb_policy/grpclb/load_balancer_api.cc',
         'src/core/ext/filters/client_channel/lb_policy/oob_backend_metric.cc',
+        'src/core/ext/filters/client_channel/lb_policy/least_request/least_request.cc',
+        'src/core/ext/filters/client_channel/lb_policy/outlier_detection/outlier_detection.cc',
         'src/core/ext/filters/client_channel/lb_policy/pick_first/pick_first.cc',
         'src/core/ext/filters/client_channel/lb_policy/priority/priority.cc',
         'src/core/ext/filters/client_channel/lb_policy/ring_hash/ring_hash.cc',
         'src/core/ext/filters/client_channel/lb_policy/rls/rls.cc',
         'src/core/ext/filters/client_channel/lb_policy/round_robin/round_robin.cc',
+        'src/core/ext/filters/client_channel/lb_policy/weighted_round_robin/weighted_round_robin.cc',
         'src/core/ext/filters/client_channel/lb_policy/weighted_target/weighted_target.cc',
         'src/core/ext/filters/client_channel/lb_policy/xds/cds.cc',
         'src/core/ext/filters/client_channel/lb_policy/xds/xds_cluster_impl.cc',
@@ -798,8 +803,19 @@
         'src/core/lib/event_engine/default_event_engine_factory.cc',
         'src/core/lib/event_engine/event_engine.cc',
         'src/core/lib/event_engine/memory_allocator.cc',
+        'src/core/lib/event_engine/posix_engine/ev_epoll1_linux.cc',
+        'src/core/lib/event_engine/posix_engine/io_uring_endpoint.cc',
+        'src/core/lib/event_engine/posix_engine/io_uring_poller.cc',
+        'src/core/lib/event_engine/posix_engine/lockfree_event.cc',
+        'src/core/lib/event_engine/posix_engine/posix_endpoint.cc',
+        'src/core/lib/event_engine/posix_engine/posix_engine.cc',
+        'src/core/lib/event_engine/posix_engine/posix_engine_listener.cc',
+        'src/core/lib/event_engine/posix_engine/tcp_socket_utils.cc',
+        'src/core/lib/event_engine/posix_engine/timer.cc',
+        'src/core/lib/event_engine/posix_engine/timer_manager.cc',
         'src/core/lib/event_engine/resolved_address.cc',
         'src/core/lib/event_engine/sockaddr.cc',
+        'src/core/lib/event_engine/thread_pool.cc',
         'src/core/lib/gprpp/time.cc',
         'src/core/lib/http/format_request.cc',
         'src/core/lib/http/httpcli.cc',
@@ -883,6 +899,7 @@
         'src/core/lib/iomgr/timer_generic.cc',
         'src/core/lib/iomgr/timer_heap.cc',
         'src/core/lib/iomgr/timer_manager.cc',
+        'src/core/lib/iomgr/timer_wheel.cc',
         'src/core/lib/iomgr/unix_sockets_posix.cc',
         'src/core/lib/iomgr/unix_sockets_posix_noop.cc',
         'src/core/lib/iomgr/wakeup_fd_eventfd.cc',
@@ -902,6 +919,7 @@
         'src/core/lib/resource_quota/api.cc',
         'src/core/lib/resource_quota/arena.cc',
         'src/core/lib/resource_quota/memory_quota.cc',
+        'src/core/lib/resource_quota/read_slab_pool.cc',
         'src/core/lib/resource_quota/resource_quota.cc',
         'src/core/lib/resource_quota/thread_quota.cc',
         'src/core/lib/resource_quota/trace.cc',
@@ -1110,9 +1128,11 @@
       'type': 'static_library',
       'dependencies': [
         'absl/container:flat_hash_map',
+        'absl/container:flat_hash_set',
         'absl/container:inlined_vector',
         'absl/functional:bind_front',
         'absl/hash:hash',
+        'absl/numeric:bits',
         'absl/status:statusor',
         'absl/types:variant',
         'absl/utility:utility',
@@ -1145,11 +1165,14 @@
         'src/core/ext/filters/client_channel/lb_policy/grpclb/grpclb_client_stats.cc',
         'src/core/ext/filters/client_channel/lb_policy/grpclb/load_balancer_api.cc',
         'src/core/ext/filters/client_channel/lb_policy/oob_backend_metric.cc',
+        'src/core/ext/filters/client_channel/lb_policy/least_request/least_request.cc',
+        'src/core/ext/filters/client_channel/lb_policy/outlier_detection/outlier_detection.cc',
         'src/core/ext/filters/client_channel/lb_policy/pick_first/pick_first.cc',
         'src/core/ext/filters/client_channel/lb_policy/priority/priority.cc',
         'src/core/ext/filters/client_channel/lb_policy/ring_hash/ring_hash.cc',
         'src/core/ext/filters/client_channel/lb_policy/rls/rls.cc',
         'src/core/ext/filters/client_channel/lb_policy/round_robin/round_robin.cc',
+        'src/core/ext/filters/client_channel/lb_policy/weighted_round_robin/weighted_round_robin.cc',
         'src/core/ext/filters/client_channel/lb_policy/weighted_target/weighted_target.cc',
         'src/core/ext/filters/client_channel/lb_policy_registry.cc',
         'src/core/ext/filters/client_channel/local_subchannel_pool.cc',
@@ -1256,8 +1279,19 @@
         'src/core/lib/event_engine/default_event_engine_factory.cc',
         'src/core/lib/event_engine/event_engine.cc',
         'src/core/lib/event_engine/memory_allocator.cc',
+        'src/core/lib/event_engine/posix_engine/ev_epoll1_linux.cc',
+        'src/core/lib/event_engine/posix_engine/io_uring_endpoint.cc',
+        'src/core/lib/event_engine/posix_engine/io_uring_poller.cc',
+        'src/core/lib/event_engine/posix_engine/lockfree_event.cc',
+        'src/core/lib/event_engine/posix_engine/posix_endpoint.cc',
+        'src/core/lib/event_engine/posix_engine/posix_engine.cc',
+        'src/core/lib/event_engine/posix_engine/posix_engine_listener.cc',
+        'src/core/lib/event_engine/posix_engine/tcp_socket_utils.cc',
+        'src/core/lib/event_engine/posix_engine/timer.cc',
+        'src/core/lib/event_engine/posix_engine/timer_manager.cc',
         'src/core/lib/event_engine/resolved_address.cc',
         'src/core/lib/event_engine/sockaddr.cc',
+        'src/core/lib/event_engine/thread_pool.cc',
         'src/core/lib/gprpp/time.cc',
         'src/core/lib/http/format_request.cc',
         'src/core/lib/http/httpcli.cc',
@@ -1340,6 +1374,7 @@
         'src/core/lib/iomgr/timer_generic.cc',
         'src/core/lib/iomgr/timer_heap.cc',
         'src/core/lib/iomgr/timer_manager.cc',
+        'src/core/lib/iomgr/timer_wheel.cc',
         'src/core/lib/iomgr/unix_sockets_posix.cc',
         'src/core/lib/iomgr/unix_sockets_posix_noop.cc',
         'src/core/lib/iomgr/wakeup_fd_eventfd.cc',
@@ -1358,6 +1393,7 @@
         'src/core/lib/resource_quota/api.cc',
         'src/core/lib/resource_quota/arena.cc',
         'src/core/lib/resource_quota/memory_quota.cc',
+        'src/core/lib/resource_quota/read_slab_pool.cc',
         'src/core/lib/resource_quota/resource_quota.cc',
         'src/core/lib/resource_quota/thread_quota.cc',
         'src/core/lib/resource_quota/trace.cc',
@@ -68,6 +68,20 @@ GRPCAPI void grpc_compression_options_disable_algorithm(
 GRPCAPI int grpc_compression_options_is_algorithm_enabled(
     const grpc_compression_options* opts, grpc_compression_algorithm algorithm);
 
+/** EXPERIMENTAL. Registers a zstd dictionary of \a dictionary_size bytes at
+ * \a dictionary for GRPC_COMPRESS_ZSTD messages of \a method (a path such as
+ * "/package.Service/Method"), or, if \a method is NULL, for the messages of
+ * all methods that have no dictionary of their own. The dictionary must be
+ * one trained by zstd, whose header carries a dictionary ID: compressed
+ * messages refer to the dictionary by that ID, so the peer needs to register
+ * the same dictionary (for any method) to decompress them. The data is
+ * copied. Registering another dictionary for the same method replaces it for
+ * future messages. Returns 1 on success, or 0 if the dictionary is invalid or
+ * gRPC was built without zstd. */
+GRPCAPI int grpc_compression_register_zstd_dictionary(const char* method,
+                                                      const void* dictionary,
+                                                      size_t dictionary_size);
+
 #ifdef __cplusplus
 }
 #endif
@@ -36,7 +36,8 @@ namespace experimental {
 class SliceBuffer {
  public:
   SliceBuffer() { abort(); }
-  explicit SliceBuffer(grpc_slice_buffer*) { abort(); }
+  explicit SliceBuffer(grpc_slice_buffer* slice_buffer)
+      : slice_buffer_(slice_buffer) {}
 
   grpc_slice_buffer* RawSliceBuffer() { return slice_buffer_; }
 
@@ -134,6 +134,19 @@ GRPCAPI grpc_event grpc_completion_queue_next(grpc_completion_queue* cq,
                                               gpr_timespec deadline,
                                               void* reserved);
 
+/*********** EXPERIMENTAL API ************/
+/** Like grpc_completion_queue_next, but after an event is available also
+    returns up to \a max_events - 1 further events that are already queued,
+    without blocking for them.
+
+    Returns the number of events stored in \a events: either one or more
+    GRPC_OP_COMPLETE events, or a single GRPC_QUEUE_TIMEOUT or
+    GRPC_QUEUE_SHUTDOWN event. \a max_events must be positive. */
+GRPCAPI int grpc_completion_queue_next_batch(grpc_completion_queue* cq,
+                                             grpc_event* events, int max_events,
+                                             gpr_timespec deadline,
+                                             void* reserved);
+
 /** Blocks until an event with tag 'tag' is available, the completion queue is
     being shutdown or deadline is reached.
 
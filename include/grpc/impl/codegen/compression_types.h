@@ -49,18 +49,21 @@ extern "C" {
  * GRPC_COMPRESS_NONE, the next bit to GRPC_COMPRESS_DEFLATE, etc.
  * Unset bits disable support for the algorithm. By default all algorithms are
  * supported. It's not possible to disable GRPC_COMPRESS_NONE (the attempt will
- * be ignored). */
+ * be ignored). Algorithms whose library was not built into gRPC (zstd, lz4)
+ * are never enabled, whatever the bitset says. */
 #define GRPC_COMPRESSION_CHANNEL_ENABLED_ALGORITHMS_BITSET \
   "grpc.compression_enabled_algorithms_bitset"
 /** \} */
 
 /** The various compression algorithms supported by gRPC (not sorted by
- * compression level) */
+ * compression level). GRPC_COMPRESS_ZSTD and GRPC_COMPRESS_LZ4 are only
+ * available if gRPC was built with the zstd and lz4 libraries, respectively. */
 typedef enum {
   GRPC_COMPRESS_NONE = 0,
   GRPC_COMPRESS_DEFLATE,
   GRPC_COMPRESS_GZIP,
-  /* TODO(ctiller): snappy */
+  GRPC_COMPRESS_ZSTD,
+  GRPC_COMPRESS_LZ4,
   GRPC_COMPRESS_ALGORITHMS_COUNT
 } grpc_compression_algorithm;
 
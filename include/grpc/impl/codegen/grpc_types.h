@@ -195,12 +195,31 @@ typedef struct {
 /** How much memory to use for hpack encoding. Int valued, bytes. */
 #define GRPC_ARG_HTTP2_HPACK_TABLE_SIZE_ENCODER \
   "grpc.http2.hpack_table_size.encoder"
+/** If non-zero, only add headers to the hpack encoder's dynamic table once
+    they have been seen repeatedly, and also consider indexing application
+    metadata. Reduces header bytes when high-cardinality values would
+    otherwise evict stable ones. Int valued, defaults to 0. */
+#define GRPC_ARG_HTTP2_HPACK_FREQUENCY_ADMISSION \
+  "grpc.http2.hpack_frequency_admission"
+/** Maximum number of DATA bytes a stream may write in one turn before the
+    http2 transport moves on to the next writable stream of the same write
+    priority (deficit round robin). 0 lets each stream write its whole flow
+    control window per turn. Int valued, bytes, defaults to 16384. */
+#define GRPC_ARG_HTTP2_WRITE_QUANTUM_BYTES "grpc.http2.write_quantum_bytes"
 /** How big a frame are we willing to receive via HTTP2.
     Min 16384, max 16777215. Larger values give lower CPU usage for large
     messages, but more head of line blocking for small messages. */
 #define GRPC_ARG_HTTP2_MAX_FRAME_SIZE "grpc.http2.max_frame_size"
 /** Should BDP probing be performed? */
 #define GRPC_ARG_HTTP2_BDP_PROBE "grpc.http2.bdp_probe"
+/** If non-zero, size HTTP2 flow control windows from the delivery rate and
+    minimum round trip time measured by BDP pings, growing them by up to ~3x
+    per round trip until the bandwidth estimate stops increasing, and shrink
+    them as memory pressure rises. Ramps up faster than the default estimator
+    on high latency links. Has no effect when BDP probing is disabled. Int
+    valued, defaults to 0. */
+#define GRPC_ARG_HTTP2_DELIVERY_RATE_FLOW_CONTROL \
+  "grpc.http2.delivery_rate_flow_control"
 /** (DEPRECATED) Does not have any effect.
     Earlier, this arg configured the minimum time between successive ping frames
     without receiving any data/header frame, Int valued, milliseconds. This put
@@ -231,6 +250,12 @@ typedef struct {
 /** How much data are we willing to queue up per stream if
     GRPC_WRITE_BUFFER_HINT is set? This is an upper bound */
 #define GRPC_ARG_HTTP2_WRITE_BUFFER_SIZE "grpc.http2.write_buffer_size"
+/** How long, in milliseconds, may data queued up because
+    GRPC_WRITE_BUFFER_HINT is set wait before it is written anyway? Lets many
+    small buffered messages share frames and writes without holding them back
+    indefinitely. Defaults to 0, which waits for the next unbuffered write. */
+#define GRPC_ARG_HTTP2_WRITE_BUFFER_MAX_DELAY_MS \
+  "grpc.http2.write_buffer_max_delay_ms"
 /** Should we allow receipt of true-binary data on http2 connections?
     Defaults to on (1) */
 #define GRPC_ARG_HTTP2_ENABLE_TRUE_BINARY "grpc.http2.true_binary"
@@ -267,6 +292,14 @@ typedef struct {
 /** The timeout used on servers for finishing handshaking on an incoming
     connection.  Defaults to 120 seconds. */
 #define GRPC_ARG_SERVER_HANDSHAKE_TIMEOUT_MS "grpc.server_handshake_timeout_ms"
+/** The maximum number of incoming connections a server handshakes at once.
+    Up to as many connections again wait, in accept order, for a running
+    handshake to finish; they are closed if their handshake timeout, counted
+    from the time they were accepted, expires first. Connections accepted
+    while that many are waiting are closed right away. Defaults to 0, which
+    means no limit. */
+#define GRPC_ARG_SERVER_MAX_CONCURRENT_HANDSHAKES \
+  "grpc.server_max_concurrent_handshakes"
 /** This *should* be used for testing only.
     The caller of the secure_channel_create functions may override the target
     name used for SSL host name checking using this channel argument which is of
@@ -287,6 +320,20 @@ typedef struct {
  *        can break old binaries that don't support larger than 1MiB frame
  *        size. */
 #define GRPC_ARG_TSI_MAX_FRAME_SIZE "grpc.tsi.max_frame_size"
+/** If non-zero, hand the record protection negotiated by the security
+ *  handshake to the kernel (kTLS on Linux) when the security protocol and the
+ *  kernel support it, so that data is encrypted and decrypted as it is
+ *  written to and read from the socket. Connections that cannot be offloaded
+ *  use the regular frame protector. Offload is skipped on connections with
+ *  GRPC_ARG_TCP_TX_ZEROCOPY_ENABLED, which the kernel cannot combine with it.
+ *  Defaults to 0. */
+#define GRPC_ARG_TSI_KERNEL_OFFLOAD "grpc.tsi.kernel_offload"
+/** If non-zero, run the steps of the security handshake that do public key
+ *  cryptography on a dedicated thread pool, sized to the number of cores,
+ *  instead of on the poller thread that received the handshake bytes. This
+ *  keeps a burst of new connections from stalling I/O on established ones.
+ *  Defaults to 0. */
+#define GRPC_ARG_TSI_HANDSHAKE_OFFLOAD "grpc.tsi.handshake_offload"
 /** Maximum metadata size, in bytes. Note this limit applies to the max sum of
     all metadata key-value entries in a batch of headers. */
 #define GRPC_ARG_MAX_METADATA_SIZE "grpc.max_metadata_size"
@@ -525,12 +572,19 @@ typedef enum grpc_call_error {
 #define GRPC_INITIAL_METADATA_WAIT_FOR_READY_EXPLICITLY_SET (0x00000080u)
 /** Signal that the initial metadata should be corked */
 #define GRPC_INITIAL_METADATA_CORKED (0x00000100u)
+/** Signal that the call's outgoing data is latency sensitive, and should be
+    written ahead of other calls sharing the same connection */
+#define GRPC_INITIAL_METADATA_WRITE_PRIORITY_HIGH (0x00000200u)
+/** Signal that the call's outgoing data is bulk traffic, and should only be
+    written when no other call on the same connection has data to write */
+#define GRPC_INITIAL_METADATA_WRITE_PRIORITY_LOW (0x00000400u)
 
 /** Mask of all valid flags */
 #define GRPC_INITIAL_METADATA_USED_MASK                                  \
   (GRPC_INITIAL_METADATA_WAIT_FOR_READY_EXPLICITLY_SET |                 \
    GRPC_INITIAL_METADATA_WAIT_FOR_READY | GRPC_INITIAL_METADATA_CORKED | \
-   GRPC_WRITE_THROUGH)
+   GRPC_INITIAL_METADATA_WRITE_PRIORITY_HIGH |                           \
+   GRPC_INITIAL_METADATA_WRITE_PRIORITY_LOW | GRPC_WRITE_THROUGH)
 
 /** A single metadata element */
 typedef struct grpc_metadata {
@@ -785,8 +839,9 @@ typedef struct grpc_completion_queue_functor {
   struct grpc_completion_queue_functor* internal_next;
 } grpc_completion_queue_functor;
 
-#define GRPC_CQ_CURRENT_VERSION 2
+#define GRPC_CQ_CURRENT_VERSION 3
 #define GRPC_CQ_VERSION_MINIMUM_FOR_CALLBACKABLE 2
+#define GRPC_CQ_VERSION_MINIMUM_FOR_SHARDING 3
 typedef struct grpc_completion_queue_attributes {
   /** The version number of this structure. More fields might be added to this
      structure in future. */
@@ -804,6 +859,17 @@ typedef struct grpc_completion_queue_attributes {
   grpc_completion_queue_functor* cq_shutdown_cb;
 
   /* END OF VERSION 2 CQ ATTRIBUTES */
+
+  /* START OF VERSION 3 CQ ATTRIBUTES */
+  /** EXPERIMENTAL: for GRPC_CQ_NEXT completion queues, the number of
+   * sub-queues to spread completed events over (capped at the number of
+   * cores). Events are queued on the sub-queue of the core that completed
+   * them, and grpc_completion_queue_next drains the sub-queue of the calling
+   * thread's core first, only taking events from the others when it is
+   * empty. 0 or 1 uses a single queue. */
+  int cq_num_shards;
+
+  /* END OF VERSION 3 CQ ATTRIBUTES */
 } grpc_completion_queue_attributes;
 
 /** The completion queue factory structure is opaque to the callers of grpc */
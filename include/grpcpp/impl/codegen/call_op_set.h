@@ -138,6 +138,12 @@ class WriteOptions {
 
   /// corked bit: aliases set_buffer_hint currently, with the intent that
   /// set_buffer_hint will be removed in the future
+  ///
+  /// With the chttp2 transport a corked write usually completes as soon as it
+  /// is queued. Queued messages are packed together and sent by the next
+  /// uncorked write on the stream, when the call finishes, once more than
+  /// GRPC_ARG_HTTP2_WRITE_BUFFER_SIZE bytes are queued, or after
+  /// GRPC_ARG_HTTP2_WRITE_BUFFER_MAX_DELAY_MS if that is set.
   inline WriteOptions& set_corked() {
     SetBit(GRPC_WRITE_BUFFER_HINT);
     return *this;
@@ -2273,6 +2273,12 @@ grpc_error_handle ClientChannel::CallData::ApplyServiceConfigToCallLocked(
           *send_initial_metadata_flags &= ~GRPC_INITIAL_METADATA_WAIT_FOR_READY;
         }
       }
+      // Likewise for the write priority.
+      if (!(*send_initial_metadata_flags &
+            (GRPC_INITIAL_METADATA_WRITE_PRIORITY_HIGH |
+             GRPC_INITIAL_METADATA_WRITE_PRIORITY_LOW))) {
+        *send_initial_metadata_flags |= method_params->write_priority_flag();
+      }
     }
     // Set the dynamic filter stack.
     dynamic_filters_ = chand->dynamic_filters_;
@@ -0,0 +1,1123 @@
+//
+// Copyright 2022 gRPC authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include <grpc/support/port_platform.h>
+
+#include <inttypes.h>
+
+#include <atomic>
+#include <cmath>
+#include <map>
+#include <set>
+
+#include "absl/random/random.h"
+#include "absl/strings/str_cat.h"
+#include "absl/types/optional.h"
+
+#include <grpc/grpc.h>
+
+#include "src/core/ext/filters/client_channel/lb_policy.h"
+#include "src/core/ext/filters/client_channel/lb_policy/child_policy_handler.h"
+#include "src/core/ext/filters/client_channel/lb_policy_factory.h"
+#include "src/core/ext/filters/client_channel/lb_policy_registry.h"
+#include "src/core/lib/address_utils/sockaddr_utils.h"
+#include "src/core/lib/channel/channel_args.h"
+#include "src/core/lib/gprpp/orphanable.h"
+#include "src/core/lib/gprpp/ref_counted_ptr.h"
+#include "src/core/lib/iomgr/timer.h"
+#include "src/core/lib/iomgr/work_serializer.h"
+#include "src/core/lib/json/json_util.h"
+
+namespace grpc_core {
+
+TraceFlag grpc_outlier_detection_lb_trace(false, "outlier_detection_lb");
+
+namespace {
+
+constexpr char kOutlierDetection[] = "outlier_detection_experimental";
+
+struct OutlierDetectionConfig {
+  Duration interval = Duration::Seconds(10);
+  Duration base_ejection_time = Duration::Seconds(30);
+  Duration max_ejection_time = Duration::Seconds(300);
+  uint32_t max_ejection_percent = 10;
+  struct SuccessRateEjection {
+    uint32_t stdev_factor = 1900;
+    uint32_t enforcement_percentage = 100;
+    uint32_t minimum_hosts = 5;
+    uint32_t request_volume = 100;
+  };
+  struct FailurePercentageEjection {
+    uint32_t threshold = 85;
+    uint32_t enforcement_percentage = 100;
+    uint32_t minimum_hosts = 5;
+    uint32_t request_volume = 50;
+  };
+  struct ConsecutiveFailureEjection {
+    uint32_t threshold = 5;
+    uint32_t enforcement_percentage = 100;
+  };
+  absl::optional<SuccessRateEjection> success_rate_ejection;
+  absl::optional<FailurePercentageEjection> failure_percentage_ejection;
+  absl::optional<ConsecutiveFailureEjection> consecutive_failure_ejection;
+};
+
+// Config for outlier detection LB policy.
+class OutlierDetectionLbConfig : public LoadBalancingPolicy::Config {
+ public:
+  OutlierDetectionLbConfig(
+      OutlierDetectionConfig outlier_detection_config,
+      RefCountedPtr<LoadBalancingPolicy::Config> child_policy)
+      : outlier_detection_config_(outlier_detection_config),
+        child_policy_(std::move(child_policy)) {}
+
+  const char* name() const override { return kOutlierDetection; }
+
+  // Returns true if any ejection algorithm is configured, in which case
+  // call results must be counted and the ejection timer must run.
+  bool CountingEnabled() const {
+    return outlier_detection_config_.interval != Duration::Infinity() &&
+           (outlier_detection_config_.success_rate_ejection.has_value() ||
+            outlier_detection_config_.failure_percentage_ejection
+                .has_value() ||
+            outlier_detection_config_.consecutive_failure_ejection
+                .has_value());
+  }
+
+  const OutlierDetectionConfig& outlier_detection_config() const {
+    return outlier_detection_config_;
+  }
+
+  RefCountedPtr<LoadBalancingPolicy::Config> child_policy() const {
+    return child_policy_;
+  }
+
+ private:
+  OutlierDetectionConfig outlier_detection_config_;
+  RefCountedPtr<LoadBalancingPolicy::Config> child_policy_;
+};
+
+// Outlier detection LB policy.
+class OutlierDetectionLb : public LoadBalancingPolicy {
+ public:
+  explicit OutlierDetectionLb(Args args);
+
+  const char* name() const override { return kOutlierDetection; }
+
+  void UpdateLocked(UpdateArgs args) override;
+  void ExitIdleLocked() override;
+  void ResetBackoffLocked() override;
+
+ private:
+  class SubchannelState;
+
+  class SubchannelWrapper : public DelegatingSubchannel {
+   public:
+    SubchannelWrapper(RefCountedPtr<SubchannelState> subchannel_state,
+                      RefCountedPtr<SubchannelInterface> subchannel);
+
+    ~SubchannelWrapper() override;
+
+    void Eject();
+    void Uneject();
+
+    grpc_connectivity_state CheckConnectivityState() override;
+
+    void WatchConnectivityState(
+        grpc_connectivity_state initial_state,
+        std::unique_ptr<ConnectivityStateWatcherInterface> watcher) override;
+
+    void CancelConnectivityStateWatch(
+        ConnectivityStateWatcherInterface* watcher) override;
+
+    RefCountedPtr<SubchannelState> subchannel_state() const {
+      return subchannel_state_;
+    }
+
+   private:
+    // Reports TRANSIENT_FAILURE to the child policy while the address is
+    // ejected, and the subchannel's real state otherwise.
+    class WatcherWrapper
+        : public SubchannelInterface::ConnectivityStateWatcherInterface {
+     public:
+      WatcherWrapper(std::unique_ptr<
+                         SubchannelInterface::ConnectivityStateWatcherInterface>
+                         watcher,
+                     grpc_connectivity_state initial_state, bool ejected)
+          : watcher_(std::move(watcher)),
+            reported_state_(initial_state),
+            ejected_(ejected) {}
+
+      void Eject() {
+        ejected_ = true;
+        MaybeReportState();
+      }
+
+      void Uneject() {
+        ejected_ = false;
+        MaybeReportState();
+      }
+
+      void OnConnectivityStateChange(
+          grpc_connectivity_state new_state) override {
+        last_seen_state_ = new_state;
+        MaybeReportState();
+      }
+
+      grpc_pollset_set* interested_parties() override {
+        return watcher_->interested_parties();
+      }
+
+      ConnectivityStateWatcherInterface* watcher() const {
+        return watcher_.get();
+      }
+
+     private:
+      void MaybeReportState() {
+        if (!last_seen_state_.has_value()) return;
+        grpc_connectivity_state state =
+            ejected_ ? GRPC_CHANNEL_TRANSIENT_FAILURE : *last_seen_state_;
+        if (state == reported_state_) return;
+        reported_state_ = state;
+        watcher_->OnConnectivityStateChange(state);
+      }
+
+      std::unique_ptr<SubchannelInterface::ConnectivityStateWatcherInterface>
+          watcher_;
+      absl::optional<grpc_connectivity_state> last_seen_state_;
+      grpc_connectivity_state reported_state_;
+      bool ejected_;
+    };
+
+    RefCountedPtr<SubchannelState> subchannel_state_;
+    bool ejected_ = false;
+    // The child policy's watcher, if any.  Owned by the wrapped subchannel.
+    WatcherWrapper* watcher_wrapper_ = nullptr;
+  };
+
+  // Per-address state, shared by all subchannels for the same address.
+  // Call results are recorded from the data plane without locks; all
+  // other methods are called from within the WorkSerializer.
+  class SubchannelState : public RefCounted<SubchannelState> {
+   public:
+    struct Bucket {
+      std::atomic<uint64_t> successes{0};
+      std::atomic<uint64_t> failures{0};
+    };
+
+    SubchannelState()
+        : current_bucket_(absl::make_unique<Bucket>()),
+          backup_bucket_(absl::make_unique<Bucket>()),
+          active_bucket_(current_bucket_.get()) {}
+
+    void AddSubchannel(SubchannelWrapper* wrapper) {
+      subchannels_.insert(wrapper);
+    }
+
+    void RemoveSubchannel(SubchannelWrapper* wrapper) {
+      subchannels_.erase(wrapper);
+    }
+
+    // Called from the data plane when a call completes.
+    void AddCallResult(bool success) {
+      Bucket* bucket = active_bucket_.load(std::memory_order_relaxed);
+      if (success) {
+        bucket->successes.fetch_add(1, std::memory_order_relaxed);
+        consecutive_failures_.store(0, std::memory_order_relaxed);
+      } else {
+        bucket->failures.fetch_add(1, std::memory_order_relaxed);
+        consecutive_failures_.fetch_add(1, std::memory_order_relaxed);
+      }
+    }
+
+    // Starts counting into a fresh bucket, making the counts from the
+    // interval that just ended available via successes() and failures().
+    void RotateBucket() {
+      backup_bucket_->successes.store(0, std::memory_order_relaxed);
+      backup_bucket_->failures.store(0, std::memory_order_relaxed);
+      current_bucket_.swap(backup_bucket_);
+      active_bucket_.store(current_bucket_.get(), std::memory_order_relaxed);
+    }
+
+    uint64_t successes() const {
+      return backup_bucket_->successes.load(std::memory_order_relaxed);
+    }
+    uint64_t failures() const {
+      return backup_bucket_->failures.load(std::memory_order_relaxed);
+    }
+    uint64_t consecutive_failures() const {
+      return consecutive_failures_.load(std::memory_order_relaxed);
+    }
+
+    bool ejected() const { return ejection_time_.has_value(); }
+
+    void Eject(Timestamp time) {
+      ejection_time_ = time;
+      ++multiplier_;
+      consecutive_failures_.store(0, std::memory_order_relaxed);
+      for (SubchannelWrapper* subchannel : subchannels_) subchannel->Eject();
+    }
+
+    void Uneject() {
+      ejection_time_.reset();
+      for (SubchannelWrapper* subchannel : subchannels_) subchannel->Uneject();
+    }
+
+    // Unejects the address if its ejection period has elapsed.  The
+    // ejection period doubles with each consecutive ejection, and the
+    // multiplier decays by one for every interval the address is not
+    // ejected.  Returns true if the address was unejected.
+    bool MaybeUneject(Duration base_ejection_time, Duration max_ejection_time,
+                      Timestamp now) {
+      if (!ejection_time_.has_value()) {
+        if (multiplier_ > 0) --multiplier_;
+        return false;
+      }
+      const Duration cap = std::max(base_ejection_time, max_ejection_time);
+      Duration ejection_duration = base_ejection_time;
+      for (uint32_t i = 1; i < multiplier_ && ejection_duration < cap; ++i) {
+        ejection_duration = ejection_duration * 2;
+      }
+      if (now < *ejection_time_ + std::min(ejection_duration, cap)) {
+        return false;
+      }
+      Uneject();
+      return true;
+    }
+
+    // Called when ejection is disabled by a config update.
+    void DisableEjection() {
+      if (ejected()) Uneject();
+      multiplier_ = 0;
+      current_bucket_->successes.store(0, std::memory_order_relaxed);
+      current_bucket_->failures.store(0, std::memory_order_relaxed);
+      backup_bucket_->successes.store(0, std::memory_order_relaxed);
+      backup_bucket_->failures.store(0, std::memory_order_relaxed);
+      consecutive_failures_.store(0, std::memory_order_relaxed);
+    }
+
+   private:
+    std::unique_ptr<Bucket> current_bucket_;
+    std::unique_ptr<Bucket> backup_bucket_;
+    // The bucket that the data plane is currently counting into.
+    std::atomic<Bucket*> active_bucket_;
+    std::atomic<uint64_t> consecutive_failures_{0};
+    uint32_t multiplier_ = 0;
+    absl::optional<Timestamp> ejection_time_;
+    std::set<SubchannelWrapper*> subchannels_;
+  };
+
+  // A simple wrapper for ref-counting a picker from the child policy.
+  class RefCountedPicker : public RefCounted<RefCountedPicker> {
+   public:
+    explicit RefCountedPicker(std::unique_ptr<SubchannelPicker> picker)
+        : picker_(std::move(picker)) {}
+    PickResult Pick(PickArgs args) { return picker_->Pick(args); }
+
+   private:
+    std::unique_ptr<SubchannelPicker> picker_;
+  };
+
+  // A picker that wraps the picker from the child to record call results.
+  class Picker : public SubchannelPicker {
+   public:
+    Picker(OutlierDetectionLb* outlier_detection_lb,
+           RefCountedPtr<RefCountedPicker> picker, bool counting_enabled);
+
+    PickResult Pick(PickArgs args) override;
+
+   private:
+    class SubchannelCallTracker;
+
+    RefCountedPtr<RefCountedPicker> picker_;
+    bool counting_enabled_;
+  };
+
+  class Helper : public ChannelControlHelper {
+   public:
+    explicit Helper(RefCountedPtr<OutlierDetectionLb> outlier_detection_policy)
+        : outlier_detection_policy_(std::move(outlier_detection_policy)) {}
+
+    ~Helper() override {
+      outlier_detection_policy_.reset(DEBUG_LOCATION, "Helper");
+    }
+
+    RefCountedPtr<SubchannelInterface> CreateSubchannel(
+        ServerAddress address, const grpc_channel_args& args) override;
+    void UpdateState(grpc_connectivity_state state, const absl::Status& status,
+                     std::unique_ptr<SubchannelPicker> picker) override;
+    void RequestReresolution() override;
+    absl::string_view GetAuthority() override;
+    void AddTraceEvent(TraceSeverity severity,
+                       absl::string_view message) override;
+
+   private:
+    RefCountedPtr<OutlierDetectionLb> outlier_detection_policy_;
+  };
+
+  class EjectionTimer : public InternallyRefCounted<EjectionTimer> {
+   public:
+    EjectionTimer(RefCountedPtr<OutlierDetectionLb> parent,
+                  Timestamp start_time);
+
+    void Orphan() override;
+
+    Timestamp StartTime() const { return start_time_; }
+
+   private:
+    static void OnTimer(void* arg, grpc_error_handle error);
+    void OnTimerLocked(grpc_error_handle);
+
+    RefCountedPtr<OutlierDetectionLb> parent_;
+    Timestamp start_time_;
+    grpc_timer timer_;
+    grpc_closure on_timer_;
+    bool timer_pending_ = true;
+    absl::BitGen bit_gen_;
+  };
+
+  ~OutlierDetectionLb() override;
+
+  static std::string MakeKeyForAddress(const ServerAddress& address);
+
+  void ShutdownLocked() override;
+
+  OrphanablePtr<LoadBalancingPolicy> CreateChildPolicyLocked(
+      const grpc_channel_args* args);
+
+  void MaybeUpdatePickerLocked();
+
+  // Current config from the resolver.
+  RefCountedPtr<OutlierDetectionLbConfig> config_;
+
+  // Internal state.
+  bool shutting_down_ = false;
+
+  OrphanablePtr<LoadBalancingPolicy> child_policy_;
+
+  // Latest state and picker reported by the child policy.
+  grpc_connectivity_state state_ = GRPC_CHANNEL_IDLE;
+  absl::Status status_;
+  RefCountedPtr<RefCountedPicker> picker_;
+
+  // Per-address state, keyed by the string form of the address.
+  std::map<std::string, RefCountedPtr<SubchannelState>> subchannel_state_map_;
+
+  OrphanablePtr<EjectionTimer> ejection_timer_;
+};
+
+//
+// OutlierDetectionLb::SubchannelWrapper
+//
+
+OutlierDetectionLb::SubchannelWrapper::SubchannelWrapper(
+    RefCountedPtr<SubchannelState> subchannel_state,
+    RefCountedPtr<SubchannelInterface> subchannel)
+    : DelegatingSubchannel(std::move(subchannel)),
+      subchannel_state_(std::move(subchannel_state)) {
+  if (subchannel_state_ != nullptr) {
+    subchannel_state_->AddSubchannel(this);
+    ejected_ = subchannel_state_->ejected();
+  }
+}
+
+OutlierDetectionLb::SubchannelWrapper::~SubchannelWrapper() {
+  if (subchannel_state_ != nullptr) {
+    subchannel_state_->RemoveSubchannel(this);
+  }
+}
+
+void OutlierDetectionLb::SubchannelWrapper::Eject() {
+  ejected_ = true;
+  if (watcher_wrapper_ != nullptr) watcher_wrapper_->Eject();
+}
+
+void OutlierDetectionLb::SubchannelWrapper::Uneject() {
+  ejected_ = false;
+  if (watcher_wrapper_ != nullptr) watcher_wrapper_->Uneject();
+}
+
+grpc_connectivity_state
+OutlierDetectionLb::SubchannelWrapper::CheckConnectivityState() {
+  if (ejected_) return GRPC_CHANNEL_TRANSIENT_FAILURE;
+  return wrapped_subchannel()->CheckConnectivityState();
+}
+
+void OutlierDetectionLb::SubchannelWrapper::WatchConnectivityState(
+    grpc_connectivity_state initial_state,
+    std::unique_ptr<ConnectivityStateWatcherInterface> watcher) {
+  auto watcher_wrapper = absl::make_unique<WatcherWrapper>(
+      std::move(watcher), initial_state, ejected_);
+  watcher_wrapper_ = watcher_wrapper.get();
+  wrapped_subchannel()->WatchConnectivityState(initial_state,
+                                               std::move(watcher_wrapper));
+}
+
+void OutlierDetectionLb::SubchannelWrapper::CancelConnectivityStateWatch(
+    ConnectivityStateWatcherInterface* watcher) {
+  if (watcher_wrapper_ == nullptr || watcher_wrapper_->watcher() != watcher) {
+    return;
+  }
+  wrapped_subchannel()->CancelConnectivityStateWatch(watcher_wrapper_);
+  watcher_wrapper_ = nullptr;
+}
+
+//
+// OutlierDetectionLb::Picker::SubchannelCallTracker
+//
+
+class OutlierDetectionLb::Picker::SubchannelCallTracker
+    : public LoadBalancingPolicy::SubchannelCallTrackerInterface {
+ public:
+  SubchannelCallTracker(
+      std::unique_ptr<LoadBalancingPolicy::SubchannelCallTrackerInterface>
+          original_subchannel_call_tracker,
+      RefCountedPtr<SubchannelState> subchannel_state)
+      : original_subchannel_call_tracker_(
+            std::move(original_subchannel_call_tracker)),
+        subchannel_state_(std::move(subchannel_state)) {}
+
+  ~SubchannelCallTracker() override {
+    subchannel_state_.reset(DEBUG_LOCATION, "SubchannelCallTracker");
+  }
+
+  void Start() override {
+    // Delegate if needed.
+    if (original_subchannel_call_tracker_ != nullptr) {
+      original_subchannel_call_tracker_->Start();
+    }
+  }
+
+  void Finish(FinishArgs args) override {
+    // Delegate if needed.
+    if (original_subchannel_call_tracker_ != nullptr) {
+      original_subchannel_call_tracker_->Finish(args);
+    }
+    // Record call completion based on status for outlier detection.
+    subchannel_state_->AddCallResult(args.status.ok());
+  }
+
+ private:
+  std::unique_ptr<LoadBalancingPolicy::SubchannelCallTrackerInterface>
+      original_subchannel_call_tracker_;
+  RefCountedPtr<SubchannelState> subchannel_state_;
+};
+
+//
+// OutlierDetectionLb::Picker
+//
+
+OutlierDetectionLb::Picker::Picker(OutlierDetectionLb* outlier_detection_lb,
+                                   RefCountedPtr<RefCountedPicker> picker,
+                                   bool counting_enabled)
+    : picker_(std::move(picker)), counting_enabled_(counting_enabled) {
+  if (GRPC_TRACE_FLAG_ENABLED(grpc_outlier_detection_lb_trace)) {
+    gpr_log(GPR_INFO,
+            "[outlier_detection_lb %p] constructed new picker %p and counting "
+            "is %s",
+            outlier_detection_lb, this,
+            (counting_enabled ? "enabled" : "disabled"));
+  }
+}
+
+LoadBalancingPolicy::PickResult OutlierDetectionLb::Picker::Pick(
+    LoadBalancingPolicy::PickArgs args) {
+  if (picker_ == nullptr) {  // Should never happen.
+    return PickResult::Fail(absl::InternalError(
+        "outlier_detection picker not given any child picker"));
+  }
+  // Delegate to child picker.
+  PickResult result = picker_->Pick(args);
+  auto* complete_pick = absl::get_if<PickResult::Complete>(&result.result);
+  if (complete_pick != nullptr) {
+    auto* subchannel_wrapper =
+        static_cast<SubchannelWrapper*>(complete_pick->subchannel.get());
+    // Inject subchannel call tracker to record call completion as either
+    // success or failure.
+    if (counting_enabled_) {
+      RefCountedPtr<SubchannelState> subchannel_state =
+          subchannel_wrapper->subchannel_state();
+      if (subchannel_state != nullptr) {
+        complete_pick->subchannel_call_tracker =
+            absl::make_unique<SubchannelCallTracker>(
+                std::move(complete_pick->subchannel_call_tracker),
+                std::move(subchannel_state));
+      }
+    }
+    // Unwrap subchannel to pass back up the stack.
+    complete_pick->subchannel = subchannel_wrapper->wrapped_subchannel();
+  }
+  return result;
+}
+
+//
+// OutlierDetectionLb
+//
+
+OutlierDetectionLb::OutlierDetectionLb(Args args)
+    : LoadBalancingPolicy(std::move(args)) {
+  if (GRPC_TRACE_FLAG_ENABLED(grpc_outlier_detection_lb_trace)) {
+    gpr_log(GPR_INFO, "[outlier_detection_lb %p] created", this);
+  }
+}
+
+OutlierDetectionLb::~OutlierDetectionLb() {
+  if (GRPC_TRACE_FLAG_ENABLED(grpc_outlier_detection_lb_trace)) {
+    gpr_log(GPR_INFO,
+            "[outlier_detection_lb %p] destroying outlier_detection LB policy",
+            this);
+  }
+}
+
+std::string OutlierDetectionLb::MakeKeyForAddress(
+    const ServerAddress& address) {
+  // Use only the address, not the attributes.
+  auto addr_str = grpc_sockaddr_to_string(&address.address(), false);
+  // If address couldn't be stringified, ignore it.
+  if (!addr_str.ok()) return "";
+  return std::move(*addr_str);
+}
+
+void OutlierDetectionLb::ShutdownLocked() {
+  if (GRPC_TRACE_FLAG_ENABLED(grpc_outlier_detection_lb_trace)) {
+    gpr_log(GPR_INFO, "[outlier_detection_lb %p] shutting down", this);
+  }
+  ejection_timer_.reset();
+  shutting_down_ = true;
+  // Remove the child policy's interested_parties pollset_set from the
+  // outlier detection policy.
+  if (child_policy_ != nullptr) {
+    grpc_pollset_set_del_pollset_set(child_policy_->interested_parties(),
+                                     interested_parties());
+    child_policy_.reset();
+  }
+  // Drop our ref to the child's picker, in case it's holding a ref to
+  // the child.
+  picker_.reset();
+}
+
+void OutlierDetectionLb::ExitIdleLocked() {
+  if (child_policy_ != nullptr) child_policy_->ExitIdleLocked();
+}
+
+void OutlierDetectionLb::ResetBackoffLocked() {
+  if (child_policy_ != nullptr) child_policy_->ResetBackoffLocked();
+}
+
+void OutlierDetectionLb::UpdateLocked(UpdateArgs args) {
+  if (GRPC_TRACE_FLAG_ENABLED(grpc_outlier_detection_lb_trace)) {
+    gpr_log(GPR_INFO, "[outlier_detection_lb %p] Received update", this);
+  }
+  auto old_config = std::move(config_);
+  // Update config.
+  config_ = std::move(args.config);
+  // Update outlier detection timer.
+  if (!config_->CountingEnabled()) {
+    // No need for timer.  Cancel the current timer, if any.
+    ejection_timer_.reset();
+    // Uneject all addresses and discard their stats.
+    for (auto& p : subchannel_state_map_) p.second->DisableEjection();
+  } else if (ejection_timer_ == nullptr) {
+    // No timer running.  Start it now.
+    ejection_timer_ = MakeOrphanable<EjectionTimer>(
+        Ref(DEBUG_LOCATION, "EjectionTimer"), ExecCtx::Get()->Now());
+  } else if (old_config->outlier_detection_config().interval !=
+             config_->outlier_detection_config().interval) {
+    // Timer interval changed.  Cancel the current timer and start a new
+    // one with the same start time.
+    Timestamp start_time = ejection_timer_->StartTime();
+    ejection_timer_ = MakeOrphanable<EjectionTimer>(
+        Ref(DEBUG_LOCATION, "EjectionTimer"), start_time);
+  }
+  // Update the subchannel state map before the child creates any
+  // subchannels for the new addresses.
+  if (args.addresses.ok()) {
+    std::set<std::string> current_addresses;
+    for (const ServerAddress& address : *args.addresses) {
+      std::string address_key = MakeKeyForAddress(address);
+      if (address_key.empty()) continue;
+      auto& subchannel_state = subchannel_state_map_[address_key];
+      if (subchannel_state == nullptr) {
+        subchannel_state = MakeRefCounted<SubchannelState>();
+      }
+      current_addresses.emplace(std::move(address_key));
+    }
+    for (auto it = subchannel_state_map_.begin();
+         it != subchannel_state_map_.end();) {
+      if (current_addresses.find(it->first) == current_addresses.end()) {
+        // Remove each map entry for a subchannel address not in the updated
+        // address list.
+        it = subchannel_state_map_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+  }
+  // Update picker if counting was enabled or disabled.
+  if (old_config != nullptr &&
+      old_config->CountingEnabled() != config_->CountingEnabled()) {
+    MaybeUpdatePickerLocked();
+  }
+  // Create child policy if needed.
+  if (child_policy_ == nullptr) {
+    child_policy_ = CreateChildPolicyLocked(args.args);
+  }
+  // Update child policy.
+  UpdateArgs update_args;
+  update_args.addresses = std::move(args.addresses);
+  update_args.config = config_->child_policy();
+  update_args.args = grpc_channel_args_copy(args.args);
+  if (GRPC_TRACE_FLAG_ENABLED(grpc_outlier_detection_lb_trace)) {
+    gpr_log(GPR_INFO,
+            "[outlier_detection_lb %p] Updating child policy handler %p", this,
+            child_policy_.get());
+  }
+  child_policy_->UpdateLocked(std::move(update_args));
+}
+
+void OutlierDetectionLb::MaybeUpdatePickerLocked() {
+  if (picker_ != nullptr) {
+    auto outlier_detection_picker = absl::make_unique<Picker>(
+        this, picker_, config_->CountingEnabled());
+    if (GRPC_TRACE_FLAG_ENABLED(grpc_outlier_detection_lb_trace)) {
+      gpr_log(GPR_INFO,
+              "[outlier_detection_lb %p] updating connectivity: state=%s "
+              "status=(%s) picker=%p",
+              this, ConnectivityStateName(state_), status_.ToString().c_str(),
+              outlier_detection_picker.get());
+    }
+    channel_control_helper()->UpdateState(state_, status_,
+                                          std::move(outlier_detection_picker));
+  }
+}
+
+OrphanablePtr<LoadBalancingPolicy> OutlierDetectionLb::CreateChildPolicyLocked(
+    const grpc_channel_args* args) {
+  LoadBalancingPolicy::Args lb_policy_args;
+  lb_policy_args.work_serializer = work_serializer();
+  lb_policy_args.args = args;
+  lb_policy_args.channel_control_helper =
+      absl::make_unique<Helper>(Ref(DEBUG_LOCATION, "Helper"));
+  OrphanablePtr<LoadBalancingPolicy> lb_policy =
+      MakeOrphanable<ChildPolicyHandler>(std::move(lb_policy_args),
+                                         &grpc_outlier_detection_lb_trace);
+  if (GRPC_TRACE_FLAG_ENABLED(grpc_outlier_detection_lb_trace)) {
+    gpr_log(GPR_INFO,
+            "[outlier_detection_lb %p] Created new child policy handler %p",
+            this, lb_policy.get());
+  }
+  // Add our interested_parties pollset_set to that of the newly created
+  // child policy. This will make the child policy progress upon activity on
+  // this policy, which in turn is tied to the application's call.
+  grpc_pollset_set_add_pollset_set(lb_policy->interested_parties(),
+                                   interested_parties());
+  return lb_policy;
+}
+
+//
+// OutlierDetectionLb::Helper
+//
+
+RefCountedPtr<SubchannelInterface> OutlierDetectionLb::Helper::CreateSubchannel(
+    ServerAddress address, const grpc_channel_args& args) {
+  if (outlier_detection_policy_->shutting_down_) return nullptr;
+  RefCountedPtr<SubchannelState> subchannel_state;
+  std::string key = MakeKeyForAddress(address);
+  auto it = outlier_detection_policy_->subchannel_state_map_.find(key);
+  if (it != outlier_detection_policy_->subchannel_state_map_.end()) {
+    subchannel_state = it->second;
+  }
+  RefCountedPtr<SubchannelInterface> subchannel =
+      outlier_detection_policy_->channel_control_helper()->CreateSubchannel(
+          std::move(address), args);
+  if (subchannel == nullptr) return nullptr;
+  return MakeRefCounted<SubchannelWrapper>(std::move(subchannel_state),
+                                           std::move(subchannel));
+}
+
+void OutlierDetectionLb::Helper::UpdateState(
+    grpc_connectivity_state state, const absl::Status& status,
+    std::unique_ptr<SubchannelPicker> picker) {
+  if (outlier_detection_policy_->shutting_down_) return;
+  if (GRPC_TRACE_FLAG_ENABLED(grpc_outlier_detection_lb_trace)) {
+    gpr_log(GPR_INFO,
+            "[outlier_detection_lb %p] child connectivity state update: "
+            "state=%s (%s) picker=%p",
+            outlier_detection_policy_.get(), ConnectivityStateName(state),
+            status.ToString().c_str(), picker.get());
+  }
+  // Save the state and picker.
+  outlier_detection_policy_->state_ = state;
+  outlier_detection_policy_->status_ = status;
+  outlier_detection_policy_->picker_ =
+      MakeRefCounted<RefCountedPicker>(std::move(picker));
+  // Wrap the picker and return it to the channel.
+  outlier_detection_policy_->MaybeUpdatePickerLocked();
+}
+
+void OutlierDetectionLb::Helper::RequestReresolution() {
+  if (outlier_detection_policy_->shutting_down_) return;
+  outlier_detection_policy_->channel_control_helper()->RequestReresolution();
+}
+
+absl::string_view OutlierDetectionLb::Helper::GetAuthority() {
+  return outlier_detection_policy_->channel_control_helper()->GetAuthority();
+}
+
+void OutlierDetectionLb::Helper::AddTraceEvent(TraceSeverity severity,
+                                               absl::string_view message) {
+  if (outlier_detection_policy_->shutting_down_) return;
+  outlier_detection_policy_->channel_control_helper()->AddTraceEvent(severity,
+                                                                     message);
+}
+
+//
+// OutlierDetectionLb::EjectionTimer
+//
+
+OutlierDetectionLb::EjectionTimer::EjectionTimer(
+    RefCountedPtr<OutlierDetectionLb> parent, Timestamp start_time)
+    : parent_(std::move(parent)), start_time_(start_time) {
+  const Duration interval =
+      parent_->config_->outlier_detection_config().interval;
+  if (GRPC_TRACE_FLAG_ENABLED(grpc_outlier_detection_lb_trace)) {
+    gpr_log(GPR_INFO,
+            "[outlier_detection_lb %p] starting ejection timer for %" PRId64
+            "ms",
+            parent_.get(), interval.millis());
+  }
+  GRPC_CLOSURE_INIT(&on_timer_, OnTimer, this, nullptr);
+  Ref(DEBUG_LOCATION, "Timer").release();
+  grpc_timer_init(&timer_, start_time_ + interval, &on_timer_);
+}
+
+void OutlierDetectionLb::EjectionTimer::Orphan() {
+  if (timer_pending_) {
+    timer_pending_ = false;
+    grpc_timer_cancel(&timer_);
+  }
+  Unref();
+}
+
+void OutlierDetectionLb::EjectionTimer::OnTimer(void* arg,
+                                                grpc_error_handle error) {
+  auto* self = static_cast<EjectionTimer*>(arg);
+  (void)GRPC_ERROR_REF(error);  // ref owned by lambda
+  self->parent_->work_serializer()->Run(
+      [self, error]() { self->OnTimerLocked(error); }, DEBUG_LOCATION);
+}
+
+void OutlierDetectionLb::EjectionTimer::OnTimerLocked(grpc_error_handle error) {
+  if (error == GRPC_ERROR_NONE && timer_pending_) {
+    if (GRPC_TRACE_FLAG_ENABLED(grpc_outlier_detection_lb_trace)) {
+      gpr_log(GPR_INFO, "[outlier_detection_lb %p] ejection timer running",
+              parent_.get());
+    }
+    timer_pending_ = false;
+    const OutlierDetectionConfig& config =
+        parent_->config_->outlier_detection_config();
+    const Timestamp now = ExecCtx::Get()->Now();
+    const size_t num_addresses = parent_->subchannel_state_map_.size();
+    std::map<SubchannelState*, double> success_rate_ejection_candidates;
+    std::map<SubchannelState*, double> failure_percentage_ejection_candidates;
+    std::vector<SubchannelState*> consecutive_failure_ejection_candidates;
+    size_t ejected_host_count = 0;
+    double success_rate_sum = 0;
+    for (auto& p : parent_->subchannel_state_map_) {
+      SubchannelState* subchannel_state = p.second.get();
+      // Swap the buckets so that the counts from the interval that just
+      // ended are stable while we look at them.
+      subchannel_state->RotateBucket();
+      if (subchannel_state->ejected()) {
+        ++ejected_host_count;
+        continue;
+      }
+      const uint64_t successes = subchannel_state->successes();
+      const uint64_t failures = subchannel_state->failures();
+      const uint64_t request_volume = successes + failures;
+      if (config.success_rate_ejection.has_value() &&
+          request_volume >= config.success_rate_ejection->request_volume) {
+        const double success_rate = 100.0 * successes / request_volume;
+        success_rate_ejection_candidates[subchannel_state] = success_rate;
+        success_rate_sum += success_rate;
+      }
+      if (config.failure_percentage_ejection.has_value() &&
+          request_volume >=
+              config.failure_percentage_ejection->request_volume) {
+        failure_percentage_ejection_candidates[subchannel_state] =
+            100.0 * failures / request_volume;
+      }
+      if (config.consecutive_failure_ejection.has_value() &&
+          subchannel_state->consecutive_failures() >=
+              config.consecutive_failure_ejection->threshold) {
+        consecutive_failure_ejection_candidates.push_back(subchannel_state);
+      }
+    }
+    // Ejects the address if the maximum ejection percentage has not been
+    // reached and the enforcement check passes.
+    auto maybe_eject = [&](SubchannelState* subchannel_state,
+                           uint32_t enforcement_percentage) {
+      if (subchannel_state->ejected()) return;
+      const double current_percent =
+          100.0 * ejected_host_count / num_addresses;
+      if (current_percent >= config.max_ejection_percent) return;
+      if (absl::Uniform<uint32_t>(bit_gen_, 0, 100) >=
+          enforcement_percentage) {
+        return;
+      }
+      if (GRPC_TRACE_FLAG_ENABLED(grpc_outlier_detection_lb_trace)) {
+        gpr_log(GPR_INFO, "[outlier_detection_lb %p] ejecting address %p",
+                parent_.get(), subchannel_state);
+      }
+      subchannel_state->Eject(now);
+      ++ejected_host_count;
+    };
+    // Success rate ejection.
+    if (!success_rate_ejection_candidates.empty() &&
+        success_rate_ejection_candidates.size() >=
+            config.success_rate_ejection->minimum_hosts) {
+      const double mean =
+          success_rate_sum / success_rate_ejection_candidates.size();
+      double variance = 0;
+      for (const auto& p : success_rate_ejection_candidates) {
+        variance += (p.second - mean) * (p.second - mean);
+      }
+      variance /= success_rate_ejection_candidates.size();
+      const double stdev = std::sqrt(variance);
+      const double ejection_threshold =
+          mean -
+          stdev * (config.success_rate_ejection->stdev_factor / 1000.0);
+      for (const auto& p : success_rate_ejection_candidates) {
+        if (p.second < ejection_threshold) {
+          maybe_eject(p.first,
+                      config.success_rate_ejection->enforcement_percentage);
+        }
+      }
+    }
+    // Failure percentage ejection.
+    if (!failure_percentage_ejection_candidates.empty() &&
+        failure_percentage_ejection_candidates.size() >=
+            config.failure_percentage_ejection->minimum_hosts) {
+      for (const auto& p : failure_percentage_ejection_candidates) {
+        if (p.second > config.failure_percentage_ejection->threshold) {
+          maybe_eject(
+              p.first,
+              config.failure_percentage_ejection->enforcement_percentage);
+        }
+      }
+    }
+    // Consecutive failure ejection.
+    for (SubchannelState* subchannel_state :
+         consecutive_failure_ejection_candidates) {
+      maybe_eject(subchannel_state,
+                  config.consecutive_failure_ejection->enforcement_percentage);
+    }
+    // Readmit addresses whose ejection period has elapsed.
+    for (auto& p : parent_->subchannel_state_map_) {
+      if (p.second->MaybeUneject(config.base_ejection_time,
+                                 config.max_ejection_time, now) &&
+          GRPC_TRACE_FLAG_ENABLED(grpc_outlier_detection_lb_trace)) {
+        gpr_log(GPR_INFO, "[outlier_detection_lb %p] unejecting address %s",
+                parent_.get(), p.first.c_str());
+      }
+    }
+    parent_->ejection_timer_ =
+        MakeOrphanable<EjectionTimer>(parent_, ExecCtx::Get()->Now());
+  }
+  Unref(DEBUG_LOCATION, "Timer");
+  GRPC_ERROR_UNREF(error);
+}
+
+//
+// factory
+//
+
+class OutlierDetectionLbFactory : public LoadBalancingPolicyFactory {
+ public:
+  OrphanablePtr<LoadBalancingPolicy> CreateLoadBalancingPolicy(
+      LoadBalancingPolicy::Args args) const override {
+    return MakeOrphanable<OutlierDetectionLb>(std::move(args));
+  }
+
+  const char* name() const override { return kOutlierDetection; }
+
+  RefCountedPtr<LoadBalancingPolicy::Config> ParseLoadBalancingConfig(
+      const Json& json, grpc_error_handle* error) const override {
+    GPR_DEBUG_ASSERT(error != nullptr && *error == GRPC_ERROR_NONE);
+    if (json.type() == Json::Type::JSON_NULL) {
+      // This policy was configured in the deprecated loadBalancingPolicy
+      // field or in the client API.
+      *error = GRPC_ERROR_CREATE_FROM_STATIC_STRING(
+          "field:loadBalancingPolicy error:outlier_detection policy requires "
+          "configuration. Please use loadBalancingConfig field of service "
+          "config instead.");
+      return nullptr;
+    }
+    std::vector<grpc_error_handle> error_list;
+    // Outlier detection config.
+    OutlierDetectionConfig outlier_detection_config;
+    const Json::Object& object = json.object_value();
+    ParseJsonObjectFieldAsDuration(object, "interval",
+                                   &outlier_detection_config.interval,
+                                   &error_list, /*required=*/false);
+    ParseJsonObjectFieldAsDuration(
+        object, "baseEjectionTime",
+        &outlier_detection_config.base_ejection_time, &error_list,
+        /*required=*/false);
+    ParseJsonObjectFieldAsDuration(object, "maxEjectionTime",
+                                   &outlier_detection_config.max_ejection_time,
+                                   &error_list, /*required=*/false);
+    ParseJsonObjectField(object, "maxEjectionPercent",
+                         &outlier_detection_config.max_ejection_percent,
+                         &error_list, /*required=*/false);
+    ValidatePercentage("maxEjectionPercent",
+                       outlier_detection_config.max_ejection_percent,
+                       &error_list);
+    const Json::Object* ejection_object = nullptr;
+    if (ParseJsonObjectField(object, "successRateEjection", &ejection_object,
+                             &error_list, /*required=*/false)) {
+      OutlierDetectionConfig::SuccessRateEjection success_rate_ejection;
+      std::vector<grpc_error_handle> ejection_errors;
+      ParseJsonObjectField(*ejection_object, "stdevFactor",
+                           &success_rate_ejection.stdev_factor,
+                           &ejection_errors, /*required=*/false);
+      ParseJsonObjectField(*ejection_object, "enforcementPercentage",
+                           &success_rate_ejection.enforcement_percentage,
+                           &ejection_errors, /*required=*/false);
+      ValidatePercentage("enforcementPercentage",
+                         success_rate_ejection.enforcement_percentage,
+                         &ejection_errors);
+      ParseJsonObjectField(*ejection_object, "minimumHosts",
+                           &success_rate_ejection.minimum_hosts,
+                           &ejection_errors, /*required=*/false);
+      ParseJsonObjectField(*ejection_object, "requestVolume",
+                           &success_rate_ejection.request_volume,
+                           &ejection_errors, /*required=*/false);
+      if (!ejection_errors.empty()) {
+        error_list.push_back(GRPC_ERROR_CREATE_FROM_VECTOR(
+            "field:successRateEjection", &ejection_errors));
+      }
+      outlier_detection_config.success_rate_ejection = success_rate_ejection;
+    }
+    if (ParseJsonObjectField(object, "failurePercentageEjection",
+                             &ejection_object, &error_list,
+                             /*required=*/false)) {
+      OutlierDetectionConfig::FailurePercentageEjection
+          failure_percentage_ejection;
+      std::vector<grpc_error_handle> ejection_errors;
+      ParseJsonObjectField(*ejection_object, "threshold",
+                           &failure_percentage_ejection.threshold,
+                           &ejection_errors, /*required=*/false);
+      ValidatePercentage("threshold", failure_percentage_ejection.threshold,
+                         &ejection_errors);
+      ParseJsonObjectField(*ejection_object, "enforcementPercentage",
+                           &failure_percentage_ejection.enforcement_percentage,
+                           &ejection_errors, /*required=*/false);
+      ValidatePercentage("enforcementPercentage",
+                         failure_percentage_ejection.enforcement_percentage,
+                         &ejection_errors);
+      ParseJsonObjectField(*ejection_object, "minimumHosts",
+                           &failure_percentage_ejection.minimum_hosts,
+                           &ejection_errors, /*required=*/false);
+      ParseJsonObjectField(*ejection_object, "requestVolume",
+                           &failure_percentage_ejection.request_volume,
+                           &ejection_errors, /*required=*/false);
+      if (!ejection_errors.empty()) {
+        error_list.push_back(GRPC_ERROR_CREATE_FROM_VECTOR(
+            "field:failurePercentageEjection", &ejection_errors));
+      }
+      outlier_detection_config.failure_percentage_ejection =
+          failure_percentage_ejection;
+    }
+    if (ParseJsonObjectField(object, "consecutiveFailureEjection",
+                             &ejection_object, &error_list,
+                             /*required=*/false)) {
+      OutlierDetectionConfig::ConsecutiveFailureEjection
+          consecutive_failure_ejection;
+      std::vector<grpc_error_handle> ejection_errors;
+      ParseJsonObjectField(*ejection_object, "threshold",
+                           &consecutive_failure_ejection.threshold,
+                           &ejection_errors, /*required=*/false);
+      if (consecutive_failure_ejection.threshold == 0) {
+        ejection_errors.push_back(GRPC_ERROR_CREATE_FROM_STATIC_STRING(
+            "field:threshold error:must be greater than 0"));
+      }
+      ParseJsonObjectField(
+          *ejection_object, "enforcementPercentage",
+          &consecutive_failure_ejection.enforcement_percentage,
+          &ejection_errors, /*required=*/false);
+      ValidatePercentage("enforcementPercentage",
+                         consecutive_failure_ejection.enforcement_percentage,
+                         &ejection_errors);
+      if (!ejection_errors.empty()) {
+        error_list.push_back(GRPC_ERROR_CREATE_FROM_VECTOR(
+            "field:consecutiveFailureEjection", &ejection_errors));
+      }
+      outlier_detection_config.consecutive_failure_ejection =
+          consecutive_failure_ejection;
+    }
+    // Child policy.
+    RefCountedPtr<LoadBalancingPolicy::Config> child_policy;
+    auto it = object.find("childPolicy");
+    if (it == object.end()) {
+      error_list.push_back(GRPC_ERROR_CREATE_FROM_STATIC_STRING(
+          "field:childPolicy error:required field missing"));
+    } else {
+      grpc_error_handle parse_error = GRPC_ERROR_NONE;
+      child_policy = LoadBalancingPolicyRegistry::ParseLoadBalancingConfig(
+          it->second, &parse_error);
+      if (child_policy == nullptr) {
+        GPR_DEBUG_ASSERT(parse_error != GRPC_ERROR_NONE);
+        std::vector<grpc_error_handle> child_errors;
+        child_errors.push_back(parse_error);
+        error_list.push_back(
+            GRPC_ERROR_CREATE_FROM_VECTOR("field:childPolicy", &child_errors));
+      }
+    }
+    if (!error_list.empty()) {
+      *error = GRPC_ERROR_CREATE_FROM_VECTOR(
+          "outlier_detection_experimental LB policy config", &error_list);
+      return nullptr;
+    }
+    return MakeRefCounted<OutlierDetectionLbConfig>(outlier_detection_config,
+                                                    std::move(child_policy));
+  }
+
+ private:
+  static void ValidatePercentage(absl::string_view field_name, uint32_t value,
+                                 std::vector<grpc_error_handle>* error_list) {
+    if (value > 100) {
+      error_list->push_back(GRPC_ERROR_CREATE_FROM_CPP_STRING(absl::StrCat(
+          "field:", field_name, " error:value must be <= 100")));
+    }
+  }
+};
+
+}  // namespace
+
+}  // namespace grpc_core
+
+//
+// Plugin registration
+//
+
+void grpc_lb_policy_outlier_detection_init() {
+  grpc_core::LoadBalancingPolicyRegistry::Builder::
+      RegisterLoadBalancingPolicyFactory(
+          absl::make_unique<grpc_core::OutlierDetectionLbFactory>());
+}
+
+void grpc_lb_policy_outlier_detection_shutdown() {}
@@ -16,9 +16,17 @@
 
 #include <grpc/support/port_platform.h>
 
+#include "src/core/ext/filters/client_channel/lb_policy/ring_hash/ring_hash.h"
+
 #include <stdlib.h>
 #include <string.h>
 
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <utility>
+
 #include "absl/strings/numbers.h"
 #include "absl/strings/str_cat.h"
 #define XXH_INLINE_ALL
@@ -35,6 +43,7 @@
 #include "src/core/lib/gpr/string.h"
 #include "src/core/lib/gprpp/ref_counted_ptr.h"
 #include "src/core/lib/gprpp/sync.h"
+#include "src/core/lib/json/json_util.h"
 #include "src/core/lib/transport/connectivity_state.h"
 #include "src/core/lib/transport/error_utils.h"
 
@@ -85,21 +94,236 @@ void ParseRingHashLbConfig(const Json& json, size_t* min_ring_size,
   }
 }
 
+//
+// RingHashTable
+//
+
+RingHashTable RingHashTable::MakeRing(
+    const std::vector<RingHashEndpoint>& endpoints, size_t min_ring_size,
+    size_t max_ring_size) {
+  RingHashTable table;
+  // Find the sum of the weights.
+  size_t sum = 0;
+  for (const RingHashEndpoint& endpoint : endpoints) {
+    GPR_ASSERT(endpoint.weight != 0);
+    sum += endpoint.weight;
+  }
+  // Calculating normalized weights and find min and max.
+  std::vector<double> normalized_weights;
+  normalized_weights.reserve(endpoints.size());
+  double min_normalized_weight = 1.0;
+  double max_normalized_weight = 0.0;
+  for (const RingHashEndpoint& endpoint : endpoints) {
+    const double normalized_weight =
+        static_cast<double>(endpoint.weight) / sum;
+    normalized_weights.push_back(normalized_weight);
+    min_normalized_weight = std::min(normalized_weight, min_normalized_weight);
+    max_normalized_weight = std::max(normalized_weight, max_normalized_weight);
+  }
+  // Scale up the number of hashes per host such that the least-weighted host
+  // gets a whole number of hashes on the ring. Other hosts might not end up
+  // with whole numbers, and that's fine (the ring-building algorithm below can
+  // handle this). This preserves the original implementation's behavior: when
+  // weights aren't provided, all hosts should get an equal number of hashes. In
+  // the case where this number exceeds the max_ring_size, it's scaled back down
+  // to fit.
+  const double scale = std::min(
+      std::ceil(min_normalized_weight * min_ring_size) / min_normalized_weight,
+      static_cast<double>(max_ring_size));
+  // Reserve memory for the entire ring up front.
+  const uint64_t ring_size = std::ceil(scale);
+  std::vector<std::pair<uint64_t, uint32_t>> ring;
+  ring.reserve(ring_size);
+  // Populate the hash ring by walking through the (host, weight) pairs in
+  // normalized_host_weights, and generating (scale * weight) hashes for each
+  // host. Since these aren't necessarily whole numbers, we maintain running
+  // sums -- current_hashes and target_hashes -- which allows us to populate the
+  // ring in a mostly stable way.
+  absl::InlinedVector<char, 196> hash_key_buffer;
+  double current_hashes = 0.0;
+  double target_hashes = 0.0;
+  for (size_t i = 0; i < endpoints.size(); ++i) {
+    const std::string& address_string = endpoints[i].key;
+    hash_key_buffer.assign(address_string.begin(), address_string.end());
+    hash_key_buffer.emplace_back('_');
+    auto offset_start = hash_key_buffer.end();
+    target_hashes += scale * normalized_weights[i];
+    size_t count = 0;
+    while (current_hashes < target_hashes) {
+      const std::string count_str = absl::StrCat(count);
+      hash_key_buffer.insert(offset_start, count_str.begin(), count_str.end());
+      absl::string_view hash_key(hash_key_buffer.data(),
+                                 hash_key_buffer.size());
+      const uint64_t hash = XXH64(hash_key.data(), hash_key.size(), 0);
+      ring.emplace_back(hash, static_cast<uint32_t>(i));
+      ++count;
+      ++current_hashes;
+      hash_key_buffer.erase(offset_start, hash_key_buffer.end());
+    }
+  }
+  std::sort(ring.begin(), ring.end(),
+            [](const std::pair<uint64_t, uint32_t>& lhs,
+               const std::pair<uint64_t, uint32_t>& rhs) -> bool {
+              return lhs.first < rhs.first;
+            });
+  table.hashes_.reserve(ring.size());
+  table.endpoint_indexes_.reserve(ring.size());
+  for (const auto& entry : ring) {
+    table.hashes_.push_back(entry.first);
+    table.endpoint_indexes_.push_back(entry.second);
+  }
+  return table;
+}
+
+RingHashTable RingHashTable::MakeMaglev(
+    const std::vector<RingHashEndpoint>& endpoints, size_t table_size) {
+  // See "Maglev: A Fast and Reliable Software Network Load Balancer"
+  // (NSDI '16), section 3.4.  Each endpoint walks its own permutation of
+  // the table, determined by an offset and a skip derived from its key,
+  // and the endpoints take turns claiming their next preferred free slot.
+  // To support weights, an endpoint earns a turn per round in proportion
+  // to its weight, so the heaviest endpoint claims a slot every round.
+  RingHashTable table;
+  if (endpoints.empty()) return table;
+  GPR_ASSERT(ValidateMaglevTableSize(table_size, endpoints.size()).ok());
+  struct Permutation {
+    uint64_t offset;
+    uint64_t skip;
+    uint64_t next = 0;
+    double credit = 0;
+    double turns_per_round;
+  };
+  uint32_t max_weight = 0;
+  for (const RingHashEndpoint& endpoint : endpoints) {
+    max_weight = std::max(max_weight, endpoint.weight);
+  }
+  std::vector<Permutation> permutations;
+  permutations.reserve(endpoints.size());
+  for (const RingHashEndpoint& endpoint : endpoints) {
+    Permutation permutation;
+    permutation.offset =
+        XXH64(endpoint.key.data(), endpoint.key.size(), 0) % table_size;
+    permutation.skip =
+        XXH64(endpoint.key.data(), endpoint.key.size(), 1) % (table_size - 1) +
+        1;
+    permutation.turns_per_round =
+        static_cast<double>(endpoint.weight) / max_weight;
+    permutations.push_back(permutation);
+  }
+  constexpr uint32_t kEmpty = std::numeric_limits<uint32_t>::max();
+  table.endpoint_indexes_.assign(table_size, kEmpty);
+  size_t filled = 0;
+  while (filled < table_size) {
+    for (size_t i = 0; i < permutations.size() && filled < table_size; ++i) {
+      Permutation& permutation = permutations[i];
+      permutation.credit += permutation.turns_per_round;
+      while (permutation.credit >= 1 && filled < table_size) {
+        permutation.credit -= 1;
+        // Since table_size is prime, the permutation visits every slot,
+        // so there is always a free one to find.
+        uint64_t slot;
+        do {
+          slot = (permutation.offset + permutation.skip * permutation.next) %
+                 table_size;
+          ++permutation.next;
+        } while (table.endpoint_indexes_[slot] != kEmpty);
+        table.endpoint_indexes_[slot] = static_cast<uint32_t>(i);
+        ++filled;
+      }
+    }
+  }
+  return table;
+}
+
+constexpr size_t RingHashTable::kMinMaglevSlotsPerEndpoint;
+
+absl::Status RingHashTable::ValidateMaglevTableSize(size_t table_size,
+                                                    size_t num_endpoints) {
+  if (table_size / kMinMaglevSlotsPerEndpoint < num_endpoints) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "maglev_table_size ", table_size, " is too small for ", num_endpoints,
+        " endpoints: it should be a prime at least ",
+        kMinMaglevSlotsPerEndpoint, " times the number of endpoints"));
+  }
+  return absl::OkStatus();
+}
+
+size_t RingHashTable::Lookup(uint64_t hash) const {
+  if (hashes_.empty()) return hash % endpoint_indexes_.size();
+  // Find the first entry whose hash is not less than the request hash,
+  // wrapping around to the start of the ring.
+  auto it = std::lower_bound(hashes_.begin(), hashes_.end(), hash);
+  if (it == hashes_.end()) return 0;
+  return it - hashes_.begin();
+}
+
+//
+// RingHashLoadTracker
+//
+
+RingHashLoadTracker::RingHashLoadTracker(std::vector<uint32_t> weights,
+                                         uint32_t hash_balance_factor)
+    : hash_balance_factor_(hash_balance_factor),
+      weights_(std::move(weights)),
+      in_flight_(absl::make_unique<std::atomic<uint32_t>[]>(weights_.size())) {
+  for (size_t i = 0; i < weights_.size(); ++i) {
+    total_weight_ += weights_[i];
+    in_flight_[i].store(0, std::memory_order_relaxed);
+  }
+}
+
+bool RingHashLoadTracker::HasSpareCapacity(size_t endpoint_index) const {
+  // Each endpoint may take its weighted share of the in-flight calls,
+  // counting the one being picked, scaled by the balance factor.
+  const double total_in_flight =
+      total_in_flight_.load(std::memory_order_relaxed) + 1;
+  const double capacity = std::ceil(total_in_flight * weights_[endpoint_index] *
+                                    hash_balance_factor_ /
+                                    (100.0 * total_weight_));
+  return in_flight_[endpoint_index].load(std::memory_order_relaxed) < capacity;
+}
+
+void RingHashLoadTracker::CallStarted(size_t endpoint_index) {
+  in_flight_[endpoint_index].fetch_add(1, std::memory_order_relaxed);
+  total_in_flight_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void RingHashLoadTracker::CallFinished(size_t endpoint_index) {
+  in_flight_[endpoint_index].fetch_sub(1, std::memory_order_relaxed);
+  total_in_flight_.fetch_sub(1, std::memory_order_relaxed);
+}
+
 namespace {
 
 constexpr char kRingHash[] = "ring_hash_experimental";
 
+constexpr size_t kDefaultMaglevTableSize = 65537;
+
 class RingHashLbConfig : public LoadBalancingPolicy::Config {
  public:
-  RingHashLbConfig(size_t min_ring_size, size_t max_ring_size)
-      : min_ring_size_(min_ring_size), max_ring_size_(max_ring_size) {}
+  RingHashLbConfig(size_t min_ring_size, size_t max_ring_size, bool use_maglev,
+                   size_t maglev_table_size, uint32_t hash_balance_factor)
+      : min_ring_size_(min_ring_size),
+        max_ring_size_(max_ring_size),
+        use_maglev_(use_maglev),
+        maglev_table_size_(maglev_table_size),
+        hash_balance_factor_(hash_balance_factor) {}
   const char* name() const override { return kRingHash; }
   size_t min_ring_size() const { return min_ring_size_; }
   size_t max_ring_size() const { return max_ring_size_; }
+  bool use_maglev() const { return use_maglev_; }
+  size_t maglev_table_size() const { return maglev_table_size_; }
+  // Percentage of its fair share of in-flight calls that an endpoint may
+  // take before picks spill over to the next endpoint, or 0 to disable
+  // bounded loads.
+  uint32_t hash_balance_factor() const { return hash_balance_factor_; }
 
  private:
   size_t min_ring_size_;
   size_t max_ring_size_;
+  bool use_maglev_;
+  size_t maglev_table_size_;
+  uint32_t hash_balance_factor_;
 };
 
 //
@@ -223,19 +447,34 @@ class RingHash : public LoadBalancingPolicy {
 
   class Ring : public RefCounted<Ring> {
    public:
-    struct Entry {
-      uint64_t hash;
-      RingHashSubchannelData* subchannel;
-    };
-
     Ring(RingHash* parent,
          RefCountedPtr<RingHashSubchannelList> subchannel_list);
 
-    const std::vector<Entry>& ring() const { return ring_; }
+    const RingHashTable& table() const { return table_; }
+
+    // Returns the subchannel at a position in the table.
+    RingHashSubchannelData* subchannel(size_t position) const {
+      return subchannel_list_->subchannel(table_.endpoint_index(position));
+    }
+
+    // Null unless bounded loads are enabled.
+    const RingHashLoadTracker* load_tracker() const {
+      return load_tracker_.get();
+    }
+
+    // Returns a call tracker that counts the call as in flight on the
+    // endpoint at a position in the table.
+    std::unique_ptr<SubchannelCallTrackerInterface> MakeCallTracker(
+        size_t position);
 
    private:
+    class CallTracker;
+
     RefCountedPtr<RingHashSubchannelList> subchannel_list_;
-    std::vector<Entry> ring_;
+    RingHashTable table_;
+    // The counts are per ring, so calls started on a previous ring are not
+    // counted against this one.
+    std::unique_ptr<RingHashLoadTracker> load_tracker_;
   };
 
   class Picker : public SubchannelPicker {
@@ -312,102 +551,81 @@ RingHash::Ring::Ring(RingHash* parent,
                      RefCountedPtr<RingHashSubchannelList> subchannel_list)
     : subchannel_list_(std::move(subchannel_list)) {
   size_t num_subchannels = subchannel_list_->num_subchannels();
-  // Store the weights while finding the sum.
-  struct AddressWeight {
-    std::string address;
-    // Default weight is 1 for the cases where a weight is not provided,
-    // each occurrence of the address will be counted a weight value of 1.
-    uint32_t weight = 1;
-    double normalized_weight;
-  };
-  std::vector<AddressWeight> address_weights;
-  size_t sum = 0;
-  address_weights.reserve(num_subchannels);
+  // Default weight is 1 for the cases where a weight is not provided,
+  // each occurrence of the address will be counted a weight value of 1.
+  std::vector<RingHashEndpoint> endpoints;
+  endpoints.reserve(num_subchannels);
   for (size_t i = 0; i < num_subchannels; ++i) {
     RingHashSubchannelData* sd = subchannel_list_->subchannel(i);
     const ServerAddressWeightAttribute* weight_attribute = static_cast<
         const ServerAddressWeightAttribute*>(sd->address().GetAttribute(
         ServerAddressWeightAttribute::kServerAddressWeightAttributeKey));
-    AddressWeight address_weight;
-    address_weight.address =
+    RingHashEndpoint endpoint;
+    endpoint.key =
         grpc_sockaddr_to_string(&sd->address().address(), false).value();
     if (weight_attribute != nullptr) {
       GPR_ASSERT(weight_attribute->weight() != 0);
-      address_weight.weight = weight_attribute->weight();
+      endpoint.weight = weight_attribute->weight();
     }
-    sum += address_weight.weight;
-    address_weights.push_back(std::move(address_weight));
+    endpoints.push_back(std::move(endpoint));
   }
-  // Calculating normalized weights and find min and max.
-  double min_normalized_weight = 1.0;
-  double max_normalized_weight = 0.0;
-  for (auto& address : address_weights) {
-    address.normalized_weight = static_cast<double>(address.weight) / sum;
-    min_normalized_weight =
-        std::min(address.normalized_weight, min_normalized_weight);
-    max_normalized_weight =
-        std::max(address.normalized_weight, max_normalized_weight);
+  if (parent->config_->use_maglev()) {
+    table_ = RingHashTable::MakeMaglev(endpoints,
+                                       parent->config_->maglev_table_size());
+  } else {
+    table_ = RingHashTable::MakeRing(endpoints,
+                                     parent->config_->min_ring_size(),
+                                     parent->config_->max_ring_size());
   }
-  // Scale up the number of hashes per host such that the least-weighted host
-  // gets a whole number of hashes on the ring. Other hosts might not end up
-  // with whole numbers, and that's fine (the ring-building algorithm below can
-  // handle this). This preserves the original implementation's behavior: when
-  // weights aren't provided, all hosts should get an equal number of hashes. In
-  // the case where this number exceeds the max_ring_size, it's scaled back down
-  // to fit.
-  const size_t min_ring_size = parent->config_->min_ring_size();
-  const size_t max_ring_size = parent->config_->max_ring_size();
-  const double scale = std::min(
-      std::ceil(min_normalized_weight * min_ring_size) / min_normalized_weight,
-      static_cast<double>(max_ring_size));
-  // Reserve memory for the entire ring up front.
-  const uint64_t ring_size = std::ceil(scale);
-  ring_.reserve(ring_size);
-  // Populate the hash ring by walking through the (host, weight) pairs in
-  // normalized_host_weights, and generating (scale * weight) hashes for each
-  // host. Since these aren't necessarily whole numbers, we maintain running
-  // sums -- current_hashes and target_hashes -- which allows us to populate the
-  // ring in a mostly stable way.
-  absl::InlinedVector<char, 196> hash_key_buffer;
-  double current_hashes = 0.0;
-  double target_hashes = 0.0;
-  uint64_t min_hashes_per_host = ring_size;
-  uint64_t max_hashes_per_host = 0;
-  for (size_t i = 0; i < num_subchannels; ++i) {
-    const std::string& address_string = address_weights[i].address;
-    hash_key_buffer.assign(address_string.begin(), address_string.end());
-    hash_key_buffer.emplace_back('_');
-    auto offset_start = hash_key_buffer.end();
-    target_hashes += scale * address_weights[i].normalized_weight;
-    size_t count = 0;
-    while (current_hashes < target_hashes) {
-      const std::string count_str = absl::StrCat(count);
-      hash_key_buffer.insert(offset_start, count_str.begin(), count_str.end());
-      absl::string_view hash_key(hash_key_buffer.data(),
-                                 hash_key_buffer.size());
-      const uint64_t hash = XXH64(hash_key.data(), hash_key.size(), 0);
-      ring_.push_back({hash, subchannel_list_->subchannel(i)});
-      ++count;
-      ++current_hashes;
-      hash_key_buffer.erase(offset_start, hash_key_buffer.end());
+  if (parent->config_->hash_balance_factor() != 0) {
+    std::vector<uint32_t> weights;
+    weights.reserve(num_subchannels);
+    for (const RingHashEndpoint& endpoint : endpoints) {
+      weights.push_back(endpoint.weight);
     }
-    min_hashes_per_host =
-        std::min(static_cast<uint64_t>(i), min_hashes_per_host);
-    max_hashes_per_host =
-        std::max(static_cast<uint64_t>(i), max_hashes_per_host);
-  }
-  std::sort(ring_.begin(), ring_.end(),
-            [](const Entry& lhs, const Entry& rhs) -> bool {
-              return lhs.hash < rhs.hash;
-            });
+    load_tracker_ = absl::make_unique<RingHashLoadTracker>(
+        std::move(weights), parent->config_->hash_balance_factor());
+  }
   if (GRPC_TRACE_FLAG_ENABLED(grpc_lb_ring_hash_trace)) {
     gpr_log(GPR_INFO,
-            "[RH %p picker %p] created ring from subchannel_list=%p "
-            "with %" PRIuPTR " ring entries",
-            parent, this, subchannel_list_.get(), ring_.size());
+            "[RH %p picker %p] created %s from subchannel_list=%p "
+            "with %" PRIuPTR " entries",
+            parent, this,
+            parent->config_->use_maglev() ? "maglev table" : "ring",
+            subchannel_list_.get(), table_.size());
   }
 }
 
+//
+// RingHash::Ring::CallTracker
+//
+
+class RingHash::Ring::CallTracker
+    : public LoadBalancingPolicy::SubchannelCallTrackerInterface {
+ public:
+  CallTracker(RefCountedPtr<Ring> ring, size_t index)
+      : ring_(std::move(ring)), index_(index) {}
+
+  void Start() override {
+    // Count the call only once it starts, since the tracker is dropped
+    // without being started if the pick is not used.
+    ring_->load_tracker_->CallStarted(index_);
+  }
+
+  void Finish(FinishArgs /*args*/) override {
+    ring_->load_tracker_->CallFinished(index_);
+  }
+
+ private:
+  RefCountedPtr<Ring> ring_;
+  size_t index_;
+};
+
+std::unique_ptr<LoadBalancingPolicy::SubchannelCallTrackerInterface>
+RingHash::Ring::MakeCallTracker(size_t position) {
+  return absl::make_unique<CallTracker>(Ref(), table_.endpoint_index(position));
+}
+
 //
 // RingHash::Picker
 //
@@ -420,34 +638,18 @@ RingHash::PickResult RingHash::Picker::Pick(PickArgs args) {
     return PickResult::Fail(
         absl::InternalError("xds ring hash value is not a number"));
   }
-  const std::vector<Ring::Entry>& ring = ring_->ring();
-  // Ported from https://github.com/RJ/ketama/blob/master/libketama/ketama.c
-  // (ketama_get_server) NOTE: The algorithm depends on using signed integers
-  // for lowp, highp, and first_index. Do not change them!
-  int64_t lowp = 0;
-  int64_t highp = ring.size();
-  int64_t first_index = 0;
-  while (true) {
-    first_index = (lowp + highp) / 2;
-    if (first_index == static_cast<int64_t>(ring.size())) {
-      first_index = 0;
-      break;
-    }
-    uint64_t midval = ring[first_index].hash;
-    uint64_t midval1 = first_index == 0 ? 0 : ring[first_index - 1].hash;
-    if (h <= midval && h > midval1) {
-      break;
+  const RingHashTable& table = ring_->table();
+  const size_t first_index = table.Lookup(h);
+  RingHashSubchannelData* first_subchannel = ring_->subchannel(first_index);
+  auto Complete = [&](size_t position) {
+    RefCountedPtr<SubchannelInterface> subchannel =
+        ring_->subchannel(position)->subchannel()->Ref();
+    if (ring_->load_tracker() == nullptr) {
+      return PickResult::Complete(std::move(subchannel));
     }
-    if (midval < h) {
-      lowp = first_index + 1;
-    } else {
-      highp = first_index - 1;
-    }
-    if (lowp > highp) {
-      first_index = 0;
-      break;
-    }
-  }
+    return PickResult::Complete(std::move(subchannel),
+                                ring_->MakeCallTracker(position));
+  };
   OrphanablePtr<SubchannelConnectionAttempter> subchannel_connection_attempter;
   auto ScheduleSubchannelConnectionAttempt =
       [&](RefCountedPtr<SubchannelInterface> subchannel) {
@@ -457,41 +659,45 @@ RingHash::PickResult RingHash::Picker::Pick(PickArgs args) {
         }
         subchannel_connection_attempter->AddSubchannel(std::move(subchannel));
       };
-  switch (ring[first_index].subchannel->GetConnectivityState()) {
-    case GRPC_CHANNEL_READY:
-      return PickResult::Complete(
-          ring[first_index].subchannel->subchannel()->Ref());
+  switch (first_subchannel->GetConnectivityState()) {
+    case GRPC_CHANNEL_READY: {
+      const RingHashLoadTracker* load_tracker = ring_->load_tracker();
+      if (load_tracker == nullptr) return Complete(first_index);
+      // Spill over to the next READY endpoint that is not above its share
+      // of the in-flight calls.  Some endpoint always has spare capacity,
+      // but if none of those are READY, stay with the first one.
+      return Complete(
+          load_tracker->Spillover(table, first_index, [&](size_t position) {
+            return ring_->subchannel(position)->GetConnectivityState() ==
+                   GRPC_CHANNEL_READY;
+          }));
+    }
     case GRPC_CHANNEL_IDLE:
       ScheduleSubchannelConnectionAttempt(
-          ring[first_index].subchannel->subchannel()->Ref());
+          first_subchannel->subchannel()->Ref());
       ABSL_FALLTHROUGH_INTENDED;
     case GRPC_CHANNEL_CONNECTING:
       return PickResult::Queue();
     default:  // GRPC_CHANNEL_TRANSIENT_FAILURE
       break;
   }
-  ScheduleSubchannelConnectionAttempt(
-      ring[first_index].subchannel->subchannel()->Ref());
+  ScheduleSubchannelConnectionAttempt(first_subchannel->subchannel()->Ref());
   // Loop through remaining subchannels to find one in READY.
   // On the way, we make sure the right set of connection attempts
   // will happen.
   bool found_second_subchannel = false;
   bool found_first_non_failed = false;
-  for (size_t i = 1; i < ring.size(); ++i) {
-    const Ring::Entry& entry = ring[(first_index + i) % ring.size()];
-    if (entry.subchannel == ring[first_index].subchannel) {
-      continue;
-    }
+  for (size_t i = 1; i < table.size(); ++i) {
+    const size_t position = (first_index + i) % table.size();
+    RingHashSubchannelData* subchannel = ring_->subchannel(position);
+    if (subchannel == first_subchannel) continue;
     grpc_connectivity_state connectivity_state =
-        entry.subchannel->GetConnectivityState();
-    if (connectivity_state == GRPC_CHANNEL_READY) {
-      return PickResult::Complete(entry.subchannel->subchannel()->Ref());
-    }
+        subchannel->GetConnectivityState();
+    if (connectivity_state == GRPC_CHANNEL_READY) return Complete(position);
     if (!found_second_subchannel) {
       switch (connectivity_state) {
         case GRPC_CHANNEL_IDLE:
-          ScheduleSubchannelConnectionAttempt(
-              entry.subchannel->subchannel()->Ref());
+          ScheduleSubchannelConnectionAttempt(subchannel->subchannel()->Ref());
           ABSL_FALLTHROUGH_INTENDED;
         case GRPC_CHANNEL_CONNECTING:
           return PickResult::Queue();
@@ -502,12 +708,10 @@ RingHash::PickResult RingHash::Picker::Pick(PickArgs args) {
     }
     if (!found_first_non_failed) {
       if (connectivity_state == GRPC_CHANNEL_TRANSIENT_FAILURE) {
-        ScheduleSubchannelConnectionAttempt(
-            entry.subchannel->subchannel()->Ref());
+        ScheduleSubchannelConnectionAttempt(subchannel->subchannel()->Ref());
       } else {
         if (connectivity_state == GRPC_CHANNEL_IDLE) {
-          ScheduleSubchannelConnectionAttempt(
-              entry.subchannel->subchannel()->Ref());
+          ScheduleSubchannelConnectionAttempt(subchannel->subchannel()->Ref());
         }
         found_first_non_failed = true;
       }
@@ -775,14 +979,30 @@ void RingHash::UpdateLocked(UpdateArgs args) {
     // failure and keep using the existing list.
     if (subchannel_list_ != nullptr) return;
   }
+  // A Maglev table too small for the addresses cannot be built, so treat
+  // the update like an empty one.
+  absl::Status table_status;
+  if (config_->use_maglev()) {
+    table_status = RingHashTable::ValidateMaglevTableSize(
+        config_->maglev_table_size(), addresses.size());
+    if (!table_status.ok()) {
+      gpr_log(GPR_ERROR, "[RH %p] %s", this, table_status.ToString().c_str());
+      addresses.clear();
+    }
+  }
   subchannel_list_ = MakeOrphanable<RingHashSubchannelList>(
       this, &grpc_lb_ring_hash_trace, std::move(addresses), *args.args);
   if (subchannel_list_->num_subchannels() == 0) {
     // If the new list is empty, immediately transition to TRANSIENT_FAILURE.
-    absl::Status status =
-        args.addresses.ok() ? absl::UnavailableError(absl::StrCat(
-                                  "empty address list: ", args.resolution_note))
-                            : args.addresses.status();
+    absl::Status status;
+    if (!table_status.ok()) {
+      status = absl::UnavailableError(table_status.message());
+    } else if (args.addresses.ok()) {
+      status = absl::UnavailableError(
+          absl::StrCat("empty address list: ", args.resolution_note));
+    } else {
+      status = args.addresses.status();
+    }
     channel_control_helper()->UpdateState(
         GRPC_CHANNEL_TRANSIENT_FAILURE, status,
         absl::make_unique<TransientFailurePicker>(status));
@@ -813,14 +1033,65 @@ class RingHashFactory : public LoadBalancingPolicyFactory {
     size_t max_ring_size;
     std::vector<grpc_error_handle> error_list;
     ParseRingHashLbConfig(json, &min_ring_size, &max_ring_size, &error_list);
+    bool use_maglev = false;
+    size_t maglev_table_size = kDefaultMaglevTableSize;
+    uint32_t hash_balance_factor = 0;
+    if (json.type() == Json::Type::OBJECT) {
+      ParseLookupTableConfig(json.object_value(), &use_maglev,
+                             &maglev_table_size, &hash_balance_factor,
+                             &error_list);
+    }
     if (error_list.empty()) {
-      return MakeRefCounted<RingHashLbConfig>(min_ring_size, max_ring_size);
+      return MakeRefCounted<RingHashLbConfig>(min_ring_size, max_ring_size,
+                                              use_maglev, maglev_table_size,
+                                              hash_balance_factor);
     } else {
       *error = GRPC_ERROR_CREATE_FROM_VECTOR(
           "ring_hash_experimental LB policy config", &error_list);
       return nullptr;
     }
   }
+
+ private:
+  static bool IsPrime(size_t n) {
+    if (n < 2) return false;
+    for (size_t i = 2; i * i <= n; ++i) {
+      if (n % i == 0) return false;
+    }
+    return true;
+  }
+
+  // Parses the fields that select the lookup table and bounded loads.
+  // These are not part of the xDS ring hash config, so they are not
+  // handled by ParseRingHashLbConfig().
+  static void ParseLookupTableConfig(
+      const Json::Object& json, bool* use_maglev, size_t* maglev_table_size,
+      uint32_t* hash_balance_factor,
+      std::vector<grpc_error_handle>* error_list) {
+    std::string lookup_table;
+    if (ParseJsonObjectField(json, "lookup_table", &lookup_table, error_list,
+                             /*required=*/false)) {
+      if (lookup_table == "maglev") {
+        *use_maglev = true;
+      } else if (lookup_table != "ring") {
+        error_list->push_back(GRPC_ERROR_CREATE_FROM_STATIC_STRING(
+            "field:lookup_table error: should be \"ring\" or \"maglev\""));
+      }
+    }
+    if (ParseJsonObjectField(json, "maglev_table_size", maglev_table_size,
+                             error_list, /*required=*/false) &&
+        (*maglev_table_size > 8388608 || !IsPrime(*maglev_table_size))) {
+      error_list->push_back(GRPC_ERROR_CREATE_FROM_STATIC_STRING(
+          "field:maglev_table_size error: should be a prime no larger "
+          "than 8388608"));
+    }
+    if (ParseJsonObjectField(json, "hash_balance_factor", hash_balance_factor,
+                             error_list, /*required=*/false) &&
+        *hash_balance_factor < 100) {
+      error_list->push_back(GRPC_ERROR_CREATE_FROM_STATIC_STRING(
+          "field:hash_balance_factor error: should be at least 100"));
+    }
+  }
 };
 
 }  // namespace
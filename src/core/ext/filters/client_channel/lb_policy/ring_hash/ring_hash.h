@@ -19,8 +19,16 @@
 
 #include <grpc/support/port_platform.h>
 
+#include <stdint.h>
 #include <stdlib.h>
 
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/status/status.h"
+
 #include "src/core/lib/iomgr/error.h"
 #include "src/core/lib/json/json.h"
 
@@ -32,6 +40,94 @@ extern const char* kRequestRingHashAttribute;
 void ParseRingHashLbConfig(const Json& json, size_t* min_ring_size,
                            size_t* max_ring_size,
                            std::vector<grpc_error_handle>* error_list);
+
+// An endpoint to be placed in a RingHashTable.  The key is hashed to
+// determine the endpoint's positions in the table.
+struct RingHashEndpoint {
+  std::string key;
+  uint32_t weight = 1;
+};
+
+// Maps request hashes to endpoints.  Each position in the table holds
+// the index of an endpoint; walking forward from the position returned by
+// Lookup() yields the endpoints to fall back to, in order.
+class RingHashTable {
+ public:
+  // Builds a ketama-style ring of between min_ring_size and max_ring_size
+  // entries, with each endpoint getting a number of entries proportional
+  // to its weight.  Lookups are a binary search over the ring.
+  static RingHashTable MakeRing(const std::vector<RingHashEndpoint>& endpoints,
+                                size_t min_ring_size, size_t max_ring_size);
+
+  // Builds a Maglev lookup table of table_size entries, which must be a
+  // prime accepted by ValidateMaglevTableSize().  Lookups are O(1), and the
+  // table is typically far smaller than an equivalent ring.
+  static RingHashTable MakeMaglev(
+      const std::vector<RingHashEndpoint>& endpoints, size_t table_size);
+
+  // Returns an error unless a Maglev table of table_size entries has at
+  // least kMinMaglevSlotsPerEndpoint slots for each of num_endpoints.
+  // Smaller tables map some endpoints to few or no slots.
+  static absl::Status ValidateMaglevTableSize(size_t table_size,
+                                              size_t num_endpoints);
+  static constexpr size_t kMinMaglevSlotsPerEndpoint = 10;
+
+  size_t size() const { return endpoint_indexes_.size(); }
+
+  // Returns the position in the table for a request hash.
+  size_t Lookup(uint64_t hash) const;
+
+  // Returns the index of the endpoint at a position in the table.
+  size_t endpoint_index(size_t position) const {
+    return endpoint_indexes_[position];
+  }
+
+ private:
+  // Sorted hashes of the ring entries.  Empty for Maglev tables.
+  std::vector<uint64_t> hashes_;
+  std::vector<uint32_t> endpoint_indexes_;
+};
+
+// Counts the calls in flight on each endpoint, for consistent hashing with
+// bounded loads: an endpoint may take its weighted share of the in-flight
+// calls, scaled by the hash balance factor (a percentage, at least 100).
+// Thread-safe.
+class RingHashLoadTracker {
+ public:
+  RingHashLoadTracker(std::vector<uint32_t> weights,
+                      uint32_t hash_balance_factor);
+
+  // Returns true if the endpoint can take another call without exceeding
+  // its share of the in-flight calls.
+  bool HasSpareCapacity(size_t endpoint_index) const;
+
+  // Returns the first position in table, starting at position and wrapping
+  // around, for which usable(position) is true and whose endpoint has spare
+  // capacity.  Returns position itself if there is none.
+  template <typename UsablePredicate>
+  size_t Spillover(const RingHashTable& table, size_t position,
+                   UsablePredicate usable) const {
+    for (size_t i = 0; i < table.size(); ++i) {
+      const size_t candidate = (position + i) % table.size();
+      if (usable(candidate) &&
+          HasSpareCapacity(table.endpoint_index(candidate))) {
+        return candidate;
+      }
+    }
+    return position;
+  }
+
+  void CallStarted(size_t endpoint_index);
+  void CallFinished(size_t endpoint_index);
+
+ private:
+  const uint32_t hash_balance_factor_;
+  const std::vector<uint32_t> weights_;
+  uint64_t total_weight_ = 0;
+  std::unique_ptr<std::atomic<uint32_t>[]> in_flight_;
+  std::atomic<uint32_t> total_in_flight_{0};
+};
+
 }  // namespace grpc_core
 
 #endif  // GRPC_CORE_EXT_FILTERS_CLIENT_CHANNEL_LB_POLICY_RING_HASH_RING_HASH_H
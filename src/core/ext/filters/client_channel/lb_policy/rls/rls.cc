@@ -343,7 +343,17 @@ class RlsLb : public LoadBalancingPolicy {
     RefCountedPtr<ChildPolicyWrapper> default_child_policy_;
   };
 
-  // An LRU cache with adjustable size.
+  // A cache with adjustable size.  Entries are evicted in approximately
+  // LRU order using the CLOCK (second chance) algorithm: a cache hit only
+  // sets a bit on the entry, and entries are reordered only when the
+  // cache needs to evict something.  This keeps the pick path, which
+  // runs under the policy's mutex, free of list manipulation and the
+  // allocations and key copies that came with it.
+  //
+  // The cache is deliberately not sharded, and the picker does not read it
+  // without the policy's mutex: entries share that mutex with their child
+  // policy wrappers, the request map and the throttle, all of which a pick
+  // may touch, so per-shard locks would not take it off the pick path.
   class Cache {
    public:
     using Iterator = std::list<RequestKey>::iterator;
@@ -416,8 +426,18 @@ class RlsLb : public LoadBalancingPolicy {
           ResponseInfo response, std::unique_ptr<BackOff> backoff_state)
           ABSL_EXCLUSIVE_LOCKS_REQUIRED(&RlsLb::mu_);
 
-      // Moves entry to the end of the LRU list.
-      void MarkUsed() ABSL_EXCLUSIVE_LOCKS_REQUIRED(&RlsLb::mu_);
+      // Marks the entry as recently used, giving it a second chance the
+      // next time it reaches the front of the eviction list.
+      void MarkUsed() ABSL_EXCLUSIVE_LOCKS_REQUIRED(&RlsLb::mu_) {
+        referenced_ = true;
+      }
+
+      // Clears the referenced bit.  Returns true if it was set.
+      bool ClearReferenced() ABSL_EXCLUSIVE_LOCKS_REQUIRED(&RlsLb::mu_) {
+        bool referenced = referenced_;
+        referenced_ = false;
+        return referenced;
+      }
 
      private:
       class BackoffTimer : public InternallyRefCounted<BackoffTimer> {
@@ -461,27 +481,27 @@ class RlsLb : public LoadBalancingPolicy {
 
       Timestamp min_expiration_time_ ABSL_GUARDED_BY(&RlsLb::mu_);
       Cache::Iterator lru_iterator_ ABSL_GUARDED_BY(&RlsLb::mu_);
+      bool referenced_ ABSL_GUARDED_BY(&RlsLb::mu_) = false;
     };
 
     explicit Cache(RlsLb* lb_policy);
 
     // Finds an entry from the cache that corresponds to a key. If an entry is
-    // not found, nullptr is returned. Otherwise, the entry is considered
-    // recently used and its order in the LRU list of the cache is updated.
+    // not found, nullptr is returned. Otherwise, the entry is marked as
+    // recently used.
     Entry* Find(const RequestKey& key)
         ABSL_EXCLUSIVE_LOCKS_REQUIRED(&RlsLb::mu_);
 
     // Finds an entry from the cache that corresponds to a key. If an entry is
     // not found, an entry is created, inserted in the cache, and returned to
     // the caller. Otherwise, the entry found is returned to the caller. The
-    // entry returned to the user is considered recently used and its order in
-    // the LRU list of the cache is updated.
+    // entry returned to the user is marked as recently used.
     Entry* FindOrInsert(const RequestKey& key)
         ABSL_EXCLUSIVE_LOCKS_REQUIRED(&RlsLb::mu_);
 
     // Resizes the cache. If the new cache size is greater than the current size
-    // of the cache, do nothing. Otherwise, evict the oldest entries that
-    // exceed the new size limit of the cache.
+    // of the cache, do nothing. Otherwise, evict the least recently used
+    // entries that exceed the new size limit of the cache.
     void Resize(size_t bytes) ABSL_EXCLUSIVE_LOCKS_REQUIRED(&RlsLb::mu_);
 
     // Resets backoff of all the cache entries.
@@ -497,7 +517,9 @@ class RlsLb : public LoadBalancingPolicy {
     static size_t EntrySizeForKey(const RequestKey& key);
 
     // Evicts oversized cache elements when the current size is greater than
-    // the specified limit.
+    // the specified limit.  Entries at the front of the LRU list that have
+    // been used since they were last considered are moved to the back
+    // instead of being evicted.
     void MaybeShrinkSize(size_t bytes)
         ABSL_EXCLUSIVE_LOCKS_REQUIRED(&RlsLb::mu_);
 
@@ -1224,17 +1246,10 @@ bool RlsLb::Cache::Entry::CanEvict() const {
   return min_expiration_time_ < now;
 }
 
-void RlsLb::Cache::Entry::MarkUsed() {
-  auto& lru_list = lb_policy_->cache_.lru_list_;
-  auto new_it = lru_list.insert(lru_list.end(), *lru_iterator_);
-  lru_list.erase(lru_iterator_);
-  lru_iterator_ = new_it;
-}
-
 std::vector<RlsLb::ChildPolicyWrapper*>
 RlsLb::Cache::Entry::OnRlsResponseLocked(
     ResponseInfo response, std::unique_ptr<BackOff> backoff_state) {
-  // Move the entry to the end of the LRU list.
+  // Mark the entry as recently used.
   MarkUsed();
   // If the request failed, store the failed status and update the
   // backoff state.
@@ -1424,6 +1439,12 @@ void RlsLb::Cache::MaybeShrinkSize(size_t bytes) {
     if (GPR_UNLIKELY(lru_it == lru_list_.end())) break;
     auto map_it = map_.find(*lru_it);
     GPR_ASSERT(map_it != map_.end());
+    // Give recently used entries a second chance.  This terminates,
+    // since each entry's referenced bit is cleared when it is moved.
+    if (map_it->second->ClearReferenced()) {
+      lru_list_.splice(lru_list_.end(), lru_list_, lru_it);
+      continue;
+    }
     if (!map_it->second->CanEvict()) break;
     if (GRPC_TRACE_FLAG_ENABLED(grpc_lb_rls_trace)) {
       gpr_log(GPR_INFO, "[rlslb %p] LRU eviction: removing entry %p %s",
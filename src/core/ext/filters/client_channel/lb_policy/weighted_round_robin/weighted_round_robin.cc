@@ -0,0 +1,973 @@
+//
+// Copyright 2022 gRPC authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include <grpc/support/port_platform.h>
+
+#include <inttypes.h>
+#include <stdlib.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <map>
+
+#include "absl/strings/str_cat.h"
+#include "absl/types/optional.h"
+
+#include <grpc/support/alloc.h>
+
+#include "src/core/ext/filters/client_channel/lb_policy/oob_backend_metric.h"
+#include "src/core/ext/filters/client_channel/lb_policy/subchannel_list.h"
+#include "src/core/ext/filters/client_channel/lb_policy_registry.h"
+#include "src/core/ext/filters/client_channel/subchannel.h"
+#include "src/core/lib/address_utils/sockaddr_utils.h"
+#include "src/core/lib/channel/channel_args.h"
+#include "src/core/lib/debug/trace.h"
+#include "src/core/lib/gprpp/orphanable.h"
+#include "src/core/lib/gprpp/ref_counted_ptr.h"
+#include "src/core/lib/gprpp/sync.h"
+#include "src/core/lib/iomgr/timer.h"
+#include "src/core/lib/iomgr/work_serializer.h"
+#include "src/core/lib/json/json_util.h"
+#include "src/core/lib/transport/connectivity_state.h"
+#include "src/core/lib/transport/error_utils.h"
+
+namespace grpc_core {
+
+TraceFlag grpc_lb_wrr_trace(false, "weighted_round_robin_lb");
+
+namespace {
+
+//
+// weighted_round_robin LB policy
+//
+
+constexpr char kWeightedRoundRobin[] = "weighted_round_robin_experimental";
+
+// Weight updates more frequent than this are not useful.
+constexpr Duration kMinWeightUpdatePeriod = Duration::Milliseconds(100);
+
+// Config for weighted_round_robin LB policy.
+class WeightedRoundRobinConfig : public LoadBalancingPolicy::Config {
+ public:
+  WeightedRoundRobinConfig(bool enable_oob_load_report,
+                           Duration oob_reporting_period,
+                           Duration blackout_period,
+                           Duration weight_update_period,
+                           Duration weight_expiration_period)
+      : enable_oob_load_report_(enable_oob_load_report),
+        oob_reporting_period_(oob_reporting_period),
+        blackout_period_(blackout_period),
+        weight_update_period_(weight_update_period),
+        weight_expiration_period_(weight_expiration_period) {}
+
+  const char* name() const override { return kWeightedRoundRobin; }
+
+  bool enable_oob_load_report() const { return enable_oob_load_report_; }
+  Duration oob_reporting_period() const { return oob_reporting_period_; }
+  Duration blackout_period() const { return blackout_period_; }
+  Duration weight_update_period() const { return weight_update_period_; }
+  Duration weight_expiration_period() const {
+    return weight_expiration_period_;
+  }
+
+ private:
+  bool enable_oob_load_report_;
+  Duration oob_reporting_period_;
+  Duration blackout_period_;
+  Duration weight_update_period_;
+  Duration weight_expiration_period_;
+};
+
+// The weight of an address, computed from the backend metrics it
+// reports.  Shared by every subchannel list and picker that uses the
+// address, so that weights survive address list updates.  Updated from
+// the data plane (per-call reports) or from the subchannel's ORCA stream
+// (out-of-band reports), and read from the WorkSerializer when pickers
+// are built.
+class AddressWeight : public RefCounted<AddressWeight> {
+ public:
+  // Records a new backend metric report.  Reports that do not yield a
+  // usable weight are ignored.
+  void MaybeUpdateWeight(double qps, double cpu_utilization, Timestamp now) {
+    if (qps <= 0 || cpu_utilization <= 0) return;
+    const float weight = qps / cpu_utilization;
+    MutexLock lock(&mu_);
+    if (non_empty_since_ == Timestamp::InfFuture()) non_empty_since_ = now;
+    last_update_time_ = now;
+    weight_ = weight;
+  }
+
+  // Returns the current weight, or 0 if the address has no weight that
+  // can be used yet: either no reports have arrived within the
+  // expiration period, or the address is still within its blackout
+  // period after first reporting.
+  float GetWeight(Timestamp now, Duration weight_expiration_period,
+                  Duration blackout_period) {
+    MutexLock lock(&mu_);
+    if (now - last_update_time_ >= weight_expiration_period) {
+      non_empty_since_ = Timestamp::InfFuture();
+      return 0;
+    }
+    if (blackout_period > Duration::Zero() &&
+        now - non_empty_since_ < blackout_period) {
+      return 0;
+    }
+    return weight_;
+  }
+
+  // Restarts the blackout period.  Called when the address becomes
+  // READY, since its load will change as calls shift to it.
+  void ResetNonEmptySince() {
+    MutexLock lock(&mu_);
+    non_empty_since_ = Timestamp::InfFuture();
+  }
+
+ private:
+  Mutex mu_;
+  float weight_ ABSL_GUARDED_BY(&mu_) = 0;
+  Timestamp non_empty_since_ ABSL_GUARDED_BY(&mu_) = Timestamp::InfFuture();
+  Timestamp last_update_time_ ABSL_GUARDED_BY(&mu_) = Timestamp::InfPast();
+};
+
+// An earliest-deadline-first schedule over a fixed set of weights,
+// computed without any shared mutable state other than a single atomic
+// sequence number.
+//
+// Each weight is scaled to [1, kMaxWeight].  Entry i is due in
+// generation g when (weight_i * g + offset_i) crosses a multiple of
+// kMaxWeight, so an entry with weight w is picked w / kMaxWeight as often
+// as the heaviest entry, which is picked every generation.  Per-entry
+// offsets keep entries with equal weights from being picked in bursts.
+class StaticStrideScheduler {
+ public:
+  // Returns null if the weights do not call for weighted picking, i.e.
+  // fewer than two entries have a non-zero weight.  Entries with zero
+  // weight get the mean of the non-zero weights.
+  static absl::optional<StaticStrideScheduler> Make(
+      const std::vector<float>& weights, uint32_t initial_sequence) {
+    size_t num_nonzero = 0;
+    float sum = 0;
+    float max = 0;
+    for (float weight : weights) {
+      if (weight > 0) {
+        ++num_nonzero;
+        sum += weight;
+        max = std::max(max, weight);
+      }
+    }
+    if (num_nonzero < 2) return absl::nullopt;
+    const float mean = sum / num_nonzero;
+    const float scale = kMaxWeight / std::max(max, mean);
+    std::vector<uint16_t> scaled_weights;
+    scaled_weights.reserve(weights.size());
+    for (float weight : weights) {
+      if (weight <= 0) weight = mean;
+      scaled_weights.push_back(static_cast<uint16_t>(
+          std::max(1.0f, std::min(std::ceil(weight * scale),
+                                  static_cast<float>(kMaxWeight)))));
+    }
+    return StaticStrideScheduler(std::move(scaled_weights), initial_sequence);
+  }
+
+  StaticStrideScheduler(StaticStrideScheduler&& other) noexcept
+      : weights_(std::move(other.weights_)),
+        sequence_(other.sequence_.load(std::memory_order_relaxed)) {}
+
+  // Returns the index of the next entry.  Thread-safe and lock-free.
+  size_t Pick() {
+    while (true) {
+      const uint64_t sequence =
+          sequence_.fetch_add(1, std::memory_order_relaxed);
+      const uint64_t index = sequence % weights_.size();
+      const uint64_t generation = sequence / weights_.size();
+      const uint64_t weight = weights_[index];
+      const uint64_t offset = kMaxWeight / 2 * index;
+      if ((weight * generation + offset) % kMaxWeight < kMaxWeight - weight) {
+        continue;
+      }
+      return static_cast<size_t>(index);
+    }
+  }
+
+ private:
+  static constexpr uint16_t kMaxWeight = 0xffff;
+
+  StaticStrideScheduler(std::vector<uint16_t> weights,
+                        uint32_t initial_sequence)
+      : weights_(std::move(weights)), sequence_(initial_sequence) {}
+
+  std::vector<uint16_t> weights_;
+  std::atomic<uint64_t> sequence_;
+};
+
+class WeightedRoundRobin : public LoadBalancingPolicy {
+ public:
+  explicit WeightedRoundRobin(Args args);
+
+  const char* name() const override { return kWeightedRoundRobin; }
+
+  void UpdateLocked(UpdateArgs args) override;
+  void ResetBackoffLocked() override;
+
+ private:
+  ~WeightedRoundRobin() override;
+
+  // Forward declaration.
+  class WrrSubchannelList;
+
+  // Data for a particular subchannel in a subchannel list.
+  // This subclass adds the following functionality:
+  // - Tracks the previous connectivity state of the subchannel, so that
+  //   we know how many subchannels are in each state.
+  // - Holds the weight of the subchannel's address, and feeds it from
+  //   the subchannel's ORCA stream if out-of-band reporting is enabled.
+  class WrrSubchannelData
+      : public SubchannelData<WrrSubchannelList, WrrSubchannelData> {
+   public:
+    WrrSubchannelData(
+        SubchannelList<WrrSubchannelList, WrrSubchannelData>* subchannel_list,
+        const ServerAddress& address,
+        RefCountedPtr<SubchannelInterface> subchannel);
+
+    grpc_connectivity_state connectivity_state() const {
+      return logical_connectivity_state_;
+    }
+
+    RefCountedPtr<AddressWeight> weight() const { return weight_; }
+
+    // Computes and updates the logical connectivity state of the subchannel.
+    // Note that the logical connectivity state may differ from the
+    // actual reported state in some cases (e.g., after we see
+    // TRANSIENT_FAILURE, we ignore any subsequent state changes until
+    // we see READY).  Returns true if the state changed.
+    bool UpdateLogicalConnectivityStateLocked(
+        grpc_connectivity_state connectivity_state);
+
+   private:
+    class OobWatcher : public OobBackendMetricWatcher {
+     public:
+      explicit OobWatcher(RefCountedPtr<AddressWeight> weight)
+          : weight_(std::move(weight)) {}
+
+      void OnBackendMetricReport(
+          const BackendMetricAccessor::BackendMetricData& backend_metric_data)
+          override {
+        weight_->MaybeUpdateWeight(backend_metric_data.requests_per_second,
+                                   backend_metric_data.cpu_utilization,
+                                   ExecCtx::Get()->Now());
+      }
+
+     private:
+      RefCountedPtr<AddressWeight> weight_;
+    };
+
+    // Performs connectivity state updates that need to be done only
+    // after we have started watching.
+    void ProcessConnectivityChangeLocked(
+        grpc_connectivity_state connectivity_state) override;
+
+    grpc_connectivity_state logical_connectivity_state_ = GRPC_CHANNEL_IDLE;
+    RefCountedPtr<AddressWeight> weight_;
+  };
+
+  // A list of subchannels.
+  class WrrSubchannelList
+      : public SubchannelList<WrrSubchannelList, WrrSubchannelData> {
+   public:
+    WrrSubchannelList(WeightedRoundRobin* policy, TraceFlag* tracer,
+                      ServerAddressList addresses,
+                      const grpc_channel_args& args)
+        : SubchannelList(policy, tracer, std::move(addresses),
+                         policy->channel_control_helper(), args) {
+      // Need to maintain a ref to the LB policy as long as we maintain
+      // any references to subchannels, since the subchannels'
+      // pollset_sets will include the LB policy's pollset_set.
+      policy->Ref(DEBUG_LOCATION, "subchannel_list").release();
+    }
+
+    ~WrrSubchannelList() override {
+      WeightedRoundRobin* p = static_cast<WeightedRoundRobin*>(policy());
+      p->Unref(DEBUG_LOCATION, "subchannel_list");
+    }
+
+    size_t num_ready() const { return num_ready_; }
+
+    // Starts watching the subchannels in this list.
+    void StartWatchingLocked(absl::Status status_for_tf);
+
+    // Updates the counters of subchannels in each state when a
+    // subchannel transitions from old_state to new_state.
+    void UpdateStateCountersLocked(grpc_connectivity_state old_state,
+                                   grpc_connectivity_state new_state);
+
+    // Ensures that the right subchannel list is used and then updates
+    // the policy's connectivity state based on the subchannel list's
+    // state counters.
+    void MaybeUpdateConnectivityStateLocked(absl::Status status_for_tf);
+
+   private:
+    std::string CountersString() const {
+      return absl::StrCat("num_subchannels=", num_subchannels(),
+                          " num_ready=", num_ready_,
+                          " num_connecting=", num_connecting_,
+                          " num_transient_failure=", num_transient_failure_);
+    }
+
+    size_t num_ready_ = 0;
+    size_t num_connecting_ = 0;
+    size_t num_transient_failure_ = 0;
+  };
+
+  // Picks READY subchannels in proportion to their weights.  Weights
+  // are captured when the picker is built; the policy builds a new
+  // picker when they change, so picks never take a lock.
+  class Picker : public SubchannelPicker {
+   public:
+    Picker(WeightedRoundRobin* parent,
+           absl::InlinedVector<std::pair<RefCountedPtr<SubchannelInterface>,
+                                         RefCountedPtr<AddressWeight>>,
+                               10>
+               subchannels,
+           const std::vector<float>& weights);
+
+    PickResult Pick(PickArgs args) override;
+
+   private:
+    class SubchannelCallTracker;
+
+    Picker(WeightedRoundRobin* parent,
+           absl::InlinedVector<std::pair<RefCountedPtr<SubchannelInterface>,
+                                         RefCountedPtr<AddressWeight>>,
+                               10>
+               subchannels,
+           const std::vector<float>& weights, uint32_t initial_sequence);
+
+    // Using pointer value only, no ref held -- do not dereference!
+    WeightedRoundRobin* parent_;
+
+    bool record_call_results_;
+    absl::InlinedVector<std::pair<RefCountedPtr<SubchannelInterface>,
+                                  RefCountedPtr<AddressWeight>>,
+                        10>
+        subchannels_;
+    // Used when weights are available.
+    absl::optional<StaticStrideScheduler> scheduler_;
+    // Used for plain round robin otherwise.
+    std::atomic<size_t> last_picked_index_;
+  };
+
+  class WeightUpdateTimer : public InternallyRefCounted<WeightUpdateTimer> {
+   public:
+    explicit WeightUpdateTimer(RefCountedPtr<WeightedRoundRobin> parent);
+
+    void Orphan() override;
+
+   private:
+    static void OnTimer(void* arg, grpc_error_handle error);
+    void OnTimerLocked(grpc_error_handle);
+
+    RefCountedPtr<WeightedRoundRobin> parent_;
+    grpc_timer timer_;
+    grpc_closure on_timer_;
+    bool timer_pending_ = true;
+  };
+
+  void ShutdownLocked() override;
+
+  static std::string MakeKeyForAddress(const ServerAddress& address);
+
+  // Returns a picker for the READY subchannels in subchannel_list.
+  std::unique_ptr<SubchannelPicker> CreatePickerLocked(
+      WrrSubchannelList* subchannel_list);
+
+  // Called periodically to pick up weight changes.
+  void UpdateWeightsLocked();
+
+  // Current config from the resolver.
+  RefCountedPtr<WeightedRoundRobinConfig> config_;
+
+  // Weights of current addresses, keyed by the string form of the address.
+  std::map<std::string, RefCountedPtr<AddressWeight>> address_weight_map_;
+
+  // List of subchannels.
+  OrphanablePtr<WrrSubchannelList> subchannel_list_;
+  // Latest pending subchannel list.
+  // When we get an updated address list, we create a new subchannel list
+  // for it here, and we wait to swap it into subchannel_list_ until the new
+  // list becomes READY.
+  OrphanablePtr<WrrSubchannelList> latest_pending_subchannel_list_;
+
+  // Weights used by the most recently created picker.
+  std::vector<float> picker_weights_;
+
+  OrphanablePtr<WeightUpdateTimer> weight_update_timer_;
+
+  bool shutdown_ = false;
+};
+
+//
+// WeightedRoundRobin::Picker::SubchannelCallTracker
+//
+
+class WeightedRoundRobin::Picker::SubchannelCallTracker
+    : public LoadBalancingPolicy::SubchannelCallTrackerInterface {
+ public:
+  explicit SubchannelCallTracker(RefCountedPtr<AddressWeight> weight)
+      : weight_(std::move(weight)) {}
+
+  void Start() override {}
+
+  void Finish(FinishArgs args) override {
+    if (args.backend_metric_accessor == nullptr) return;
+    const BackendMetricAccessor::BackendMetricData* backend_metric_data =
+        args.backend_metric_accessor->GetBackendMetricData();
+    if (backend_metric_data == nullptr) return;
+    weight_->MaybeUpdateWeight(backend_metric_data->requests_per_second,
+                               backend_metric_data->cpu_utilization,
+                               ExecCtx::Get()->Now());
+  }
+
+ private:
+  RefCountedPtr<AddressWeight> weight_;
+};
+
+//
+// WeightedRoundRobin::Picker
+//
+
+// For discussion on why we generate a random starting index for
+// the picker, see https://github.com/grpc/grpc-go/issues/2580.
+// TODO(roth): rand(3) is not thread-safe.  This should be replaced with
+// something better as part of https://github.com/grpc/grpc/issues/17891.
+WeightedRoundRobin::Picker::Picker(
+    WeightedRoundRobin* parent,
+    absl::InlinedVector<std::pair<RefCountedPtr<SubchannelInterface>,
+                                  RefCountedPtr<AddressWeight>>,
+                        10>
+        subchannels,
+    const std::vector<float>& weights)
+    : Picker(parent, std::move(subchannels), weights, rand()) {}
+
+WeightedRoundRobin::Picker::Picker(
+    WeightedRoundRobin* parent,
+    absl::InlinedVector<std::pair<RefCountedPtr<SubchannelInterface>,
+                                  RefCountedPtr<AddressWeight>>,
+                        10>
+        subchannels,
+    const std::vector<float>& weights, uint32_t initial_sequence)
+    : parent_(parent),
+      record_call_results_(!parent->config_->enable_oob_load_report()),
+      subchannels_(std::move(subchannels)),
+      // StaticStrideScheduler holds an atomic and cannot be assigned.
+      scheduler_(StaticStrideScheduler::Make(weights, initial_sequence)),
+      last_picked_index_(initial_sequence % subchannels_.size()) {
+  if (GRPC_TRACE_FLAG_ENABLED(grpc_lb_wrr_trace)) {
+    gpr_log(GPR_INFO,
+            "[WRR %p picker %p] created picker with %" PRIuPTR
+            " READY subchannels; using %s",
+            parent_, this, subchannels_.size(),
+            scheduler_.has_value() ? "weights" : "round robin");
+  }
+}
+
+WeightedRoundRobin::PickResult WeightedRoundRobin::Picker::Pick(
+    PickArgs /*args*/) {
+  size_t index;
+  if (scheduler_.has_value()) {
+    index = scheduler_->Pick();
+  } else {
+    index = last_picked_index_.fetch_add(1, std::memory_order_relaxed) %
+            subchannels_.size();
+  }
+  if (GRPC_TRACE_FLAG_ENABLED(grpc_lb_wrr_trace)) {
+    gpr_log(GPR_INFO,
+            "[WRR %p picker %p] returning index %" PRIuPTR ", subchannel=%p",
+            parent_, this, index, subchannels_[index].first.get());
+  }
+  // When weights come from the ORCA stream, there is no need to look at
+  // per-call backend metrics.
+  std::unique_ptr<SubchannelCallTrackerInterface> subchannel_call_tracker;
+  if (record_call_results_) {
+    subchannel_call_tracker =
+        absl::make_unique<SubchannelCallTracker>(subchannels_[index].second);
+  }
+  return PickResult::Complete(subchannels_[index].first,
+                              std::move(subchannel_call_tracker));
+}
+
+//
+// WeightedRoundRobin::WeightUpdateTimer
+//
+
+WeightedRoundRobin::WeightUpdateTimer::WeightUpdateTimer(
+    RefCountedPtr<WeightedRoundRobin> parent)
+    : parent_(std::move(parent)) {
+  GRPC_CLOSURE_INIT(&on_timer_, OnTimer, this, nullptr);
+  Ref(DEBUG_LOCATION, "Timer").release();
+  grpc_timer_init(
+      &timer_,
+      ExecCtx::Get()->Now() + parent_->config_->weight_update_period(),
+      &on_timer_);
+}
+
+void WeightedRoundRobin::WeightUpdateTimer::Orphan() {
+  if (timer_pending_) {
+    timer_pending_ = false;
+    grpc_timer_cancel(&timer_);
+  }
+  Unref();
+}
+
+void WeightedRoundRobin::WeightUpdateTimer::OnTimer(void* arg,
+                                                    grpc_error_handle error) {
+  auto* self = static_cast<WeightUpdateTimer*>(arg);
+  (void)GRPC_ERROR_REF(error);  // ref owned by lambda
+  self->parent_->work_serializer()->Run(
+      [self, error]() { self->OnTimerLocked(error); }, DEBUG_LOCATION);
+}
+
+void WeightedRoundRobin::WeightUpdateTimer::OnTimerLocked(
+    grpc_error_handle error) {
+  if (error == GRPC_ERROR_NONE && timer_pending_) {
+    timer_pending_ = false;
+    parent_->UpdateWeightsLocked();
+    parent_->weight_update_timer_ =
+        MakeOrphanable<WeightUpdateTimer>(parent_);
+  }
+  Unref(DEBUG_LOCATION, "Timer");
+  GRPC_ERROR_UNREF(error);
+}
+
+//
+// WeightedRoundRobin
+//
+
+WeightedRoundRobin::WeightedRoundRobin(Args args)
+    : LoadBalancingPolicy(std::move(args)) {
+  if (GRPC_TRACE_FLAG_ENABLED(grpc_lb_wrr_trace)) {
+    gpr_log(GPR_INFO, "[WRR %p] Created", this);
+  }
+}
+
+WeightedRoundRobin::~WeightedRoundRobin() {
+  if (GRPC_TRACE_FLAG_ENABLED(grpc_lb_wrr_trace)) {
+    gpr_log(GPR_INFO, "[WRR %p] Destroying weighted_round_robin policy",
+            this);
+  }
+  GPR_ASSERT(subchannel_list_ == nullptr);
+  GPR_ASSERT(latest_pending_subchannel_list_ == nullptr);
+}
+
+void WeightedRoundRobin::ShutdownLocked() {
+  if (GRPC_TRACE_FLAG_ENABLED(grpc_lb_wrr_trace)) {
+    gpr_log(GPR_INFO, "[WRR %p] Shutting down", this);
+  }
+  shutdown_ = true;
+  weight_update_timer_.reset();
+  subchannel_list_.reset();
+  latest_pending_subchannel_list_.reset();
+}
+
+void WeightedRoundRobin::ResetBackoffLocked() {
+  subchannel_list_->ResetBackoffLocked();
+  if (latest_pending_subchannel_list_ != nullptr) {
+    latest_pending_subchannel_list_->ResetBackoffLocked();
+  }
+}
+
+std::string WeightedRoundRobin::MakeKeyForAddress(
+    const ServerAddress& address) {
+  // Use only the address, not the attributes.
+  auto addr_str = grpc_sockaddr_to_string(&address.address(), false);
+  // If address couldn't be stringified, ignore it.
+  if (!addr_str.ok()) return "";
+  return std::move(*addr_str);
+}
+
+void WeightedRoundRobin::UpdateLocked(UpdateArgs args) {
+  config_ = std::move(args.config);
+  ServerAddressList addresses;
+  if (args.addresses.ok()) {
+    if (GRPC_TRACE_FLAG_ENABLED(grpc_lb_wrr_trace)) {
+      gpr_log(GPR_INFO, "[WRR %p] received update with %" PRIuPTR " addresses",
+              this, args.addresses->size());
+    }
+    addresses = std::move(*args.addresses);
+    // Keep the weights of addresses that are still present, so that a
+    // re-resolution does not reset them.
+    std::map<std::string, RefCountedPtr<AddressWeight>> address_weight_map;
+    for (const ServerAddress& address : addresses) {
+      std::string key = MakeKeyForAddress(address);
+      if (key.empty()) continue;
+      auto it = address_weight_map_.find(key);
+      address_weight_map.emplace(key, it != address_weight_map_.end()
+                                          ? it->second
+                                          : MakeRefCounted<AddressWeight>());
+    }
+    address_weight_map_ = std::move(address_weight_map);
+  } else {
+    if (GRPC_TRACE_FLAG_ENABLED(grpc_lb_wrr_trace)) {
+      gpr_log(GPR_INFO, "[WRR %p] received update with address error: %s",
+              this, args.addresses.status().ToString().c_str());
+    }
+    // If we already have a subchannel list, then ignore the resolver
+    // failure and keep using the existing list.
+    if (subchannel_list_ != nullptr) return;
+  }
+  // (Re)start the weight update timer, since its period may have changed.
+  weight_update_timer_ = MakeOrphanable<WeightUpdateTimer>(
+      Ref(DEBUG_LOCATION, "WeightUpdateTimer"));
+  // Create new subchannel list, replacing the previous pending list, if any.
+  if (GRPC_TRACE_FLAG_ENABLED(grpc_lb_wrr_trace) &&
+      latest_pending_subchannel_list_ != nullptr) {
+    gpr_log(GPR_INFO, "[WRR %p] replacing previous pending subchannel list %p",
+            this, latest_pending_subchannel_list_.get());
+  }
+  latest_pending_subchannel_list_ = MakeOrphanable<WrrSubchannelList>(
+      this, &grpc_lb_wrr_trace, std::move(addresses), *args.args);
+  // Start watching the new list.  If appropriate, this will cause it to be
+  // immediately promoted to subchannel_list_ and to generate a new picker.
+  latest_pending_subchannel_list_->StartWatchingLocked(
+      args.addresses.ok() ? absl::UnavailableError(absl::StrCat(
+                                "empty address list: ", args.resolution_note))
+                          : args.addresses.status());
+}
+
+std::unique_ptr<LoadBalancingPolicy::SubchannelPicker>
+WeightedRoundRobin::CreatePickerLocked(WrrSubchannelList* subchannel_list) {
+  const Timestamp now = ExecCtx::Get()->Now();
+  absl::InlinedVector<std::pair<RefCountedPtr<SubchannelInterface>,
+                                RefCountedPtr<AddressWeight>>,
+                      10>
+      subchannels;
+  std::vector<float> weights;
+  for (size_t i = 0; i < subchannel_list->num_subchannels(); ++i) {
+    WrrSubchannelData* sd = subchannel_list->subchannel(i);
+    if (sd->connectivity_state() == GRPC_CHANNEL_READY) {
+      subchannels.emplace_back(sd->subchannel()->Ref(), sd->weight());
+      weights.push_back(sd->weight()->GetWeight(
+          now, config_->weight_expiration_period(),
+          config_->blackout_period()));
+    }
+  }
+  auto picker =
+      absl::make_unique<Picker>(this, std::move(subchannels), weights);
+  picker_weights_ = std::move(weights);
+  return picker;
+}
+
+void WeightedRoundRobin::UpdateWeightsLocked() {
+  if (subchannel_list_ == nullptr || subchannel_list_->num_ready() == 0) {
+    return;
+  }
+  // Only replace the picker if the weights actually changed, since a
+  // picker update makes the channel reprocess any queued picks.
+  const Timestamp now = ExecCtx::Get()->Now();
+  std::vector<float> weights;
+  for (size_t i = 0; i < subchannel_list_->num_subchannels(); ++i) {
+    WrrSubchannelData* sd = subchannel_list_->subchannel(i);
+    if (sd->connectivity_state() == GRPC_CHANNEL_READY) {
+      weights.push_back(sd->weight()->GetWeight(
+          now, config_->weight_expiration_period(),
+          config_->blackout_period()));
+    }
+  }
+  if (weights == picker_weights_) return;
+  if (GRPC_TRACE_FLAG_ENABLED(grpc_lb_wrr_trace)) {
+    gpr_log(GPR_INFO, "[WRR %p] weights changed, updating picker", this);
+  }
+  channel_control_helper()->UpdateState(
+      GRPC_CHANNEL_READY, absl::Status(),
+      CreatePickerLocked(subchannel_list_.get()));
+}
+
+//
+// WrrSubchannelList
+//
+
+void WeightedRoundRobin::WrrSubchannelList::StartWatchingLocked(
+    absl::Status status_for_tf) {
+  // Check current state of each subchannel synchronously, since any
+  // subchannel already used by some other channel may have a non-IDLE
+  // state.
+  for (size_t i = 0; i < num_subchannels(); ++i) {
+    grpc_connectivity_state state =
+        subchannel(i)->CheckConnectivityStateLocked();
+    if (state != GRPC_CHANNEL_IDLE) {
+      subchannel(i)->UpdateLogicalConnectivityStateLocked(state);
+    }
+  }
+  // Start connectivity watch for each subchannel.
+  for (size_t i = 0; i < num_subchannels(); i++) {
+    if (subchannel(i)->subchannel() != nullptr) {
+      subchannel(i)->StartConnectivityWatchLocked();
+      subchannel(i)->subchannel()->RequestConnection();
+    }
+  }
+  // Update connectivity state if needed.
+  MaybeUpdateConnectivityStateLocked(status_for_tf);
+}
+
+void WeightedRoundRobin::WrrSubchannelList::UpdateStateCountersLocked(
+    grpc_connectivity_state old_state, grpc_connectivity_state new_state) {
+  GPR_ASSERT(old_state != GRPC_CHANNEL_SHUTDOWN);
+  GPR_ASSERT(new_state != GRPC_CHANNEL_SHUTDOWN);
+  if (old_state == GRPC_CHANNEL_READY) {
+    GPR_ASSERT(num_ready_ > 0);
+    --num_ready_;
+  } else if (old_state == GRPC_CHANNEL_CONNECTING) {
+    GPR_ASSERT(num_connecting_ > 0);
+    --num_connecting_;
+  } else if (old_state == GRPC_CHANNEL_TRANSIENT_FAILURE) {
+    GPR_ASSERT(num_transient_failure_ > 0);
+    --num_transient_failure_;
+  }
+  if (new_state == GRPC_CHANNEL_READY) {
+    ++num_ready_;
+  } else if (new_state == GRPC_CHANNEL_CONNECTING) {
+    ++num_connecting_;
+  } else if (new_state == GRPC_CHANNEL_TRANSIENT_FAILURE) {
+    ++num_transient_failure_;
+  }
+}
+
+void WeightedRoundRobin::WrrSubchannelList::MaybeUpdateConnectivityStateLocked(
+    absl::Status status_for_tf) {
+  WeightedRoundRobin* p = static_cast<WeightedRoundRobin*>(policy());
+  // If this is latest_pending_subchannel_list_, then swap it into
+  // subchannel_list_ in the following cases:
+  // - subchannel_list_ is null (i.e., this is the first update).
+  // - subchannel_list_ has no READY subchannels.
+  // - This list has at least one READY subchannel.
+  // - All of the subchannels in this list are in TRANSIENT_FAILURE, or
+  //   the list is empty.  (This may cause the channel to go from READY
+  //   to TRANSIENT_FAILURE, but we're doing what the control plane told
+  //   us to do.
+  if (p->latest_pending_subchannel_list_.get() == this &&
+      (p->subchannel_list_ == nullptr || p->subchannel_list_->num_ready_ == 0 ||
+       num_ready_ > 0 ||
+       // Note: num_transient_failure_ and num_subchannels() may both be 0.
+       num_transient_failure_ == num_subchannels())) {
+    if (GRPC_TRACE_FLAG_ENABLED(grpc_lb_wrr_trace)) {
+      const std::string old_counters_string =
+          p->subchannel_list_ != nullptr ? p->subchannel_list_->CountersString()
+                                         : "";
+      gpr_log(
+          GPR_INFO,
+          "[WRR %p] swapping out subchannel list %p (%s) in favor of %p (%s)",
+          p, p->subchannel_list_.get(), old_counters_string.c_str(), this,
+          CountersString().c_str());
+    }
+    p->subchannel_list_ = std::move(p->latest_pending_subchannel_list_);
+  }
+  // Only set connectivity state if this is the current subchannel list.
+  if (p->subchannel_list_.get() != this) return;
+  // First matching rule wins:
+  // 1) ANY subchannel is READY => policy is READY.
+  // 2) ANY subchannel is CONNECTING => policy is CONNECTING.
+  // 3) ALL subchannels are TRANSIENT_FAILURE => policy is TRANSIENT_FAILURE.
+  if (num_ready_ > 0) {
+    if (GRPC_TRACE_FLAG_ENABLED(grpc_lb_wrr_trace)) {
+      gpr_log(GPR_INFO, "[WRR %p] reporting READY with subchannel list %p", p,
+              this);
+    }
+    p->channel_control_helper()->UpdateState(GRPC_CHANNEL_READY,
+                                             absl::Status(),
+                                             p->CreatePickerLocked(this));
+  } else if (num_connecting_ > 0) {
+    if (GRPC_TRACE_FLAG_ENABLED(grpc_lb_wrr_trace)) {
+      gpr_log(GPR_INFO, "[WRR %p] reporting CONNECTING with subchannel list %p",
+              p, this);
+    }
+    p->channel_control_helper()->UpdateState(
+        GRPC_CHANNEL_CONNECTING, absl::Status(),
+        absl::make_unique<QueuePicker>(p->Ref(DEBUG_LOCATION, "QueuePicker")));
+  } else if (num_transient_failure_ == num_subchannels()) {
+    if (GRPC_TRACE_FLAG_ENABLED(grpc_lb_wrr_trace)) {
+      gpr_log(
+          GPR_INFO,
+          "[WRR %p] reporting TRANSIENT_FAILURE with subchannel list %p: %s",
+          p, this, status_for_tf.ToString().c_str());
+    }
+    p->channel_control_helper()->UpdateState(
+        GRPC_CHANNEL_TRANSIENT_FAILURE, status_for_tf,
+        absl::make_unique<TransientFailurePicker>(status_for_tf));
+  }
+}
+
+//
+// WrrSubchannelData
+//
+
+WeightedRoundRobin::WrrSubchannelData::WrrSubchannelData(
+    SubchannelList<WrrSubchannelList, WrrSubchannelData>* subchannel_list,
+    const ServerAddress& address, RefCountedPtr<SubchannelInterface> subchannel)
+    : SubchannelData(subchannel_list, address, std::move(subchannel)) {
+  WeightedRoundRobin* p =
+      static_cast<WeightedRoundRobin*>(subchannel_list->policy());
+  auto it = p->address_weight_map_.find(MakeKeyForAddress(address));
+  weight_ = it != p->address_weight_map_.end()
+                ? it->second
+                : MakeRefCounted<AddressWeight>();
+  if (p->config_->enable_oob_load_report()) {
+    this->subchannel()->AddDataWatcher(MakeOobBackendMetricWatcher(
+        p->config_->oob_reporting_period(),
+        absl::make_unique<OobWatcher>(weight_)));
+  }
+}
+
+bool WeightedRoundRobin::WrrSubchannelData::
+    UpdateLogicalConnectivityStateLocked(
+        grpc_connectivity_state connectivity_state) {
+  WeightedRoundRobin* p =
+      static_cast<WeightedRoundRobin*>(subchannel_list()->policy());
+  if (GRPC_TRACE_FLAG_ENABLED(grpc_lb_wrr_trace)) {
+    gpr_log(
+        GPR_INFO,
+        "[WRR %p] connectivity changed for subchannel %p, subchannel_list %p "
+        "(index %" PRIuPTR " of %" PRIuPTR "): prev_state=%s new_state=%s",
+        p, subchannel(), subchannel_list(), Index(),
+        subchannel_list()->num_subchannels(),
+        ConnectivityStateName(logical_connectivity_state_),
+        ConnectivityStateName(connectivity_state));
+  }
+  // Decide what state to report for aggregation purposes.
+  // If the last logical state was TRANSIENT_FAILURE, then ignore the
+  // state change unless the new state is READY.
+  if (logical_connectivity_state_ == GRPC_CHANNEL_TRANSIENT_FAILURE &&
+      connectivity_state != GRPC_CHANNEL_READY) {
+    return false;
+  }
+  // If the new state is IDLE, treat it as CONNECTING, since it will
+  // immediately transition into CONNECTING anyway.
+  if (connectivity_state == GRPC_CHANNEL_IDLE) {
+    if (GRPC_TRACE_FLAG_ENABLED(grpc_lb_wrr_trace)) {
+      gpr_log(GPR_INFO,
+              "[WRR %p] subchannel %p, subchannel_list %p (index %" PRIuPTR
+              " of %" PRIuPTR "): treating IDLE as CONNECTING",
+              p, subchannel(), subchannel_list(), Index(),
+              subchannel_list()->num_subchannels());
+    }
+    connectivity_state = GRPC_CHANNEL_CONNECTING;
+  }
+  // If no change, return false.
+  if (logical_connectivity_state_ == connectivity_state) return false;
+  // When the subchannel becomes READY, its load is about to change, so
+  // don't trust its weight until the blackout period has passed again.
+  if (connectivity_state == GRPC_CHANNEL_READY) weight_->ResetNonEmptySince();
+  // Otherwise, update counters and logical state.
+  subchannel_list()->UpdateStateCountersLocked(logical_connectivity_state_,
+                                               connectivity_state);
+  logical_connectivity_state_ = connectivity_state;
+  return true;
+}
+
+void WeightedRoundRobin::WrrSubchannelData::ProcessConnectivityChangeLocked(
+    grpc_connectivity_state connectivity_state) {
+  WeightedRoundRobin* p =
+      static_cast<WeightedRoundRobin*>(subchannel_list()->policy());
+  GPR_ASSERT(subchannel() != nullptr);
+  // If the new state is TRANSIENT_FAILURE or IDLE, re-resolve.
+  // Only do this if we've started watching, not at startup time.
+  // Otherwise, if the subchannel was already in state TRANSIENT_FAILURE
+  // when the subchannel list was created, we'd wind up in a constant
+  // loop of re-resolution.
+  // Also attempt to reconnect.
+  if (connectivity_state == GRPC_CHANNEL_TRANSIENT_FAILURE ||
+      connectivity_state == GRPC_CHANNEL_IDLE) {
+    if (GRPC_TRACE_FLAG_ENABLED(grpc_lb_wrr_trace)) {
+      gpr_log(GPR_INFO,
+              "[WRR %p] Subchannel %p reported %s; requesting re-resolution",
+              p, subchannel(), ConnectivityStateName(connectivity_state));
+    }
+    p->channel_control_helper()->RequestReresolution();
+    subchannel()->RequestConnection();
+  }
+  // Update logical connectivity state.
+  // If it changed, update the policy state.
+  if (UpdateLogicalConnectivityStateLocked(connectivity_state)) {
+    subchannel_list()->MaybeUpdateConnectivityStateLocked(
+        absl::UnavailableError("connections to all backends failing"));
+  }
+}
+
+//
+// factory
+//
+
+class WeightedRoundRobinFactory : public LoadBalancingPolicyFactory {
+ public:
+  OrphanablePtr<LoadBalancingPolicy> CreateLoadBalancingPolicy(
+      LoadBalancingPolicy::Args args) const override {
+    return MakeOrphanable<WeightedRoundRobin>(std::move(args));
+  }
+
+  const char* name() const override { return kWeightedRoundRobin; }
+
+  RefCountedPtr<LoadBalancingPolicy::Config> ParseLoadBalancingConfig(
+      const Json& json, grpc_error_handle* error) const override {
+    GPR_DEBUG_ASSERT(error != nullptr && *error == GRPC_ERROR_NONE);
+    bool enable_oob_load_report = false;
+    Duration oob_reporting_period = Duration::Seconds(10);
+    Duration blackout_period = Duration::Seconds(10);
+    Duration weight_update_period = Duration::Seconds(1);
+    Duration weight_expiration_period = Duration::Minutes(3);
+    // A null config means the policy was selected via the deprecated
+    // loadBalancingPolicy field or the client API; use the defaults.
+    if (json.type() == Json::Type::OBJECT) {
+      std::vector<grpc_error_handle> error_list;
+      const Json::Object& object = json.object_value();
+      ParseJsonObjectField(object, "enableOobLoadReport",
+                           &enable_oob_load_report, &error_list,
+                           /*required=*/false);
+      ParseJsonObjectFieldAsDuration(object, "oobReportingPeriod",
+                                     &oob_reporting_period, &error_list,
+                                     /*required=*/false);
+      ParseJsonObjectFieldAsDuration(object, "blackoutPeriod",
+                                     &blackout_period, &error_list,
+                                     /*required=*/false);
+      ParseJsonObjectFieldAsDuration(object, "weightUpdatePeriod",
+                                     &weight_update_period, &error_list,
+                                     /*required=*/false);
+      ParseJsonObjectFieldAsDuration(object, "weightExpirationPeriod",
+                                     &weight_expiration_period, &error_list,
+                                     /*required=*/false);
+      if (!error_list.empty()) {
+        *error = GRPC_ERROR_CREATE_FROM_VECTOR(
+            "weighted_round_robin_experimental LB policy config",
+            &error_list);
+        return nullptr;
+      }
+    }
+    return MakeRefCounted<WeightedRoundRobinConfig>(
+        enable_oob_load_report, oob_reporting_period, blackout_period,
+        std::max(weight_update_period, kMinWeightUpdatePeriod),
+        weight_expiration_period);
+  }
+};
+
+}  // namespace
+
+}  // namespace grpc_core
+
+void grpc_lb_policy_weighted_round_robin_init() {
+  grpc_core::LoadBalancingPolicyRegistry::Builder::
+      RegisterLoadBalancingPolicyFactory(
+          absl::make_unique<grpc_core::WeightedRoundRobinFactory>());
+}
+
+void grpc_lb_policy_weighted_round_robin_shutdown() {}
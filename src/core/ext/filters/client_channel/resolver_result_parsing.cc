@@ -173,11 +173,27 @@ ClientChannelServiceConfigParser::ParsePerMethodParams(
   Duration timeout;
   ParseJsonObjectFieldAsDuration(json.object_value(), "timeout", &timeout,
                                  &error_list, false);
+  // Parse writePriority.
+  uint32_t write_priority_flag = 0;
+  it = json.object_value().find("writePriority");
+  if (it != json.object_value().end()) {
+    if (it->second.type() != Json::Type::STRING) {
+      error_list.push_back(GRPC_ERROR_CREATE_FROM_STATIC_STRING(
+          "field:writePriority error:should be of type string"));
+    } else if (it->second.string_value() == "HIGH") {
+      write_priority_flag = GRPC_INITIAL_METADATA_WRITE_PRIORITY_HIGH;
+    } else if (it->second.string_value() == "LOW") {
+      write_priority_flag = GRPC_INITIAL_METADATA_WRITE_PRIORITY_LOW;
+    } else if (it->second.string_value() != "NORMAL") {
+      error_list.push_back(GRPC_ERROR_CREATE_FROM_STATIC_STRING(
+          "field:writePriority error:should be HIGH, NORMAL or LOW"));
+    }
+  }
   // Return result.
   *error = GRPC_ERROR_CREATE_FROM_VECTOR("Client channel parser", &error_list);
   if (*error == GRPC_ERROR_NONE) {
-    return absl::make_unique<ClientChannelMethodParsedConfig>(timeout,
-                                                              wait_for_ready);
+    return absl::make_unique<ClientChannelMethodParsedConfig>(
+        timeout, wait_for_ready, write_priority_flag);
   }
   return nullptr;
 }
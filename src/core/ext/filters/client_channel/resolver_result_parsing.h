@@ -68,16 +68,24 @@ class ClientChannelMethodParsedConfig
     : public ServiceConfigParser::ParsedConfig {
  public:
   ClientChannelMethodParsedConfig(Duration timeout,
-                                  const absl::optional<bool>& wait_for_ready)
-      : timeout_(timeout), wait_for_ready_(wait_for_ready) {}
+                                  const absl::optional<bool>& wait_for_ready,
+                                  uint32_t write_priority_flag = 0)
+      : timeout_(timeout),
+        wait_for_ready_(wait_for_ready),
+        write_priority_flag_(write_priority_flag) {}
 
   Duration timeout() const { return timeout_; }
 
   absl::optional<bool> wait_for_ready() const { return wait_for_ready_; }
 
+  // The GRPC_INITIAL_METADATA_WRITE_PRIORITY_* flag to set on calls, or 0
+  // to leave the call at normal write priority.
+  uint32_t write_priority_flag() const { return write_priority_flag_; }
+
  private:
   Duration timeout_;
   absl::optional<bool> wait_for_ready_;
+  uint32_t write_priority_flag_;
 };
 
 class ClientChannelServiceConfigParser : public ServiceConfigParser::Parser {
@@ -24,6 +24,7 @@
 #include <limits.h>
 #include <string.h>
 
+#include <list>
 #include <vector>
 
 #include "absl/strings/match.h"
@@ -133,7 +134,9 @@ class Chttp2ServerListener : public Server::ListenerInterface {
 
       void Orphan() override;
 
-      void Start(grpc_endpoint* endpoint, grpc_channel_args* args);
+      // Returns false if the connection was shut down before the handshake
+      // could start, in which case \a endpoint has been destroyed.
+      bool Start(grpc_endpoint* endpoint, grpc_channel_args* args);
 
       // Needed to be able to grab an external ref in ActiveConnection::Start()
       using InternallyRefCounted<HandshakingState>::Ref;
@@ -164,7 +167,9 @@ class Chttp2ServerListener : public Server::ListenerInterface {
 
     void SendGoAway();
 
-    void Start(RefCountedPtr<Chttp2ServerListener> listener,
+    // Returns false if the connection was shut down before its handshake
+    // could start, in which case \a endpoint has been destroyed.
+    bool Start(RefCountedPtr<Chttp2ServerListener> listener,
                grpc_endpoint* endpoint, grpc_channel_args* args);
 
     // Needed to be able to grab an external ref in
@@ -191,6 +196,24 @@ class Chttp2ServerListener : public Server::ListenerInterface {
     bool shutdown_ ABSL_GUARDED_BY(&mu_) = false;
   };
 
+  // An accepted connection waiting for a handshake slot. Owned by the
+  // callback of its timer, which closes the connection if it is still waiting
+  // at its handshake deadline.
+  struct PendingHandshake {
+    RefCountedPtr<ActiveConnection> connection;
+    RefCountedPtr<Chttp2ServerListener> listener;
+    // Owned by whoever removes the entry from pending_handshakes_.
+    grpc_endpoint* endpoint = nullptr;
+    grpc_channel_args* args = nullptr;
+    // Set if args is a per-connection copy owned by this entry.
+    grpc_channel_args* args_to_destroy = nullptr;
+    grpc_timer timer;
+    grpc_closure on_timeout;
+    // Set once the entry is no longer in pending_handshakes_. Guarded by the
+    // listener's mu_.
+    bool dequeued = false;
+  };
+
   // To allow access to RefCounted<> like interface.
   friend class RefCountedPtr<Chttp2ServerListener>;
 
@@ -203,6 +226,12 @@ class Chttp2ServerListener : public Server::ListenerInterface {
 
   static void TcpServerShutdownComplete(void* arg, grpc_error_handle error);
 
+  // Called once a connection that took a handshake slot is done handshaking.
+  // Hands the slot to the oldest pending connection, if any.
+  void ReleaseHandshakeSlot();
+
+  static void OnPendingHandshakeTimeout(void* arg, grpc_error_handle error);
+
   static void DestroyListener(Server* /*server*/, void* arg,
                               grpc_closure* destroy_done);
 
@@ -239,6 +268,8 @@ class Chttp2ServerListener : public Server::ListenerInterface {
   Chttp2ServerArgsModifier const args_modifier_;
   ConfigFetcherWatcher* config_fetcher_watcher_ = nullptr;
   grpc_channel_args* args_;
+  // Maximum number of handshakes in flight, or 0 for no limit.
+  const size_t max_concurrent_handshakes_;
   Mutex mu_;
   RefCountedPtr<grpc_server_config_fetcher::ConnectionManager>
       connection_manager_ ABSL_GUARDED_BY(mu_);
@@ -254,6 +285,10 @@ class Chttp2ServerListener : public Server::ListenerInterface {
       ABSL_GUARDED_BY(mu_);
   grpc_closure tcp_server_shutdown_complete_ ABSL_GUARDED_BY(mu_);
   grpc_closure* on_destroy_done_ ABSL_GUARDED_BY(mu_) = nullptr;
+  // Only maintained when max_concurrent_handshakes_ is set. At most
+  // max_concurrent_handshakes_ connections wait for a slot.
+  size_t handshakes_in_flight_ ABSL_GUARDED_BY(mu_) = 0;
+  std::list<PendingHandshake*> pending_handshakes_ ABSL_GUARDED_BY(mu_);
   RefCountedPtr<channelz::ListenSocketNode> channelz_listen_socket_;
   MemoryQuotaRefPtr memory_quota_;
 };
@@ -374,17 +409,22 @@ void Chttp2ServerListener::ActiveConnection::HandshakingState::Orphan() {
   Unref();
 }
 
-void Chttp2ServerListener::ActiveConnection::HandshakingState::Start(
+bool Chttp2ServerListener::ActiveConnection::HandshakingState::Start(
     grpc_endpoint* endpoint, grpc_channel_args* args) {
-  Ref().release();  // Held by OnHandshakeDone
   RefCountedPtr<HandshakeManager> handshake_mgr;
   {
     MutexLock lock(&connection_->mu_);
-    if (handshake_mgr_ == nullptr) return;
     handshake_mgr = handshake_mgr_;
   }
+  if (handshake_mgr == nullptr) {
+    grpc_endpoint_shutdown(endpoint, GRPC_ERROR_NONE);
+    grpc_endpoint_destroy(endpoint);
+    return false;
+  }
+  Ref().release();  // Held by OnHandshakeDone
   handshake_mgr->DoHandshake(endpoint, args, deadline_, acceptor_,
                              OnHandshakeDone, this);
+  return true;
 }
 
 void Chttp2ServerListener::ActiveConnection::HandshakingState::OnTimeout(
@@ -522,6 +562,7 @@ void Chttp2ServerListener::ActiveConnection::HandshakingState::OnHandshakeDone(
       self->connection_->listener_->connections_.erase(it);
     }
   }
+  self->connection_->listener_->ReleaseHandshakeSlot();
   self->Unref();
 }
 
@@ -584,19 +625,23 @@ void Chttp2ServerListener::ActiveConnection::SendGoAway() {
   }
 }
 
-void Chttp2ServerListener::ActiveConnection::Start(
+bool Chttp2ServerListener::ActiveConnection::Start(
     RefCountedPtr<Chttp2ServerListener> listener, grpc_endpoint* endpoint,
     grpc_channel_args* args) {
   RefCountedPtr<HandshakingState> handshaking_state_ref;
   listener_ = std::move(listener);
   {
     MutexLock lock(&mu_);
-    if (shutdown_) return;
     // Hold a ref to HandshakingState to allow starting the handshake outside
     // the critical region.
-    handshaking_state_ref = handshaking_state_->Ref();
+    if (!shutdown_) handshaking_state_ref = handshaking_state_->Ref();
+  }
+  if (handshaking_state_ref == nullptr) {
+    grpc_endpoint_shutdown(endpoint, GRPC_ERROR_NONE);
+    grpc_endpoint_destroy(endpoint);
+    return false;
   }
-  handshaking_state_ref->Start(endpoint, args);
+  return handshaking_state_ref->Start(endpoint, args);
 }
 
 void Chttp2ServerListener::ActiveConnection::OnClose(
@@ -725,6 +770,8 @@ Chttp2ServerListener::Chttp2ServerListener(
     : server_(server),
       args_modifier_(args_modifier),
       args_(args),
+      max_concurrent_handshakes_(grpc_channel_args_find_integer(
+          args, GRPC_ARG_SERVER_MAX_CONCURRENT_HANDSHAKES, {0, 0, INT_MAX})),
       memory_quota_(ResourceQuotaFromChannelArgs(args)->memory_quota()) {
   GRPC_CLOSURE_INIT(&tcp_server_shutdown_complete_, TcpServerShutdownComplete,
                     this, grpc_schedule_on_exec_ctx);
@@ -827,12 +874,19 @@ void Chttp2ServerListener::OnAccept(void* arg, grpc_endpoint* tcp,
   // critical region
   RefCountedPtr<ActiveConnection> connection_ref = connection->Ref();
   RefCountedPtr<Chttp2ServerListener> listener_ref;
+  bool queued = false;
   {
     MutexLock lock(&self->mu_);
     // Shutdown the the connection if listener's stopped serving or if the
-    // connection manager has changed.
-    if (!self->shutdown_ && self->is_serving_ &&
-        connection_manager == self->connection_manager_) {
+    // connection manager has changed. Also shed it if too many connections
+    // are already waiting for a handshake slot.
+    if (self->max_concurrent_handshakes_ != 0 &&
+        self->pending_handshakes_.size() >= self->max_concurrent_handshakes_) {
+      gpr_log(GPR_DEBUG,
+              "Closing connection: too many connections waiting to "
+              "handshake");
+    } else if (!self->shutdown_ && self->is_serving_ &&
+               connection_manager == self->connection_manager_) {
       // This ref needs to be taken in the critical region after having made
       // sure that the listener has not been Orphaned, so as to avoid
       // heap-use-after-free issues where `Ref()` is invoked when the ref of
@@ -840,16 +894,102 @@ void Chttp2ServerListener::OnAccept(void* arg, grpc_endpoint* tcp,
       // Chttp2ServerListener is grpc_tcp_server_ref().)
       listener_ref = self->Ref();
       self->connections_.emplace(connection.get(), std::move(connection));
+      if (self->max_concurrent_handshakes_ != 0) {
+        // Beyond the limit, the connection waits in accept order for a
+        // running handshake to finish, until its handshake deadline.
+        if (self->handshakes_in_flight_ < self->max_concurrent_handshakes_) {
+          ++self->handshakes_in_flight_;
+        } else {
+          auto* pending = new PendingHandshake();
+          pending->connection = connection_ref;
+          pending->listener = std::move(listener_ref);
+          pending->endpoint = tcp;
+          pending->args = args;
+          pending->args_to_destroy = args_to_destroy;
+          args_to_destroy = nullptr;
+          GRPC_CLOSURE_INIT(&pending->on_timeout, OnPendingHandshakeTimeout,
+                            pending, grpc_schedule_on_exec_ctx);
+          grpc_timer_init(&pending->timer, GetConnectionDeadline(args),
+                          &pending->on_timeout);
+          self->pending_handshakes_.push_back(pending);
+          queued = true;
+        }
+      }
     }
   }
   if (connection != nullptr) {
     endpoint_cleanup(GRPC_ERROR_NONE);
-  } else {
-    connection_ref->Start(std::move(listener_ref), tcp, args);
+  } else if (!queued &&
+             !connection_ref->Start(std::move(listener_ref), tcp, args)) {
+    self->ReleaseHandshakeSlot();
   }
   grpc_channel_args_destroy(args_to_destroy);
 }
 
+void Chttp2ServerListener::ReleaseHandshakeSlot() {
+  if (max_concurrent_handshakes_ == 0) return;
+  while (true) {
+    RefCountedPtr<ActiveConnection> connection;
+    RefCountedPtr<Chttp2ServerListener> listener;
+    grpc_endpoint* endpoint;
+    grpc_channel_args* args;
+    grpc_channel_args* args_to_destroy;
+    {
+      MutexLock lock(&mu_);
+      if (pending_handshakes_.empty()) {
+        --handshakes_in_flight_;
+        return;
+      }
+      PendingHandshake* next = pending_handshakes_.front();
+      pending_handshakes_.pop_front();
+      // The entry may be freed by its timer callback as soon as the lock is
+      // released.
+      next->dequeued = true;
+      connection = next->connection;
+      listener = next->listener;
+      endpoint = next->endpoint;
+      args = next->args;
+      args_to_destroy = next->args_to_destroy;
+      next->args_to_destroy = nullptr;
+      grpc_timer_cancel(&next->timer);
+    }
+    // The slot passes to the next connection, unless it was shut down while
+    // it waited.
+    bool started = connection->Start(std::move(listener), endpoint, args);
+    grpc_channel_args_destroy(args_to_destroy);
+    if (started) return;
+  }
+}
+
+void Chttp2ServerListener::OnPendingHandshakeTimeout(
+    void* arg, grpc_error_handle /*error*/) {
+  PendingHandshake* pending = static_cast<PendingHandshake*>(arg);
+  Chttp2ServerListener* self = pending->listener.get();
+  OrphanablePtr<ActiveConnection> connection;
+  bool expired = false;
+  {
+    MutexLock lock(&self->mu_);
+    // A cancelled timer finds its entry already dequeued.
+    if (!pending->dequeued) {
+      self->pending_handshakes_.remove(pending);
+      expired = true;
+      auto it = self->connections_.find(pending->connection.get());
+      if (it != self->connections_.end()) {
+        connection = std::move(it->second);
+        self->connections_.erase(it);
+      }
+    }
+  }
+  if (expired) {
+    grpc_endpoint_shutdown(pending->endpoint,
+                           GRPC_ERROR_CREATE_FROM_STATIC_STRING(
+                               "Handshake timed out waiting to start"));
+    grpc_endpoint_destroy(pending->endpoint);
+  }
+  grpc_channel_args_destroy(pending->args_to_destroy);
+  delete pending;
+}
+
 void Chttp2ServerListener::TcpServerShutdownComplete(void* arg,
                                                      grpc_error_handle error) {
   Chttp2ServerListener* self = static_cast<Chttp2ServerListener*>(arg);
@@ -867,6 +1007,7 @@ void Chttp2ServerListener::Orphan() {
     server_->config_fetcher()->CancelWatch(config_fetcher_watcher_);
   }
   std::map<ActiveConnection*, OrphanablePtr<ActiveConnection>> connections;
+  std::vector<grpc_endpoint*> pending_endpoints;
   grpc_tcp_server* tcp_server;
   {
     MutexLock lock(&mu_);
@@ -874,6 +1015,14 @@ void Chttp2ServerListener::Orphan() {
     is_serving_ = false;
     // Orphan the connections so that they can start cleaning up.
     connections = std::move(connections_);
+    // Connections still waiting for a handshake slot are closed right away.
+    // Their entries are freed by the timer callbacks.
+    for (PendingHandshake* pending : pending_handshakes_) {
+      pending->dequeued = true;
+      pending_endpoints.push_back(pending->endpoint);
+      grpc_timer_cancel(&pending->timer);
+    }
+    pending_handshakes_.clear();
     // If the listener is currently set to be serving but has not been started
     // yet, it means that `grpc_tcp_server_start` is in progress. Wait for the
     // operation to finish to avoid causing races.
@@ -882,6 +1031,10 @@ void Chttp2ServerListener::Orphan() {
     }
     tcp_server = tcp_server_;
   }
+  for (grpc_endpoint* endpoint : pending_endpoints) {
+    grpc_endpoint_shutdown(endpoint, GRPC_ERROR_NONE);
+    grpc_endpoint_destroy(endpoint);
+  }
   grpc_tcp_server_shutdown_listeners(tcp_server);
   grpc_tcp_server_unref(tcp_server);
 }
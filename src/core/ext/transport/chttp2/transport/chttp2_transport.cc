@@ -24,6 +24,7 @@
 #include <stdio.h>
 #include <string.h>
 
+#include "absl/memory/memory.h"
 #include "absl/strings/str_format.h"
 
 #include <grpc/slice_buffer.h>
@@ -288,6 +289,16 @@ static bool read_channel_args(grpc_chttp2_transport* t,
       if (value >= 0) {
         t->hpack_compressor.SetMaxUsableSize(value);
       }
+    } else if (0 == strcmp(channel_args->args[i].key,
+                           GRPC_ARG_HTTP2_HPACK_FREQUENCY_ADMISSION)) {
+      if (grpc_channel_arg_get_bool(&channel_args->args[i], false)) {
+        t->hpack_compressor.SetIndexingPolicy(
+            absl::make_unique<grpc_core::FrequencySketchIndexingPolicy>());
+      }
+    } else if (0 == strcmp(channel_args->args[i].key,
+                           GRPC_ARG_HTTP2_WRITE_QUANTUM_BYTES)) {
+      t->write_quantum = static_cast<uint32_t>(grpc_channel_arg_get_integer(
+          &channel_args->args[i], {16384, 0, INT_MAX}));
     } else if (0 == strcmp(channel_args->args[i].key,
                            GRPC_ARG_HTTP2_MAX_PINGS_WITHOUT_DATA)) {
       t->ping_policy.max_pings_without_data = grpc_channel_arg_get_integer(
@@ -310,9 +321,18 @@ static bool read_channel_args(grpc_chttp2_transport* t,
                            GRPC_ARG_HTTP2_WRITE_BUFFER_SIZE)) {
       t->write_buffer_size = static_cast<uint32_t>(grpc_channel_arg_get_integer(
           &channel_args->args[i], {0, 0, MAX_WRITE_BUFFER_SIZE}));
+    } else if (0 == strcmp(channel_args->args[i].key,
+                           GRPC_ARG_HTTP2_WRITE_BUFFER_MAX_DELAY_MS)) {
+      t->write_buffer_max_delay =
+          grpc_core::Duration::Milliseconds(grpc_channel_arg_get_integer(
+              &channel_args->args[i], {0, 0, INT_MAX}));
     } else if (0 ==
                strcmp(channel_args->args[i].key, GRPC_ARG_HTTP2_BDP_PROBE)) {
       enable_bdp = grpc_channel_arg_get_bool(&channel_args->args[i], true);
+    } else if (0 == strcmp(channel_args->args[i].key,
+                           GRPC_ARG_HTTP2_DELIVERY_RATE_FLOW_CONTROL)) {
+      t->delivery_rate_flow_control =
+          grpc_channel_arg_get_bool(&channel_args->args[i], false);
     } else if (0 ==
                strcmp(channel_args->args[i].key, GRPC_ARG_KEEPALIVE_TIME_MS)) {
       const int value = grpc_channel_arg_get_integer(
@@ -524,8 +544,8 @@ grpc_chttp2_transport::grpc_chttp2_transport(
   static const bool kEnableFlowControl =
       !GPR_GLOBAL_CONFIG_GET(grpc_experimental_disable_flow_control);
   if (kEnableFlowControl) {
-    flow_control.Init<grpc_core::chttp2::TransportFlowControl>(this,
-                                                               enable_bdp);
+    flow_control.Init<grpc_core::chttp2::TransportFlowControl>(
+        this, enable_bdp, delivery_rate_flow_control);
   } else {
     flow_control.Init<grpc_core::chttp2::TransportFlowControlDisabled>(this);
     enable_bdp = false;
@@ -601,6 +621,9 @@ static void close_transport_locked(grpc_chttp2_transport* t,
     if (t->have_next_bdp_ping_timer) {
       grpc_timer_cancel(&t->next_bdp_ping_timer);
     }
+    if (t->have_write_buffer_flush_timer) {
+      grpc_timer_cancel(&t->write_buffer_flush_timer);
+    }
     switch (t->keepalive_state) {
       case GRPC_CHTTP2_KEEPALIVE_STATE_WAITING:
         grpc_timer_cancel(&t->keepalive_ping_timer);
@@ -1291,12 +1314,56 @@ static bool contains_non_ok_status(grpc_metadata_batch* batch) {
          GRPC_STATUS_OK;
 }
 
+static void flush_buffered_writes(void* arg, uint32_t /*key*/, void* stream) {
+  grpc_chttp2_transport* t = static_cast<grpc_chttp2_transport*>(arg);
+  grpc_chttp2_stream* s = static_cast<grpc_chttp2_stream*>(stream);
+  if (s->write_buffering && s->flow_controlled_buffer.length > 0) {
+    grpc_chttp2_mark_stream_writable(t, s);
+  }
+}
+
+static void write_buffer_flush_locked(void* tp, grpc_error_handle error) {
+  grpc_chttp2_transport* t = static_cast<grpc_chttp2_transport*>(tp);
+  GPR_ASSERT(t->have_write_buffer_flush_timer);
+  t->have_write_buffer_flush_timer = false;
+  if (error == GRPC_ERROR_NONE) {
+    grpc_chttp2_stream_map_for_each(&t->stream_map, flush_buffered_writes, t);
+    grpc_chttp2_initiate_write(t, GRPC_CHTTP2_INITIATE_WRITE_SEND_MESSAGE);
+  }
+  GRPC_CHTTP2_UNREF_TRANSPORT(t, "write_buffer_flush");
+}
+
+static void write_buffer_flush(void* tp, grpc_error_handle error) {
+  grpc_chttp2_transport* t = static_cast<grpc_chttp2_transport*>(tp);
+  t->combiner->Run(GRPC_CLOSURE_INIT(&t->write_buffer_flush_locked,
+                                     write_buffer_flush_locked, t, nullptr),
+                   GRPC_ERROR_REF(error));
+}
+
+// Bound how long buffered writes may wait for a later write to carry them.
+static void schedule_write_buffer_flush(grpc_chttp2_transport* t) {
+  if (t->have_write_buffer_flush_timer ||
+      t->write_buffer_max_delay == grpc_core::Duration::Zero() ||
+      t->closed_with_error != GRPC_ERROR_NONE) {
+    return;
+  }
+  t->have_write_buffer_flush_timer = true;
+  GRPC_CHTTP2_REF_TRANSPORT(t, "write_buffer_flush");
+  GRPC_CLOSURE_INIT(&t->write_buffer_flush_locked, write_buffer_flush, t,
+                    grpc_schedule_on_exec_ctx);
+  grpc_timer_init(&t->write_buffer_flush_timer,
+                  grpc_core::ExecCtx::Get()->Now() + t->write_buffer_max_delay,
+                  &t->write_buffer_flush_locked);
+}
+
 static void maybe_become_writable_due_to_send_msg(grpc_chttp2_transport* t,
                                                   grpc_chttp2_stream* s) {
   if (s->id != 0 && (!s->write_buffering ||
                      s->flow_controlled_buffer.length > t->write_buffer_size)) {
     grpc_chttp2_mark_stream_writable(t, s);
     grpc_chttp2_initiate_write(t, GRPC_CHTTP2_INITIATE_WRITE_SEND_MESSAGE);
+  } else if (s->id != 0 && s->flow_controlled_buffer.length > 0) {
+    schedule_write_buffer_flush(t);
   }
 }
 
@@ -1443,6 +1510,13 @@ static void perform_stream_op_locked(void* stream_op,
     s->send_initial_metadata_finished = add_closure_barrier(on_complete);
     s->send_initial_metadata =
         op_payload->send_initial_metadata.send_initial_metadata;
+    const uint32_t flags =
+        op_payload->send_initial_metadata.send_initial_metadata_flags;
+    if (flags & GRPC_INITIAL_METADATA_WRITE_PRIORITY_HIGH) {
+      s->write_priority = GRPC_CHTTP2_WRITE_PRIORITY_HIGH;
+    } else if (flags & GRPC_INITIAL_METADATA_WRITE_PRIORITY_LOW) {
+      s->write_priority = GRPC_CHTTP2_WRITE_PRIORITY_LOW;
+    }
     if (t->is_client) {
       s->deadline = std::min(
           s->deadline,
@@ -1531,6 +1605,7 @@ static void perform_stream_op_locked(void* stream_op,
       if (flags & GRPC_WRITE_BUFFER_HINT) {
         s->next_message_end_offset -= t->write_buffer_size;
         s->write_buffering = true;
+        s->write_buffered_data = true;
       } else {
         s->write_buffering = false;
       }
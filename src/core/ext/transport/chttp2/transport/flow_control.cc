@@ -177,9 +177,11 @@ TransportFlowControlDisabled::TransportFlowControlDisabled(
 }
 
 TransportFlowControl::TransportFlowControl(const grpc_chttp2_transport* t,
-                                           bool enable_bdp_probe)
+                                           bool enable_bdp_probe,
+                                           bool delivery_rate_windows)
     : t_(t),
       enable_bdp_probe_(enable_bdp_probe),
+      delivery_rate_windows_(delivery_rate_windows),
       bdp_estimator_(t->peer_string.c_str()),
       pid_controller_(PidController::Args()
                           .set_gain_p(4)
@@ -340,6 +342,18 @@ static double AdjustForMemoryPressure(double memory_pressure, double target) {
   return target;
 }
 
+// Take in a window in bytes and shrink it linearly as memory pressure rises
+// past kShrinkMemPressure, down to nothing at kMaxMemPressure.
+static double ScaleForMemoryPressure(double memory_pressure, double target) {
+  static const double kShrinkMemPressure = 0.5;
+  static const double kMaxMemPressure = 0.9;
+  if (memory_pressure > kShrinkMemPressure) {
+    target *= 1 - std::min(1.0, (memory_pressure - kShrinkMemPressure) /
+                                    (kMaxMemPressure - kShrinkMemPressure));
+  }
+  return target;
+}
+
 double TransportFlowControl::TargetLogBdp() {
   return AdjustForMemoryPressure(t_->memory_owner.is_valid()
                                      ? t_->memory_owner.InstantaneousPressure()
@@ -357,6 +371,28 @@ double TransportFlowControl::SmoothLogBdp(double value) {
   return pid_controller_.Update(bdp_error, dt > kMaxDt ? kMaxDt : dt);
 }
 
+double TransportFlowControl::DeliveryRateTarget() {
+  const DeliveryRateEstimator& estimator = bdp_estimator_.delivery_rate();
+  // Before the first ping completes there is nothing to size from, so keep
+  // the default window.
+  double target = std::max(estimator.TargetWindow(), double(kDefaultWindow));
+  const double memory_pressure = t_->memory_owner.is_valid()
+                                     ? t_->memory_owner.InstantaneousPressure()
+                                     : 0.0;
+  double scaled = ScaleForMemoryPressure(memory_pressure, target);
+  if (GRPC_TRACE_FLAG_ENABLED(grpc_flowctl_trace)) {
+    gpr_log(GPR_INFO,
+            "%p[%s] delivery rate: bw=%lfMbs min_rtt=%lfms gain=%lf%s "
+            "pressure=%lf window=%" PRId64 " -> %" PRId64,
+            this, t_->is_client ? "cli" : "svr",
+            estimator.max_bandwidth() / 125000.0, estimator.min_rtt() * 1000.0,
+            estimator.gain(), estimator.probing() ? " (probing)" : "",
+            memory_pressure, target_initial_window_size_,
+            static_cast<int64_t>(scaled));
+  }
+  return scaled;
+}
+
 FlowControlAction::Urgency TransportFlowControl::DeltaUrgency(
     int64_t value, grpc_chttp2_setting_id setting_id) {
   int64_t delta = value - static_cast<int64_t>(
@@ -370,13 +406,16 @@ FlowControlAction::Urgency TransportFlowControl::DeltaUrgency(
 }
 
 FlowControlAction TransportFlowControl::PeriodicUpdate() {
+  FlowControlTrace trace(" bdp update", this, nullptr);
   FlowControlAction action;
   if (enable_bdp_probe_) {
     // get bdp estimate and update initial_window accordingly.
     // target might change based on how much memory pressure we are under
     // TODO(ncteisen): experiment with setting target to be huge under low
     // memory pressure.
-    double target = pow(2, SmoothLogBdp(TargetLogBdp()));
+    double target = delivery_rate_windows_
+                        ? DeliveryRateTarget()
+                        : pow(2, SmoothLogBdp(TargetLogBdp()));
     if (g_test_only_transport_target_window_estimates_mocker != nullptr) {
       // Hook for simulating unusual flow control situations in tests.
       target = g_test_only_transport_target_window_estimates_mocker
@@ -393,7 +432,9 @@ FlowControlAction TransportFlowControl::PeriodicUpdate() {
         static_cast<uint32_t>(target_initial_window_size_));
 
     // get bandwidth estimate and update max_frame accordingly.
-    double bw_dbl = bdp_estimator_.EstimateBandwidth();
+    double bw_dbl = delivery_rate_windows_
+                        ? bdp_estimator_.delivery_rate().max_bandwidth()
+                        : bdp_estimator_.EstimateBandwidth();
     // we target the max of BDP or bandwidth in microseconds.
     int32_t frame_size = static_cast<int32_t>(Clamp(
         std::max(
@@ -226,7 +226,11 @@ class TransportFlowControlDisabled final : public TransportFlowControlBase {
 // to be as performant as possible.
 class TransportFlowControl final : public TransportFlowControlBase {
  public:
-  TransportFlowControl(const grpc_chttp2_transport* t, bool enable_bdp_probe);
+  // With \a delivery_rate_windows, the target window is sized from the
+  // delivery rate and round trip time measured by BDP pings rather than by
+  // smoothing the ping's BDP estimate through a PID controller.
+  TransportFlowControl(const grpc_chttp2_transport* t, bool enable_bdp_probe,
+                       bool delivery_rate_windows = false);
   ~TransportFlowControl() override {}
 
   bool flow_control_enabled() const override { return true; }
@@ -304,6 +308,7 @@ class TransportFlowControl final : public TransportFlowControlBase {
  private:
   double TargetLogBdp();
   double SmoothLogBdp(double value);
+  double DeliveryRateTarget();
   FlowControlAction::Urgency DeltaUrgency(int64_t value,
                                           grpc_chttp2_setting_id setting_id);
 
@@ -329,6 +334,8 @@ class TransportFlowControl final : public TransportFlowControlBase {
 
   /** should we probe bdp? */
   const bool enable_bdp_probe_;
+  /** size windows from the measured delivery rate instead of the pid loop */
+  const bool delivery_rate_windows_;
 
   /* bdp estimation */
   BdpEstimator bdp_estimator_;
@@ -62,16 +62,14 @@ grpc_error_handle grpc_chttp2_data_parser_begin_frame(
   return GRPC_ERROR_NONE;
 }
 
-void grpc_chttp2_encode_data(uint32_t id, grpc_slice_buffer* inbuf,
-                             uint32_t write_bytes, int is_eof,
-                             grpc_transport_one_way_stats* stats,
-                             grpc_slice_buffer* outbuf) {
-  grpc_slice hdr;
-  uint8_t* p;
-  static const size_t header_size = 9;
+/* Buffered frames whose payload is spread over slices averaging fewer bytes
+ * than this are copied into a single slice together with their header: a run
+ * of small corked messages would otherwise cost the endpoint two iovecs per
+ * message. */
+#define GRPC_CHTTP2_MIN_AVERAGE_SCATTERED_SLICE_SIZE 256
 
-  hdr = GRPC_SLICE_MALLOC(header_size);
-  p = GRPC_SLICE_START_PTR(hdr);
+static void encode_data_header(uint32_t id, uint32_t write_bytes, int is_eof,
+                               uint8_t* p) {
   GPR_ASSERT(write_bytes < (1 << 24));
   *p++ = static_cast<uint8_t>(write_bytes >> 16);
   *p++ = static_cast<uint8_t>(write_bytes >> 8);
@@ -82,9 +80,41 @@ void grpc_chttp2_encode_data(uint32_t id, grpc_slice_buffer* inbuf,
   *p++ = static_cast<uint8_t>(id >> 16);
   *p++ = static_cast<uint8_t>(id >> 8);
   *p++ = static_cast<uint8_t>(id);
-  grpc_slice_buffer_add(outbuf, hdr);
+}
+
+/* Should the first \a write_bytes of \a inbuf be copied rather than
+ * referenced? */
+static bool should_coalesce_data(const grpc_slice_buffer* inbuf,
+                                 uint32_t write_bytes) {
+  size_t covered = 0;
+  size_t count = 0;
+  while (covered < write_bytes && count < inbuf->count) {
+    covered += GRPC_SLICE_LENGTH(inbuf->slices[count]);
+    ++count;
+  }
+  return count > 1 &&
+         write_bytes < count * GRPC_CHTTP2_MIN_AVERAGE_SCATTERED_SLICE_SIZE;
+}
 
-  grpc_slice_buffer_move_first_no_ref(inbuf, write_bytes, outbuf);
+void grpc_chttp2_encode_data(uint32_t id, grpc_slice_buffer* inbuf,
+                             uint32_t write_bytes, int is_eof,
+                             bool coalesce_small_slices,
+                             grpc_transport_one_way_stats* stats,
+                             grpc_slice_buffer* outbuf) {
+  static const size_t header_size = 9;
+
+  if (coalesce_small_slices && should_coalesce_data(inbuf, write_bytes)) {
+    grpc_slice frame = GRPC_SLICE_MALLOC(header_size + write_bytes);
+    encode_data_header(id, write_bytes, is_eof, GRPC_SLICE_START_PTR(frame));
+    grpc_slice_buffer_move_first_into_buffer(
+        inbuf, write_bytes, GRPC_SLICE_START_PTR(frame) + header_size);
+    grpc_slice_buffer_add(outbuf, frame);
+  } else {
+    grpc_slice hdr = GRPC_SLICE_MALLOC(header_size);
+    encode_data_header(id, write_bytes, is_eof, GRPC_SLICE_START_PTR(hdr));
+    grpc_slice_buffer_add(outbuf, hdr);
+    grpc_slice_buffer_move_first_no_ref(inbuf, write_bytes, outbuf);
+  }
 
   stats->framing_bytes += header_size;
   stats->data_bytes += write_bytes;
@@ -70,8 +70,12 @@ grpc_error_handle grpc_chttp2_data_parser_parse(void* parser,
                                                 const grpc_slice& slice,
                                                 int is_last);
 
+/* frame the first \a write_bytes of \a inbuf as a DATA frame into \a outbuf;
+   if \a coalesce_small_slices is set and those bytes are spread over many
+   small slices, they are copied into one slice with the frame header */
 void grpc_chttp2_encode_data(uint32_t id, grpc_slice_buffer* inbuf,
                              uint32_t write_bytes, int is_eof,
+                             bool coalesce_small_slices,
                              grpc_transport_one_way_stats* stats,
                              grpc_slice_buffer* outbuf);
 
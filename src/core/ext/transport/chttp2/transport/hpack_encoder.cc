@@ -24,6 +24,7 @@
 #include <string.h>
 
 #include <cstdint>
+#include <utility>
 
 #include "src/core/ext/transport/chttp2/transport/hpack_constants.h"
 #include "src/core/ext/transport/chttp2/transport/hpack_encoder_table.h"
@@ -50,6 +51,13 @@ namespace {
 
 constexpr size_t kDataFrameHeaderSize = 9;
 
+// Headers carrying credentials: these are never added to the dynamic table
+// by the indexing policy, so their values can't be probed through it.
+bool IsSensitiveHeader(absl::string_view key) {
+  return key == "authorization" || key == "proxy-authorization" ||
+         key == "cookie" || key == "set-cookie";
+}
+
 } /* namespace */
 
 /* fills p (which is expected to be kDataFrameHeaderSize bytes long)
@@ -331,6 +339,18 @@ void HPackCompressor::Framer::EmitLitHdrWithNonBinaryStringKeyNotIdx(
   Add(emit.data());
 }
 
+void HPackCompressor::Framer::EmitLitHdrWithNonBinaryStringKeyNeverIdx(
+    Slice key_slice, Slice value_slice) {
+  GRPC_STATS_INC_HPACK_SEND_LITHDR_NVRIDX_V();
+  GRPC_STATS_INC_HPACK_SEND_UNCOMPRESSED();
+  StringKey key(std::move(key_slice));
+  key.WritePrefix(0x10, AddTiny(key.prefix_length()));
+  Add(key.key());
+  NonBinaryStringValue emit(std::move(value_slice));
+  emit.WritePrefix(AddTiny(emit.prefix_length()));
+  Add(emit.data());
+}
+
 void HPackCompressor::Framer::AdvertiseTableSizeChange() {
   VarintWriter<3> w(compressor_->table_.max_size());
   w.Write(0x20, AddTiny(w.length()));
@@ -348,6 +368,7 @@ void HPackCompressor::SliceIndex::EmitTo(absl::string_view key,
                                                    value.Ref());
     return;
   }
+  auto* policy = framer->compressor_->indexing_policy_.get();
   // Linear scan through previous values to see if we find the value.
   for (It it = values_.begin(); it != values_.end(); ++it) {
     if (value == it->value) {
@@ -355,6 +376,11 @@ void HPackCompressor::SliceIndex::EmitTo(absl::string_view key,
       if (table.ConvertableToDynamicIndex(it->index)) {
         // Yes, emit the index and proceed to cleanup.
         framer->EmitIndexed(table.DynamicIndex(it->index));
+      } else if (policy != nullptr &&
+                 !policy->ShouldIndex(key, value.as_string_view())) {
+        // Not current, and not popular enough to bring back.
+        framer->EmitLitHdrWithNonBinaryStringKeyNotIdx(
+            Slice::FromStaticString(key), value.Ref());
       } else {
         // Not current, emit a new literal and update the index.
         it->index = table.AllocateIndex(transport_length);
@@ -375,6 +401,11 @@ void HPackCompressor::SliceIndex::EmitTo(absl::string_view key,
     }
     prev = it;
   }
+  if (policy != nullptr && !policy->ShouldIndex(key, value.as_string_view())) {
+    framer->EmitLitHdrWithNonBinaryStringKeyNotIdx(Slice::FromStaticString(key),
+                                                   value.Ref());
+    return;
+  }
   // No hit, emit a new literal and add it to the index.
   uint32_t index = table.AllocateIndex(transport_length);
   framer->EmitLitHdrWithNonBinaryStringKeyIncIdx(Slice::FromStaticString(key),
@@ -386,8 +417,58 @@ void HPackCompressor::Framer::Encode(const Slice& key, const Slice& value) {
   if (absl::EndsWith(key.as_string_view(), "-bin")) {
     EmitLitHdrWithBinaryStringKeyNotIdx(key.Ref(), value.Ref());
   } else {
+    EncodeWithIndexingPolicy(key, value);
+  }
+}
+
+void HPackCompressor::Framer::EncodeWithIndexingPolicy(const Slice& key,
+                                                       const Slice& value) {
+  HPackIndexingPolicy* policy = compressor_->indexing_policy_.get();
+  if (policy != nullptr && IsSensitiveHeader(key.as_string_view())) {
+    // Never offer credentials to the policy, and ask intermediaries not to
+    // index them either (RFC 7541 section 7.1.3).
+    EmitLitHdrWithNonBinaryStringKeyNeverIdx(key.Ref(), value.Ref());
+    return;
+  }
+  const uint32_t transport_length =
+      key.length() + value.length() + hpack_constants::kEntryOverhead;
+  if (policy == nullptr ||
+      transport_length > HPackEncoderTable::MaxEntrySize()) {
+    EmitLitHdrWithNonBinaryStringKeyNotIdx(key.Ref(), value.Ref());
+    return;
+  }
+  auto& table = compressor_->table_;
+  auto& index = compressor_->policy_index_;
+  auto it = index.find(
+      std::make_pair(key.as_string_view(), value.as_string_view()));
+  if (it != index.end() && table.ConvertableToDynamicIndex(it->second)) {
+    EmitIndexed(table.DynamicIndex(it->second));
+    return;
+  }
+  if (!policy->ShouldIndex(key.as_string_view(), value.as_string_view())) {
     EmitLitHdrWithNonBinaryStringKeyNotIdx(key.Ref(), value.Ref());
+    return;
+  }
+  const uint32_t new_index = table.AllocateIndex(transport_length);
+  if (it != index.end()) {
+    it->second = new_index;
+  } else {
+    // The remote table can't hold more entries than this, so once we reach
+    // it some of ours must have been evicted: drop them before growing.
+    if (index.size() >= hpack_constants::EntriesForBytes(table.max_size())) {
+      for (auto stale = index.begin(); stale != index.end();) {
+        if (table.ConvertableToDynamicIndex(stale->second)) {
+          ++stale;
+        } else {
+          index.erase(stale++);
+        }
+      }
+    }
+    index.emplace(std::make_pair(std::string(key.as_string_view()),
+                                 std::string(value.as_string_view())),
+                  new_index);
   }
+  EmitLitHdrWithNonBinaryStringKeyIncIdx(key.Ref(), value.Ref());
 }
 
 void HPackCompressor::Framer::Encode(HttpPathMetadata, const Slice& value) {
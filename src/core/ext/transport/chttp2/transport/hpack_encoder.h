@@ -22,6 +22,13 @@
 #include <grpc/support/port_platform.h>
 
 #include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/hash/hash.h"
+#include "absl/strings/string_view.h"
 
 #include <grpc/slice.h>
 #include <grpc/slice_buffer.h>
@@ -52,6 +59,15 @@ class HPackCompressor {
     return table_.test_only_table_size();
   }
 
+  // Set the policy that decides which otherwise unindexed headers are added
+  // to the dynamic table. With no policy (the default) :path and :authority
+  // values are always indexed and other unknown headers never are. With a
+  // policy, credentials (authorization, cookie and the like) are always sent
+  // as never-indexed literals.
+  void SetIndexingPolicy(std::unique_ptr<HPackIndexingPolicy> policy) {
+    indexing_policy_ = std::move(policy);
+  }
+
   struct EncodeHeaderOptions {
     uint32_t stream_id;
     bool is_end_of_stream;
@@ -103,8 +119,7 @@ class HPackCompressor {
         EmitLitHdrWithBinaryStringKeyNotIdx(
             Slice::FromStaticString(Which::key()), slice.Ref());
       } else {
-        EmitLitHdrWithNonBinaryStringKeyNotIdx(
-            Slice::FromStaticString(Which::key()), slice.Ref());
+        EncodeWithIndexingPolicy(Slice::FromStaticString(Which::key()), slice);
       }
     }
 
@@ -135,11 +150,14 @@ class HPackCompressor {
                                              Slice value_slice);
     void EmitLitHdrWithNonBinaryStringKeyNotIdx(Slice key_slice,
                                                 Slice value_slice);
+    void EmitLitHdrWithNonBinaryStringKeyNeverIdx(Slice key_slice,
+                                                  Slice value_slice);
 
     void EncodeAlwaysIndexed(uint32_t* index, absl::string_view key,
                              Slice value, uint32_t transport_length);
     void EncodeIndexedKeyWithBinaryValue(uint32_t* index, absl::string_view key,
                                          Slice value);
+    void EncodeWithIndexingPolicy(const Slice& key, const Slice& value);
 
     size_t CurrentFrameSize() const;
     void Add(Slice slice);
@@ -169,6 +187,7 @@ class HPackCompressor {
   // of this size
   bool advertise_table_size_change_ = false;
   HPackEncoderTable table_;
+  std::unique_ptr<HPackIndexingPolicy> indexing_policy_;
 
   class SliceIndex {
    public:
@@ -211,6 +230,31 @@ class HPackCompressor {
   Slice user_agent_;
   SliceIndex path_index_;
   SliceIndex authority_index_;
+  // Hash and equality over (key, value) pairs that also accept pairs of
+  // string_views, so that lookups don't copy the header.
+  using HeaderView = std::pair<absl::string_view, absl::string_view>;
+  struct HeaderHash {
+    using is_transparent = void;
+    size_t operator()(const HeaderView& header) const {
+      return absl::Hash<HeaderView>()(header);
+    }
+    size_t operator()(const std::pair<std::string, std::string>& header) const {
+      return (*this)(HeaderView(header.first, header.second));
+    }
+  };
+  struct HeaderEq {
+    using is_transparent = void;
+    template <typename A, typename B>
+    bool operator()(const A& a, const B& b) const {
+      return absl::string_view(a.first) == absl::string_view(b.first) &&
+             absl::string_view(a.second) == absl::string_view(b.second);
+    }
+  };
+  // Table indices of headers admitted by indexing_policy_, keyed by
+  // (key, value).
+  absl::flat_hash_map<std::pair<std::string, std::string>, uint32_t,
+                      HeaderHash, HeaderEq>
+      policy_index_;
   std::vector<PreviousTimeout> previous_timeouts_;
 };
 
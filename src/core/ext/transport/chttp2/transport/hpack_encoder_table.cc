@@ -16,6 +16,11 @@
 
 #include "src/core/ext/transport/chttp2/transport/hpack_encoder_table.h"
 
+#include <algorithm>
+#include <utility>
+
+#include "absl/hash/hash.h"
+
 #include <grpc/support/log.h>
 
 namespace grpc_core {
@@ -83,4 +88,61 @@ void HPackEncoderTable::Rebuild(uint32_t capacity) {
   elem_size_.swap(new_elem_size);
 }
 
+namespace {
+
+// Per-row counter indexes for key/value, derived from one hash by double
+// hashing.
+template <size_t kDepth, size_t kWidth>
+void SketchIndexes(absl::string_view key, absl::string_view value,
+                   size_t (&indexes)[kDepth]) {
+  const uint64_t hash =
+      absl::Hash<std::pair<absl::string_view, absl::string_view>>()(
+          std::make_pair(key, value));
+  const uint32_t h1 = static_cast<uint32_t>(hash);
+  const uint32_t h2 = static_cast<uint32_t>(hash >> 32) | 1;
+  for (size_t i = 0; i < kDepth; i++) {
+    indexes[i] = (h1 + i * h2) % kWidth;
+  }
+}
+
+}  // namespace
+
+bool FrequencySketchIndexingPolicy::ShouldIndex(absl::string_view key,
+                                                absl::string_view value) {
+  size_t indexes[kDepth];
+  SketchIndexes<kDepth, kWidth>(key, value, indexes);
+  // Conservative update: only bump the counters that hold the current
+  // minimum, which keeps the overestimate from hash collisions down.
+  uint8_t estimate = UINT8_MAX;
+  for (size_t i = 0; i < kDepth; i++) {
+    estimate = std::min(estimate, counters_[i][indexes[i]]);
+  }
+  if (estimate < UINT8_MAX) {
+    for (size_t i = 0; i < kDepth; i++) {
+      if (counters_[i][indexes[i]] == estimate) counters_[i][indexes[i]]++;
+    }
+    estimate++;
+  }
+  if (++observations_ == kResetInterval) Halve();
+  return estimate >= kAdmitThreshold;
+}
+
+uint8_t FrequencySketchIndexingPolicy::Estimate(absl::string_view key,
+                                                absl::string_view value) const {
+  size_t indexes[kDepth];
+  SketchIndexes<kDepth, kWidth>(key, value, indexes);
+  uint8_t estimate = UINT8_MAX;
+  for (size_t i = 0; i < kDepth; i++) {
+    estimate = std::min(estimate, counters_[i][indexes[i]]);
+  }
+  return estimate;
+}
+
+void FrequencySketchIndexingPolicy::Halve() {
+  observations_ = 0;
+  for (auto& row : counters_) {
+    for (uint8_t& counter : row) counter >>= 1;
+  }
+}
+
 }  // namespace grpc_core
@@ -17,7 +17,10 @@
 
 #include <grpc/support/port_platform.h>
 
+#include <stdint.h>
+
 #include "absl/container/inlined_vector.h"
+#include "absl/strings/string_view.h"
 
 #include "src/core/ext/transport/chttp2/transport/hpack_constants.h"
 
@@ -66,6 +69,43 @@ class HPackEncoderTable {
       elem_size_;
 };
 
+// Decides whether a header that is not in the remote HPACK table should be
+// sent as a literal with incremental indexing (taking space in the table, and
+// possibly evicting other entries) or as a literal without indexing.
+class HPackIndexingPolicy {
+ public:
+  virtual ~HPackIndexingPolicy() = default;
+
+  // Called each time key/value misses the table. Returns true if it should be
+  // added to the table.
+  virtual bool ShouldIndex(absl::string_view key, absl::string_view value) = 0;
+};
+
+// Admits a key/value pair once it has missed the table kAdmitThreshold times
+// recently, so that one-off values (request ids, tokens) do not evict stable
+// ones (authority, user-agent).
+// Popularity is estimated with a count-min sketch of saturating 8-bit
+// counters, all of which are halved every kResetInterval observations so
+// that old popularity fades.
+class FrequencySketchIndexingPolicy final : public HPackIndexingPolicy {
+ public:
+  static constexpr uint8_t kAdmitThreshold = 2;
+  static constexpr size_t kDepth = 4;
+  static constexpr size_t kWidth = 256;
+  static constexpr uint32_t kResetInterval = 10 * kWidth;
+
+  bool ShouldIndex(absl::string_view key, absl::string_view value) override;
+
+  // Estimated number of recent misses for key/value.
+  uint8_t Estimate(absl::string_view key, absl::string_view value) const;
+
+ private:
+  void Halve();
+
+  uint32_t observations_ = 0;
+  uint8_t counters_[kDepth][kWidth] = {};
+};
+
 }  // namespace grpc_core
 
 #endif  // GRPC_CORE_EXT_TRANSPORT_CHTTP2_TRANSPORT_HPACK_ENCODER_TABLE_H
@@ -20,6 +20,9 @@
 
 #include "src/core/ext/transport/chttp2/transport/huffsyms.h"
 
+#include <algorithm>
+#include <iterator>
+
 /* Constants pulled from the HPACK spec, and converted to C using the vim
    command:
    :%s/.*   \([0-9a-f]\+\)  \[ *\([0-9]\+\)\]/{0x\1, \2},/g */
@@ -90,3 +93,97 @@ const grpc_chttp2_huffsym grpc_chttp2_huffsyms[GRPC_CHTTP2_NUM_HUFFSYMS] = {
     {0x7ffffee, 27},  {0x7ffffef, 27},  {0x7fffff0, 27},  {0x3ffffee, 26},
     {0x3fffffff, 30},
 };
+
+namespace grpc_core {
+
+namespace {
+
+constexpr int kMaxCodeLength = 30;
+
+struct DecoderTables {
+  DecoderTables();
+
+  HuffmanDecoder::FastEntry fast[1 << HuffmanDecoder::kFastBits];
+  // Canonical decoding tables: codes of each length are consecutive, so a
+  // code of length l maps to sorted_symbols[offset[l] + code - first_code[l]]
+  // if code - first_code[l] < count[l].
+  uint32_t first_code[kMaxCodeLength + 1] = {};
+  uint32_t count[kMaxCodeLength + 1] = {};
+  uint32_t offset[kMaxCodeLength + 1] = {};
+  uint16_t sorted_symbols[GRPC_CHTTP2_NUM_HUFFSYMS];
+};
+
+DecoderTables::DecoderTables() {
+  for (uint16_t i = 0; i < GRPC_CHTTP2_NUM_HUFFSYMS; i++) sorted_symbols[i] = i;
+  std::sort(sorted_symbols, sorted_symbols + GRPC_CHTTP2_NUM_HUFFSYMS,
+            [](uint16_t a, uint16_t b) {
+              const grpc_chttp2_huffsym& x = grpc_chttp2_huffsyms[a];
+              const grpc_chttp2_huffsym& y = grpc_chttp2_huffsyms[b];
+              if (x.length != y.length) return x.length < y.length;
+              return x.bits < y.bits;
+            });
+  for (int i = GRPC_CHTTP2_NUM_HUFFSYMS - 1; i >= 0; i--) {
+    const grpc_chttp2_huffsym& sym = grpc_chttp2_huffsyms[sorted_symbols[i]];
+    first_code[sym.length] = sym.bits;
+    offset[sym.length] = i;
+    count[sym.length]++;
+  }
+  // Single symbol entries first: every index whose top bits are a code of at
+  // most kFastBits bits decodes to that symbol.
+  constexpr int kFastBits = HuffmanDecoder::kFastBits;
+  for (auto& e : fast) e = HuffmanDecoder::FastEntry{{0, 0}, 0, 0};
+  for (int i = 0; i < 256; i++) {
+    const grpc_chttp2_huffsym& sym = grpc_chttp2_huffsyms[i];
+    if (sym.length > kFastBits) continue;
+    const int shift = kFastBits - sym.length;
+    for (uint32_t j = 0; j < (1u << shift); j++) {
+      HuffmanDecoder::FastEntry& e = fast[(sym.bits << shift) | j];
+      e.symbols[0] = static_cast<uint8_t>(i);
+      e.num_symbols = 1;
+      e.num_bits = static_cast<uint8_t>(sym.length);
+    }
+  }
+  // Then pair up symbols where the bits left over after the first symbol hold
+  // a complete second code.
+  constexpr uint32_t kMask = (1u << kFastBits) - 1;
+  HuffmanDecoder::FastEntry single[1 << kFastBits];
+  std::copy(std::begin(fast), std::end(fast), single);
+  for (uint32_t i = 0; i <= kMask; i++) {
+    HuffmanDecoder::FastEntry& e = fast[i];
+    if (e.num_symbols != 1) continue;
+    const HuffmanDecoder::FastEntry& next = single[(i << e.num_bits) & kMask];
+    if (next.num_symbols == 0 || e.num_bits + next.num_bits > kFastBits) {
+      continue;
+    }
+    e.symbols[1] = next.symbols[0];
+    e.num_symbols = 2;
+    e.num_bits += next.num_bits;
+  }
+}
+
+const DecoderTables& Tables() {
+  static const DecoderTables* tables = new DecoderTables();
+  return *tables;
+}
+
+}  // namespace
+
+const HuffmanDecoder::FastEntry* HuffmanDecoder::FastTable() {
+  return Tables().fast;
+}
+
+int HuffmanDecoder::DecodeSlow(uint64_t bits, int max_length, int* length) {
+  const DecoderTables& tables = Tables();
+  max_length = std::min(max_length, kMaxCodeLength);
+  for (int l = 1; l <= max_length; l++) {
+    const uint32_t code = static_cast<uint32_t>(bits >> (64 - l));
+    const uint32_t index = code - tables.first_code[l];
+    if (index < tables.count[l]) {
+      *length = l;
+      return tables.sorted_symbols[tables.offset[l] + index];
+    }
+  }
+  return -1;
+}
+
+}  // namespace grpc_core
@@ -19,6 +19,11 @@
 #ifndef GRPC_CORE_EXT_TRANSPORT_CHTTP2_TRANSPORT_HUFFSYMS_H
 #define GRPC_CORE_EXT_TRANSPORT_CHTTP2_TRANSPORT_HUFFSYMS_H
 
+#include <grpc/support/port_platform.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
 /* HPACK static huffman table */
 
 #define GRPC_CHTTP2_NUM_HUFFSYMS 257
@@ -29,4 +34,64 @@ struct grpc_chttp2_huffsym {
 };
 extern const grpc_chttp2_huffsym grpc_chttp2_huffsyms[GRPC_CHTTP2_NUM_HUFFSYMS];
 
+namespace grpc_core {
+
+// Table driven decoder for the HPACK huffman code.
+// Input bits are accumulated MSB-first into a 64-bit word, and the top
+// kFastBits bits index a table that decodes up to two symbols at a time. The
+// handful of codes longer than kFastBits (and the tail of the input) fall
+// back to a canonical-code decode of a single symbol.
+class HuffmanDecoder {
+ public:
+  static constexpr int kFastBits = 12;
+
+  struct FastEntry {
+    uint8_t symbols[2];
+    // Number of symbols decoded by this entry (0, 1 or 2).
+    uint8_t num_symbols;
+    // Number of input bits consumed by this entry.
+    uint8_t num_bits;
+  };
+
+  // Decode length bytes at p, calling output(uint8_t) for each decoded byte.
+  // Decoding stops at the EOS symbol, or at trailing bits that do not form a
+  // complete code (i.e. padding).
+  template <typename Out>
+  static void Decode(const uint8_t* p, size_t length, Out output) {
+    const FastEntry* fast = FastTable();
+    const uint8_t* const end = p + length;
+    uint64_t bits = 0;
+    int num_bits = 0;
+    while (true) {
+      while (num_bits <= 56 && p != end) {
+        bits |= static_cast<uint64_t>(*p++) << (56 - num_bits);
+        num_bits += 8;
+      }
+      if (num_bits == 0) return;
+      const FastEntry& e = fast[bits >> (64 - kFastBits)];
+      if (e.num_symbols != 0 && e.num_bits <= num_bits) {
+        output(e.symbols[0]);
+        if (e.num_symbols == 2) output(e.symbols[1]);
+        bits <<= e.num_bits;
+        num_bits -= e.num_bits;
+        continue;
+      }
+      int symbol_length;
+      int symbol = DecodeSlow(bits, num_bits, &symbol_length);
+      if (symbol < 0 || symbol == 256) return;
+      output(static_cast<uint8_t>(symbol));
+      bits <<= symbol_length;
+      num_bits -= symbol_length;
+    }
+  }
+
+ private:
+  static const FastEntry* FastTable();
+  // Decode one symbol from the top max_length bits of bits; returns -1 if
+  // those bits do not start with a complete code.
+  static int DecodeSlow(uint64_t bits, int max_length, int* length);
+};
+
+}  // namespace grpc_core
+
 #endif /* GRPC_CORE_EXT_TRANSPORT_CHTTP2_TRANSPORT_HUFFSYMS_H */
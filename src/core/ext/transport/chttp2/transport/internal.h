@@ -50,12 +50,25 @@ namespace grpc_core {
 class ContextList;
 }
 
+/* write priority class of a stream: writable streams of a higher class are
+   always written before any stream of a lower class */
+typedef enum {
+  GRPC_CHTTP2_WRITE_PRIORITY_HIGH,
+  GRPC_CHTTP2_WRITE_PRIORITY_NORMAL,
+  GRPC_CHTTP2_WRITE_PRIORITY_LOW,
+  GRPC_CHTTP2_WRITE_PRIORITY_COUNT /* must be last */
+} grpc_chttp2_write_priority;
+
 /* streams are kept in various linked lists depending on what things need to
    happen to them... this enum labels each list */
 typedef enum {
-  /* If a stream is in the following two lists, an explicit ref is associated
+  /* If a stream is in the following lists, an explicit ref is associated
      with the stream */
-  GRPC_CHTTP2_LIST_WRITABLE,
+  /** streams with data to write, one list per write priority (in the same
+      order as grpc_chttp2_write_priority) */
+  GRPC_CHTTP2_LIST_WRITABLE_HIGH,
+  GRPC_CHTTP2_LIST_WRITABLE_NORMAL,
+  GRPC_CHTTP2_LIST_WRITABLE_LOW,
   GRPC_CHTTP2_LIST_WRITING,
   /* No additional ref is taken for the following refs. Make sure to remove the
      stream from these lists when the stream is removed. */
@@ -318,6 +331,9 @@ struct grpc_chttp2_transport {
 
   /** various lists of streams */
   grpc_chttp2_stream_list lists[STREAM_LIST_COUNT] = {};
+  /** how many DATA bytes a stream may write per turn before the next
+      writable stream of the same priority is written; 0 for no limit */
+  uint32_t write_quantum = 16384;
 
   /** maps stream id to grpc_chttp2_stream objects */
   grpc_chttp2_stream_map stream_map;
@@ -357,6 +373,9 @@ struct grpc_chttp2_transport {
   /** how much data are we willing to buffer when the WRITE_BUFFER_HINT is set?
    */
   uint32_t write_buffer_size = grpc_core::chttp2::kDefaultWindow;
+  /** how long may data buffered due to WRITE_BUFFER_HINT wait to be written?
+   * Zero leaves it buffered until the stream's next unbuffered write. */
+  grpc_core::Duration write_buffer_max_delay;
 
   /** Set to a grpc_error object if a goaway frame is received. By default, set
    * to GRPC_ERROR_NONE */
@@ -412,6 +431,8 @@ struct grpc_chttp2_transport {
       grpc_core::chttp2::TransportFlowControl,
       grpc_core::chttp2::TransportFlowControlDisabled>
       flow_control;
+  /** size flow control windows from the measured delivery rate */
+  bool delivery_rate_flow_control = false;
   /** initial window change. This is tracked as we parse settings frames from
    * the remote peer. If there is a positive delta, then we will make all
    * streams readable since they may have become unstalled */
@@ -460,6 +481,11 @@ struct grpc_chttp2_transport {
   /** destructive cleanup closure */
   grpc_closure destructive_reclaimer_locked;
 
+  /* flushes streams still buffering writes after write_buffer_max_delay */
+  bool have_write_buffer_flush_timer = false;
+  grpc_timer write_buffer_flush_timer;
+  grpc_closure write_buffer_flush_locked;
+
   /* next bdp ping timer */
   bool have_next_bdp_ping_timer = false;
   /** If start_bdp_ping_locked has been called */
@@ -578,6 +604,10 @@ struct grpc_chttp2_stream {
   /** Are we buffering writes on this stream? If yes, we won't become writable
       until there's enough queued up in the flow_controlled_buffer */
   bool write_buffering = false;
+  /** Does flow_controlled_buffer hold messages that were written with
+      GRPC_WRITE_BUFFER_HINT? If yes, their small slices are packed into
+      shared frames when they are written */
+  bool write_buffered_data = false;
 
   /* have we sent or received the EOS bit? */
   bool eos_received = false;
@@ -646,6 +676,12 @@ struct grpc_chttp2_stream {
   bool traced = false;
   /** Byte counter for number of bytes written */
   size_t byte_counter = 0;
+
+  /** which writable list this stream is scheduled on */
+  grpc_chttp2_write_priority write_priority = GRPC_CHTTP2_WRITE_PRIORITY_NORMAL;
+  /** DATA bytes this stream may still write before yielding its turn to the
+      next writable stream of the same priority */
+  uint32_t write_deficit = 0;
 };
 
 /** Transport writing call flow:
@@ -682,7 +718,8 @@ grpc_error_handle grpc_chttp2_perform_read(grpc_chttp2_transport* t,
 
 bool grpc_chttp2_list_add_writable_stream(grpc_chttp2_transport* t,
                                           grpc_chttp2_stream* s);
-/** Get a writable stream
+/** Get a writable stream: streams of the highest write priority come first,
+    in round robin order within a priority.
     returns non-zero if there was a stream available */
 bool grpc_chttp2_list_pop_writable_stream(grpc_chttp2_transport* t,
                                           grpc_chttp2_stream** s);
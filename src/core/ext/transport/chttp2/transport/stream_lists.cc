@@ -25,8 +25,12 @@
 
 static const char* stream_list_id_string(grpc_chttp2_stream_list_id id) {
   switch (id) {
-    case GRPC_CHTTP2_LIST_WRITABLE:
+    case GRPC_CHTTP2_LIST_WRITABLE_HIGH:
+      return "writable_high";
+    case GRPC_CHTTP2_LIST_WRITABLE_NORMAL:
       return "writable";
+    case GRPC_CHTTP2_LIST_WRITABLE_LOW:
+      return "writable_low";
     case GRPC_CHTTP2_LIST_WRITING:
       return "writing";
     case GRPC_CHTTP2_LIST_STALLED_BY_TRANSPORT:
@@ -138,20 +142,48 @@ static bool stream_list_add(grpc_chttp2_transport* t, grpc_chttp2_stream* s,
 
 /* wrappers for specializations */
 
+static grpc_chttp2_stream_list_id writable_list_id(
+    grpc_chttp2_write_priority priority) {
+  return static_cast<grpc_chttp2_stream_list_id>(
+      GRPC_CHTTP2_LIST_WRITABLE_HIGH + priority);
+}
+
 bool grpc_chttp2_list_add_writable_stream(grpc_chttp2_transport* t,
                                           grpc_chttp2_stream* s) {
   GPR_ASSERT(s->id != 0);
-  return stream_list_add(t, s, GRPC_CHTTP2_LIST_WRITABLE);
+  // A stream is on at most one writable list, even if its priority changed
+  // while it was queued.
+  for (int i = 0; i < GRPC_CHTTP2_WRITE_PRIORITY_COUNT; i++) {
+    if (s->included.is_set(
+            writable_list_id(static_cast<grpc_chttp2_write_priority>(i)))) {
+      return false;
+    }
+  }
+  return stream_list_add(t, s, writable_list_id(s->write_priority));
 }
 
 bool grpc_chttp2_list_pop_writable_stream(grpc_chttp2_transport* t,
                                           grpc_chttp2_stream** s) {
-  return stream_list_pop(t, s, GRPC_CHTTP2_LIST_WRITABLE);
+  for (int i = 0; i < GRPC_CHTTP2_WRITE_PRIORITY_COUNT; i++) {
+    if (stream_list_pop(
+            t, s,
+            writable_list_id(static_cast<grpc_chttp2_write_priority>(i)))) {
+      return true;
+    }
+  }
+  return false;
 }
 
 bool grpc_chttp2_list_remove_writable_stream(grpc_chttp2_transport* t,
                                              grpc_chttp2_stream* s) {
-  return stream_list_maybe_remove(t, s, GRPC_CHTTP2_LIST_WRITABLE);
+  for (int i = 0; i < GRPC_CHTTP2_WRITE_PRIORITY_COUNT; i++) {
+    if (stream_list_maybe_remove(
+            t, s,
+            writable_list_id(static_cast<grpc_chttp2_write_priority>(i)))) {
+      return true;
+    }
+  }
+  return false;
 }
 
 bool grpc_chttp2_list_add_writing_stream(grpc_chttp2_transport* t,
@@ -20,158 +20,166 @@
 
 #include "src/core/ext/transport/chttp2/transport/stream_map.h"
 
+#include <stdlib.h>
 #include <string.h>
 
+#include <algorithm>
+
 #include <grpc/support/alloc.h>
 #include <grpc/support/log.h>
 
-void grpc_chttp2_stream_map_init(grpc_chttp2_stream_map* map,
-                                 size_t initial_capacity) {
-  GPR_DEBUG_ASSERT(initial_capacity > 1);
-  map->keys =
-      static_cast<uint32_t*>(gpr_malloc(sizeof(uint32_t) * initial_capacity));
-  map->values =
-      static_cast<void**>(gpr_malloc(sizeof(void*) * initial_capacity));
-  map->count = 0;
-  map->free = 0;
-  map->capacity = initial_capacity;
+/* Fibonacci hashing: sequential stream ids spread evenly over the table */
+static size_t home_slot(const grpc_chttp2_stream_map* map, uint32_t key) {
+  return static_cast<size_t>((key * 2654435769u) >> map->hash_shift);
 }
 
-void grpc_chttp2_stream_map_destroy(grpc_chttp2_stream_map* map) {
-  gpr_free(map->keys);
-  gpr_free(map->values);
+static void alloc_slots(grpc_chttp2_stream_map* map, size_t capacity) {
+  GPR_DEBUG_ASSERT((capacity & (capacity - 1)) == 0);
+  map->slots = static_cast<grpc_chttp2_stream_map_slot*>(
+      gpr_zalloc(sizeof(grpc_chttp2_stream_map_slot) * capacity));
+  map->capacity = capacity;
+  map->hash_shift = 32;
+  while (capacity > 1) {
+    capacity >>= 1;
+    map->hash_shift--;
+  }
 }
 
-static size_t compact(uint32_t* keys, void** values, size_t count) {
-  size_t i, out;
+/* insert key without checking for duplicates or resizing */
+static void insert(grpc_chttp2_stream_map* map, uint32_t key, void* value) {
+  const size_t mask = map->capacity - 1;
+  size_t i = home_slot(map, key);
+  while (map->slots[i].key != 0) {
+    i = (i + 1) & mask;
+  }
+  map->slots[i].key = key;
+  map->slots[i].value = value;
+}
 
-  for (i = 0, out = 0; i < count; i++) {
-    if (values[i]) {
-      keys[out] = keys[i];
-      values[out] = values[i];
-      out++;
+static void resize(grpc_chttp2_stream_map* map, size_t capacity) {
+  grpc_chttp2_stream_map_slot* old_slots = map->slots;
+  const size_t old_capacity = map->capacity;
+  alloc_slots(map, capacity);
+  for (size_t i = 0; i < old_capacity; i++) {
+    if (old_slots[i].key != 0) {
+      insert(map, old_slots[i].key, old_slots[i].value);
     }
   }
+  gpr_free(old_slots);
+}
 
-  return out;
+void grpc_chttp2_stream_map_init(grpc_chttp2_stream_map* map,
+                                 size_t initial_capacity) {
+  GPR_DEBUG_ASSERT(initial_capacity > 1);
+  size_t capacity = 2;
+  while (capacity < initial_capacity) capacity *= 2;
+  alloc_slots(map, capacity);
+  map->count = 0;
+  map->min_capacity = capacity;
+  map->max_key = 0;
+}
+
+void grpc_chttp2_stream_map_destroy(grpc_chttp2_stream_map* map) {
+  gpr_free(map->slots);
 }
 
 void grpc_chttp2_stream_map_add(grpc_chttp2_stream_map* map, uint32_t key,
                                 void* value) {
-  size_t count = map->count;
-  size_t capacity = map->capacity;
-  uint32_t* keys = map->keys;
-  void** values = map->values;
-
-  // The first assertion ensures that the table is monotonically increasing.
-  GPR_ASSERT(count == 0 || keys[count - 1] < key);
+  // Ensures that keys are monotonically increasing, which also means key is
+  // not already in the map.
+  GPR_ASSERT(key > map->max_key);
   GPR_DEBUG_ASSERT(value);
-  // Asserting that the key is not already in the map can be a debug assertion.
-  // Why: we're already checking that the map elements are monotonically
-  // increasing. If we re-add a key, i.e. if the key is already present, then
-  // either it is the most recently added key in the map (in which case the
-  // first assertion fails due to key == last_key) or there is a more recently
-  // added (larger) key at the end of the map: in which case the first assertion
-  // still fails due to key < last_key.
-  GPR_DEBUG_ASSERT(grpc_chttp2_stream_map_find(map, key) == nullptr);
-
-  if (count == capacity) {
-    if (map->free > capacity / 4) {
-      count = compact(keys, values, count);
-      map->free = 0;
-    } else {
-      /* resize when less than 25% of the table is free, because compaction
-         won't help much */
-      map->capacity = capacity = 2 * capacity;
-      map->keys = keys = static_cast<uint32_t*>(
-          gpr_realloc(keys, capacity * sizeof(uint32_t)));
-      map->values = values =
-          static_cast<void**>(gpr_realloc(values, capacity * sizeof(void*)));
-    }
+  map->max_key = key;
+  /* grow when more than 3/4 full, keeping probe sequences short */
+  if (4 * (map->count + 1) > 3 * map->capacity) {
+    resize(map, 2 * map->capacity);
   }
-
-  keys[count] = key;
-  values[count] = value;
-  map->count = count + 1;
+  insert(map, key, value);
+  map->count++;
 }
 
-template <bool strict_find>
-static void** find(grpc_chttp2_stream_map* map, uint32_t key) {
-  size_t min_idx = 0;
-  size_t max_idx = map->count;
-  size_t mid_idx;
-  uint32_t* keys = map->keys;
-  void** values = map->values;
-  uint32_t mid_key;
-
-  GPR_DEBUG_ASSERT(!strict_find || max_idx > 0);
-  if (!strict_find && max_idx == 0) return nullptr;
-
-  while (min_idx < max_idx) {
-    /* find the midpoint, avoiding overflow */
-    mid_idx = min_idx + ((max_idx - min_idx) / 2);
-    mid_key = keys[mid_idx];
-
-    if (mid_key < key) {
-      min_idx = mid_idx + 1;
-    } else if (mid_key > key) {
-      max_idx = mid_idx;
-    } else /* mid_key == key */
-    {
-      return &values[mid_idx];
-    }
+static grpc_chttp2_stream_map_slot* find(grpc_chttp2_stream_map* map,
+                                         uint32_t key) {
+  const size_t mask = map->capacity - 1;
+  size_t i = home_slot(map, key);
+  while (map->slots[i].key != 0) {
+    if (map->slots[i].key == key) return &map->slots[i];
+    i = (i + 1) & mask;
   }
-
-  GPR_DEBUG_ASSERT(!strict_find);
   return nullptr;
 }
 
 void* grpc_chttp2_stream_map_delete(grpc_chttp2_stream_map* map, uint32_t key) {
-  void** pvalue = find<true>(map, key);
-  GPR_DEBUG_ASSERT(pvalue != nullptr);
-  void* out = *pvalue;
+  grpc_chttp2_stream_map_slot* slot = find(map, key);
+  GPR_DEBUG_ASSERT(slot != nullptr);
+  if (slot == nullptr) return nullptr;
+  void* out = slot->value;
   GPR_DEBUG_ASSERT(out != nullptr);
-  *pvalue = nullptr;
-  map->free++;
-  /* recognize complete emptyness and ensure we can skip
-     defragmentation later */
-  if (map->free == map->count) {
-    map->free = map->count = 0;
+  /* Backward shift deletion: walk the rest of the probe run, moving back
+     any entry whose home slot does not lie in (hole, j], so that every
+     remaining entry stays reachable from its home slot. */
+  const size_t mask = map->capacity - 1;
+  size_t hole = static_cast<size_t>(slot - map->slots);
+  for (size_t j = (hole + 1) & mask; map->slots[j].key != 0;
+       j = (j + 1) & mask) {
+    const size_t home = home_slot(map, map->slots[j].key);
+    if (((j - home) & mask) >= ((j - hole) & mask)) {
+      map->slots[hole] = map->slots[j];
+      hole = j;
+    }
+  }
+  map->slots[hole].key = 0;
+  map->slots[hole].value = nullptr;
+  map->count--;
+  /* shrink when less than 1/8 full, so that rand() scans stay short */
+  if (map->capacity > map->min_capacity && 8 * map->count < map->capacity) {
+    resize(map, map->capacity / 2);
   }
   GPR_DEBUG_ASSERT(grpc_chttp2_stream_map_find(map, key) == nullptr);
   return out;
 }
 
 void* grpc_chttp2_stream_map_find(grpc_chttp2_stream_map* map, uint32_t key) {
-  void** pvalue = find<false>(map, key);
-  return pvalue != nullptr ? *pvalue : nullptr;
+  grpc_chttp2_stream_map_slot* slot = find(map, key);
+  return slot != nullptr ? slot->value : nullptr;
 }
 
 size_t grpc_chttp2_stream_map_size(grpc_chttp2_stream_map* map) {
-  return map->count - map->free;
+  return map->count;
 }
 
 void* grpc_chttp2_stream_map_rand(grpc_chttp2_stream_map* map) {
-  if (map->count == map->free) {
+  if (map->count == 0) {
     return nullptr;
   }
-  if (map->free != 0) {
-    map->count = compact(map->keys, map->values, map->count);
-    map->free = 0;
-    GPR_ASSERT(map->count > 0);
+  const size_t mask = map->capacity - 1;
+  size_t i = static_cast<size_t>(rand()) & mask;
+  while (map->slots[i].key == 0) {
+    i = (i + 1) & mask;
   }
-  return map->values[(static_cast<size_t>(rand())) % map->count];
+  return map->slots[i].value;
 }
 
 void grpc_chttp2_stream_map_for_each(grpc_chttp2_stream_map* map,
                                      void (*f)(void* user_data, uint32_t key,
                                                void* value),
                                      void* user_data) {
-  size_t i;
-
-  for (i = 0; i < map->count; i++) {
-    if (map->values[i]) {
-      f(user_data, map->keys[i], map->values[i]);
+  /* Snapshot the keys first: f may delete entries, which moves others
+     around the table. */
+  const size_t count = map->count;
+  if (count == 0) return;
+  uint32_t* keys = static_cast<uint32_t*>(gpr_malloc(sizeof(uint32_t) * count));
+  size_t n = 0;
+  for (size_t i = 0; i < map->capacity; i++) {
+    if (map->slots[i].key != 0) keys[n++] = map->slots[i].key;
+  }
+  GPR_DEBUG_ASSERT(n == count);
+  std::sort(keys, keys + n);
+  for (size_t i = 0; i < n; i++) {
+    void* value = grpc_chttp2_stream_map_find(map, keys[i]);
+    if (value != nullptr) {
+      f(user_data, keys[i], value);
     }
   }
+  gpr_free(keys);
 }
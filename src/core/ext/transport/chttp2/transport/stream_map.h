@@ -22,19 +22,30 @@
 #include <grpc/support/port_platform.h>
 
 #include <stddef.h>
+#include <stdint.h>
 
 /* Data structure to map a uint32_t to a data object (represented by a void*)
 
-   Represented as a sorted array of keys, and a corresponding array of values.
-   Lookups are performed with binary search.
+   Represented as an open addressed hash table of (key, value) slots, with
+   linear probing. Key 0 (never a valid http2 stream id) marks an empty slot.
+   Deletes shift later entries of the probe sequence back, so the table never
+   accumulates tombstones and needs no compaction. The table is kept between
+   1/8 and 3/4 full (above the initial capacity).
    Adds are restricted to strictly higher keys than previously seen (this is
    guaranteed by http2). */
+struct grpc_chttp2_stream_map_slot {
+  uint32_t key;
+  void* value;
+};
 struct grpc_chttp2_stream_map {
-  uint32_t* keys;
-  void** values;
+  grpc_chttp2_stream_map_slot* slots;
   size_t count;
-  size_t free;
+  /* always a power of two */
   size_t capacity;
+  size_t min_capacity;
+  /* 32 - log2(capacity): turns a 32-bit hash into a slot index */
+  int hash_shift;
+  uint32_t max_key;
 };
 void grpc_chttp2_stream_map_init(grpc_chttp2_stream_map* map,
                                  size_t initial_capacity);
@@ -52,13 +63,15 @@ void* grpc_chttp2_stream_map_delete(grpc_chttp2_stream_map* map, uint32_t key);
 /* Return an existing key, or NULL if it does not exist */
 void* grpc_chttp2_stream_map_find(grpc_chttp2_stream_map* map, uint32_t key);
 
-/* Return a random entry */
+/* Return a random entry. Entries after long runs of empty slots are more
+   likely to be chosen; the distribution is not uniform. */
 void* grpc_chttp2_stream_map_rand(grpc_chttp2_stream_map* map);
 
 /* How many (populated) entries are in the stream map? */
 size_t grpc_chttp2_stream_map_size(grpc_chttp2_stream_map* map);
 
-/* Callback on each stream */
+/* Callback on each stream, in increasing key order. f may delete entries
+   (including ones not yet visited, which are then skipped). */
 void grpc_chttp2_stream_map_for_each(grpc_chttp2_stream_map* map,
                                      void (*f)(void* user_data, uint32_t key,
                                                void* value),
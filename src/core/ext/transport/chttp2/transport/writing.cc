@@ -371,17 +371,22 @@ class DataSendContext {
 
   bool AnyOutgoing() const { return max_outgoing() > 0; }
 
-  void FlushBytes() {
+  // Frame up to limit bytes of the stream's pending data, returning how many
+  // were framed.
+  uint32_t FlushBytes(uint32_t limit) {
     uint32_t send_bytes = static_cast<uint32_t>(
-        std::min(size_t(max_outgoing()), s_->flow_controlled_buffer.length));
+        std::min(size_t(std::min(max_outgoing(), limit)),
+                 s_->flow_controlled_buffer.length));
     is_last_frame_ = send_bytes == s_->flow_controlled_buffer.length &&
                      s_->fetching_send_message == nullptr &&
                      s_->send_trailing_metadata != nullptr &&
                      s_->send_trailing_metadata->empty();
     grpc_chttp2_encode_data(s_->id, &s_->flow_controlled_buffer, send_bytes,
-                            is_last_frame_, &s_->stats.outgoing, &t_->outbuf);
+                            is_last_frame_, s_->write_buffered_data,
+                            &s_->stats.outgoing, &t_->outbuf);
     s_->flow_control->SentData(send_bytes);
     s_->sending_bytes += send_bytes;
+    return send_bytes;
   }
 
   bool is_last_frame() const { return is_last_frame_; }
@@ -490,9 +495,29 @@ class StreamWriteContext {
       return;  // early out: nothing to do
     }
 
+    // Deficit round robin: each turn grants the stream another quantum of
+    // bytes to write. A stream that still has data once its deficit is spent
+    // goes to the back of its writable list, so a bulk transfer cannot hold
+    // off the other streams of its priority for a whole flow control window.
+    // Any unspent deficit (when flow control cut the turn short) carries over
+    // to the next turn, up to one extra quantum.
+    const uint32_t quantum = t_->write_quantum;
+    if (quantum != 0) {
+      s_->write_deficit = std::min(s_->write_deficit, quantum) + quantum;
+    }
     while (s_->flow_controlled_buffer.length > 0 &&
-           data_send_context.max_outgoing() > 0) {
-      data_send_context.FlushBytes();
+           data_send_context.max_outgoing() > 0 &&
+           (quantum == 0 || s_->write_deficit > 0)) {
+      uint32_t sent = data_send_context.FlushBytes(
+          quantum == 0 ? UINT32_MAX : s_->write_deficit);
+      if (quantum != 0) s_->write_deficit -= sent;
+    }
+    if (s_->flow_controlled_buffer.length == 0) {
+      s_->write_deficit = 0;
+      s_->write_buffered_data = false;
+      // A message may take several turns: count it once, when its last
+      // bytes are framed.
+      write_context_->IncMessageWrites();
     }
     grpc_chttp2_reset_ping_clock(t_);
     if (data_send_context.is_last_frame()) {
@@ -504,7 +529,6 @@ class StreamWriteContext {
       GRPC_CHTTP2_STREAM_REF(s_, "chttp2_writing:fork");
       grpc_chttp2_list_add_writable_stream(t_, s_);
     }
-    write_context_->IncMessageWrites();
   }
 
   void FlushTrailingMetadata() {
@@ -517,7 +541,7 @@ class StreamWriteContext {
     GRPC_CHTTP2_IF_TRACING(gpr_log(GPR_INFO, "sending trailing_metadata"));
     if (s_->send_trailing_metadata->empty()) {
       grpc_chttp2_encode_data(s_->id, &s_->flow_controlled_buffer, 0, true,
-                              &s_->stats.outgoing, &t_->outbuf);
+                              false, &s_->stats.outgoing, &t_->outbuf);
     } else {
       if (send_status_.has_value()) {
         s_->send_trailing_metadata->Set(grpc_core::HttpStatusMetadata(),
@@ -37,6 +37,8 @@ BaseCallData::BaseCallData(grpc_call_element* elem,
       deadline_(args->deadline),
       context_(args->context) {
   if (flags & kFilterExaminesServerInitialMetadata) {
+    // Not ManagedNew(): the latch holds the waiter of the promise polling it,
+    // and must be destroyed with this call data rather than with the arena.
     server_initial_metadata_latch_ = arena_->New<Latch<ServerMetadata*>>();
   }
 }
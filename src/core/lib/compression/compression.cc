@@ -24,6 +24,7 @@
 #include <grpc/compression.h>
 
 #include "src/core/lib/compression/compression_internal.h"
+#include "src/core/lib/compression/message_compress.h"
 #include "src/core/lib/gpr/useful.h"
 #include "src/core/lib/slice/slice_internal.h"
 #include "src/core/lib/surface/api_trace.h"
@@ -89,3 +90,16 @@ int grpc_compression_options_is_algorithm_enabled(
              opts->enabled_algorithms_bitset)
       .IsSet(algorithm);
 }
+
+int grpc_compression_register_zstd_dictionary(const char* method,
+                                              const void* dictionary,
+                                              size_t dictionary_size) {
+  GRPC_API_TRACE(
+      "grpc_compression_register_zstd_dictionary(method=%s, dictionary=%p, "
+      "dictionary_size=%" PRIuPTR ")",
+      3, (method == nullptr ? "(null)" : method, dictionary, dictionary_size));
+  return grpc_msg_register_zstd_dictionary(
+      method == nullptr ? absl::string_view() : absl::string_view(method),
+      absl::string_view(static_cast<const char*>(dictionary),
+                        dictionary_size));
+}
@@ -46,6 +46,10 @@ const char* CompressionAlgorithmAsString(grpc_compression_algorithm algorithm) {
       return "deflate";
     case GRPC_COMPRESS_GZIP:
       return "gzip";
+    case GRPC_COMPRESS_ZSTD:
+      return "zstd";
+    case GRPC_COMPRESS_LZ4:
+      return "lz4";
     case GRPC_COMPRESS_ALGORITHMS_COUNT:
     default:
       return nullptr;
@@ -60,6 +64,10 @@ absl::optional<grpc_compression_algorithm> ParseCompressionAlgorithm(
     return GRPC_COMPRESS_DEFLATE;
   } else if (algorithm == "gzip") {
     return GRPC_COMPRESS_GZIP;
+  } else if (algorithm == "zstd") {
+    return GRPC_COMPRESS_ZSTD;
+  } else if (algorithm == "lz4") {
+    return GRPC_COMPRESS_LZ4;
   } else {
     return absl::nullopt;
   }
@@ -85,7 +93,9 @@ CompressionAlgorithmSet::CompressionAlgorithmForLevel(
   /* Establish a "ranking" or compression algorithms in increasing order of
    * compression.
    * This is simplistic and we will probably want to introduce other dimensions
-   * in the future (cpu/memory cost, etc). */
+   * in the future (cpu/memory cost, etc). zstd and lz4 are not ranked, so that
+   * levels keep mapping to the same algorithms for peers that accept them:
+   * they have to be requested explicitly. */
   absl::InlinedVector<grpc_compression_algorithm,
                       GRPC_COMPRESS_ALGORITHMS_COUNT>
       algos;
@@ -136,6 +146,20 @@ CompressionAlgorithmSet CompressionAlgorithmSet::FromChannelArgs(
   } else {
     set = CompressionAlgorithmSet::FromUint32(kEverything);
   }
+  // Never advertise an algorithm we could not decompress.
+  return CompressionAlgorithmSet::FromUint32(set.ToLegacyBitmask() &
+                                             Supported().ToLegacyBitmask());
+}
+
+CompressionAlgorithmSet CompressionAlgorithmSet::Supported() {
+  CompressionAlgorithmSet set{GRPC_COMPRESS_NONE, GRPC_COMPRESS_DEFLATE,
+                              GRPC_COMPRESS_GZIP};
+#ifdef GRPC_HAVE_ZSTD
+  set.Set(GRPC_COMPRESS_ZSTD);
+#endif
+#ifdef GRPC_HAVE_LZ4
+  set.Set(GRPC_COMPRESS_LZ4);
+#endif
   return set;
 }
 
@@ -57,6 +57,9 @@ class CompressionAlgorithmSet {
   static CompressionAlgorithmSet FromChannelArgs(const grpc_channel_args* args);
   // Parse a string of comma-separated compression algorithms.
   static CompressionAlgorithmSet FromString(absl::string_view str);
+  // The algorithms this build of gRPC can compress and decompress: zstd and
+  // lz4 are only there if their libraries were built in.
+  static CompressionAlgorithmSet Supported();
   // Construct an empty set.
   CompressionAlgorithmSet();
   // Construct from a std::initializer_list of grpc_compression_algorithm
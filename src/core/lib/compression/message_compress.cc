@@ -22,11 +22,27 @@
 
 #include <string.h>
 
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
 #include <zlib.h>
 
+#include "absl/container/flat_hash_map.h"
+
+#ifdef GRPC_HAVE_ZSTD
+#include <zstd.h>
+#endif
+#ifdef GRPC_HAVE_LZ4
+#include <lz4frame.h>
+#endif
+
 #include <grpc/support/alloc.h>
 #include <grpc/support/log.h>
 
+#include "src/core/lib/gprpp/sync.h"
 #include "src/core/lib/slice/slice_internal.h"
 
 #define OUTPUT_BLOCK_SIZE 1024
@@ -140,6 +156,519 @@ static int zlib_decompress(grpc_slice_buffer* input, grpc_slice_buffer* output,
   return r;
 }
 
+/* Output slices of the zstd and lz4 codecs are at most this large, so that a
+   small message does not pin a large allocation while it is being written. */
+#define MAX_OUTPUT_SLICE_SIZE (64 * 1024)
+
+static void unwind_output(grpc_slice_buffer* output, size_t count_before,
+                          size_t length_before) {
+  for (size_t i = count_before; i < output->count; i++) {
+    grpc_slice_unref_internal(output->slices[i]);
+  }
+  output->count = count_before;
+  output->length = length_before;
+}
+
+/* Appends the first 'used' bytes of 'slice' to 'output'. */
+static void add_used(grpc_slice_buffer* output, grpc_slice slice,
+                     size_t used) {
+  if (used == 0) {
+    grpc_slice_unref_internal(slice);
+    return;
+  }
+  if (slice.refcount != nullptr) {
+    slice.data.refcounted.length = used;
+  } else {
+    slice.data.inlined.length = static_cast<uint8_t>(used);
+  }
+  grpc_slice_buffer_add_indexed(output, slice);
+}
+
+#ifdef GRPC_HAVE_ZSTD
+
+namespace {
+
+/* Keeps a few idle zstd contexts, so that each message does not pay for
+   allocating and initializing the context's tables. */
+template <typename Context, Context* (*kCreate)(), size_t (*kFree)(Context*)>
+class ZstdContextPool {
+ public:
+  Context* Get() {
+    {
+      grpc_core::MutexLock lock(&mu_);
+      if (!idle_.empty()) {
+        Context* context = idle_.back();
+        idle_.pop_back();
+        return context;
+      }
+    }
+    return kCreate();
+  }
+
+  void Put(Context* context) {
+    {
+      grpc_core::MutexLock lock(&mu_);
+      if (idle_.size() < kMaxIdle) {
+        idle_.push_back(context);
+        return;
+      }
+    }
+    kFree(context);
+  }
+
+ private:
+  static constexpr size_t kMaxIdle = 16;
+  grpc_core::Mutex mu_;
+  std::vector<Context*> idle_ ABSL_GUARDED_BY(mu_);
+};
+
+using ZstdCompressContextPool =
+    ZstdContextPool<ZSTD_CCtx, ZSTD_createCCtx, ZSTD_freeCCtx>;
+/* Frames may ask for a window of up to 1 << ZSTD_WINDOWLOG_LIMIT_DEFAULT
+   (128MiB) bytes, which the decompression context allocates and, being
+   pooled, keeps. Our own encoder never needs more than 8MiB, the limit the
+   zstd format recommends decoders support, so larger windows are rejected. */
+#define ZSTD_MAX_WINDOW_LOG 23
+
+/* Resets all of 'dctx' except the window limit, which is reapplied. */
+void reset_decompress_context(ZSTD_DCtx* dctx) {
+  ZSTD_DCtx_reset(dctx, ZSTD_reset_session_and_parameters);
+  ZSTD_DCtx_setParameter(dctx, ZSTD_d_windowLogMax, ZSTD_MAX_WINDOW_LOG);
+}
+
+ZSTD_DCtx* create_decompress_context() {
+  ZSTD_DCtx* dctx = ZSTD_createDCtx();
+  if (dctx != nullptr) reset_decompress_context(dctx);
+  return dctx;
+}
+
+using ZstdDecompressContextPool =
+    ZstdContextPool<ZSTD_DCtx, create_decompress_context, ZSTD_freeDCtx>;
+
+ZstdCompressContextPool* compress_contexts() {
+  static auto* pool = new ZstdCompressContextPool();
+  return pool;
+}
+
+ZstdDecompressContextPool* decompress_contexts() {
+  static auto* pool = new ZstdDecompressContextPool();
+  return pool;
+}
+
+/* A digested dictionary, shared by messages in flight when it is replaced. */
+class ZstdDictionary {
+ public:
+  ZstdDictionary(ZSTD_CDict* cdict, ZSTD_DDict* ddict)
+      : cdict_(cdict), ddict_(ddict) {}
+  ~ZstdDictionary() {
+    ZSTD_freeCDict(cdict_);
+    ZSTD_freeDDict(ddict_);
+  }
+  ZstdDictionary(const ZstdDictionary&) = delete;
+  ZstdDictionary& operator=(const ZstdDictionary&) = delete;
+
+  const ZSTD_CDict* cdict() const { return cdict_; }
+  const ZSTD_DDict* ddict() const { return ddict_; }
+
+ private:
+  ZSTD_CDict* cdict_;
+  ZSTD_DDict* ddict_;
+};
+
+/* Dictionaries by method (for compression) and by id (for decompression,
+   where the frame header names the dictionary it needs). */
+class ZstdDictionaryRegistry {
+ public:
+  bool Register(absl::string_view method, absl::string_view dictionary) {
+    unsigned id = ZSTD_getDictID_fromDict(dictionary.data(), dictionary.size());
+    if (id == 0) return false;
+    ZSTD_CDict* cdict = ZSTD_createCDict(dictionary.data(), dictionary.size(),
+                                         ZSTD_CLEVEL_DEFAULT);
+    ZSTD_DDict* ddict = ZSTD_createDDict(dictionary.data(), dictionary.size());
+    auto dict = std::make_shared<const ZstdDictionary>(cdict, ddict);
+    if (cdict == nullptr || ddict == nullptr) return false;
+    grpc_core::MutexLock lock(&mu_);
+    by_method_[std::string(method)] = dict;
+    by_id_[id] = std::move(dict);
+    any_registered_.store(true, std::memory_order_release);
+    return true;
+  }
+
+  std::shared_ptr<const ZstdDictionary> ForMethod(absl::string_view method) {
+    if (!any_registered_.load(std::memory_order_acquire)) return nullptr;
+    grpc_core::MutexLock lock(&mu_);
+    auto it = by_method_.find(method);
+    if (it == by_method_.end()) it = by_method_.find(absl::string_view());
+    return it == by_method_.end() ? nullptr : it->second;
+  }
+
+  std::shared_ptr<const ZstdDictionary> ForId(unsigned id) {
+    grpc_core::MutexLock lock(&mu_);
+    auto it = by_id_.find(id);
+    return it == by_id_.end() ? nullptr : it->second;
+  }
+
+ private:
+  std::atomic<bool> any_registered_{false};
+  grpc_core::Mutex mu_;
+  absl::flat_hash_map<std::string, std::shared_ptr<const ZstdDictionary>>
+      by_method_ ABSL_GUARDED_BY(mu_);
+  absl::flat_hash_map<unsigned, std::shared_ptr<const ZstdDictionary>> by_id_
+      ABSL_GUARDED_BY(mu_);
+};
+
+ZstdDictionaryRegistry* zstd_dictionaries() {
+  static auto* registry = new ZstdDictionaryRegistry();
+  return registry;
+}
+
+}  // namespace
+
+static int zstd_compress_body(ZSTD_CCtx* cctx, grpc_slice_buffer* input,
+                              grpc_slice_buffer* output) {
+  size_t block_size = std::min<size_t>(ZSTD_compressBound(input->length),
+                                       MAX_OUTPUT_SLICE_SIZE);
+  size_t produced = 0;
+  grpc_slice outbuf = GRPC_SLICE_MALLOC(block_size);
+  ZSTD_outBuffer out = {GRPC_SLICE_START_PTR(outbuf), block_size, 0};
+  /* An empty input still needs one call to write the frame. */
+  size_t i = 0;
+  do {
+    const bool last = input->count == 0 || i == input->count - 1;
+    ZSTD_inBuffer in = {nullptr, 0, 0};
+    if (input->count != 0) {
+      in.src = GRPC_SLICE_START_PTR(input->slices[i]);
+      in.size = GRPC_SLICE_LENGTH(input->slices[i]);
+    }
+    size_t remaining;
+    do {
+      if (out.pos == out.size) {
+        produced += out.pos;
+        /* Compressing would not make the message smaller: give up early. */
+        if (produced >= input->length) goto error;
+        grpc_slice_buffer_add_indexed(output, outbuf);
+        block_size = std::min<size_t>(input->length - produced,
+                                      MAX_OUTPUT_SLICE_SIZE);
+        outbuf = GRPC_SLICE_MALLOC(block_size);
+        out = {GRPC_SLICE_START_PTR(outbuf), block_size, 0};
+      }
+      remaining = ZSTD_compressStream2(cctx, &out, &in,
+                                       last ? ZSTD_e_end : ZSTD_e_continue);
+      if (ZSTD_isError(remaining)) {
+        gpr_log(GPR_INFO, "zstd error (%s)", ZSTD_getErrorName(remaining));
+        goto error;
+      }
+    } while (in.pos < in.size || (last && remaining != 0));
+  } while (++i < input->count);
+  add_used(output, outbuf, out.pos);
+  return 1;
+
+error:
+  grpc_slice_unref_internal(outbuf);
+  return 0;
+}
+
+static int zstd_compress(absl::string_view method, grpc_slice_buffer* input,
+                         grpc_slice_buffer* output) {
+  size_t count_before = output->count;
+  size_t length_before = output->length;
+  std::shared_ptr<const ZstdDictionary> dict =
+      zstd_dictionaries()->ForMethod(method);
+  ZSTD_CCtx* cctx = compress_contexts()->Get();
+  ZSTD_CCtx_reset(cctx, ZSTD_reset_session_and_parameters);
+  if (dict != nullptr) ZSTD_CCtx_refCDict(cctx, dict->cdict());
+  ZSTD_CCtx_setPledgedSrcSize(cctx, input->length);
+  int r = zstd_compress_body(cctx, input, output) &&
+          output->length < input->length;
+  if (!r) unwind_output(output, count_before, length_before);
+  /* Drop the dictionary reference before the context is shared again. */
+  ZSTD_CCtx_reset(cctx, ZSTD_reset_session_and_parameters);
+  compress_contexts()->Put(cctx);
+  return r;
+}
+
+static int zstd_decompress_body(ZSTD_DCtx* dctx, grpc_slice_buffer* input,
+                                grpc_slice_buffer* output) {
+  /* The frame header is small, but may span slices: gather it to learn the
+     dictionary and the content size. */
+  uint8_t header[18 /* ZSTD_FRAMEHEADERSIZE_MAX */];
+  size_t header_size = 0;
+  for (size_t i = 0; i < input->count && header_size < sizeof(header); i++) {
+    size_t n = std::min(sizeof(header) - header_size,
+                        GRPC_SLICE_LENGTH(input->slices[i]));
+    memcpy(header + header_size, GRPC_SLICE_START_PTR(input->slices[i]), n);
+    header_size += n;
+  }
+  std::shared_ptr<const ZstdDictionary> dict;
+  unsigned dict_id = ZSTD_getDictID_fromFrame(header, header_size);
+  if (dict_id != 0) {
+    dict = zstd_dictionaries()->ForId(dict_id);
+    if (dict == nullptr) {
+      gpr_log(GPR_INFO, "zstd: unknown dictionary %u", dict_id);
+      return 0;
+    }
+    ZSTD_DCtx_refDDict(dctx, dict->ddict());
+  }
+  size_t block_size = MAX_OUTPUT_SLICE_SIZE;
+  unsigned long long content_size =
+      ZSTD_getFrameContentSize(header, header_size);
+  if (content_size != ZSTD_CONTENTSIZE_UNKNOWN &&
+      content_size != ZSTD_CONTENTSIZE_ERROR && content_size < block_size) {
+    /* Leave room to see the end of the frame without another slice. */
+    block_size = static_cast<size_t>(content_size) + 1;
+  }
+  grpc_slice outbuf = GRPC_SLICE_MALLOC(block_size);
+  ZSTD_outBuffer out = {GRPC_SLICE_START_PTR(outbuf), block_size, 0};
+  size_t remaining = 1;
+  for (size_t i = 0; i < input->count; i++) {
+    ZSTD_inBuffer in = {GRPC_SLICE_START_PTR(input->slices[i]),
+                        GRPC_SLICE_LENGTH(input->slices[i]), 0};
+    while (in.pos < in.size) {
+      if (remaining == 0) {
+        gpr_log(GPR_INFO, "zstd: not all input consumed");
+        goto error;
+      }
+      if (out.pos == out.size) {
+        grpc_slice_buffer_add_indexed(output, outbuf);
+        block_size = MAX_OUTPUT_SLICE_SIZE;
+        outbuf = GRPC_SLICE_MALLOC(block_size);
+        out = {GRPC_SLICE_START_PTR(outbuf), block_size, 0};
+      }
+      remaining = ZSTD_decompressStream(dctx, &out, &in);
+      if (ZSTD_isError(remaining)) {
+        gpr_log(GPR_INFO, "zstd error (%s)", ZSTD_getErrorName(remaining));
+        goto error;
+      }
+    }
+  }
+  /* Flush what the context still holds once the input is exhausted. */
+  while (remaining != 0 && out.pos == out.size) {
+    grpc_slice_buffer_add_indexed(output, outbuf);
+    outbuf = GRPC_SLICE_MALLOC(MAX_OUTPUT_SLICE_SIZE);
+    out = {GRPC_SLICE_START_PTR(outbuf), MAX_OUTPUT_SLICE_SIZE, 0};
+    ZSTD_inBuffer in = {nullptr, 0, 0};
+    remaining = ZSTD_decompressStream(dctx, &out, &in);
+    if (ZSTD_isError(remaining)) {
+      gpr_log(GPR_INFO, "zstd error (%s)", ZSTD_getErrorName(remaining));
+      goto error;
+    }
+  }
+  if (remaining != 0) {
+    gpr_log(GPR_INFO, "zstd: Data error");
+    goto error;
+  }
+  add_used(output, outbuf, out.pos);
+  return 1;
+
+error:
+  grpc_slice_unref_internal(outbuf);
+  return 0;
+}
+
+static int zstd_decompress(grpc_slice_buffer* input,
+                           grpc_slice_buffer* output) {
+  size_t count_before = output->count;
+  size_t length_before = output->length;
+  ZSTD_DCtx* dctx = decompress_contexts()->Get();
+  int r = zstd_decompress_body(dctx, input, output);
+  if (!r) unwind_output(output, count_before, length_before);
+  reset_decompress_context(dctx);
+  decompress_contexts()->Put(dctx);
+  return r;
+}
+
+#endif /* GRPC_HAVE_ZSTD */
+
+#ifdef GRPC_HAVE_LZ4
+
+#define LZ4_BLOCK_SIZE (64 * 1024)
+
+static int lz4_compress_body(LZ4F_cctx* cctx, grpc_slice_buffer* input,
+                             grpc_slice_buffer* output) {
+  LZ4F_preferences_t prefs;
+  memset(&prefs, 0, sizeof(prefs));
+  prefs.frameInfo.blockSizeID = LZ4F_max64KB;
+  prefs.frameInfo.contentSize = input->length;
+  /* Blocks are handed over whole, so each update emits exactly one block and
+     the room LZ4F_compressUpdate insists on is close to the block itself. */
+  prefs.autoFlush = 1;
+  std::unique_ptr<uint8_t[]> staging;
+  size_t staged = 0;
+  size_t produced = 0;
+  size_t block_size =
+      std::min<size_t>(LZ4F_compressFrameBound(input->length, &prefs),
+                       LZ4F_HEADER_SIZE_MAX +
+                           LZ4F_compressBound(LZ4_BLOCK_SIZE, &prefs));
+  grpc_slice outbuf = GRPC_SLICE_MALLOC(block_size);
+  size_t used = 0;
+  size_t r;
+  /* Makes room for 'needed' bytes, returning false if compression will not
+     save anything. */
+  auto reserve = [&](size_t needed) {
+    if (block_size - used >= needed) return true;
+    produced += used;
+    if (produced >= input->length) return false;
+    add_used(output, outbuf, used);
+    block_size = std::max<size_t>(
+        needed,
+        std::min<size_t>(input->length - produced, MAX_OUTPUT_SLICE_SIZE));
+    outbuf = GRPC_SLICE_MALLOC(block_size);
+    used = 0;
+    return true;
+  };
+  auto update = [&](const uint8_t* src, size_t src_size) {
+    if (!reserve(LZ4F_compressBound(src_size, &prefs))) return false;
+    size_t n = LZ4F_compressUpdate(cctx, GRPC_SLICE_START_PTR(outbuf) + used,
+                                   block_size - used, src, src_size, nullptr);
+    if (LZ4F_isError(n)) {
+      gpr_log(GPR_INFO, "lz4 error (%s)", LZ4F_getErrorName(n));
+      return false;
+    }
+    used += n;
+    return true;
+  };
+  if (!reserve(LZ4F_HEADER_SIZE_MAX)) goto error;
+  r = LZ4F_compressBegin(cctx, GRPC_SLICE_START_PTR(outbuf), block_size,
+                         &prefs);
+  if (LZ4F_isError(r)) {
+    gpr_log(GPR_INFO, "lz4 error (%s)", LZ4F_getErrorName(r));
+    goto error;
+  }
+  used += r;
+  for (size_t i = 0; i < input->count; i++) {
+    const uint8_t* src = GRPC_SLICE_START_PTR(input->slices[i]);
+    size_t src_size = GRPC_SLICE_LENGTH(input->slices[i]);
+    while (src_size > 0) {
+      /* Compress straight from the slice when it holds a whole block (or the
+         rest of the message), and coalesce small slices otherwise. */
+      size_t n;
+      if (staged == 0 &&
+          (src_size >= LZ4_BLOCK_SIZE || i == input->count - 1)) {
+        n = std::min<size_t>(src_size, LZ4_BLOCK_SIZE);
+        if (!update(src, n)) goto error;
+      } else {
+        if (staging == nullptr) staging.reset(new uint8_t[LZ4_BLOCK_SIZE]);
+        n = std::min<size_t>(src_size, LZ4_BLOCK_SIZE - staged);
+        memcpy(staging.get() + staged, src, n);
+        staged += n;
+        if (staged == LZ4_BLOCK_SIZE) {
+          if (!update(staging.get(), staged)) goto error;
+          staged = 0;
+        }
+      }
+      src += n;
+      src_size -= n;
+    }
+  }
+  if (staged > 0 && !update(staging.get(), staged)) goto error;
+  if (!reserve(LZ4F_compressBound(0, &prefs))) goto error;
+  r = LZ4F_compressEnd(cctx, GRPC_SLICE_START_PTR(outbuf) + used,
+                       block_size - used, nullptr);
+  if (LZ4F_isError(r)) {
+    gpr_log(GPR_INFO, "lz4 error (%s)", LZ4F_getErrorName(r));
+    goto error;
+  }
+  add_used(output, outbuf, used + r);
+  return 1;
+
+error:
+  grpc_slice_unref_internal(outbuf);
+  return 0;
+}
+
+static int lz4_compress(grpc_slice_buffer* input, grpc_slice_buffer* output) {
+  size_t count_before = output->count;
+  size_t length_before = output->length;
+  LZ4F_cctx* cctx;
+  if (LZ4F_isError(LZ4F_createCompressionContext(&cctx, LZ4F_VERSION))) {
+    return 0;
+  }
+  int r = lz4_compress_body(cctx, input, output) &&
+          output->length < input->length;
+  if (!r) unwind_output(output, count_before, length_before);
+  LZ4F_freeCompressionContext(cctx);
+  return r;
+}
+
+static int lz4_decompress_body(LZ4F_dctx* dctx, grpc_slice_buffer* input,
+                               grpc_slice_buffer* output) {
+  /* Start with a guess from the compressed size, so that small messages do
+     not allocate a whole block. */
+  size_t block_size =
+      std::min<size_t>(4 * input->length + 64, MAX_OUTPUT_SLICE_SIZE);
+  grpc_slice outbuf = GRPC_SLICE_MALLOC(block_size);
+  size_t used = 0;
+  size_t hint = 1;
+  for (size_t i = 0; i < input->count; i++) {
+    const uint8_t* src = GRPC_SLICE_START_PTR(input->slices[i]);
+    size_t src_size = GRPC_SLICE_LENGTH(input->slices[i]);
+    while (src_size > 0) {
+      if (hint == 0) {
+        gpr_log(GPR_INFO, "lz4: not all input consumed");
+        goto error;
+      }
+      if (used == block_size) {
+        grpc_slice_buffer_add_indexed(output, outbuf);
+        block_size = MAX_OUTPUT_SLICE_SIZE;
+        outbuf = GRPC_SLICE_MALLOC(block_size);
+        used = 0;
+      }
+      size_t dst_size = block_size - used;
+      size_t consumed = src_size;
+      hint = LZ4F_decompress(dctx, GRPC_SLICE_START_PTR(outbuf) + used,
+                             &dst_size, src, &consumed, nullptr);
+      if (LZ4F_isError(hint)) {
+        gpr_log(GPR_INFO, "lz4 error (%s)", LZ4F_getErrorName(hint));
+        goto error;
+      }
+      used += dst_size;
+      src += consumed;
+      src_size -= consumed;
+    }
+  }
+  /* Flush what the context still holds once the input is exhausted. */
+  while (hint != 0 && used == block_size) {
+    grpc_slice_buffer_add_indexed(output, outbuf);
+    block_size = MAX_OUTPUT_SLICE_SIZE;
+    outbuf = GRPC_SLICE_MALLOC(block_size);
+    used = 0;
+    size_t dst_size = block_size;
+    size_t consumed = 0;
+    hint = LZ4F_decompress(dctx, GRPC_SLICE_START_PTR(outbuf), &dst_size,
+                           nullptr, &consumed, nullptr);
+    if (LZ4F_isError(hint)) {
+      gpr_log(GPR_INFO, "lz4 error (%s)", LZ4F_getErrorName(hint));
+      goto error;
+    }
+    used += dst_size;
+  }
+  if (hint != 0) {
+    gpr_log(GPR_INFO, "lz4: Data error");
+    goto error;
+  }
+  add_used(output, outbuf, used);
+  return 1;
+
+error:
+  grpc_slice_unref_internal(outbuf);
+  return 0;
+}
+
+static int lz4_decompress(grpc_slice_buffer* input, grpc_slice_buffer* output) {
+  size_t count_before = output->count;
+  size_t length_before = output->length;
+  LZ4F_dctx* dctx;
+  if (LZ4F_isError(LZ4F_createDecompressionContext(&dctx, LZ4F_VERSION))) {
+    return 0;
+  }
+  int r = lz4_decompress_body(dctx, input, output);
+  if (!r) unwind_output(output, count_before, length_before);
+  LZ4F_freeDecompressionContext(dctx);
+  return r;
+}
+
+#endif /* GRPC_HAVE_LZ4 */
+
 static int copy(grpc_slice_buffer* input, grpc_slice_buffer* output) {
   size_t i;
   for (i = 0; i < input->count; i++) {
@@ -149,7 +678,8 @@ static int copy(grpc_slice_buffer* input, grpc_slice_buffer* output) {
 }
 
 static int compress_inner(grpc_compression_algorithm algorithm,
-                          grpc_slice_buffer* input, grpc_slice_buffer* output) {
+                          absl::string_view method, grpc_slice_buffer* input,
+                          grpc_slice_buffer* output) {
   switch (algorithm) {
     case GRPC_COMPRESS_NONE:
       /* the fallback path always needs to be send uncompressed: we simply
@@ -159,6 +689,19 @@ static int compress_inner(grpc_compression_algorithm algorithm,
       return zlib_compress(input, output, 0);
     case GRPC_COMPRESS_GZIP:
       return zlib_compress(input, output, 1);
+    case GRPC_COMPRESS_ZSTD:
+#ifdef GRPC_HAVE_ZSTD
+      return zstd_compress(method, input, output);
+#else
+      (void)method;
+      break;
+#endif
+    case GRPC_COMPRESS_LZ4:
+#ifdef GRPC_HAVE_LZ4
+      return lz4_compress(input, output);
+#else
+      break;
+#endif
     case GRPC_COMPRESS_ALGORITHMS_COUNT:
       break;
   }
@@ -168,7 +711,15 @@ static int compress_inner(grpc_compression_algorithm algorithm,
 
 int grpc_msg_compress(grpc_compression_algorithm algorithm,
                       grpc_slice_buffer* input, grpc_slice_buffer* output) {
-  if (!compress_inner(algorithm, input, output)) {
+  return grpc_msg_compress_for_method(algorithm, absl::string_view(), input,
+                                      output);
+}
+
+int grpc_msg_compress_for_method(grpc_compression_algorithm algorithm,
+                                 absl::string_view method,
+                                 grpc_slice_buffer* input,
+                                 grpc_slice_buffer* output) {
+  if (!compress_inner(algorithm, method, input, output)) {
     copy(input, output);
     return 0;
   }
@@ -184,9 +735,33 @@ int grpc_msg_decompress(grpc_compression_algorithm algorithm,
       return zlib_decompress(input, output, 0);
     case GRPC_COMPRESS_GZIP:
       return zlib_decompress(input, output, 1);
+    case GRPC_COMPRESS_ZSTD:
+#ifdef GRPC_HAVE_ZSTD
+      return zstd_decompress(input, output);
+#else
+      break;
+#endif
+    case GRPC_COMPRESS_LZ4:
+#ifdef GRPC_HAVE_LZ4
+      return lz4_decompress(input, output);
+#else
+      break;
+#endif
     case GRPC_COMPRESS_ALGORITHMS_COUNT:
       break;
   }
   gpr_log(GPR_ERROR, "invalid compression algorithm %d", algorithm);
   return 0;
 }
+
+bool grpc_msg_register_zstd_dictionary(absl::string_view method,
+                                       absl::string_view dictionary) {
+#ifdef GRPC_HAVE_ZSTD
+  return zstd_dictionaries()->Register(method, dictionary);
+#else
+  (void)method;
+  (void)dictionary;
+  gpr_log(GPR_ERROR, "zstd compression is not built in");
+  return false;
+#endif
+}
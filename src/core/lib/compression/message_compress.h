@@ -21,6 +21,8 @@
 
 #include <grpc/support/port_platform.h>
 
+#include "absl/strings/string_view.h"
+
 #include <grpc/slice_buffer.h>
 
 #include "src/core/lib/compression/compression_internal.h"
@@ -31,10 +33,23 @@
 int grpc_msg_compress(grpc_compression_algorithm algorithm,
                       grpc_slice_buffer* input, grpc_slice_buffer* output);
 
+/* like grpc_msg_compress, but GRPC_COMPRESS_ZSTD uses the dictionary
+   registered for 'method', if there is one. */
+int grpc_msg_compress_for_method(grpc_compression_algorithm algorithm,
+                                 absl::string_view method,
+                                 grpc_slice_buffer* input,
+                                 grpc_slice_buffer* output);
+
 /* decompress 'input' to 'output' using 'algorithm'.
    On success, appends slices to output and returns 1.
    On failure, output is unchanged, and returns 0. */
 int grpc_msg_decompress(grpc_compression_algorithm algorithm,
                         grpc_slice_buffer* input, grpc_slice_buffer* output);
 
+/* registers a zstd dictionary for 'method', or for all methods without a
+   dictionary of their own if 'method' is empty. Returns false if
+   'dictionary' is not a zstd dictionary, or zstd is not built in. */
+bool grpc_msg_register_zstd_dictionary(absl::string_view method,
+                                       absl::string_view dictionary);
+
 #endif /* GRPC_CORE_LIB_COMPRESSION_MESSAGE_COMPRESS_H */
@@ -124,6 +124,9 @@ const char* grpc_stats_counter_name[GRPC_STATS_COUNTER_COUNT] = {
     "cq_ev_queue_trylock_failures",
     "cq_ev_queue_trylock_successes",
     "cq_ev_queue_transient_pop_failures",
+    "ssl_session_cache_hits",
+    "ssl_session_cache_misses",
+    "ssl_session_cache_evictions",
 };
 const char* grpc_stats_counter_doc[GRPC_STATS_COUNTER_COUNT] = {
     "Number of client side calls created by this process",
@@ -249,6 +252,11 @@ const char* grpc_stats_counter_doc[GRPC_STATS_COUNTER_COUNT] = {
     "queue.",
     "Number of times NULL was popped out of completion queue's event queue "
     "even though the event queue was not empty",
+    "Number of SSL session cache lookups that found a live session",
+    "Number of SSL session cache lookups that found no session, or only an "
+    "expired one",
+    "Number of sessions dropped from the SSL session cache because it was "
+    "full or they had expired",
 };
 const char* grpc_stats_histogram_name[GRPC_STATS_HISTOGRAM_COUNT] = {
     "call_initial_size",
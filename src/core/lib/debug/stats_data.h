@@ -125,6 +125,9 @@ typedef enum {
   GRPC_STATS_COUNTER_CQ_EV_QUEUE_TRYLOCK_FAILURES,
   GRPC_STATS_COUNTER_CQ_EV_QUEUE_TRYLOCK_SUCCESSES,
   GRPC_STATS_COUNTER_CQ_EV_QUEUE_TRANSIENT_POP_FAILURES,
+  GRPC_STATS_COUNTER_SSL_SESSION_CACHE_HITS,
+  GRPC_STATS_COUNTER_SSL_SESSION_CACHE_MISSES,
+  GRPC_STATS_COUNTER_SSL_SESSION_CACHE_EVICTIONS,
   GRPC_STATS_COUNTER_COUNT
 } grpc_stats_counters;
 extern const char* grpc_stats_counter_name[GRPC_STATS_COUNTER_COUNT];
@@ -394,6 +397,12 @@ typedef enum {
   GRPC_STATS_INC_COUNTER(GRPC_STATS_COUNTER_CQ_EV_QUEUE_TRYLOCK_SUCCESSES)
 #define GRPC_STATS_INC_CQ_EV_QUEUE_TRANSIENT_POP_FAILURES() \
   GRPC_STATS_INC_COUNTER(GRPC_STATS_COUNTER_CQ_EV_QUEUE_TRANSIENT_POP_FAILURES)
+#define GRPC_STATS_INC_SSL_SESSION_CACHE_HITS() \
+  GRPC_STATS_INC_COUNTER(GRPC_STATS_COUNTER_SSL_SESSION_CACHE_HITS)
+#define GRPC_STATS_INC_SSL_SESSION_CACHE_MISSES() \
+  GRPC_STATS_INC_COUNTER(GRPC_STATS_COUNTER_SSL_SESSION_CACHE_MISSES)
+#define GRPC_STATS_INC_SSL_SESSION_CACHE_EVICTIONS() \
+  GRPC_STATS_INC_COUNTER(GRPC_STATS_COUNTER_SSL_SESSION_CACHE_EVICTIONS)
 #define GRPC_STATS_INC_CALL_INITIAL_SIZE(value) \
   grpc_stats_inc_call_initial_size((int)(value))
 void grpc_stats_inc_call_initial_size(int x);
@@ -531,6 +540,9 @@ void grpc_stats_inc_server_cqs_checked(int x);
 #define GRPC_STATS_INC_CQ_EV_QUEUE_TRYLOCK_FAILURES()
 #define GRPC_STATS_INC_CQ_EV_QUEUE_TRYLOCK_SUCCESSES()
 #define GRPC_STATS_INC_CQ_EV_QUEUE_TRANSIENT_POP_FAILURES()
+#define GRPC_STATS_INC_SSL_SESSION_CACHE_HITS()
+#define GRPC_STATS_INC_SSL_SESSION_CACHE_MISSES()
+#define GRPC_STATS_INC_SSL_SESSION_CACHE_EVICTIONS()
 #define GRPC_STATS_INC_CALL_INITIAL_SIZE(value)
 #define GRPC_STATS_INC_POLL_EVENTS_RETURNED(value)
 #define GRPC_STATS_INC_TCP_WRITE_SIZE(value)
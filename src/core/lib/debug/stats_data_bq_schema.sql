@@ -94,4 +94,7 @@ server_requested_calls_per_iteration:FLOAT,
 server_slowpath_requests_queued_per_iteration:FLOAT,
 cq_ev_queue_trylock_failures_per_iteration:FLOAT,
 cq_ev_queue_trylock_successes_per_iteration:FLOAT,
-cq_ev_queue_transient_pop_failures_per_iteration:FLOAT
+cq_ev_queue_transient_pop_failures_per_iteration:FLOAT,
+ssl_session_cache_hits_per_iteration:FLOAT,
+ssl_session_cache_misses_per_iteration:FLOAT,
+ssl_session_cache_evictions_per_iteration:FLOAT
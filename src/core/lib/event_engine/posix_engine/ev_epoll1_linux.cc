@@ -0,0 +1,271 @@
+// Copyright 2022 The gRPC Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <grpc/support/port_platform.h>
+
+#include "src/core/lib/event_engine/posix_engine/ev_epoll1_linux.h"
+
+#include "src/core/lib/iomgr/port.h"
+
+#ifdef GRPC_LINUX_EPOLL
+
+#include <errno.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <limits>
+
+#include <grpc/support/log.h>
+
+#include "src/core/lib/event_engine/posix_engine/lockfree_event.h"
+
+namespace grpc_event_engine {
+namespace posix_engine {
+
+namespace {
+constexpr int kMaxEpollEvents = 100;
+// The low bit of epoll_event.data.ptr records whether the handle tracks
+// socket errors separately.
+constexpr intptr_t kTrackErrBit = 1;
+}  // namespace
+
+class Epoll1EventHandle final : public EventHandle {
+ public:
+  Epoll1EventHandle(int fd, bool track_err, Epoll1Poller* poller)
+      : fd_(fd),
+        track_err_(track_err),
+        poller_(poller),
+        read_closure_(poller->GetScheduler()),
+        write_closure_(poller->GetScheduler()),
+        error_closure_(poller->GetScheduler()) {
+    InitEvents();
+  }
+
+  void ReInit(int fd, bool track_err) {
+    fd_ = fd;
+    track_err_ = track_err;
+    InitEvents();
+  }
+
+  int WrappedFd() override { return fd_; }
+
+  void OrphanHandle(PosixEngineClosure* on_done, int* release_fd,
+                    absl::string_view /*reason*/) override {
+    epoll_event ev_fd;
+    memset(&ev_fd, 0, sizeof(ev_fd));
+    // Remove the fd from the epoll set before closing it or handing it back,
+    // so no further events can be reported for it.
+    epoll_ctl(poller_->epoll_fd_, EPOLL_CTL_DEL, fd_, &ev_fd);
+    if (release_fd != nullptr) {
+      *release_fd = fd_;
+    } else {
+      close(fd_);
+    }
+    absl::Status why = absl::CancelledError("FD orphaned");
+    read_closure_.SetShutdown(why);
+    write_closure_.SetShutdown(why);
+    error_closure_.SetShutdown(why);
+    read_closure_.DestroyEvent();
+    write_closure_.DestroyEvent();
+    error_closure_.DestroyEvent();
+    poller_->ReleaseHandle(this);
+    if (on_done != nullptr) {
+      on_done->SetStatus(absl::OkStatus());
+      poller_->GetScheduler()->Run(on_done);
+    }
+  }
+
+  void ShutdownHandle(absl::Status why) override {
+    // Only the first shutdown shuts the socket down; later ones are no-ops.
+    if (read_closure_.SetShutdown(why)) {
+      shutdown(fd_, SHUT_RDWR);
+      write_closure_.SetShutdown(why);
+      error_closure_.SetShutdown(why);
+    }
+  }
+
+  void NotifyOnRead(PosixEngineClosure* on_read) override {
+    read_closure_.NotifyOn(on_read);
+  }
+  void NotifyOnWrite(PosixEngineClosure* on_write) override {
+    write_closure_.NotifyOn(on_write);
+  }
+  void NotifyOnError(PosixEngineClosure* on_error) override {
+    error_closure_.NotifyOn(on_error);
+  }
+  void SetReadable() override { read_closure_.SetReady(); }
+  void SetWritable() override { write_closure_.SetReady(); }
+  void SetHasError() override { error_closure_.SetReady(); }
+  bool IsHandleShutdown() override { return read_closure_.IsShutdown(); }
+  PosixEventPoller* Poller() override { return poller_; }
+
+  bool track_err() const { return track_err_; }
+
+  // Intrusive links owned by the poller.
+  Epoll1EventHandle* next_free = nullptr;
+  Epoll1EventHandle* next_all = nullptr;
+
+ private:
+  void InitEvents() {
+    read_closure_.InitEvent();
+    write_closure_.InitEvent();
+    error_closure_.InitEvent();
+  }
+
+  int fd_;
+  bool track_err_;
+  Epoll1Poller* poller_;
+  LockfreeEvent read_closure_;
+  LockfreeEvent write_closure_;
+  LockfreeEvent error_closure_;
+};
+
+Epoll1Poller::Epoll1Poller(Scheduler* scheduler) : scheduler_(scheduler) {
+  epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+  GPR_ASSERT(epoll_fd_ >= 0);
+  wakeup_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  GPR_ASSERT(wakeup_fd_ >= 0);
+  epoll_event ev;
+  ev.events = static_cast<uint32_t>(EPOLLIN | EPOLLET);
+  // A null data pointer identifies the wakeup fd.
+  ev.data.ptr = nullptr;
+  GPR_ASSERT(epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, wakeup_fd_, &ev) == 0);
+}
+
+Epoll1Poller::~Epoll1Poller() {
+  {
+    grpc_core::MutexLock lock(&mu_);
+    while (all_handles_ != nullptr) {
+      Epoll1EventHandle* next = all_handles_->next_all;
+      delete all_handles_;
+      all_handles_ = next;
+    }
+  }
+  close(wakeup_fd_);
+  close(epoll_fd_);
+}
+
+void Epoll1Poller::Shutdown() { delete this; }
+
+EventHandle* Epoll1Poller::CreateHandle(int fd, absl::string_view /*name*/,
+                                        bool track_err) {
+  Epoll1EventHandle* handle = nullptr;
+  {
+    grpc_core::MutexLock lock(&mu_);
+    if (free_handles_ != nullptr) {
+      handle = free_handles_;
+      free_handles_ = handle->next_free;
+      handle->ReInit(fd, track_err);
+    } else {
+      handle = new Epoll1EventHandle(fd, track_err, this);
+      handle->next_all = all_handles_;
+      all_handles_ = handle;
+    }
+  }
+  epoll_event ev;
+  ev.events = static_cast<uint32_t>(EPOLLIN | EPOLLOUT | EPOLLET);
+  ev.data.ptr = reinterpret_cast<void*>(reinterpret_cast<intptr_t>(handle) |
+                                        (track_err ? kTrackErrBit : 0));
+  if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &ev) != 0) {
+    gpr_log(GPR_ERROR, "epoll_ctl failed: %s", strerror(errno));
+  }
+  return handle;
+}
+
+void Epoll1Poller::ReleaseHandle(Epoll1EventHandle* handle) {
+  grpc_core::MutexLock lock(&mu_);
+  handle->next_free = free_handles_;
+  free_handles_ = handle;
+}
+
+PosixEventPoller::WorkResult Epoll1Poller::Work(grpc_core::Duration timeout) {
+  int timeout_ms;
+  if (timeout == grpc_core::Duration::Infinity()) {
+    timeout_ms = -1;
+  } else if (timeout <= grpc_core::Duration::Zero()) {
+    timeout_ms = 0;
+  } else {
+    timeout_ms = static_cast<int>(std::min<int64_t>(
+        timeout.millis(), std::numeric_limits<int>::max()));
+  }
+  epoll_event events[kMaxEpollEvents];
+  int r;
+  do {
+    r = epoll_wait(epoll_fd_, events, kMaxEpollEvents, timeout_ms);
+  } while (r < 0 && errno == EINTR);
+  if (r < 0) {
+    gpr_log(GPR_ERROR, "epoll_wait failed: %s", strerror(errno));
+    return WorkResult::kOk;
+  }
+  if (r == 0) return WorkResult::kDeadlineExceeded;
+  bool kicked = false;
+  for (int i = 0; i < r; i++) {
+    void* data_ptr = events[i].data.ptr;
+    if (data_ptr == nullptr) {
+      eventfd_t value;
+      while (eventfd_read(wakeup_fd_, &value) < 0 && errno == EINTR) {
+      }
+      kicked = true;
+      continue;
+    }
+    auto* handle = reinterpret_cast<Epoll1EventHandle*>(
+        reinterpret_cast<intptr_t>(data_ptr) & ~kTrackErrBit);
+    bool track_err = (reinterpret_cast<intptr_t>(data_ptr) & kTrackErrBit) != 0;
+    uint32_t ev = events[i].events;
+    bool cancel = (ev & EPOLLHUP) != 0;
+    bool error = (ev & EPOLLERR) != 0;
+    bool read_ev = (ev & (EPOLLIN | EPOLLPRI)) != 0;
+    bool write_ev = (ev & EPOLLOUT) != 0;
+    bool err_fallback = error && !track_err;
+    if (error && !err_fallback) handle->SetHasError();
+    if (read_ev || cancel || err_fallback) handle->SetReadable();
+    if (write_ev || cancel || err_fallback) handle->SetWritable();
+  }
+  return kicked ? WorkResult::kKicked : WorkResult::kOk;
+}
+
+void Epoll1Poller::Kick() {
+  while (eventfd_write(wakeup_fd_, 1) < 0 && errno == EINTR) {
+  }
+}
+
+Epoll1Poller* MakeEpoll1Poller(Scheduler* scheduler) {
+  // Probe for epoll support before committing to it.
+  int fd = epoll_create1(EPOLL_CLOEXEC);
+  if (fd < 0) {
+    gpr_log(GPR_ERROR, "epoll_create1 unavailable: %s", strerror(errno));
+    return nullptr;
+  }
+  close(fd);
+  return new Epoll1Poller(scheduler);
+}
+
+}  // namespace posix_engine
+}  // namespace grpc_event_engine
+
+#else  // GRPC_LINUX_EPOLL
+
+namespace grpc_event_engine {
+namespace posix_engine {
+
+Epoll1Poller* MakeEpoll1Poller(Scheduler* /*scheduler*/) { return nullptr; }
+
+}  // namespace posix_engine
+}  // namespace grpc_event_engine
+
+#endif  // GRPC_LINUX_EPOLL
@@ -0,0 +1,70 @@
+// Copyright 2022 The gRPC Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#ifndef GRPC_CORE_LIB_EVENT_ENGINE_POSIX_ENGINE_EV_EPOLL1_LINUX_H
+#define GRPC_CORE_LIB_EVENT_ENGINE_POSIX_ENGINE_EV_EPOLL1_LINUX_H
+
+#include <grpc/support/port_platform.h>
+
+#include <string>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/strings/string_view.h"
+
+#include "src/core/lib/event_engine/posix_engine/event_poller.h"
+#include "src/core/lib/gprpp/sync.h"
+#include "src/core/lib/iomgr/port.h"
+
+namespace grpc_event_engine {
+namespace posix_engine {
+
+class Epoll1EventHandle;
+
+/// An edge-triggered epoll poller. Every fd is registered once for
+/// EPOLLIN | EPOLLOUT | EPOLLET, so readiness costs one epoll_wait wakeup and
+/// no epoll_ctl re-arming per operation.
+class Epoll1Poller final : public PosixEventPoller {
+ public:
+  explicit Epoll1Poller(Scheduler* scheduler);
+  EventHandle* CreateHandle(int fd, absl::string_view name,
+                            bool track_err) override;
+  WorkResult Work(grpc_core::Duration timeout) override;
+  void Kick() override;
+  std::string Name() override { return "epoll1"; }
+  void Shutdown() override;
+
+  Scheduler* GetScheduler() { return scheduler_; }
+
+ private:
+  friend class Epoll1EventHandle;
+  ~Epoll1Poller() override;
+
+  // Returns a handle to the free list. The handle is not deleted, since a
+  // concurrent epoll_wait may still report events for it.
+  void ReleaseHandle(Epoll1EventHandle* handle);
+
+  Scheduler* scheduler_;
+  int epoll_fd_ = -1;
+  int wakeup_fd_ = -1;
+  grpc_core::Mutex mu_;
+  Epoll1EventHandle* free_handles_ ABSL_GUARDED_BY(mu_) = nullptr;
+  Epoll1EventHandle* all_handles_ ABSL_GUARDED_BY(mu_) = nullptr;
+};
+
+/// Returns a new epoll poller, or nullptr if epoll is not available.
+Epoll1Poller* MakeEpoll1Poller(Scheduler* scheduler);
+
+}  // namespace posix_engine
+}  // namespace grpc_event_engine
+
+#endif  // GRPC_CORE_LIB_EVENT_ENGINE_POSIX_ENGINE_EV_EPOLL1_LINUX_H
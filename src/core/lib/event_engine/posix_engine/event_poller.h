@@ -0,0 +1,101 @@
+// Copyright 2022 The gRPC Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#ifndef GRPC_CORE_LIB_EVENT_ENGINE_POSIX_ENGINE_EVENT_POLLER_H
+#define GRPC_CORE_LIB_EVENT_ENGINE_POSIX_ENGINE_EVENT_POLLER_H
+
+#include <grpc/support/port_platform.h>
+
+#include <functional>
+#include <string>
+
+#include "absl/status/status.h"
+#include "absl/strings/string_view.h"
+
+#include <grpc/event_engine/event_engine.h>
+
+#include "src/core/lib/event_engine/posix_engine/posix_engine_closure.h"
+#include "src/core/lib/gprpp/time.h"
+
+namespace grpc_event_engine {
+namespace posix_engine {
+
+/// Runs closures on behalf of a poller. Pollers never run I/O callbacks inline;
+/// they hand them to the Scheduler, which is normally the engine's thread pool.
+class Scheduler {
+ public:
+  virtual void Run(experimental::EventEngine::Closure* closure) = 0;
+  virtual void Run(std::function<void()> cb) = 0;
+  virtual ~Scheduler() = default;
+};
+
+class PosixEventPoller;
+
+/// A file descriptor registered with a PosixEventPoller.
+class EventHandle {
+ public:
+  virtual int WrappedFd() = 0;
+  /// Stops polling the fd and releases the handle. If \a release_fd is
+  /// non-null the fd is not closed and is returned through it instead.
+  /// \a on_done (if any) is scheduled once the handle is released.
+  virtual void OrphanHandle(PosixEngineClosure* on_done, int* release_fd,
+                            absl::string_view reason) = 0;
+  /// Fails all pending and future notifications with \a why and shuts down
+  /// the underlying socket.
+  virtual void ShutdownHandle(absl::Status why) = 0;
+  /// Schedules \a on_read once the fd becomes readable (or is shut down).
+  /// At most one read notification may be pending at a time.
+  virtual void NotifyOnRead(PosixEngineClosure* on_read) = 0;
+  /// Schedules \a on_write once the fd becomes writable (or is shut down).
+  virtual void NotifyOnWrite(PosixEngineClosure* on_write) = 0;
+  /// Schedules \a on_error once the fd has a pending socket error (or is shut
+  /// down). Only meaningful for handles created with track_err.
+  virtual void NotifyOnError(PosixEngineClosure* on_error) = 0;
+  /// Force the corresponding event as ready, as if reported by the poller.
+  virtual void SetReadable() = 0;
+  virtual void SetWritable() = 0;
+  virtual void SetHasError() = 0;
+  virtual bool IsHandleShutdown() = 0;
+  virtual PosixEventPoller* Poller() = 0;
+
+ protected:
+  ~EventHandle() = default;
+};
+
+/// An fd readiness poller. A single thread calls Work() in a loop; all other
+/// methods are thread safe.
+class PosixEventPoller {
+ public:
+  enum class WorkResult { kOk, kDeadlineExceeded, kKicked };
+
+  /// Registers \a fd. With \a track_err, socket errors are delivered through
+  /// NotifyOnError instead of waking readers and writers.
+  virtual EventHandle* CreateHandle(int fd, absl::string_view name,
+                                    bool track_err) = 0;
+  /// Waits up to \a timeout for fd events and schedules the closures of every
+  /// handle that became ready.
+  virtual WorkResult Work(grpc_core::Duration timeout) = 0;
+  /// Wakes up a concurrent (or the next) call to Work().
+  virtual void Kick() = 0;
+  virtual std::string Name() = 0;
+  /// Releases the poller. All handles must already be orphaned.
+  virtual void Shutdown() = 0;
+
+ protected:
+  virtual ~PosixEventPoller() = default;
+};
+
+}  // namespace posix_engine
+}  // namespace grpc_event_engine
+
+#endif  // GRPC_CORE_LIB_EVENT_ENGINE_POSIX_ENGINE_EVENT_POLLER_H
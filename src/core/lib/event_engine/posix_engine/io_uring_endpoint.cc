@@ -0,0 +1,454 @@
+// Copyright 2022 The gRPC Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <grpc/support/port_platform.h>
+
+#include "src/core/lib/event_engine/posix_engine/io_uring_endpoint.h"
+
+#include <stdlib.h>
+
+#include "src/core/lib/iomgr/port.h"
+
+#ifdef GRPC_LINUX_IO_URING
+
+#include <errno.h>
+#include <limits.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <functional>
+#include <utility>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/memory/memory.h"
+#include "absl/status/status.h"
+
+#include <grpc/slice.h>
+#include <grpc/slice_buffer.h>
+#include <grpc/support/log.h>
+
+#include "src/core/lib/event_engine/posix_engine/tcp_socket_utils.h"
+#include "src/core/lib/gprpp/ref_counted.h"
+#include "src/core/lib/gprpp/ref_counted_ptr.h"
+#include "src/core/lib/gprpp/sync.h"
+#include "src/core/lib/slice/slice_internal.h"
+
+#if defined(IOV_MAX) && IOV_MAX < 260
+#define MAX_WRITE_IOVEC IOV_MAX
+#else
+#define MAX_WRITE_IOVEC 260
+#endif
+
+namespace grpc_event_engine {
+namespace posix_engine {
+
+namespace {
+
+using ::grpc_event_engine::experimental::EventEngine;
+using ::grpc_event_engine::experimental::MemoryAllocator;
+using ::grpc_event_engine::experimental::SliceBuffer;
+
+// Received bytes an endpoint queues while nobody reads. Beyond this the
+// receive is cancelled, so that a slow reader cannot take all of the
+// poller's shared buffers.
+constexpr size_t kMaxBufferedBytes = 256 * 1024;
+
+// The state of one connection. The Endpoint owns one ref, and every
+// operation submitted to the ring holds another until its final completion,
+// so the socket stays open until the kernel is done with it.
+class IoUringEndpointImpl : public grpc_core::RefCounted<IoUringEndpointImpl> {
+ public:
+  IoUringEndpointImpl(int fd, IoUringPoller* poller,
+                      MemoryAllocator&& allocator);
+  ~IoUringEndpointImpl() override;
+
+  void Read(std::function<void(absl::Status)> on_read, SliceBuffer* buffer);
+  void Write(std::function<void(absl::Status)> on_writable, SliceBuffer* data);
+  const EventEngine::ResolvedAddress& GetPeerAddress() const {
+    return peer_address_;
+  }
+  const EventEngine::ResolvedAddress& GetLocalAddress() const {
+    return local_address_;
+  }
+
+  // Fails the pending read, shuts the socket down so that the operations in
+  // flight complete, and drops the Endpoint's ref.
+  void Shutdown();
+
+ private:
+  // Routes the completions of one kind of operation to a member function.
+  class Operation final : public IoUringPoller::Completion {
+   public:
+    Operation(IoUringEndpointImpl* endpoint,
+              void (IoUringEndpointImpl::*on_complete)(int, uint32_t))
+        : endpoint_(endpoint), on_complete_(on_complete) {}
+    void OnComplete(int res, uint32_t flags) override {
+      (endpoint_->*on_complete_)(res, flags);
+    }
+
+   private:
+    IoUringEndpointImpl* const endpoint_;
+    void (IoUringEndpointImpl::*const on_complete_)(int, uint32_t);
+  };
+
+  // Arms the multishot receive unless it is armed already, or there is no
+  // point in receiving more.
+  void MaybeArmRecvLocked() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+  // Hands whatever was received (or the error that ended the stream) to a
+  // pending read. Returns the read callback to run, if any.
+  std::function<void()> MaybeFinishReadLocked()
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+  void CancelRecvLocked() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+  void OnRecv(int res, uint32_t flags);
+  void OnBuffersAvailable();
+  void SubmitSend();
+  void OnSend(int res, uint32_t flags);
+  void OnCancel(int res, uint32_t flags);
+
+  const int fd_;
+  IoUringPoller* const poller_;
+  Scheduler* const scheduler_;
+  MemoryAllocator memory_allocator_;
+  EventEngine::ResolvedAddress peer_address_;
+  EventEngine::ResolvedAddress local_address_;
+  Operation recv_op_{this, &IoUringEndpointImpl::OnRecv};
+  Operation send_op_{this, &IoUringEndpointImpl::OnSend};
+  Operation cancel_op_{this, &IoUringEndpointImpl::OnCancel};
+
+  grpc_core::Mutex mu_;
+  // Data received ahead of a read.
+  grpc_slice_buffer received_ ABSL_GUARDED_BY(mu_);
+  // How the stream ended, once received_ is drained.
+  absl::Status read_status_ ABSL_GUARDED_BY(mu_);
+  std::function<void(absl::Status)> read_cb_ ABSL_GUARDED_BY(mu_);
+  grpc_slice_buffer* read_buffer_ ABSL_GUARDED_BY(mu_) = nullptr;
+  bool recv_armed_ ABSL_GUARDED_BY(mu_) = false;
+  bool recv_cancelled_ ABSL_GUARDED_BY(mu_) = false;
+  bool waiting_for_buffers_ ABSL_GUARDED_BY(mu_) = false;
+  bool shutdown_ ABSL_GUARDED_BY(mu_) = false;
+
+  // There is at most one write outstanding, and at most one send in flight
+  // for it, so the write state needs no lock.
+  std::function<void(absl::Status)> write_cb_;
+  grpc_slice_buffer* outgoing_buffer_ = nullptr;
+  size_t outgoing_slice_idx_ = 0;
+  size_t outgoing_byte_idx_ = 0;
+  // Referenced by the kernel until the send completes.
+  msghdr msg_;
+  iovec iov_[MAX_WRITE_IOVEC];
+};
+
+IoUringEndpointImpl::IoUringEndpointImpl(int fd, IoUringPoller* poller,
+                                         MemoryAllocator&& allocator)
+    : fd_(fd),
+      poller_(poller),
+      scheduler_(poller->scheduler()),
+      memory_allocator_(std::move(allocator)) {
+  grpc_slice_buffer_init(&received_);
+  auto local_address = LocalAddress(fd_);
+  if (local_address.ok()) local_address_ = *local_address;
+  auto peer_address = PeerAddress(fd_);
+  if (peer_address.ok()) peer_address_ = *peer_address;
+  grpc_core::MutexLock lock(&mu_);
+  MaybeArmRecvLocked();
+}
+
+IoUringEndpointImpl::~IoUringEndpointImpl() {
+  close(fd_);
+  grpc_slice_buffer_destroy_internal(&received_);
+}
+
+void IoUringEndpointImpl::Shutdown() {
+  std::function<void(absl::Status)> cb;
+  {
+    grpc_core::MutexLock lock(&mu_);
+    shutdown_ = true;
+    if (read_cb_ != nullptr) {
+      cb = std::move(read_cb_);
+      read_cb_ = nullptr;
+      read_buffer_ = nullptr;
+    }
+    if (recv_armed_) CancelRecvLocked();
+  }
+  // Fails a send that is in flight.
+  shutdown(fd_, SHUT_RDWR);
+  if (cb != nullptr) {
+    scheduler_->Run(std::bind(std::move(cb),
+                              absl::CancelledError("Endpoint destroyed")));
+  }
+  Unref();
+}
+
+void IoUringEndpointImpl::MaybeArmRecvLocked() {
+  if (recv_armed_ || waiting_for_buffers_ || shutdown_ ||
+      !read_status_.ok() || received_.length >= kMaxBufferedBytes) {
+    return;
+  }
+  io_uring_sqe sqe;
+  memset(&sqe, 0, sizeof(sqe));
+  sqe.opcode = IORING_OP_RECV;
+  sqe.fd = fd_;
+  sqe.ioprio = IORING_RECV_MULTISHOT;
+  sqe.flags = IOSQE_BUFFER_SELECT;
+  sqe.buf_group = poller_->buffer_group();
+  recv_armed_ = true;
+  recv_cancelled_ = false;
+  Ref().release();
+  poller_->Submit(sqe, &recv_op_);
+}
+
+void IoUringEndpointImpl::CancelRecvLocked() {
+  if (recv_cancelled_) return;
+  recv_cancelled_ = true;
+  io_uring_sqe sqe;
+  memset(&sqe, 0, sizeof(sqe));
+  sqe.opcode = IORING_OP_ASYNC_CANCEL;
+  sqe.addr = reinterpret_cast<uint64_t>(
+      static_cast<IoUringPoller::Completion*>(&recv_op_));
+  Ref().release();
+  poller_->Submit(sqe, &cancel_op_);
+}
+
+std::function<void()> IoUringEndpointImpl::MaybeFinishReadLocked() {
+  if (read_cb_ == nullptr) return nullptr;
+  absl::Status status;
+  if (received_.length > 0) {
+    grpc_slice_buffer_swap(read_buffer_, &received_);
+  } else if (!read_status_.ok()) {
+    status = read_status_;
+  } else {
+    return nullptr;
+  }
+  std::function<void()> cb = std::bind(std::move(read_cb_), std::move(status));
+  read_cb_ = nullptr;
+  read_buffer_ = nullptr;
+  return cb;
+}
+
+void IoUringEndpointImpl::Read(std::function<void(absl::Status)> on_read,
+                               SliceBuffer* buffer) {
+  std::function<void()> cb;
+  {
+    grpc_core::MutexLock lock(&mu_);
+    GPR_ASSERT(read_cb_ == nullptr);
+    grpc_slice_buffer* incoming = buffer->RawSliceBuffer();
+    grpc_slice_buffer_reset_and_unref_internal(incoming);
+    if (shutdown_) {
+      cb = std::bind(std::move(on_read),
+                     absl::CancelledError("Read on a shut down endpoint"));
+    } else {
+      read_cb_ = std::move(on_read);
+      read_buffer_ = incoming;
+      cb = MaybeFinishReadLocked();
+      // Resume receiving if the queue was full.
+      MaybeArmRecvLocked();
+    }
+  }
+  if (cb != nullptr) scheduler_->Run(std::move(cb));
+}
+
+void IoUringEndpointImpl::OnRecv(int res, uint32_t flags) {
+  const bool more = (flags & IORING_CQE_F_MORE) != 0;
+  bool wait_for_buffers = false;
+  std::function<void()> cb;
+  {
+    grpc_core::MutexLock lock(&mu_);
+    if (res > 0) {
+      GPR_ASSERT(flags & IORING_CQE_F_BUFFER);
+      grpc_slice slice = poller_->TakeBuffer(
+          static_cast<uint16_t>(flags >> IORING_CQE_BUFFER_SHIFT), res);
+      if (received_.length >= kMaxBufferedBytes) {
+        // The kernel keeps receiving until the cancellation lands. Copy what
+        // arrives in the meantime, so the shared buffers go straight back.
+        grpc_slice copy = grpc_slice_copy(slice);
+        grpc_slice_unref_internal(slice);
+        slice = copy;
+      }
+      grpc_slice_buffer_add(&received_, slice);
+    } else if (res == 0) {
+      read_status_ = absl::UnavailableError("Socket closed");
+    } else if (res == -ENOBUFS) {
+      // Every provided buffer holds data that was not consumed yet.
+      wait_for_buffers = !shutdown_;
+      waiting_for_buffers_ = wait_for_buffers;
+    } else if (res != -ECANCELED && res != -EINTR) {
+      read_status_ = PosixOSError(-res, "recv");
+    }
+    if (!more) recv_armed_ = false;
+    cb = MaybeFinishReadLocked();
+    if (!more) {
+      MaybeArmRecvLocked();
+    } else if (received_.length >= kMaxBufferedBytes) {
+      CancelRecvLocked();
+    }
+  }
+  if (cb != nullptr) scheduler_->Run(std::move(cb));
+  if (wait_for_buffers) {
+    grpc_core::RefCountedPtr<IoUringEndpointImpl> self = Ref();
+    poller_->NotifyOnBufferAvailable([self]() { self->OnBuffersAvailable(); });
+  }
+  if (!more) Unref();
+}
+
+void IoUringEndpointImpl::OnBuffersAvailable() {
+  grpc_core::MutexLock lock(&mu_);
+  waiting_for_buffers_ = false;
+  MaybeArmRecvLocked();
+}
+
+void IoUringEndpointImpl::Write(std::function<void(absl::Status)> on_writable,
+                                SliceBuffer* data) {
+  grpc_slice_buffer* buf = data->RawSliceBuffer();
+  GPR_ASSERT(write_cb_ == nullptr);
+  if (buf->length == 0) {
+    absl::Status status;
+    {
+      grpc_core::MutexLock lock(&mu_);
+      if (shutdown_) {
+        status = absl::CancelledError("Write on a shut down endpoint");
+      }
+    }
+    scheduler_->Run(std::bind(std::move(on_writable), std::move(status)));
+    return;
+  }
+  write_cb_ = std::move(on_writable);
+  outgoing_buffer_ = buf;
+  outgoing_slice_idx_ = 0;
+  outgoing_byte_idx_ = 0;
+  SubmitSend();
+}
+
+void IoUringEndpointImpl::SubmitSend() {
+  size_t iov_size = 0;
+  size_t byte_idx = outgoing_byte_idx_;
+  for (size_t i = outgoing_slice_idx_;
+       i != outgoing_buffer_->count && iov_size != MAX_WRITE_IOVEC; i++) {
+    iov_[iov_size].iov_base =
+        GRPC_SLICE_START_PTR(outgoing_buffer_->slices[i]) + byte_idx;
+    iov_[iov_size].iov_len =
+        GRPC_SLICE_LENGTH(outgoing_buffer_->slices[i]) - byte_idx;
+    iov_size++;
+    byte_idx = 0;
+  }
+  memset(&msg_, 0, sizeof(msg_));
+  msg_.msg_iov = iov_;
+  msg_.msg_iovlen = iov_size;
+  io_uring_sqe sqe;
+  memset(&sqe, 0, sizeof(sqe));
+  sqe.opcode = IORING_OP_SENDMSG;
+  sqe.fd = fd_;
+  sqe.addr = reinterpret_cast<uint64_t>(&msg_);
+  sqe.msg_flags = MSG_NOSIGNAL;
+  Ref().release();
+  poller_->Submit(sqe, &send_op_);
+}
+
+void IoUringEndpointImpl::OnSend(int res, uint32_t /*flags*/) {
+  absl::Status status;
+  if (res == -EINTR || res == -EAGAIN) {
+    SubmitSend();
+    Unref();
+    return;
+  }
+  if (res < 0) {
+    status = PosixOSError(-res, "sendmsg");
+  } else {
+    // Skip over what the kernel accepted.
+    size_t sent = static_cast<size_t>(res);
+    while (sent > 0) {
+      size_t remaining =
+          GRPC_SLICE_LENGTH(outgoing_buffer_->slices[outgoing_slice_idx_]) -
+          outgoing_byte_idx_;
+      if (sent < remaining) {
+        outgoing_byte_idx_ += sent;
+        break;
+      }
+      sent -= remaining;
+      outgoing_slice_idx_++;
+      outgoing_byte_idx_ = 0;
+    }
+    if (outgoing_slice_idx_ != outgoing_buffer_->count) {
+      SubmitSend();
+      Unref();
+      return;
+    }
+  }
+  grpc_slice_buffer_reset_and_unref_internal(outgoing_buffer_);
+  outgoing_buffer_ = nullptr;
+  std::function<void(absl::Status)> cb = std::move(write_cb_);
+  write_cb_ = nullptr;
+  scheduler_->Run(std::bind(std::move(cb), std::move(status)));
+  Unref();
+}
+
+void IoUringEndpointImpl::OnCancel(int /*res*/, uint32_t /*flags*/) {
+  // The receive reports the outcome of the cancellation itself.
+  Unref();
+}
+
+class IoUringEndpoint final : public EventEngine::Endpoint {
+ public:
+  explicit IoUringEndpoint(IoUringEndpointImpl* impl) : impl_(impl) {}
+  ~IoUringEndpoint() override { impl_->Shutdown(); }
+
+  void Read(std::function<void(absl::Status)> on_read,
+            SliceBuffer* buffer) override {
+    impl_->Read(std::move(on_read), buffer);
+  }
+  void Write(std::function<void(absl::Status)> on_writable,
+             SliceBuffer* data) override {
+    impl_->Write(std::move(on_writable), data);
+  }
+  const EventEngine::ResolvedAddress& GetPeerAddress() const override {
+    return impl_->GetPeerAddress();
+  }
+  const EventEngine::ResolvedAddress& GetLocalAddress() const override {
+    return impl_->GetLocalAddress();
+  }
+
+ private:
+  IoUringEndpointImpl* impl_;
+};
+
+}  // namespace
+
+std::unique_ptr<EventEngine::Endpoint> CreateIoUringEndpoint(
+    int fd, IoUringPoller* poller, MemoryAllocator&& allocator) {
+  GPR_ASSERT(poller != nullptr);
+  return absl::make_unique<IoUringEndpoint>(
+      new IoUringEndpointImpl(fd, poller, std::move(allocator)));
+}
+
+}  // namespace posix_engine
+}  // namespace grpc_event_engine
+
+#else  // GRPC_LINUX_IO_URING
+
+#include <grpc/support/log.h>
+
+namespace grpc_event_engine {
+namespace posix_engine {
+
+std::unique_ptr<experimental::EventEngine::Endpoint> CreateIoUringEndpoint(
+    int /*fd*/, IoUringPoller* /*poller*/,
+    experimental::MemoryAllocator&& /*allocator*/) {
+  gpr_log(GPR_ERROR, "io_uring endpoints are not supported on this platform");
+  abort();
+}
+
+}  // namespace posix_engine
+}  // namespace grpc_event_engine
+
+#endif  // GRPC_LINUX_IO_URING
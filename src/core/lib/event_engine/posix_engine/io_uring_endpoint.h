@@ -0,0 +1,43 @@
+// Copyright 2022 The gRPC Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GRPC_CORE_LIB_EVENT_ENGINE_POSIX_ENGINE_IO_URING_ENDPOINT_H
+#define GRPC_CORE_LIB_EVENT_ENGINE_POSIX_ENGINE_IO_URING_ENDPOINT_H
+
+#include <grpc/support/port_platform.h>
+
+#include <memory>
+
+#include <grpc/event_engine/event_engine.h>
+#include <grpc/event_engine/memory_allocator.h>
+
+#include "src/core/lib/event_engine/posix_engine/io_uring_poller.h"
+
+namespace grpc_event_engine {
+namespace posix_engine {
+
+/// Creates an Endpoint for the connected socket \a fd whose reads and writes
+/// are io_uring operations on \a poller. A single multishot receive stays
+/// armed for the lifetime of the connection and fills buffers provided by
+/// the poller, which Read hands out without copying. The endpoint takes
+/// ownership of \a fd and closes it once the endpoint is destroyed and all of
+/// its operations have completed. Read and write callbacks run on the
+/// poller's scheduler, never inline.
+std::unique_ptr<experimental::EventEngine::Endpoint> CreateIoUringEndpoint(
+    int fd, IoUringPoller* poller, experimental::MemoryAllocator&& allocator);
+
+}  // namespace posix_engine
+}  // namespace grpc_event_engine
+
+#endif  // GRPC_CORE_LIB_EVENT_ENGINE_POSIX_ENGINE_IO_URING_ENDPOINT_H
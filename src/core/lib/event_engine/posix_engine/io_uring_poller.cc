@@ -0,0 +1,526 @@
+// Copyright 2022 The gRPC Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <grpc/support/port_platform.h>
+
+#include "src/core/lib/event_engine/posix_engine/io_uring_poller.h"
+
+#include <stdlib.h>
+
+#include <utility>
+
+#include <grpc/support/log.h>
+
+#ifdef GRPC_LINUX_IO_URING
+
+#include <errno.h>
+#include <string.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/utsname.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/memory/memory.h"
+
+#include "src/core/lib/gprpp/sync.h"
+#include "src/core/lib/gprpp/thd.h"
+#include "src/core/lib/slice/slice_refcount_base.h"
+
+namespace grpc_event_engine {
+namespace posix_engine {
+
+namespace {
+
+// Submission queue size. Operations queued beyond this wait for the next
+// tick of the ring thread.
+constexpr uint32_t kSubmissionQueueEntries = 256;
+// Completion queue size. Completions beyond this are buffered by the kernel
+// (IORING_FEAT_NODROP) rather than lost.
+constexpr uint32_t kCompletionQueueEntries = 4096;
+// Receive buffers shared by all connections of a poller. Must be a power of
+// two.
+constexpr uint32_t kBufferCount = 256;
+constexpr size_t kBufferSize = 16 * 1024;
+constexpr uint16_t kBufferGroup = 0;
+// The user_data of the read that wakes up the ring thread. Every other
+// operation carries a Completion pointer, which is never null.
+constexpr uint64_t kWakeupUserData = 0;
+
+int IoUringSetup(uint32_t entries, io_uring_params* params) {
+  return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+}
+
+int IoUringEnter(int ring_fd, uint32_t to_submit, uint32_t min_complete,
+                 uint32_t flags) {
+  return static_cast<int>(syscall(__NR_io_uring_enter, ring_fd, to_submit,
+                                  min_complete, flags, nullptr, 0));
+}
+
+int IoUringRegister(int ring_fd, uint32_t opcode, void* arg,
+                    uint32_t nr_args) {
+  return static_cast<int>(
+      syscall(__NR_io_uring_register, ring_fd, opcode, arg, nr_args));
+}
+
+// Multishot receive appeared in Linux 6.0. An older kernel only reports it
+// as unsupported once a receive fails, so check the version up front.
+bool KernelSupportsMultishotRecv() {
+  struct utsname buffer;
+  if (uname(&buffer) != 0) {
+    gpr_log(GPR_ERROR, "uname: %s", strerror(errno));
+    return false;
+  }
+  return strtol(buffer.release, nullptr, 10) >= 6;
+}
+
+class ProvidedBuffers;
+
+}  // namespace
+
+// The io_uring instance and the thread that submits to and reaps from it.
+class IoUringRing {
+ public:
+  static std::unique_ptr<IoUringRing> Create(Scheduler* scheduler);
+  ~IoUringRing();
+
+  void Submit(const io_uring_sqe& sqe, IoUringPoller::Completion* completion);
+  ProvidedBuffers* buffers() const { return buffers_; }
+
+ private:
+  IoUringRing() = default;
+
+  static void ThreadMain(void* arg);
+  // Moves queued operations into the submission queue and returns how many
+  // entries the kernel has not consumed yet.
+  uint32_t FillSubmissionQueueLocked() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+  // Runs the handlers of all available completions.
+  void ReapCompletions();
+  bool CompletionsAvailable() const {
+    return *cq_head_ != __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+  }
+
+  int ring_fd_ = -1;
+  int wakeup_fd_ = -1;
+  void* ring_memory_ = nullptr;
+  size_t ring_memory_size_ = 0;
+  io_uring_sqe* sqes_ = nullptr;
+  size_t sqes_size_ = 0;
+  uint32_t* sq_head_ = nullptr;
+  uint32_t* sq_tail_ = nullptr;
+  uint32_t* sq_array_ = nullptr;
+  uint32_t sq_mask_ = 0;
+  uint32_t sq_entries_ = 0;
+  uint32_t* cq_head_ = nullptr;
+  uint32_t* cq_tail_ = nullptr;
+  io_uring_cqe* cqes_ = nullptr;
+  uint32_t cq_mask_ = 0;
+  ProvidedBuffers* buffers_ = nullptr;
+
+  // Only touched by the ring thread.
+  uint64_t wakeup_value_ = 0;
+  bool wakeup_armed_ = false;
+  // Operations in the submission queue or in the kernel.
+  size_t in_flight_ = 0;
+
+  grpc_core::Mutex mu_;
+  std::vector<io_uring_sqe> pending_ ABSL_GUARDED_BY(mu_);
+  // Whether the ring thread is (about to be) blocked in io_uring_enter, and
+  // whether it has been woken up since.
+  std::atomic<bool> sleeping_{false};
+  bool kicked_ ABSL_GUARDED_BY(mu_) = false;
+  bool shutdown_ ABSL_GUARDED_BY(mu_) = false;
+  grpc_core::Thread thread_;
+};
+
+namespace {
+
+// The receive buffers of a ring. The kernel picks one of the buffers it was
+// given when data arrives, and Take() hands it out as a slice. Releasing the
+// slice gives the buffer back to the kernel with IORING_OP_PROVIDE_BUFFERS,
+// batched with the other operations of the ring. Outstanding slices keep the
+// memory alive after the ring is gone: the ring holds one ref and every
+// slice another.
+class ProvidedBuffers {
+ public:
+  static ProvidedBuffers* Create(IoUringRing* ring, Scheduler* scheduler) {
+    void* memory = mmap(nullptr, kBufferCount * kBufferSize,
+                        PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE,
+                        -1, 0);
+    if (memory == MAP_FAILED) return nullptr;
+    auto* buffers =
+        new ProvidedBuffers(ring, static_cast<uint8_t*>(memory), scheduler);
+    buffers->Provide(0, kBufferCount);
+    return buffers;
+  }
+
+  void Ref() { refs_.fetch_add(1, std::memory_order_relaxed); }
+  void Unref() {
+    if (refs_.fetch_sub(1, std::memory_order_acq_rel) == 1) delete this;
+  }
+
+  grpc_slice Take(uint16_t id, size_t length) {
+    GPR_DEBUG_ASSERT(id < kBufferCount);
+    GPR_DEBUG_ASSERT(length <= kBufferSize);
+    Ref();
+    grpc_slice slice;
+    slice.refcount = new (&refcounts_[id]) BufferRefcount(this, id);
+    slice.data.refcounted.bytes = memory_ + id * kBufferSize;
+    slice.data.refcounted.length = length;
+    return slice;
+  }
+
+  void NotifyOnAvailable(std::function<void()> cb) {
+    grpc_core::MutexLock lock(&mu_);
+    if (detached_) return;
+    waiters_.push_back(std::move(cb));
+  }
+
+  // The ring is shutting down: released buffers are no longer handed back,
+  // and nobody waits for them any more.
+  void Detach() {
+    std::vector<std::function<void()>> waiters;
+    grpc_core::MutexLock lock(&mu_);
+    detached_ = true;
+    waiters.swap(waiters_);
+  }
+
+ private:
+  // Tracks the slice that owns a buffer. It lives in preallocated storage,
+  // so handing out a buffer never allocates.
+  class BufferRefcount : public grpc_slice_refcount {
+   public:
+    BufferRefcount(ProvidedBuffers* owner, uint16_t id)
+        : grpc_slice_refcount(Destroy), owner_(owner), id_(id) {}
+
+   private:
+    static void Destroy(grpc_slice_refcount* arg) {
+      auto* refcount = static_cast<BufferRefcount*>(arg);
+      ProvidedBuffers* owner = refcount->owner_;
+      uint16_t id = refcount->id_;
+      refcount->~BufferRefcount();
+      owner->Recycle(id);
+      owner->Unref();
+    }
+
+    ProvidedBuffers* owner_;
+    uint16_t id_;
+  };
+
+  class ProvideCompletion final : public IoUringPoller::Completion {
+   public:
+    void OnComplete(int res, uint32_t /*flags*/) override {
+      if (res < 0) {
+        gpr_log(GPR_ERROR, "IORING_OP_PROVIDE_BUFFERS: %s", strerror(-res));
+      }
+    }
+  };
+
+  ProvidedBuffers(IoUringRing* ring, uint8_t* memory, Scheduler* scheduler)
+      : ring_(ring), memory_(memory), scheduler_(scheduler) {}
+
+  ~ProvidedBuffers() { munmap(memory_, kBufferCount * kBufferSize); }
+
+  // Hands \a count buffers starting at \a first_id to the kernel.
+  void Provide(uint16_t first_id, uint32_t count) {
+    io_uring_sqe sqe;
+    memset(&sqe, 0, sizeof(sqe));
+    sqe.opcode = IORING_OP_PROVIDE_BUFFERS;
+    sqe.fd = static_cast<int32_t>(count);
+    sqe.addr = reinterpret_cast<uint64_t>(memory_ + first_id * kBufferSize);
+    sqe.len = kBufferSize;
+    sqe.off = first_id;
+    sqe.buf_group = kBufferGroup;
+    ring_->Submit(sqe, &provide_completion_);
+  }
+
+  void Recycle(uint16_t id) {
+    std::vector<std::function<void()>> waiters;
+    {
+      grpc_core::MutexLock lock(&mu_);
+      if (detached_) return;
+      Provide(id, 1);
+      waiters.swap(waiters_);
+    }
+    // Slices are released from arbitrary contexts, possibly with endpoint
+    // locks held, so the waiters never run inline.
+    for (auto& waiter : waiters) scheduler_->Run(std::move(waiter));
+  }
+
+  std::atomic<size_t> refs_{1};
+  IoUringRing* const ring_;
+  uint8_t* const memory_;
+  Scheduler* const scheduler_;
+  ProvideCompletion provide_completion_;
+  typename std::aligned_storage<sizeof(BufferRefcount),
+                                alignof(BufferRefcount)>::type
+      refcounts_[kBufferCount];
+  grpc_core::Mutex mu_;
+  std::vector<std::function<void()>> waiters_ ABSL_GUARDED_BY(mu_);
+  bool detached_ ABSL_GUARDED_BY(mu_) = false;
+};
+
+}  // namespace
+
+std::unique_ptr<IoUringRing> IoUringRing::Create(Scheduler* scheduler) {
+  if (!KernelSupportsMultishotRecv()) return nullptr;
+  io_uring_params params;
+  memset(&params, 0, sizeof(params));
+  params.flags = IORING_SETUP_CQSIZE;
+  params.cq_entries = kCompletionQueueEntries;
+  int fd = IoUringSetup(kSubmissionQueueEntries, &params);
+  if (fd < 0) {
+    gpr_log(GPR_INFO, "io_uring_setup: %s", strerror(errno));
+    return nullptr;
+  }
+  auto ring = absl::WrapUnique(new IoUringRing());
+  ring->ring_fd_ = fd;
+  const uint32_t kRequiredFeatures = IORING_FEAT_SINGLE_MMAP |
+                                     IORING_FEAT_NODROP |
+                                     IORING_FEAT_SUBMIT_STABLE;
+  if ((params.features & kRequiredFeatures) != kRequiredFeatures) {
+    return nullptr;
+  }
+  // With IORING_FEAT_SINGLE_MMAP both rings share one mapping.
+  ring->ring_memory_size_ =
+      std::max(params.sq_off.array + params.sq_entries * sizeof(uint32_t),
+               params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe));
+  void* ring_memory =
+      mmap(nullptr, ring->ring_memory_size_, PROT_READ | PROT_WRITE,
+           MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+  if (ring_memory == MAP_FAILED) return nullptr;
+  ring->ring_memory_ = ring_memory;
+  ring->sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+  void* sqes = mmap(nullptr, ring->sqes_size_, PROT_READ | PROT_WRITE,
+                    MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+  if (sqes == MAP_FAILED) return nullptr;
+  ring->sqes_ = static_cast<io_uring_sqe*>(sqes);
+  char* base = static_cast<char*>(ring_memory);
+  ring->sq_head_ = reinterpret_cast<uint32_t*>(base + params.sq_off.head);
+  ring->sq_tail_ = reinterpret_cast<uint32_t*>(base + params.sq_off.tail);
+  ring->sq_array_ = reinterpret_cast<uint32_t*>(base + params.sq_off.array);
+  ring->sq_mask_ = *reinterpret_cast<uint32_t*>(base + params.sq_off.ring_mask);
+  ring->sq_entries_ = params.sq_entries;
+  ring->cq_head_ = reinterpret_cast<uint32_t*>(base + params.cq_off.head);
+  ring->cq_tail_ = reinterpret_cast<uint32_t*>(base + params.cq_off.tail);
+  ring->cqes_ = reinterpret_cast<io_uring_cqe*>(base + params.cq_off.cqes);
+  ring->cq_mask_ = *reinterpret_cast<uint32_t*>(base + params.cq_off.ring_mask);
+  ring->wakeup_fd_ = eventfd(0, EFD_CLOEXEC);
+  if (ring->wakeup_fd_ < 0) return nullptr;
+  ring->buffers_ = ProvidedBuffers::Create(ring.get(), scheduler);
+  if (ring->buffers_ == nullptr) return nullptr;
+  ring->thread_ =
+      grpc_core::Thread("event_engine_io_uring", &IoUringRing::ThreadMain,
+                        ring.get());
+  ring->thread_.Start();
+  return ring;
+}
+
+IoUringRing::~IoUringRing() {
+  if (buffers_ != nullptr) {
+    // Buffers released from now on stay with the slices' memory.
+    buffers_->Detach();
+    bool kick;
+    {
+      grpc_core::MutexLock lock(&mu_);
+      shutdown_ = true;
+      kick = sleeping_.load(std::memory_order_relaxed);
+    }
+    if (kick) eventfd_write(wakeup_fd_, 1);
+    thread_.Join();
+  }
+  if (sqes_ != nullptr) munmap(sqes_, sqes_size_);
+  if (ring_memory_ != nullptr) munmap(ring_memory_, ring_memory_size_);
+  if (wakeup_fd_ >= 0) close(wakeup_fd_);
+  close(ring_fd_);
+  // Only now that the kernel no longer writes to the buffers.
+  if (buffers_ != nullptr) buffers_->Unref();
+}
+
+void IoUringRing::Submit(const io_uring_sqe& sqe,
+                         IoUringPoller::Completion* completion) {
+  bool kick = false;
+  {
+    grpc_core::MutexLock lock(&mu_);
+    pending_.push_back(sqe);
+    pending_.back().user_data = reinterpret_cast<uint64_t>(completion);
+    // Operations queued while the ring thread is busy go out with its next
+    // batch. Only wake it up if it is blocked, and only once per batch.
+    if (sleeping_.load(std::memory_order_relaxed) && !kicked_) {
+      kicked_ = true;
+      kick = true;
+    }
+  }
+  if (kick) eventfd_write(wakeup_fd_, 1);
+}
+
+void IoUringRing::ThreadMain(void* arg) {
+  auto* ring = static_cast<IoUringRing*>(arg);
+  while (true) {
+    ring->ReapCompletions();
+    uint32_t to_submit;
+    bool wait;
+    {
+      grpc_core::MutexLock lock(&ring->mu_);
+      if (ring->shutdown_ && ring->in_flight_ == 0 && ring->pending_.empty()) {
+        return;
+      }
+      if (!ring->wakeup_armed_) {
+        io_uring_sqe sqe;
+        memset(&sqe, 0, sizeof(sqe));
+        sqe.opcode = IORING_OP_READ;
+        sqe.fd = ring->wakeup_fd_;
+        sqe.addr = reinterpret_cast<uint64_t>(&ring->wakeup_value_);
+        sqe.len = sizeof(ring->wakeup_value_);
+        sqe.user_data = kWakeupUserData;
+        ring->pending_.insert(ring->pending_.begin(), sqe);
+        ring->wakeup_armed_ = true;
+      }
+      to_submit = ring->FillSubmissionQueueLocked();
+      // Block only if there is nothing left to submit or to reap.
+      wait = ring->pending_.empty() && !ring->CompletionsAvailable();
+      if (wait) {
+        ring->sleeping_.store(true, std::memory_order_relaxed);
+        ring->kicked_ = false;
+      }
+    }
+    if (to_submit > 0 || wait) {
+      int r = IoUringEnter(ring->ring_fd_, to_submit, wait ? 1 : 0,
+                           wait ? IORING_ENTER_GETEVENTS : 0);
+      // EBUSY and EAGAIN mean the kernel is short of completion queue space
+      // or memory: reaping the completions we have fixes both.
+      if (r < 0 && errno != EINTR && errno != EBUSY && errno != EAGAIN) {
+        gpr_log(GPR_ERROR, "io_uring_enter: %s", strerror(errno));
+        abort();
+      }
+    }
+    ring->sleeping_.store(false, std::memory_order_relaxed);
+  }
+}
+
+uint32_t IoUringRing::FillSubmissionQueueLocked() {
+  uint32_t head = __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE);
+  uint32_t tail = *sq_tail_;
+  size_t n = 0;
+  while (n < pending_.size() && tail - head < sq_entries_) {
+    uint32_t index = tail & sq_mask_;
+    sqes_[index] = pending_[n];
+    sq_array_[index] = index;
+    if (pending_[n].user_data != kWakeupUserData) ++in_flight_;
+    ++tail;
+    ++n;
+  }
+  if (n == pending_.size()) {
+    pending_.clear();
+  } else {
+    pending_.erase(pending_.begin(), pending_.begin() + n);
+  }
+  __atomic_store_n(sq_tail_, tail, __ATOMIC_RELEASE);
+  return tail - head;
+}
+
+void IoUringRing::ReapCompletions() {
+  uint32_t head = *cq_head_;
+  uint32_t tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+  while (head != tail) {
+    io_uring_cqe cqe = cqes_[head & cq_mask_];
+    // Hand the entry back before running its handler, which may take a
+    // while.
+    ++head;
+    __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+    if (cqe.user_data == kWakeupUserData) {
+      wakeup_armed_ = false;
+    } else {
+      if ((cqe.flags & IORING_CQE_F_MORE) == 0) --in_flight_;
+      reinterpret_cast<IoUringPoller::Completion*>(cqe.user_data)
+          ->OnComplete(cqe.res, cqe.flags);
+    }
+    if (head == tail) tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+  }
+}
+
+std::unique_ptr<IoUringPoller> IoUringPoller::Create(Scheduler* scheduler) {
+  std::unique_ptr<IoUringRing> ring = IoUringRing::Create(scheduler);
+  if (ring == nullptr) return nullptr;
+  return absl::WrapUnique(new IoUringPoller(scheduler, std::move(ring)));
+}
+
+void IoUringPoller::Submit(const io_uring_sqe& sqe, Completion* completion) {
+  ring_->Submit(sqe, completion);
+}
+
+uint16_t IoUringPoller::buffer_group() const { return kBufferGroup; }
+
+grpc_slice IoUringPoller::TakeBuffer(uint16_t buffer_id, size_t length) {
+  return ring_->buffers()->Take(buffer_id, length);
+}
+
+void IoUringPoller::NotifyOnBufferAvailable(std::function<void()> cb) {
+  ring_->buffers()->NotifyOnAvailable(std::move(cb));
+}
+
+}  // namespace posix_engine
+}  // namespace grpc_event_engine
+
+#else  // GRPC_LINUX_IO_URING
+
+namespace grpc_event_engine {
+namespace posix_engine {
+
+class IoUringRing {};
+
+std::unique_ptr<IoUringPoller> IoUringPoller::Create(
+    Scheduler* /*scheduler*/) {
+  return nullptr;
+}
+
+uint16_t IoUringPoller::buffer_group() const {
+  gpr_log(GPR_ERROR, "io_uring is not supported on this platform");
+  abort();
+}
+
+grpc_slice IoUringPoller::TakeBuffer(uint16_t /*buffer_id*/,
+                                     size_t /*length*/) {
+  gpr_log(GPR_ERROR, "io_uring is not supported on this platform");
+  abort();
+}
+
+void IoUringPoller::NotifyOnBufferAvailable(std::function<void()> /*cb*/) {
+  gpr_log(GPR_ERROR, "io_uring is not supported on this platform");
+  abort();
+}
+
+}  // namespace posix_engine
+}  // namespace grpc_event_engine
+
+#endif  // GRPC_LINUX_IO_URING
+
+namespace grpc_event_engine {
+namespace posix_engine {
+
+IoUringPoller::IoUringPoller(Scheduler* scheduler,
+                             std::unique_ptr<IoUringRing> ring)
+    : scheduler_(scheduler), ring_(std::move(ring)) {}
+
+IoUringPoller::~IoUringPoller() = default;
+
+}  // namespace posix_engine
+}  // namespace grpc_event_engine
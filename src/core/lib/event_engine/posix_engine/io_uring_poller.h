@@ -0,0 +1,107 @@
+// Copyright 2022 The gRPC Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GRPC_CORE_LIB_EVENT_ENGINE_POSIX_ENGINE_IO_URING_POLLER_H
+#define GRPC_CORE_LIB_EVENT_ENGINE_POSIX_ENGINE_IO_URING_POLLER_H
+
+#include <grpc/support/port_platform.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <functional>
+#include <memory>
+
+#include <grpc/slice.h>
+
+#include "src/core/lib/event_engine/posix_engine/event_poller.h"
+#include "src/core/lib/iomgr/port.h"
+
+// The io_uring endpoints need multishot receive. Kernel support is checked at
+// run time, so only the header needs to be recent enough to describe it. The
+// detection lives here rather than in port.h so that only the io_uring
+// sources pull in <linux/io_uring.h>.
+#if defined(GPR_LINUX) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#ifdef IORING_RECV_MULTISHOT
+#define GRPC_LINUX_IO_URING 1
+#endif  // IORING_RECV_MULTISHOT
+#endif  // __has_include(<linux/io_uring.h>)
+#endif  // defined(GPR_LINUX) && defined(__has_include)
+
+namespace grpc_event_engine {
+namespace posix_engine {
+
+class IoUringRing;
+
+/// Drives one io_uring instance that is shared by many endpoints.
+///
+/// Operations are not handed to the kernel when they are submitted. They are
+/// queued, and a dedicated ring thread moves everything that was queued -
+/// across all connections - into the submission queue and submits it with a
+/// single io_uring_enter call, which also waits for the next completions.
+/// Completion handlers run on the ring thread, and typically just queue more
+/// operations or hand a callback to the Scheduler.
+///
+/// Receives use a pool of provided buffers: the kernel picks a buffer when
+/// data arrives, and TakeBuffer() turns it into a slice without copying.
+class IoUringPoller {
+ public:
+  /// The target of an operation. OnComplete runs on the ring thread once for
+  /// every completion of the operation; multishot operations set
+  /// IORING_CQE_F_MORE in \a flags on all but their last completion.
+  class Completion {
+   public:
+    virtual void OnComplete(int res, uint32_t flags) = 0;
+
+   protected:
+    ~Completion() = default;
+  };
+
+  /// Returns nullptr if io_uring is disabled at compile time, or if the
+  /// running kernel lacks the features this poller needs (multishot receive
+  /// into provided buffers, Linux 6.0). Callers fall back to epoll.
+  static std::unique_ptr<IoUringPoller> Create(Scheduler* scheduler);
+
+  /// All operations must have completed: every endpoint using this poller
+  /// must be destroyed first. Waits for the ring thread to exit.
+  ~IoUringPoller();
+
+#ifdef GRPC_LINUX_IO_URING
+  /// Queues \a sqe for the next batch. Its user_data is overwritten.
+  void Submit(const io_uring_sqe& sqe, Completion* completion);
+#endif
+  /// The buffer group to select receive buffers from.
+  uint16_t buffer_group() const;
+  /// Wraps the provided buffer \a buffer_id, which holds \a length received
+  /// bytes, in a slice. The buffer goes back to the kernel once the slice is
+  /// released, which may be after the poller is gone.
+  grpc_slice TakeBuffer(uint16_t buffer_id, size_t length);
+  /// Runs \a cb once a provided buffer has been released. Receives fail with
+  /// ENOBUFS when the kernel runs out of buffers and are re-armed from here.
+  void NotifyOnBufferAvailable(std::function<void()> cb);
+  Scheduler* scheduler() const { return scheduler_; }
+
+ private:
+  IoUringPoller(Scheduler* scheduler, std::unique_ptr<IoUringRing> ring);
+
+  Scheduler* const scheduler_;
+  const std::unique_ptr<IoUringRing> ring_;
+};
+
+}  // namespace posix_engine
+}  // namespace grpc_event_engine
+
+#endif  // GRPC_CORE_LIB_EVENT_ENGINE_POSIX_ENGINE_IO_URING_POLLER_H
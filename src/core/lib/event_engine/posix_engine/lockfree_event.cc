@@ -0,0 +1,169 @@
+// Copyright 2022 The gRPC Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <grpc/support/port_platform.h>
+
+#include "src/core/lib/event_engine/posix_engine/lockfree_event.h"
+
+#include <utility>
+
+#include <grpc/support/log.h>
+
+// The state machine is identical to the one documented in
+// src/core/lib/iomgr/lockfree_event.cc. 'state_' holds one of:
+//   kClosureNotReady: no readiness has been observed, and nobody is waiting.
+//   kClosureReady:    readiness was observed but nobody is waiting yet.
+//   closure pointer:  a closure is waiting for readiness.
+//   status pointer | kShutdownBit: the event was shut down with that status.
+//     A bare kShutdownBit marks an event that was destroyed.
+
+namespace grpc_event_engine {
+namespace posix_engine {
+
+constexpr intptr_t LockfreeEvent::kShutdownBit;
+
+void LockfreeEvent::InitEvent() {
+  // The event may be reused from a free list while a stale poller
+  // notification is in flight, so the reset has to be atomic.
+  state_.store(kClosureNotReady, std::memory_order_relaxed);
+}
+
+void LockfreeEvent::DestroyEvent() {
+  intptr_t curr;
+  do {
+    curr = state_.load(std::memory_order_relaxed);
+    if (curr & kShutdownBit) {
+      delete reinterpret_cast<absl::Status*>(curr & ~kShutdownBit);
+    } else {
+      GPR_ASSERT(curr == kClosureNotReady || curr == kClosureReady);
+    }
+    // CAS in a shutdown without a status, so that any interaction with the
+    // destroyed event cannot reference a freed status.
+  } while (!state_.compare_exchange_strong(curr, kShutdownBit,
+                                           std::memory_order_relaxed,
+                                           std::memory_order_relaxed));
+}
+
+absl::Status LockfreeEvent::ShutdownStatus(intptr_t state) {
+  auto* status = reinterpret_cast<absl::Status*>(state & ~kShutdownBit);
+  if (status == nullptr) return absl::CancelledError("Event destroyed");
+  return *status;
+}
+
+void LockfreeEvent::NotifyOn(PosixEngineClosure* closure) {
+  // Acquire: a shutdown status published by SetShutdown() may be referenced.
+  intptr_t curr = state_.load(std::memory_order_acquire);
+  while (true) {
+    switch (curr) {
+      case kClosureNotReady:
+        // kClosureNotReady -> <closure>. Release pairs with the acquire in
+        // SetReady().
+        if (state_.compare_exchange_strong(
+                curr, reinterpret_cast<intptr_t>(closure),
+                std::memory_order_acq_rel, std::memory_order_acquire)) {
+          return;
+        }
+        break;
+      case kClosureReady:
+        // kClosureReady -> kClosureNotReady: the event already happened, so
+        // the closure can run right away.
+        if (state_.compare_exchange_strong(curr, kClosureNotReady,
+                                           std::memory_order_acq_rel,
+                                           std::memory_order_acquire)) {
+          scheduler_->Run(closure);
+          return;
+        }
+        break;
+      default:
+        if ((curr & kShutdownBit) != 0) {
+          closure->SetStatus(ShutdownStatus(curr));
+          scheduler_->Run(closure);
+          return;
+        }
+        // There is already a closure waiting: this is an API misuse.
+        gpr_log(GPR_ERROR,
+                "LockfreeEvent::NotifyOn: notify_on called with a previous "
+                "callback still pending");
+        abort();
+    }
+  }
+}
+
+bool LockfreeEvent::SetShutdown(absl::Status shutdown_status) {
+  auto* status = new absl::Status(std::move(shutdown_status));
+  intptr_t new_state = reinterpret_cast<intptr_t>(status) | kShutdownBit;
+  intptr_t curr = state_.load(std::memory_order_acquire);
+  while (true) {
+    switch (curr) {
+      case kClosureReady:
+      case kClosureNotReady:
+        // Release pairs with the acquire in NotifyOn(), publishing *status.
+        if (state_.compare_exchange_strong(curr, new_state,
+                                           std::memory_order_acq_rel,
+                                           std::memory_order_acquire)) {
+          return true;
+        }
+        break;
+      default:
+        if ((curr & kShutdownBit) != 0) {
+          // Already shut down.
+          delete status;
+          return false;
+        }
+        // A closure is waiting: swap in the shutdown state and fail it.
+        if (state_.compare_exchange_strong(curr, new_state,
+                                           std::memory_order_acq_rel,
+                                           std::memory_order_acquire)) {
+          auto* closure = reinterpret_cast<PosixEngineClosure*>(curr);
+          closure->SetStatus(*status);
+          scheduler_->Run(closure);
+          return true;
+        }
+        break;
+    }
+  }
+}
+
+void LockfreeEvent::SetReady() {
+  intptr_t curr = state_.load(std::memory_order_acquire);
+  while (true) {
+    switch (curr) {
+      case kClosureReady:
+        // Already ready; nothing to do.
+        return;
+      case kClosureNotReady:
+        if (state_.compare_exchange_strong(curr, kClosureReady,
+                                           std::memory_order_acq_rel,
+                                           std::memory_order_acquire)) {
+          return;
+        }
+        break;
+      default:
+        if ((curr & kShutdownBit) != 0) return;
+        // <closure> -> kClosureNotReady, then run the closure. A concurrent
+        // SetShutdown() may win the race, in which case it runs the closure.
+        if (state_.compare_exchange_strong(curr, kClosureNotReady,
+                                           std::memory_order_acq_rel,
+                                           std::memory_order_acquire)) {
+          auto* closure = reinterpret_cast<PosixEngineClosure*>(curr);
+          closure->SetStatus(absl::OkStatus());
+          scheduler_->Run(closure);
+          return;
+        }
+        break;
+    }
+  }
+}
+
+}  // namespace posix_engine
+}  // namespace grpc_event_engine
@@ -0,0 +1,77 @@
+// Copyright 2022 The gRPC Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#ifndef GRPC_CORE_LIB_EVENT_ENGINE_POSIX_ENGINE_LOCKFREE_EVENT_H
+#define GRPC_CORE_LIB_EVENT_ENGINE_POSIX_ENGINE_LOCKFREE_EVENT_H
+
+#include <grpc/support/port_platform.h>
+
+#include <stdint.h>
+
+#include <atomic>
+
+#include "absl/status/status.h"
+
+#include "src/core/lib/event_engine/posix_engine/event_poller.h"
+#include "src/core/lib/event_engine/posix_engine/posix_engine_closure.h"
+
+namespace grpc_event_engine {
+namespace posix_engine {
+
+/// The EventEngine counterpart of iomgr's LockfreeEvent: a lock-free state
+/// machine matching "fd is ready" notifications from the poller with closures
+/// waiting for that readiness.
+class LockfreeEvent {
+ public:
+  explicit LockfreeEvent(Scheduler* scheduler) : scheduler_(scheduler) {}
+
+  LockfreeEvent(const LockfreeEvent&) = delete;
+  LockfreeEvent& operator=(const LockfreeEvent&) = delete;
+
+  // These methods are used to initialize and destroy the internal state. They
+  // cannot be invoked from constructor/destructor because the handle holding
+  // the event may be recycled through a free list.
+  void InitEvent();
+  void DestroyEvent();
+
+  // Returns true if SetShutdown() was successfully called.
+  bool IsShutdown() const {
+    return (state_.load(std::memory_order_relaxed) & kShutdownBit) != 0;
+  }
+
+  // Schedules \a closure when the event is received (see SetReady()) or the
+  // shutdown state has been set. The closure is always run asynchronously.
+  void NotifyOn(PosixEngineClosure* closure);
+
+  // Sets the shutdown state and schedules any pending closure with
+  // \a shutdown_status. Returns true if this was the first shutdown.
+  bool SetShutdown(absl::Status shutdown_status);
+
+  // Signals that the event has occurred: schedules the pending closure if one
+  // exists, otherwise remembers the readiness for the next NotifyOn().
+  void SetReady();
+
+ private:
+  enum State : intptr_t { kClosureNotReady = 0, kClosureReady = 2 };
+  static constexpr intptr_t kShutdownBit = 1;
+
+  static absl::Status ShutdownStatus(intptr_t state);
+
+  std::atomic<intptr_t> state_{kClosureNotReady};
+  Scheduler* scheduler_;
+};
+
+}  // namespace posix_engine
+}  // namespace grpc_event_engine
+
+#endif  // GRPC_CORE_LIB_EVENT_ENGINE_POSIX_ENGINE_LOCKFREE_EVENT_H
@@ -0,0 +1,1036 @@
+// Copyright 2022 The gRPC Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <grpc/support/port_platform.h>
+
+#include "src/core/lib/event_engine/posix_engine/posix_endpoint.h"
+
+#include "src/core/lib/iomgr/port.h"
+
+#ifdef GRPC_POSIX_SOCKET_TCP
+
+#include <errno.h>
+#include <limits.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "absl/memory/memory.h"
+#include "absl/status/status.h"
+
+#include <grpc/slice.h>
+#include <grpc/slice_buffer.h>
+#include <grpc/support/log.h>
+
+#include "src/core/lib/event_engine/posix_engine/posix_engine_closure.h"
+#include "src/core/lib/gpr/useful.h"
+#include "src/core/lib/gprpp/ref_counted.h"
+#include "src/core/lib/gprpp/sync.h"
+#include "src/core/lib/slice/slice_internal.h"
+
+#ifdef GRPC_LINUX_ERRQUEUE
+#include <linux/errqueue.h>
+#endif
+
+#ifndef SOL_TCP
+#define SOL_TCP IPPROTO_TCP
+#endif
+
+#ifndef TCP_INQ
+#define TCP_INQ 36
+#define TCP_CM_INQ TCP_INQ
+#endif
+
+#ifdef GRPC_HAVE_MSG_NOSIGNAL
+#define SENDMSG_FLAGS MSG_NOSIGNAL
+#else
+#define SENDMSG_FLAGS 0
+#endif
+
+// Fallbacks for older library headers. These constants are part of the kernel
+// ABI, so defining them here is safe.
+#ifndef MSG_ZEROCOPY
+#define MSG_ZEROCOPY 0x4000000
+#endif
+#ifndef SO_ZEROCOPY
+#define SO_ZEROCOPY 60
+#endif
+#ifndef SO_EE_ORIGIN_ZEROCOPY
+#define SO_EE_ORIGIN_ZEROCOPY 5
+#endif
+
+#if defined(IOV_MAX) && IOV_MAX < 260
+#define MAX_WRITE_IOVEC IOV_MAX
+#else
+#define MAX_WRITE_IOVEC 260
+#endif
+
+#define MAX_READ_IOVEC 4
+
+#ifdef GRPC_MSG_IOVLEN_TYPE
+typedef GRPC_MSG_IOVLEN_TYPE msg_iovlen_type;
+#else
+typedef size_t msg_iovlen_type;
+#endif
+
+namespace grpc_event_engine {
+namespace posix_engine {
+
+namespace {
+
+using ::grpc_event_engine::experimental::EventEngine;
+using ::grpc_event_engine::experimental::MemoryAllocator;
+using ::grpc_event_engine::experimental::MemoryRequest;
+using ::grpc_event_engine::experimental::SliceBuffer;
+
+// A wrapper around sendmsg. It sends \a msg over \a fd and returns the number
+// of bytes sent.
+ssize_t TcpSend(int fd, const msghdr* msg, int additional_flags = 0) {
+  ssize_t sent_length;
+  do {
+    sent_length = sendmsg(fd, msg, SENDMSG_FLAGS | additional_flags);
+  } while (sent_length < 0 && errno == EINTR);
+  return sent_length;
+}
+
+// The slices of a write that is being sent with MSG_ZEROCOPY. The kernel
+// references the slice memory until it reports the send as complete on the
+// socket error queue, so the record owns the slices until then. It holds one
+// ref per sendmsg call in flight plus one for the write itself.
+class TcpZerocopySendRecord {
+ public:
+  TcpZerocopySendRecord() { grpc_slice_buffer_init(&buf_); }
+
+  ~TcpZerocopySendRecord() {
+    AssertEmpty();
+    grpc_slice_buffer_destroy_internal(&buf_);
+  }
+
+  // Fills \a iov with the unsent part of the record, and saves the current
+  // offset in \a unwind_slice_idx and \a unwind_byte_idx.
+  msg_iovlen_type PopulateIovs(size_t* unwind_slice_idx,
+                               size_t* unwind_byte_idx, size_t* sending_length,
+                               iovec* iov) {
+    msg_iovlen_type iov_size;
+    *unwind_slice_idx = out_offset_.slice_idx;
+    *unwind_byte_idx = out_offset_.byte_idx;
+    for (iov_size = 0;
+         out_offset_.slice_idx != buf_.count && iov_size != MAX_WRITE_IOVEC;
+         iov_size++) {
+      iov[iov_size].iov_base =
+          GRPC_SLICE_START_PTR(buf_.slices[out_offset_.slice_idx]) +
+          out_offset_.byte_idx;
+      iov[iov_size].iov_len =
+          GRPC_SLICE_LENGTH(buf_.slices[out_offset_.slice_idx]) -
+          out_offset_.byte_idx;
+      *sending_length += iov[iov_size].iov_len;
+      ++(out_offset_.slice_idx);
+      out_offset_.byte_idx = 0;
+    }
+    GPR_DEBUG_ASSERT(iov_size > 0);
+    return iov_size;
+  }
+
+  // Restores the offset saved by PopulateIovs() if sendmsg was throttled.
+  void UnwindIfThrottled(size_t unwind_slice_idx, size_t unwind_byte_idx) {
+    out_offset_.byte_idx = unwind_byte_idx;
+    out_offset_.slice_idx = unwind_slice_idx;
+  }
+
+  // Moves the offset back over the bytes that sendmsg did not accept.
+  void UpdateOffsetForBytesSent(size_t sending_length, size_t actually_sent) {
+    size_t trailing = sending_length - actually_sent;
+    while (trailing > 0) {
+      out_offset_.slice_idx--;
+      size_t slice_length =
+          GRPC_SLICE_LENGTH(buf_.slices[out_offset_.slice_idx]);
+      if (slice_length > trailing) {
+        out_offset_.byte_idx = slice_length - trailing;
+        break;
+      }
+      trailing -= slice_length;
+    }
+  }
+
+  bool AllSlicesSent() { return out_offset_.slice_idx == buf_.count; }
+
+  // Takes over the slices of \a slices_to_send.
+  void PrepareForSends(grpc_slice_buffer* slices_to_send) {
+    AssertEmpty();
+    out_offset_.slice_idx = 0;
+    out_offset_.byte_idx = 0;
+    grpc_slice_buffer_swap(slices_to_send, &buf_);
+    Ref();
+  }
+
+  void Ref() { ref_.fetch_add(1, std::memory_order_relaxed); }
+
+  // Returns true (and releases the slices) when the last ref is dropped.
+  bool Unref() {
+    const intptr_t prior = ref_.fetch_sub(1, std::memory_order_acq_rel);
+    GPR_DEBUG_ASSERT(prior > 0);
+    if (prior == 1) {
+      grpc_slice_buffer_reset_and_unref_internal(&buf_);
+      return true;
+    }
+    return false;
+  }
+
+ private:
+  struct OutgoingOffset {
+    size_t slice_idx = 0;
+    size_t byte_idx = 0;
+  };
+
+  void AssertEmpty() {
+    GPR_DEBUG_ASSERT(buf_.count == 0);
+    GPR_DEBUG_ASSERT(buf_.length == 0);
+    GPR_DEBUG_ASSERT(ref_.load(std::memory_order_relaxed) == 0);
+  }
+
+  grpc_slice_buffer buf_;
+  std::atomic<intptr_t> ref_{0};
+  OutgoingOffset out_offset_;
+};
+
+// The zerocopy state of one endpoint: a fixed pool of send records, and the
+// mapping from kernel send sequence numbers to the records they belong to.
+class TcpZerocopySendCtx {
+ public:
+  TcpZerocopySendCtx(int max_sends, size_t send_bytes_threshold)
+      : max_sends_(std::max(max_sends, 0)),
+        send_records_(new TcpZerocopySendRecord[max_sends_]),
+        threshold_bytes_(send_bytes_threshold) {
+    free_send_records_.reserve(max_sends_);
+    for (int idx = 0; idx < max_sends_; ++idx) {
+      free_send_records_.push_back(&send_records_[idx]);
+    }
+  }
+
+  // Notes a sendmsg call for \a record: the kernel numbers each MSG_ZEROCOPY
+  // send sequentially, starting from zero.
+  void NoteSend(TcpZerocopySendRecord* record) {
+    record->Ref();
+    grpc_core::MutexLock lock(&mu_);
+    ctx_lookup_.emplace(last_send_, record);
+    ++last_send_;
+  }
+
+  // Undoes the last NoteSend() if sendmsg failed.
+  void UndoSend() {
+    TcpZerocopySendRecord* record;
+    {
+      grpc_core::MutexLock lock(&mu_);
+      --last_send_;
+      record = ReleaseSendRecordLocked(last_send_);
+    }
+    if (record->Unref()) {
+      // The write itself still holds a ref.
+      GPR_DEBUG_ASSERT(0);
+    }
+  }
+
+  TcpZerocopySendRecord* GetSendRecord() {
+    grpc_core::MutexLock lock(&mu_);
+    if (shutdown_ || free_send_records_.empty()) return nullptr;
+    TcpZerocopySendRecord* record = free_send_records_.back();
+    free_send_records_.pop_back();
+    return record;
+  }
+
+  TcpZerocopySendRecord* ReleaseSendRecord(uint32_t seq) {
+    grpc_core::MutexLock lock(&mu_);
+    return ReleaseSendRecordLocked(seq);
+  }
+
+  void PutSendRecord(TcpZerocopySendRecord* record) {
+    GPR_DEBUG_ASSERT(record >= send_records_.get() &&
+                     record < send_records_.get() + max_sends_);
+    grpc_core::MutexLock lock(&mu_);
+    free_send_records_.push_back(record);
+  }
+
+  void Shutdown() {
+    grpc_core::MutexLock lock(&mu_);
+    shutdown_ = true;
+  }
+
+  bool AllSendRecordsEmpty() {
+    grpc_core::MutexLock lock(&mu_);
+    return free_send_records_.size() == static_cast<size_t>(max_sends_);
+  }
+
+  bool enabled() const { return enabled_; }
+  void set_enabled(bool enabled) { enabled_ = enabled; }
+  size_t threshold_bytes() const { return threshold_bytes_; }
+
+ private:
+  TcpZerocopySendRecord* ReleaseSendRecordLocked(uint32_t seq)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    auto iter = ctx_lookup_.find(seq);
+    GPR_DEBUG_ASSERT(iter != ctx_lookup_.end());
+    TcpZerocopySendRecord* record = iter->second;
+    ctx_lookup_.erase(iter);
+    return record;
+  }
+
+  const int max_sends_;
+  std::unique_ptr<TcpZerocopySendRecord[]> send_records_;
+  const size_t threshold_bytes_;
+  bool enabled_ = false;
+  grpc_core::Mutex mu_;
+  std::vector<TcpZerocopySendRecord*> free_send_records_ ABSL_GUARDED_BY(mu_);
+  std::unordered_map<uint32_t, TcpZerocopySendRecord*> ctx_lookup_
+      ABSL_GUARDED_BY(mu_);
+  uint32_t last_send_ ABSL_GUARDED_BY(mu_) = 0;
+  bool shutdown_ ABSL_GUARDED_BY(mu_) = false;
+};
+
+// The state of one TCP connection. The Endpoint owns one ref; every pending
+// read, write and error notification holds another, so the socket stays open
+// until the last callback has run.
+class PosixEndpointImpl : public grpc_core::RefCounted<PosixEndpointImpl> {
+ public:
+  PosixEndpointImpl(EventHandle* handle, Scheduler* scheduler,
+                    MemoryAllocator&& allocator,
+                    const PosixTcpOptions& options);
+  ~PosixEndpointImpl() override;
+
+  void Read(std::function<void(absl::Status)> on_read, SliceBuffer* buffer);
+  void Write(std::function<void(absl::Status)> on_writable, SliceBuffer* data);
+  const EventEngine::ResolvedAddress& GetPeerAddress() const {
+    return peer_address_;
+  }
+  const EventEngine::ResolvedAddress& GetLocalAddress() const {
+    return local_address_;
+  }
+
+  // Fails all pending operations with \a why and drops the Endpoint's ref.
+  void MaybeShutdown(absl::Status why);
+
+ private:
+  void HandleRead(absl::Status status);
+  // Returns true if data was read or an error other than EAGAIN occurred.
+  bool TcpDoRead(absl::Status* status) ABSL_EXCLUSIVE_LOCKS_REQUIRED(read_mu_);
+  void MaybeMakeReadSlices() ABSL_EXCLUSIVE_LOCKS_REQUIRED(read_mu_);
+  void FinishEstimate();
+
+  void HandleWrite(absl::Status status);
+  // The flush functions return true if done, false if the socket is not
+  // writable. If returning true, *status is set.
+  bool TcpFlush(absl::Status* status);
+  bool TcpFlushZerocopy(TcpZerocopySendRecord* record, absl::Status* status);
+  bool DoTcpFlushZerocopy(TcpZerocopySendRecord* record, absl::Status* status);
+  TcpZerocopySendRecord* TcpGetSendZerocopyRecord(grpc_slice_buffer* buf);
+  void UnrefMaybePutZerocopySendRecord(TcpZerocopySendRecord* record);
+
+  void HandleError(absl::Status status);
+  // Drains the socket error queue. Returns true if any zerocopy completion
+  // was processed.
+  bool ProcessErrors();
+  void ZerocopyDisableAndWaitForRemaining();
+
+  grpc_core::Mutex read_mu_;
+  EventHandle* handle_;
+  Scheduler* scheduler_;
+  int fd_;
+  MemoryAllocator memory_allocator_;
+  EventEngine::ResolvedAddress peer_address_;
+  EventEngine::ResolvedAddress local_address_;
+
+  std::function<void(absl::Status)> read_cb_ ABSL_GUARDED_BY(read_mu_);
+  grpc_slice_buffer* incoming_buffer_ ABSL_GUARDED_BY(read_mu_) = nullptr;
+  // Bytes of the previous read's slices that were not filled, reused by the
+  // next read.
+  grpc_slice_buffer last_read_buffer_;
+  double target_length_;
+  double bytes_read_this_round_ = 0;
+  int min_read_chunk_size_;
+  int max_read_chunk_size_;
+  // Bytes the kernel reported as still queued after the last read. Without
+  // TCP_INQ support this stays at 1, meaning "maybe".
+  int inq_ ABSL_GUARDED_BY(read_mu_) = 1;
+  bool inq_capable_ = false;
+  bool is_first_read_ ABSL_GUARDED_BY(read_mu_) = true;
+
+  // There is at most one write outstanding, so the write state needs no lock.
+  std::function<void(absl::Status)> write_cb_;
+  grpc_slice_buffer* outgoing_buffer_ = nullptr;
+  // Byte within outgoing_buffer_->slices[0] to write next.
+  size_t outgoing_byte_idx_ = 0;
+  TcpZerocopySendRecord* current_zerocopy_send_ = nullptr;
+  TcpZerocopySendCtx tcp_zerocopy_send_ctx_;
+
+  const bool track_err_;
+  std::atomic<bool> stop_error_notification_{false};
+
+  PosixEngineClosure* on_read_;
+  PosixEngineClosure* on_write_;
+  PosixEngineClosure* on_error_;
+};
+
+PosixEndpointImpl::PosixEndpointImpl(EventHandle* handle, Scheduler* scheduler,
+                                     MemoryAllocator&& allocator,
+                                     const PosixTcpOptions& options)
+    : handle_(handle),
+      scheduler_(scheduler),
+      fd_(handle->WrappedFd()),
+      memory_allocator_(std::move(allocator)),
+      target_length_(static_cast<double>(options.tcp_read_chunk_size)),
+      min_read_chunk_size_(options.tcp_min_read_chunk_size),
+      max_read_chunk_size_(options.tcp_max_read_chunk_size),
+      tcp_zerocopy_send_ctx_(options.tcp_tx_zerocopy_max_simultaneous_sends,
+                             options.tcp_tx_zerocopy_send_bytes_threshold),
+      track_err_(PosixEndpointTracksErrors(options)) {
+  grpc_slice_buffer_init(&last_read_buffer_);
+  auto local_address = LocalAddress(fd_);
+  if (local_address.ok()) local_address_ = *local_address;
+  auto peer_address = PeerAddress(fd_);
+  if (peer_address.ok()) peer_address_ = *peer_address;
+  on_read_ = PosixEngineClosure::ToPermanentClosure(
+      [this](absl::Status status) { HandleRead(std::move(status)); });
+  on_write_ = PosixEngineClosure::ToPermanentClosure(
+      [this](absl::Status status) { HandleWrite(std::move(status)); });
+  on_error_ = PosixEngineClosure::ToPermanentClosure(
+      [this](absl::Status status) { HandleError(std::move(status)); });
+#ifdef GRPC_LINUX_ERRQUEUE
+  if (options.tcp_tx_zero_copy_enabled) {
+    const int enable = 1;
+    if (setsockopt(fd_, SOL_SOCKET, SO_ZEROCOPY, &enable, sizeof(enable)) ==
+        0) {
+      tcp_zerocopy_send_ctx_.set_enabled(true);
+    } else {
+      gpr_log(GPR_ERROR, "Failed to set zerocopy options on the socket.");
+    }
+  }
+#endif
+#ifdef GRPC_HAVE_TCP_INQ
+  int one = 1;
+  if (setsockopt(fd_, SOL_TCP, TCP_INQ, &one, sizeof(one)) == 0) {
+    inq_capable_ = true;
+  } else {
+    gpr_log(GPR_DEBUG, "cannot set inq fd=%d errno=%d", fd_, errno);
+  }
+#endif
+  if (track_err_) {
+    // Released when error notifications are no longer wanted.
+    Ref().release();
+    handle_->NotifyOnError(on_error_);
+  }
+}
+
+PosixEndpointImpl::~PosixEndpointImpl() {
+  // The kernel may still reference the memory of zerocopy sends: wait for
+  // their completions before the slices are released and the fd is closed.
+  ZerocopyDisableAndWaitForRemaining();
+  handle_->OrphanHandle(nullptr, nullptr, "endpoint destroyed");
+  grpc_slice_buffer_destroy_internal(&last_read_buffer_);
+  delete on_read_;
+  delete on_write_;
+  delete on_error_;
+}
+
+void PosixEndpointImpl::MaybeShutdown(absl::Status why) {
+  stop_error_notification_.store(true, std::memory_order_release);
+  handle_->ShutdownHandle(std::move(why));
+  Unref();
+}
+
+void PosixEndpointImpl::FinishEstimate() {
+  // If we read >80% of the target buffer in one read loop, increase the size
+  // of the target buffer to either the amount read, or twice its previous
+  // value.
+  if (bytes_read_this_round_ > target_length_ * 0.8) {
+    target_length_ = std::max(2 * target_length_, bytes_read_this_round_);
+  } else {
+    target_length_ = 0.99 * target_length_ + 0.01 * bytes_read_this_round_;
+  }
+  bytes_read_this_round_ = 0;
+}
+
+void PosixEndpointImpl::MaybeMakeReadSlices() {
+  if (incoming_buffer_->length == 0 &&
+      incoming_buffer_->count < MAX_READ_IOVEC) {
+    int target_length = static_cast<int>(target_length_);
+    int extra_wanted =
+        target_length - static_cast<int>(incoming_buffer_->length);
+    grpc_slice_buffer_add_indexed(
+        incoming_buffer_,
+        memory_allocator_.MakeSlice(MemoryRequest(
+            min_read_chunk_size_,
+            grpc_core::Clamp(extra_wanted, min_read_chunk_size_,
+                             max_read_chunk_size_))));
+  }
+}
+
+bool PosixEndpointImpl::TcpDoRead(absl::Status* status) {
+  msghdr msg;
+  iovec iov[MAX_READ_IOVEC];
+  ssize_t read_bytes;
+  size_t total_read_bytes = 0;
+  size_t iov_len =
+      std::min<size_t>(MAX_READ_IOVEC, incoming_buffer_->count);
+  union {
+    char buf[CMSG_SPACE(sizeof(int))];
+    cmsghdr align;
+  } cmsgbuf;
+  for (size_t i = 0; i < iov_len; i++) {
+    iov[i].iov_base = GRPC_SLICE_START_PTR(incoming_buffer_->slices[i]);
+    iov[i].iov_len = GRPC_SLICE_LENGTH(incoming_buffer_->slices[i]);
+  }
+
+  GPR_ASSERT(incoming_buffer_->length != 0);
+
+  do {
+    // Assume there is something on the queue. If we receive TCP_INQ from the
+    // kernel, we will update this value, otherwise, we have to assume there
+    // is always something to read until we get EAGAIN.
+    inq_ = 1;
+
+    msg.msg_name = nullptr;
+    msg.msg_namelen = 0;
+    msg.msg_iov = iov;
+    msg.msg_iovlen = static_cast<msg_iovlen_type>(iov_len);
+    if (inq_capable_) {
+      msg.msg_control = cmsgbuf.buf;
+      msg.msg_controllen = sizeof(cmsgbuf.buf);
+    } else {
+      msg.msg_control = nullptr;
+      msg.msg_controllen = 0;
+    }
+    msg.msg_flags = 0;
+
+    do {
+      read_bytes = recvmsg(fd_, &msg, 0);
+    } while (read_bytes < 0 && errno == EINTR);
+
+    // We have read something in previous reads. We need to deliver those
+    // bytes to the upper layer.
+    if (read_bytes <= 0 && total_read_bytes > 0) {
+      inq_ = 1;
+      break;
+    }
+
+    if (read_bytes < 0) {
+      if (errno == EAGAIN) {
+        FinishEstimate();
+        inq_ = 0;
+        return false;
+      }
+      grpc_slice_buffer_reset_and_unref_internal(incoming_buffer_);
+      *status = PosixOSError(errno, "recvmsg");
+      return true;
+    }
+    if (read_bytes == 0) {
+      // 0 read size ==> end of stream. Anything read earlier in this loop is
+      // dropped, because the callback can only be called once.
+      grpc_slice_buffer_reset_and_unref_internal(incoming_buffer_);
+      *status = absl::UnavailableError("Socket closed");
+      return true;
+    }
+
+    bytes_read_this_round_ += static_cast<double>(read_bytes);
+    GPR_DEBUG_ASSERT(static_cast<size_t>(read_bytes) <=
+                     incoming_buffer_->length - total_read_bytes);
+
+#ifdef GRPC_HAVE_TCP_INQ
+    if (inq_capable_) {
+      GPR_DEBUG_ASSERT(!(msg.msg_flags & MSG_CTRUNC));
+      cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+      for (; cmsg != nullptr; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+        if (cmsg->cmsg_level == SOL_TCP && cmsg->cmsg_type == TCP_CM_INQ &&
+            cmsg->cmsg_len == CMSG_LEN(sizeof(int))) {
+          memcpy(&inq_, CMSG_DATA(cmsg), sizeof(inq_));
+          break;
+        }
+      }
+    }
+#endif  // GRPC_HAVE_TCP_INQ
+
+    total_read_bytes += read_bytes;
+    if (inq_ == 0 || total_read_bytes == incoming_buffer_->length) {
+      break;
+    }
+
+    // We had a partial read, and still have space to read more data. So,
+    // adjust IOVs and try to read more.
+    size_t remaining = read_bytes;
+    size_t j = 0;
+    for (size_t i = 0; i < iov_len; i++) {
+      if (remaining >= iov[i].iov_len) {
+        remaining -= iov[i].iov_len;
+        continue;
+      }
+      if (remaining > 0) {
+        iov[j].iov_base = static_cast<char*>(iov[i].iov_base) + remaining;
+        iov[j].iov_len = iov[i].iov_len - remaining;
+        remaining = 0;
+      } else {
+        iov[j].iov_base = iov[i].iov_base;
+        iov[j].iov_len = iov[i].iov_len;
+      }
+      ++j;
+    }
+    iov_len = j;
+  } while (true);
+
+  if (inq_ == 0) {
+    FinishEstimate();
+  }
+
+  GPR_DEBUG_ASSERT(total_read_bytes > 0);
+  if (total_read_bytes < incoming_buffer_->length) {
+    grpc_slice_buffer_trim_end(incoming_buffer_,
+                               incoming_buffer_->length - total_read_bytes,
+                               &last_read_buffer_);
+  }
+  *status = absl::OkStatus();
+  return true;
+}
+
+void PosixEndpointImpl::HandleRead(absl::Status status) {
+  grpc_core::ReleasableMutexLock lock(&read_mu_);
+  if (status.ok()) {
+    MaybeMakeReadSlices();
+    if (!TcpDoRead(&status)) {
+      // We've consumed the edge, request a new one.
+      lock.Release();
+      handle_->NotifyOnRead(on_read_);
+      return;
+    }
+  } else {
+    grpc_slice_buffer_reset_and_unref_internal(incoming_buffer_);
+    grpc_slice_buffer_reset_and_unref_internal(&last_read_buffer_);
+  }
+  std::function<void(absl::Status)> cb = std::move(read_cb_);
+  read_cb_ = nullptr;
+  incoming_buffer_ = nullptr;
+  lock.Release();
+  cb(std::move(status));
+  Unref();
+}
+
+void PosixEndpointImpl::Read(std::function<void(absl::Status)> on_read,
+                             SliceBuffer* buffer) {
+  grpc_core::ReleasableMutexLock lock(&read_mu_);
+  GPR_ASSERT(read_cb_ == nullptr);
+  read_cb_ = std::move(on_read);
+  incoming_buffer_ = buffer->RawSliceBuffer();
+  grpc_slice_buffer_reset_and_unref_internal(incoming_buffer_);
+  grpc_slice_buffer_swap(incoming_buffer_, &last_read_buffer_);
+  Ref().release();
+  if (is_first_read_ || inq_ == 0) {
+    // Either nothing was read yet, or the last read drained the socket: wait
+    // for the poller to report it readable.
+    is_first_read_ = false;
+    lock.Release();
+    handle_->NotifyOnRead(on_read_);
+  } else {
+    // There may be more data queued in the kernel. Read it from a scheduler
+    // thread so that on_read never runs inline.
+    lock.Release();
+    on_read_->SetStatus(absl::OkStatus());
+    scheduler_->Run(on_read_);
+  }
+}
+
+bool PosixEndpointImpl::TcpFlush(absl::Status* status) {
+  msghdr msg;
+  iovec iov[MAX_WRITE_IOVEC];
+  msg_iovlen_type iov_size;
+  ssize_t sent_length = 0;
+  size_t sending_length;
+  size_t trailing;
+  size_t unwind_slice_idx;
+  size_t unwind_byte_idx;
+
+  // We always start at zero, because we eagerly unref and trim the slice
+  // buffer as we write.
+  size_t outgoing_slice_idx = 0;
+
+  while (true) {
+    sending_length = 0;
+    unwind_slice_idx = outgoing_slice_idx;
+    unwind_byte_idx = outgoing_byte_idx_;
+    for (iov_size = 0; outgoing_slice_idx != outgoing_buffer_->count &&
+                       iov_size != MAX_WRITE_IOVEC;
+         iov_size++) {
+      iov[iov_size].iov_base =
+          GRPC_SLICE_START_PTR(outgoing_buffer_->slices[outgoing_slice_idx]) +
+          outgoing_byte_idx_;
+      iov[iov_size].iov_len =
+          GRPC_SLICE_LENGTH(outgoing_buffer_->slices[outgoing_slice_idx]) -
+          outgoing_byte_idx_;
+      sending_length += iov[iov_size].iov_len;
+      outgoing_slice_idx++;
+      outgoing_byte_idx_ = 0;
+    }
+    GPR_ASSERT(iov_size > 0);
+
+    msg.msg_name = nullptr;
+    msg.msg_namelen = 0;
+    msg.msg_iov = iov;
+    msg.msg_iovlen = iov_size;
+    msg.msg_control = nullptr;
+    msg.msg_controllen = 0;
+    msg.msg_flags = 0;
+    sent_length = TcpSend(fd_, &msg);
+
+    if (sent_length < 0) {
+      if (errno == EAGAIN) {
+        outgoing_byte_idx_ = unwind_byte_idx;
+        // Unref all and forget about all slices that have been written to
+        // this point.
+        for (size_t idx = 0; idx < unwind_slice_idx; ++idx) {
+          grpc_slice_buffer_remove_first(outgoing_buffer_);
+        }
+        return false;
+      }
+      *status = PosixOSError(errno, "sendmsg");
+      grpc_slice_buffer_reset_and_unref_internal(outgoing_buffer_);
+      return true;
+    }
+
+    GPR_ASSERT(outgoing_byte_idx_ == 0);
+    trailing = sending_length - static_cast<size_t>(sent_length);
+    while (trailing > 0) {
+      size_t slice_length;
+      outgoing_slice_idx--;
+      slice_length =
+          GRPC_SLICE_LENGTH(outgoing_buffer_->slices[outgoing_slice_idx]);
+      if (slice_length > trailing) {
+        outgoing_byte_idx_ = slice_length - trailing;
+        break;
+      } else {
+        trailing -= slice_length;
+      }
+    }
+    if (outgoing_slice_idx == outgoing_buffer_->count) {
+      *status = absl::OkStatus();
+      grpc_slice_buffer_reset_and_unref_internal(outgoing_buffer_);
+      return true;
+    }
+  }
+}
+
+bool PosixEndpointImpl::DoTcpFlushZerocopy(TcpZerocopySendRecord* record,
+                                           absl::Status* status) {
+  msg_iovlen_type iov_size;
+  ssize_t sent_length = 0;
+  size_t sending_length;
+  size_t unwind_slice_idx;
+  size_t unwind_byte_idx;
+  msghdr msg;
+  // iov consumes a large space. Keep it as the last item on the stack to
+  // improve locality.
+  iovec iov[MAX_WRITE_IOVEC];
+  while (true) {
+    sending_length = 0;
+    iov_size = record->PopulateIovs(&unwind_slice_idx, &unwind_byte_idx,
+                                    &sending_length, iov);
+    msg.msg_name = nullptr;
+    msg.msg_namelen = 0;
+    msg.msg_iov = iov;
+    msg.msg_iovlen = iov_size;
+    msg.msg_control = nullptr;
+    msg.msg_controllen = 0;
+    msg.msg_flags = 0;
+    // Take a ref on the record for this sendmsg call; it is dropped when the
+    // kernel reports the send as complete.
+    tcp_zerocopy_send_ctx_.NoteSend(record);
+    sent_length = TcpSend(fd_, &msg, MSG_ZEROCOPY);
+    if (sent_length < 0) {
+      // If this particular send failed, drop the ref taken above.
+      tcp_zerocopy_send_ctx_.UndoSend();
+      if (errno == EAGAIN) {
+        record->UnwindIfThrottled(unwind_slice_idx, unwind_byte_idx);
+        return false;
+      }
+      *status = PosixOSError(errno, "sendmsg");
+      return true;
+    }
+    record->UpdateOffsetForBytesSent(sending_length,
+                                     static_cast<size_t>(sent_length));
+    if (record->AllSlicesSent()) {
+      *status = absl::OkStatus();
+      return true;
+    }
+  }
+}
+
+bool PosixEndpointImpl::TcpFlushZerocopy(TcpZerocopySendRecord* record,
+                                         absl::Status* status) {
+  bool done = DoTcpFlushZerocopy(record, status);
+  if (done) {
+    // Either we encountered an error, or we successfully sent all the bytes.
+    // In either case, we're done with this record.
+    UnrefMaybePutZerocopySendRecord(record);
+  }
+  return done;
+}
+
+void PosixEndpointImpl::UnrefMaybePutZerocopySendRecord(
+    TcpZerocopySendRecord* record) {
+  if (record->Unref()) {
+    tcp_zerocopy_send_ctx_.PutSendRecord(record);
+  }
+}
+
+TcpZerocopySendRecord* PosixEndpointImpl::TcpGetSendZerocopyRecord(
+    grpc_slice_buffer* buf) {
+  if (!tcp_zerocopy_send_ctx_.enabled() ||
+      tcp_zerocopy_send_ctx_.threshold_bytes() >= buf->length) {
+    return nullptr;
+  }
+  TcpZerocopySendRecord* record = tcp_zerocopy_send_ctx_.GetSendRecord();
+  if (record == nullptr) {
+    // All records may be waiting on completions that are already queued.
+    ProcessErrors();
+    record = tcp_zerocopy_send_ctx_.GetSendRecord();
+  }
+  if (record != nullptr) {
+    record->PrepareForSends(buf);
+    GPR_DEBUG_ASSERT(buf->count == 0);
+    GPR_DEBUG_ASSERT(buf->length == 0);
+    outgoing_byte_idx_ = 0;
+    outgoing_buffer_ = nullptr;
+  }
+  return record;
+}
+
+void PosixEndpointImpl::HandleWrite(absl::Status status) {
+  if (status.ok()) {
+    bool flush_result =
+        current_zerocopy_send_ != nullptr
+            ? TcpFlushZerocopy(current_zerocopy_send_, &status)
+            : TcpFlush(&status);
+    if (!flush_result) {
+      handle_->NotifyOnWrite(on_write_);
+      return;
+    }
+  } else if (current_zerocopy_send_ != nullptr) {
+    UnrefMaybePutZerocopySendRecord(current_zerocopy_send_);
+  }
+  current_zerocopy_send_ = nullptr;
+  std::function<void(absl::Status)> cb = std::move(write_cb_);
+  write_cb_ = nullptr;
+  cb(std::move(status));
+  Unref();
+}
+
+void PosixEndpointImpl::Write(std::function<void(absl::Status)> on_writable,
+                              SliceBuffer* data) {
+  grpc_slice_buffer* buf = data->RawSliceBuffer();
+  absl::Status status;
+  GPR_ASSERT(write_cb_ == nullptr);
+  GPR_DEBUG_ASSERT(current_zerocopy_send_ == nullptr);
+  if (buf->length == 0) {
+    if (handle_->IsHandleShutdown()) {
+      status = absl::CancelledError("Write on a shut down endpoint");
+    }
+    scheduler_->Run(std::bind(std::move(on_writable), std::move(status)));
+    return;
+  }
+  TcpZerocopySendRecord* zerocopy_send_record = TcpGetSendZerocopyRecord(buf);
+  if (zerocopy_send_record == nullptr) {
+    // Either not enough bytes, or no zerocopy record was available.
+    outgoing_buffer_ = buf;
+    outgoing_byte_idx_ = 0;
+  }
+  bool flush_result = zerocopy_send_record != nullptr
+                          ? TcpFlushZerocopy(zerocopy_send_record, &status)
+                          : TcpFlush(&status);
+  if (!flush_result) {
+    Ref().release();
+    write_cb_ = std::move(on_writable);
+    current_zerocopy_send_ = zerocopy_send_record;
+    handle_->NotifyOnWrite(on_write_);
+    return;
+  }
+  // Even a write that completed synchronously reports from a scheduler
+  // thread, so callers never see on_writable run inside Write().
+  scheduler_->Run(std::bind(std::move(on_writable), std::move(status)));
+}
+
+#ifdef GRPC_LINUX_ERRQUEUE
+
+bool PosixEndpointImpl::ProcessErrors() {
+  bool processed_err = false;
+  iovec iov;
+  iov.iov_base = nullptr;
+  iov.iov_len = 0;
+  msghdr msg;
+  msg.msg_name = nullptr;
+  msg.msg_namelen = 0;
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 0;
+  msg.msg_flags = 0;
+  union {
+    char rbuf[CMSG_SPACE(sizeof(sock_extended_err) + sizeof(sockaddr_in6))];
+    cmsghdr align;
+  } aligned_buf;
+  msg.msg_control = aligned_buf.rbuf;
+  int r, saved_errno;
+  while (true) {
+    msg.msg_controllen = sizeof(aligned_buf.rbuf);
+    do {
+      r = recvmsg(fd_, &msg, MSG_ERRQUEUE);
+      saved_errno = errno;
+    } while (r < 0 && saved_errno == EINTR);
+    if (r == -1) {
+      // EAGAIN means there are no more errors to process.
+      return processed_err;
+    }
+    if (GPR_UNLIKELY((msg.msg_flags & MSG_CTRUNC) != 0)) {
+      gpr_log(GPR_ERROR, "Error message was truncated.");
+    }
+    if (msg.msg_controllen == 0) {
+      // There was no control message found. It was probably spurious.
+      return processed_err;
+    }
+    bool seen = false;
+    for (cmsghdr* cmsg = CMSG_FIRSTHDR(&msg); cmsg && cmsg->cmsg_len;
+         cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+      bool ip_level =
+          (cmsg->cmsg_level == SOL_IPV6 && cmsg->cmsg_type == IPV6_RECVERR) ||
+          (cmsg->cmsg_level == SOL_IP && cmsg->cmsg_type == IP_RECVERR);
+      if (!ip_level) return processed_err;
+      auto* serr = reinterpret_cast<sock_extended_err*>(CMSG_DATA(cmsg));
+      if (serr->ee_errno != 0 || serr->ee_origin != SO_EE_ORIGIN_ZEROCOPY) {
+        return processed_err;
+      }
+      // The kernel reports a range of completed send sequence numbers.
+      const uint32_t lo = serr->ee_info;
+      const uint32_t hi = serr->ee_data;
+      for (uint32_t seq = lo; seq <= hi; ++seq) {
+        UnrefMaybePutZerocopySendRecord(
+            tcp_zerocopy_send_ctx_.ReleaseSendRecord(seq));
+      }
+      seen = true;
+      processed_err = true;
+    }
+    if (!seen) return processed_err;
+  }
+}
+
+#else  // GRPC_LINUX_ERRQUEUE
+
+bool PosixEndpointImpl::ProcessErrors() { return false; }
+
+#endif  // GRPC_LINUX_ERRQUEUE
+
+void PosixEndpointImpl::HandleError(absl::Status status) {
+  if (!status.ok() ||
+      stop_error_notification_.load(std::memory_order_acquire)) {
+    // We aren't going to register to hear on error anymore, so it is safe to
+    // unref.
+    Unref();
+    return;
+  }
+  if (!ProcessErrors()) {
+    // This was not a zerocopy completion: let the reader and writer find out
+    // what went wrong.
+    handle_->SetReadable();
+    handle_->SetWritable();
+  }
+  handle_->NotifyOnError(on_error_);
+}
+
+void PosixEndpointImpl::ZerocopyDisableAndWaitForRemaining() {
+  tcp_zerocopy_send_ctx_.Shutdown();
+  while (!tcp_zerocopy_send_ctx_.AllSendRecordsEmpty()) {
+    ProcessErrors();
+  }
+}
+
+class PosixEndpoint final : public EventEngine::Endpoint {
+ public:
+  explicit PosixEndpoint(PosixEndpointImpl* impl) : impl_(impl) {}
+  ~PosixEndpoint() override {
+    impl_->MaybeShutdown(absl::CancelledError("Endpoint destroyed"));
+  }
+
+  void Read(std::function<void(absl::Status)> on_read,
+            SliceBuffer* buffer) override {
+    impl_->Read(std::move(on_read), buffer);
+  }
+  void Write(std::function<void(absl::Status)> on_writable,
+             SliceBuffer* data) override {
+    impl_->Write(std::move(on_writable), data);
+  }
+  const EventEngine::ResolvedAddress& GetPeerAddress() const override {
+    return impl_->GetPeerAddress();
+  }
+  const EventEngine::ResolvedAddress& GetLocalAddress() const override {
+    return impl_->GetLocalAddress();
+  }
+
+ private:
+  PosixEndpointImpl* impl_;
+};
+
+}  // namespace
+
+bool PosixEndpointTracksErrors(const PosixTcpOptions& options) {
+#ifdef GRPC_LINUX_ERRQUEUE
+  return options.tcp_tx_zero_copy_enabled;
+#else
+  (void)options;
+  return false;
+#endif
+}
+
+std::unique_ptr<EventEngine::Endpoint> CreatePosixEndpoint(
+    EventHandle* handle, Scheduler* scheduler, MemoryAllocator&& allocator,
+    const PosixTcpOptions& options) {
+  GPR_ASSERT(handle != nullptr);
+  return absl::make_unique<PosixEndpoint>(new PosixEndpointImpl(
+      handle, scheduler, std::move(allocator), options));
+}
+
+}  // namespace posix_engine
+}  // namespace grpc_event_engine
+
+#else  // GRPC_POSIX_SOCKET_TCP
+
+#include <grpc/support/log.h>
+
+namespace grpc_event_engine {
+namespace posix_engine {
+
+bool PosixEndpointTracksErrors(const PosixTcpOptions& /*options*/) {
+  return false;
+}
+
+std::unique_ptr<experimental::EventEngine::Endpoint> CreatePosixEndpoint(
+    EventHandle* /*handle*/, Scheduler* /*scheduler*/,
+    experimental::MemoryAllocator&& /*allocator*/,
+    const PosixTcpOptions& /*options*/) {
+  gpr_log(GPR_ERROR, "Posix endpoints are not supported on this platform");
+  abort();
+}
+
+}  // namespace posix_engine
+}  // namespace grpc_event_engine
+
+#endif  // GRPC_POSIX_SOCKET_TCP
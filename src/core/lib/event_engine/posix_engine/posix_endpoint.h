@@ -0,0 +1,46 @@
+// Copyright 2022 The gRPC Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#ifndef GRPC_CORE_LIB_EVENT_ENGINE_POSIX_ENGINE_POSIX_ENDPOINT_H
+#define GRPC_CORE_LIB_EVENT_ENGINE_POSIX_ENGINE_POSIX_ENDPOINT_H
+
+#include <grpc/support/port_platform.h>
+
+#include <memory>
+
+#include <grpc/event_engine/event_engine.h>
+#include <grpc/event_engine/memory_allocator.h>
+
+#include "src/core/lib/event_engine/posix_engine/event_poller.h"
+#include "src/core/lib/event_engine/posix_engine/tcp_socket_utils.h"
+
+namespace grpc_event_engine {
+namespace posix_engine {
+
+/// Returns true if the EventHandle of an endpoint created with \a options
+/// must be created with error tracking enabled: MSG_ZEROCOPY completions are
+/// delivered through the socket error queue.
+bool PosixEndpointTracksErrors(const PosixTcpOptions& options);
+
+/// Creates an Endpoint for the connected socket wrapped by \a handle. The
+/// endpoint takes ownership of the handle and orphans it (closing the fd) once
+/// the endpoint is destroyed and all pending operations have completed. Read
+/// and write callbacks run on \a scheduler, never inline.
+std::unique_ptr<experimental::EventEngine::Endpoint> CreatePosixEndpoint(
+    EventHandle* handle, Scheduler* scheduler,
+    experimental::MemoryAllocator&& allocator, const PosixTcpOptions& options);
+
+}  // namespace posix_engine
+}  // namespace grpc_event_engine
+
+#endif  // GRPC_CORE_LIB_EVENT_ENGINE_POSIX_ENGINE_POSIX_ENDPOINT_H
@@ -0,0 +1,468 @@
+// Copyright 2022 The gRPC Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <grpc/support/port_platform.h>
+
+#include "src/core/lib/event_engine/posix_engine/posix_engine.h"
+
+#include <inttypes.h>
+#include <string.h>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/memory/memory.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+
+#include <grpc/support/log.h>
+#include <grpc/support/time.h>
+
+#include "src/core/lib/event_engine/posix_engine/ev_epoll1_linux.h"
+#include "src/core/lib/event_engine/posix_engine/io_uring_endpoint.h"
+#include "src/core/lib/event_engine/posix_engine/posix_endpoint.h"
+#include "src/core/lib/event_engine/posix_engine/posix_engine_closure.h"
+#include "src/core/lib/event_engine/posix_engine/posix_engine_listener.h"
+#include "src/core/lib/event_engine/posix_engine/tcp_socket_utils.h"
+#include "src/core/lib/event_engine/posix_engine/timer.h"
+#include "src/core/lib/gprpp/host_port.h"
+#include "src/core/lib/gprpp/time.h"
+#include "src/core/lib/iomgr/port.h"
+
+#ifdef GRPC_POSIX_SOCKET_TCP
+#include <errno.h>
+#include <netdb.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+GPR_GLOBAL_CONFIG_DEFINE_BOOL(
+    grpc_experimental_enable_io_uring, false,
+    "If set, the posix EventEngine reads from and writes to TCP sockets with "
+    "io_uring when the kernel supports it, batching the system calls of all "
+    "connections. Otherwise it uses epoll.");
+
+namespace grpc_event_engine {
+namespace experimental {
+
+namespace {
+
+// Converts \a when to a deadline on the monotonic clock that the timer wheel
+// runs on, rounding up so that timers never fire early.
+grpc_core::Timestamp ToTimestamp(absl::Time when) {
+  if (when == absl::InfiniteFuture()) return grpc_core::Timestamp::InfFuture();
+  absl::Duration delta = when - absl::Now();
+  if (delta < absl::ZeroDuration()) delta = absl::ZeroDuration();
+  // Anything this far out will not fire within the lifetime of the process.
+  if (delta > absl::Hours(24 * 365 * 100)) {
+    return grpc_core::Timestamp::InfFuture();
+  }
+  return grpc_core::Timestamp::FromTimespecRoundUp(gpr_time_add(
+      gpr_now(GPR_CLOCK_MONOTONIC),
+      gpr_time_from_nanos(absl::ToInt64Nanoseconds(delta), GPR_TIMESPAN)));
+}
+
+// Resolves names with the blocking getaddrinfo(3) on the engine's thread
+// pool. Lookups cannot be cancelled, and deadlines are not enforced.
+class PosixDNSResolver final : public EventEngine::DNSResolver {
+ public:
+  explicit PosixDNSResolver(EventEngine* engine) : engine_(engine) {}
+
+  LookupTaskHandle LookupHostname(LookupHostnameCallback on_resolve,
+                                  absl::string_view name,
+                                  absl::string_view default_port,
+                                  absl::Time /*deadline*/) override {
+    std::string name_str(name);
+    std::string default_port_str(default_port);
+    engine_->Run([on_resolve, name_str, default_port_str]() {
+      on_resolve(LookupHostnameBlocking(name_str, default_port_str));
+    });
+    return {{0, 0}};
+  }
+
+  LookupTaskHandle LookupSRV(LookupSRVCallback on_resolve,
+                             absl::string_view /*name*/,
+                             absl::Time /*deadline*/) override {
+    engine_->Run([on_resolve]() {
+      on_resolve(absl::UnimplementedError(
+          "SRV lookups are not supported by the posix DNS resolver"));
+    });
+    return {{0, 0}};
+  }
+
+  LookupTaskHandle LookupTXT(LookupTXTCallback on_resolve,
+                             absl::string_view /*name*/,
+                             absl::Time /*deadline*/) override {
+    engine_->Run([on_resolve]() {
+      on_resolve(absl::UnimplementedError(
+          "TXT lookups are not supported by the posix DNS resolver"));
+    });
+    return {{0, 0}};
+  }
+
+  bool CancelLookup(LookupTaskHandle /*handle*/) override { return false; }
+
+ private:
+  static absl::StatusOr<std::vector<EventEngine::ResolvedAddress>>
+  LookupHostnameBlocking(const std::string& name,
+                         const std::string& default_port) {
+#ifdef GRPC_POSIX_SOCKET_TCP
+    std::string host;
+    std::string port;
+    if (!grpc_core::SplitHostPort(name, &host, &port) || host.empty()) {
+      return absl::InvalidArgumentError(
+          absl::StrCat("Unparseable name: ", name));
+    }
+    if (port.empty()) {
+      if (default_port.empty()) {
+        return absl::InvalidArgumentError(
+            absl::StrCat("No port in name: ", name));
+      }
+      port = default_port;
+    }
+    addrinfo hints;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* result = nullptr;
+    int s = getaddrinfo(host.c_str(), port.c_str(), &hints, &result);
+    if (s != 0) {
+      return absl::NotFoundError(absl::StrCat("getaddrinfo(", name,
+                                              "): ", gai_strerror(s)));
+    }
+    std::vector<EventEngine::ResolvedAddress> addresses;
+    for (addrinfo* resp = result; resp != nullptr; resp = resp->ai_next) {
+      addresses.emplace_back(resp->ai_addr,
+                             static_cast<socklen_t>(resp->ai_addrlen));
+    }
+    freeaddrinfo(result);
+    return addresses;
+#else
+    (void)name;
+    (void)default_port;
+    return absl::UnimplementedError("DNS lookups are not supported");
+#endif
+  }
+
+  EventEngine* engine_;
+};
+
+}  // namespace
+
+// Wraps every timer, so that RunAt callbacks can be tracked for Cancel().
+struct PosixEventEngine::ClosureData final : public EventEngine::Closure {
+  std::function<void()> cb;
+  posix_engine::Timer timer;
+  PosixEventEngine* engine;
+  EventEngine::TaskHandle handle;
+
+  void Run() override {
+    {
+      grpc_core::MutexLock lock(&engine->mu_);
+      engine->known_handles_.erase(handle);
+    }
+    cb();
+    delete this;
+  }
+};
+
+// A connection attempt. The writable notification owns the EventHandle until
+// it either wraps it in an Endpoint or orphans it; whichever of that
+// notification, the deadline timer and CancelConnect() first removes the
+// attempt from pending_connections_ decides its outcome.
+struct PosixEventEngine::ConnectionState {
+  EventEngine::OnConnectCallback on_connect;
+  MemoryAllocator allocator;
+  posix_engine::PosixTcpOptions options;
+  posix_engine::EventHandle* handle = nullptr;
+  ConnectionHandle connection_handle;
+  TaskHandle deadline_timer;
+  // One ref for the writable notification and one for the deadline timer.
+  std::atomic<int> refs{2};
+};
+
+PosixEventEngine::PosixEventEngine()
+    : thread_pool_(absl::make_unique<ThreadPool>()),
+      poller_(posix_engine::MakeEpoll1Poller(this)),
+      timer_manager_(absl::make_unique<posix_engine::TimerManager>(this)) {
+  if (poller_ != nullptr) {
+    poller_thread_ = grpc_core::Thread("event_engine_poller",
+                                       &PosixEventEngine::PollerLoop, this);
+    poller_thread_.Start();
+    if (GPR_GLOBAL_CONFIG_GET(grpc_experimental_enable_io_uring)) {
+      io_uring_ = posix_engine::IoUringPoller::Create(this);
+      if (io_uring_ == nullptr) {
+        gpr_log(GPR_INFO, "io_uring is not supported, falling back to epoll");
+      }
+    }
+  }
+}
+
+PosixEventEngine::~PosixEventEngine() {
+  {
+    grpc_core::MutexLock lock(&mu_);
+    if (!known_handles_.empty()) {
+      gpr_log(GPR_ERROR,
+              "PosixEventEngine destroyed with %" PRIuPTR
+              " outstanding timers; they will not run",
+              known_handles_.size());
+    }
+    for (const auto& handle : known_handles_) {
+      auto* cd = reinterpret_cast<ClosureData*>(handle.keys[0]);
+      if (timer_manager_->TimerCancel(&cd->timer)) delete cd;
+    }
+    known_handles_.clear();
+  }
+  timer_manager_.reset();
+  if (poller_ != nullptr) {
+    poller_shutdown_.store(true, std::memory_order_release);
+    poller_->Kick();
+    poller_thread_.Join();
+  }
+  io_uring_.reset();
+  // Runs whatever the timers and the pollers already scheduled.
+  thread_pool_.reset();
+  if (poller_ != nullptr) poller_->Shutdown();
+}
+
+void PosixEventEngine::PollerLoop(void* arg) {
+  auto* engine = static_cast<PosixEventEngine*>(arg);
+  while (!engine->poller_shutdown_.load(std::memory_order_acquire)) {
+    engine->poller_->Work(grpc_core::Duration::Infinity());
+  }
+}
+
+bool PosixEventEngine::IsWorkerThread() {
+  return thread_pool_->IsThreadPoolThread();
+}
+
+void PosixEventEngine::Run(Closure* closure) {
+  thread_pool_->Add([closure]() { closure->Run(); });
+}
+
+void PosixEventEngine::Run(std::function<void()> closure) {
+  thread_pool_->Add(std::move(closure));
+}
+
+EventEngine::TaskHandle PosixEventEngine::RunAt(absl::Time when,
+                                                Closure* closure) {
+  return RunAtInternal(when, [closure]() { closure->Run(); });
+}
+
+EventEngine::TaskHandle PosixEventEngine::RunAt(absl::Time when,
+                                                std::function<void()> closure) {
+  return RunAtInternal(when, std::move(closure));
+}
+
+EventEngine::TaskHandle PosixEventEngine::RunAtInternal(
+    absl::Time when, std::function<void()> cb) {
+  grpc_core::Timestamp deadline = ToTimestamp(when);
+  auto* cd = new ClosureData;
+  cd->cb = std::move(cb);
+  cd->engine = this;
+  EventEngine::TaskHandle handle{
+      {reinterpret_cast<intptr_t>(cd),
+       aba_token_.fetch_add(1, std::memory_order_relaxed)}};
+  cd->handle = handle;
+  grpc_core::MutexLock lock(&mu_);
+  known_handles_.insert(handle);
+  timer_manager_->TimerInit(&cd->timer, deadline, cd);
+  return handle;
+}
+
+bool PosixEventEngine::Cancel(TaskHandle handle) {
+  grpc_core::MutexLock lock(&mu_);
+  if (!known_handles_.contains(handle)) return false;
+  auto* cd = reinterpret_cast<ClosureData*>(handle.keys[0]);
+  bool r = timer_manager_->TimerCancel(&cd->timer);
+  known_handles_.erase(handle);
+  if (r) delete cd;
+  return r;
+}
+
+std::unique_ptr<EventEngine::DNSResolver> PosixEventEngine::GetDNSResolver(
+    const DNSResolver::ResolverOptions& /*options*/) {
+  return absl::make_unique<PosixDNSResolver>(this);
+}
+
+absl::StatusOr<std::unique_ptr<EventEngine::Listener>>
+PosixEventEngine::CreateListener(
+    Listener::AcceptCallback on_accept,
+    std::function<void(absl::Status)> on_shutdown,
+    const EndpointConfig& config,
+    std::unique_ptr<MemoryAllocatorFactory> memory_allocator_factory) {
+  if (poller_ == nullptr) {
+    return absl::UnimplementedError(
+        "PosixEventEngine networking requires epoll");
+  }
+  return posix_engine::CreatePosixEngineListener(
+      std::move(on_accept), std::move(on_shutdown), config,
+      std::move(memory_allocator_factory), poller_, io_uring_.get(), this);
+}
+
+#ifdef GRPC_POSIX_SOCKET_TCP
+
+EventEngine::ConnectionHandle PosixEventEngine::Connect(
+    OnConnectCallback on_connect, const ResolvedAddress& addr,
+    const EndpointConfig& args, MemoryAllocator memory_allocator,
+    absl::Time deadline) {
+  static constexpr ConnectionHandle kInvalidConnectionHandle = {{0, 0}};
+  auto fail = [this, &on_connect](absl::Status status) {
+    Run([on_connect, status]() { on_connect(status); });
+    return kInvalidConnectionHandle;
+  };
+  if (poller_ == nullptr) {
+    return fail(
+        absl::UnimplementedError("PosixEventEngine networking requires epoll"));
+  }
+  posix_engine::PosixTcpOptions options =
+      posix_engine::TcpOptionsFromEndpointConfig(args);
+  absl::StatusOr<int> fd =
+      posix_engine::CreateNonBlockingSocket(addr.address()->sa_family);
+  if (!fd.ok()) return fail(fd.status());
+  absl::Status status = posix_engine::PrepareConnectedSocket(*fd, options);
+  if (status.ok()) {
+    int err;
+    do {
+      err = connect(*fd, addr.address(), addr.size());
+    } while (err < 0 && errno == EINTR);
+    // A connection that completes immediately is handled like one in
+    // progress: the socket is already writable, so the poller reports it.
+    if (err < 0 && errno != EINPROGRESS) {
+      status = posix_engine::PosixOSError(errno, "connect");
+    }
+  }
+  if (!status.ok()) {
+    close(*fd);
+    return fail(status);
+  }
+  auto* state = new ConnectionState;
+  state->on_connect = std::move(on_connect);
+  state->allocator = std::move(memory_allocator);
+  state->options = options;
+  state->handle = poller_->CreateHandle(
+      *fd, posix_engine::SockaddrToString(addr),
+      posix_engine::PosixEndpointTracksErrors(options));
+  state->connection_handle = {
+      {reinterpret_cast<intptr_t>(state),
+       aba_token_.fetch_add(1, std::memory_order_relaxed)}};
+  ConnectionHandle handle = state->connection_handle;
+  {
+    grpc_core::MutexLock lock(&mu_);
+    pending_connections_.insert(handle);
+  }
+  state->deadline_timer =
+      RunAtInternal(deadline, [this, state]() { OnConnectDeadline(state); });
+  state->handle->NotifyOnWrite(new posix_engine::PosixEngineClosure(
+      [this, state](absl::Status status) {
+        OnConnectWritable(state, std::move(status));
+      },
+      /*is_permanent=*/false));
+  return handle;
+}
+
+void PosixEventEngine::OnConnectWritable(ConnectionState* state,
+                                         absl::Status status) {
+  bool owned;
+  {
+    grpc_core::MutexLock lock(&mu_);
+    owned = pending_connections_.erase(state->connection_handle) > 0;
+  }
+  if (!owned) {
+    // The deadline or CancelConnect() already decided the outcome.
+    state->handle->OrphanHandle(nullptr, nullptr, "connect cancelled");
+    UnrefConnectionState(state);
+    return;
+  }
+  if (Cancel(state->deadline_timer)) UnrefConnectionState(state);
+  int fd = state->handle->WrappedFd();
+  if (status.ok()) {
+    int so_error = 0;
+    socklen_t so_error_size = sizeof(so_error);
+    if (getsockopt(fd, SOL_SOCKET, SO_ERROR, &so_error, &so_error_size) < 0) {
+      status = posix_engine::PosixOSError(errno, "getsockopt");
+    } else if (so_error != 0) {
+      status = posix_engine::PosixOSError(so_error, "connect");
+    }
+  }
+  if (!status.ok()) {
+    state->handle->OrphanHandle(nullptr, nullptr, "connect failed");
+    state->on_connect(status);
+  } else if (io_uring_ != nullptr) {
+    state->handle->OrphanHandle(nullptr, &fd, "handed off to io_uring");
+    state->on_connect(posix_engine::CreateIoUringEndpoint(
+        fd, io_uring_.get(), std::move(state->allocator)));
+  } else {
+    state->on_connect(posix_engine::CreatePosixEndpoint(
+        state->handle, this, std::move(state->allocator), state->options));
+  }
+  UnrefConnectionState(state);
+}
+
+void PosixEventEngine::OnConnectDeadline(ConnectionState* state) {
+  bool owned;
+  {
+    grpc_core::MutexLock lock(&mu_);
+    owned = pending_connections_.erase(state->connection_handle) > 0;
+  }
+  if (owned) {
+    // Fails the writable notification, which releases the socket.
+    state->handle->ShutdownHandle(
+        absl::DeadlineExceededError("Connect deadline exceeded"));
+    state->on_connect(absl::DeadlineExceededError("Connect deadline exceeded"));
+  }
+  UnrefConnectionState(state);
+}
+
+bool PosixEventEngine::CancelConnect(ConnectionHandle handle) {
+  {
+    grpc_core::MutexLock lock(&mu_);
+    if (pending_connections_.erase(handle) == 0) return false;
+  }
+  auto* state = reinterpret_cast<ConnectionState*>(handle.keys[0]);
+  if (Cancel(state->deadline_timer)) UnrefConnectionState(state);
+  state->handle->ShutdownHandle(absl::CancelledError("Connect cancelled"));
+  return true;
+}
+
+void PosixEventEngine::UnrefConnectionState(ConnectionState* state) {
+  if (state->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) delete state;
+}
+
+#else  // GRPC_POSIX_SOCKET_TCP
+
+EventEngine::ConnectionHandle PosixEventEngine::Connect(
+    OnConnectCallback on_connect, const ResolvedAddress& /*addr*/,
+    const EndpointConfig& /*args*/, MemoryAllocator /*memory_allocator*/,
+    absl::Time /*deadline*/) {
+  Run([on_connect]() {
+    on_connect(absl::UnimplementedError(
+        "PosixEventEngine networking is not supported on this platform"));
+  });
+  return {{0, 0}};
+}
+
+bool PosixEventEngine::CancelConnect(ConnectionHandle /*handle*/) {
+  return false;
+}
+
+void PosixEventEngine::OnConnectWritable(ConnectionState* /*state*/,
+                                         absl::Status /*status*/) {}
+void PosixEventEngine::OnConnectDeadline(ConnectionState* /*state*/) {}
+void PosixEventEngine::UnrefConnectionState(ConnectionState* /*state*/) {}
+
+#endif  // GRPC_POSIX_SOCKET_TCP
+
+}  // namespace experimental
+}  // namespace grpc_event_engine
@@ -0,0 +1,144 @@
+// Copyright 2022 The gRPC Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#ifndef GRPC_CORE_LIB_EVENT_ENGINE_POSIX_ENGINE_POSIX_ENGINE_H
+#define GRPC_CORE_LIB_EVENT_ENGINE_POSIX_ENGINE_POSIX_ENGINE_H
+
+#include <grpc/support/port_platform.h>
+
+#include <stdint.h>
+
+#include <atomic>
+#include <functional>
+#include <memory>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/hash/hash.h"
+#include "absl/status/statusor.h"
+#include "absl/time/time.h"
+
+#include <grpc/event_engine/endpoint_config.h>
+#include <grpc/event_engine/event_engine.h>
+#include <grpc/event_engine/memory_allocator.h>
+
+#include "src/core/lib/event_engine/posix_engine/event_poller.h"
+#include "src/core/lib/event_engine/posix_engine/timer_manager.h"
+#include "src/core/lib/event_engine/thread_pool.h"
+#include "src/core/lib/gprpp/global_config.h"
+#include "src/core/lib/gprpp/sync.h"
+#include "src/core/lib/gprpp/thd.h"
+
+GPR_GLOBAL_CONFIG_DECLARE_BOOL(grpc_experimental_enable_io_uring);
+
+namespace grpc_event_engine {
+namespace posix_engine {
+class IoUringPoller;
+}  // namespace posix_engine
+
+namespace experimental {
+
+/// An EventEngine for Linux and other POSIX platforms with epoll.
+///
+/// Callbacks run on a work-stealing ThreadPool. A dedicated thread waits on
+/// an edge-triggered epoll set and hands ready fds to the pool, and another
+/// one drives a sharded timing wheel. On platforms without epoll the engine
+/// still supports Run and RunAt, but networking returns UNIMPLEMENTED.
+///
+/// With grpc_experimental_enable_io_uring set, connected sockets are handed
+/// to io_uring endpoints instead, whose operations are batched by an
+/// IoUringPoller. The engine falls back to epoll endpoints if the kernel does
+/// not support io_uring.
+class PosixEventEngine final : public EventEngine,
+                               public posix_engine::Scheduler {
+ public:
+  PosixEventEngine();
+  ~PosixEventEngine() override;
+
+  absl::StatusOr<std::unique_ptr<Listener>> CreateListener(
+      Listener::AcceptCallback on_accept,
+      std::function<void(absl::Status)> on_shutdown,
+      const EndpointConfig& config,
+      std::unique_ptr<MemoryAllocatorFactory> memory_allocator_factory)
+      override;
+  ConnectionHandle Connect(OnConnectCallback on_connect,
+                           const ResolvedAddress& addr,
+                           const EndpointConfig& args,
+                           MemoryAllocator memory_allocator,
+                           absl::Time deadline) override;
+  bool CancelConnect(ConnectionHandle handle) override;
+  bool IsWorkerThread() override;
+  std::unique_ptr<DNSResolver> GetDNSResolver(
+      const DNSResolver::ResolverOptions& options) override;
+  // Also implements posix_engine::Scheduler.
+  void Run(Closure* closure) override;
+  void Run(std::function<void()> closure) override;
+  TaskHandle RunAt(absl::Time when, Closure* closure) override;
+  TaskHandle RunAt(absl::Time when, std::function<void()> closure) override;
+  bool Cancel(TaskHandle handle) override;
+
+ private:
+  struct ClosureData;
+  struct ConnectionState;
+
+  // Hash and equality for the two-word handles of the EventEngine API.
+  template <typename Handle>
+  struct HandleHash {
+    size_t operator()(const Handle& handle) const {
+      return absl::Hash<std::pair<intptr_t, intptr_t>>()(
+          std::make_pair(handle.keys[0], handle.keys[1]));
+    }
+  };
+  template <typename Handle>
+  struct HandleEq {
+    bool operator()(const Handle& lhs, const Handle& rhs) const {
+      return lhs.keys[0] == rhs.keys[0] && lhs.keys[1] == rhs.keys[1];
+    }
+  };
+  using TaskHandleSet =
+      absl::flat_hash_set<TaskHandle, HandleHash<TaskHandle>,
+                          HandleEq<TaskHandle>>;
+  using ConnectionHandleSet =
+      absl::flat_hash_set<ConnectionHandle, HandleHash<ConnectionHandle>,
+                          HandleEq<ConnectionHandle>>;
+
+  static void PollerLoop(void* arg);
+
+  TaskHandle RunAtInternal(absl::Time when, std::function<void()> cb);
+  // Called when the socket of a pending connection becomes writable (or the
+  // attempt is cancelled).
+  void OnConnectWritable(ConnectionState* state, absl::Status status);
+  void OnConnectDeadline(ConnectionState* state);
+  void UnrefConnectionState(ConnectionState* state);
+
+  grpc_core::Mutex mu_;
+  TaskHandleSet known_handles_ ABSL_GUARDED_BY(mu_);
+  ConnectionHandleSet pending_connections_ ABSL_GUARDED_BY(mu_);
+  std::atomic<intptr_t> aba_token_{0};
+
+  // Destroyed in reverse order: timers first, then the poller thread, and the
+  // pool last so that callbacks they scheduled still run.
+  std::unique_ptr<ThreadPool> thread_pool_;
+  posix_engine::PosixEventPoller* poller_ = nullptr;
+  std::atomic<bool> poller_shutdown_{false};
+  grpc_core::Thread poller_thread_;
+  std::unique_ptr<posix_engine::TimerManager> timer_manager_;
+  // Null unless io_uring endpoints are enabled and supported. Destroyed
+  // before the thread pool, which runs the callbacks of its endpoints.
+  std::unique_ptr<posix_engine::IoUringPoller> io_uring_;
+};
+
+}  // namespace experimental
+}  // namespace grpc_event_engine
+
+#endif  // GRPC_CORE_LIB_EVENT_ENGINE_POSIX_ENGINE_POSIX_ENGINE_H
@@ -0,0 +1,74 @@
+// Copyright 2022 The gRPC Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#ifndef GRPC_CORE_LIB_EVENT_ENGINE_POSIX_ENGINE_POSIX_ENGINE_CLOSURE_H
+#define GRPC_CORE_LIB_EVENT_ENGINE_POSIX_ENGINE_POSIX_ENGINE_CLOSURE_H
+
+#include <grpc/support/port_platform.h>
+
+#include <functional>
+#include <utility>
+
+#include "absl/status/status.h"
+#include "absl/utility/utility.h"
+
+#include <grpc/event_engine/event_engine.h>
+
+namespace grpc_event_engine {
+namespace posix_engine {
+
+/// An EventEngine::Closure carrying the status of the I/O operation it
+/// completes. Permanent closures are reused across operations (e.g. an
+/// endpoint's read callback); temporary ones delete themselves once run.
+class PosixEngineClosure final
+    : public grpc_event_engine::experimental::EventEngine::Closure {
+ public:
+  PosixEngineClosure() = default;
+  PosixEngineClosure(std::function<void(absl::Status)> cb, bool is_permanent)
+      : cb_(std::move(cb)), is_permanent_(is_permanent) {}
+  ~PosixEngineClosure() final = default;
+
+  void SetStatus(absl::Status status) { status_ = std::move(status); }
+
+  void Run() override {
+    // Move the status out first: a permanent closure may be re-armed (and its
+    // status overwritten) from within the callback.
+    absl::Status status = absl::exchange(status_, absl::OkStatus());
+    if (!is_permanent_) {
+      auto cb = std::move(cb_);
+      delete this;
+      cb(std::move(status));
+      return;
+    }
+    cb_(std::move(status));
+  }
+
+  static PosixEngineClosure* TestOnlyToClosure(
+      std::function<void(absl::Status)> cb) {
+    return new PosixEngineClosure(std::move(cb), false);
+  }
+  static PosixEngineClosure* ToPermanentClosure(
+      std::function<void(absl::Status)> cb) {
+    return new PosixEngineClosure(std::move(cb), true);
+  }
+
+ private:
+  std::function<void(absl::Status)> cb_;
+  bool is_permanent_ = false;
+  absl::Status status_;
+};
+
+}  // namespace posix_engine
+}  // namespace grpc_event_engine
+
+#endif  // GRPC_CORE_LIB_EVENT_ENGINE_POSIX_ENGINE_POSIX_ENGINE_CLOSURE_H
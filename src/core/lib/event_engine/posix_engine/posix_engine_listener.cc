@@ -0,0 +1,278 @@
+// Copyright 2022 The gRPC Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <grpc/support/port_platform.h>
+
+#include "src/core/lib/event_engine/posix_engine/posix_engine_listener.h"
+
+#include "src/core/lib/iomgr/port.h"
+
+#ifdef GRPC_POSIX_SOCKET_TCP
+
+#include <errno.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/memory/memory.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+
+#include <grpc/support/log.h>
+
+#include "src/core/lib/event_engine/posix_engine/io_uring_endpoint.h"
+#include "src/core/lib/event_engine/posix_engine/posix_endpoint.h"
+#include "src/core/lib/event_engine/posix_engine/posix_engine_closure.h"
+#include "src/core/lib/event_engine/posix_engine/tcp_socket_utils.h"
+#include "src/core/lib/gprpp/ref_counted.h"
+#include "src/core/lib/gprpp/sync.h"
+
+namespace grpc_event_engine {
+namespace posix_engine {
+
+namespace {
+
+using ::grpc_event_engine::experimental::EndpointConfig;
+using ::grpc_event_engine::experimental::EventEngine;
+using ::grpc_event_engine::experimental::MemoryAllocator;
+using ::grpc_event_engine::experimental::MemoryAllocatorFactory;
+
+// The state of a listener. The Listener owns one ref and every started
+// listening socket holds another until its final accept notification (the
+// one failed by shutdown) has run.
+class PosixEngineListenerImpl
+    : public grpc_core::RefCounted<PosixEngineListenerImpl> {
+ public:
+  PosixEngineListenerImpl(
+      EventEngine::Listener::AcceptCallback on_accept,
+      std::function<void(absl::Status)> on_shutdown,
+      const PosixTcpOptions& options,
+      std::unique_ptr<MemoryAllocatorFactory> memory_allocator_factory,
+      PosixEventPoller* poller, IoUringPoller* io_uring, Scheduler* scheduler)
+      : on_accept_(std::move(on_accept)),
+        on_shutdown_(std::move(on_shutdown)),
+        options_(options),
+        memory_allocator_factory_(std::move(memory_allocator_factory)),
+        poller_(poller),
+        io_uring_(io_uring),
+        scheduler_(scheduler) {}
+
+  ~PosixEngineListenerImpl() override {
+    for (auto& acceptor : acceptors_) {
+      // Sockets that were bound but never started are not owned by a handle.
+      if (acceptor->handle == nullptr) close(acceptor->fd);
+      delete acceptor->notify_on_accept;
+    }
+    scheduler_->Run(std::bind(std::move(on_shutdown_), absl::OkStatus()));
+  }
+
+  absl::StatusOr<int> Bind(const EventEngine::ResolvedAddress& addr);
+  absl::Status Start();
+  // Fails the pending accept notifications and drops the Listener's ref.
+  void TriggerShutdown();
+
+ private:
+  struct Acceptor {
+    int fd;
+    EventHandle* handle = nullptr;
+    PosixEngineClosure* notify_on_accept = nullptr;
+  };
+
+  void HandleAccept(Acceptor* acceptor, absl::Status status);
+
+  const EventEngine::Listener::AcceptCallback on_accept_;
+  std::function<void(absl::Status)> on_shutdown_;
+  const PosixTcpOptions options_;
+  const std::unique_ptr<MemoryAllocatorFactory> memory_allocator_factory_;
+  PosixEventPoller* const poller_;
+  IoUringPoller* const io_uring_;
+  Scheduler* const scheduler_;
+  grpc_core::Mutex mu_;
+  std::vector<std::unique_ptr<Acceptor>> acceptors_ ABSL_GUARDED_BY(mu_);
+  bool started_ ABSL_GUARDED_BY(mu_) = false;
+};
+
+absl::StatusOr<int> PosixEngineListenerImpl::Bind(
+    const EventEngine::ResolvedAddress& addr) {
+  grpc_core::MutexLock lock(&mu_);
+  if (started_) {
+    return absl::FailedPreconditionError(
+        "Bind cannot be called after the listener is started");
+  }
+  absl::StatusOr<int> fd = CreateNonBlockingSocket(addr.address()->sa_family);
+  if (!fd.ok()) return fd.status();
+  absl::Status status = PrepareListenerSocket(*fd, addr);
+  if (status.ok() && bind(*fd, addr.address(), addr.size()) != 0) {
+    status = PosixOSError(errno, "bind");
+  }
+  if (status.ok() && listen(*fd, SOMAXCONN) != 0) {
+    status = PosixOSError(errno, "listen");
+  }
+  absl::StatusOr<EventEngine::ResolvedAddress> bound_addr;
+  if (status.ok()) {
+    // Report the port the kernel picked if the caller asked for port 0.
+    bound_addr = LocalAddress(*fd);
+    status = bound_addr.status();
+  }
+  if (!status.ok()) {
+    close(*fd);
+    return status;
+  }
+  auto acceptor = absl::make_unique<Acceptor>();
+  acceptor->fd = *fd;
+  acceptors_.push_back(std::move(acceptor));
+  return GetSockaddrPort(*bound_addr);
+}
+
+absl::Status PosixEngineListenerImpl::Start() {
+  grpc_core::MutexLock lock(&mu_);
+  if (started_) {
+    return absl::FailedPreconditionError("Listener is already started");
+  }
+  started_ = true;
+  for (auto& acceptor : acceptors_) {
+    Acceptor* a = acceptor.get();
+    a->handle = poller_->CreateHandle(a->fd, "tcp-server-listener",
+                                      /*track_err=*/false);
+    a->notify_on_accept =
+        PosixEngineClosure::ToPermanentClosure([this, a](absl::Status status) {
+          HandleAccept(a, std::move(status));
+        });
+    Ref().release();
+    a->handle->NotifyOnRead(a->notify_on_accept);
+  }
+  return absl::OkStatus();
+}
+
+void PosixEngineListenerImpl::TriggerShutdown() {
+  {
+    grpc_core::MutexLock lock(&mu_);
+    for (auto& acceptor : acceptors_) {
+      if (acceptor->handle != nullptr) {
+        acceptor->handle->ShutdownHandle(
+            absl::CancelledError("Listener shutdown"));
+      }
+    }
+  }
+  Unref();
+}
+
+void PosixEngineListenerImpl::HandleAccept(Acceptor* acceptor,
+                                           absl::Status status) {
+  if (!status.ok()) {
+    // The listener is shutting down: this was the last notification for this
+    // socket.
+    acceptor->handle->OrphanHandle(nullptr, nullptr, "listener shutdown");
+    Unref();
+    return;
+  }
+  while (true) {
+    sockaddr_storage storage;
+    socklen_t len = sizeof(storage);
+    int fd = accept(acceptor->fd, reinterpret_cast<sockaddr*>(&storage), &len);
+    if (fd < 0) {
+      if (errno == EINTR) continue;
+      if (errno != EAGAIN && errno != EWOULDBLOCK && errno != ECONNABORTED) {
+        gpr_log(GPR_ERROR, "Failed accept: %s", strerror(errno));
+      }
+      // Wait for the next connection.
+      acceptor->handle->NotifyOnRead(acceptor->notify_on_accept);
+      return;
+    }
+    status = PrepareConnectedSocket(fd, options_);
+    if (!status.ok()) {
+      gpr_log(GPR_ERROR, "Failed to prepare accepted socket: %s",
+              status.ToString().c_str());
+      close(fd);
+      continue;
+    }
+    std::string peer_name = SockaddrToString(EventEngine::ResolvedAddress(
+        reinterpret_cast<sockaddr*>(&storage), len));
+    MemoryAllocator endpoint_allocator =
+        memory_allocator_factory_->CreateMemoryAllocator(
+            absl::StrCat("endpoint-tcp-server-connection: ", peer_name));
+    std::unique_ptr<EventEngine::Endpoint> endpoint;
+    if (io_uring_ != nullptr) {
+      endpoint =
+          CreateIoUringEndpoint(fd, io_uring_, std::move(endpoint_allocator));
+    } else {
+      EventHandle* handle = poller_->CreateHandle(
+          fd, peer_name, PosixEndpointTracksErrors(options_));
+      endpoint = CreatePosixEndpoint(handle, scheduler_,
+                                     std::move(endpoint_allocator), options_);
+    }
+    on_accept_(std::move(endpoint),
+               memory_allocator_factory_->CreateMemoryAllocator(absl::StrCat(
+                   "on-accept-tcp-server-connection: ", peer_name)));
+  }
+}
+
+class PosixEngineListener final : public EventEngine::Listener {
+ public:
+  explicit PosixEngineListener(PosixEngineListenerImpl* impl) : impl_(impl) {}
+  ~PosixEngineListener() override { impl_->TriggerShutdown(); }
+
+  absl::StatusOr<int> Bind(const EventEngine::ResolvedAddress& addr) override {
+    return impl_->Bind(addr);
+  }
+  absl::Status Start() override { return impl_->Start(); }
+
+ private:
+  PosixEngineListenerImpl* impl_;
+};
+
+}  // namespace
+
+std::unique_ptr<EventEngine::Listener> CreatePosixEngineListener(
+    EventEngine::Listener::AcceptCallback on_accept,
+    std::function<void(absl::Status)> on_shutdown,
+    const EndpointConfig& config,
+    std::unique_ptr<MemoryAllocatorFactory> memory_allocator_factory,
+    PosixEventPoller* poller, IoUringPoller* io_uring, Scheduler* scheduler) {
+  return absl::make_unique<PosixEngineListener>(new PosixEngineListenerImpl(
+      std::move(on_accept), std::move(on_shutdown),
+      TcpOptionsFromEndpointConfig(config), std::move(memory_allocator_factory),
+      poller, io_uring, scheduler));
+}
+
+}  // namespace posix_engine
+}  // namespace grpc_event_engine
+
+#else  // GRPC_POSIX_SOCKET_TCP
+
+#include <grpc/support/log.h>
+
+namespace grpc_event_engine {
+namespace posix_engine {
+
+std::unique_ptr<experimental::EventEngine::Listener> CreatePosixEngineListener(
+    experimental::EventEngine::Listener::AcceptCallback /*on_accept*/,
+    std::function<void(absl::Status)> /*on_shutdown*/,
+    const experimental::EndpointConfig& /*config*/,
+    std::unique_ptr<experimental::MemoryAllocatorFactory>
+    /*memory_allocator_factory*/,
+    PosixEventPoller* /*poller*/, IoUringPoller* /*io_uring*/,
+    Scheduler* /*scheduler*/) {
+  gpr_log(GPR_ERROR, "Posix listeners are not supported on this platform");
+  abort();
+}
+
+}  // namespace posix_engine
+}  // namespace grpc_event_engine
+
+#endif  // GRPC_POSIX_SOCKET_TCP
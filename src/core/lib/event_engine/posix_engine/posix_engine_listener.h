@@ -0,0 +1,51 @@
+// Copyright 2022 The gRPC Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#ifndef GRPC_CORE_LIB_EVENT_ENGINE_POSIX_ENGINE_POSIX_ENGINE_LISTENER_H
+#define GRPC_CORE_LIB_EVENT_ENGINE_POSIX_ENGINE_POSIX_ENGINE_LISTENER_H
+
+#include <grpc/support/port_platform.h>
+
+#include <functional>
+#include <memory>
+
+#include "absl/status/status.h"
+
+#include <grpc/event_engine/endpoint_config.h>
+#include <grpc/event_engine/event_engine.h>
+#include <grpc/event_engine/memory_allocator.h>
+
+#include "src/core/lib/event_engine/posix_engine/event_poller.h"
+
+namespace grpc_event_engine {
+namespace posix_engine {
+
+class IoUringPoller;
+
+/// Creates a Listener whose sockets are polled by \a poller. Accepted
+/// connections are wrapped in posix endpoints that run their callbacks on
+/// \a scheduler, or in io_uring endpoints if \a io_uring is not null.
+/// \a on_shutdown runs once the listener has been destroyed and every accept
+/// in progress has finished.
+std::unique_ptr<experimental::EventEngine::Listener> CreatePosixEngineListener(
+    experimental::EventEngine::Listener::AcceptCallback on_accept,
+    std::function<void(absl::Status)> on_shutdown,
+    const experimental::EndpointConfig& config,
+    std::unique_ptr<experimental::MemoryAllocatorFactory>
+        memory_allocator_factory,
+    PosixEventPoller* poller, IoUringPoller* io_uring, Scheduler* scheduler);
+
+}  // namespace posix_engine
+}  // namespace grpc_event_engine
+
+#endif  // GRPC_CORE_LIB_EVENT_ENGINE_POSIX_ENGINE_POSIX_ENGINE_LISTENER_H
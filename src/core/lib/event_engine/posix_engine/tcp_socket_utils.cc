@@ -0,0 +1,251 @@
+// Copyright 2022 The gRPC Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <grpc/support/port_platform.h>
+
+#include "src/core/lib/event_engine/posix_engine/tcp_socket_utils.h"
+
+#include "src/core/lib/iomgr/port.h"
+
+#ifdef GRPC_POSIX_SOCKET_TCP
+
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <climits>
+#include <utility>
+
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
+#include "absl/types/variant.h"
+
+#include <grpc/impl/codegen/grpc_types.h>
+#include <grpc/support/log.h>
+
+#include "src/core/lib/gpr/useful.h"
+
+namespace grpc_event_engine {
+namespace posix_engine {
+
+using ::grpc_event_engine::experimental::EndpointConfig;
+using ::grpc_event_engine::experimental::EventEngine;
+
+constexpr int PosixTcpOptions::kDefaultReadChunkSize;
+constexpr int PosixTcpOptions::kDefaultMinReadChunksize;
+constexpr int PosixTcpOptions::kDefaultMaxReadChunksize;
+constexpr int PosixTcpOptions::kZerocpTxEnabledDefault;
+constexpr int PosixTcpOptions::kMaxChunkSize;
+constexpr int PosixTcpOptions::kDefaultMaxSends;
+constexpr size_t PosixTcpOptions::kDefaultSendBytesThreshold;
+
+namespace {
+
+int AdjustValue(int default_value, int min_value, int max_value,
+                const EndpointConfig::Setting& setting) {
+  const int* value = absl::get_if<int>(&setting);
+  if (value == nullptr) return default_value;
+  if (*value < min_value || *value > max_value) return default_value;
+  return *value;
+}
+
+absl::Status SetSocketOption(int fd, int level, int option, int value,
+                             const char* name) {
+  if (setsockopt(fd, level, option, &value, sizeof(value)) != 0) {
+    return PosixOSError(errno, name);
+  }
+  return absl::OkStatus();
+}
+
+absl::Status SetNonBlockingAndCloexec(int fd) {
+  int flags = fcntl(fd, F_GETFL, 0);
+  if (flags < 0) return PosixOSError(errno, "fcntl");
+  if (fcntl(fd, F_SETFL, flags | O_NONBLOCK) != 0) {
+    return PosixOSError(errno, "fcntl");
+  }
+  flags = fcntl(fd, F_GETFD, 0);
+  if (flags < 0) return PosixOSError(errno, "fcntl");
+  if (fcntl(fd, F_SETFD, flags | FD_CLOEXEC) != 0) {
+    return PosixOSError(errno, "fcntl");
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace
+
+PosixTcpOptions TcpOptionsFromEndpointConfig(const EndpointConfig& config) {
+  PosixTcpOptions options;
+  options.tcp_read_chunk_size = AdjustValue(
+      PosixTcpOptions::kDefaultReadChunkSize, 1, PosixTcpOptions::kMaxChunkSize,
+      config.Get(GRPC_ARG_TCP_READ_CHUNK_SIZE));
+  options.tcp_min_read_chunk_size =
+      AdjustValue(PosixTcpOptions::kDefaultMinReadChunksize, 1,
+                  PosixTcpOptions::kMaxChunkSize,
+                  config.Get(GRPC_ARG_TCP_MIN_READ_CHUNK_SIZE));
+  options.tcp_max_read_chunk_size =
+      AdjustValue(PosixTcpOptions::kDefaultMaxReadChunksize, 1,
+                  PosixTcpOptions::kMaxChunkSize,
+                  config.Get(GRPC_ARG_TCP_MAX_READ_CHUNK_SIZE));
+  options.tcp_tx_zerocopy_send_bytes_threshold =
+      AdjustValue(PosixTcpOptions::kDefaultSendBytesThreshold, 0, INT_MAX,
+                  config.Get(GRPC_ARG_TCP_TX_ZEROCOPY_SEND_BYTES_THRESHOLD));
+  options.tcp_tx_zerocopy_max_simultaneous_sends =
+      AdjustValue(PosixTcpOptions::kDefaultMaxSends, 0, INT_MAX,
+                  config.Get(GRPC_ARG_TCP_TX_ZEROCOPY_MAX_SIMULT_SENDS));
+  options.tcp_tx_zero_copy_enabled =
+      AdjustValue(PosixTcpOptions::kZerocpTxEnabledDefault, 0, 1,
+                  config.Get(GRPC_ARG_TCP_TX_ZEROCOPY_ENABLED)) != 0;
+  options.keep_alive_time_ms =
+      AdjustValue(0, 1, INT_MAX, config.Get(GRPC_ARG_KEEPALIVE_TIME_MS));
+  options.keep_alive_timeout_ms =
+      AdjustValue(0, 1, INT_MAX, config.Get(GRPC_ARG_KEEPALIVE_TIMEOUT_MS));
+  if (options.tcp_min_read_chunk_size > options.tcp_max_read_chunk_size) {
+    std::swap(options.tcp_min_read_chunk_size,
+              options.tcp_max_read_chunk_size);
+  }
+  options.tcp_read_chunk_size =
+      grpc_core::Clamp(options.tcp_read_chunk_size,
+                       options.tcp_min_read_chunk_size,
+                       options.tcp_max_read_chunk_size);
+  return options;
+}
+
+absl::Status PosixOSError(int err, const char* call) {
+  return absl::UnknownError(absl::StrCat(call, ": ", strerror(err)));
+}
+
+absl::StatusOr<int> CreateNonBlockingSocket(int family) {
+  int fd = socket(family, SOCK_STREAM, 0);
+  if (fd < 0) return PosixOSError(errno, "socket");
+  absl::Status status = SetNonBlockingAndCloexec(fd);
+  if (!status.ok()) {
+    close(fd);
+    return status;
+  }
+  return fd;
+}
+
+absl::Status PrepareConnectedSocket(int fd, const PosixTcpOptions& options) {
+  absl::Status status = SetNonBlockingAndCloexec(fd);
+  if (!status.ok()) return status;
+  status = SetSocketOption(fd, IPPROTO_TCP, TCP_NODELAY, 1, "TCP_NODELAY");
+  if (!status.ok()) return status;
+#ifdef GRPC_HAVE_SO_NOSIGPIPE
+  status = SetSocketOption(fd, SOL_SOCKET, SO_NOSIGPIPE, 1, "SO_NOSIGPIPE");
+  if (!status.ok()) return status;
+#endif
+  if (options.keep_alive_time_ms > 0) {
+    // Failures are not fatal: keepalive is advisory, and gRPC has its own.
+    SetSocketOption(fd, SOL_SOCKET, SO_KEEPALIVE, 1, "SO_KEEPALIVE")
+        .IgnoreError();
+#ifdef TCP_KEEPIDLE
+    SetSocketOption(fd, IPPROTO_TCP, TCP_KEEPIDLE,
+                    std::max(1, options.keep_alive_time_ms / 1000),
+                    "TCP_KEEPIDLE")
+        .IgnoreError();
+#endif
+#ifdef TCP_USER_TIMEOUT
+    if (options.keep_alive_timeout_ms > 0) {
+      SetSocketOption(fd, IPPROTO_TCP, TCP_USER_TIMEOUT,
+                      options.keep_alive_timeout_ms, "TCP_USER_TIMEOUT")
+          .IgnoreError();
+    }
+#endif
+  }
+  return absl::OkStatus();
+}
+
+absl::Status PrepareListenerSocket(int fd,
+                                   const EventEngine::ResolvedAddress& addr) {
+  absl::Status status = SetNonBlockingAndCloexec(fd);
+  if (!status.ok()) return status;
+  status = SetSocketOption(fd, SOL_SOCKET, SO_REUSEADDR, 1, "SO_REUSEADDR");
+  if (!status.ok()) return status;
+  if (addr.address()->sa_family == AF_INET6) {
+    // Accept IPv4-mapped connections on IPv6 sockets where the platform allows
+    // it; failure just leaves the socket v6-only.
+    SetSocketOption(fd, IPPROTO_IPV6, IPV6_V6ONLY, 0, "IPV6_V6ONLY")
+        .IgnoreError();
+  }
+  return SetSocketOption(fd, IPPROTO_TCP, TCP_NODELAY, 1, "TCP_NODELAY");
+}
+
+bool IsIpv6Wildcard(const EventEngine::ResolvedAddress& addr) {
+  if (addr.address()->sa_family != AF_INET6) return false;
+  const auto* addr6 = reinterpret_cast<const sockaddr_in6*>(addr.address());
+  return memcmp(&addr6->sin6_addr, &in6addr_any, sizeof(in6addr_any)) == 0;
+}
+
+int GetSockaddrPort(const EventEngine::ResolvedAddress& addr) {
+  switch (addr.address()->sa_family) {
+    case AF_INET:
+      return ntohs(
+          reinterpret_cast<const sockaddr_in*>(addr.address())->sin_port);
+    case AF_INET6:
+      return ntohs(
+          reinterpret_cast<const sockaddr_in6*>(addr.address())->sin6_port);
+    default:
+      return -1;
+  }
+}
+
+std::string SockaddrToString(const EventEngine::ResolvedAddress& addr) {
+  char buf[INET6_ADDRSTRLEN];
+  switch (addr.address()->sa_family) {
+    case AF_INET: {
+      const auto* a = reinterpret_cast<const sockaddr_in*>(addr.address());
+      if (inet_ntop(AF_INET, &a->sin_addr, buf, sizeof(buf)) == nullptr) break;
+      return absl::StrFormat("%s:%d", buf, ntohs(a->sin_port));
+    }
+    case AF_INET6: {
+      const auto* a = reinterpret_cast<const sockaddr_in6*>(addr.address());
+      if (inet_ntop(AF_INET6, &a->sin6_addr, buf, sizeof(buf)) == nullptr) {
+        break;
+      }
+      return absl::StrFormat("[%s]:%d", buf, ntohs(a->sin6_port));
+    }
+    default:
+      break;
+  }
+  return absl::StrFormat("(sockaddr family=%d)", addr.address()->sa_family);
+}
+
+absl::StatusOr<EventEngine::ResolvedAddress> LocalAddress(int fd) {
+  sockaddr_storage storage;
+  socklen_t len = sizeof(storage);
+  if (getsockname(fd, reinterpret_cast<sockaddr*>(&storage), &len) != 0) {
+    return PosixOSError(errno, "getsockname");
+  }
+  return EventEngine::ResolvedAddress(reinterpret_cast<sockaddr*>(&storage),
+                                      len);
+}
+
+absl::StatusOr<EventEngine::ResolvedAddress> PeerAddress(int fd) {
+  sockaddr_storage storage;
+  socklen_t len = sizeof(storage);
+  if (getpeername(fd, reinterpret_cast<sockaddr*>(&storage), &len) != 0) {
+    return PosixOSError(errno, "getpeername");
+  }
+  return EventEngine::ResolvedAddress(reinterpret_cast<sockaddr*>(&storage),
+                                      len);
+}
+
+}  // namespace posix_engine
+}  // namespace grpc_event_engine
+
+#endif  // GRPC_POSIX_SOCKET_TCP
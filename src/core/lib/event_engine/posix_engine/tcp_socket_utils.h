@@ -0,0 +1,86 @@
+// Copyright 2022 The gRPC Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#ifndef GRPC_CORE_LIB_EVENT_ENGINE_POSIX_ENGINE_TCP_SOCKET_UTILS_H
+#define GRPC_CORE_LIB_EVENT_ENGINE_POSIX_ENGINE_TCP_SOCKET_UTILS_H
+
+#include <grpc/support/port_platform.h>
+
+#include <string>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+
+#include <grpc/event_engine/endpoint_config.h>
+#include <grpc/event_engine/event_engine.h>
+
+namespace grpc_event_engine {
+namespace posix_engine {
+
+/// TCP tuning knobs, read from the channel args carried by an EndpointConfig.
+struct PosixTcpOptions {
+  static constexpr int kDefaultReadChunkSize = 8192;
+  static constexpr int kDefaultMinReadChunksize = 256;
+  static constexpr int kDefaultMaxReadChunksize = 4 * 1024 * 1024;
+  static constexpr int kZerocpTxEnabledDefault = 0;
+  static constexpr int kMaxChunkSize = 32 * 1024 * 1024;
+  static constexpr int kDefaultMaxSends = 4;
+  static constexpr size_t kDefaultSendBytesThreshold = 16 * 1024;
+
+  int tcp_read_chunk_size = kDefaultReadChunkSize;
+  int tcp_min_read_chunk_size = kDefaultMinReadChunksize;
+  int tcp_max_read_chunk_size = kDefaultMaxReadChunksize;
+  int tcp_tx_zerocopy_send_bytes_threshold = kDefaultSendBytesThreshold;
+  int tcp_tx_zerocopy_max_simultaneous_sends = kDefaultMaxSends;
+  bool tcp_tx_zero_copy_enabled = kZerocpTxEnabledDefault;
+  int keep_alive_time_ms = 0;
+  int keep_alive_timeout_ms = 0;
+};
+
+PosixTcpOptions TcpOptionsFromEndpointConfig(
+    const experimental::EndpointConfig& config);
+
+/// Creates a non-blocking, close-on-exec stream socket for \a family.
+absl::StatusOr<int> CreateNonBlockingSocket(int family);
+
+/// Applies the per-connection options shared by accepted and connected
+/// sockets: non-blocking, close-on-exec, TCP_NODELAY, keepalive, and no
+/// SIGPIPE.
+absl::Status PrepareConnectedSocket(int fd, const PosixTcpOptions& options);
+
+/// Configures a socket for listening on \a addr: address reuse, dual-stack
+/// where applicable, and a non-blocking accept.
+absl::Status PrepareListenerSocket(
+    int fd, const experimental::EventEngine::ResolvedAddress& addr);
+
+/// Returns true if \a addr is an IPv6 wildcard address ("[::]").
+bool IsIpv6Wildcard(const experimental::EventEngine::ResolvedAddress& addr);
+
+/// Returns the port of an AF_INET or AF_INET6 address, or -1.
+int GetSockaddrPort(const experimental::EventEngine::ResolvedAddress& addr);
+
+/// Returns "ip:port" (or "[ip]:port" for IPv6) for \a addr.
+std::string SockaddrToString(
+    const experimental::EventEngine::ResolvedAddress& addr);
+
+/// Returns the local or peer address of a connected socket.
+absl::StatusOr<experimental::EventEngine::ResolvedAddress> LocalAddress(int fd);
+absl::StatusOr<experimental::EventEngine::ResolvedAddress> PeerAddress(int fd);
+
+/// Converts errno \a err from \a call into an absl::Status.
+absl::Status PosixOSError(int err, const char* call);
+
+}  // namespace posix_engine
+}  // namespace grpc_event_engine
+
+#endif  // GRPC_CORE_LIB_EVENT_ENGINE_POSIX_ENGINE_TCP_SOCKET_UTILS_H
@@ -0,0 +1,107 @@
+// Copyright 2022 The gRPC Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <grpc/support/port_platform.h>
+
+#include "src/core/lib/event_engine/posix_engine/timer.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "absl/memory/memory.h"
+
+#include <grpc/support/cpu.h>
+
+#include "src/core/lib/gpr/useful.h"
+
+namespace grpc_event_engine {
+namespace posix_engine {
+
+namespace {
+constexpr int64_t kInfiniteMillis = std::numeric_limits<int64_t>::max();
+
+int64_t ToMillis(grpc_core::Timestamp t) {
+  return static_cast<int64_t>(t.milliseconds_after_process_epoch());
+}
+
+// Lowers 'value' to 'candidate' if candidate is smaller. Returns true if it
+// did.
+bool AtomicMin(std::atomic<int64_t>* value, int64_t candidate) {
+  int64_t current = value->load(std::memory_order_relaxed);
+  while (candidate < current) {
+    if (value->compare_exchange_weak(current, candidate,
+                                     std::memory_order_relaxed)) {
+      return true;
+    }
+  }
+  return false;
+}
+}  // namespace
+
+TimerList::TimerList(TimerListHost* host)
+    : host_(host),
+      num_shards_(grpc_core::Clamp(2 * gpr_cpu_num_cores(), 1u, 32u)),
+      next_check_(kInfiniteMillis) {
+  const int64_t now = ToMillis(host_->Now());
+  shards_.reserve(num_shards_);
+  for (size_t i = 0; i < num_shards_; i++) {
+    shards_.push_back(absl::make_unique<Shard>(now));
+  }
+}
+
+void TimerList::TimerInit(Timer* timer, grpc_core::Timestamp deadline,
+                          experimental::EventEngine::Closure* closure) {
+  timer->closure = closure;
+  timer->deadline = ToMillis(deadline);
+  timer->shard =
+      static_cast<uint32_t>(grpc_core::HashPointer(timer, num_shards_));
+  Shard* shard = shards_[timer->shard].get();
+  {
+    grpc_core::MutexLock lock(&shard->mu);
+    // A timer that is already due expires on the shard's next tick, which
+    // keeps it cancellable until the timer thread picks it up.
+    timer->deadline = std::max(timer->deadline, shard->wheel.now() + 1);
+    GPR_ASSERT(shard->wheel.Add(timer));
+  }
+  if (AtomicMin(&next_check_, timer->deadline)) host_->Kick();
+}
+
+bool TimerList::TimerCancel(Timer* timer) {
+  Shard* shard = shards_[timer->shard].get();
+  grpc_core::MutexLock lock(&shard->mu);
+  return shard->wheel.Remove(timer);
+}
+
+std::vector<experimental::EventEngine::Closure*> TimerList::TimerCheck(
+    grpc_core::Timestamp* next) {
+  // Anything added while the shards are scanned must kick the host again, so
+  // forget the previous promise before looking.
+  next_check_.store(kInfiniteMillis, std::memory_order_relaxed);
+  const int64_t now = ToMillis(host_->Now());
+  int64_t min_next = kInfiniteMillis;
+  std::vector<experimental::EventEngine::Closure*> expired;
+  for (auto& shard : shards_) {
+    grpc_core::MutexLock lock(&shard->mu);
+    shard->wheel.Advance(now, [&expired](Timer* timer) {
+      expired.push_back(timer->closure);
+    });
+    min_next = std::min(min_next, shard->wheel.NextWakeupTick());
+  }
+  AtomicMin(&next_check_, min_next);
+  *next = grpc_core::Timestamp::FromMillisecondsAfterProcessEpoch(
+      next_check_.load(std::memory_order_relaxed));
+  return expired;
+}
+
+}  // namespace posix_engine
+}  // namespace grpc_event_engine
@@ -0,0 +1,110 @@
+// Copyright 2022 The gRPC Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#ifndef GRPC_CORE_LIB_EVENT_ENGINE_POSIX_ENGINE_TIMER_H
+#define GRPC_CORE_LIB_EVENT_ENGINE_POSIX_ENGINE_TIMER_H
+
+#include <grpc/support/port_platform.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+
+#include <grpc/event_engine/event_engine.h>
+
+#include "src/core/lib/gprpp/sync.h"
+#include "src/core/lib/gprpp/time.h"
+#include "src/core/lib/gprpp/timer_wheel.h"
+
+namespace grpc_event_engine {
+namespace posix_engine {
+
+struct Timer {
+  int64_t deadline;
+  Timer* next;
+  Timer* prev;
+  uint32_t wheel_slot;
+  uint32_t shard;
+  experimental::EventEngine::Closure* closure;
+};
+
+/// Supplies time and wakeups to a TimerList.
+class TimerListHost {
+ public:
+  /// Returns the current time.
+  virtual grpc_core::Timestamp Now() = 0;
+  /// Schedules a call to TimerCheck() as soon as possible: a timer was added
+  /// that expires before the previously reported next deadline.
+  virtual void Kick() = 0;
+
+ protected:
+  ~TimerListHost() = default;
+};
+
+/// A set of pending timers, sharded so that unrelated TimerInit/TimerCancel
+/// calls do not contend. Each shard is a hierarchical timing wheel with
+/// millisecond ticks, so both operations are O(1).
+class TimerList {
+ public:
+  explicit TimerList(TimerListHost* host);
+
+  TimerList(const TimerList&) = delete;
+  TimerList& operator=(const TimerList&) = delete;
+
+  /// Arranges for \a closure to be returned by a TimerCheck() at or after
+  /// \a deadline. \a timer must stay alive until the closure is returned or
+  /// TimerCancel() returns true.
+  void TimerInit(Timer* timer, grpc_core::Timestamp deadline,
+                 experimental::EventEngine::Closure* closure);
+
+  /// Cancels a pending timer. Returns false if the timer already expired (its
+  /// closure was, or is about to be, returned by TimerCheck()).
+  bool TimerCancel(Timer* timer);
+
+  /// Returns the closures of all timers that expired, and sets \a *next to the
+  /// time at which TimerCheck() should be called again.
+  std::vector<experimental::EventEngine::Closure*> TimerCheck(
+      grpc_core::Timestamp* next);
+
+ private:
+  struct TimerTraits {
+    static int64_t Deadline(const Timer* t) { return t->deadline; }
+    static Timer*& Next(Timer* t) { return t->next; }
+    static Timer*& Prev(Timer* t) { return t->prev; }
+    static uint32_t& Slot(Timer* t) { return t->wheel_slot; }
+  };
+  using Wheel = grpc_core::TimerWheel<Timer, TimerTraits>;
+
+  struct Shard {
+    explicit Shard(int64_t now) : wheel(now) {}
+    grpc_core::Mutex mu;
+    Wheel wheel ABSL_GUARDED_BY(mu);
+  };
+
+  TimerListHost* const host_;
+  const size_t num_shards_;
+  std::vector<std::unique_ptr<Shard>> shards_;
+  // The earliest time any caller of TimerCheck() was told to come back. A
+  // timer that expires before it needs a kick.
+  std::atomic<int64_t> next_check_;
+};
+
+}  // namespace posix_engine
+}  // namespace grpc_event_engine
+
+#endif  // GRPC_CORE_LIB_EVENT_ENGINE_POSIX_ENGINE_TIMER_H
@@ -0,0 +1,89 @@
+// Copyright 2022 The gRPC Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <grpc/support/port_platform.h>
+
+#include "src/core/lib/event_engine/posix_engine/timer_manager.h"
+
+#include <vector>
+
+#include <grpc/support/time.h>
+
+namespace grpc_event_engine {
+namespace posix_engine {
+
+TimerManager::TimerManager(Scheduler* scheduler)
+    : scheduler_(scheduler), timer_list_(this) {
+  thread_ = grpc_core::Thread("timer_manager", &TimerManager::ThreadBody, this);
+  thread_.Start();
+}
+
+TimerManager::~TimerManager() {
+  {
+    grpc_core::MutexLock lock(&mu_);
+    shutdown_ = true;
+    cv_.Signal();
+  }
+  thread_.Join();
+}
+
+grpc_core::Timestamp TimerManager::Now() {
+  return grpc_core::Timestamp::FromTimespecRoundDown(
+      gpr_now(GPR_CLOCK_MONOTONIC));
+}
+
+void TimerManager::TimerInit(Timer* timer, grpc_core::Timestamp deadline,
+                             experimental::EventEngine::Closure* closure) {
+  timer_list_.TimerInit(timer, deadline, closure);
+}
+
+bool TimerManager::TimerCancel(Timer* timer) {
+  return timer_list_.TimerCancel(timer);
+}
+
+void TimerManager::Kick() {
+  grpc_core::MutexLock lock(&mu_);
+  kicked_ = true;
+  cv_.Signal();
+}
+
+void TimerManager::ThreadBody(void* arg) {
+  static_cast<TimerManager*>(arg)->MainLoop();
+}
+
+void TimerManager::MainLoop() {
+  while (true) {
+    grpc_core::Timestamp next;
+    std::vector<experimental::EventEngine::Closure*> expired =
+        timer_list_.TimerCheck(&next);
+    for (auto* closure : expired) scheduler_->Run(closure);
+    grpc_core::MutexLock lock(&mu_);
+    if (shutdown_) return;
+    if (kicked_) {
+      kicked_ = false;
+      continue;
+    }
+    if (next == grpc_core::Timestamp::InfFuture()) {
+      cv_.Wait(&mu_);
+    } else {
+      grpc_core::Duration timeout = next - Now();
+      if (timeout > grpc_core::Duration::Zero()) {
+        cv_.WaitWithTimeout(&mu_, absl::Milliseconds(timeout.millis()));
+      }
+    }
+    kicked_ = false;
+  }
+}
+
+}  // namespace posix_engine
+}  // namespace grpc_event_engine
@@ -0,0 +1,161 @@
+// Copyright 2022 The gRPC Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <grpc/support/port_platform.h>
+
+#include "src/core/lib/event_engine/thread_pool.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "absl/memory/memory.h"
+
+#include <grpc/support/cpu.h>
+#include <grpc/support/log.h>
+
+#include "src/core/lib/gpr/tls.h"
+
+namespace grpc_event_engine {
+namespace experimental {
+
+namespace {
+// The pool (and worker index) the current thread belongs to, if any.
+GPR_THREAD_LOCAL(const ThreadPool*) g_current_pool = nullptr;
+GPR_THREAD_LOCAL(size_t) g_worker_index = 0;
+
+struct ThreadArg {
+  ThreadPool* pool;
+  size_t index;
+};
+}  // namespace
+
+ThreadPool::ThreadPool(int thread_count) {
+  if (thread_count <= 0) {
+    thread_count = std::max(2u, gpr_cpu_num_cores());
+  }
+  workers_.reserve(thread_count);
+  for (int i = 0; i < thread_count; i++) {
+    workers_.push_back(absl::make_unique<Worker>());
+  }
+  for (size_t i = 0; i < workers_.size(); i++) {
+    workers_[i]->thread = grpc_core::Thread(
+        "event_engine", &ThreadPool::ThreadBody, new ThreadArg{this, i});
+    workers_[i]->thread.Start();
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  GPR_ASSERT(!IsThreadPoolThread());
+  {
+    grpc_core::MutexLock lock(&mu_);
+    shutdown_ = true;
+    cv_.SignalAll();
+  }
+  for (auto& worker : workers_) {
+    worker->thread.Join();
+  }
+}
+
+void ThreadPool::ThreadBody(void* arg) {
+  auto* thread_arg = static_cast<ThreadArg*>(arg);
+  ThreadPool* pool = thread_arg->pool;
+  size_t index = thread_arg->index;
+  delete thread_arg;
+  g_current_pool = pool;
+  g_worker_index = index;
+  pool->Run(index);
+  g_current_pool = nullptr;
+}
+
+bool ThreadPool::IsThreadPoolThread() const { return g_current_pool == this; }
+
+void ThreadPool::Add(std::function<void()> callback) {
+  pending_.fetch_add(1, std::memory_order_relaxed);
+  if (IsThreadPoolThread()) {
+    Worker* worker = workers_[g_worker_index].get();
+    {
+      grpc_core::MutexLock lock(&worker->mu);
+      worker->queue.push_back(std::move(callback));
+    }
+    // The producing worker will get to this callback eventually, but an idle
+    // peer can steal it sooner.
+    WakeIdleWorker();
+    return;
+  }
+  grpc_core::MutexLock lock(&mu_);
+  shared_queue_.push_back(std::move(callback));
+  if (idle_workers_ > 0) cv_.Signal();
+}
+
+void ThreadPool::WakeIdleWorker() {
+  grpc_core::MutexLock lock(&mu_);
+  if (idle_workers_ > 0) cv_.Signal();
+}
+
+bool ThreadPool::PopLocal(size_t index, std::function<void()>* callback) {
+  Worker* worker = workers_[index].get();
+  grpc_core::MutexLock lock(&worker->mu);
+  if (worker->queue.empty()) return false;
+  *callback = std::move(worker->queue.back());
+  worker->queue.pop_back();
+  return true;
+}
+
+bool ThreadPool::PopShared(std::function<void()>* callback) {
+  grpc_core::MutexLock lock(&mu_);
+  if (shared_queue_.empty()) return false;
+  *callback = std::move(shared_queue_.front());
+  shared_queue_.pop_front();
+  return true;
+}
+
+bool ThreadPool::Steal(size_t thief, std::function<void()>* callback) {
+  const size_t n = workers_.size();
+  for (size_t i = 1; i < n; i++) {
+    Worker* victim = workers_[(thief + i) % n].get();
+    grpc_core::MutexLock lock(&victim->mu);
+    if (victim->queue.empty()) continue;
+    *callback = std::move(victim->queue.front());
+    victim->queue.pop_front();
+    return true;
+  }
+  return false;
+}
+
+void ThreadPool::Run(size_t index) {
+  std::function<void()> callback;
+  while (true) {
+    if (PopLocal(index, &callback) || PopShared(&callback) ||
+        Steal(index, &callback)) {
+      pending_.fetch_sub(1, std::memory_order_relaxed);
+      callback();
+      callback = nullptr;
+      continue;
+    }
+    grpc_core::MutexLock lock(&mu_);
+    if (!shared_queue_.empty()) continue;
+    if (pending_.load(std::memory_order_relaxed) > 0) {
+      // Work is sitting on some other worker's local queue; go steal it.
+      continue;
+    }
+    if (shutdown_) return;
+    // Add() bumps pending_ before taking mu_ to look for idle workers, so a
+    // wakeup cannot be lost between the check above and this wait.
+    ++idle_workers_;
+    cv_.Wait(&mu_);
+    --idle_workers_;
+  }
+}
+
+}  // namespace experimental
+}  // namespace grpc_event_engine
@@ -0,0 +1,92 @@
+// Copyright 2022 The gRPC Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#ifndef GRPC_CORE_LIB_EVENT_ENGINE_THREAD_POOL_H
+#define GRPC_CORE_LIB_EVENT_ENGINE_THREAD_POOL_H
+
+#include <grpc/support/port_platform.h>
+
+#include <stddef.h>
+
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+
+#include "src/core/lib/gprpp/sync.h"
+#include "src/core/lib/gprpp/thd.h"
+
+namespace grpc_event_engine {
+namespace experimental {
+
+/// A fixed-size, work-stealing thread pool.
+///
+/// Each worker owns a local queue. Callbacks added from a worker thread are
+/// pushed onto that worker's queue and popped LIFO, so that continuations tend
+/// to run on the thread (and the cache) that produced them. Callbacks added
+/// from any other thread go to a shared queue. A worker that runs dry first
+/// drains the shared queue, then steals the oldest entries from its peers,
+/// and only then goes to sleep.
+class ThreadPool final {
+ public:
+  /// Creates a pool with \a thread_count workers. A value of zero selects a
+  /// default based on the number of cores.
+  explicit ThreadPool(int thread_count = 0);
+  /// Runs every callback that was already queued, then joins all workers.
+  /// Must not be called from a worker thread.
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  /// Schedules \a callback to run on some worker thread.
+  void Add(std::function<void()> callback);
+
+  /// Returns true if the caller is one of this pool's worker threads.
+  bool IsThreadPoolThread() const;
+
+  /// Returns the number of worker threads.
+  size_t thread_count() const { return workers_.size(); }
+
+ private:
+  struct Worker {
+    grpc_core::Mutex mu;
+    std::deque<std::function<void()>> queue ABSL_GUARDED_BY(mu);
+    grpc_core::Thread thread;
+  };
+
+  static void ThreadBody(void* arg);
+  void Run(size_t index);
+  bool PopLocal(size_t index, std::function<void()>* callback);
+  bool PopShared(std::function<void()>* callback);
+  bool Steal(size_t thief, std::function<void()>* callback);
+  void WakeIdleWorker();
+
+  std::vector<std::unique_ptr<Worker>> workers_;
+  grpc_core::Mutex mu_;
+  grpc_core::CondVar cv_;
+  std::deque<std::function<void()>> shared_queue_ ABSL_GUARDED_BY(mu_);
+  size_t idle_workers_ ABSL_GUARDED_BY(mu_) = 0;
+  bool shutdown_ ABSL_GUARDED_BY(mu_) = false;
+  // Number of callbacks queued on any queue. Lets an idle worker decide
+  // whether to sleep without taking every worker's lock.
+  std::atomic<size_t> pending_{0};
+};
+
+}  // namespace experimental
+}  // namespace grpc_event_engine
+
+#endif  // GRPC_CORE_LIB_EVENT_ENGINE_THREAD_POOL_H
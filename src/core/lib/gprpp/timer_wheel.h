@@ -0,0 +1,277 @@
+// Copyright 2022 gRPC authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GRPC_CORE_LIB_GPRPP_TIMER_WHEEL_H
+#define GRPC_CORE_LIB_GPRPP_TIMER_WHEEL_H
+
+#include <grpc/support/port_platform.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <limits>
+
+#include "absl/numeric/bits.h"
+
+#include <grpc/support/log.h>
+
+namespace grpc_core {
+
+// A hierarchical timing wheel.
+//
+// Timers are intrusive: the wheel never allocates, it only links nodes
+// together. Insertion and cancellation are O(1); advancing the wheel costs
+// O(1) per expired timer plus an amortized cascade cost as timers migrate from
+// coarse levels to finer ones.
+//
+// Time is measured in abstract integer ticks (gRPC uses milliseconds). The
+// wheel has kLevels levels of kSlots slots each: level L covers deadlines that
+// differ from the current time only in bits [8L, 8L+8). Deadlines further away
+// than the last level are kept on an overflow list that is redistributed once
+// per full rotation of the wheel.
+//
+// NodeTraits must provide:
+//   static int64_t Deadline(const Node* n);
+//   static Node*& Next(Node* n);
+//   static Node*& Prev(Node* n);
+//   static uint32_t& Slot(Node* n);
+// Slot() is owned by the wheel while a node is linked, and is set to
+// kNotInWheel otherwise.
+//
+// This class is not thread safe: callers provide external synchronization.
+template <typename Node, typename NodeTraits>
+class TimerWheel {
+ public:
+  static constexpr uint32_t kNotInWheel = std::numeric_limits<uint32_t>::max();
+  static constexpr int kSlotBits = 8;
+  static constexpr int kLevels = 4;
+  static constexpr uint32_t kSlots = 1u << kSlotBits;
+  static constexpr int64_t kInfiniteTicks = std::numeric_limits<int64_t>::max();
+
+  explicit TimerWheel(int64_t now = 0) : now_(now) {
+    for (auto& head : heads_) head = nullptr;
+    for (auto& word : level0_occupied_) word = 0;
+  }
+
+  TimerWheel(const TimerWheel&) = delete;
+  TimerWheel& operator=(const TimerWheel&) = delete;
+
+  // The tick up to which all expired timers have been returned by Advance().
+  int64_t now() const { return now_; }
+  // Number of timers currently linked into the wheel.
+  size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+
+  // Link \a node into the wheel. Returns false (and does not link the node) if
+  // its deadline is not after now(), in which case the caller should treat the
+  // timer as already expired.
+  bool Add(Node* node) {
+    if (NodeTraits::Deadline(node) <= now_) {
+      NodeTraits::Slot(node) = kNotInWheel;
+      return false;
+    }
+    Link(node);
+    ++size_;
+    return true;
+  }
+
+  // Unlink \a node from the wheel. Returns false if the node was not linked
+  // (it already expired, or was never added).
+  bool Remove(Node* node) {
+    uint32_t slot = NodeTraits::Slot(node);
+    if (slot == kNotInWheel) return false;
+    Unlink(node, slot);
+    --size_;
+    return true;
+  }
+
+  // Advance the wheel to \a now, invoking \a on_expired(Node*) for every timer
+  // whose deadline is <= now. Nodes are unlinked before the callback runs. The
+  // callback must not modify the wheel; callers typically collect the expired
+  // nodes and run them after releasing their lock.
+  template <typename F>
+  void Advance(int64_t now, F on_expired) {
+    while (now_ < now) {
+      if (size_ == 0) {
+        now_ = now;
+        return;
+      }
+      int64_t next = NextInterestingTick();
+      if (next > now) {
+        now_ = now;
+        return;
+      }
+      now_ = next;
+      Cascade();
+      FireSlot(static_cast<uint32_t>(now_ & (kSlots - 1)), on_expired);
+    }
+  }
+
+  // Unlink every timer regardless of its deadline, invoking
+  // \a on_removed(Node*) for each. Used to flush the wheel on shutdown, where
+  // advancing to the last deadline would take one step per rotation.
+  template <typename F>
+  void Clear(F on_removed) {
+    for (Node*& head : heads_) {
+      Node* node = head;
+      head = nullptr;
+      while (node != nullptr) {
+        Node* next = NodeTraits::Next(node);
+        NodeTraits::Slot(node) = kNotInWheel;
+        on_removed(node);
+        node = next;
+      }
+    }
+    for (auto& word : level0_occupied_) word = 0;
+    size_ = 0;
+  }
+
+  // Returns the earliest tick at which Advance() may have work to do: either a
+  // timer expires then, or timers need to be redistributed between levels. The
+  // true earliest deadline is never earlier than this value. Returns
+  // kInfiniteTicks if the wheel is empty.
+  int64_t NextWakeupTick() const {
+    if (size_ == 0) return kInfiniteTicks;
+    return NextInterestingTick();
+  }
+
+ private:
+  static constexpr uint32_t kOverflowSlot = kLevels * kSlots;
+  static constexpr int kWordBits = 64;
+
+  void Link(Node* node) {
+    uint32_t slot = SlotFor(NodeTraits::Deadline(node));
+    Node*& head = heads_[slot];
+    NodeTraits::Slot(node) = slot;
+    NodeTraits::Prev(node) = nullptr;
+    NodeTraits::Next(node) = head;
+    if (head != nullptr) NodeTraits::Prev(head) = node;
+    head = node;
+    if (slot < kSlots) {
+      level0_occupied_[slot / kWordBits] |= uint64_t{1} << (slot % kWordBits);
+    }
+  }
+
+  void Unlink(Node* node, uint32_t slot) {
+    Node* next = NodeTraits::Next(node);
+    Node* prev = NodeTraits::Prev(node);
+    if (prev != nullptr) {
+      NodeTraits::Next(prev) = next;
+    } else {
+      heads_[slot] = next;
+    }
+    if (next != nullptr) NodeTraits::Prev(next) = prev;
+    NodeTraits::Slot(node) = kNotInWheel;
+    if (slot < kSlots && heads_[slot] == nullptr) {
+      level0_occupied_[slot / kWordBits] &=
+          ~(uint64_t{1} << (slot % kWordBits));
+    }
+  }
+
+  // Level L holds deadlines that share all bits above 8(L+1) with now_.
+  uint32_t SlotFor(int64_t deadline) const {
+    uint64_t diff =
+        static_cast<uint64_t>(deadline) ^ static_cast<uint64_t>(now_);
+    int level = (kWordBits - 1 - absl::countl_zero(diff | 1)) / kSlotBits;
+    if (level >= kLevels) return kOverflowSlot;
+    return static_cast<uint32_t>(level) * kSlots +
+           static_cast<uint32_t>((static_cast<uint64_t>(deadline) >>
+                                  (level * kSlotBits)) &
+                                 (kSlots - 1));
+  }
+
+  // The next tick that has an occupied level 0 slot within the current
+  // rotation, or the start of the next rotation (where a cascade happens).
+  int64_t NextInterestingTick() const {
+    const int64_t rotation_start = now_ & ~static_cast<int64_t>(kSlots - 1);
+    uint32_t first = static_cast<uint32_t>(now_ & (kSlots - 1)) + 1;
+    for (uint32_t word = first / kWordBits; word < kSlots / kWordBits;
+         ++word) {
+      uint64_t bits = level0_occupied_[word];
+      if (word == first / kWordBits) {
+        uint32_t shift = first % kWordBits;
+        bits &= ~uint64_t{0} << shift;
+      }
+      if (bits != 0) {
+        return rotation_start + word * kWordBits + absl::countr_zero(bits);
+      }
+    }
+    return rotation_start + kSlots;
+  }
+
+  // Redistribute coarse levels whose slot boundary was just crossed.
+  void Cascade() {
+    uint64_t now = static_cast<uint64_t>(now_);
+    if ((now & ((uint64_t{1} << (kLevels * kSlotBits)) - 1)) == 0) {
+      Relink(kOverflowSlot);
+    }
+    for (int level = kLevels - 1; level >= 1; --level) {
+      if ((now & ((uint64_t{1} << (level * kSlotBits)) - 1)) != 0) continue;
+      Relink(static_cast<uint32_t>(level) * kSlots +
+             static_cast<uint32_t>((now >> (level * kSlotBits)) &
+                                   (kSlots - 1)));
+    }
+  }
+
+  void Relink(uint32_t slot) {
+    Node* node = heads_[slot];
+    heads_[slot] = nullptr;
+    while (node != nullptr) {
+      Node* next = NodeTraits::Next(node);
+      GPR_DEBUG_ASSERT(NodeTraits::Deadline(node) >= now_);
+      Link(node);
+      node = next;
+    }
+  }
+
+  template <typename F>
+  void FireSlot(uint32_t slot, F& on_expired) {
+    Node* node = heads_[slot];
+    if (node == nullptr) return;
+    heads_[slot] = nullptr;
+    level0_occupied_[slot / kWordBits] &= ~(uint64_t{1} << (slot % kWordBits));
+    while (node != nullptr) {
+      Node* next = NodeTraits::Next(node);
+      GPR_DEBUG_ASSERT(NodeTraits::Deadline(node) <= now_);
+      NodeTraits::Slot(node) = kNotInWheel;
+      --size_;
+      on_expired(node);
+      node = next;
+    }
+  }
+
+  int64_t now_;
+  size_t size_ = 0;
+  Node* heads_[kLevels * kSlots + 1];
+  uint64_t level0_occupied_[kSlots / kWordBits];
+};
+
+template <typename Node, typename NodeTraits>
+constexpr uint32_t TimerWheel<Node, NodeTraits>::kNotInWheel;
+template <typename Node, typename NodeTraits>
+constexpr int TimerWheel<Node, NodeTraits>::kSlotBits;
+template <typename Node, typename NodeTraits>
+constexpr int TimerWheel<Node, NodeTraits>::kLevels;
+template <typename Node, typename NodeTraits>
+constexpr uint32_t TimerWheel<Node, NodeTraits>::kSlots;
+template <typename Node, typename NodeTraits>
+constexpr int64_t TimerWheel<Node, NodeTraits>::kInfiniteTicks;
+template <typename Node, typename NodeTraits>
+constexpr uint32_t TimerWheel<Node, NodeTraits>::kOverflowSlot;
+template <typename Node, typename NodeTraits>
+constexpr int TimerWheel<Node, NodeTraits>::kWordBits;
+
+}  // namespace grpc_core
+
+#endif  // GRPC_CORE_LIB_GPRPP_TIMER_WHEEL_H
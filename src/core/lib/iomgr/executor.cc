@@ -76,22 +76,37 @@ void resolver_enqueue_long(grpc_closure* closure, grpc_error_handle error) {
       closure, error, false /* is_short */);
 }
 
+void handshake_enqueue_short(grpc_closure* closure, grpc_error_handle error) {
+  executors[static_cast<size_t>(ExecutorType::HANDSHAKE)]->Enqueue(
+      closure, error, true /* is_short */);
+}
+
+void handshake_enqueue_long(grpc_closure* closure, grpc_error_handle error) {
+  executors[static_cast<size_t>(ExecutorType::HANDSHAKE)]->Enqueue(
+      closure, error, false /* is_short */);
+}
+
 using EnqueueFunc = void (*)(grpc_closure* closure, grpc_error_handle error);
 
 const EnqueueFunc
     executor_enqueue_fns_[static_cast<size_t>(ExecutorType::NUM_EXECUTORS)]
                          [static_cast<size_t>(ExecutorJobType::NUM_JOB_TYPES)] =
                              {{default_enqueue_short, default_enqueue_long},
-                              {resolver_enqueue_short, resolver_enqueue_long}};
+                              {resolver_enqueue_short, resolver_enqueue_long},
+                              {handshake_enqueue_short,
+                               handshake_enqueue_long}};
 
 }  // namespace
 
 TraceFlag executor_trace(false, "executor");
 
-Executor::Executor(const char* name) : name_(name) {
+Executor::Executor(const char* name)
+    : Executor(name, 2 * gpr_cpu_num_cores()) {}
+
+Executor::Executor(const char* name, size_t max_threads) : name_(name) {
   adding_thread_lock_ = GPR_SPINLOCK_STATIC_INITIALIZER;
   gpr_atm_rel_store(&num_threads_, 0);
-  max_threads_ = std::max(1u, 2 * gpr_cpu_num_cores());
+  max_threads_ = std::max<size_t>(1, max_threads);
 }
 
 void Executor::Init() { SetThreading(true); }
@@ -381,6 +396,8 @@ void Executor::InitAll() {
   if (executors[static_cast<size_t>(ExecutorType::DEFAULT)] != nullptr) {
     GPR_ASSERT(executors[static_cast<size_t>(ExecutorType::RESOLVER)] !=
                nullptr);
+    GPR_ASSERT(executors[static_cast<size_t>(ExecutorType::HANDSHAKE)] !=
+               nullptr);
     return;
   }
 
@@ -388,9 +405,14 @@ void Executor::InitAll() {
       new Executor("default-executor");
   executors[static_cast<size_t>(ExecutorType::RESOLVER)] =
       new Executor("resolver-executor");
+  // Handshakes are CPU bound, so more threads than cores would only take time
+  // away from the pollers.
+  executors[static_cast<size_t>(ExecutorType::HANDSHAKE)] =
+      new Executor("handshake-executor", gpr_cpu_num_cores());
 
   executors[static_cast<size_t>(ExecutorType::DEFAULT)]->Init();
   executors[static_cast<size_t>(ExecutorType::RESOLVER)]->Init();
+  executors[static_cast<size_t>(ExecutorType::HANDSHAKE)]->Init();
 
   EXECUTOR_TRACE0("Executor::InitAll() done");
 }
@@ -408,11 +430,14 @@ void Executor::ShutdownAll() {
   if (executors[static_cast<size_t>(ExecutorType::DEFAULT)] == nullptr) {
     GPR_ASSERT(executors[static_cast<size_t>(ExecutorType::RESOLVER)] ==
                nullptr);
+    GPR_ASSERT(executors[static_cast<size_t>(ExecutorType::HANDSHAKE)] ==
+               nullptr);
     return;
   }
 
   executors[static_cast<size_t>(ExecutorType::DEFAULT)]->Shutdown();
   executors[static_cast<size_t>(ExecutorType::RESOLVER)]->Shutdown();
+  executors[static_cast<size_t>(ExecutorType::HANDSHAKE)]->Shutdown();
 
   // Delete the executor objects.
   //
@@ -428,8 +453,10 @@ void Executor::ShutdownAll() {
 
   delete executors[static_cast<size_t>(ExecutorType::DEFAULT)];
   delete executors[static_cast<size_t>(ExecutorType::RESOLVER)];
+  delete executors[static_cast<size_t>(ExecutorType::HANDSHAKE)];
   executors[static_cast<size_t>(ExecutorType::DEFAULT)] = nullptr;
   executors[static_cast<size_t>(ExecutorType::RESOLVER)] = nullptr;
+  executors[static_cast<size_t>(ExecutorType::HANDSHAKE)] = nullptr;
 
   EXECUTOR_TRACE0("Executor::ShutdownAll() done");
 }
@@ -42,6 +42,8 @@ struct ThreadState {
 enum class ExecutorType {
   DEFAULT = 0,
   RESOLVER,
+  // Runs the CPU heavy steps of security handshakes, off the pollers.
+  HANDSHAKE,
 
   NUM_EXECUTORS  // Add new values above this
 };
@@ -55,6 +57,7 @@ enum class ExecutorJobType {
 class Executor {
  public:
   explicit Executor(const char* executor_name);
+  Executor(const char* executor_name, size_t max_threads);
 
   void Init();
 
@@ -72,8 +75,8 @@ class Executor {
    * a short job (i.e expected to not block and complete quickly) */
   void Enqueue(grpc_closure* closure, grpc_error_handle error, bool is_short);
 
-  // TODO(sreek): Currently we have two executors (available globally): The
-  // default executor and the resolver executor.
+  // TODO(sreek): Currently we have three executors (available globally): The
+  // default executor, the resolver executor and the handshake executor.
   //
   // Some of the functions below operate on the DEFAULT executor only while some
   // operate of ALL the executors. This is a bit confusing and should be cleaned
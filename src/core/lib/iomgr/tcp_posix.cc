@@ -61,6 +61,7 @@
 #include "src/core/lib/profiling/timers.h"
 #include "src/core/lib/resource_quota/api.h"
 #include "src/core/lib/resource_quota/memory_quota.h"
+#include "src/core/lib/resource_quota/read_slab_pool.h"
 #include "src/core/lib/resource_quota/trace.h"
 #include "src/core/lib/slice/slice_internal.h"
 #include "src/core/lib/slice/slice_string_helpers.h"
@@ -74,6 +75,17 @@
 #define TCP_CM_INQ TCP_INQ
 #endif
 
+// Kernel TLS reports the content type of the records a read returns.
+#ifndef SOL_TLS
+#define SOL_TLS 282
+#endif
+
+#ifndef TLS_GET_RECORD_TYPE
+#define TLS_GET_RECORD_TYPE 2
+#endif
+
+#define TLS_RECORD_TYPE_APPLICATION_DATA 23
+
 #ifdef GRPC_HAVE_MSG_NOSIGNAL
 #define SENDMSG_FLAGS MSG_NOSIGNAL
 #else
@@ -380,6 +392,8 @@ struct grpc_tcp {
 
   grpc_core::Mutex read_mu;
   grpc_slice_buffer* incoming_buffer ABSL_GUARDED_BY(read_mu) = nullptr;
+  /* whether the read buffers were last taken from the read slab pool */
+  bool read_slabs ABSL_GUARDED_BY(read_mu) = false;
   int inq;          /* bytes pending on the socket from the last read. */
   bool inq_capable; /* cache whether kernel supports inq */
 
@@ -709,6 +723,9 @@ static void tcp_trace_read(grpc_tcp* tcp, grpc_error_handle error)
   }
 }
 
+/* Above this memory pressure every read is served from a single slab. */
+static constexpr double kReadSlabPressure = 0.8;
+
 /* Returns true if data available to read or error other than EAGAIN. */
 #define MAX_READ_IOVEC 4
 static bool tcp_do_read(grpc_tcp* tcp, grpc_error_handle* error)
@@ -725,9 +742,12 @@ static bool tcp_do_read(grpc_tcp* tcp, grpc_error_handle* error)
       std::min<size_t>(MAX_READ_IOVEC, tcp->incoming_buffer->count);
 #ifdef GRPC_LINUX_ERRQUEUE
   constexpr size_t cmsg_alloc_space =
-      CMSG_SPACE(sizeof(grpc_core::scm_timestamping)) + CMSG_SPACE(sizeof(int));
+      CMSG_SPACE(sizeof(grpc_core::scm_timestamping)) +
+      CMSG_SPACE(sizeof(int)) + CMSG_SPACE(sizeof(unsigned char));
 #else
-  constexpr size_t cmsg_alloc_space = 24 /* CMSG_SPACE(sizeof(int)) */;
+  constexpr size_t cmsg_alloc_space =
+      24 /* CMSG_SPACE(sizeof(int)) */ +
+      24 /* CMSG_SPACE(sizeof(unsigned char)) */;
 #endif /* GRPC_LINUX_ERRQUEUE */
   char cmsgbuf[cmsg_alloc_space];
   for (size_t i = 0; i < iov_len; i++) {
@@ -778,6 +798,11 @@ static bool tcp_do_read(grpc_tcp* tcp, grpc_error_handle* error)
       if (errno == EAGAIN) {
         finish_estimate(tcp);
         tcp->inq = 0;
+        if (tcp->read_slabs && total_read_bytes == 0) {
+          /* Nothing was read into the slabs: hand them back to the pool
+           * rather than holding them while the connection is idle. */
+          grpc_slice_buffer_reset_and_unref_internal(tcp->incoming_buffer);
+        }
         return false;
       } else {
         grpc_slice_buffer_reset_and_unref_internal(tcp->incoming_buffer);
@@ -805,14 +830,29 @@ static bool tcp_do_read(grpc_tcp* tcp, grpc_error_handle* error)
 #ifdef GRPC_HAVE_TCP_INQ
     if (tcp->inq_capable) {
       GPR_DEBUG_ASSERT(!(msg.msg_flags & MSG_CTRUNC));
+      bool application_data = true;
       struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
       for (; cmsg != nullptr; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
         if (cmsg->cmsg_level == SOL_TCP && cmsg->cmsg_type == TCP_CM_INQ &&
             cmsg->cmsg_len == CMSG_LEN(sizeof(int))) {
           tcp->inq = *reinterpret_cast<int*>(CMSG_DATA(cmsg));
-          break;
+        } else if (cmsg->cmsg_level == SOL_TLS &&
+                   cmsg->cmsg_type == TLS_GET_RECORD_TYPE) {
+          application_data =
+              *CMSG_DATA(cmsg) == TLS_RECORD_TYPE_APPLICATION_DATA;
         }
       }
+      /* With kernel TLS receive offload, alerts and handshake messages such
+       * as KeyUpdate are returned as data, one record at a time, tagged with
+       * their record type. They cannot be processed here, so the connection
+       * fails. Without a control buffer the kernel fails the read itself. */
+      if (!application_data) {
+        grpc_slice_buffer_reset_and_unref_internal(tcp->incoming_buffer);
+        *error = tcp_annotate_error(
+            GRPC_ERROR_CREATE_FROM_STATIC_STRING("Unexpected TLS record"),
+            tcp);
+        return true;
+      }
     }
 #endif /* GRPC_HAVE_TCP_INQ */
 
@@ -871,12 +911,37 @@ static void maybe_make_read_slices(grpc_tcp* tcp)
     int target_length = static_cast<int>(tcp->target_length);
     int extra_wanted =
         target_length - static_cast<int>(tcp->incoming_buffer->length);
-    grpc_slice_buffer_add_indexed(
-        tcp->incoming_buffer,
-        tcp->memory_owner.MakeSlice(grpc_core::MemoryRequest(
-            tcp->min_read_chunk_size,
-            grpc_core::Clamp(extra_wanted, tcp->min_read_chunk_size,
-                             tcp->max_read_chunk_size))));
+    constexpr int kSlabSize =
+        static_cast<int>(grpc_core::ReadSlabPool::kSlabSize);
+    const bool under_pressure =
+        tcp->memory_owner.InstantaneousPressure() > kReadSlabPressure;
+    tcp->read_slabs = tcp->min_read_chunk_size <= kSlabSize &&
+                      tcp->max_read_chunk_size >= kSlabSize &&
+                      (under_pressure ||
+                       target_length <= MAX_READ_IOVEC * kSlabSize);
+    if (tcp->read_slabs) {
+      /* Small reads, and all reads under memory pressure, are served from
+       * pooled fixed size slabs rather than freshly allocated slices. */
+      const int max_slabs =
+          MAX_READ_IOVEC - static_cast<int>(tcp->incoming_buffer->count);
+      int slabs = 1;
+      if (!under_pressure) {
+        slabs = grpc_core::Clamp((extra_wanted + kSlabSize - 1) / kSlabSize,
+                                 1, max_slabs);
+      }
+      for (int i = 0; i < slabs; i++) {
+        grpc_slice_buffer_add_indexed(
+            tcp->incoming_buffer,
+            grpc_core::ReadSlabPool::Get()->MakeSlice(&tcp->memory_owner));
+      }
+    } else {
+      grpc_slice_buffer_add_indexed(
+          tcp->incoming_buffer,
+          tcp->memory_owner.MakeSlice(grpc_core::MemoryRequest(
+              tcp->min_read_chunk_size,
+              grpc_core::Clamp(extra_wanted, tcp->min_read_chunk_size,
+                               tcp->max_read_chunk_size))));
+    }
     maybe_post_reclaimer(tcp);
   }
 }
@@ -920,6 +985,12 @@ static void tcp_read(grpc_endpoint* ep, grpc_slice_buffer* incoming_buffer,
   tcp->incoming_buffer = incoming_buffer;
   grpc_slice_buffer_reset_and_unref_internal(incoming_buffer);
   grpc_slice_buffer_swap(incoming_buffer, &tcp->last_read_buffer);
+  const bool wait_for_pollin = tcp->is_first_read || (!urgent && tcp->inq == 0);
+  if (wait_for_pollin && tcp->read_slabs) {
+    /* Don't hold the slabs left over from the last read while waiting: they
+     * are allocated again from the pool once the socket is readable. */
+    grpc_slice_buffer_reset_and_unref_internal(incoming_buffer);
+  }
   tcp->read_mu.Unlock();
   TCP_REF(tcp, "read");
   if (tcp->is_first_read) {
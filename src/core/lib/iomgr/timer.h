@@ -33,6 +33,7 @@
 typedef struct grpc_timer {
   int64_t deadline;
   // Uninitialized if not using heap, or INVALID_HEAP_INDEX if not in heap.
+  // The timing wheel implementation keeps its wheel slot here instead.
   uint32_t heap_index;
   bool pending;
   struct grpc_timer* next;
@@ -42,7 +43,8 @@ typedef struct grpc_timer {
   struct grpc_timer* hash_table_next;
 #endif
 
-  // Optional field used by custom timers
+  // Optional field used by custom timers, and by the timing wheel
+  // implementation to find the shard that holds the timer
   union {
     void* custom_timer;
     grpc_event_engine::experimental::EventEngine::TaskHandle ee_task_handle;
@@ -133,4 +135,8 @@ void grpc_kick_poller(void);
 /* Sets the timer implementation */
 void grpc_set_timer_impl(grpc_timer_vtable* vtable);
 
+/* Returns the timer implementation named by GRPC_TIMER_STRATEGY: sharded
+   heaps ("heap", the default) or sharded timing wheels ("wheel") */
+grpc_timer_vtable* grpc_default_timer_impl();
+
 #endif /* GRPC_CORE_LIB_IOMGR_TIMER_H */
@@ -0,0 +1,313 @@
+/*
+ *
+ * Copyright 2022 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+/* A grpc_timer implementation built on hierarchical timing wheels.
+ *
+ * Timers are kept in one of several wheel shards. Every thread adds its timers
+ * to the same shard (assigned round-robin the first time the thread sets a
+ * timer), so a thread that keeps setting and cancelling timers keeps touching
+ * the same lock and cache lines. Adding and cancelling a timer are O(1) no
+ * matter how many timers are outstanding, which is what matters for servers
+ * holding millions of call deadlines that are almost all cancelled before they
+ * expire.
+ *
+ * Selected with GRPC_TIMER_STRATEGY=wheel; see grpc_default_timer_impl(). */
+
+#include <grpc/support/port_platform.h>
+
+#include <inttypes.h>
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+
+#include <grpc/support/cpu.h>
+#include <grpc/support/log.h>
+
+#include "src/core/lib/debug/trace.h"
+#include "src/core/lib/gpr/spinlock.h"
+#include "src/core/lib/gpr/tls.h"
+#include "src/core/lib/gpr/useful.h"
+#include "src/core/lib/gprpp/sync.h"
+#include "src/core/lib/gprpp/time.h"
+#include "src/core/lib/gprpp/timer_wheel.h"
+#include "src/core/lib/iomgr/exec_ctx.h"
+#include "src/core/lib/iomgr/timer.h"
+
+extern grpc_core::TraceFlag grpc_timer_trace;
+extern grpc_core::TraceFlag grpc_timer_check_trace;
+
+namespace {
+
+constexpr int64_t kInfiniteMillis = std::numeric_limits<int64_t>::max();
+
+/* The wheel links timers through next/prev and keeps its slot number in
+   heap_index, which the wheel backend does not otherwise use. */
+struct TimerTraits {
+  static int64_t Deadline(const grpc_timer* t) { return t->deadline; }
+  static grpc_timer*& Next(grpc_timer* t) { return t->next; }
+  static grpc_timer*& Prev(grpc_timer* t) { return t->prev; }
+  static uint32_t& Slot(grpc_timer* t) { return t->heap_index; }
+};
+using Wheel = grpc_core::TimerWheel<grpc_timer, TimerTraits>;
+
+struct WheelShard {
+  explicit WheelShard(int64_t now) : wheel(now) {}
+  grpc_core::Mutex mu;
+  Wheel wheel ABSL_GUARDED_BY(mu);
+  /* Never later than the first tick at which wheel has work to do, so that
+     timer_check can skip idle shards without taking their locks. */
+  std::atomic<int64_t> next_wakeup{kInfiniteMillis};
+};
+
+/* Lowers *value to candidate if candidate is smaller. Returns true if it
+   did. */
+bool AtomicMin(std::atomic<int64_t>* value, int64_t candidate) {
+  int64_t current = value->load();
+  while (candidate < current) {
+    if (value->compare_exchange_weak(current, candidate)) return true;
+  }
+  return false;
+}
+
+}  // namespace
+
+static WheelShard** g_shards;
+static size_t g_num_shards;
+static bool g_initialized;
+/* Round-robin source for assigning threads to shards */
+static std::atomic<uint32_t> g_next_thread_shard{0};
+/* Never later than the earliest next_wakeup over all shards */
+static std::atomic<int64_t> g_min_timer;
+/* Allow only one timer_check to advance the shards at once */
+static gpr_spinlock g_checker_mu = GPR_SPINLOCK_STATIC_INITIALIZER;
+
+/* Shard index + 1 of the calling thread, or 0 if it has not set a timer yet */
+static GPR_THREAD_LOCAL(uint32_t) g_thread_shard;
+/* Thread local copy of g_min_timer, so that timer_check does not touch the
+   shared cacheline when nothing can have expired yet */
+static GPR_THREAD_LOCAL(int64_t) g_last_seen_min_timer;
+
+static WheelShard* thread_shard() {
+  if (g_thread_shard == 0) {
+    g_thread_shard = g_next_thread_shard.fetch_add(1) + 1;
+  }
+  return g_shards[(g_thread_shard - 1) % g_num_shards];
+}
+
+static void timer_list_init() {
+  g_num_shards = grpc_core::Clamp(2 * gpr_cpu_num_cores(), 1u, 32u);
+  const int64_t now =
+      grpc_core::ExecCtx::Get()->Now().milliseconds_after_process_epoch();
+  g_shards = new WheelShard*[g_num_shards];
+  for (size_t i = 0; i < g_num_shards; i++) {
+    g_shards[i] = new WheelShard(now);
+  }
+  g_min_timer.store(now);
+  g_last_seen_min_timer = 0;
+  g_initialized = true;
+}
+
+static void timer_list_shutdown() {
+  grpc_error_handle error =
+      GRPC_ERROR_CREATE_FROM_STATIC_STRING("Timer list shutdown");
+  for (size_t i = 0; i < g_num_shards; i++) {
+    WheelShard* shard = g_shards[i];
+    {
+      grpc_core::MutexLock lock(&shard->mu);
+      shard->wheel.Clear([error](grpc_timer* timer) {
+        timer->pending = false;
+        grpc_core::ExecCtx::Run(DEBUG_LOCATION, timer->closure,
+                                GRPC_ERROR_REF(error));
+      });
+    }
+    delete shard;
+  }
+  GRPC_ERROR_UNREF(error);
+  delete[] g_shards;
+  g_shards = nullptr;
+  g_initialized = false;
+}
+
+static void timer_init(grpc_timer* timer, grpc_core::Timestamp deadline,
+                       grpc_closure* closure) {
+  timer->closure = closure;
+  timer->deadline = deadline.milliseconds_after_process_epoch();
+  timer->custom_timer = nullptr;
+
+#ifndef NDEBUG
+  timer->hash_table_next = nullptr;
+#endif
+
+  if (GRPC_TRACE_FLAG_ENABLED(grpc_timer_trace)) {
+    gpr_log(GPR_INFO, "TIMER %p: SET %" PRId64 " now %" PRId64 " call %p[%p]",
+            timer, deadline.milliseconds_after_process_epoch(),
+            grpc_core::ExecCtx::Get()->Now().milliseconds_after_process_epoch(),
+            closure, closure->cb);
+  }
+
+  if (!g_initialized) {
+    timer->pending = false;
+    grpc_core::ExecCtx::Run(
+        DEBUG_LOCATION, timer->closure,
+        GRPC_ERROR_CREATE_FROM_STATIC_STRING(
+            "Attempt to create timer before initialization"));
+    return;
+  }
+
+  if (deadline <= grpc_core::ExecCtx::Get()->Now()) {
+    timer->pending = false;
+    grpc_core::ExecCtx::Run(DEBUG_LOCATION, timer->closure, GRPC_ERROR_NONE);
+    return;
+  }
+
+  WheelShard* shard = thread_shard();
+  {
+    grpc_core::MutexLock lock(&shard->mu);
+    timer->pending = true;
+    if (!shard->wheel.Add(timer)) {
+      /* Another thread with a fresher clock already advanced the shard past
+         this deadline. */
+      timer->pending = false;
+      grpc_core::ExecCtx::Run(DEBUG_LOCATION, timer->closure, GRPC_ERROR_NONE);
+      return;
+    }
+    timer->custom_timer = shard;
+    AtomicMin(&shard->next_wakeup, timer->deadline);
+  }
+  /* If this is the earliest timer anywhere, the thread waiting in
+     timer_check must wake up sooner than it planned to. */
+  if (AtomicMin(&g_min_timer, timer->deadline)) {
+    if (GRPC_TRACE_FLAG_ENABLED(grpc_timer_trace)) {
+      gpr_log(GPR_INFO, "  .. new min_timer %" PRId64, timer->deadline);
+    }
+    grpc_kick_poller();
+  }
+}
+
+static void timer_consume_kick(void) {
+  /* Force re-evaluation of last seen min */
+  g_last_seen_min_timer = 0;
+}
+
+static void timer_cancel(grpc_timer* timer) {
+  if (!g_initialized) {
+    /* must have already been cancelled, also the shard mutex is invalid */
+    return;
+  }
+  /* Timers that never made it into a wheel have no shard, and are never
+     pending. */
+  WheelShard* shard = static_cast<WheelShard*>(timer->custom_timer);
+  if (shard == nullptr) return;
+  grpc_core::MutexLock lock(&shard->mu);
+  if (GRPC_TRACE_FLAG_ENABLED(grpc_timer_trace)) {
+    gpr_log(GPR_INFO, "TIMER %p: CANCEL pending=%s", timer,
+            timer->pending ? "true" : "false");
+  }
+  if (timer->pending) {
+    timer->pending = false;
+    shard->wheel.Remove(timer);
+    grpc_core::ExecCtx::Run(DEBUG_LOCATION, timer->closure,
+                            GRPC_ERROR_CANCELLED);
+  }
+}
+
+/* REQUIRES: g_checker_mu locked */
+static grpc_timer_check_result run_expired_timers(int64_t now) {
+  grpc_timer_check_result result = GRPC_TIMERS_CHECKED_AND_EMPTY;
+  int64_t min_next = kInfiniteMillis;
+  for (size_t i = 0; i < g_num_shards; i++) {
+    WheelShard* shard = g_shards[i];
+    if (shard->next_wakeup.load() <= now) {
+      grpc_core::MutexLock lock(&shard->mu);
+      size_t n = 0;
+      shard->wheel.Advance(now, [now, &n](grpc_timer* timer) {
+        if (GRPC_TRACE_FLAG_ENABLED(grpc_timer_trace)) {
+          gpr_log(GPR_INFO, "TIMER %p: FIRE %" PRId64 "ms late", timer,
+                  now - timer->deadline);
+        }
+        timer->pending = false;
+        grpc_core::ExecCtx::Run(DEBUG_LOCATION, timer->closure,
+                                GRPC_ERROR_NONE);
+        n++;
+      });
+      shard->next_wakeup.store(shard->wheel.NextWakeupTick());
+      if (n > 0) result = GRPC_TIMERS_FIRED;
+      if (GRPC_TRACE_FLAG_ENABLED(grpc_timer_check_trace)) {
+        gpr_log(GPR_INFO, "  .. shard[%d] popped %" PRIdPTR,
+                static_cast<int>(i), n);
+      }
+    }
+    min_next = std::min(min_next, shard->next_wakeup.load());
+  }
+  /* A timer_init that ran on an already scanned shard may have lowered
+     g_min_timer below min_next in the meantime. Publish min_next, then look
+     at the shards again: either the second pass sees that timer, or the
+     timer_init sees our store and lowers g_min_timer itself. */
+  g_min_timer.store(min_next);
+  for (size_t i = 0; i < g_num_shards; i++) {
+    AtomicMin(&g_min_timer, g_shards[i]->next_wakeup.load());
+  }
+  return result;
+}
+
+static grpc_timer_check_result timer_check(grpc_core::Timestamp* next) {
+  const int64_t now =
+      grpc_core::ExecCtx::Get()->Now().milliseconds_after_process_epoch();
+
+  /* fetch from a thread-local first: this avoids contention on a globally
+     mutable cacheline in the common case */
+  int64_t min_timer = g_last_seen_min_timer;
+  if (now < min_timer) {
+    if (next != nullptr) {
+      *next = std::min(
+          *next, grpc_core::Timestamp::FromMillisecondsAfterProcessEpoch(
+                     min_timer));
+    }
+    if (GRPC_TRACE_FLAG_ENABLED(grpc_timer_check_trace)) {
+      gpr_log(GPR_INFO, "TIMER CHECK SKIP: now=%" PRId64 " min_timer=%" PRId64,
+              now, min_timer);
+    }
+    return GRPC_TIMERS_CHECKED_AND_EMPTY;
+  }
+
+  min_timer = g_min_timer.load();
+  g_last_seen_min_timer = min_timer;
+  grpc_timer_check_result result = GRPC_TIMERS_CHECKED_AND_EMPTY;
+  if (now >= min_timer) {
+    if (!gpr_spinlock_trylock(&g_checker_mu)) return GRPC_TIMERS_NOT_CHECKED;
+    result = run_expired_timers(now);
+    gpr_spinlock_unlock(&g_checker_mu);
+    min_timer = g_min_timer.load();
+    g_last_seen_min_timer = min_timer;
+  }
+  if (next != nullptr) {
+    *next = std::min(
+        *next,
+        grpc_core::Timestamp::FromMillisecondsAfterProcessEpoch(min_timer));
+  }
+  if (GRPC_TRACE_FLAG_ENABLED(grpc_timer_check_trace)) {
+    gpr_log(GPR_INFO, "TIMER CHECK END: r=%d; now=%" PRId64 " next=%" PRId64,
+            result, now, min_timer);
+  }
+  return result;
+}
+
+grpc_timer_vtable grpc_wheel_timer_vtable = {
+    timer_init,      timer_cancel,        timer_check,
+    timer_list_init, timer_list_shutdown, timer_consume_kick};
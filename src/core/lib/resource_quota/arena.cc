@@ -22,65 +22,266 @@
 
 #include <string.h>
 
+#include <algorithm>
 #include <new>
 
+#include "absl/types/optional.h"
+
 #include <grpc/support/alloc.h>
 #include <grpc/support/atm.h>
+#include <grpc/support/cpu.h>
 #include <grpc/support/log.h>
 #include <grpc/support/sync.h>
 
 #include "src/core/lib/gpr/alloc.h"
+#include "src/core/lib/gpr/useful.h"
 #include "src/core/lib/gprpp/memory.h"
+#include "src/core/lib/gprpp/sync.h"
+#include "src/core/lib/resource_quota/resource_quota.h"
 
 namespace {
 
-void* ArenaStorage(size_t initial_size) {
-  static constexpr size_t base_size =
-      GPR_ROUND_UP_TO_ALIGNMENT_SIZE(sizeof(grpc_core::Arena));
-  initial_size = GPR_ROUND_UP_TO_ALIGNMENT_SIZE(initial_size);
-  size_t alloc_size = base_size + initial_size;
-  static constexpr size_t alignment =
-      (GPR_CACHELINE_SIZE > GPR_MAX_ALIGNMENT &&
-       GPR_CACHELINE_SIZE % GPR_MAX_ALIGNMENT == 0)
-          ? GPR_CACHELINE_SIZE
-          : GPR_MAX_ALIGNMENT;
-  return gpr_malloc_aligned(alloc_size, alignment);
+// Blocks of 256 bytes up to 64KiB are cached, in power of two size classes.
+constexpr size_t kMinSizeClassShift = 8;
+constexpr size_t kMaxSizeClassShift = 16;
+constexpr size_t kNumSizeClasses = kMaxSizeClassShift - kMinSizeClassShift + 1;
+// Upper bound on the memory cached for each CPU.
+constexpr size_t kMaxCachedBytesPerShard = 1024 * 1024;
+// Cached memory is charged to the quota in chunks of this many bytes, so that
+// a busy CPU does not touch the quota on every arena it recycles.
+constexpr size_t kQuotaChunkSize = 64 * 1024;
+
+// Returns the smallest size class holding \a size bytes, or kNumSizeClasses
+// if \a size is too large to be cached.
+size_t SizeClassFor(size_t size) {
+  size_t size_class = 0;
+  while ((size_t{1} << (size_class + kMinSizeClassShift)) < size) {
+    if (++size_class == kNumSizeClasses) break;
+  }
+  return size_class;
+}
+
+size_t SizeClassBytes(size_t size_class) {
+  return size_t{1} << (size_class + kMinSizeClassShift);
+}
+
+size_t RoundUpToQuotaChunk(size_t size) {
+  return (size + kQuotaChunkSize - 1) / kQuotaChunkSize * kQuotaChunkSize;
 }
 
 }  // namespace
 
 namespace grpc_core {
 
+struct ArenaBlockPool::FreeBlock {
+  FreeBlock* next;
+};
+
+struct alignas(GPR_CACHELINE_SIZE) ArenaBlockPool::Shard {
+  Mutex mu;
+  FreeBlock* free_lists[kNumSizeClasses] ABSL_GUARDED_BY(mu) = {};
+  size_t cached_bytes ABSL_GUARDED_BY(mu) = 0;
+  // Bytes reserved from the quota on behalf of this shard; always at least
+  // cached_bytes.
+  size_t charged_bytes ABSL_GUARDED_BY(mu) = 0;
+};
+
+ArenaBlockPool* ArenaBlockPool::Get() {
+  static ArenaBlockPool* pool = new ArenaBlockPool(
+      ResourceQuota::Default()->memory_quota()->CreateMemoryOwner(
+          "arena_block_pool"));
+  return pool;
+}
+
+ArenaBlockPool::ArenaBlockPool(MemoryOwner memory_owner)
+    : memory_owner_(std::move(memory_owner)),
+      num_shards_(Clamp(gpr_cpu_num_cores(), 1u, 64u)),
+      shards_(static_cast<Shard*>(gpr_malloc_aligned(
+          num_shards_ * sizeof(Shard), GPR_CACHELINE_SIZE))) {
+  for (size_t i = 0; i < num_shards_; i++) new (&shards_[i]) Shard();
+}
+
+ArenaBlockPool::~ArenaBlockPool() {
+  Drain();
+  for (size_t i = 0; i < num_shards_; i++) shards_[i].~Shard();
+  gpr_free_aligned(shards_);
+}
+
+ArenaBlockPool::Shard* ArenaBlockPool::CurrentShard() {
+  return &shards_[gpr_cpu_current_cpu() % num_shards_];
+}
+
+void* ArenaBlockPool::Alloc(size_t size, size_t* block_size) {
+  size_t size_class = SizeClassFor(size);
+  if (size_class == kNumSizeClasses ||
+      !enabled_.load(std::memory_order_relaxed)) {
+    *block_size = size;
+  } else {
+    *block_size = SizeClassBytes(size_class);
+    Shard* shard = CurrentShard();
+    FreeBlock* block;
+    size_t release = 0;
+    {
+      MutexLock lock(&shard->mu);
+      block = shard->free_lists[size_class];
+      if (block != nullptr) {
+        shard->free_lists[size_class] = block->next;
+        shard->cached_bytes -= *block_size;
+        // Hand quota back once we hold a couple of chunks more than we cache.
+        if (shard->charged_bytes - shard->cached_bytes >= 2 * kQuotaChunkSize) {
+          release = shard->charged_bytes -
+                    RoundUpToQuotaChunk(shard->cached_bytes);
+          shard->charged_bytes -= release;
+        }
+      }
+    }
+    if (release != 0) memory_owner_.Release(release);
+    if (block != nullptr) return block;
+  }
+  system_allocs_.fetch_add(1, std::memory_order_relaxed);
+  return gpr_malloc_aligned(*block_size, kAlignment);
+}
+
+void ArenaBlockPool::Free(void* block, size_t block_size) {
+  size_t size_class = SizeClassFor(block_size);
+  // Blocks that were not rounded up to a size class (too large, or allocated
+  // while caching was disabled) go straight back to the system.
+  if (size_class == kNumSizeClasses ||
+      SizeClassBytes(size_class) != block_size ||
+      !enabled_.load(std::memory_order_relaxed)) {
+    gpr_free_aligned(block);
+    return;
+  }
+  Shard* shard = CurrentShard();
+  bool cached = false;
+  size_t reserve = 0;
+  {
+    MutexLock lock(&shard->mu);
+    if (shard->cached_bytes + block_size <= kMaxCachedBytesPerShard) {
+      cached = true;
+      auto* free_block = new (block) FreeBlock;
+      free_block->next = shard->free_lists[size_class];
+      shard->free_lists[size_class] = free_block;
+      shard->cached_bytes += block_size;
+      if (shard->cached_bytes > shard->charged_bytes) {
+        reserve =
+            RoundUpToQuotaChunk(shard->cached_bytes - shard->charged_bytes);
+        shard->charged_bytes += reserve;
+      }
+    }
+  }
+  if (!cached) {
+    // This CPU's cache is full.
+    gpr_free_aligned(block);
+    return;
+  }
+  // The quota is only touched outside of the shard lock, since the reclaimer
+  // takes shard locks from within the quota.
+  if (reserve != 0) memory_owner_.Reserve(reserve);
+  MaybePostReclaimer();
+}
+
+size_t ArenaBlockPool::Drain() {
+  size_t drained = 0;
+  for (size_t i = 0; i < num_shards_; i++) {
+    Shard* shard = &shards_[i];
+    FreeBlock* free_lists[kNumSizeClasses];
+    size_t release;
+    {
+      MutexLock lock(&shard->mu);
+      std::copy(std::begin(shard->free_lists), std::end(shard->free_lists),
+                free_lists);
+      std::fill(std::begin(shard->free_lists), std::end(shard->free_lists),
+                nullptr);
+      drained += shard->cached_bytes;
+      release = shard->charged_bytes;
+      shard->cached_bytes = 0;
+      shard->charged_bytes = 0;
+    }
+    for (FreeBlock* block : free_lists) {
+      while (block != nullptr) {
+        FreeBlock* next = block->next;
+        gpr_free_aligned(block);
+        block = next;
+      }
+    }
+    if (release != 0) memory_owner_.Release(release);
+  }
+  return drained;
+}
+
+size_t ArenaBlockPool::cached_bytes() {
+  size_t total = 0;
+  for (size_t i = 0; i < num_shards_; i++) {
+    MutexLock lock(&shards_[i].mu);
+    total += shards_[i].cached_bytes;
+  }
+  return total;
+}
+
+void ArenaBlockPool::MaybePostReclaimer() {
+  if (reclaimer_posted_.load(std::memory_order_relaxed) ||
+      reclaimer_posted_.exchange(true, std::memory_order_relaxed)) {
+    return;
+  }
+  memory_owner_.PostReclaimer(
+      ReclamationPass::kBenign,
+      [this](absl::optional<ReclamationSweep> sweep) {
+        reclaimer_posted_.store(false, std::memory_order_relaxed);
+        if (!sweep.has_value()) return;
+        Drain();
+      });
+}
+
 Arena::~Arena() {
   Zone* z = last_zone_;
   while (z) {
     Zone* prev_z = z->prev;
+    size_t size = z->size;
     z->~Zone();
-    gpr_free_aligned(z);
+    ArenaBlockPool::Get()->Free(z, size);
     z = prev_z;
   }
 }
 
 Arena* Arena::Create(size_t initial_size, MemoryAllocator* memory_allocator) {
-  return new (ArenaStorage(initial_size))
-      Arena(initial_size, 0, memory_allocator);
+  return CreateWithAlloc(initial_size, 0, memory_allocator).first;
 }
 
 std::pair<Arena*, void*> Arena::CreateWithAlloc(
     size_t initial_size, size_t alloc_size, MemoryAllocator* memory_allocator) {
   static constexpr size_t base_size =
       GPR_ROUND_UP_TO_ALIGNMENT_SIZE(sizeof(Arena));
-  auto* new_arena = new (ArenaStorage(initial_size))
-      Arena(initial_size, alloc_size, memory_allocator);
+  size_t block_size;
+  void* block = ArenaBlockPool::Get()->Alloc(
+      base_size + GPR_ROUND_UP_TO_ALIGNMENT_SIZE(initial_size), &block_size);
+  auto* new_arena = new (block) Arena(block_size, alloc_size, memory_allocator);
   void* first_alloc = reinterpret_cast<char*>(new_arena) + base_size;
   return std::make_pair(new_arena, first_alloc);
 }
 
+void Arena::DestroyManagedNewObjects() {
+  // Destructors may register further objects, so keep going until the list
+  // stays empty.
+  ManagedNewObject* p;
+  while ((p = managed_new_head_.exchange(nullptr, std::memory_order_acquire)) !=
+         nullptr) {
+    while (p != nullptr) {
+      ManagedNewObject* next = p->next();
+      p->~ManagedNewObject();
+      p = next;
+    }
+  }
+}
+
 size_t Arena::Destroy() {
+  DestroyManagedNewObjects();
   size_t size = total_used_.load(std::memory_order_relaxed);
+  size_t block_size =
+      GPR_ROUND_UP_TO_ALIGNMENT_SIZE(sizeof(Arena)) + initial_zone_size_;
   memory_allocator_->Release(total_allocated_.load(std::memory_order_relaxed));
   this->~Arena();
-  gpr_free_aligned(this);
+  ArenaBlockPool::Get()->Free(this, block_size);
   return size;
 }
 
@@ -92,10 +293,13 @@ void* Arena::AllocZone(size_t size) {
   // zone and will not need to grow the arena).
   static constexpr size_t zone_base_size =
       GPR_ROUND_UP_TO_ALIGNMENT_SIZE(sizeof(Zone));
-  size_t alloc_size = zone_base_size + size;
+  size_t alloc_size;
+  void* block =
+      ArenaBlockPool::Get()->Alloc(zone_base_size + size, &alloc_size);
   memory_allocator_->Reserve(alloc_size);
   total_allocated_.fetch_add(alloc_size, std::memory_order_relaxed);
-  Zone* z = new (gpr_malloc_aligned(alloc_size, GPR_MAX_ALIGNMENT)) Zone();
+  Zone* z = new (block) Zone();
+  z->size = alloc_size;
   auto* prev = last_zone_.load(std::memory_order_relaxed);
   do {
     z->prev = prev;
@@ -32,9 +32,12 @@
 #include <atomic>
 #include <memory>
 #include <new>
+#include <string>
 #include <utility>
+#include <vector>
 
 #include <grpc/support/alloc.h>
+#include <grpc/support/log.h>
 #include <grpc/support/sync.h>
 
 #include "src/core/lib/gpr/alloc.h"
@@ -43,6 +46,67 @@
 
 namespace grpc_core {
 
+// Caches the memory blocks that back arenas, so that creating and destroying
+// an arena for every call does not cost a trip through the system allocator.
+// Blocks are rounded up to a power of two size class and kept on per-CPU free
+// lists. Cached blocks are charged to the default resource quota, and a benign
+// reclaimer hands them back to the system when that quota comes under
+// pressure.
+class ArenaBlockPool {
+ public:
+  // Alignment of every block handed out.
+  static constexpr size_t kAlignment =
+      (GPR_CACHELINE_SIZE > GPR_MAX_ALIGNMENT &&
+       GPR_CACHELINE_SIZE % GPR_MAX_ALIGNMENT == 0)
+          ? GPR_CACHELINE_SIZE
+          : GPR_MAX_ALIGNMENT;
+
+  // The process wide pool.
+  static ArenaBlockPool* Get();
+
+  ArenaBlockPool(const ArenaBlockPool&) = delete;
+  ArenaBlockPool& operator=(const ArenaBlockPool&) = delete;
+
+  // Return a block of at least \a size bytes, setting \a *block_size to its
+  // actual size. The whole block is usable.
+  void* Alloc(size_t size, size_t* block_size);
+  // Return a block obtained from Alloc() to the pool.
+  void Free(void* block, size_t block_size);
+
+  // Free every cached block back to the system. Returns the number of bytes
+  // released.
+  size_t Drain();
+  // Number of bytes currently cached across all CPUs.
+  size_t cached_bytes();
+  // Number of blocks that could not be served from the cache.
+  size_t system_allocs() const {
+    return system_allocs_.load(std::memory_order_relaxed);
+  }
+
+  // With caching disabled every block comes from the system allocator,
+  // exactly as large as requested.
+  void TestOnlySetEnabled(bool enabled) {
+    enabled_.store(enabled, std::memory_order_relaxed);
+  }
+
+ private:
+  struct FreeBlock;
+  struct Shard;
+
+  explicit ArenaBlockPool(MemoryOwner memory_owner);
+  ~ArenaBlockPool();
+
+  Shard* CurrentShard();
+  void MaybePostReclaimer();
+
+  MemoryOwner memory_owner_;
+  const size_t num_shards_;
+  Shard* const shards_;
+  std::atomic<bool> enabled_{true};
+  std::atomic<bool> reclaimer_posted_{false};
+  std::atomic<size_t> system_allocs_{0};
+};
+
 class Arena {
  public:
   // Create an arena, with \a initial_size bytes in the first allocated buffer.
@@ -57,56 +121,149 @@ class Arena {
 
   // Destroy an arena, returning the total number of bytes allocated.
   size_t Destroy();
-  // Allocate \a size bytes from the arena.
-  void* Alloc(size_t size) {
+  // Allocate \a size bytes from the arena, aligned to \a alignment, which
+  // must be a power of two no larger than GPR_MAX_ALIGNMENT.
+  void* Alloc(size_t size, size_t alignment = GPR_MAX_ALIGNMENT) {
     static constexpr size_t base_size =
         GPR_ROUND_UP_TO_ALIGNMENT_SIZE(sizeof(Arena));
-    size = GPR_ROUND_UP_TO_ALIGNMENT_SIZE(size);
-    size_t begin = total_used_.fetch_add(size, std::memory_order_relaxed);
-    if (begin + size <= initial_zone_size_) {
-      return reinterpret_cast<char*>(this) + base_size + begin;
+    GPR_DEBUG_ASSERT(alignment != 0 && (alignment & (alignment - 1)) == 0 &&
+                     alignment <= GPR_MAX_ALIGNMENT);
+    // Zone 0 starts GPR_MAX_ALIGNMENT aligned, so aligning the offset aligns
+    // the address.
+    size_t begin = total_used_.load(std::memory_order_relaxed);
+    size_t aligned_begin;
+    do {
+      aligned_begin = (begin + alignment - 1) & ~(alignment - 1);
+    } while (!total_used_.compare_exchange_weak(begin, aligned_begin + size,
+                                                std::memory_order_relaxed,
+                                                std::memory_order_relaxed));
+    if (aligned_begin + size <= initial_zone_size_) {
+      return reinterpret_cast<char*>(this) + base_size + aligned_begin;
     } else {
       return AllocZone(size);
     }
   }
 
-  // TODO(roth): We currently assume that all callers need alignment of 16
-  // bytes, which may be wrong in some cases. When we have time, we should
-  // change this to instead use the alignment of the type being allocated by
-  // this method.
+  // Allocate and construct a T. The arena only provides its storage: T's
+  // destructor is not run unless the caller runs it.
   template <typename T, typename... Args>
   T* New(Args&&... args) {
-    T* t = static_cast<T*>(Alloc(sizeof(T)));
+    static_assert(alignof(T) <= GPR_MAX_ALIGNMENT,
+                  "Arena cannot satisfy over-aligned types");
+    T* t = static_cast<T*>(Alloc(sizeof(T), alignof(T)));
     new (t) T(std::forward<Args>(args)...);
     return t;
   }
 
+  // Like New(), but T's destructor is registered with the arena and runs
+  // during Destroy(). Destructors run in the reverse order of registration.
+  // Only use this for objects whose destruction may wait for the arena: an
+  // object that other call state points into, or that releases resources,
+  // should be destroyed explicitly where its owner is.
+  template <typename T, typename... Args>
+  T* ManagedNew(Args&&... args) {
+    auto* p = New<ManagedNewImpl<T>>(std::forward<Args>(args)...);
+    p->Link(&managed_new_head_);
+    return &p->t;
+  }
+
+  // An std::allocator compatible allocator drawing from an arena, for
+  // containers whose lifetime is bounded by the arena's. deallocate() is a
+  // no-op: memory is returned when the arena is destroyed, so containers that
+  // grow should reserve() their expected size up front.
+  template <typename T>
+  class Allocator {
+   public:
+    using value_type = T;
+
+    explicit Allocator(Arena* arena) : arena_(arena) {}
+    template <typename U>
+    Allocator(const Allocator<U>& other)  // NOLINT(google-explicit-constructor)
+        : arena_(other.arena()) {}
+
+    T* allocate(size_t n) {
+      static_assert(alignof(T) <= GPR_MAX_ALIGNMENT,
+                    "Arena cannot satisfy over-aligned types");
+      return static_cast<T*>(arena_->Alloc(n * sizeof(T), alignof(T)));
+    }
+    void deallocate(T* /*p*/, size_t /*n*/) {}
+
+    Arena* arena() const { return arena_; }
+
+    template <typename U>
+    bool operator==(const Allocator<U>& other) const {
+      return arena_ == other.arena();
+    }
+    template <typename U>
+    bool operator!=(const Allocator<U>& other) const {
+      return arena_ != other.arena();
+    }
+
+   private:
+    Arena* arena_;
+  };
+
  private:
+  // Header for objects created with ManagedNew(); two words per object.
+  class ManagedNewObject {
+   public:
+    ManagedNewObject() = default;
+    ManagedNewObject(const ManagedNewObject&) = delete;
+    ManagedNewObject& operator=(const ManagedNewObject&) = delete;
+    virtual ~ManagedNewObject() = default;
+
+    void Link(std::atomic<ManagedNewObject*>* head) {
+      next_ = head->load(std::memory_order_relaxed);
+      while (!head->compare_exchange_weak(next_, this,
+                                          std::memory_order_acq_rel,
+                                          std::memory_order_relaxed)) {
+      }
+    }
+    ManagedNewObject* next() const { return next_; }
+
+   private:
+    ManagedNewObject* next_ = nullptr;
+  };
+
+  template <typename T>
+  class ManagedNewImpl final : public ManagedNewObject {
+   public:
+    template <typename... Args>
+    explicit ManagedNewImpl(Args&&... args) : t(std::forward<Args>(args)...) {}
+
+    T t;
+  };
+
   struct Zone {
     Zone* prev;
+    // Size of the block holding this zone, to return it to ArenaBlockPool
+    size_t size;
   };
 
   // Initialize an arena.
   // Parameters:
-  //   initial_size: The initial size of the whole arena in bytes. These bytes
-  //   are contained within 'zone 0'. If the arena user ends up requiring more
-  //   memory than the arena contains in zone 0, subsequent zones are allocated
-  //   on demand and maintained in a tail-linked list.
+  //   block_size: The size of the block holding the arena itself followed by
+  //   'zone 0'. The block comes from ArenaBlockPool, rounded up from the
+  //   requested initial size, and all of it is usable. If the arena user ends
+  //   up requiring more memory than the arena contains in zone 0, subsequent
+  //   zones are allocated on demand and maintained in a tail-linked list.
   //
   //   initial_alloc: Optionally, construct the arena as though a call to
   //   Alloc() had already been made for initial_alloc bytes. This provides a
   //   quick optimization (avoiding an atomic fetch-add) for the common case
   //   where we wish to create an arena and then perform an immediate
   //   allocation.
-  explicit Arena(size_t initial_size, size_t initial_alloc,
+  explicit Arena(size_t block_size, size_t initial_alloc,
                  MemoryAllocator* memory_allocator)
       : total_used_(GPR_ROUND_UP_TO_ALIGNMENT_SIZE(initial_alloc)),
-        initial_zone_size_(initial_size),
+        initial_zone_size_(block_size -
+                           GPR_ROUND_UP_TO_ALIGNMENT_SIZE(sizeof(Arena))),
         memory_allocator_(memory_allocator) {}
 
   ~Arena();
 
   void* AllocZone(size_t size);
+  void DestroyManagedNewObjects();
 
   // Keep track of the total used size. We use this in our call sizing
   // hysteresis.
@@ -119,6 +276,8 @@ class Arena {
   // and (2) the allocated memory. The arena itself maintains a pointer to the
   // last zone; the zone list is reverse-walked during arena destruction only.
   std::atomic<Zone*> last_zone_{nullptr};
+  // Objects created with ManagedNew(), most recent first.
+  std::atomic<ManagedNewObject*> managed_new_head_{nullptr};
   // The backing memory quota
   MemoryAllocator* const memory_allocator_;
 };
@@ -133,6 +292,12 @@ inline ScopedArenaPtr MakeScopedArena(size_t initial_size,
   return ScopedArenaPtr(Arena::Create(initial_size, memory_allocator));
 }
 
+// Containers allocating from an arena; see Arena::Allocator.
+template <typename T>
+using ArenaVector = std::vector<T, Arena::Allocator<T>>;
+using ArenaString =
+    std::basic_string<char, std::char_traits<char>, Arena::Allocator<char>>;
+
 // Arenas form a context for activities
 template <>
 struct ContextType<Arena> {};
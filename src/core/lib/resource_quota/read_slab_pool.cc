@@ -0,0 +1,209 @@
+// Copyright 2022 gRPC authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <grpc/support/port_platform.h>
+
+#include "src/core/lib/resource_quota/read_slab_pool.h"
+
+#include <new>
+#include <utility>
+
+#include "absl/types/optional.h"
+#include "absl/utility/utility.h"
+
+#include <grpc/support/alloc.h>
+#include <grpc/support/cpu.h>
+
+#include "src/core/lib/gpr/alloc.h"
+#include "src/core/lib/gpr/useful.h"
+#include "src/core/lib/gprpp/sync.h"
+#include "src/core/lib/resource_quota/resource_quota.h"
+#include "src/core/lib/slice/slice_refcount.h"
+
+namespace grpc_core {
+
+namespace {
+// Upper bound on the idle slabs kept for each CPU (2MiB).
+constexpr size_t kMaxIdleSlabsPerShard = 256;
+}  // namespace
+
+struct ReadSlabPool::Slab : public grpc_slice_refcount {
+  Slab(ReadSlabPool* pool, MemoryAllocator::Reservation reservation)
+      : grpc_slice_refcount(ReadSlabPool::Destroy),
+        pool(pool),
+        reservation(std::move(reservation)) {}
+
+  uint8_t* data() {
+    return reinterpret_cast<uint8_t*>(this) +
+           GPR_ROUND_UP_TO_ALIGNMENT_SIZE(sizeof(Slab));
+  }
+
+  ReadSlabPool* const pool;
+  // The charge against the allocator of the endpoint using this slab.
+  MemoryAllocator::Reservation reservation;
+};
+
+// Idle slabs are linked through their first bytes.
+struct ReadSlabPool::Shard {
+  struct FreeSlab {
+    FreeSlab* next;
+  };
+
+  Mutex mu;
+  FreeSlab* free_list ABSL_GUARDED_BY(mu) = nullptr;
+  size_t idle ABSL_GUARDED_BY(mu) = 0;
+  // Bytes reserved from the quota on behalf of this shard's idle slabs. The
+  // quota is only reserved or released by amounts taken from this counter.
+  size_t charged_bytes ABSL_GUARDED_BY(mu) = 0;
+};
+
+size_t ReadSlabPool::SlabAllocSize() {
+  return GPR_ROUND_UP_TO_ALIGNMENT_SIZE(sizeof(Slab)) + kSlabSize;
+}
+
+ReadSlabPool* ReadSlabPool::Get() {
+  static ReadSlabPool* pool = new ReadSlabPool(
+      ResourceQuota::Default()->memory_quota()->CreateMemoryOwner(
+          "read_slab_pool"));
+  return pool;
+}
+
+ReadSlabPool::ReadSlabPool(MemoryOwner memory_owner)
+    : memory_owner_(std::move(memory_owner)),
+      num_shards_(Clamp(gpr_cpu_num_cores(), 1u, 64u)),
+      shards_(new Shard[num_shards_]) {}
+
+ReadSlabPool::Shard* ReadSlabPool::CurrentShard() {
+  return &shards_[gpr_cpu_current_cpu() % num_shards_];
+}
+
+grpc_slice ReadSlabPool::MakeSlice(MemoryAllocator* allocator) {
+  const size_t alloc_size = SlabAllocSize();
+  MemoryAllocator::Reservation reservation =
+      allocator->MakeReservation(alloc_size);
+  Shard* shard = CurrentShard();
+  void* p;
+  size_t release = 0;
+  {
+    MutexLock lock(&shard->mu);
+    p = shard->free_list;
+    if (p != nullptr) {
+      shard->free_list = shard->free_list->next;
+      --shard->idle;
+      release = alloc_size;
+      shard->charged_bytes -= release;
+    }
+  }
+  if (release != 0) memory_owner_.Release(release);
+  if (p == nullptr) {
+    system_allocs_.fetch_add(1, std::memory_order_relaxed);
+    p = gpr_malloc(alloc_size);
+  }
+  Slab* slab = new (p) Slab(this, std::move(reservation));
+  grpc_slice slice;
+  slice.refcount = slab;
+  slice.data.refcounted.bytes = slab->data();
+  slice.data.refcounted.length = kSlabSize;
+  return slice;
+}
+
+void ReadSlabPool::Destroy(grpc_slice_refcount* refcount) {
+  Slab* slab = static_cast<Slab*>(refcount);
+  slab->pool->Recycle(slab);
+}
+
+void ReadSlabPool::Recycle(Slab* slab) {
+  const size_t alloc_size = SlabAllocSize();
+  // Releases the endpoint's charge.
+  slab->~Slab();
+  Shard* shard = CurrentShard();
+  size_t reserve = 0;
+  {
+    MutexLock lock(&shard->mu);
+    if (shard->idle < kMaxIdleSlabsPerShard) {
+      auto* free_slab = new (slab) Shard::FreeSlab;
+      free_slab->next = shard->free_list;
+      shard->free_list = free_slab;
+      ++shard->idle;
+      reserve = alloc_size;
+      shard->charged_bytes += reserve;
+    }
+  }
+  if (reserve == 0) {
+    gpr_free(slab);
+    return;
+  }
+  // The quota is only touched outside of the shard lock, since the reclaimer
+  // takes shard locks from within the quota.
+  memory_owner_.Reserve(reserve);
+  MaybePostReclaimer();
+}
+
+size_t ReadSlabPool::Drain() {
+  size_t drained = 0;
+  for (size_t i = 0; i < num_shards_; i++) {
+    Shard* shard = &shards_[i];
+    Shard::FreeSlab* free_list;
+    size_t idle;
+    size_t release;
+    {
+      MutexLock lock(&shard->mu);
+      free_list = absl::exchange(shard->free_list, nullptr);
+      idle = absl::exchange(shard->idle, 0);
+      release = absl::exchange(shard->charged_bytes, 0);
+    }
+    while (free_list != nullptr) {
+      Shard::FreeSlab* next = free_list->next;
+      gpr_free(free_list);
+      free_list = next;
+    }
+    if (release != 0) memory_owner_.Release(release);
+    drained += idle;
+  }
+  return drained;
+}
+
+size_t ReadSlabPool::idle_slabs() {
+  size_t total = 0;
+  for (size_t i = 0; i < num_shards_; i++) {
+    MutexLock lock(&shards_[i].mu);
+    total += shards_[i].idle;
+  }
+  return total;
+}
+
+size_t ReadSlabPool::charged_bytes() {
+  size_t total = 0;
+  for (size_t i = 0; i < num_shards_; i++) {
+    MutexLock lock(&shards_[i].mu);
+    total += shards_[i].charged_bytes;
+  }
+  return total;
+}
+
+void ReadSlabPool::MaybePostReclaimer() {
+  if (reclaimer_posted_.load(std::memory_order_relaxed) ||
+      reclaimer_posted_.exchange(true, std::memory_order_relaxed)) {
+    return;
+  }
+  memory_owner_.PostReclaimer(
+      ReclamationPass::kBenign,
+      [this](absl::optional<ReclamationSweep> sweep) {
+        reclaimer_posted_.store(false, std::memory_order_relaxed);
+        if (!sweep.has_value()) return;
+        Drain();
+      });
+}
+
+}  // namespace grpc_core
@@ -0,0 +1,88 @@
+// Copyright 2022 gRPC authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GRPC_CORE_LIB_RESOURCE_QUOTA_READ_SLAB_POOL_H
+#define GRPC_CORE_LIB_RESOURCE_QUOTA_READ_SLAB_POOL_H
+
+#include <grpc/support/port_platform.h>
+
+#include <stddef.h>
+
+#include <atomic>
+
+#include <grpc/slice.h>
+
+#include "src/core/lib/resource_quota/memory_quota.h"
+
+namespace grpc_core {
+
+// A process wide pool of fixed size read buffers ("slabs").
+//
+// Each slab is handed out as a refcounted slice charged to the allocator of
+// the endpoint that asked for it. When the last reference to the slice is
+// dropped - typically after the transport has parsed the bytes - the charge
+// is released and the slab goes back to a per-CPU free list for the next
+// read on any connection, rather than back to the system allocator.
+//
+// Idle slabs are charged to the default resource quota, and a benign
+// reclaimer frees them when that quota comes under pressure.
+class ReadSlabPool {
+ public:
+  static constexpr size_t kSlabSize = 8192;
+
+  // The process wide pool.
+  static ReadSlabPool* Get();
+
+  ReadSlabPool(const ReadSlabPool&) = delete;
+  ReadSlabPool& operator=(const ReadSlabPool&) = delete;
+
+  // Returns a kSlabSize byte slice, charged to \a allocator until the last
+  // reference to it is released.
+  grpc_slice MakeSlice(MemoryAllocator* allocator);
+
+  // Frees every idle slab back to the system. Returns the number of slabs
+  // freed.
+  size_t Drain();
+  // Number of slabs currently idle across all CPUs.
+  size_t idle_slabs();
+  // Number of bytes currently reserved from the quota for idle slabs.
+  size_t charged_bytes();
+  // Number of slabs that could not be served from the free lists.
+  size_t system_allocs() const {
+    return system_allocs_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  struct Slab;
+  struct Shard;
+
+  explicit ReadSlabPool(MemoryOwner memory_owner);
+
+  // Bytes allocated per slab, including its header.
+  static size_t SlabAllocSize();
+  static void Destroy(grpc_slice_refcount* refcount);
+  void Recycle(Slab* slab);
+  Shard* CurrentShard();
+  void MaybePostReclaimer();
+
+  MemoryOwner memory_owner_;
+  const size_t num_shards_;
+  Shard* const shards_;
+  std::atomic<bool> reclaimer_posted_{false};
+  std::atomic<size_t> system_allocs_{0};
+};
+
+}  // namespace grpc_core
+
+#endif  // GRPC_CORE_LIB_RESOURCE_QUOTA_READ_SLAB_POOL_H
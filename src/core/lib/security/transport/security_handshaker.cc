@@ -34,6 +34,8 @@
 #include "src/core/lib/channel/handshaker.h"
 #include "src/core/lib/config/core_configuration.h"
 #include "src/core/lib/gprpp/ref_counted_ptr.h"
+#include "src/core/lib/iomgr/endpoint.h"
+#include "src/core/lib/iomgr/executor.h"
 #include "src/core/lib/security/context/security_context.h"
 #include "src/core/lib/security/transport/secure_endpoint.h"
 #include "src/core/lib/security/transport/tsi_error.h"
@@ -61,6 +63,8 @@ class SecurityHandshaker : public Handshaker {
  private:
   grpc_error_handle DoHandshakerNextLocked(const unsigned char* bytes_received,
                                            size_t bytes_received_size);
+  grpc_error_handle DoHandshakerNextInlineLocked(
+      const unsigned char* bytes_received, size_t bytes_received_size);
 
   grpc_error_handle OnHandshakeNextDoneLocked(
       tsi_result result, const unsigned char* bytes_to_send,
@@ -75,6 +79,7 @@ class SecurityHandshaker : public Handshaker {
       void* arg, grpc_error_handle error);
   static void OnHandshakeDataSentToPeerFnScheduler(void* arg,
                                                    grpc_error_handle error);
+  static void OnHandshakerNextOffloadedFn(void* arg, grpc_error_handle error);
   static void OnHandshakeNextDoneGrpcWrapper(
       tsi_result result, void* user_data, const unsigned char* bytes_to_send,
       size_t bytes_to_send_size, tsi_handshaker_result* handshaker_result);
@@ -104,9 +109,14 @@ class SecurityHandshaker : public Handshaker {
   grpc_closure on_handshake_data_sent_to_peer_;
   grpc_closure on_handshake_data_received_from_peer_;
   grpc_closure on_peer_checked_;
+  grpc_closure on_handshaker_next_offloaded_;
+  // Bytes at the start of handshake_buffer_ waiting for an offloaded step.
+  size_t offloaded_bytes_received_size_ = 0;
   RefCountedPtr<grpc_auth_context> auth_context_;
   tsi_handshaker_result* handshaker_result_ = nullptr;
   size_t max_frame_size_ = 0;
+  bool kernel_offload_ = false;
+  bool handshake_offload_ = false;
 };
 
 SecurityHandshaker::SecurityHandshaker(tsi_handshaker* handshaker,
@@ -119,7 +129,15 @@ SecurityHandshaker::SecurityHandshaker(tsi_handshaker* handshaker,
           static_cast<uint8_t*>(gpr_malloc(handshake_buffer_size_))),
       max_frame_size_(grpc_channel_args_find_integer(
           args, GRPC_ARG_TSI_MAX_FRAME_SIZE,
-          {0, 0, std::numeric_limits<int>::max()})) {
+          {0, 0, std::numeric_limits<int>::max()})),
+      // The kernel's TLS implementation rejects MSG_ZEROCOPY sends.
+      kernel_offload_(
+          grpc_channel_args_find_bool(args, GRPC_ARG_TSI_KERNEL_OFFLOAD,
+                                      false) &&
+          !grpc_channel_args_find_bool(args, GRPC_ARG_TCP_TX_ZEROCOPY_ENABLED,
+                                       false)),
+      handshake_offload_(grpc_channel_args_find_bool(
+          args, GRPC_ARG_TSI_HANDSHAKE_OFFLOAD, false)) {
   grpc_slice_buffer_init(&outgoing_);
   GRPC_CLOSURE_INIT(&on_peer_checked_, &SecurityHandshaker::OnPeerCheckedFn,
                     this, grpc_schedule_on_exec_ctx);
@@ -253,6 +271,25 @@ void SecurityHandshaker::OnPeerCheckedInner(grpc_error_handle error) {
         result));
     return;
   }
+  // Hand record protection to the kernel if we can, in which case the endpoint
+  // carries plaintext and needs no wrapping.
+  bool kernel_offloaded = false;
+  const int fd = grpc_endpoint_get_fd(args_->endpoint);
+  if (kernel_offload_ && fd >= 0 &&
+      frame_protector_type != TSI_FRAME_PROTECTOR_NONE) {
+    result = tsi_handshaker_result_offload_to_kernel(handshaker_result_, fd);
+    if (result == TSI_OK) {
+      kernel_offloaded = true;
+      frame_protector_type = TSI_FRAME_PROTECTOR_NONE;
+    } else if (result != TSI_UNIMPLEMENTED &&
+               result != TSI_FAILED_PRECONDITION) {
+      HandshakeFailedLocked(
+          grpc_set_tsi_error_result(GRPC_ERROR_CREATE_FROM_STATIC_STRING(
+                                        "Kernel record protection failed"),
+                                    result));
+      return;
+    }
+  }
   tsi_zero_copy_grpc_protector* zero_copy_protector = nullptr;
   tsi_frame_protector* protector = nullptr;
   switch (frame_protector_type) {
@@ -317,8 +354,8 @@ void SecurityHandshaker::OnPeerCheckedInner(grpc_error_handle error) {
       grpc_auth_context_to_arg(auth_context_.get()),
   };
   RefCountedPtr<channelz::SocketNode::Security> channelz_security;
-  // Add channelz channel args only if frame protector is created.
-  if (has_frame_protector) {
+  // Add channelz channel args only if the connection is protected.
+  if (has_frame_protector || kernel_offloaded) {
     channelz_security =
         MakeChannelzSecurityFromAuthContext(auth_context_.get());
     args_to_add.push_back(channelz_security->MakeChannelArg());
@@ -427,6 +464,40 @@ void SecurityHandshaker::OnHandshakeNextDoneGrpcWrapper(
 
 grpc_error_handle SecurityHandshaker::DoHandshakerNextLocked(
     const unsigned char* bytes_received, size_t bytes_received_size) {
+  if (!handshake_offload_) {
+    return DoHandshakerNextInlineLocked(bytes_received, bytes_received_size);
+  }
+  // Run the step on the handshake executor, which takes over the caller's
+  // ref. The bytes stay in handshake_buffer_, which is not touched again
+  // until the step completes.
+  GPR_ASSERT(bytes_received == handshake_buffer_);
+  offloaded_bytes_received_size_ = bytes_received_size;
+  Executor::Run(GRPC_CLOSURE_INIT(
+                    &on_handshaker_next_offloaded_,
+                    &SecurityHandshaker::OnHandshakerNextOffloadedFn, this,
+                    nullptr),
+                GRPC_ERROR_NONE, ExecutorType::HANDSHAKE);
+  return GRPC_ERROR_NONE;
+}
+
+void SecurityHandshaker::OnHandshakerNextOffloadedFn(
+    void* arg, grpc_error_handle /*error*/) {
+  RefCountedPtr<SecurityHandshaker> h(static_cast<SecurityHandshaker*>(arg));
+  MutexLock lock(&h->mu_);
+  grpc_error_handle error =
+      h->is_shutdown_
+          ? GRPC_ERROR_CREATE_FROM_STATIC_STRING("Handshaker shutdown")
+          : h->DoHandshakerNextInlineLocked(
+                h->handshake_buffer_, h->offloaded_bytes_received_size_);
+  if (error != GRPC_ERROR_NONE) {
+    h->HandshakeFailedLocked(error);
+  } else {
+    h.release();  // Avoid unref
+  }
+}
+
+grpc_error_handle SecurityHandshaker::DoHandshakerNextInlineLocked(
+    const unsigned char* bytes_received, size_t bytes_received_size) {
   // Invoke TSI handshaker.
   const unsigned char* bytes_to_send = nullptr;
   size_t bytes_to_send_size = 0;
@@ -23,6 +23,7 @@
 #include <stdio.h>
 #include <string.h>
 
+#include <algorithm>
 #include <atomic>
 #include <vector>
 
@@ -31,6 +32,7 @@
 
 #include <grpc/support/alloc.h>
 #include <grpc/support/atm.h>
+#include <grpc/support/cpu.h>
 #include <grpc/support/log.h>
 #include <grpc/support/string_util.h>
 #include <grpc/support/time.h>
@@ -196,7 +198,8 @@ const cq_poller_vtable g_poller_vtable_by_poller_type[] = {
 struct cq_vtable {
   grpc_cq_completion_type cq_completion_type;
   size_t data_size;
-  void (*init)(void* data, grpc_completion_queue_functor* shutdown_callback);
+  void (*init)(void* data, grpc_completion_queue_functor* shutdown_callback,
+               size_t num_shards);
   void (*shutdown)(grpc_completion_queue* cq);
   void (*destroy)(void* data);
   bool (*begin_op)(grpc_completion_queue* cq, void* tag);
@@ -241,7 +244,45 @@ class CqEventQueue {
   std::atomic<intptr_t> num_queue_items_{0};
 };
 
+/* Completed events of a GRPC_CQ_NEXT completion queue, held in one or more
+ * CqEventQueue shards. An event is pushed onto the shard of the core that
+ * completed it, and Pop() looks at the shard of the calling core first,
+ * stealing from the other shards only when that one is empty. With many
+ * threads polling one completion queue, this keeps an event on the core that
+ * produced it and spreads push/pop traffic over many cache lines. */
+class ShardedCqEventQueue {
+ public:
+  explicit ShardedCqEventQueue(size_t num_shards);
+  ~ShardedCqEventQueue();
+
+  /* Sum of the shards' eventually consistent item counts */
+  intptr_t num_items() const;
+
+  /* Counter of how many things have ever been queued, useful for avoiding
+     locks to check the queue */
+  intptr_t things_queued_ever() const;
+
+  /* Returns true if the event was the first one queued on its shard */
+  bool Push(grpc_cq_completion* c);
+  grpc_cq_completion* Pop();
+
+ private:
+  struct alignas(GPR_CACHELINE_SIZE) Shard {
+    CqEventQueue queue;
+    std::atomic<intptr_t> things_queued_ever{0};
+  };
+
+  size_t CurrentShard() const {
+    return num_shards_ == 1 ? 0 : gpr_cpu_current_cpu() % num_shards_;
+  }
+
+  const size_t num_shards_;
+  Shard* shards_;
+};
+
 struct cq_next_data {
+  explicit cq_next_data(size_t num_shards) : queue(num_shards) {}
+
   ~cq_next_data() {
     GPR_ASSERT(queue.num_items() == 0);
 #ifndef NDEBUG
@@ -252,11 +293,7 @@ struct cq_next_data {
   }
 
   /** Completed events for completion-queues of type GRPC_CQ_NEXT */
-  CqEventQueue queue;
-
-  /** Counter of how many things have ever been queued on this completion queue
-      useful for avoiding locks to check the queue */
-  std::atomic<intptr_t> things_queued_ever{0};
+  ShardedCqEventQueue queue;
 
   /** Number of outstanding events (+1 if not shut down)
       Initial count is dropped by grpc_completion_queue_shutdown */
@@ -393,13 +430,17 @@ static grpc_event cq_next(grpc_completion_queue* cq, gpr_timespec deadline,
 static grpc_event cq_pluck(grpc_completion_queue* cq, void* tag,
                            gpr_timespec deadline, void* reserved);
 
-// Note that cq_init_next and cq_init_pluck do not use the shutdown_callback
+// Note that cq_init_next and cq_init_pluck do not use the shutdown_callback,
+// and only cq_init_next uses num_shards
 static void cq_init_next(void* data,
-                         grpc_completion_queue_functor* shutdown_callback);
+                         grpc_completion_queue_functor* shutdown_callback,
+                         size_t num_shards);
 static void cq_init_pluck(void* data,
-                          grpc_completion_queue_functor* shutdown_callback);
+                          grpc_completion_queue_functor* shutdown_callback,
+                          size_t num_shards);
 static void cq_init_callback(void* data,
-                             grpc_completion_queue_functor* shutdown_callback);
+                             grpc_completion_queue_functor* shutdown_callback,
+                             size_t num_shards);
 static void cq_destroy_next(void* data);
 static void cq_destroy_pluck(void* data);
 static void cq_destroy_callback(void* data);
@@ -502,17 +543,72 @@ grpc_cq_completion* CqEventQueue::Pop() {
   return c;
 }
 
+ShardedCqEventQueue::ShardedCqEventQueue(size_t num_shards)
+    : num_shards_(num_shards) {
+  GPR_ASSERT(num_shards_ >= 1);
+  shards_ = static_cast<Shard*>(
+      gpr_malloc_aligned(num_shards_ * sizeof(Shard), GPR_CACHELINE_SIZE));
+  for (size_t i = 0; i < num_shards_; i++) {
+    new (&shards_[i]) Shard();
+  }
+}
+
+ShardedCqEventQueue::~ShardedCqEventQueue() {
+  for (size_t i = 0; i < num_shards_; i++) {
+    shards_[i].~Shard();
+  }
+  gpr_free_aligned(shards_);
+}
+
+intptr_t ShardedCqEventQueue::num_items() const {
+  intptr_t n = 0;
+  for (size_t i = 0; i < num_shards_; i++) {
+    n += shards_[i].queue.num_items();
+  }
+  return n;
+}
+
+intptr_t ShardedCqEventQueue::things_queued_ever() const {
+  intptr_t n = 0;
+  for (size_t i = 0; i < num_shards_; i++) {
+    n += shards_[i].things_queued_ever.load(std::memory_order_relaxed);
+  }
+  return n;
+}
+
+bool ShardedCqEventQueue::Push(grpc_cq_completion* c) {
+  Shard& shard = shards_[CurrentShard()];
+  bool is_first = shard.queue.Push(c);
+  shard.things_queued_ever.fetch_add(1, std::memory_order_relaxed);
+  return is_first;
+}
+
+grpc_cq_completion* ShardedCqEventQueue::Pop() {
+  const size_t home = CurrentShard();
+  grpc_cq_completion* c = shards_[home].queue.Pop();
+  if (c != nullptr || num_shards_ == 1) return c;
+  /* The local shard is empty (or contended): steal from the others, skipping
+     the ones that look empty */
+  for (size_t i = 1; i < num_shards_; i++) {
+    CqEventQueue& victim = shards_[(home + i) % num_shards_].queue;
+    if (victim.num_items() == 0) continue;
+    c = victim.Pop();
+    if (c != nullptr) return c;
+  }
+  return nullptr;
+}
+
 grpc_completion_queue* grpc_completion_queue_create_internal(
     grpc_cq_completion_type completion_type, grpc_cq_polling_type polling_type,
-    grpc_completion_queue_functor* shutdown_callback) {
+    grpc_completion_queue_functor* shutdown_callback, size_t num_shards) {
   GPR_TIMER_SCOPE("grpc_completion_queue_create_internal", 0);
 
   grpc_completion_queue* cq;
 
   GRPC_API_TRACE(
       "grpc_completion_queue_create_internal(completion_type=%d, "
-      "polling_type=%d)",
-      2, (completion_type, polling_type));
+      "polling_type=%d, num_shards=%d)",
+      3, (completion_type, polling_type, static_cast<int>(num_shards)));
 
   const cq_vtable* vtable = &g_cq_vtable[completion_type];
   const cq_poller_vtable* poller_vtable =
@@ -532,7 +628,9 @@ grpc_completion_queue* grpc_completion_queue_create_internal(
   new (&cq->owning_refs) grpc_core::RefCount(2);
 
   poller_vtable->init(POLLSET_FROM_CQ(cq), &cq->mu);
-  vtable->init(DATA_FROM_CQ(cq), shutdown_callback);
+  vtable->init(DATA_FROM_CQ(cq), shutdown_callback,
+               std::max(size_t(1),
+                        std::min(num_shards, size_t(gpr_cpu_num_cores()))));
 
   GRPC_CLOSURE_INIT(&cq->pollset_shutdown_done, on_pollset_shutdown_done, cq,
                     grpc_schedule_on_exec_ctx);
@@ -540,8 +638,9 @@ grpc_completion_queue* grpc_completion_queue_create_internal(
 }
 
 static void cq_init_next(void* data,
-                         grpc_completion_queue_functor* /*shutdown_callback*/) {
-  new (data) cq_next_data();
+                         grpc_completion_queue_functor* /*shutdown_callback*/,
+                         size_t num_shards) {
+  new (data) cq_next_data(num_shards);
 }
 
 static void cq_destroy_next(void* data) {
@@ -549,8 +648,9 @@ static void cq_destroy_next(void* data) {
   cqd->~cq_next_data();
 }
 
-static void cq_init_pluck(
-    void* data, grpc_completion_queue_functor* /*shutdown_callback*/) {
+static void cq_init_pluck(void* data,
+                          grpc_completion_queue_functor* /*shutdown_callback*/,
+                          size_t /*num_shards*/) {
   new (data) cq_pluck_data();
 }
 
@@ -560,7 +660,8 @@ static void cq_destroy_pluck(void* data) {
 }
 
 static void cq_init_callback(void* data,
-                             grpc_completion_queue_functor* shutdown_callback) {
+                             grpc_completion_queue_functor* shutdown_callback,
+                             size_t /*num_shards*/) {
   new (data) cq_callback_data(shutdown_callback);
 }
 
@@ -714,7 +815,6 @@ static void cq_end_op_for_next(
   } else {
     /* Add the completion to the queue */
     bool is_first = cqd->queue.Push(storage);
-    cqd->things_queued_ever.fetch_add(1, std::memory_order_relaxed);
     /* Since we do not hold the cq lock here, it is important to do an 'acquire'
        load here (instead of a 'no_barrier' load) to match with the release
        store
@@ -911,12 +1011,11 @@ class ExecCtxNext : public grpc_core::ExecCtx {
     GPR_ASSERT(a->stolen_completion == nullptr);
 
     intptr_t current_last_seen_things_queued_ever =
-        cqd->things_queued_ever.load(std::memory_order_relaxed);
+        cqd->queue.things_queued_ever();
 
     if (current_last_seen_things_queued_ever !=
         a->last_seen_things_queued_ever) {
-      a->last_seen_things_queued_ever =
-          cqd->things_queued_ever.load(std::memory_order_relaxed);
+      a->last_seen_things_queued_ever = current_last_seen_things_queued_ever;
 
       /* Pop a cq_completion from the queue. Returns NULL if the queue is empty
        * might return NULL in some cases even if the queue is not empty; but
@@ -976,7 +1075,7 @@ static grpc_event cq_next(grpc_completion_queue* cq, gpr_timespec deadline,
   grpc_core::Timestamp deadline_millis =
       grpc_core::Timestamp::FromTimespecRoundUp(deadline);
   cq_is_finished_arg is_finished_arg = {
-      cqd->things_queued_ever.load(std::memory_order_relaxed),
+      cqd->queue.things_queued_ever(),
       cq,
       deadline_millis,
       nullptr,
@@ -1126,6 +1225,38 @@ grpc_event grpc_completion_queue_next(grpc_completion_queue* cq,
   return cq->vtable->next(cq, deadline, reserved);
 }
 
+int grpc_completion_queue_next_batch(grpc_completion_queue* cq,
+                                     grpc_event* events, int max_events,
+                                     gpr_timespec deadline, void* reserved) {
+  GRPC_API_TRACE(
+      "grpc_completion_queue_next_batch(cq=%p, events=%p, max_events=%d)", 3,
+      (cq, events, max_events));
+  GPR_ASSERT(cq->vtable->cq_completion_type == GRPC_CQ_NEXT);
+  GPR_ASSERT(max_events > 0);
+
+  /* Block for the first event, then take whatever else is already queued
+     without polling again */
+  events[0] = cq_next(cq, deadline, reserved);
+  if (events[0].type != GRPC_OP_COMPLETE) return 1;
+
+  GRPC_CQ_INTERNAL_REF(cq, "next_batch");
+  cq_next_data* cqd = static_cast<cq_next_data*> DATA_FROM_CQ(cq);
+  grpc_core::ExecCtx exec_ctx;
+  int num_events = 1;
+  while (num_events < max_events) {
+    grpc_cq_completion* c = cqd->queue.Pop();
+    if (c == nullptr) break;
+    grpc_event* ev = &events[num_events++];
+    ev->type = GRPC_OP_COMPLETE;
+    ev->success = c->next & 1u;
+    ev->tag = c->tag;
+    c->done(c->done_arg, c);
+    GRPC_SURFACE_TRACE_RETURNED_EVENT(cq, ev);
+  }
+  GRPC_CQ_INTERNAL_UNREF(cq, "next_batch");
+  return num_events;
+}
+
 static int add_plucker(grpc_completion_queue* cq, void* tag,
                        grpc_pollset_worker** worker) {
   cq_pluck_data* cqd = static_cast<cq_pluck_data*> DATA_FROM_CQ(cq);
@@ -91,8 +91,10 @@ grpc_cq_completion_type grpc_get_cq_completion_type(grpc_completion_queue* cq);
 
 int grpc_get_cq_poll_num(grpc_completion_queue* cq);
 
+/* num_shards > 1 spreads the events of a GRPC_CQ_NEXT completion queue over
+   per-core sub-queues (see grpc_completion_queue_attributes.cq_num_shards) */
 grpc_completion_queue* grpc_completion_queue_create_internal(
     grpc_cq_completion_type completion_type, grpc_cq_polling_type polling_type,
-    grpc_completion_queue_functor* shutdown_callback);
+    grpc_completion_queue_functor* shutdown_callback, size_t num_shards = 1);
 
 #endif /* GRPC_CORE_LIB_SURFACE_COMPLETION_QUEUE_H */
@@ -31,8 +31,14 @@
 static grpc_completion_queue* default_create(
     const grpc_completion_queue_factory* /*factory*/,
     const grpc_completion_queue_attributes* attr) {
+  size_t num_shards = 1;
+  if (attr->version >= GRPC_CQ_VERSION_MINIMUM_FOR_SHARDING &&
+      attr->cq_num_shards > 1) {
+    num_shards = static_cast<size_t>(attr->cq_num_shards);
+  }
   return grpc_completion_queue_create_internal(
-      attr->cq_completion_type, attr->cq_polling_type, attr->cq_shutdown_cb);
+      attr->cq_completion_type, attr->cq_polling_type, attr->cq_shutdown_cb,
+      num_shards);
 }
 
 static grpc_completion_queue_factory_vtable default_vtable = {default_create};
@@ -49,8 +55,8 @@ const grpc_completion_queue_factory* grpc_completion_queue_factory_lookup(
   GPR_ASSERT(attributes->version >= 1 &&
              attributes->version <= GRPC_CQ_CURRENT_VERSION);
 
-  /* The default factory can handle version 1 of the attributes structure. We
-     may have to change this as more fields are added to the structure */
+  /* The default factory can handle all versions of the attributes structure.
+     We may have to change this as more fields are added to the structure */
   return &g_default_cq_factory;
 }
 
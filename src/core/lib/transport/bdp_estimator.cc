@@ -23,12 +23,40 @@
 #include <inttypes.h>
 #include <stdlib.h>
 
+#include <algorithm>
+
 #include "src/core/lib/gpr/useful.h"
 
 grpc_core::TraceFlag grpc_bdp_estimator_trace(false, "bdp_estimator");
 
 namespace grpc_core {
 
+constexpr double DeliveryRateEstimator::kStartupGain;
+constexpr double DeliveryRateEstimator::kSteadyGain;
+constexpr int DeliveryRateEstimator::kFilterLength;
+constexpr double DeliveryRateEstimator::kFullPipeGrowth;
+constexpr int DeliveryRateEstimator::kFullPipeRounds;
+
+void DeliveryRateEstimator::AddSample(int64_t bytes, double seconds) {
+  if (bytes <= 0 || seconds <= 0) return;
+  samples_[next_sample_] = {static_cast<double>(bytes) / seconds, seconds};
+  next_sample_ = (next_sample_ + 1) % kFilterLength;
+  if (num_samples_ < kFilterLength) num_samples_++;
+  max_bandwidth_ = samples_[0].bandwidth;
+  min_rtt_ = samples_[0].rtt;
+  for (int i = 1; i < num_samples_; i++) {
+    max_bandwidth_ = std::max(max_bandwidth_, samples_[i].bandwidth);
+    min_rtt_ = std::min(min_rtt_, samples_[i].rtt);
+  }
+  if (filled_pipe_) return;
+  if (max_bandwidth_ >= full_bandwidth_ * kFullPipeGrowth) {
+    full_bandwidth_ = max_bandwidth_;
+    full_bandwidth_rounds_ = 0;
+  } else if (++full_bandwidth_rounds_ >= kFullPipeRounds) {
+    filled_pipe_ = true;
+  }
+}
+
 BdpEstimator::BdpEstimator(const char* name)
     : ping_state_(PingState::UNSCHEDULED),
       accumulator_(0),
@@ -54,6 +82,8 @@ Timestamp BdpEstimator::CompletePing() {
             bw_est_ / 125000.0);
   }
   GPR_ASSERT(ping_state_ == PingState::STARTED);
+  delivery_rate_.AddSample(accumulator_, dt);
+  completed_pings_++;
   if (accumulator_ > 2 * estimate_ / 3 && bw > bw_est_) {
     estimate_ = std::max(accumulator_, estimate_ * 2);
     bw_est_ = bw;
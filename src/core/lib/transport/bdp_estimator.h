@@ -35,6 +35,59 @@ extern grpc_core::TraceFlag grpc_bdp_estimator_trace;
 
 namespace grpc_core {
 
+// Estimates the bandwidth and round trip time of a path from (bytes delivered,
+// interval) samples, in the style of BBR: bandwidth is the maximum delivery
+// rate over the last few samples, latency the minimum round trip. While the
+// bandwidth estimate keeps growing the path is assumed not yet full, and the
+// suggested window is inflated so that the sender can double its rate every
+// round trip.
+class DeliveryRateEstimator {
+ public:
+  // Gain applied to the bandwidth-delay product while probing for bandwidth:
+  // 2/ln(2), enough to double the delivery rate each round trip.
+  static constexpr double kStartupGain = 2.885;
+  // Gain once the path is full, leaving headroom for bandwidth to grow.
+  static constexpr double kSteadyGain = 2.0;
+
+  // Record that \a bytes were delivered over \a seconds, which should
+  // approximate one round trip. Empty samples are ignored.
+  void AddSample(int64_t bytes, double seconds);
+
+  // Bytes per second; 0 before the first sample.
+  double max_bandwidth() const { return max_bandwidth_; }
+  // Seconds; 0 before the first sample.
+  double min_rtt() const { return min_rtt_; }
+  // True until the bandwidth estimate stops growing.
+  bool probing() const { return !filled_pipe_; }
+  double gain() const { return filled_pipe_ ? kSteadyGain : kStartupGain; }
+  // Window, in bytes, that keeps the path busy: gain * bandwidth * latency.
+  double TargetWindow() const {
+    return gain() * max_bandwidth_ * min_rtt_;
+  }
+
+ private:
+  // Number of most recent samples the bandwidth and latency filters cover.
+  static constexpr int kFilterLength = 10;
+  // The pipe is considered full once the bandwidth estimate fails to grow by
+  // kFullPipeGrowth over kFullPipeRounds consecutive samples.
+  static constexpr double kFullPipeGrowth = 1.25;
+  static constexpr int kFullPipeRounds = 3;
+
+  struct Sample {
+    double bandwidth;
+    double rtt;
+  };
+
+  Sample samples_[kFilterLength] = {};
+  int num_samples_ = 0;
+  int next_sample_ = 0;
+  double max_bandwidth_ = 0;
+  double min_rtt_ = 0;
+  bool filled_pipe_ = false;
+  double full_bandwidth_ = 0;
+  int full_bandwidth_rounds_ = 0;
+};
+
 class BdpEstimator {
  public:
   explicit BdpEstimator(const char* name);
@@ -76,6 +129,11 @@ class BdpEstimator {
 
   int64_t accumulator() { return accumulator_; }
 
+  // Delivery rate samples taken from every completed ping.
+  const DeliveryRateEstimator& delivery_rate() const { return delivery_rate_; }
+  // Number of pings completed so far.
+  int64_t completed_pings() const { return completed_pings_; }
+
  private:
   enum class PingState { UNSCHEDULED, SCHEDULED, STARTED };
 
@@ -88,6 +146,8 @@ class BdpEstimator {
   int stable_estimate_count_;
   double bw_est_;
   const char* name_;
+  DeliveryRateEstimator delivery_rate_;
+  int64_t completed_pings_ = 0;
 };
 
 }  // namespace grpc_core
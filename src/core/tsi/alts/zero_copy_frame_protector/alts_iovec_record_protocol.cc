@@ -23,6 +23,8 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include <algorithm>
+
 #include <grpc/support/alloc.h>
 #include <grpc/support/log.h>
 
@@ -34,6 +36,9 @@ struct alts_iovec_record_protocol {
   size_t tag_length;
   bool is_integrity_only;
   bool is_protect;
+  /* Scratch iovec array describing the data of one frame in a batch.  */
+  iovec_t* frame_vec;
+  size_t frame_vec_length;
 };
 
 /* Copies error message to destination.  */
@@ -160,6 +165,74 @@ static grpc_status_code verify_frame_header(size_t data_length,
   return GRPC_STATUS_OK;
 }
 
+/* Points rp->frame_vec at the next data_length bytes of vec, starting at
+ * entry *vec_index and offset *vec_offset, and advances both past them. Returns
+ * the number of rp->frame_vec entries used.  */
+static size_t next_frame_vec(alts_iovec_record_protocol* rp,
+                             const iovec_t* vec, size_t vec_length,
+                             size_t data_length, size_t* vec_index,
+                             size_t* vec_offset) {
+  size_t count = 0;
+  while (data_length > 0) {
+    GPR_ASSERT(*vec_index < vec_length);
+    const iovec_t& entry = vec[*vec_index];
+    size_t length = std::min(entry.iov_len - *vec_offset, data_length);
+    if (length > 0) {
+      if (count == rp->frame_vec_length) {
+        rp->frame_vec_length = std::max<size_t>(8, 2 * rp->frame_vec_length);
+        rp->frame_vec = static_cast<iovec_t*>(gpr_realloc(
+            rp->frame_vec, rp->frame_vec_length * sizeof(iovec_t)));
+      }
+      rp->frame_vec[count].iov_base =
+          static_cast<unsigned char*>(entry.iov_base) + *vec_offset;
+      rp->frame_vec[count].iov_len = length;
+      ++count;
+    }
+    *vec_offset += length;
+    data_length -= length;
+    if (*vec_offset == entry.iov_len) {
+      ++*vec_index;
+      *vec_offset = 0;
+    }
+  }
+  return count;
+}
+
+/* Writes a privacy-integrity protected frame holding data_length bytes of
+ * unprotected data to frame, which must have room for the header and tag.  */
+static grpc_status_code privacy_integrity_protect_frame(
+    alts_iovec_record_protocol* rp, const iovec_t* unprotected_vec,
+    size_t unprotected_vec_length, size_t data_length, unsigned char* frame,
+    char** error_details) {
+  /* Writer frame header.  */
+  grpc_status_code status =
+      write_frame_header(data_length + rp->tag_length, frame, error_details);
+  if (status != GRPC_STATUS_OK) {
+    return status;
+  }
+  /* Encrypt unprotected data by calling AEAD crypter.  */
+  unsigned char* ciphertext_buffer =
+      frame + alts_iovec_record_protocol_get_header_length();
+  iovec_t ciphertext = {ciphertext_buffer, data_length + rp->tag_length};
+  size_t bytes_written = 0;
+  status = gsec_aead_crypter_encrypt_iovec(
+      rp->crypter, alts_counter_get_counter(rp->ctr),
+      alts_counter_get_size(rp->ctr), /* aad_vec = */ nullptr,
+      /* aad_vec_length = */ 0, unprotected_vec, unprotected_vec_length,
+      ciphertext, &bytes_written, error_details);
+  if (status != GRPC_STATUS_OK) {
+    return status;
+  }
+  if (bytes_written != data_length + rp->tag_length) {
+    maybe_copy_error_msg(
+        "Bytes written expects to be data length plus tag length.",
+        error_details);
+    return GRPC_STATUS_INTERNAL;
+  }
+  /* Increments the crypter counter. */
+  return increment_counter(rp->ctr, error_details);
+}
+
 /* --- alts_iovec_record_protocol methods implementation. --- */
 
 size_t alts_iovec_record_protocol_get_header_length() {
@@ -323,35 +396,9 @@ grpc_status_code alts_iovec_record_protocol_privacy_integrity_protect(
     maybe_copy_error_msg("Protected frame size is incorrect.", error_details);
     return GRPC_STATUS_INVALID_ARGUMENT;
   }
-  /* Writer frame header.  */
-  grpc_status_code status = write_frame_header(
-      data_length + rp->tag_length,
+  return privacy_integrity_protect_frame(
+      rp, unprotected_vec, unprotected_vec_length, data_length,
       static_cast<unsigned char*>(protected_frame.iov_base), error_details);
-  if (status != GRPC_STATUS_OK) {
-    return status;
-  }
-  /* Encrypt unprotected data by calling AEAD crypter.  */
-  unsigned char* ciphertext_buffer =
-      static_cast<unsigned char*>(protected_frame.iov_base) +
-      alts_iovec_record_protocol_get_header_length();
-  iovec_t ciphertext = {ciphertext_buffer, data_length + rp->tag_length};
-  size_t bytes_written = 0;
-  status = gsec_aead_crypter_encrypt_iovec(
-      rp->crypter, alts_counter_get_counter(rp->ctr),
-      alts_counter_get_size(rp->ctr), /* aad_vec = */ nullptr,
-      /* aad_vec_length = */ 0, unprotected_vec, unprotected_vec_length,
-      ciphertext, &bytes_written, error_details);
-  if (status != GRPC_STATUS_OK) {
-    return status;
-  }
-  if (bytes_written != data_length + rp->tag_length) {
-    maybe_copy_error_msg(
-        "Bytes written expects to be data length plus tag length.",
-        error_details);
-    return GRPC_STATUS_INTERNAL;
-  }
-  /* Increments the crypter counter. */
-  return increment_counter(rp->ctr, error_details);
 }
 
 grpc_status_code alts_iovec_record_protocol_privacy_integrity_unprotect(
@@ -426,6 +473,181 @@ grpc_status_code alts_iovec_record_protocol_privacy_integrity_unprotect(
   return increment_counter(rp->ctr, error_details);
 }
 
+size_t alts_iovec_record_protocol_protected_frames_length(
+    const alts_iovec_record_protocol* rp, size_t unprotected_data_length,
+    size_t max_unprotected_frame_size) {
+  if (rp == nullptr || max_unprotected_frame_size == 0) {
+    return 0;
+  }
+  size_t num_frames = std::max<size_t>(
+      1, (unprotected_data_length + max_unprotected_frame_size - 1) /
+             max_unprotected_frame_size);
+  return unprotected_data_length +
+         num_frames *
+             (alts_iovec_record_protocol_get_header_length() + rp->tag_length);
+}
+
+grpc_status_code alts_iovec_record_protocol_privacy_integrity_protect_frames(
+    alts_iovec_record_protocol* rp, const iovec_t* unprotected_vec,
+    size_t unprotected_vec_length, size_t max_unprotected_frame_size,
+    iovec_t protected_frames, char** error_details) {
+  /* Input sanity checks.  */
+  if (rp == nullptr) {
+    maybe_copy_error_msg("Input iovec_record_protocol is nullptr.",
+                         error_details);
+    return GRPC_STATUS_INVALID_ARGUMENT;
+  }
+  if (rp->is_integrity_only) {
+    maybe_copy_error_msg(
+        "Privacy-integrity operations are not allowed for this object.",
+        error_details);
+    return GRPC_STATUS_FAILED_PRECONDITION;
+  }
+  if (!rp->is_protect) {
+    maybe_copy_error_msg("Protect operations are not allowed for this object.",
+                         error_details);
+    return GRPC_STATUS_FAILED_PRECONDITION;
+  }
+  if (max_unprotected_frame_size == 0) {
+    maybe_copy_error_msg("Maximum unprotected frame size is zero.",
+                         error_details);
+    return GRPC_STATUS_INVALID_ARGUMENT;
+  }
+  size_t data_length =
+      get_total_length(unprotected_vec, unprotected_vec_length);
+  /* Ensures protected frames iovec has sufficient size.  */
+  if (protected_frames.iov_base == nullptr) {
+    maybe_copy_error_msg("Protected frames is nullptr.", error_details);
+    return GRPC_STATUS_INVALID_ARGUMENT;
+  }
+  if (protected_frames.iov_len !=
+      alts_iovec_record_protocol_protected_frames_length(
+          rp, data_length, max_unprotected_frame_size)) {
+    maybe_copy_error_msg("Protected frames size is incorrect.", error_details);
+    return GRPC_STATUS_INVALID_ARGUMENT;
+  }
+  /* Seals one frame at a time, reading straight from unprotected_vec.  */
+  unsigned char* frame = static_cast<unsigned char*>(protected_frames.iov_base);
+  size_t vec_index = 0;
+  size_t vec_offset = 0;
+  do {
+    size_t frame_data_length =
+        std::min(data_length, max_unprotected_frame_size);
+    size_t frame_vec_length =
+        next_frame_vec(rp, unprotected_vec, unprotected_vec_length,
+                       frame_data_length, &vec_index, &vec_offset);
+    grpc_status_code status = privacy_integrity_protect_frame(
+        rp, rp->frame_vec, frame_vec_length, frame_data_length, frame,
+        error_details);
+    if (status != GRPC_STATUS_OK) {
+      return status;
+    }
+    frame += alts_iovec_record_protocol_get_header_length() +
+             frame_data_length + rp->tag_length;
+    data_length -= frame_data_length;
+  } while (data_length > 0);
+  return GRPC_STATUS_OK;
+}
+
+grpc_status_code alts_iovec_record_protocol_privacy_integrity_unprotect_frames(
+    alts_iovec_record_protocol* rp, iovec_t protected_frames,
+    iovec_t* unprotected_data, size_t unprotected_data_length,
+    size_t* num_frames, char** error_details) {
+  /* Input sanity checks.  */
+  if (rp == nullptr) {
+    maybe_copy_error_msg("Input iovec_record_protocol is nullptr.",
+                         error_details);
+    return GRPC_STATUS_INVALID_ARGUMENT;
+  }
+  if (rp->is_integrity_only) {
+    maybe_copy_error_msg(
+        "Privacy-integrity operations are not allowed for this object.",
+        error_details);
+    return GRPC_STATUS_FAILED_PRECONDITION;
+  }
+  if (rp->is_protect) {
+    maybe_copy_error_msg(
+        "Unprotect operations are not allowed for this object.", error_details);
+    return GRPC_STATUS_FAILED_PRECONDITION;
+  }
+  if (num_frames == nullptr) {
+    maybe_copy_error_msg("Number of frames is nullptr.", error_details);
+    return GRPC_STATUS_INVALID_ARGUMENT;
+  }
+  *num_frames = 0;
+  if (protected_frames.iov_base == nullptr && protected_frames.iov_len > 0) {
+    maybe_copy_error_msg("Protected frames is nullptr.", error_details);
+    return GRPC_STATUS_INVALID_ARGUMENT;
+  }
+  /* Verifies every frame header before touching any frame.  */
+  size_t header_length = alts_iovec_record_protocol_get_header_length();
+  unsigned char* frame = static_cast<unsigned char*>(protected_frames.iov_base);
+  size_t remaining = protected_frames.iov_len;
+  size_t count = 0;
+  while (remaining > 0) {
+    if (remaining < header_length) {
+      maybe_copy_error_msg("Protected frames end in a partial frame header.",
+                           error_details);
+      return GRPC_STATUS_INVALID_ARGUMENT;
+    }
+    size_t frame_length = load_32_le(frame);
+    if (frame_length < kZeroCopyFrameMessageTypeFieldSize + rp->tag_length) {
+      maybe_copy_error_msg("Bad frame length.", error_details);
+      return GRPC_STATUS_INTERNAL;
+    }
+    size_t protected_data_length =
+        frame_length - kZeroCopyFrameMessageTypeFieldSize;
+    if (remaining - header_length < protected_data_length) {
+      maybe_copy_error_msg("Protected frames end in a partial frame.",
+                           error_details);
+      return GRPC_STATUS_INVALID_ARGUMENT;
+    }
+    grpc_status_code status =
+        verify_frame_header(protected_data_length, frame, error_details);
+    if (status != GRPC_STATUS_OK) {
+      return status;
+    }
+    if (count == unprotected_data_length) {
+      maybe_copy_error_msg("Unprotected data array is too small.",
+                           error_details);
+      return GRPC_STATUS_INVALID_ARGUMENT;
+    }
+    unprotected_data[count].iov_base = frame + header_length;
+    unprotected_data[count].iov_len = protected_data_length - rp->tag_length;
+    ++count;
+    frame += header_length + protected_data_length;
+    remaining -= header_length + protected_data_length;
+  }
+  /* Decrypts each frame over its own ciphertext.  */
+  for (size_t i = 0; i < count; ++i) {
+    iovec_t ciphertext = {unprotected_data[i].iov_base,
+                          unprotected_data[i].iov_len + rp->tag_length};
+    size_t bytes_written = 0;
+    grpc_status_code status = gsec_aead_crypter_decrypt_iovec(
+        rp->crypter, alts_counter_get_counter(rp->ctr),
+        alts_counter_get_size(rp->ctr), /* aad_vec = */ nullptr,
+        /* aad_vec_length = */ 0, &ciphertext, 1, unprotected_data[i],
+        &bytes_written, error_details);
+    if (status != GRPC_STATUS_OK) {
+      maybe_append_error_msg(" Frame decryption failed.", error_details);
+      return GRPC_STATUS_INTERNAL;
+    }
+    if (bytes_written != unprotected_data[i].iov_len) {
+      maybe_copy_error_msg(
+          "Bytes written expects to be protected data length minus tag "
+          "length.",
+          error_details);
+      return GRPC_STATUS_INTERNAL;
+    }
+    status = increment_counter(rp->ctr, error_details);
+    if (status != GRPC_STATUS_OK) {
+      return status;
+    }
+  }
+  *num_frames = count;
+  return GRPC_STATUS_OK;
+}
+
 grpc_status_code alts_iovec_record_protocol_create(
     gsec_aead_crypter* crypter, size_t overflow_size, bool is_client,
     bool is_integrity_only, bool is_protect, alts_iovec_record_protocol** rp,
@@ -473,6 +695,7 @@ void alts_iovec_record_protocol_destroy(alts_iovec_record_protocol* rp) {
   if (rp != nullptr) {
     alts_counter_destroy(rp->ctr);
     gsec_aead_crypter_destroy(rp->crypter);
+    gpr_free(rp->frame_vec);
     gpr_free(rp);
   }
 }
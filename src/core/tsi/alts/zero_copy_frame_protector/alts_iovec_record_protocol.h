@@ -159,6 +159,76 @@ grpc_status_code alts_iovec_record_protocol_privacy_integrity_unprotect(
     const iovec_t* protected_vec, size_t protected_vec_length,
     iovec_t unprotected_data, char** error_details);
 
+/**
+ * This method returns the size of the buffer needed by
+ * alts_iovec_record_protocol_privacy_integrity_protect_frames() to protect
+ * unprotected_data_length bytes of data, when each frame carries at most
+ * max_unprotected_frame_size bytes of it.
+ *
+ * - rp: an alts_iovec_record_protocol instance.
+ * - unprotected_data_length: total length of the unprotected data.
+ * - max_unprotected_frame_size: maximum unprotected data size of a frame.
+ *
+ * On success, the method returns the total length of the protected frames.
+ * Otherwise, it returns zero.
+ */
+size_t alts_iovec_record_protocol_protected_frames_length(
+    const alts_iovec_record_protocol* rp, size_t unprotected_data_length,
+    size_t max_unprotected_frame_size);
+
+/**
+ * This method performs privacy-integrity protect operation on a batch of
+ * frames. The unprotected data is split into frames of at most
+ * max_unprotected_frame_size bytes, which are written back to back into
+ * protected_frames. At least one frame is written, even for empty data. The
+ * record protocol state is checked once for the whole batch, and no memory is
+ * allocated per frame.
+ *
+ * - rp: an alts_iovec_record_protocol instance.
+ * - unprotected_vec: an iovec array containing unprotected data.
+ * - unprotected_vec_length: the array length of unprotected_vec.
+ * - max_unprotected_frame_size: maximum unprotected data size of a frame.
+ * - protected_frames: an iovec containing the output protected frames. Its
+ *   length must be the one returned by
+ *   alts_iovec_record_protocol_protected_frames_length().
+ * - error_details: a buffer containing an error message if the method does not
+ *   function correctly. It is OK to pass nullptr into error_details.
+ *
+ * On success, the method returns GRPC_STATUS_OK. Otherwise, it returns an
+ * error status code along with its details specified in error_details (if
+ * error_details is not nullptr).
+ */
+grpc_status_code alts_iovec_record_protocol_privacy_integrity_protect_frames(
+    alts_iovec_record_protocol* rp, const iovec_t* unprotected_vec,
+    size_t unprotected_vec_length, size_t max_unprotected_frame_size,
+    iovec_t protected_frames, char** error_details);
+
+/**
+ * This method performs privacy-integrity unprotect operation in place on a
+ * batch of full frames stored back to back in protected_frames. All frame
+ * headers are verified before any frame is decrypted. The unprotected data of
+ * each frame is written over its ciphertext, and unprotected_data[i] is set to
+ * point at the data of the i-th frame.
+ *
+ * - rp: an alts_iovec_record_protocol instance.
+ * - protected_frames: an iovec containing whole protected frames.
+ * - unprotected_data: an iovec array receiving the unprotected data of each
+ *   frame.
+ * - unprotected_data_length: the array length of unprotected_data.
+ * - num_frames: the number of frames unprotected.
+ * - error_details: a buffer containing an error message if the method does not
+ *   function correctly. It is OK to pass nullptr into error_details.
+ *
+ * On success, the method returns GRPC_STATUS_OK. Otherwise, it returns an
+ * error status code along with its details specified in error_details (if
+ * error_details is not nullptr), and the content of protected_frames is
+ * unspecified.
+ */
+grpc_status_code alts_iovec_record_protocol_privacy_integrity_unprotect_frames(
+    alts_iovec_record_protocol* rp, iovec_t protected_frames,
+    iovec_t* unprotected_data, size_t unprotected_data_length,
+    size_t* num_frames, char** error_details);
+
 /**
  * This method creates an alts_iovec_record_protocol instance, given a
  * gsec_aead_crypter instance, a flag indicating if the created instance will be
@@ -562,6 +562,7 @@ static const tsi_handshaker_result_vtable handshaker_result_vtable = {
     fake_handshaker_result_create_zero_copy_grpc_protector,
     fake_handshaker_result_create_frame_protector,
     fake_handshaker_result_get_unused_bytes,
+    nullptr, /* offload_to_kernel */
     fake_handshaker_result_destroy,
 };
 
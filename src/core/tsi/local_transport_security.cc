@@ -95,6 +95,7 @@ const tsi_handshaker_result_vtable result_vtable = {
     nullptr, /* handshaker_result_create_zero_copy_grpc_protector */
     nullptr, /* handshaker_result_create_frame_protector */
     handshaker_result_get_unused_bytes,
+    nullptr, /* handshaker_result_offload_to_kernel */
     handshaker_result_destroy};
 
 tsi_result create_handshaker_result(const unsigned char* received_bytes,
@@ -16,19 +16,57 @@
  *
  */
 
+
 #include <grpc/support/port_platform.h>
 
 #include "src/core/tsi/ssl/session_cache/ssl_session_cache.h"
 
+#include <functional>
+#include <map>
+
 #include <grpc/support/log.h>
 #include <grpc/support/string_util.h>
+#include <grpc/support/time.h>
 
+#include "src/core/lib/debug/stats.h"
+#include "src/core/lib/gpr/useful.h"
 #include "src/core/lib/gprpp/sync.h"
+#include "src/core/lib/iomgr/exec_ctx.h"
 #include "src/core/lib/slice/slice_internal.h"
 #include "src/core/tsi/ssl/session_cache/ssl_session.h"
 
 namespace tsi {
 
+namespace {
+
+// Caches smaller than this many sessions per shard are not split, so that
+// small caches keep evicting in exact LRU order.
+constexpr size_t kMinShardCapacity = 64;
+constexpr size_t kMaxShards = 16;
+
+int64_t NowSeconds() { return gpr_now(GPR_CLOCK_REALTIME).tv_sec; }
+
+// Stats are kept per CPU and indexed through the current ExecCtx. The cache is
+// also used by TSI code that runs without one, in which case nothing is
+// recorded.
+void RecordLookup(bool hit) {
+  if (grpc_core::ExecCtx::Get() == nullptr) return;
+  if (hit) {
+    GRPC_STATS_INC_SSL_SESSION_CACHE_HITS();
+  } else {
+    GRPC_STATS_INC_SSL_SESSION_CACHE_MISSES();
+  }
+}
+
+void RecordEvictions(size_t evictions) {
+  if (grpc_core::ExecCtx::Get() == nullptr) return;
+  for (size_t i = 0; i < evictions; i++) {
+    GRPC_STATS_INC_SSL_SESSION_CACHE_EVICTIONS();
+  }
+}
+
+}  // namespace
+
 /// Node for single cached session.
 class SslSessionLRUCache::Node {
  public:
@@ -47,133 +85,217 @@ class SslSessionLRUCache::Node {
 
   /// Set the \a session (which is moved) for the node.
   void SetSession(SslSessionPtr session) {
+    expiry_ = static_cast<int64_t>(SSL_SESSION_get_time(session.get())) +
+              static_cast<int64_t>(SSL_SESSION_get_timeout(session.get()));
     session_ = SslCachedSession::Create(std::move(session));
   }
 
+  /// Returns true if the session can no longer be resumed at \a now (in
+  /// seconds since the epoch).
+  bool Expired(int64_t now) const { return expiry_ <= now; }
+
  private:
-  friend class SslSessionLRUCache;
+  friend class SslSessionLRUCache::Shard;
 
   std::string key_;
   std::unique_ptr<SslCachedSession> session_;
+  int64_t expiry_;
 
   Node* next_ = nullptr;
   Node* prev_ = nullptr;
 };
 
-SslSessionLRUCache::SslSessionLRUCache(size_t capacity) : capacity_(capacity) {
-  GPR_ASSERT(capacity > 0);
-}
+/// An independently locked LRU list holding part of the cache's keys.
+class SslSessionLRUCache::Shard {
+ public:
+  Shard() = default;
+  ~Shard() {
+    Node* node = use_order_list_head_;
+    while (node) {
+      Node* next = node->next_;
+      delete node;
+      node = next;
+    }
+  }
 
-SslSessionLRUCache::~SslSessionLRUCache() {
-  Node* node = use_order_list_head_;
-  while (node) {
-    Node* next = node->next_;
-    delete node;
-    node = next;
+  // Not copyable nor movable.
+  Shard(const Shard&) = delete;
+  Shard& operator=(const Shard&) = delete;
+
+  void set_capacity(size_t capacity) { capacity_ = capacity; }
+
+  size_t Size() {
+    grpc_core::MutexLock lock(&lock_);
+    return use_order_list_size_;
   }
-}
 
-size_t SslSessionLRUCache::Size() {
-  grpc_core::MutexLock lock(&lock_);
-  return use_order_list_size_;
-}
+  /// Returns the number of sessions evicted to make room.
+  size_t Put(const std::string& key, SslSessionPtr session, int64_t now) {
+    grpc_core::MutexLock lock(&lock_);
+    Node* node = FindLocked(key);
+    if (node != nullptr) {
+      node->SetSession(std::move(session));
+    } else {
+      node = new Node(key, std::move(session));
+      PushFront(node);
+      entry_by_key_.emplace(key, node);
+      AssertInvariants();
+    }
+    return EvictLocked(now);
+  }
 
-SslSessionLRUCache::Node* SslSessionLRUCache::FindLocked(
-    const std::string& key) {
-  auto it = entry_by_key_.find(key);
-  if (it == entry_by_key_.end()) {
-    return nullptr;
-  }
-  Node* node = it->second;
-  // Move to the beginning.
-  Remove(node);
-  PushFront(node);
-  AssertInvariants();
-  return node;
-}
+  /// Sets \a evictions to the number of expired sessions dropped.
+  SslSessionPtr Get(const std::string& key, int64_t now, size_t* evictions) {
+    grpc_core::MutexLock lock(&lock_);
+    Node* node = FindLocked(key);
+    if (node == nullptr) return nullptr;
+    if (node->Expired(now)) {
+      Erase(node);
+      *evictions = 1;
+      return nullptr;
+    }
+    return node->CopySession();
+  }
 
-void SslSessionLRUCache::Put(const char* key, SslSessionPtr session) {
-  grpc_core::MutexLock lock(&lock_);
-  Node* node = FindLocked(key);
-  if (node != nullptr) {
-    node->SetSession(std::move(session));
-    return;
-  }
-  node = new Node(key, std::move(session));
-  PushFront(node);
-  entry_by_key_.emplace(key, node);
-  AssertInvariants();
-  if (use_order_list_size_ > capacity_) {
-    GPR_ASSERT(use_order_list_tail_);
-    node = use_order_list_tail_;
+ private:
+  Node* FindLocked(const std::string& key)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(lock_) {
+    auto it = entry_by_key_.find(key);
+    if (it == entry_by_key_.end()) {
+      return nullptr;
+    }
+    Node* node = it->second;
+    // Move to the beginning.
+    Remove(node);
+    PushFront(node);
+    AssertInvariants();
+    return node;
+  }
+
+  // Drops sessions from the cold end of the list while the shard is over
+  // capacity or they have expired.
+  size_t EvictLocked(int64_t now) ABSL_EXCLUSIVE_LOCKS_REQUIRED(lock_) {
+    size_t evictions = 0;
+    while (use_order_list_tail_ != nullptr &&
+           (use_order_list_size_ > capacity_ ||
+            use_order_list_tail_->Expired(now))) {
+      Erase(use_order_list_tail_);
+      evictions++;
+    }
+    return evictions;
+  }
+
+  void Erase(Node* node) ABSL_EXCLUSIVE_LOCKS_REQUIRED(lock_) {
     Remove(node);
     // Order matters, key is destroyed after deleting node.
     entry_by_key_.erase(node->key());
     delete node;
     AssertInvariants();
   }
-}
 
-SslSessionPtr SslSessionLRUCache::Get(const char* key) {
-  grpc_core::MutexLock lock(&lock_);
-  // Key is only used for lookups.
-  Node* node = FindLocked(key);
-  if (node == nullptr) {
-    return nullptr;
+  void Remove(Node* node) ABSL_EXCLUSIVE_LOCKS_REQUIRED(lock_) {
+    if (node->prev_ == nullptr) {
+      use_order_list_head_ = node->next_;
+    } else {
+      node->prev_->next_ = node->next_;
+    }
+    if (node->next_ == nullptr) {
+      use_order_list_tail_ = node->prev_;
+    } else {
+      node->next_->prev_ = node->prev_;
+    }
+    GPR_ASSERT(use_order_list_size_ >= 1);
+    use_order_list_size_--;
   }
-  return node->CopySession();
-}
 
-void SslSessionLRUCache::Remove(SslSessionLRUCache::Node* node) {
-  if (node->prev_ == nullptr) {
-    use_order_list_head_ = node->next_;
-  } else {
-    node->prev_->next_ = node->next_;
+  void PushFront(Node* node) ABSL_EXCLUSIVE_LOCKS_REQUIRED(lock_) {
+    if (use_order_list_head_ == nullptr) {
+      use_order_list_head_ = node;
+      use_order_list_tail_ = node;
+      node->next_ = nullptr;
+      node->prev_ = nullptr;
+    } else {
+      node->next_ = use_order_list_head_;
+      node->next_->prev_ = node;
+      use_order_list_head_ = node;
+      node->prev_ = nullptr;
+    }
+    use_order_list_size_++;
   }
-  if (node->next_ == nullptr) {
-    use_order_list_tail_ = node->prev_;
-  } else {
-    node->next_->prev_ = node->prev_;
+
+#ifndef NDEBUG
+  void AssertInvariants() ABSL_EXCLUSIVE_LOCKS_REQUIRED(lock_) {
+    size_t size = 0;
+    Node* prev = nullptr;
+    Node* current = use_order_list_head_;
+    while (current != nullptr) {
+      size++;
+      GPR_ASSERT(current->prev_ == prev);
+      auto it = entry_by_key_.find(current->key());
+      GPR_ASSERT(it != entry_by_key_.end());
+      GPR_ASSERT(it->second == current);
+      prev = current;
+      current = current->next_;
+    }
+    GPR_ASSERT(prev == use_order_list_tail_);
+    GPR_ASSERT(size == use_order_list_size_);
+    GPR_ASSERT(entry_by_key_.size() == use_order_list_size_);
   }
-  GPR_ASSERT(use_order_list_size_ >= 1);
-  use_order_list_size_--;
-}
+#else
+  void AssertInvariants() {}
+#endif
 
-void SslSessionLRUCache::PushFront(SslSessionLRUCache::Node* node) {
-  if (use_order_list_head_ == nullptr) {
-    use_order_list_head_ = node;
-    use_order_list_tail_ = node;
-    node->next_ = nullptr;
-    node->prev_ = nullptr;
-  } else {
-    node->next_ = use_order_list_head_;
-    node->next_->prev_ = node;
-    use_order_list_head_ = node;
-    node->prev_ = nullptr;
+  grpc_core::Mutex lock_;
+  size_t capacity_ = 0;
+
+  Node* use_order_list_head_ ABSL_GUARDED_BY(lock_) = nullptr;
+  Node* use_order_list_tail_ ABSL_GUARDED_BY(lock_) = nullptr;
+  size_t use_order_list_size_ ABSL_GUARDED_BY(lock_) = 0;
+  std::map<std::string, Node*> entry_by_key_ ABSL_GUARDED_BY(lock_);
+};
+
+SslSessionLRUCache::SslSessionLRUCache(size_t capacity)
+    : num_shards_(grpc_core::Clamp(capacity / kMinShardCapacity, size_t(1),
+                                   kMaxShards)),
+      shards_(new Shard[num_shards_]) {
+  GPR_ASSERT(capacity > 0);
+  // Spread the capacity so that the shards add up to exactly \a capacity.
+  for (size_t i = 0; i < num_shards_; i++) {
+    shards_[i].set_capacity(capacity / num_shards_ +
+                            (i < capacity % num_shards_ ? 1 : 0));
   }
-  use_order_list_size_++;
 }
 
-#ifndef NDEBUG
-void SslSessionLRUCache::AssertInvariants() {
+SslSessionLRUCache::~SslSessionLRUCache() = default;
+
+SslSessionLRUCache::Shard* SslSessionLRUCache::ShardForKey(
+    const std::string& key) {
+  return &shards_[std::hash<std::string>()(key) % num_shards_];
+}
+
+size_t SslSessionLRUCache::Size() {
   size_t size = 0;
-  Node* prev = nullptr;
-  Node* current = use_order_list_head_;
-  while (current != nullptr) {
-    size++;
-    GPR_ASSERT(current->prev_ == prev);
-    auto it = entry_by_key_.find(current->key());
-    GPR_ASSERT(it != entry_by_key_.end());
-    GPR_ASSERT(it->second == current);
-    prev = current;
-    current = current->next_;
-  }
-  GPR_ASSERT(prev == use_order_list_tail_);
-  GPR_ASSERT(size == use_order_list_size_);
-  GPR_ASSERT(entry_by_key_.size() == use_order_list_size_);
+  for (size_t i = 0; i < num_shards_; i++) {
+    size += shards_[i].Size();
+  }
+  return size;
+}
+
+void SslSessionLRUCache::Put(const char* key, SslSessionPtr session) {
+  std::string key_str(key);
+  RecordEvictions(
+      ShardForKey(key_str)->Put(key_str, std::move(session), NowSeconds()));
+}
+
+SslSessionPtr SslSessionLRUCache::Get(const char* key) {
+  // Key is only used for lookups.
+  std::string key_str(key);
+  size_t evictions = 0;
+  SslSessionPtr session =
+      ShardForKey(key_str)->Get(key_str, NowSeconds(), &evictions);
+  RecordLookup(session != nullptr);
+  RecordEvictions(evictions);
+  return session;
 }
-#else
-void SslSessionLRUCache::AssertInvariants() {}
-#endif
 
 }  // namespace tsi
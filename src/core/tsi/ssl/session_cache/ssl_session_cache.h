@@ -21,7 +21,8 @@
 
 #include <grpc/support/port_platform.h>
 
-#include <map>
+#include <memory>
+#include <string>
 
 #include <openssl/ssl.h>
 
@@ -40,6 +41,14 @@
 /// name. Note that servers are required to share session ticket encryption keys
 /// in order for cache to be effective.
 ///
+/// Large caches are split into shards by key, each with its own lock and LRU
+/// list, so that many connections resuming at once do not serialize on a
+/// single mutex. LRU order is then only kept within a shard. Sessions whose
+/// lifetime has passed are never returned, and are dropped from the cold end
+/// of a shard as new sessions are added.
+///
+/// Lookups and evictions are counted in the ssl_session_cache_* stats.
+///
 /// This class is thread safe.
 
 namespace tsi {
@@ -70,19 +79,12 @@ class SslSessionLRUCache : public grpc_core::RefCounted<SslSessionLRUCache> {
 
  private:
   class Node;
+  class Shard;
 
-  Node* FindLocked(const std::string& key);
-  void Remove(Node* node);
-  void PushFront(Node* node);
-  void AssertInvariants();
-
-  grpc_core::Mutex lock_;
-  size_t capacity_;
+  Shard* ShardForKey(const std::string& key);
 
-  Node* use_order_list_head_ = nullptr;
-  Node* use_order_list_tail_ = nullptr;
-  size_t use_order_list_size_ = 0;
-  std::map<std::string, Node*> entry_by_key_;
+  const size_t num_shards_;
+  std::unique_ptr<Shard[]> shards_;
 };
 
 }  // namespace tsi
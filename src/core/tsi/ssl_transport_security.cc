@@ -33,19 +33,38 @@
 #include <sys/socket.h>
 #endif
 
+#include <algorithm>
 #include <string>
 
 #include <openssl/bio.h>
 #include <openssl/crypto.h> /* For OPENSSL_free */
 #include <openssl/engine.h>
 #include <openssl/err.h>
+#include <openssl/evp.h>
+#include <openssl/hmac.h>
+#include <openssl/rand.h>
 #include <openssl/ssl.h>
 #include <openssl/tls1.h>
 #include <openssl/x509.h>
 #include <openssl/x509v3.h>
 
+/* Kernel TLS needs the record keys and sequence numbers of the connection,
+   which only BoringSSL exposes. */
+#if defined(GPR_LINUX) && defined(OPENSSL_IS_BORINGSSL) && \
+    defined(__has_include)
+#if __has_include(<linux/tls.h>)
+#define TSI_SSL_KTLS_SUPPORT 1
+#include <errno.h>
+#include <linux/tls.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <openssl/hkdf.h>
+#endif
+#endif
+
 #include "absl/strings/match.h"
 #include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
 
 #include <grpc/grpc_security.h>
 #include <grpc/support/alloc.h>
@@ -55,16 +74,26 @@
 #include <grpc/support/thd_id.h>
 
 #include "src/core/lib/gpr/useful.h"
+#include "src/core/lib/gprpp/sync.h"
+#include "src/core/lib/slice/slice_internal.h"
 #include "src/core/tsi/ssl/key_logging/ssl_key_logging.h"
 #include "src/core/tsi/ssl/session_cache/ssl_session_cache.h"
 #include "src/core/tsi/ssl_types.h"
 #include "src/core/tsi/transport_security.h"
+#include "src/core/tsi/transport_security_grpc.h"
+
+GPR_GLOBAL_CONFIG_DEFINE_BOOL(
+    grpc_experimental_ssl_zero_copy_protector, false,
+    "If set, SSL connections protect frames with the zero-copy grpc "
+    "protector instead of the regular frame protector.");
 
 /* --- Constants. ---*/
 
 #define TSI_SSL_MAX_PROTECTED_FRAME_SIZE_UPPER_BOUND 16384
 #define TSI_SSL_MAX_PROTECTED_FRAME_SIZE_LOWER_BOUND 1024
 #define TSI_SSL_HANDSHAKER_OUTGOING_BUFFER_INITIAL_SIZE 1024
+/* Largest plaintext carried by a TLS record. */
+#define TSI_SSL_MAX_RECORD_PLAINTEXT_SIZE 16384
 
 /* Putting a macro like this and littering the source file with #if is really
    bad practice.
@@ -99,6 +128,25 @@ struct tsi_ssl_client_handshaker_factory {
   grpc_core::RefCountedPtr<TlsSessionKeyLogger> key_logger;
 };
 
+/* A session ticket encryption key, in the layout accepted by
+   SSL_CTX_set_tlsext_ticket_keys: the key name followed by equal sized HMAC
+   and AES keys. */
+struct tsi_ssl_session_ticket_key {
+  unsigned char name[16];
+  unsigned char hmac_key[32];
+  unsigned char aes_key[32];
+  size_t secret_size;
+};
+
+/* The keys used by the session ticket callback of a server factory. Tickets
+   are issued under the current key; tickets issued under the previous key are
+   still accepted, and renewed, until the next rotation. */
+struct tsi_ssl_session_ticket_keys {
+  grpc_core::Mutex mu;
+  tsi_ssl_session_ticket_key current ABSL_GUARDED_BY(mu);
+  absl::optional<tsi_ssl_session_ticket_key> previous ABSL_GUARDED_BY(mu);
+};
+
 struct tsi_ssl_server_handshaker_factory {
   /* Several contexts to support SNI.
      The tsi_peer array contains the subject names of the server certificates
@@ -110,6 +158,8 @@ struct tsi_ssl_server_handshaker_factory {
   unsigned char* alpn_protocol_list;
   size_t alpn_protocol_list_length;
   grpc_core::RefCountedPtr<TlsSessionKeyLogger> key_logger;
+  /* Only set when the factory was created with a session_ticket_key. */
+  tsi_ssl_session_ticket_keys* session_ticket_keys;
 };
 
 struct tsi_ssl_handshaker {
@@ -136,6 +186,22 @@ struct tsi_ssl_frame_protector {
   size_t buffer_size;
   size_t buffer_offset;
 };
+struct tsi_ssl_zero_copy_grpc_protector {
+  tsi_zero_copy_grpc_protector base;
+  /* protect and unprotect share the SSL object and may run concurrently. */
+  gpr_mu mu;
+  SSL* ssl;
+  BIO* network_io;
+  size_t max_protected_frame_size;
+  /* Plaintext sealed into each record. Input slices at least this large are
+     sealed directly; smaller ones are first gathered in record_buffer. */
+  size_t record_size;
+  unsigned char* record_buffer;
+  /* Protected bytes that did not fit into network_io yet. */
+  grpc_slice_buffer protected_staging;
+  /* Unused tail of the last slice records were decrypted into. */
+  grpc_slice unprotected_tail;
+};
 /* --- Library Initialization. ---*/
 
 static gpr_once g_init_openssl_once = GPR_ONCE_INIT;
@@ -1200,6 +1266,161 @@ static const tsi_frame_protector_vtable frame_protector_vtable = {
     ssl_protector_destroy,
 };
 
+/* --- tsi_zero_copy_grpc_protector methods implementation. ---*/
+
+/* Moves every protected byte pending in network_io into one new slice. */
+static tsi_result ssl_zero_copy_grpc_protector_drain(
+    tsi_ssl_zero_copy_grpc_protector* impl,
+    grpc_slice_buffer* protected_slices) {
+  int pending = static_cast<int>(BIO_pending(impl->network_io));
+  if (pending <= 0) return TSI_OK;
+  grpc_slice slice = GRPC_SLICE_MALLOC(static_cast<size_t>(pending));
+  int read_from_ssl =
+      BIO_read(impl->network_io, GRPC_SLICE_START_PTR(slice), pending);
+  if (read_from_ssl != pending) {
+    gpr_log(GPR_ERROR, "Could not read from BIO after SSL_write.");
+    grpc_slice_unref_internal(slice);
+    return TSI_INTERNAL_ERROR;
+  }
+  grpc_slice_buffer_add(protected_slices, slice);
+  return TSI_OK;
+}
+
+static tsi_result ssl_zero_copy_grpc_protector_protect(
+    tsi_zero_copy_grpc_protector* self, grpc_slice_buffer* unprotected_slices,
+    grpc_slice_buffer* protected_slices) {
+  if (self == nullptr || unprotected_slices == nullptr ||
+      protected_slices == nullptr) {
+    return TSI_INVALID_ARGUMENT;
+  }
+  tsi_ssl_zero_copy_grpc_protector* impl =
+      reinterpret_cast<tsi_ssl_zero_copy_grpc_protector*>(self);
+  tsi_result result = TSI_OK;
+  gpr_mu_lock(&impl->mu);
+  while (unprotected_slices->length > 0) {
+    size_t record_size =
+        std::min(impl->record_size, unprotected_slices->length);
+    grpc_slice first = unprotected_slices->slices[0];
+    if (GRPC_SLICE_LENGTH(first) >= record_size) {
+      result =
+          do_ssl_write(impl->ssl, GRPC_SLICE_START_PTR(first), record_size);
+      if (result != TSI_OK) break;
+      if (GRPC_SLICE_LENGTH(first) == record_size) {
+        grpc_slice_buffer_remove_first(unprotected_slices);
+      } else {
+        grpc_slice_buffer_sub_first(unprotected_slices, record_size,
+                                    GRPC_SLICE_LENGTH(first));
+      }
+    } else {
+      grpc_slice_buffer_move_first_into_buffer(unprotected_slices, record_size,
+                                               impl->record_buffer);
+      result = do_ssl_write(impl->ssl, impl->record_buffer, record_size);
+      if (result != TSI_OK) break;
+    }
+    result = ssl_zero_copy_grpc_protector_drain(impl, protected_slices);
+    if (result != TSI_OK) break;
+  }
+  gpr_mu_unlock(&impl->mu);
+  return result;
+}
+
+/* Hands as much of protected_staging to network_io as it accepts. Returns the
+   number of bytes handed over. */
+static size_t ssl_zero_copy_grpc_protector_feed(
+    tsi_ssl_zero_copy_grpc_protector* impl) {
+  size_t fed = 0;
+  while (impl->protected_staging.count > 0) {
+    grpc_slice first = impl->protected_staging.slices[0];
+    size_t length = std::min<size_t>(GRPC_SLICE_LENGTH(first), INT_MAX);
+    int written = BIO_write(impl->network_io, GRPC_SLICE_START_PTR(first),
+                            static_cast<int>(length));
+    if (written <= 0) break;
+    fed += static_cast<size_t>(written);
+    if (static_cast<size_t>(written) == GRPC_SLICE_LENGTH(first)) {
+      grpc_slice_buffer_remove_first(&impl->protected_staging);
+    } else {
+      grpc_slice_buffer_sub_first(&impl->protected_staging,
+                                  static_cast<size_t>(written),
+                                  GRPC_SLICE_LENGTH(first));
+    }
+  }
+  return fed;
+}
+
+static tsi_result ssl_zero_copy_grpc_protector_unprotect(
+    tsi_zero_copy_grpc_protector* self, grpc_slice_buffer* protected_slices,
+    grpc_slice_buffer* unprotected_slices) {
+  if (self == nullptr || unprotected_slices == nullptr ||
+      protected_slices == nullptr) {
+    return TSI_INVALID_ARGUMENT;
+  }
+  tsi_ssl_zero_copy_grpc_protector* impl =
+      reinterpret_cast<tsi_ssl_zero_copy_grpc_protector*>(self);
+  tsi_result result = TSI_OK;
+  gpr_mu_lock(&impl->mu);
+  grpc_slice_buffer_move_into(protected_slices, &impl->protected_staging);
+  bool fed = ssl_zero_copy_grpc_protector_feed(impl) > 0;
+  while (true) {
+    /* Records are decrypted straight into slices handed to the caller, which
+       share one allocation until it is used up. */
+    if (GRPC_SLICE_LENGTH(impl->unprotected_tail) == 0) {
+      grpc_slice_unref_internal(impl->unprotected_tail);
+      impl->unprotected_tail =
+          GRPC_SLICE_MALLOC(TSI_SSL_MAX_RECORD_PLAINTEXT_SIZE);
+    }
+    size_t read_from_ssl = GRPC_SLICE_LENGTH(impl->unprotected_tail);
+    result = do_ssl_read(impl->ssl,
+                         GRPC_SLICE_START_PTR(impl->unprotected_tail),
+                         &read_from_ssl);
+    if (result != TSI_OK) break;
+    if (read_from_ssl > 0) {
+      grpc_slice_buffer_add(
+          unprotected_slices,
+          grpc_slice_split_head(&impl->unprotected_tail, read_from_ssl));
+      continue;
+    }
+    /* SSL needs more protected bytes: stop once there are none left, or the
+       BIO takes no more. */
+    if (!fed) break;
+    fed = ssl_zero_copy_grpc_protector_feed(impl) > 0;
+  }
+  gpr_mu_unlock(&impl->mu);
+  return result;
+}
+
+static void ssl_zero_copy_grpc_protector_destroy(
+    tsi_zero_copy_grpc_protector* self) {
+  if (self == nullptr) return;
+  tsi_ssl_zero_copy_grpc_protector* impl =
+      reinterpret_cast<tsi_ssl_zero_copy_grpc_protector*>(self);
+  grpc_slice_buffer_destroy_internal(&impl->protected_staging);
+  grpc_slice_unref_internal(impl->unprotected_tail);
+  gpr_free(impl->record_buffer);
+  SSL_free(impl->ssl);
+  BIO_free(impl->network_io);
+  gpr_mu_destroy(&impl->mu);
+  gpr_free(impl);
+}
+
+static tsi_result ssl_zero_copy_grpc_protector_max_frame_size(
+    tsi_zero_copy_grpc_protector* self, size_t* max_frame_size) {
+  if (self == nullptr || max_frame_size == nullptr) {
+    return TSI_INVALID_ARGUMENT;
+  }
+  tsi_ssl_zero_copy_grpc_protector* impl =
+      reinterpret_cast<tsi_ssl_zero_copy_grpc_protector*>(self);
+  *max_frame_size = impl->max_protected_frame_size;
+  return TSI_OK;
+}
+
+static const tsi_zero_copy_grpc_protector_vtable
+    zero_copy_grpc_protector_vtable = {
+        ssl_zero_copy_grpc_protector_protect,
+        ssl_zero_copy_grpc_protector_unprotect,
+        ssl_zero_copy_grpc_protector_destroy,
+        ssl_zero_copy_grpc_protector_max_frame_size,
+};
+
 /* --- tsi_server_handshaker_factory methods implementation. --- */
 
 static void tsi_ssl_handshaker_factory_destroy(
@@ -1337,7 +1558,57 @@ static tsi_result ssl_handshaker_result_extract_peer(
 static tsi_result ssl_handshaker_result_get_frame_protector_type(
     const tsi_handshaker_result* /*self*/,
     tsi_frame_protector_type* frame_protector_type) {
-  *frame_protector_type = TSI_FRAME_PROTECTOR_NORMAL;
+  *frame_protector_type =
+      GPR_GLOBAL_CONFIG_GET(grpc_experimental_ssl_zero_copy_protector)
+          ? TSI_FRAME_PROTECTOR_NORMAL_OR_ZERO_COPY
+          : TSI_FRAME_PROTECTOR_NORMAL;
+  return TSI_OK;
+}
+
+/* Clamps the requested protected frame size, if any, to what SSL supports and
+   returns the size to use. */
+static size_t ssl_protected_frame_size(
+    size_t* max_output_protected_frame_size) {
+  if (max_output_protected_frame_size == nullptr) {
+    return TSI_SSL_MAX_PROTECTED_FRAME_SIZE_UPPER_BOUND;
+  }
+  if (*max_output_protected_frame_size >
+      TSI_SSL_MAX_PROTECTED_FRAME_SIZE_UPPER_BOUND) {
+    *max_output_protected_frame_size =
+        TSI_SSL_MAX_PROTECTED_FRAME_SIZE_UPPER_BOUND;
+  } else if (*max_output_protected_frame_size <
+             TSI_SSL_MAX_PROTECTED_FRAME_SIZE_LOWER_BOUND) {
+    *max_output_protected_frame_size =
+        TSI_SSL_MAX_PROTECTED_FRAME_SIZE_LOWER_BOUND;
+  }
+  return *max_output_protected_frame_size;
+}
+
+static tsi_result ssl_handshaker_result_create_zero_copy_grpc_protector(
+    const tsi_handshaker_result* self, size_t* max_output_protected_frame_size,
+    tsi_zero_copy_grpc_protector** protector) {
+  tsi_ssl_handshaker_result* impl =
+      reinterpret_cast<tsi_ssl_handshaker_result*>(
+          const_cast<tsi_handshaker_result*>(self));
+  tsi_ssl_zero_copy_grpc_protector* protector_impl =
+      static_cast<tsi_ssl_zero_copy_grpc_protector*>(
+          gpr_zalloc(sizeof(*protector_impl)));
+  protector_impl->max_protected_frame_size =
+      ssl_protected_frame_size(max_output_protected_frame_size);
+  protector_impl->record_size = protector_impl->max_protected_frame_size -
+                                TSI_SSL_MAX_PROTECTION_OVERHEAD;
+  protector_impl->record_buffer =
+      static_cast<unsigned char*>(gpr_malloc(protector_impl->record_size));
+  gpr_mu_init(&protector_impl->mu);
+  grpc_slice_buffer_init(&protector_impl->protected_staging);
+  protector_impl->unprotected_tail = grpc_empty_slice();
+  /* Transfer ownership of ssl and network_io to the frame protector. */
+  protector_impl->ssl = impl->ssl;
+  impl->ssl = nullptr;
+  protector_impl->network_io = impl->network_io;
+  impl->network_io = nullptr;
+  protector_impl->base.vtable = &zero_copy_grpc_protector_vtable;
+  *protector = &protector_impl->base;
   return TSI_OK;
 }
 
@@ -1345,7 +1616,7 @@ static tsi_result ssl_handshaker_result_create_frame_protector(
     const tsi_handshaker_result* self, size_t* max_output_protected_frame_size,
     tsi_frame_protector** protector) {
   size_t actual_max_output_protected_frame_size =
-      TSI_SSL_MAX_PROTECTED_FRAME_SIZE_UPPER_BOUND;
+      ssl_protected_frame_size(max_output_protected_frame_size);
   tsi_ssl_handshaker_result* impl =
       reinterpret_cast<tsi_ssl_handshaker_result*>(
           const_cast<tsi_handshaker_result*>(self));
@@ -1353,18 +1624,6 @@ static tsi_result ssl_handshaker_result_create_frame_protector(
       static_cast<tsi_ssl_frame_protector*>(
           gpr_zalloc(sizeof(*protector_impl)));
 
-  if (max_output_protected_frame_size != nullptr) {
-    if (*max_output_protected_frame_size >
-        TSI_SSL_MAX_PROTECTED_FRAME_SIZE_UPPER_BOUND) {
-      *max_output_protected_frame_size =
-          TSI_SSL_MAX_PROTECTED_FRAME_SIZE_UPPER_BOUND;
-    } else if (*max_output_protected_frame_size <
-               TSI_SSL_MAX_PROTECTED_FRAME_SIZE_LOWER_BOUND) {
-      *max_output_protected_frame_size =
-          TSI_SSL_MAX_PROTECTED_FRAME_SIZE_LOWER_BOUND;
-    }
-    actual_max_output_protected_frame_size = *max_output_protected_frame_size;
-  }
   protector_impl->buffer_size =
       actual_max_output_protected_frame_size - TSI_SSL_MAX_PROTECTION_OVERHEAD;
   protector_impl->buffer =
@@ -1396,6 +1655,211 @@ static tsi_result ssl_handshaker_result_get_unused_bytes(
   return TSI_OK;
 }
 
+#ifdef TSI_SSL_KTLS_SUPPORT
+
+#ifndef SOL_TLS
+#define SOL_TLS 282
+#endif
+#ifndef TCP_ULP
+#define TCP_ULP 31
+#endif
+
+/* Keys for one direction of a connection, in the form the kernel wants them:
+   the AEAD key, the 12 byte nonce base and the next record sequence number.
+   For TLS 1.2 AES-GCM the last 8 bytes of the nonce base are the explicit
+   nonce of the next record, which BoringSSL takes from the sequence number. */
+struct tsi_ssl_ktls_keys {
+  uint8_t key[32];
+  uint8_t nonce[12];
+  uint64_t sequence;
+};
+
+/* Installs |keys| as the |direction| (TLS_TX or TLS_RX) record protection of
+   |fd|. CryptoInfo is one of the kernel's tls12_crypto_info_* structures. */
+template <typename CryptoInfo>
+static bool ssl_ktls_install(int fd, int direction, uint16_t version,
+                             uint16_t cipher_type,
+                             const tsi_ssl_ktls_keys& keys) {
+  static_assert(sizeof(CryptoInfo::salt) + sizeof(CryptoInfo::iv) ==
+                    sizeof(keys.nonce),
+                "kernel nonce layout");
+  CryptoInfo info;
+  memset(&info, 0, sizeof(info));
+  info.info.version = version;
+  info.info.cipher_type = cipher_type;
+  memcpy(info.key, keys.key, sizeof(info.key));
+  memcpy(info.salt, keys.nonce, sizeof(info.salt));
+  memcpy(info.iv, keys.nonce + sizeof(info.salt), sizeof(info.iv));
+  for (size_t i = 0; i < sizeof(info.rec_seq); i++) {
+    info.rec_seq[i] = static_cast<uint8_t>(keys.sequence >> (56 - 8 * i));
+  }
+  bool ok = setsockopt(fd, SOL_TLS, direction, &info, sizeof(info)) == 0;
+  OPENSSL_cleanse(&info, sizeof(info));
+  return ok;
+}
+
+static bool ssl_ktls_install_keys(int fd, int direction, uint16_t version,
+                                  int cipher_nid,
+                                  const tsi_ssl_ktls_keys& keys) {
+  switch (cipher_nid) {
+    case NID_aes_128_gcm:
+      return ssl_ktls_install<tls12_crypto_info_aes_gcm_128>(
+          fd, direction, version, TLS_CIPHER_AES_GCM_128, keys);
+#ifdef TLS_CIPHER_AES_GCM_256
+    case NID_aes_256_gcm:
+      return ssl_ktls_install<tls12_crypto_info_aes_gcm_256>(
+          fd, direction, version, TLS_CIPHER_AES_GCM_256, keys);
+#endif
+#ifdef TLS_CIPHER_CHACHA20_POLY1305
+    case NID_chacha20_poly1305:
+      return ssl_ktls_install<tls12_crypto_info_chacha20_poly1305>(
+          fd, direction, version, TLS_CIPHER_CHACHA20_POLY1305, keys);
+#endif
+    default:
+      return false;
+  }
+}
+
+/* HKDF-Expand-Label from RFC 8446 section 7.1, with an empty context. */
+static bool ssl_ktls_expand_label(const EVP_MD* digest,
+                                  bssl::Span<const uint8_t> secret,
+                                  absl::string_view label, uint8_t* out,
+                                  size_t out_len) {
+  static constexpr absl::string_view kPrefix = "tls13 ";
+  std::string info;
+  info.push_back(static_cast<char>(out_len >> 8));
+  info.push_back(static_cast<char>(out_len));
+  info.push_back(static_cast<char>(kPrefix.size() + label.size()));
+  info.append(kPrefix.data(), kPrefix.size());
+  info.append(label.data(), label.size());
+  info.push_back(0);
+  return HKDF_expand(out, out_len, digest, secret.data(), secret.size(),
+                     reinterpret_cast<const uint8_t*>(info.data()),
+                     info.size()) == 1;
+}
+
+/* Derives the read and write keys of a TLS 1.2 or TLS 1.3 connection using
+   the AEAD |cipher| with a |key_len| byte key. */
+static bool ssl_ktls_derive_keys(SSL* ssl, const SSL_CIPHER* cipher,
+                                 size_t key_len, tsi_ssl_ktls_keys* read_keys,
+                                 tsi_ssl_ktls_keys* write_keys) {
+  read_keys->sequence = SSL_get_read_sequence(ssl);
+  write_keys->sequence = SSL_get_write_sequence(ssl);
+  if (SSL_version(ssl) == TLS1_3_VERSION) {
+    bssl::Span<const uint8_t> read_secret;
+    bssl::Span<const uint8_t> write_secret;
+    if (!bssl::SSL_get_traffic_secrets(ssl, &read_secret, &write_secret)) {
+      return false;
+    }
+    const EVP_MD* digest = SSL_CIPHER_get_handshake_digest(cipher);
+    return ssl_ktls_expand_label(digest, read_secret, "key", read_keys->key,
+                                 key_len) &&
+           ssl_ktls_expand_label(digest, read_secret, "iv", read_keys->nonce,
+                                 sizeof(read_keys->nonce)) &&
+           ssl_ktls_expand_label(digest, write_secret, "key", write_keys->key,
+                                 key_len) &&
+           ssl_ktls_expand_label(digest, write_secret, "iv", write_keys->nonce,
+                                 sizeof(write_keys->nonce));
+  }
+  /* The TLS 1.2 key block holds, in order, the client and server MAC keys
+     (empty for AEADs), write keys and fixed IVs. AES-GCM has a 4 byte fixed
+     IV followed by an explicit nonce; ChaCha20-Poly1305 a 12 byte one. */
+  const size_t fixed_iv_len =
+      SSL_CIPHER_get_cipher_nid(cipher) == NID_chacha20_poly1305 ? 12 : 4;
+  uint8_t key_block[2 * (32 + 12)];
+  if (static_cast<size_t>(SSL_get_key_block_len(ssl)) !=
+          2 * (key_len + fixed_iv_len) ||
+      !SSL_generate_key_block(ssl, key_block,
+                              2 * (key_len + fixed_iv_len))) {
+    return false;
+  }
+  const bool is_server = SSL_is_server(ssl);
+  const uint8_t* client_key = key_block;
+  const uint8_t* server_key = client_key + key_len;
+  const uint8_t* client_iv = server_key + key_len;
+  const uint8_t* server_iv = client_iv + fixed_iv_len;
+  memcpy(read_keys->key, is_server ? client_key : server_key, key_len);
+  memcpy(read_keys->nonce, is_server ? client_iv : server_iv, fixed_iv_len);
+  memcpy(write_keys->key, is_server ? server_key : client_key, key_len);
+  memcpy(write_keys->nonce, is_server ? server_iv : client_iv, fixed_iv_len);
+  OPENSSL_cleanse(key_block, sizeof(key_block));
+  for (size_t i = fixed_iv_len; i < sizeof(write_keys->nonce); i++) {
+    write_keys->nonce[i] =
+        static_cast<uint8_t>(write_keys->sequence >> (8 * (11 - i)));
+  }
+  return true;
+}
+
+static tsi_result ssl_handshaker_result_offload_to_kernel(
+    const tsi_handshaker_result* self, int fd) {
+  const tsi_ssl_handshaker_result* impl =
+      reinterpret_cast<const tsi_ssl_handshaker_result*>(self);
+  SSL* ssl = impl->ssl;
+  if (ssl == nullptr) return TSI_FAILED_PRECONDITION;
+  /* Anything that BoringSSL has already read or not yet sent would be out of
+     step with the kernel. */
+  if (impl->unused_bytes_size > 0 || SSL_has_pending(ssl) ||
+      BIO_pending(impl->network_io) > 0) {
+    return TSI_FAILED_PRECONDITION;
+  }
+  const uint16_t version = static_cast<uint16_t>(SSL_version(ssl));
+  if (version != TLS1_2_VERSION && version != TLS1_3_VERSION) {
+    return TSI_FAILED_PRECONDITION;
+  }
+  /* A TLS 1.3 server may send session tickets or key updates after the
+     handshake, which the kernel does not process. gRPC clients send servers
+     neither, and a server endpoint fails the connection on any record that
+     is not application data. */
+  if (version == TLS1_3_VERSION && !SSL_is_server(ssl)) {
+    return TSI_FAILED_PRECONDITION;
+  }
+  const SSL_CIPHER* cipher = SSL_get_current_cipher(ssl);
+  if (cipher == nullptr) return TSI_FAILED_PRECONDITION;
+  const int cipher_nid = SSL_CIPHER_get_cipher_nid(cipher);
+  size_t key_len;
+  switch (cipher_nid) {
+    case NID_aes_128_gcm:
+      key_len = 16;
+      break;
+    case NID_aes_256_gcm:
+    case NID_chacha20_poly1305:
+      key_len = 32;
+      break;
+    default:
+      return TSI_FAILED_PRECONDITION;
+  }
+  tsi_ssl_ktls_keys read_keys;
+  tsi_ssl_ktls_keys write_keys;
+  memset(&read_keys, 0, sizeof(read_keys));
+  memset(&write_keys, 0, sizeof(write_keys));
+  if (!ssl_ktls_derive_keys(ssl, cipher, key_len, &read_keys, &write_keys)) {
+    gpr_log(GPR_ERROR, "Could not derive record keys for kernel TLS.");
+    return TSI_FAILED_PRECONDITION;
+  }
+  tsi_result result = TSI_OK;
+  if (setsockopt(fd, IPPROTO_TCP, TCP_ULP, "tls", sizeof("tls")) != 0) {
+    /* Kernel without TLS support: the socket is unchanged. */
+    result = TSI_UNIMPLEMENTED;
+  } else if (!ssl_ktls_install_keys(fd, TLS_TX, version, cipher_nid,
+                                    write_keys)) {
+    /* The cipher is not supported by this kernel. Without keys the TLS layer
+       passes data through, so the connection can still use user space
+       protection. */
+    result = TSI_UNIMPLEMENTED;
+  } else if (!ssl_ktls_install_keys(fd, TLS_RX, version, cipher_nid,
+                                    read_keys)) {
+    /* Writes are already encrypted by the kernel, there is no way back. */
+    gpr_log(GPR_ERROR, "Could not install kernel TLS receive keys: %s",
+            strerror(errno));
+    result = TSI_INTERNAL_ERROR;
+  }
+  OPENSSL_cleanse(&read_keys, sizeof(read_keys));
+  OPENSSL_cleanse(&write_keys, sizeof(write_keys));
+  return result;
+}
+
+#endif /* TSI_SSL_KTLS_SUPPORT */
+
 static void ssl_handshaker_result_destroy(tsi_handshaker_result* self) {
   tsi_ssl_handshaker_result* impl =
       reinterpret_cast<tsi_ssl_handshaker_result*>(self);
@@ -1408,9 +1872,14 @@ static void ssl_handshaker_result_destroy(tsi_handshaker_result* self) {
 static const tsi_handshaker_result_vtable handshaker_result_vtable = {
     ssl_handshaker_result_extract_peer,
     ssl_handshaker_result_get_frame_protector_type,
-    nullptr, /* create_zero_copy_grpc_protector */
+    ssl_handshaker_result_create_zero_copy_grpc_protector,
     ssl_handshaker_result_create_frame_protector,
     ssl_handshaker_result_get_unused_bytes,
+#ifdef TSI_SSL_KTLS_SUPPORT
+    ssl_handshaker_result_offload_to_kernel,
+#else
+    nullptr, /* offload_to_kernel */
+#endif
     ssl_handshaker_result_destroy,
 };
 
@@ -1827,6 +2296,38 @@ void tsi_ssl_server_handshaker_factory_unref(
   tsi_ssl_handshaker_factory_unref(&factory->base);
 }
 
+/// Splits a session ticket key of \a key_size bytes (48 for AES-128 or 80 for
+/// AES-256) into \a out. Returns false if the size is not supported.
+static bool ssl_session_ticket_key_parse(const char* key, size_t key_size,
+                                         tsi_ssl_session_ticket_key* out) {
+  const size_t name_size = sizeof(out->name);
+  if (key_size != name_size + 2 * 16 && key_size != name_size + 2 * 32) {
+    return false;
+  }
+  out->secret_size = (key_size - name_size) / 2;
+  memcpy(out->name, key, name_size);
+  memcpy(out->hmac_key, key + name_size, out->secret_size);
+  memcpy(out->aes_key, key + name_size + out->secret_size, out->secret_size);
+  return true;
+}
+
+tsi_result tsi_ssl_server_handshaker_factory_rotate_session_ticket_key(
+    tsi_ssl_server_handshaker_factory* factory, const char* key,
+    size_t key_size) {
+  if (factory == nullptr || key == nullptr) return TSI_INVALID_ARGUMENT;
+  if (factory->session_ticket_keys == nullptr) return TSI_FAILED_PRECONDITION;
+  tsi_ssl_session_ticket_key new_key;
+  if (!ssl_session_ticket_key_parse(key, key_size, &new_key)) {
+    gpr_log(GPR_ERROR, "Invalid STEK size.");
+    return TSI_INVALID_ARGUMENT;
+  }
+  tsi_ssl_session_ticket_keys* keys = factory->session_ticket_keys;
+  grpc_core::MutexLock lock(&keys->mu);
+  keys->previous = keys->current;
+  keys->current = new_key;
+  return TSI_OK;
+}
+
 static void tsi_ssl_server_handshaker_factory_destroy(
     tsi_ssl_handshaker_factory* factory) {
   if (factory == nullptr) return;
@@ -1845,6 +2346,7 @@ static void tsi_ssl_server_handshaker_factory_destroy(
   }
   if (self->alpn_protocol_list != nullptr) gpr_free(self->alpn_protocol_list);
   self->key_logger.reset();
+  delete self->session_ticket_keys;
   gpr_free(self);
 }
 
@@ -1957,6 +2459,58 @@ static int server_handshaker_factory_new_session_callback(
   return 1;
 }
 
+/// This callback is invoked at the server to encrypt a new session ticket, or
+/// to decrypt one presented by a client. It's intended to be used with
+/// SSL_CTX_set_tlsext_ticket_key_cb.
+///
+/// When decrypting it returns 0 for an unknown key name, which makes the
+/// handshake fall back to a full one, and 2 for the previous key, which makes
+/// the server issue a fresh ticket under the current key.
+static int server_handshaker_factory_ticket_key_callback(
+    SSL* ssl, unsigned char* key_name, unsigned char* iv,
+    EVP_CIPHER_CTX* cipher_ctx, HMAC_CTX* hmac_ctx, int encrypt) {
+  void* arg =
+      SSL_CTX_get_ex_data(SSL_get_SSL_CTX(ssl), g_ssl_ctx_ex_factory_index);
+  tsi_ssl_server_handshaker_factory* factory =
+      static_cast<tsi_ssl_server_handshaker_factory*>(arg);
+  if (factory == nullptr || factory->session_ticket_keys == nullptr) {
+    return -1;
+  }
+  tsi_ssl_session_ticket_key key;
+  bool renew = false;
+  {
+    tsi_ssl_session_ticket_keys* keys = factory->session_ticket_keys;
+    grpc_core::MutexLock lock(&keys->mu);
+    if (encrypt ||
+        memcmp(key_name, keys->current.name, sizeof(key.name)) == 0) {
+      key = keys->current;
+    } else if (keys->previous.has_value() &&
+               memcmp(key_name, keys->previous->name, sizeof(key.name)) == 0) {
+      key = *keys->previous;
+      renew = true;
+    } else {
+      return 0;
+    }
+  }
+  const EVP_CIPHER* cipher =
+      key.secret_size == 16 ? EVP_aes_128_cbc() : EVP_aes_256_cbc();
+  if (encrypt) {
+    memcpy(key_name, key.name, sizeof(key.name));
+    if (RAND_bytes(iv, EVP_CIPHER_iv_length(cipher)) != 1 ||
+        !EVP_EncryptInit_ex(cipher_ctx, cipher, nullptr, key.aes_key, iv)) {
+      return -1;
+    }
+  } else if (!EVP_DecryptInit_ex(cipher_ctx, cipher, nullptr, key.aes_key,
+                                 iv)) {
+    return -1;
+  }
+  if (!HMAC_Init_ex(hmac_ctx, key.hmac_key, static_cast<int>(key.secret_size),
+                    EVP_sha256(), nullptr)) {
+    return -1;
+  }
+  return renew ? 2 : 1;
+}
+
 /// This callback is invoked at client or server when ssl/tls handshakes
 /// complete and keylogging is enabled.
 template <typename T>
@@ -2222,6 +2776,20 @@ tsi_result tsi_create_ssl_server_handshaker_factory_with_options(
     impl->key_logger = options->key_logger->Ref();
   }
 
+  if (options->session_ticket_key != nullptr) {
+    tsi_ssl_session_ticket_key key;
+    if (!ssl_session_ticket_key_parse(options->session_ticket_key,
+                                      options->session_ticket_key_size,
+                                      &key)) {
+      gpr_log(GPR_ERROR, "Invalid STEK size.");
+      tsi_ssl_handshaker_factory_unref(&impl->base);
+      return TSI_INVALID_ARGUMENT;
+    }
+    impl->session_ticket_keys = new tsi_ssl_session_ticket_keys();
+    grpc_core::MutexLock lock(&impl->session_ticket_keys->mu);
+    impl->session_ticket_keys->current = key;
+  }
+
   for (i = 0; i < options->num_key_cert_pairs; i++) {
     do {
 #if OPENSSL_VERSION_NUMBER >= 0x10100000
@@ -2258,15 +2826,15 @@ tsi_result tsi_create_ssl_server_handshaker_factory_with_options(
         break;
       }
 
-      if (options->session_ticket_key != nullptr) {
-        if (SSL_CTX_set_tlsext_ticket_keys(
-                impl->ssl_contexts[i],
-                const_cast<char*>(options->session_ticket_key),
-                options->session_ticket_key_size) == 0) {
-          gpr_log(GPR_ERROR, "Invalid STEK size.");
-          result = TSI_INVALID_ARGUMENT;
-          break;
-        }
+      // Tickets are encrypted through a callback rather than with
+      // SSL_CTX_set_tlsext_ticket_keys so that the keys can be rotated while
+      // handshakes are running.
+      if (impl->session_ticket_keys != nullptr) {
+        SSL_CTX_set_ex_data(impl->ssl_contexts[i], g_ssl_ctx_ex_factory_index,
+                            impl);
+        SSL_CTX_set_tlsext_ticket_key_cb(
+            impl->ssl_contexts[i],
+            server_handshaker_factory_ticket_key_callback);
       }
 
       if (options->pem_client_root_certs != nullptr) {
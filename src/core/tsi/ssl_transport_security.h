@@ -27,9 +27,14 @@
 
 #include <grpc/grpc_security_constants.h>
 
+#include "src/core/lib/gprpp/global_config.h"
 #include "src/core/tsi/ssl/key_logging/ssl_key_logging.h"
 #include "src/core/tsi/transport_security_interface.h"
 
+/* If set, SSL handshaker results offer a tsi_zero_copy_grpc_protector in
+   addition to the regular frame protector. Off by default. */
+GPR_GLOBAL_CONFIG_DECLARE_BOOL(grpc_experimental_ssl_zero_copy_protector);
+
 /* Value for the TSI_CERTIFICATE_TYPE_PEER_PROPERTY property for X509 certs. */
 #define TSI_X509_CERTIFICATE_TYPE "X509"
 
@@ -306,9 +311,12 @@ struct tsi_ssl_server_handshaker_options {
      NULL. */
   uint16_t num_alpn_protocols;
   /* session_ticket_key is optional key for encrypting session keys. If
-     parameter is not specified it must be NULL. */
+     parameter is not specified it must be NULL. It is a 16 byte key name
+     followed by equal sized HMAC and AES keys, and can later be changed with
+     tsi_ssl_server_handshaker_factory_rotate_session_ticket_key. */
   const char* session_ticket_key;
-  /* session_ticket_key_size is a size of session ticket encryption key. */
+  /* session_ticket_key_size is a size of session ticket encryption key: 48
+     bytes for AES-128 or 80 bytes for AES-256. */
   size_t session_ticket_key_size;
   /* The min and max TLS versions that will be negotiated by the handshaker. */
   tsi_tls_version min_tls_version;
@@ -365,6 +373,22 @@ tsi_result tsi_ssl_server_handshaker_factory_create_handshaker(
 void tsi_ssl_server_handshaker_factory_unref(
     tsi_ssl_server_handshaker_factory* factory);
 
+/* Replaces the session ticket encryption key of a server handshaker factory.
+   New tickets are issued under key, while tickets issued under the replaced
+   key are still accepted, and renewed, until the next rotation. Servers that
+   share keys should rotate at least one ticket lifetime apart so that clients
+   can resume across a rotation.
+  - factory must have been created with a session_ticket_key.
+  - key and key_size follow the format of session_ticket_key: a 16 byte key
+    name followed by equal sized HMAC and AES keys, 48 or 80 bytes in total.
+
+  - This method returns TSI_OK on success, TSI_FAILED_PRECONDITION if the
+    factory has no session ticket key, or TSI_INVALID_ARGUMENT in the case
+    where a parameter is invalid. This method is thread-safe. */
+tsi_result tsi_ssl_server_handshaker_factory_rotate_session_ticket_key(
+    tsi_ssl_server_handshaker_factory* factory, const char* key,
+    size_t key_size);
+
 /* Util that checks that an ssl peer matches a specific name.
    Still TODO(jboeuf):
    - handle mixed case.
@@ -116,6 +116,8 @@ struct tsi_handshaker_result_vtable {
   tsi_result (*get_unused_bytes)(const tsi_handshaker_result* self,
                                  const unsigned char** bytes,
                                  size_t* bytes_size);
+  /* May be null if the record protection cannot be done by the kernel. */
+  tsi_result (*offload_to_kernel)(const tsi_handshaker_result* self, int fd);
   void (*destroy)(tsi_handshaker_result* self);
 };
 struct tsi_handshaker_result {
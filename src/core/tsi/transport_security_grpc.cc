@@ -34,6 +34,15 @@ tsi_result tsi_handshaker_result_create_zero_copy_grpc_protector(
       self, max_output_protected_frame_size, protector);
 }
 
+tsi_result tsi_handshaker_result_offload_to_kernel(
+    const tsi_handshaker_result* self, int fd) {
+  if (self == nullptr || self->vtable == nullptr || fd < 0) {
+    return TSI_INVALID_ARGUMENT;
+  }
+  if (self->vtable->offload_to_kernel == nullptr) return TSI_UNIMPLEMENTED;
+  return self->vtable->offload_to_kernel(self, fd);
+}
+
 /* --- tsi_zero_copy_grpc_protector common implementation. ---
 
    Calls specific implementation after state/input validation. */
@@ -32,6 +32,16 @@ tsi_result tsi_handshaker_result_create_zero_copy_grpc_protector(
     const tsi_handshaker_result* self, size_t* max_output_protected_frame_size,
     tsi_zero_copy_grpc_protector** protector);
 
+/* This method hands the record protection negotiated by the handshake to the
+   kernel for the connected socket |fd|, so that data written to and read from
+   |fd| is plaintext and no frame protector is needed. It returns TSI_OK on
+   success, in which case the handshaker result can no longer create a frame
+   protector, and TSI_UNIMPLEMENTED or TSI_FAILED_PRECONDITION if the
+   connection cannot be offloaded, in which case the caller should fall back
+   to creating a frame protector. */
+tsi_result tsi_handshaker_result_offload_to_kernel(
+    const tsi_handshaker_result* self, int fd);
+
 /* -- tsi_zero_copy_grpc_protector object --  */
 
 /* Outputs protected frames.
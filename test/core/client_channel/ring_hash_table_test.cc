@@ -0,0 +1,183 @@
+//
+// Copyright 2022 gRPC authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "src/core/ext/filters/client_channel/lb_policy/ring_hash/ring_hash.h"
+
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "absl/strings/str_cat.h"
+
+#include "test/core/util/test_config.h"
+
+namespace grpc_core {
+namespace testing {
+namespace {
+
+constexpr size_t kTableSize = 1009;
+
+std::vector<RingHashEndpoint> MakeEndpoints(std::vector<uint32_t> weights) {
+  std::vector<RingHashEndpoint> endpoints(weights.size());
+  for (size_t i = 0; i < weights.size(); ++i) {
+    endpoints[i].key = absl::StrCat("127.0.0.1:", 10000 + i);
+    endpoints[i].weight = weights[i];
+  }
+  return endpoints;
+}
+
+// Returns the number of slots in the table that map to each endpoint.
+std::vector<size_t> SlotCounts(const RingHashTable& table,
+                               size_t num_endpoints) {
+  std::vector<size_t> counts(num_endpoints);
+  for (size_t i = 0; i < table.size(); ++i) {
+    EXPECT_LT(table.endpoint_index(i), num_endpoints);
+    if (table.endpoint_index(i) < num_endpoints) {
+      ++counts[table.endpoint_index(i)];
+    }
+  }
+  return counts;
+}
+
+TEST(MaglevTableTest, FillsEverySlotEvenly) {
+  const size_t kNumEndpoints = 10;
+  RingHashTable table = RingHashTable::MakeMaglev(
+      MakeEndpoints(std::vector<uint32_t>(kNumEndpoints, 1)), kTableSize);
+  EXPECT_EQ(table.size(), kTableSize);
+  // Endpoints take turns claiming slots, so the counts differ by at most 1.
+  for (size_t count : SlotCounts(table, kNumEndpoints)) {
+    EXPECT_GE(count, kTableSize / kNumEndpoints);
+    EXPECT_LE(count, kTableSize / kNumEndpoints + 1);
+  }
+}
+
+TEST(MaglevTableTest, HonorsWeights) {
+  RingHashTable table =
+      RingHashTable::MakeMaglev(MakeEndpoints({1, 2, 4}), kTableSize);
+  std::vector<size_t> counts = SlotCounts(table, 3);
+  // The heaviest endpoint claims a slot every round, and the others one in
+  // every two or four rounds.
+  EXPECT_NEAR(counts[0] * 4.0 / kTableSize, 4.0 / 7, 0.01);
+  EXPECT_NEAR(counts[1] * 2.0 / kTableSize, 4.0 / 7, 0.01);
+  EXPECT_NEAR(counts[2] * 1.0 / kTableSize, 4.0 / 7, 0.01);
+}
+
+TEST(MaglevTableTest, LookupIsModuloTableSize) {
+  RingHashTable table =
+      RingHashTable::MakeMaglev(MakeEndpoints({1, 1, 1}), kTableSize);
+  EXPECT_EQ(table.Lookup(0), 0u);
+  EXPECT_EQ(table.Lookup(kTableSize + 5), 5u);
+  EXPECT_EQ(table.Lookup(UINT64_MAX), UINT64_MAX % kTableSize);
+}
+
+TEST(MaglevTableTest, RemovingAnEndpointKeepsMostSlots) {
+  const size_t kNumEndpoints = 10;
+  std::vector<RingHashEndpoint> endpoints =
+      MakeEndpoints(std::vector<uint32_t>(kNumEndpoints, 1));
+  RingHashTable before = RingHashTable::MakeMaglev(endpoints, kTableSize);
+  endpoints.pop_back();
+  RingHashTable after = RingHashTable::MakeMaglev(endpoints, kTableSize);
+  // Slots of the remaining endpoints mostly stay with them; the Maglev
+  // paper reports a few percent of changes for tables of this density.
+  size_t moved = 0;
+  for (size_t i = 0; i < kTableSize; ++i) {
+    if (before.endpoint_index(i) != kNumEndpoints - 1 &&
+        before.endpoint_index(i) != after.endpoint_index(i)) {
+      ++moved;
+    }
+  }
+  EXPECT_LT(moved, kTableSize / 10);
+}
+
+TEST(MaglevTableTest, ValidateTableSize) {
+  EXPECT_TRUE(RingHashTable::ValidateMaglevTableSize(kTableSize, 100).ok());
+  EXPECT_FALSE(RingHashTable::ValidateMaglevTableSize(kTableSize, 101).ok());
+  // The default table size is too small for more than 6553 endpoints.
+  EXPECT_TRUE(RingHashTable::ValidateMaglevTableSize(65537, 6553).ok());
+  EXPECT_FALSE(RingHashTable::ValidateMaglevTableSize(65537, 6554).ok());
+}
+
+TEST(RingHashLoadTrackerTest, CapacityIsWeightedShareOfCalls) {
+  // With a balance factor of 150%, each of two equal endpoints may take
+  // up to ceil(1.5 * (in flight + 1) / 2) calls.
+  RingHashLoadTracker tracker({1, 1}, 150);
+  EXPECT_TRUE(tracker.HasSpareCapacity(0));
+  tracker.CallStarted(0);
+  // 1 < ceil(1.5 * 2 / 2) = 2
+  EXPECT_TRUE(tracker.HasSpareCapacity(0));
+  tracker.CallStarted(0);
+  // 2 < ceil(1.5 * 3 / 2) = 3
+  EXPECT_TRUE(tracker.HasSpareCapacity(0));
+  tracker.CallStarted(0);
+  // 3 == ceil(1.5 * 4 / 2) = 3
+  EXPECT_FALSE(tracker.HasSpareCapacity(0));
+  EXPECT_TRUE(tracker.HasSpareCapacity(1));
+  tracker.CallFinished(0);
+  EXPECT_TRUE(tracker.HasSpareCapacity(0));
+}
+
+TEST(RingHashLoadTrackerTest, HeavierEndpointsTakeMoreCalls) {
+  RingHashLoadTracker tracker({1, 3}, 100);
+  for (int i = 0; i < 3; ++i) tracker.CallStarted(1);
+  // Endpoint 1 has 3 of 4 calls, its full share.
+  EXPECT_FALSE(tracker.HasSpareCapacity(1));
+  EXPECT_TRUE(tracker.HasSpareCapacity(0));
+  tracker.CallStarted(0);
+  // ceil(5 * 3 / 4) = 4 > 3
+  EXPECT_TRUE(tracker.HasSpareCapacity(1));
+}
+
+TEST(RingHashLoadTrackerTest, SpilloverSkipsOverloadedEndpoints) {
+  const size_t kNumEndpoints = 4;
+  RingHashTable table = RingHashTable::MakeMaglev(
+      MakeEndpoints(std::vector<uint32_t>(kNumEndpoints, 1)), kTableSize);
+  RingHashLoadTracker tracker(std::vector<uint32_t>(kNumEndpoints, 1), 100);
+  auto all_usable = [](size_t) { return true; };
+  const size_t position = 0;
+  const size_t overloaded = table.endpoint_index(position);
+  // Without load, the pick stays at its position.
+  EXPECT_EQ(tracker.Spillover(table, position, all_usable), position);
+  // Load one endpoint beyond its share: the pick moves to the next position
+  // of another endpoint.
+  tracker.CallStarted(overloaded);
+  tracker.CallStarted(overloaded);
+  size_t spilled = tracker.Spillover(table, position, all_usable);
+  EXPECT_NE(table.endpoint_index(spilled), overloaded);
+  for (size_t i = position; i < spilled; ++i) {
+    EXPECT_EQ(table.endpoint_index(i), overloaded);
+  }
+  // Positions that are not usable are skipped too.
+  const size_t skipped = table.endpoint_index(spilled);
+  size_t next = tracker.Spillover(table, position, [&](size_t p) {
+    return table.endpoint_index(p) != skipped;
+  });
+  EXPECT_NE(table.endpoint_index(next), overloaded);
+  EXPECT_NE(table.endpoint_index(next), skipped);
+  // If nothing is usable, the pick stays at its position.
+  EXPECT_EQ(tracker.Spillover(table, position, [](size_t) { return false; }),
+            position);
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace grpc_core
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  grpc::testing::TestEnvironment env(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -587,6 +587,85 @@ TEST_F(ClientChannelParserTest, ValidLoadBalancingConfigXds) {
   EXPECT_STREQ(lb_config->name(), "xds_cluster_resolver_experimental");
 }
 
+TEST_F(ClientChannelParserTest, ValidLoadBalancingConfigLeastRequest) {
+  const char* test_json =
+      "{\"loadBalancingConfig\": "
+      "[{\"least_request_experimental\":{\"choiceCount\":3}}]}";
+  grpc_error_handle error = GRPC_ERROR_NONE;
+  auto svc_cfg = ServiceConfigImpl::Create(nullptr, test_json, &error);
+  ASSERT_EQ(error, GRPC_ERROR_NONE) << grpc_error_std_string(error);
+  const auto* parsed_config =
+      static_cast<internal::ClientChannelGlobalParsedConfig*>(
+          svc_cfg->GetGlobalParsedConfig(0));
+  auto lb_config = parsed_config->parsed_lb_config();
+  EXPECT_STREQ(lb_config->name(), "least_request_experimental");
+}
+
+TEST_F(ClientChannelParserTest, ValidLoadBalancingConfigOutlierDetection) {
+  const char* test_json =
+      "{\n"
+      "  \"loadBalancingConfig\":[\n"
+      "    { \"outlier_detection_experimental\":{\n"
+      "      \"interval\": \"1s\",\n"
+      "      \"baseEjectionTime\": \"10s\",\n"
+      "      \"maxEjectionPercent\": 20,\n"
+      "      \"successRateEjection\": { \"stdevFactor\": 1000 },\n"
+      "      \"failurePercentageEjection\": { \"threshold\": 50 },\n"
+      "      \"consecutiveFailureEjection\": { \"threshold\": 3 },\n"
+      "      \"childPolicy\": [{ \"round_robin\":{} }]\n"
+      "    } }\n"
+      "  ]\n"
+      "}";
+  grpc_error_handle error = GRPC_ERROR_NONE;
+  auto svc_cfg = ServiceConfigImpl::Create(nullptr, test_json, &error);
+  ASSERT_EQ(error, GRPC_ERROR_NONE) << grpc_error_std_string(error);
+  const auto* parsed_config =
+      static_cast<internal::ClientChannelGlobalParsedConfig*>(
+          svc_cfg->GetGlobalParsedConfig(0));
+  auto lb_config = parsed_config->parsed_lb_config();
+  EXPECT_STREQ(lb_config->name(), "outlier_detection_experimental");
+}
+
+TEST_F(ClientChannelParserTest, ValidLoadBalancingConfigRingHashMaglev) {
+  const char* test_json =
+      "{\"loadBalancingConfig\": [{\"ring_hash_experimental\":{"
+      "  \"lookup_table\":\"maglev\","
+      "  \"maglev_table_size\":65537,"
+      "  \"hash_balance_factor\":125"
+      "}}]}";
+  grpc_error_handle error = GRPC_ERROR_NONE;
+  auto svc_cfg = ServiceConfigImpl::Create(nullptr, test_json, &error);
+  ASSERT_EQ(error, GRPC_ERROR_NONE) << grpc_error_std_string(error);
+  const auto* parsed_config =
+      static_cast<internal::ClientChannelGlobalParsedConfig*>(
+          svc_cfg->GetGlobalParsedConfig(0));
+  auto lb_config = parsed_config->parsed_lb_config();
+  EXPECT_STREQ(lb_config->name(), "ring_hash_experimental");
+}
+
+TEST_F(ClientChannelParserTest, ValidLoadBalancingConfigWeightedRoundRobin) {
+  const char* test_json =
+      "{\n"
+      "  \"loadBalancingConfig\":[\n"
+      "    { \"weighted_round_robin_experimental\":{\n"
+      "      \"enableOobLoadReport\": true,\n"
+      "      \"oobReportingPeriod\": \"5s\",\n"
+      "      \"blackoutPeriod\": \"1s\",\n"
+      "      \"weightUpdatePeriod\": \"0.5s\",\n"
+      "      \"weightExpirationPeriod\": \"60s\"\n"
+      "    } }\n"
+      "  ]\n"
+      "}";
+  grpc_error_handle error = GRPC_ERROR_NONE;
+  auto svc_cfg = ServiceConfigImpl::Create(nullptr, test_json, &error);
+  ASSERT_EQ(error, GRPC_ERROR_NONE) << grpc_error_std_string(error);
+  const auto* parsed_config =
+      static_cast<internal::ClientChannelGlobalParsedConfig*>(
+          svc_cfg->GetGlobalParsedConfig(0));
+  auto lb_config = parsed_config->parsed_lb_config();
+  EXPECT_STREQ(lb_config->name(), "weighted_round_robin_experimental");
+}
+
 TEST_F(ClientChannelParserTest, UnknownLoadBalancingConfig) {
   const char* test_json = "{\"loadBalancingConfig\": [{\"unknown\":{}}]}";
   grpc_error_handle error = GRPC_ERROR_NONE;
@@ -620,6 +699,90 @@ TEST_F(ClientChannelParserTest, InvalidGrpclbLoadBalancingConfig) {
   GRPC_ERROR_UNREF(error);
 }
 
+TEST_F(ClientChannelParserTest, InvalidLeastRequestLoadBalancingConfig) {
+  const char* test_json =
+      "{\"loadBalancingConfig\": "
+      "[{\"least_request_experimental\":{\"choiceCount\":1}}]}";
+  grpc_error_handle error = GRPC_ERROR_NONE;
+  auto svc_cfg = ServiceConfigImpl::Create(nullptr, test_json, &error);
+  EXPECT_THAT(grpc_error_std_string(error),
+              ::testing::ContainsRegex(
+                  "Service config parsing error" CHILD_ERROR_TAG
+                  "Global Params" CHILD_ERROR_TAG
+                  "Client channel global parser" CHILD_ERROR_TAG
+                  "field:loadBalancingConfig" CHILD_ERROR_TAG
+                  "least_request_experimental LB policy config" CHILD_ERROR_TAG
+                  "field:choiceCount error:must be at least 2"));
+  GRPC_ERROR_UNREF(error);
+}
+
+TEST_F(ClientChannelParserTest, InvalidRingHashLookupTableConfig) {
+  const char* test_json =
+      "{\"loadBalancingConfig\": [{\"ring_hash_experimental\":{"
+      "  \"lookup_table\":\"tree\","
+      "  \"maglev_table_size\":65536,"
+      "  \"hash_balance_factor\":50"
+      "}}]}";
+  grpc_error_handle error = GRPC_ERROR_NONE;
+  auto svc_cfg = ServiceConfigImpl::Create(nullptr, test_json, &error);
+  EXPECT_THAT(grpc_error_std_string(error),
+              ::testing::ContainsRegex(
+                  "Service config parsing error" CHILD_ERROR_TAG
+                  "Global Params" CHILD_ERROR_TAG
+                  "Client channel global parser" CHILD_ERROR_TAG
+                  "field:loadBalancingConfig" CHILD_ERROR_TAG
+                  "ring_hash_experimental LB policy config" CHILD_ERROR_TAG
+                  "field:lookup_table error: should be .*"
+                  "field:maglev_table_size error: should be a prime.*"
+                  "field:hash_balance_factor error: should be at least 100"));
+  GRPC_ERROR_UNREF(error);
+}
+
+TEST_F(ClientChannelParserTest, InvalidWeightedRoundRobinLoadBalancingConfig) {
+  const char* test_json =
+      "{\"loadBalancingConfig\": ["
+      "  {\"weighted_round_robin_experimental\":{"
+      "    \"enableOobLoadReport\":\"yes\","
+      "    \"blackoutPeriod\":10"
+      "  }}"
+      "]}";
+  grpc_error_handle error = GRPC_ERROR_NONE;
+  auto svc_cfg = ServiceConfigImpl::Create(nullptr, test_json, &error);
+  EXPECT_THAT(grpc_error_std_string(error),
+              ::testing::ContainsRegex(
+                  "Service config parsing error" CHILD_ERROR_TAG
+                  "Global Params" CHILD_ERROR_TAG
+                  "Client channel global parser" CHILD_ERROR_TAG
+                  "field:loadBalancingConfig" CHILD_ERROR_TAG
+                  "weighted_round_robin_experimental LB policy "
+                  "config" CHILD_ERROR_TAG
+                  "field:enableOobLoadReport error:type should be "
+                  "BOOLEAN.*field:blackoutPeriod error:type should be STRING"));
+  GRPC_ERROR_UNREF(error);
+}
+
+TEST_F(ClientChannelParserTest, InvalidOutlierDetectionLoadBalancingConfig) {
+  const char* test_json =
+      "{\"loadBalancingConfig\": ["
+      "  {\"outlier_detection_experimental\":{"
+      "    \"maxEjectionPercent\":101,"
+      "    \"childPolicy\":[{\"round_robin\":{}}]"
+      "  }}"
+      "]}";
+  grpc_error_handle error = GRPC_ERROR_NONE;
+  auto svc_cfg = ServiceConfigImpl::Create(nullptr, test_json, &error);
+  EXPECT_THAT(grpc_error_std_string(error),
+              ::testing::ContainsRegex(
+                  "Service config parsing error" CHILD_ERROR_TAG
+                  "Global Params" CHILD_ERROR_TAG
+                  "Client channel global parser" CHILD_ERROR_TAG
+                  "field:loadBalancingConfig" CHILD_ERROR_TAG
+                  "outlier_detection_experimental LB policy "
+                  "config" CHILD_ERROR_TAG
+                  "field:maxEjectionPercent error:value must be <= 100"));
+  GRPC_ERROR_UNREF(error);
+}
+
 TEST_F(ClientChannelParserTest, ValidLoadBalancingPolicy) {
   const char* test_json = "{\"loadBalancingPolicy\":\"pick_first\"}";
   grpc_error_handle error = GRPC_ERROR_NONE;
@@ -764,6 +927,63 @@ TEST_F(ClientChannelParserTest, InvalidWaitForReady) {
   GRPC_ERROR_UNREF(error);
 }
 
+TEST_F(ClientChannelParserTest, ValidWritePriority) {
+  const char* test_json =
+      "{\n"
+      "  \"methodConfig\": [ {\n"
+      "    \"name\": [\n"
+      "      { \"service\": \"TestServ\", \"method\": \"Bulk\" }\n"
+      "    ],\n"
+      "    \"writePriority\": \"LOW\"\n"
+      "  }, {\n"
+      "    \"name\": [\n"
+      "      { \"service\": \"TestServ\", \"method\": \"Default\" }\n"
+      "    ],\n"
+      "    \"writePriority\": \"NORMAL\"\n"
+      "  } ]\n"
+      "}";
+  grpc_error_handle error = GRPC_ERROR_NONE;
+  auto svc_cfg = ServiceConfigImpl::Create(nullptr, test_json, &error);
+  ASSERT_EQ(error, GRPC_ERROR_NONE) << grpc_error_std_string(error);
+  const auto* vector_ptr = svc_cfg->GetMethodParsedConfigVector(
+      grpc_slice_from_static_string("/TestServ/Bulk"));
+  ASSERT_NE(vector_ptr, nullptr);
+  auto parsed_config = ((*vector_ptr)[0]).get();
+  EXPECT_EQ(
+      (static_cast<internal::ClientChannelMethodParsedConfig*>(parsed_config))
+          ->write_priority_flag(),
+      GRPC_INITIAL_METADATA_WRITE_PRIORITY_LOW);
+  vector_ptr = svc_cfg->GetMethodParsedConfigVector(
+      grpc_slice_from_static_string("/TestServ/Default"));
+  ASSERT_NE(vector_ptr, nullptr);
+  parsed_config = ((*vector_ptr)[0]).get();
+  EXPECT_EQ(
+      (static_cast<internal::ClientChannelMethodParsedConfig*>(parsed_config))
+          ->write_priority_flag(),
+      0u);
+}
+
+TEST_F(ClientChannelParserTest, InvalidWritePriority) {
+  const char* test_json =
+      "{\n"
+      "  \"methodConfig\": [ {\n"
+      "    \"name\": [\n"
+      "      { \"service\": \"service\", \"method\": \"method\" }\n"
+      "    ],\n"
+      "    \"writePriority\": \"URGENT\"\n"
+      "  } ]\n"
+      "}";
+  grpc_error_handle error = GRPC_ERROR_NONE;
+  auto svc_cfg = ServiceConfigImpl::Create(nullptr, test_json, &error);
+  EXPECT_THAT(grpc_error_std_string(error),
+              ::testing::ContainsRegex(
+                  "Service config parsing error" CHILD_ERROR_TAG
+                  "Method Params" CHILD_ERROR_TAG "methodConfig" CHILD_ERROR_TAG
+                  "Client channel parser" CHILD_ERROR_TAG
+                  "field:writePriority error:should be HIGH, NORMAL or LOW"));
+  GRPC_ERROR_UNREF(error);
+}
+
 TEST_F(ClientChannelParserTest, ValidHealthCheck) {
   const char* test_json =
       "{\n"
@@ -21,6 +21,14 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include <string>
+#include <vector>
+
+#ifdef GRPC_HAVE_ZSTD
+#include <zdict.h>
+#endif
+
+#include <grpc/compression.h>
 #include <grpc/grpc.h>
 #include <grpc/support/log.h>
 
@@ -114,6 +122,10 @@ static grpc_slice repeated(char c, size_t length) {
 static compressability get_compressability(
     test_value id, grpc_compression_algorithm algorithm) {
   if (algorithm == GRPC_COMPRESS_NONE) return SHOULD_NOT_COMPRESS;
+  /* algorithms that are not built in always fall back to no compression */
+  if (!grpc_core::CompressionAlgorithmSet::Supported().IsSet(algorithm)) {
+    return SHOULD_NOT_COMPRESS;
+  }
   switch (id) {
     case ONE_A:
       return SHOULD_NOT_COMPRESS;
@@ -303,6 +315,116 @@ static void test_bad_decompression_algorithm(void) {
   grpc_slice_buffer_destroy(&output);
 }
 
+static void test_invalid_zstd_dictionary(void) {
+  const char not_a_dictionary[] = "not a dictionary";
+  GPR_ASSERT(0 == grpc_compression_register_zstd_dictionary(
+                      nullptr, not_a_dictionary, sizeof(not_a_dictionary)));
+}
+
+#ifdef GRPC_HAVE_ZSTD
+/* a small message, similar to (but not in) the ones a dictionary is trained
+   on */
+static std::string dictionary_sample(int i) {
+  char buf[256];
+  snprintf(buf, sizeof(buf),
+           "{\"user_id\": %d, \"name\": \"user-%d\", \"status\": "
+           "\"active\", \"roles\": [\"reader\", \"writer\"], "
+           "\"region\": \"us-east-%d\"}",
+           i, i * 7, i % 4);
+  return buf;
+}
+
+static void test_zstd_dictionary(void) {
+  std::string samples;
+  std::vector<size_t> sample_sizes;
+  for (int i = 0; i < 2000; i++) {
+    std::string sample = dictionary_sample(i);
+    samples += sample;
+    sample_sizes.push_back(sample.size());
+  }
+  std::vector<char> dictionary(4096);
+  size_t dictionary_size = ZDICT_trainFromBuffer(
+      dictionary.data(), dictionary.size(), samples.data(),
+      sample_sizes.data(), static_cast<unsigned>(sample_sizes.size()));
+  GPR_ASSERT(!ZDICT_isError(dictionary_size));
+  GPR_ASSERT(1 == grpc_compression_register_zstd_dictionary(
+                      "/test.Service/Method", dictionary.data(),
+                      dictionary_size));
+
+  std::string message = dictionary_sample(123456);
+  grpc_slice_buffer input;
+  grpc_slice_buffer with_dictionary;
+  grpc_slice_buffer without_dictionary;
+  grpc_slice_buffer output;
+  grpc_slice_buffer_init(&input);
+  grpc_slice_buffer_init(&with_dictionary);
+  grpc_slice_buffer_init(&without_dictionary);
+  grpc_slice_buffer_init(&output);
+  grpc_slice_buffer_add(&input, grpc_slice_from_copied_buffer(
+                                    message.data(), message.size()));
+
+  grpc_core::ExecCtx exec_ctx;
+  /* other methods have no dictionary, and barely shrink if at all */
+  grpc_msg_compress_for_method(GRPC_COMPRESS_ZSTD, "/test.Service/Other",
+                               &input, &without_dictionary);
+  GPR_ASSERT(1 == grpc_msg_compress_for_method(GRPC_COMPRESS_ZSTD,
+                                               "/test.Service/Method", &input,
+                                               &with_dictionary));
+  GPR_ASSERT(with_dictionary.length < without_dictionary.length / 2);
+  /* the frame names the dictionary, so the receiver needs no method */
+  GPR_ASSERT(1 == grpc_msg_decompress(GRPC_COMPRESS_ZSTD, &with_dictionary,
+                                      &output));
+  grpc_slice merged = grpc_slice_merge(output.slices, output.count);
+  GPR_ASSERT(grpc_slice_eq(merged, input.slices[0]));
+  grpc_slice_unref(merged);
+
+  grpc_slice_buffer_destroy(&input);
+  grpc_slice_buffer_destroy(&with_dictionary);
+  grpc_slice_buffer_destroy(&without_dictionary);
+  grpc_slice_buffer_destroy(&output);
+}
+
+/* a zstd frame holding the single byte 'x', whose header asks for a window
+   of 1 << window_log bytes */
+static grpc_slice zstd_frame_with_window_log(int window_log) {
+  const uint8_t frame[] = {
+      0x28, 0xb5, 0x2f, 0xfd, /* magic number */
+      0x00, /* no content size, checksum or dictionary: window follows */
+      static_cast<uint8_t>((window_log - 10) << 3), /* window exponent */
+      0x09, 0x00, 0x00, /* last block, raw, 1 byte */
+      'x'};
+  return grpc_slice_from_copied_buffer(reinterpret_cast<const char*>(frame),
+                                       sizeof(frame));
+}
+
+static void test_zstd_window_limit(void) {
+  grpc_slice_buffer input;
+  grpc_slice_buffer output;
+  grpc_slice_buffer_init(&input);
+  grpc_slice_buffer_init(&output);
+  grpc_core::ExecCtx exec_ctx;
+
+  /* an 8MiB window is accepted */
+  grpc_slice_buffer_add(&input, zstd_frame_with_window_log(23));
+  GPR_ASSERT(1 == grpc_msg_decompress(GRPC_COMPRESS_ZSTD, &input, &output));
+  GPR_ASSERT(output.length == 1);
+  grpc_slice_buffer_reset_and_unref(&input);
+  grpc_slice_buffer_reset_and_unref(&output);
+
+  /* a 128MiB window, which zstd itself would allow, is rejected, and keeps
+     being rejected by the pooled context */
+  for (int i = 0; i < 2; i++) {
+    grpc_slice_buffer_add(&input, zstd_frame_with_window_log(27));
+    GPR_ASSERT(0 == grpc_msg_decompress(GRPC_COMPRESS_ZSTD, &input, &output));
+    GPR_ASSERT(output.length == 0);
+    grpc_slice_buffer_reset_and_unref(&input);
+  }
+
+  grpc_slice_buffer_destroy(&input);
+  grpc_slice_buffer_destroy(&output);
+}
+#endif
+
 int main(int argc, char** argv) {
   unsigned i, j, k, m;
   grpc_slice_split_mode uncompressed_split_modes[] = {
@@ -338,6 +460,11 @@ int main(int argc, char** argv) {
   test_bad_decompression_data_trailing_garbage();
   test_bad_compression_algorithm();
   test_bad_decompression_algorithm();
+  test_invalid_zstd_dictionary();
+#ifdef GRPC_HAVE_ZSTD
+  test_zstd_dictionary();
+  test_zstd_window_limit();
+#endif
   grpc_shutdown();
 
   return 0;
@@ -0,0 +1,225 @@
+/*
+ *
+ * Copyright 2022 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <string.h>
+
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <grpc/grpc.h>
+#include <grpc/grpc_security.h>
+#include <grpc/support/log.h>
+
+#include "src/core/lib/channel/channel_args.h"
+#include "src/core/lib/gprpp/host_port.h"
+#include "src/core/lib/iomgr/load_file.h"
+#include "src/core/lib/security/security_connector/ssl_utils_config.h"
+#include "test/core/end2end/cq_verifier.h"
+#include "test/core/util/port.h"
+#include "test/core/util/test_config.h"
+
+#define CA_CERT_PATH "src/core/tsi/test_creds/ca.pem"
+#define SERVER_CERT_PATH "src/core/tsi/test_creds/server1.pem"
+#define SERVER_KEY_PATH "src/core/tsi/test_creds/server1.key"
+
+namespace grpc {
+namespace testing {
+namespace {
+
+void* tag(intptr_t t) { return reinterpret_cast<void*>(t); }
+
+const int kNumChannels = 4;
+
+// SSL clients and a server that run their handshakes with
+// GRPC_ARG_TSI_HANDSHAKE_OFFLOAD.
+class H2SslHandshakeOffloadTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    cq_ = grpc_completion_queue_create_for_next(nullptr);
+    cqv_ = cq_verifier_create(cq_);
+    server_address_ =
+        grpc_core::JoinHostPort("localhost", grpc_pick_unused_port_or_die());
+  }
+
+  void TearDown() override {
+    for (grpc_channel* channel : channels_) grpc_channel_destroy(channel);
+    grpc_server_shutdown_and_notify(server_, cq_, tag(1000));
+    CQ_EXPECT_COMPLETION(cqv_, tag(1000), true);
+    cq_verify(cqv_);
+    grpc_server_destroy(server_);
+    cq_verifier_destroy(cqv_);
+    grpc_completion_queue_shutdown(cq_);
+    while (grpc_completion_queue_next(cq_, gpr_inf_future(GPR_CLOCK_REALTIME),
+                                      nullptr)
+               .type != GRPC_QUEUE_SHUTDOWN) {
+    }
+    grpc_completion_queue_destroy(cq_);
+  }
+
+  void StartServer(int max_concurrent_handshakes) {
+    grpc_arg args[] = {
+        grpc_channel_arg_integer_create(
+            const_cast<char*>(GRPC_ARG_TSI_HANDSHAKE_OFFLOAD), 1),
+        grpc_channel_arg_integer_create(
+            const_cast<char*>(GRPC_ARG_SERVER_MAX_CONCURRENT_HANDSHAKES),
+            max_concurrent_handshakes),
+    };
+    grpc_channel_args server_args = {GPR_ARRAY_SIZE(args), args};
+    server_ = grpc_server_create(&server_args, nullptr);
+    grpc_server_register_completion_queue(server_, cq_, nullptr);
+    grpc_slice cert_slice, key_slice;
+    GPR_ASSERT(GRPC_LOG_IF_ERROR(
+        "load_file", grpc_load_file(SERVER_CERT_PATH, 1, &cert_slice)));
+    GPR_ASSERT(GRPC_LOG_IF_ERROR(
+        "load_file", grpc_load_file(SERVER_KEY_PATH, 1, &key_slice)));
+    grpc_ssl_pem_key_cert_pair pem_key_cert_pair = {
+        reinterpret_cast<const char*> GRPC_SLICE_START_PTR(key_slice),
+        reinterpret_cast<const char*> GRPC_SLICE_START_PTR(cert_slice)};
+    grpc_server_credentials* server_creds = grpc_ssl_server_credentials_create(
+        nullptr, &pem_key_cert_pair, 1, 0, nullptr);
+    grpc_slice_unref(cert_slice);
+    grpc_slice_unref(key_slice);
+    GPR_ASSERT(grpc_server_add_http2_port(server_, server_address_.c_str(),
+                                          server_creds));
+    grpc_server_credentials_release(server_creds);
+    grpc_server_start(server_);
+  }
+
+  // Connects kNumChannels channels at once, and makes a call on each.
+  void DoCalls() {
+    grpc_arg args[] = {
+        grpc_channel_arg_integer_create(
+            const_cast<char*>(GRPC_ARG_TSI_HANDSHAKE_OFFLOAD), 1),
+        grpc_channel_arg_string_create(
+            const_cast<char*>(GRPC_SSL_TARGET_NAME_OVERRIDE_ARG),
+            const_cast<char*>("foo.test.google.fr")),
+        // Keep the channels from sharing a subchannel.
+        grpc_channel_arg_integer_create(
+            const_cast<char*>(GRPC_ARG_USE_LOCAL_SUBCHANNEL_POOL), 1),
+    };
+    grpc_channel_args client_args = {GPR_ARRAY_SIZE(args), args};
+    grpc_channel_credentials* creds =
+        grpc_ssl_credentials_create(nullptr, nullptr, nullptr, nullptr);
+    std::vector<grpc_call*> client_calls(kNumChannels);
+    std::vector<grpc_call*> server_calls(kNumChannels);
+    std::vector<grpc_status_code> statuses(kNumChannels);
+    std::vector<grpc_slice> details(kNumChannels);
+    std::vector<grpc_metadata_array> initial_metadata_recv(kNumChannels);
+    std::vector<grpc_metadata_array> trailing_metadata_recv(kNumChannels);
+    std::vector<grpc_metadata_array> request_metadata_recv(kNumChannels);
+    std::vector<grpc_call_details> call_details(kNumChannels);
+    std::vector<int> was_cancelled(kNumChannels, 2);
+    grpc_op ops[4];
+    for (int i = 0; i < kNumChannels; i++) {
+      channels_.push_back(
+          grpc_channel_create(server_address_.c_str(), creds, &client_args));
+      client_calls[i] = grpc_channel_create_call(
+          channels_[i], nullptr, GRPC_PROPAGATE_DEFAULTS, cq_,
+          grpc_slice_from_static_string("/foo"), nullptr,
+          grpc_timeout_seconds_to_deadline(30), nullptr);
+      GPR_ASSERT(client_calls[i]);
+      grpc_metadata_array_init(&initial_metadata_recv[i]);
+      grpc_metadata_array_init(&trailing_metadata_recv[i]);
+      grpc_metadata_array_init(&request_metadata_recv[i]);
+      grpc_call_details_init(&call_details[i]);
+      memset(ops, 0, sizeof(ops));
+      ops[0].op = GRPC_OP_SEND_INITIAL_METADATA;
+      // A connection the server sheds is retried.
+      ops[0].flags = GRPC_INITIAL_METADATA_WAIT_FOR_READY;
+      ops[1].op = GRPC_OP_SEND_CLOSE_FROM_CLIENT;
+      ops[2].op = GRPC_OP_RECV_INITIAL_METADATA;
+      ops[2].data.recv_initial_metadata.recv_initial_metadata =
+          &initial_metadata_recv[i];
+      ops[3].op = GRPC_OP_RECV_STATUS_ON_CLIENT;
+      ops[3].data.recv_status_on_client.trailing_metadata =
+          &trailing_metadata_recv[i];
+      ops[3].data.recv_status_on_client.status = &statuses[i];
+      ops[3].data.recv_status_on_client.status_details = &details[i];
+      GPR_ASSERT(GRPC_CALL_OK == grpc_call_start_batch(client_calls[i], ops, 4,
+                                                       tag(1 + i), nullptr));
+    }
+    grpc_channel_credentials_release(creds);
+    for (int i = 0; i < kNumChannels; i++) {
+      GPR_ASSERT(GRPC_CALL_OK ==
+                 grpc_server_request_call(server_, &server_calls[i],
+                                          &call_details[i],
+                                          &request_metadata_recv[i], cq_, cq_,
+                                          tag(101 + i)));
+      CQ_EXPECT_COMPLETION(cqv_, tag(101 + i), true);
+    }
+    cq_verify(cqv_, 30);
+    for (int i = 0; i < kNumChannels; i++) {
+      memset(ops, 0, sizeof(ops));
+      ops[0].op = GRPC_OP_SEND_INITIAL_METADATA;
+      ops[1].op = GRPC_OP_RECV_CLOSE_ON_SERVER;
+      ops[1].data.recv_close_on_server.cancelled = &was_cancelled[i];
+      ops[2].op = GRPC_OP_SEND_STATUS_FROM_SERVER;
+      ops[2].data.send_status_from_server.status = GRPC_STATUS_OK;
+      GPR_ASSERT(GRPC_CALL_OK == grpc_call_start_batch(server_calls[i], ops, 3,
+                                                       tag(201 + i), nullptr));
+      CQ_EXPECT_COMPLETION(cqv_, tag(201 + i), true);
+      CQ_EXPECT_COMPLETION(cqv_, tag(1 + i), true);
+    }
+    cq_verify(cqv_);
+    for (int i = 0; i < kNumChannels; i++) {
+      EXPECT_EQ(statuses[i], GRPC_STATUS_OK);
+      EXPECT_EQ(was_cancelled[i], 0);
+      grpc_slice_unref(details[i]);
+      grpc_metadata_array_destroy(&initial_metadata_recv[i]);
+      grpc_metadata_array_destroy(&trailing_metadata_recv[i]);
+      grpc_metadata_array_destroy(&request_metadata_recv[i]);
+      grpc_call_details_destroy(&call_details[i]);
+      grpc_call_unref(client_calls[i]);
+      grpc_call_unref(server_calls[i]);
+    }
+  }
+
+  grpc_completion_queue* cq_;
+  cq_verifier* cqv_;
+  grpc_server* server_ = nullptr;
+  std::vector<grpc_channel*> channels_;
+  std::string server_address_;
+};
+
+TEST_F(H2SslHandshakeOffloadTest, ConcurrentHandshakes) {
+  StartServer(/*max_concurrent_handshakes=*/0);
+  DoCalls();
+}
+
+TEST_F(H2SslHandshakeOffloadTest, ConcurrentHandshakesWithLimit) {
+  // Some handshakes wait for a slot, and may be shed if they find the queue
+  // full.
+  StartServer(/*max_concurrent_handshakes=*/1);
+  DoCalls();
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace grpc
+
+int main(int argc, char** argv) {
+  grpc::testing::TestEnvironment env(&argc, argv);
+  GPR_GLOBAL_CONFIG_SET(grpc_default_ssl_roots_file_path, CA_CERT_PATH);
+  grpc_init();
+  ::testing::InitGoogleTest(&argc, argv);
+  int ret = RUN_ALL_TESTS();
+  grpc_shutdown();
+  return ret;
+}
@@ -0,0 +1,254 @@
+/*
+ *
+ * Copyright 2022 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <string.h>
+
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include <grpc/grpc.h>
+#include <grpc/grpc_security.h>
+#include <grpc/support/log.h>
+
+#include "src/core/lib/channel/channel_args.h"
+#include "src/core/lib/gprpp/host_port.h"
+#include "src/core/lib/iomgr/load_file.h"
+#include "src/core/lib/security/credentials/ssl/ssl_credentials.h"
+#include "src/core/lib/security/security_connector/ssl_utils_config.h"
+#include "test/core/end2end/cq_verifier.h"
+#include "test/core/util/port.h"
+#include "test/core/util/test_config.h"
+
+#define CA_CERT_PATH "src/core/tsi/test_creds/ca.pem"
+#define SERVER_CERT_PATH "src/core/tsi/test_creds/server1.pem"
+#define SERVER_KEY_PATH "src/core/tsi/test_creds/server1.key"
+
+namespace grpc {
+namespace testing {
+namespace {
+
+void* tag(intptr_t t) { return reinterpret_cast<void*>(t); }
+
+// A message that spans several TLS records.
+const size_t kMessageSize = 100 * 1024;
+
+// An SSL client and server that both set GRPC_ARG_TSI_KERNEL_OFFLOAD. Whether
+// or not the kernel takes over record protection, calls must work as they do
+// without the argument.
+class H2SslKernelOffloadTest
+    : public ::testing::TestWithParam<grpc_tls_version> {
+ protected:
+  void SetUp() override {
+    cq_ = grpc_completion_queue_create_for_next(nullptr);
+    cqv_ = cq_verifier_create(cq_);
+    server_address_ =
+        grpc_core::JoinHostPort("localhost", grpc_pick_unused_port_or_die());
+    grpc_arg arg = grpc_channel_arg_integer_create(
+        const_cast<char*>(GRPC_ARG_TSI_KERNEL_OFFLOAD), 1);
+    grpc_channel_args args = {1, &arg};
+    server_ = grpc_server_create(&args, nullptr);
+    grpc_server_register_completion_queue(server_, cq_, nullptr);
+    grpc_server_credentials* server_creds = CreateServerCredentials();
+    GPR_ASSERT(grpc_server_add_http2_port(server_, server_address_.c_str(),
+                                          server_creds));
+    grpc_server_credentials_release(server_creds);
+    grpc_server_start(server_);
+    grpc_arg client_args[] = {
+        arg,
+        grpc_channel_arg_string_create(
+            const_cast<char*>(GRPC_SSL_TARGET_NAME_OVERRIDE_ARG),
+            const_cast<char*>("foo.test.google.fr")),
+    };
+    grpc_channel_args channel_args = {GPR_ARRAY_SIZE(client_args),
+                                      client_args};
+    grpc_channel_credentials* client_creds =
+        grpc_ssl_credentials_create(nullptr, nullptr, nullptr, nullptr);
+    auto* ssl_creds = reinterpret_cast<grpc_ssl_credentials*>(client_creds);
+    ssl_creds->set_min_tls_version(GetParam());
+    ssl_creds->set_max_tls_version(GetParam());
+    channel_ = grpc_channel_create(server_address_.c_str(), client_creds,
+                                   &channel_args);
+    grpc_channel_credentials_release(client_creds);
+  }
+
+  void TearDown() override {
+    grpc_channel_destroy(channel_);
+    grpc_server_shutdown_and_notify(server_, cq_, tag(1000));
+    CQ_EXPECT_COMPLETION(cqv_, tag(1000), true);
+    cq_verify(cqv_);
+    grpc_server_destroy(server_);
+    cq_verifier_destroy(cqv_);
+    grpc_completion_queue_shutdown(cq_);
+    while (grpc_completion_queue_next(cq_, gpr_inf_future(GPR_CLOCK_REALTIME),
+                                      nullptr)
+               .type != GRPC_QUEUE_SHUTDOWN) {
+    }
+    grpc_completion_queue_destroy(cq_);
+  }
+
+  grpc_server_credentials* CreateServerCredentials() {
+    grpc_slice cert_slice, key_slice;
+    GPR_ASSERT(GRPC_LOG_IF_ERROR(
+        "load_file", grpc_load_file(SERVER_CERT_PATH, 1, &cert_slice)));
+    GPR_ASSERT(GRPC_LOG_IF_ERROR(
+        "load_file", grpc_load_file(SERVER_KEY_PATH, 1, &key_slice)));
+    grpc_ssl_pem_key_cert_pair pem_key_cert_pair = {
+        reinterpret_cast<const char*> GRPC_SLICE_START_PTR(key_slice),
+        reinterpret_cast<const char*> GRPC_SLICE_START_PTR(cert_slice)};
+    grpc_server_credentials* creds = grpc_ssl_server_credentials_create(
+        nullptr, &pem_key_cert_pair, 1, 0, nullptr);
+    auto* ssl_creds = reinterpret_cast<grpc_ssl_server_credentials*>(creds);
+    ssl_creds->set_min_tls_version(GetParam());
+    ssl_creds->set_max_tls_version(GetParam());
+    grpc_slice_unref(cert_slice);
+    grpc_slice_unref(key_slice);
+    return creds;
+  }
+
+  // Makes a call that sends a large message in each direction, and checks
+  // that both arrive intact.
+  void DoRoundTrip() {
+    grpc_call* c = grpc_channel_create_call(
+        channel_, nullptr, GRPC_PROPAGATE_DEFAULTS, cq_,
+        grpc_slice_from_static_string("/foo"), nullptr,
+        grpc_timeout_seconds_to_deadline(30), nullptr);
+    GPR_ASSERT(c);
+    std::string request(kMessageSize, 'a');
+    std::string response(kMessageSize, 'b');
+    grpc_slice request_slice =
+        grpc_slice_from_copied_buffer(request.data(), request.size());
+    grpc_slice response_slice =
+        grpc_slice_from_copied_buffer(response.data(), response.size());
+    grpc_byte_buffer* request_payload =
+        grpc_raw_byte_buffer_create(&request_slice, 1);
+    grpc_byte_buffer* response_payload =
+        grpc_raw_byte_buffer_create(&response_slice, 1);
+    grpc_slice_unref(request_slice);
+    grpc_slice_unref(response_slice);
+    grpc_byte_buffer* request_payload_recv = nullptr;
+    grpc_byte_buffer* response_payload_recv = nullptr;
+    grpc_metadata_array initial_metadata_recv;
+    grpc_metadata_array trailing_metadata_recv;
+    grpc_metadata_array request_metadata_recv;
+    grpc_call_details call_details;
+    grpc_metadata_array_init(&initial_metadata_recv);
+    grpc_metadata_array_init(&trailing_metadata_recv);
+    grpc_metadata_array_init(&request_metadata_recv);
+    grpc_call_details_init(&call_details);
+    grpc_status_code status;
+    grpc_slice details;
+    int was_cancelled = 2;
+
+    grpc_op ops[6];
+    memset(ops, 0, sizeof(ops));
+    ops[0].op = GRPC_OP_SEND_INITIAL_METADATA;
+    ops[1].op = GRPC_OP_SEND_MESSAGE;
+    ops[1].data.send_message.send_message = request_payload;
+    ops[2].op = GRPC_OP_SEND_CLOSE_FROM_CLIENT;
+    ops[3].op = GRPC_OP_RECV_INITIAL_METADATA;
+    ops[3].data.recv_initial_metadata.recv_initial_metadata =
+        &initial_metadata_recv;
+    ops[4].op = GRPC_OP_RECV_MESSAGE;
+    ops[4].data.recv_message.recv_message = &response_payload_recv;
+    ops[5].op = GRPC_OP_RECV_STATUS_ON_CLIENT;
+    ops[5].data.recv_status_on_client.trailing_metadata =
+        &trailing_metadata_recv;
+    ops[5].data.recv_status_on_client.status = &status;
+    ops[5].data.recv_status_on_client.status_details = &details;
+    GPR_ASSERT(GRPC_CALL_OK ==
+               grpc_call_start_batch(c, ops, 6, tag(1), nullptr));
+
+    grpc_call* s;
+    GPR_ASSERT(GRPC_CALL_OK ==
+               grpc_server_request_call(server_, &s, &call_details,
+                                        &request_metadata_recv, cq_, cq_,
+                                        tag(101)));
+    CQ_EXPECT_COMPLETION(cqv_, tag(101), true);
+    cq_verify(cqv_);
+
+    memset(ops, 0, sizeof(ops));
+    ops[0].op = GRPC_OP_RECV_MESSAGE;
+    ops[0].data.recv_message.recv_message = &request_payload_recv;
+    GPR_ASSERT(GRPC_CALL_OK ==
+               grpc_call_start_batch(s, ops, 1, tag(102), nullptr));
+    CQ_EXPECT_COMPLETION(cqv_, tag(102), true);
+    cq_verify(cqv_);
+
+    memset(ops, 0, sizeof(ops));
+    ops[0].op = GRPC_OP_SEND_INITIAL_METADATA;
+    ops[1].op = GRPC_OP_SEND_MESSAGE;
+    ops[1].data.send_message.send_message = response_payload;
+    ops[2].op = GRPC_OP_RECV_CLOSE_ON_SERVER;
+    ops[2].data.recv_close_on_server.cancelled = &was_cancelled;
+    ops[3].op = GRPC_OP_SEND_STATUS_FROM_SERVER;
+    ops[3].data.send_status_from_server.status = GRPC_STATUS_OK;
+    GPR_ASSERT(GRPC_CALL_OK ==
+               grpc_call_start_batch(s, ops, 4, tag(103), nullptr));
+    CQ_EXPECT_COMPLETION(cqv_, tag(103), true);
+    CQ_EXPECT_COMPLETION(cqv_, tag(1), true);
+    cq_verify(cqv_);
+
+    EXPECT_EQ(status, GRPC_STATUS_OK);
+    EXPECT_EQ(was_cancelled, 0);
+    EXPECT_TRUE(byte_buffer_eq_string(request_payload_recv, request.c_str()));
+    EXPECT_TRUE(
+        byte_buffer_eq_string(response_payload_recv, response.c_str()));
+
+    grpc_slice_unref(details);
+    grpc_metadata_array_destroy(&initial_metadata_recv);
+    grpc_metadata_array_destroy(&trailing_metadata_recv);
+    grpc_metadata_array_destroy(&request_metadata_recv);
+    grpc_call_details_destroy(&call_details);
+    grpc_byte_buffer_destroy(request_payload);
+    grpc_byte_buffer_destroy(response_payload);
+    grpc_byte_buffer_destroy(request_payload_recv);
+    grpc_byte_buffer_destroy(response_payload_recv);
+    grpc_call_unref(c);
+    grpc_call_unref(s);
+  }
+
+  grpc_completion_queue* cq_;
+  cq_verifier* cqv_;
+  grpc_server* server_;
+  grpc_channel* channel_;
+  std::string server_address_;
+};
+
+TEST_P(H2SslKernelOffloadTest, RoundTrip) {
+  DoRoundTrip();
+  // The connection stays usable after the first call.
+  DoRoundTrip();
+}
+
+INSTANTIATE_TEST_SUITE_P(H2SslKernelOffloadTest, H2SslKernelOffloadTest,
+                         ::testing::Values(TLS1_2, TLS1_3));
+
+}  // namespace
+}  // namespace testing
+}  // namespace grpc
+
+int main(int argc, char** argv) {
+  grpc::testing::TestEnvironment env(&argc, argv);
+  GPR_GLOBAL_CONFIG_SET(grpc_default_ssl_roots_file_path, CA_CERT_PATH);
+  grpc_init();
+  ::testing::InitGoogleTest(&argc, argv);
+  int ret = RUN_ALL_TESTS();
+  grpc_shutdown();
+  return ret;
+}
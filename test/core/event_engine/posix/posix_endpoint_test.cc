@@ -0,0 +1,232 @@
+// Copyright 2022 gRPC authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <netinet/in.h>
+#include <string.h>
+#include <sys/socket.h>
+
+#include <memory>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "absl/memory/memory.h"
+#include "absl/synchronization/notification.h"
+#include "absl/time/clock.h"
+
+#include <grpc/event_engine/endpoint_config.h>
+#include <grpc/event_engine/event_engine.h>
+#include <grpc/grpc.h>
+#include <grpc/impl/codegen/grpc_types.h>
+#include <grpc/slice_buffer.h>
+
+#include "src/core/lib/event_engine/posix_engine/posix_engine.h"
+#include "src/core/lib/gprpp/sync.h"
+#include "src/core/lib/iomgr/port.h"
+#include "src/core/lib/resource_quota/memory_quota.h"
+#include "test/core/util/test_config.h"
+
+namespace grpc_event_engine {
+namespace experimental {
+namespace {
+
+class TestEndpointConfig : public EndpointConfig {
+ public:
+  explicit TestEndpointConfig(bool zerocopy) : zerocopy_(zerocopy) {}
+  Setting Get(absl::string_view key) const override {
+    if (zerocopy_ && key == GRPC_ARG_TCP_TX_ZEROCOPY_ENABLED) return 1;
+    if (zerocopy_ && key == GRPC_ARG_TCP_TX_ZEROCOPY_SEND_BYTES_THRESHOLD) {
+      return 1;
+    }
+    return absl::monostate();
+  }
+
+ private:
+  bool zerocopy_;
+};
+
+EventEngine::ResolvedAddress LoopbackAddress(int port) {
+  sockaddr_in addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  addr.sin_port = htons(port);
+  return EventEngine::ResolvedAddress(reinterpret_cast<sockaddr*>(&addr),
+                                      sizeof(addr));
+}
+
+// Reads from \a endpoint until \a expected_size bytes have arrived.
+std::string ReadAll(EventEngine::Endpoint* endpoint, size_t expected_size) {
+  std::string received;
+  grpc_slice_buffer buffer;
+  grpc_slice_buffer_init(&buffer);
+  SliceBuffer slice_buffer(&buffer);
+  while (received.size() < expected_size) {
+    absl::Notification read_done;
+    absl::Status read_status;
+    endpoint->Read(
+        [&](absl::Status status) {
+          read_status = status;
+          read_done.Notify();
+        },
+        &slice_buffer);
+    read_done.WaitForNotification();
+    if (!read_status.ok()) break;
+    for (size_t i = 0; i < buffer.count; i++) {
+      received.append(
+          reinterpret_cast<const char*>(GRPC_SLICE_START_PTR(buffer.slices[i])),
+          GRPC_SLICE_LENGTH(buffer.slices[i]));
+    }
+    grpc_slice_buffer_reset_and_unref(&buffer);
+  }
+  grpc_slice_buffer_destroy(&buffer);
+  return received;
+}
+
+class PosixEventEngineTest : public ::testing::TestWithParam<bool> {
+ protected:
+  PosixEventEngineTest()
+      : engine_(absl::make_unique<PosixEventEngine>()),
+        config_(/*zerocopy=*/GetParam()) {}
+
+  // Connects a client to a fresh listener and returns both ends.
+  void Connect(std::unique_ptr<EventEngine::Endpoint>* client,
+               std::unique_ptr<EventEngine::Endpoint>* server) {
+    absl::Notification accepted;
+    auto listener = engine_->CreateListener(
+        [server, &accepted](std::unique_ptr<EventEngine::Endpoint> ep,
+                            MemoryAllocator /*allocator*/) {
+          *server = std::move(ep);
+          accepted.Notify();
+        },
+        [](absl::Status status) { GPR_ASSERT(status.ok()); }, config_,
+        absl::make_unique<grpc_core::MemoryQuota>("listener"));
+    ASSERT_TRUE(listener.ok()) << listener.status();
+    auto port = (*listener)->Bind(LoopbackAddress(0));
+    ASSERT_TRUE(port.ok()) << port.status();
+    ASSERT_TRUE((*listener)->Start().ok());
+    absl::Notification connected;
+    engine_->Connect(
+        [client, &connected](
+            absl::StatusOr<std::unique_ptr<EventEngine::Endpoint>> ep) {
+          GPR_ASSERT(ep.ok());
+          *client = std::move(*ep);
+          connected.Notify();
+        },
+        LoopbackAddress(*port), config_,
+        memory_quota_.CreateMemoryAllocator("client"),
+        absl::Now() + absl::Seconds(10));
+    connected.WaitForNotification();
+    accepted.WaitForNotification();
+  }
+
+  std::unique_ptr<PosixEventEngine> engine_;
+  TestEndpointConfig config_;
+  grpc_core::MemoryQuota memory_quota_{"test"};
+};
+
+TEST_P(PosixEventEngineTest, EchoesData) {
+  std::unique_ptr<EventEngine::Endpoint> client;
+  std::unique_ptr<EventEngine::Endpoint> server;
+  Connect(&client, &server);
+  ASSERT_NE(client, nullptr);
+  ASSERT_NE(server, nullptr);
+  // Large enough to need several writes and reads.
+  std::string payload;
+  for (int i = 0; payload.size() < 4 * 1024 * 1024; i++) {
+    payload.append(std::to_string(i));
+  }
+  grpc_slice_buffer out;
+  grpc_slice_buffer_init(&out);
+  for (size_t offset = 0; offset < payload.size(); offset += 64 * 1024) {
+    size_t len = std::min<size_t>(64 * 1024, payload.size() - offset);
+    grpc_slice_buffer_add(&out,
+                          grpc_slice_from_copied_buffer(&payload[offset], len));
+  }
+  SliceBuffer out_buffer(&out);
+  absl::Notification write_done;
+  client->Write(
+      [&write_done](absl::Status status) {
+        EXPECT_TRUE(status.ok()) << status;
+        write_done.Notify();
+      },
+      &out_buffer);
+  EXPECT_EQ(ReadAll(server.get(), payload.size()), payload);
+  write_done.WaitForNotification();
+  grpc_slice_buffer_destroy(&out);
+}
+
+TEST_P(PosixEventEngineTest, ReadFailsAfterPeerCloses) {
+  std::unique_ptr<EventEngine::Endpoint> client;
+  std::unique_ptr<EventEngine::Endpoint> server;
+  Connect(&client, &server);
+  client.reset();
+  EXPECT_EQ(ReadAll(server.get(), 1), "");
+}
+
+TEST_P(PosixEventEngineTest, ConnectToClosedPortFails) {
+  // Bind a socket without listening on it so that the port is known to be
+  // closed.
+  int fd = socket(AF_INET, SOCK_STREAM, 0);
+  ASSERT_GE(fd, 0);
+  EventEngine::ResolvedAddress addr = LoopbackAddress(0);
+  ASSERT_EQ(bind(fd, addr.address(), addr.size()), 0);
+  sockaddr_in bound;
+  socklen_t len = sizeof(bound);
+  ASSERT_EQ(getsockname(fd, reinterpret_cast<sockaddr*>(&bound), &len), 0);
+  absl::Notification done;
+  engine_->Connect(
+      [&done](absl::StatusOr<std::unique_ptr<EventEngine::Endpoint>> ep) {
+        EXPECT_FALSE(ep.ok());
+        done.Notify();
+      },
+      LoopbackAddress(ntohs(bound.sin_port)), config_,
+      memory_quota_.CreateMemoryAllocator("client"),
+      absl::Now() + absl::Seconds(10));
+  done.WaitForNotification();
+  close(fd);
+}
+
+TEST_P(PosixEventEngineTest, ListenerShutdownIsReported) {
+  absl::Notification shutdown;
+  {
+    auto listener = engine_->CreateListener(
+        [](std::unique_ptr<EventEngine::Endpoint>, MemoryAllocator) {},
+        [&shutdown](absl::Status status) {
+          EXPECT_TRUE(status.ok()) << status;
+          shutdown.Notify();
+        },
+        config_, absl::make_unique<grpc_core::MemoryQuota>("listener"));
+    ASSERT_TRUE(listener.ok());
+    ASSERT_TRUE((*listener)->Bind(LoopbackAddress(0)).ok());
+    ASSERT_TRUE((*listener)->Start().ok());
+  }
+  shutdown.WaitForNotification();
+}
+
+INSTANTIATE_TEST_SUITE_P(PosixEventEngine, PosixEventEngineTest,
+                         ::testing::Bool());
+
+}  // namespace
+}  // namespace experimental
+}  // namespace grpc_event_engine
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  grpc::testing::TestEnvironment env(&argc, argv);
+  grpc_init();
+  int r = RUN_ALL_TESTS();
+  grpc_shutdown();
+  return r;
+}
@@ -0,0 +1,92 @@
+// Copyright 2022 gRPC authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "src/core/lib/event_engine/thread_pool.h"
+
+#include <atomic>
+
+#include <gtest/gtest.h>
+
+#include "absl/synchronization/notification.h"
+
+#include "test/core/util/test_config.h"
+
+namespace grpc_event_engine {
+namespace experimental {
+
+TEST(ThreadPoolTest, RunsCallbacks) {
+  ThreadPool pool(4);
+  EXPECT_EQ(pool.thread_count(), 4);
+  absl::Notification done;
+  std::atomic<int> count{0};
+  for (int i = 0; i < 1000; i++) {
+    pool.Add([&count, &done]() {
+      if (count.fetch_add(1) + 1 == 1000) done.Notify();
+    });
+  }
+  done.WaitForNotification();
+  EXPECT_EQ(count.load(), 1000);
+}
+
+TEST(ThreadPoolTest, CallbacksRunOnPoolThreads) {
+  ThreadPool pool(2);
+  EXPECT_FALSE(pool.IsThreadPoolThread());
+  absl::Notification done;
+  bool on_pool_thread = false;
+  pool.Add([&]() {
+    on_pool_thread = pool.IsThreadPoolThread();
+    done.Notify();
+  });
+  done.WaitForNotification();
+  EXPECT_TRUE(on_pool_thread);
+}
+
+TEST(ThreadPoolTest, CallbacksAddedFromWorkersRun) {
+  ThreadPool pool(4);
+  absl::Notification done;
+  std::atomic<int> count{0};
+  // Every callback adds two more from the worker it runs on, so most of the
+  // work is queued locally and has to be stolen to keep the other workers
+  // busy.
+  std::function<void(int)> fan_out = [&](int depth) {
+    if (count.fetch_add(1) + 1 == (1 << 12) - 1) done.Notify();
+    if (depth == 11) return;
+    for (int i = 0; i < 2; i++) {
+      pool.Add([&fan_out, depth]() { fan_out(depth + 1); });
+    }
+  };
+  pool.Add([&fan_out]() { fan_out(0); });
+  done.WaitForNotification();
+  EXPECT_EQ(count.load(), (1 << 12) - 1);
+}
+
+TEST(ThreadPoolTest, DestructorRunsQueuedCallbacks) {
+  std::atomic<int> count{0};
+  {
+    ThreadPool pool(2);
+    for (int i = 0; i < 100; i++) {
+      pool.Add([&count]() { count.fetch_add(1); });
+    }
+  }
+  EXPECT_EQ(count.load(), 100);
+}
+
+}  // namespace experimental
+}  // namespace grpc_event_engine
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  grpc::testing::TestEnvironment env(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -21,6 +21,8 @@
 #include <inttypes.h>
 #include <string.h>
 
+#include <vector>
+
 #include "absl/strings/str_format.h"
 #include "absl/strings/str_join.h"
 
@@ -120,6 +122,71 @@ static void concurrent_test(void) {
   args.arena->Destroy();
 }
 
+static void packing_test(void) {
+  gpr_log(GPR_DEBUG, "packing_test");
+
+  Arena* a = Arena::Create(1024, g_memory_allocator);
+  char* c1 = a->New<char>('a');
+  char* c2 = a->New<char>('b');
+  uint32_t* u = a->New<uint32_t>(42);
+  // Small allocations are packed by their own alignment, not by 16 bytes.
+  GPR_ASSERT(c2 == c1 + 1);
+  GPR_ASSERT(reinterpret_cast<char*>(u) == c1 + 4);
+  GPR_ASSERT(((intptr_t)a->Alloc(1) & 0xf) == 0);
+  a->Destroy();
+}
+
+static void managed_new_test(void) {
+  gpr_log(GPR_DEBUG, "managed_new_test");
+
+  struct Recorder {
+    Recorder(std::vector<int>* order, int id) : order(order), id(id) {}
+    ~Recorder() { order->push_back(id); }
+    std::vector<int>* order;
+    int id;
+  };
+  std::vector<int> order;
+  Arena* a = Arena::Create(32, g_memory_allocator);
+  for (int i = 0; i < 100; i++) a->ManagedNew<Recorder>(&order, i);
+  GPR_ASSERT(order.empty());
+  a->Destroy();
+  GPR_ASSERT(order.size() == 100);
+  for (int i = 0; i < 100; i++) GPR_ASSERT(order[i] == 99 - i);
+}
+
+static void containers_test(void) {
+  gpr_log(GPR_DEBUG, "containers_test");
+
+  Arena* a = Arena::Create(64, g_memory_allocator);
+  auto* v = a->ManagedNew<grpc_core::ArenaVector<int>>(
+      grpc_core::Arena::Allocator<int>(a));
+  for (int i = 0; i < 1000; i++) v->push_back(i);
+  for (int i = 0; i < 1000; i++) GPR_ASSERT((*v)[i] == i);
+  auto* s = a->ManagedNew<grpc_core::ArenaString>(
+      "a string long enough to need storage outside of the object",
+      grpc_core::Arena::Allocator<char>(a));
+  s->append(" and then some");
+  GPR_ASSERT(s->size() == 72);
+  a->Destroy();
+}
+
+static void block_pool_test(void) {
+  gpr_log(GPR_DEBUG, "block_pool_test");
+
+  grpc_core::ArenaBlockPool* pool = grpc_core::ArenaBlockPool::Get();
+  pool->Drain();
+  GPR_ASSERT(pool->cached_bytes() == 0);
+  // Grow the arena past its first zone, so that both the arena and the zone
+  // blocks are returned to the pool.
+  Arena* a = Arena::Create(1000, g_memory_allocator);
+  memset(a->Alloc(3000), 1, 3000);
+  a->Destroy();
+  size_t cached = pool->cached_bytes();
+  GPR_ASSERT(cached >= 1024 + 4096);
+  GPR_ASSERT(pool->Drain() == cached);
+  GPR_ASSERT(pool->cached_bytes() == 0);
+}
+
 int main(int argc, char* argv[]) {
   grpc::testing::TestEnvironment env(&argc, argv);
 
@@ -131,6 +198,10 @@ int main(int argc, char* argv[]) {
   TEST(1_inc, 1, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11);
   TEST(6_123, 6, 1, 2, 3);
   concurrent_test();
+  packing_test();
+  managed_new_test();
+  containers_test();
+  block_pool_test();
 
   return 0;
 }
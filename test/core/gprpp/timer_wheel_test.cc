@@ -0,0 +1,152 @@
+// Copyright 2022 gRPC authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "src/core/lib/gprpp/timer_wheel.h"
+
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace grpc_core {
+namespace testing {
+
+struct TestTimer {
+  int64_t deadline = 0;
+  uint32_t slot = 0;
+  TestTimer* prev = nullptr;
+  TestTimer* next = nullptr;
+};
+
+struct TestTimerTraits {
+  static int64_t Deadline(TestTimer* t) { return t->deadline; }
+  static uint32_t& Slot(TestTimer* t) { return t->slot; }
+  static TestTimer*& Prev(TestTimer* t) { return t->prev; }
+  static TestTimer*& Next(TestTimer* t) { return t->next; }
+};
+
+using Wheel = TimerWheel<TestTimer, TestTimerTraits>;
+
+std::vector<TestTimer*> AdvanceTo(Wheel* wheel, int64_t now) {
+  std::vector<TestTimer*> expired;
+  wheel->Advance(now, [&expired](TestTimer* t) { expired.push_back(t); });
+  return expired;
+}
+
+TEST(TimerWheelTest, PastDeadlineIsNotAdded) {
+  Wheel wheel(100);
+  TestTimer t;
+  t.deadline = 100;
+  EXPECT_FALSE(wheel.Add(&t));
+  EXPECT_TRUE(wheel.empty());
+  EXPECT_FALSE(wheel.Remove(&t));
+}
+
+TEST(TimerWheelTest, FiresAtDeadline) {
+  Wheel wheel;
+  TestTimer t;
+  t.deadline = 10;
+  ASSERT_TRUE(wheel.Add(&t));
+  EXPECT_EQ(wheel.size(), 1);
+  EXPECT_TRUE(AdvanceTo(&wheel, 9).empty());
+  EXPECT_EQ(AdvanceTo(&wheel, 10), std::vector<TestTimer*>{&t});
+  EXPECT_TRUE(wheel.empty());
+  EXPECT_EQ(wheel.now(), 10);
+}
+
+TEST(TimerWheelTest, RemovedTimerDoesNotFire) {
+  Wheel wheel;
+  TestTimer a;
+  TestTimer b;
+  a.deadline = 5;
+  b.deadline = 5;
+  ASSERT_TRUE(wheel.Add(&a));
+  ASSERT_TRUE(wheel.Add(&b));
+  EXPECT_TRUE(wheel.Remove(&a));
+  EXPECT_FALSE(wheel.Remove(&a));
+  EXPECT_EQ(AdvanceTo(&wheel, 100), std::vector<TestTimer*>{&b});
+}
+
+TEST(TimerWheelTest, ClearRemovesEveryLevel) {
+  Wheel wheel;
+  std::vector<TestTimer> timers(4);
+  timers[0].deadline = 3;
+  timers[1].deadline = 300;
+  timers[2].deadline = 70000;
+  timers[3].deadline = std::numeric_limits<int64_t>::max() - 1;
+  for (auto& t : timers) ASSERT_TRUE(wheel.Add(&t));
+  std::vector<TestTimer*> removed;
+  wheel.Clear([&removed](TestTimer* t) { removed.push_back(t); });
+  EXPECT_EQ(removed.size(), timers.size());
+  EXPECT_TRUE(wheel.empty());
+  EXPECT_EQ(wheel.NextWakeupTick(), Wheel::kInfiniteTicks);
+  for (auto& t : timers) EXPECT_FALSE(wheel.Remove(&t));
+}
+
+TEST(TimerWheelTest, NextWakeupIsNeverLate) {
+  Wheel wheel;
+  EXPECT_EQ(wheel.NextWakeupTick(), Wheel::kInfiniteTicks);
+  TestTimer t;
+  t.deadline = 100000;
+  ASSERT_TRUE(wheel.Add(&t));
+  int64_t wakeups = 0;
+  while (!wheel.empty()) {
+    int64_t next = wheel.NextWakeupTick();
+    ASSERT_LE(next, t.deadline);
+    AdvanceTo(&wheel, next);
+    ++wakeups;
+  }
+  EXPECT_EQ(wheel.now(), t.deadline);
+  // Coarse levels keep the number of wakeups far below the number of ticks.
+  EXPECT_LT(wakeups, 1000);
+}
+
+TEST(TimerWheelTest, RandomDeadlinesFireInOrder) {
+  std::mt19937 rng(42);
+  // Spread deadlines over every level, including the overflow list.
+  std::uniform_int_distribution<int> shift(0, 40);
+  Wheel wheel(12345);
+  std::vector<TestTimer> timers(2000);
+  for (auto& t : timers) {
+    t.deadline = wheel.now() + 1 + (rng() & ((int64_t{1} << shift(rng)) - 1));
+    ASSERT_TRUE(wheel.Add(&t));
+  }
+  std::vector<TestTimer*> cancelled;
+  for (size_t i = 0; i < timers.size(); i += 7) {
+    ASSERT_TRUE(wheel.Remove(&timers[i]));
+    cancelled.push_back(&timers[i]);
+  }
+  size_t fired = 0;
+  int64_t last_deadline = 0;
+  while (!wheel.empty()) {
+    int64_t now = wheel.NextWakeupTick();
+    for (TestTimer* t : AdvanceTo(&wheel, now)) {
+      EXPECT_EQ(t->deadline, now);
+      EXPECT_GE(t->deadline, last_deadline);
+      last_deadline = t->deadline;
+      ++fired;
+    }
+  }
+  EXPECT_EQ(fired + cancelled.size(), timers.size());
+}
+
+}  // namespace testing
+}  // namespace grpc_core
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
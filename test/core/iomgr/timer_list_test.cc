@@ -25,6 +25,7 @@
 #include <grpc/support/log.h>
 
 #include "src/core/lib/debug/trace.h"
+#include "src/core/lib/gpr/useful.h"
 #include "src/core/lib/gprpp/time.h"
 #include "src/core/lib/iomgr/iomgr_internal.h"
 #include "src/core/lib/iomgr/port.h"
@@ -36,6 +37,8 @@
 
 extern grpc_core::TraceFlag grpc_timer_trace;
 extern grpc_core::TraceFlag grpc_timer_check_trace;
+extern grpc_timer_vtable grpc_generic_timer_vtable;
+extern grpc_timer_vtable grpc_wheel_timer_vtable;
 
 static int cb_called[MAX_CB][2];
 static const int64_t kHoursIn25Days = 25 * 24;
@@ -160,6 +163,58 @@ void destruction_test(void) {
   GPR_ASSERT(1 == cb_called[2][0]);
 }
 
+/* Timers far enough out to start on the coarser levels of a timing wheel must
+   still fire at their deadline, not before, and cancelling some of them must
+   not disturb the others. */
+void cascade_test(void) {
+  static const int64_t kDeadlines[] = {
+      1, 63, 64, 255, 256, 257, 4095, 4096, 65535, 65536, 65537, 300000};
+  static const int kNumTimers = GPR_ARRAY_SIZE(kDeadlines);
+  static_assert(kNumTimers <= MAX_CB, "too many timers");
+  grpc_timer timers[kNumTimers];
+  grpc_core::ExecCtx exec_ctx;
+
+  gpr_log(GPR_INFO, "cascade_test");
+
+  grpc_core::ExecCtx::Get()->TestOnlySetNow(
+      grpc_core::Timestamp::FromMillisecondsAfterProcessEpoch(0));
+  grpc_timer_list_init();
+  memset(cb_called, 0, sizeof(cb_called));
+
+  for (int i = 0; i < kNumTimers; i++) {
+    grpc_timer_init(
+        &timers[i],
+        grpc_core::Timestamp::FromMillisecondsAfterProcessEpoch(kDeadlines[i]),
+        GRPC_CLOSURE_CREATE(cb, (void*)(intptr_t)i, grpc_schedule_on_exec_ctx));
+  }
+  /* cancel every third timer */
+  for (int i = 0; i < kNumTimers; i += 3) {
+    grpc_timer_cancel(&timers[i]);
+  }
+  grpc_core::ExecCtx::Get()->Flush();
+
+  for (int i = 0; i < kNumTimers; i++) {
+    if (i % 3 == 0) continue;
+    grpc_core::ExecCtx::Get()->TestOnlySetNow(
+        grpc_core::Timestamp::FromMillisecondsAfterProcessEpoch(kDeadlines[i] -
+                                                                1));
+    grpc_timer_check(nullptr);
+    grpc_core::ExecCtx::Get()->Flush();
+    GPR_ASSERT(cb_called[i][1] == 0);
+    grpc_core::ExecCtx::Get()->TestOnlySetNow(
+        grpc_core::Timestamp::FromMillisecondsAfterProcessEpoch(kDeadlines[i]));
+    GPR_ASSERT(grpc_timer_check(nullptr) == GRPC_TIMERS_FIRED);
+    grpc_core::ExecCtx::Get()->Flush();
+    GPR_ASSERT(cb_called[i][1] == 1);
+  }
+  for (int i = 0; i < kNumTimers; i++) {
+    GPR_ASSERT(cb_called[i][0] == (i % 3 == 0));
+    GPR_ASSERT(cb_called[i][1] == (i % 3 != 0));
+  }
+
+  grpc_timer_list_shutdown();
+}
+
 /* Cleans up a list with pending timers that simulate long-running-services.
    This test does the following:
     1) Simulates grpc server start time to 25 days in the past (completed in
@@ -231,36 +286,42 @@ void long_running_service_cleanup_test(void) {
 int main(int argc, char** argv) {
   gpr_time_init();
 
-  /* Tests with default g_start_time */
-  {
-    grpc::testing::TestEnvironment env(&argc, argv);
-    grpc_core::ExecCtx exec_ctx;
-    grpc_set_default_iomgr_platform();
-    grpc_iomgr_platform_init();
-    gpr_set_log_verbosity(GPR_LOG_SEVERITY_DEBUG);
-    add_test();
-    destruction_test();
-    grpc_iomgr_platform_shutdown();
-  }
-
-  /* Begin long running service tests */
-  {
-    grpc::testing::TestEnvironment env(&argc, argv);
-    /* Set g_start_time back 25 days. */
-    /* We set g_start_time here in case there are any initialization
-        dependencies that use g_start_time. */
-    grpc_core::TestOnlySetProcessEpoch(gpr_time_sub(
-        gpr_now(gpr_clock_type::GPR_CLOCK_MONOTONIC),
-        gpr_time_add(gpr_time_from_hours(kHoursIn25Days, GPR_TIMESPAN),
-                     gpr_time_from_seconds(10, GPR_TIMESPAN))));
-    grpc_core::ExecCtx exec_ctx;
-    grpc_set_default_iomgr_platform();
-    grpc_iomgr_platform_init();
-    gpr_set_log_verbosity(GPR_LOG_SEVERITY_DEBUG);
-    long_running_service_cleanup_test();
-    add_test();
-    destruction_test();
-    grpc_iomgr_platform_shutdown();
+  for (grpc_timer_vtable* vtable :
+       {&grpc_generic_timer_vtable, &grpc_wheel_timer_vtable}) {
+    /* Tests with default g_start_time */
+    {
+      grpc::testing::TestEnvironment env(&argc, argv);
+      grpc_core::ExecCtx exec_ctx;
+      grpc_set_default_iomgr_platform();
+      grpc_set_timer_impl(vtable);
+      grpc_iomgr_platform_init();
+      gpr_set_log_verbosity(GPR_LOG_SEVERITY_DEBUG);
+      add_test();
+      destruction_test();
+      cascade_test();
+      grpc_iomgr_platform_shutdown();
+    }
+
+    /* Begin long running service tests */
+    {
+      grpc::testing::TestEnvironment env(&argc, argv);
+      /* Set g_start_time back 25 days. */
+      /* We set g_start_time here in case there are any initialization
+          dependencies that use g_start_time. */
+      grpc_core::TestOnlySetProcessEpoch(gpr_time_sub(
+          gpr_now(gpr_clock_type::GPR_CLOCK_MONOTONIC),
+          gpr_time_add(gpr_time_from_hours(kHoursIn25Days, GPR_TIMESPAN),
+                       gpr_time_from_seconds(10, GPR_TIMESPAN))));
+      grpc_core::ExecCtx exec_ctx;
+      grpc_set_default_iomgr_platform();
+      grpc_set_timer_impl(vtable);
+      grpc_iomgr_platform_init();
+      gpr_set_log_verbosity(GPR_LOG_SEVERITY_DEBUG);
+      long_running_service_cleanup_test();
+      add_test();
+      destruction_test();
+      grpc_iomgr_platform_shutdown();
+    }
   }
 
   return 0;
@@ -0,0 +1,109 @@
+// Copyright 2022 gRPC authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "src/core/lib/resource_quota/read_slab_pool.h"
+
+#include <string.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <grpc/grpc.h>
+
+#include "src/core/lib/iomgr/exec_ctx.h"
+#include "src/core/lib/slice/slice_internal.h"
+#include "test/core/util/test_config.h"
+
+namespace grpc_core {
+namespace testing {
+
+TEST(ReadSlabPoolTest, SliceIsWritable) {
+  ExecCtx exec_ctx;
+  MemoryQuota memory_quota("foo");
+  auto allocator = memory_quota.CreateMemoryAllocator("bar");
+  grpc_slice slice = ReadSlabPool::Get()->MakeSlice(&allocator);
+  ASSERT_EQ(GRPC_SLICE_LENGTH(slice), ReadSlabPool::kSlabSize);
+  memset(GRPC_SLICE_START_PTR(slice), 0xab, GRPC_SLICE_LENGTH(slice));
+  grpc_slice_unref_internal(slice);
+}
+
+TEST(ReadSlabPoolTest, ReleasedSlabsAreKeptUntilDrained) {
+  ExecCtx exec_ctx;
+  MemoryQuota memory_quota("foo");
+  auto allocator = memory_quota.CreateMemoryAllocator("bar");
+  ReadSlabPool* pool = ReadSlabPool::Get();
+  pool->Drain();
+  EXPECT_EQ(pool->idle_slabs(), 0u);
+  grpc_slice slices[4];
+  for (auto& slice : slices) slice = pool->MakeSlice(&allocator);
+  EXPECT_EQ(pool->idle_slabs(), 0u);
+  for (auto& slice : slices) grpc_slice_unref_internal(slice);
+  EXPECT_EQ(pool->idle_slabs(), 4u);
+  EXPECT_EQ(pool->Drain(), 4u);
+  EXPECT_EQ(pool->idle_slabs(), 0u);
+}
+
+TEST(ReadSlabPoolTest, ConcurrentRecycleAndDrainKeepQuotaBalanced) {
+  ExecCtx exec_ctx;
+  MemoryQuota memory_quota("foo");
+  auto allocator = memory_quota.CreateMemoryAllocator("bar");
+  ReadSlabPool* pool = ReadSlabPool::Get();
+  pool->Drain();
+  EXPECT_EQ(pool->charged_bytes(), 0u);
+  // Find out what one idle slab costs.
+  grpc_slice_unref_internal(pool->MakeSlice(&allocator));
+  const size_t slab_charge = pool->charged_bytes();
+  EXPECT_GT(slab_charge, 0u);
+  std::vector<std::thread> threads;
+  std::atomic<bool> done{false};
+  for (int i = 0; i < 4; i++) {
+    threads.emplace_back([pool, &memory_quota]() {
+      ExecCtx exec_ctx;
+      auto allocator = memory_quota.CreateMemoryAllocator("baz");
+      for (int j = 0; j < 1000; j++) {
+        grpc_slice slices[8];
+        for (auto& slice : slices) slice = pool->MakeSlice(&allocator);
+        for (auto& slice : slices) grpc_slice_unref_internal(slice);
+      }
+    });
+  }
+  std::thread drainer([pool, &done]() {
+    ExecCtx exec_ctx;
+    while (!done.load(std::memory_order_relaxed)) pool->Drain();
+  });
+  for (auto& thread : threads) thread.join();
+  done.store(true, std::memory_order_relaxed);
+  drainer.join();
+  // Whatever interleaving happened, the pool holds exactly the charge for
+  // its idle slabs, and nothing once they are drained.
+  EXPECT_EQ(pool->charged_bytes(), pool->idle_slabs() * slab_charge);
+  pool->Drain();
+  EXPECT_EQ(pool->charged_bytes(), 0u);
+  EXPECT_EQ(pool->idle_slabs(), 0u);
+}
+
+}  // namespace testing
+}  // namespace grpc_core
+
+int main(int argc, char** argv) {
+  grpc::testing::TestEnvironment env(&argc, argv);
+  grpc_init();
+  ::testing::InitGoogleTest(&argc, argv);
+  int ret = RUN_ALL_TESTS();
+  grpc_shutdown();
+  return ret;
+}
@@ -166,6 +166,65 @@ static void test_cq_end_op(void) {
   }
 }
 
+static void test_next_batch(void) {
+  grpc_event events[8];
+  grpc_completion_queue* cc;
+  void* tags[16];
+  grpc_cq_completion completions[GPR_ARRAY_SIZE(tags)];
+  bool seen[GPR_ARRAY_SIZE(tags)];
+  int num_shards[] = {1, 4};
+  grpc_completion_queue_attributes attr;
+
+  LOG_TEST("test_next_batch");
+
+  for (size_t i = 0; i < GPR_ARRAY_SIZE(tags); i++) {
+    tags[i] = create_test_tag();
+  }
+
+  attr.version = GRPC_CQ_VERSION_MINIMUM_FOR_SHARDING;
+  attr.cq_completion_type = GRPC_CQ_NEXT;
+  attr.cq_polling_type = GRPC_CQ_NON_POLLING;
+  attr.cq_shutdown_cb = nullptr;
+  for (size_t sidx = 0; sidx < GPR_ARRAY_SIZE(num_shards); sidx++) {
+    grpc_core::ExecCtx exec_ctx;
+    attr.cq_num_shards = num_shards[sidx];
+    cc = grpc_completion_queue_create(
+        grpc_completion_queue_factory_lookup(&attr), &attr, nullptr);
+
+    for (size_t i = 0; i < GPR_ARRAY_SIZE(tags); i++) {
+      GPR_ASSERT(grpc_cq_begin_op(cc, tags[i]));
+      grpc_cq_end_op(cc, tags[i], GRPC_ERROR_NONE, do_nothing_end_completion,
+                     nullptr, &completions[i]);
+      seen[i] = false;
+    }
+
+    /* Two full batches drain everything, whichever shards the events were
+       queued on */
+    for (int batch = 0; batch < 2; batch++) {
+      int n = grpc_completion_queue_next_batch(
+          cc, events, GPR_ARRAY_SIZE(events), gpr_inf_past(GPR_CLOCK_REALTIME),
+          nullptr);
+      GPR_ASSERT(n == static_cast<int>(GPR_ARRAY_SIZE(events)));
+      for (int j = 0; j < n; j++) {
+        GPR_ASSERT(events[j].type == GRPC_OP_COMPLETE);
+        GPR_ASSERT(events[j].success);
+        size_t k = 0;
+        while (k < GPR_ARRAY_SIZE(tags) && tags[k] != events[j].tag) k++;
+        GPR_ASSERT(k < GPR_ARRAY_SIZE(tags));
+        GPR_ASSERT(!seen[k]);
+        seen[k] = true;
+      }
+    }
+
+    GPR_ASSERT(grpc_completion_queue_next_batch(
+                   cc, events, GPR_ARRAY_SIZE(events),
+                   gpr_inf_past(GPR_CLOCK_REALTIME), nullptr) == 1);
+    GPR_ASSERT(events[0].type == GRPC_QUEUE_TIMEOUT);
+
+    shutdown_and_destroy(cc);
+  }
+}
+
 static void test_cq_tls_cache_full(void) {
   grpc_event ev;
   grpc_completion_queue* cc;
@@ -495,6 +554,7 @@ int main(int argc, char** argv) {
   test_shutdown_then_next_polling();
   test_shutdown_then_next_with_timeout();
   test_cq_end_op();
+  test_next_batch();
   test_pluck();
   test_pluck_after_shutdown();
   test_cq_tls_cache_full();
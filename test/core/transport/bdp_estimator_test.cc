@@ -20,6 +20,8 @@
 
 #include <limits.h>
 
+#include <algorithm>
+
 #include <gtest/gtest.h>
 
 #include <grpc/grpc.h>
@@ -136,6 +138,61 @@ INSTANTIATE_TEST_SUITE_P(TooManyNames, BdpEstimatorRandomTest,
                          ::testing::Values(3, 4, 6, 9, 13, 19, 28, 42, 63, 94,
                                            141, 211, 316, 474, 711));
 
+TEST(BdpEstimatorTest, PingFeedsDeliveryRate) {
+  BdpEstimator est("test");
+  ExecCtx exec_ctx;
+  est.SchedulePing();
+  est.StartPing();
+  est.AddIncomingBytes(300000);
+  inc_time();
+  ExecCtx::Get()->InvalidateNow();
+  est.CompletePing();
+  EXPECT_EQ(est.completed_pings(), 1);
+  EXPECT_DOUBLE_EQ(est.delivery_rate().max_bandwidth(), 10000);
+  EXPECT_DOUBLE_EQ(est.delivery_rate().min_rtt(), 30);
+}
+
+TEST(DeliveryRateEstimatorTest, NoSamples) {
+  DeliveryRateEstimator est;
+  est.AddSample(0, 1);
+  est.AddSample(100, 0);
+  EXPECT_EQ(est.max_bandwidth(), 0);
+  EXPECT_EQ(est.TargetWindow(), 0);
+  EXPECT_TRUE(est.probing());
+}
+
+TEST(DeliveryRateEstimatorTest, WindowLimitedRampFillsPipe) {
+  // 100MB/s with a 100ms round trip: a 10MB bandwidth-delay product.
+  const double kBandwidth = 100e6;
+  const double kRtt = 0.1;
+  DeliveryRateEstimator est;
+  double window = 65535;
+  int rounds = 0;
+  while (est.probing()) {
+    ASSERT_LT(++rounds, 30);
+    est.AddSample(static_cast<int64_t>(std::min(window, kBandwidth * kRtt)),
+                  kRtt);
+    window = std::max(window, est.TargetWindow());
+  }
+  // The window grows by the startup gain every round trip until it covers the
+  // bandwidth-delay product, then the estimate needs a few flat rounds.
+  EXPECT_LE(rounds, 11);
+  EXPECT_DOUBLE_EQ(est.max_bandwidth(), kBandwidth);
+  EXPECT_DOUBLE_EQ(est.min_rtt(), kRtt);
+  EXPECT_DOUBLE_EQ(est.TargetWindow(),
+                   DeliveryRateEstimator::kSteadyGain * kBandwidth * kRtt);
+}
+
+TEST(DeliveryRateEstimatorTest, FiltersExpireOldSamples) {
+  DeliveryRateEstimator est;
+  est.AddSample(1000000, 0.05);
+  EXPECT_DOUBLE_EQ(est.min_rtt(), 0.05);
+  EXPECT_DOUBLE_EQ(est.max_bandwidth(), 20000000);
+  for (int i = 0; i < 10; i++) est.AddSample(1000, 0.2);
+  EXPECT_DOUBLE_EQ(est.min_rtt(), 0.2);
+  EXPECT_DOUBLE_EQ(est.max_bandwidth(), 5000);
+}
+
 }  // namespace testing
 }  // namespace grpc_core
 
@@ -20,6 +20,8 @@
 
 #include <string.h>
 
+#include <string>
+
 /* This is here for grpc_is_binary_header
  * TODO(murgatroid99): Remove this
  */
@@ -27,6 +29,7 @@
 #include <grpc/support/alloc.h>
 #include <grpc/support/log.h>
 
+#include "src/core/ext/transport/chttp2/transport/huffsyms.h"
 #include "src/core/lib/gpr/string.h"
 #include "src/core/lib/slice/slice_string_helpers.h"
 #include "test/core/util/test_config.h"
@@ -92,6 +95,26 @@ static void expect_combined_equiv(const char* s, size_t len, int line) {
 #define EXPECT_COMBINED_EQUIV(x) \
   expect_combined_equiv(x, sizeof(x) - 1, __LINE__)
 
+static void expect_huff_roundtrip(const char* s, size_t len, int line) {
+  grpc_slice input = grpc_slice_from_copied_buffer(s, len);
+  grpc_slice compressed = grpc_chttp2_huffman_compress(input);
+  std::string decoded;
+  grpc_core::HuffmanDecoder::Decode(
+      GRPC_SLICE_START_PTR(compressed), GRPC_SLICE_LENGTH(compressed),
+      [&decoded](uint8_t c) { decoded.push_back(static_cast<char>(c)); });
+  if (decoded != std::string(s, len)) {
+    char* t = grpc_dump_slice(input, GPR_DUMP_HEX | GPR_DUMP_ASCII);
+    gpr_log(GPR_ERROR, "FAILED:%d: huffman roundtrip of %s", line, t);
+    gpr_free(t);
+    all_ok = 0;
+  }
+  grpc_slice_unref(input);
+  grpc_slice_unref(compressed);
+}
+
+#define EXPECT_HUFF_ROUNDTRIP(x) \
+  expect_huff_roundtrip(x, sizeof(x) - 1, __LINE__)
+
 static void expect_binary_header(const char* hdr, int binary) {
   if (grpc_is_binary_header(grpc_slice_from_static_string(hdr)) != binary) {
     gpr_log(GPR_ERROR, "FAILED: expected header '%s' to be %s", hdr,
@@ -170,6 +193,22 @@ int main(int argc, char** argv) {
       "\xe0\xe1\xe2\xe3\xe4\xe5\xe6\xe7\xe8\xe9\xea\xeb\xec\xed\xee\xef"
       "\xf0\xf1\xf2\xf3\xf4\xf5\xf6\xf7\xf8\xf9\xfa\xfb\xfc\xfd\xfe\xff");
 
+  /* Huffman roundtrips, covering codes longer than the decoder's fast table
+     and strings long enough to cross several 32-bit flushes */
+  EXPECT_HUFF_ROUNDTRIP("");
+  EXPECT_HUFF_ROUNDTRIP("www.example.com");
+  EXPECT_HUFF_ROUNDTRIP("Mon, 21 Oct 2013 20:13:21 GMT");
+  EXPECT_HUFF_ROUNDTRIP("\x0a\x0d\x16\xff\xfe\x0a");
+  EXPECT_HUFF_ROUNDTRIP(
+      "/grpc.testing.EchoTestService/Echo?query=0123456789abcdefghijklmnopqr"
+      "stuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ~!@#$%^&*()_+`-=[]{}|;':\",./<>?");
+  {
+    std::string all_bytes;
+    for (int i = 0; i < 256; i++) all_bytes.push_back(static_cast<char>(i));
+    for (int i = 255; i >= 0; i--) all_bytes.push_back(static_cast<char>(i));
+    expect_huff_roundtrip(all_bytes.data(), all_bytes.size(), __LINE__);
+  }
+
   expect_binary_header("foo-bin", 1);
   expect_binary_header("foo-bar", 0);
   expect_binary_header("-bin", 0);
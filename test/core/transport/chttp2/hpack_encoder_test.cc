@@ -18,11 +18,13 @@
 
 #include "src/core/ext/transport/chttp2/transport/hpack_encoder.h"
 
+#include <inttypes.h>
 #include <stdio.h>
 #include <string.h>
 
 #include <string>
 
+#include "absl/memory/memory.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
 
@@ -214,6 +216,44 @@ static void test_basic_headers() {
          "b", "c");
 }
 
+static void test_frequency_admission() {
+  verify_params params = {
+      false,
+      false,
+  };
+  g_compressor->SetIndexingPolicy(
+      absl::make_unique<grpc_core::FrequencySketchIndexingPolicy>());
+  // First sighting is not worth indexing, the second is, and the third can
+  // then be sent indexed.
+  verify(params, "000005 0104 deadbeef 00 0161 0161", 1, "a", "a");
+  verify(params, "000005 0104 deadbeef 40 0161 0161", 1, "a", "a");
+  verify(params, "000001 0104 deadbeef be", 1, "a", "a");
+  // A different value for the same key starts over.
+  verify(params, "000005 0104 deadbeef 00 0161 0162", 1, "a", "b");
+}
+
+static void test_frequency_admission_never_indexes_credentials() {
+  verify_params params = {
+      false,
+      false,
+  };
+  g_compressor->SetIndexingPolicy(
+      absl::make_unique<grpc_core::FrequencySketchIndexingPolicy>());
+  // However often they repeat, credentials are sent as never-indexed
+  // literals and nothing is added to the table.
+  for (int i = 0; i < 3; i++) {
+    verify(params,
+           "000011 0104 deadbeef 10 0d 617574686f72697a6174696f6e 0178", 1,
+           "authorization", "x");
+  }
+  verify(params, "00000a 0104 deadbeef 10 06 636f6f6b6965 0178", 1, "cookie",
+         "x");
+  if (g_compressor->test_only_table_size() != 0) {
+    gpr_log(GPR_ERROR, "credentials were added to the dynamic table");
+    g_failure = 1;
+  }
+}
+
 static void verify_continuation_headers(const char* key, const char* value,
                                         bool is_eof) {
   auto arena = grpc_core::MakeScopedArena(1024, g_memory_allocator);
@@ -261,6 +301,8 @@ int main(int argc, char** argv) {
   grpc_init();
   TEST(test_basic_headers);
   TEST(test_continuation_headers);
+  TEST(test_frequency_admission);
+  TEST(test_frequency_admission_never_indexes_credentials);
   grpc_shutdown();
   return g_failure;
 }
@@ -49,11 +49,14 @@ namespace {
 // A gRPC server, running in its own thread.
 class ServerThread {
  public:
-  explicit ServerThread(const char* address) : address_(address) {}
+  explicit ServerThread(const char* address,
+                        int max_concurrent_handshakes = 0)
+      : address_(address),
+        max_concurrent_handshakes_(max_concurrent_handshakes) {}
 
   void Start() {
     // Start server with 1-second handshake timeout.
-    grpc_arg a[2];
+    grpc_arg a[3];
     a[0].type = GRPC_ARG_INTEGER;
     a[0].key = const_cast<char*>(GRPC_ARG_SERVER_HANDSHAKE_TIMEOUT_MS);
     a[0].value.integer = 1000;
@@ -61,7 +64,10 @@ class ServerThread {
     a[1].type = GRPC_ARG_POINTER;
     a[1].value.pointer.p = grpc_resource_quota_create("test");
     a[1].value.pointer.vtable = grpc_resource_quota_arg_vtable();
-    grpc_channel_args args = {2, a};
+    a[2].type = GRPC_ARG_INTEGER;
+    a[2].key = const_cast<char*>(GRPC_ARG_SERVER_MAX_CONCURRENT_HANDSHAKES);
+    a[2].value.integer = max_concurrent_handshakes_;
+    grpc_channel_args args = {3, a};
     server_ = grpc_server_create(&args, nullptr);
     grpc_server_credentials* server_creds =
         grpc_insecure_server_credentials_create();
@@ -99,6 +105,7 @@ class ServerThread {
   }
 
   const char* address_;  // Do not own.
+  const int max_concurrent_handshakes_;
   grpc_server* server_ = nullptr;
   grpc_completion_queue* cq_ = nullptr;
   std::unique_ptr<std::thread> thread_;
@@ -139,14 +146,14 @@ class Client {
 
   // Reads until an error is returned.
   // Returns true if an error was encountered before the deadline.
-  bool ReadUntilError() {
+  // Use a default timeout of 3 seconds, which is a lot more than we should
+  // need for a 1-second timeout, but this helps avoid flakes.
+  bool ReadUntilError(Duration timeout = Duration::Seconds(3)) {
     ExecCtx exec_ctx;
     grpc_slice_buffer read_buffer;
     grpc_slice_buffer_init(&read_buffer);
     bool retval = true;
-    // Use a deadline of 3 seconds, which is a lot more than we should
-    // need for a 1-second timeout, but this helps avoid flakes.
-    Timestamp deadline = ExecCtx::Get()->Now() + Duration::Seconds(3);
+    Timestamp deadline = ExecCtx::Get()->Now() + timeout;
     while (true) {
       EventState state;
       grpc_endpoint_read(endpoint_, &read_buffer, state.closure(),
@@ -258,6 +265,33 @@ TEST(SettingsTimeout, Basic) {
   // Clean up.
 }
 
+TEST(SettingsTimeout, MaxConcurrentHandshakes) {
+  const int server_port = grpc_pick_unused_port_or_die();
+  std::string server_address_string = absl::StrCat("localhost:", server_port);
+  ServerThread server_thread(server_address_string.c_str(),
+                             /*max_concurrent_handshakes=*/1);
+  server_thread.Start();
+  // The first connection handshakes, the second waits for it, and the third
+  // finds the queue full.
+  Client client1(server_address_string.c_str());
+  Client client2(server_address_string.c_str());
+  Client client3(server_address_string.c_str());
+  client1.Connect();
+  client2.Connect();
+  client3.Connect();
+  // The third connection is closed right away, well before the handshake
+  // timeout.
+  EXPECT_TRUE(client3.ReadUntilError(Duration::Milliseconds(500)));
+  // The others are dropped at their handshake deadline, whether or not they
+  // got a slot.
+  EXPECT_TRUE(client1.ReadUntilError());
+  EXPECT_TRUE(client2.ReadUntilError());
+  client1.Shutdown();
+  client2.Shutdown();
+  client3.Shutdown();
+  server_thread.Shutdown();
+}
+
 }  // namespace
 }  // namespace test
 }  // namespace grpc_core
@@ -167,6 +167,60 @@ static void test_periodic_compaction(uint32_t n) {
   grpc_chttp2_stream_map_destroy(&map);
 }
 
+/* delete every entry from inside for_each, as the transport does when it
+   cancels all streams, and make sure each entry is visited exactly once */
+static void delete_in_for_each(void* user_data, uint32_t stream_id,
+                               void* ptr) {
+  grpc_chttp2_stream_map* map = static_cast<grpc_chttp2_stream_map*>(user_data);
+  GPR_ASSERT((void*)(uintptr_t)stream_id == ptr);
+  GPR_ASSERT(ptr == grpc_chttp2_stream_map_delete(map, stream_id));
+}
+
+static void test_delete_in_for_each(uint32_t n) {
+  grpc_chttp2_stream_map map;
+  uint32_t i;
+
+  LOG_TEST("test_delete_in_for_each");
+  gpr_log(GPR_INFO, "n = %d", n);
+
+  grpc_chttp2_stream_map_init(&map, 8);
+  for (i = 1; i <= n; i++) {
+    grpc_chttp2_stream_map_add(&map, 2 * i + 1, (void*)(uintptr_t)(2 * i + 1));
+  }
+  grpc_chttp2_stream_map_for_each(&map, delete_in_for_each, &map);
+  GPR_ASSERT(0 == grpc_chttp2_stream_map_size(&map));
+  GPR_ASSERT(map.capacity == 8);
+  grpc_chttp2_stream_map_destroy(&map);
+}
+
+/* rand must only ever return live entries */
+static void test_rand(uint32_t n) {
+  grpc_chttp2_stream_map map;
+  uint32_t i;
+  uintptr_t got;
+
+  LOG_TEST("test_rand");
+  gpr_log(GPR_INFO, "n = %d", n);
+
+  grpc_chttp2_stream_map_init(&map, 8);
+  GPR_ASSERT(nullptr == grpc_chttp2_stream_map_rand(&map));
+  for (i = 1; i <= n; i++) {
+    grpc_chttp2_stream_map_add(&map, i, reinterpret_cast<void*>(i));
+  }
+  for (i = 1; i <= n; i++) {
+    if (i % 3 != 0) grpc_chttp2_stream_map_delete(&map, i);
+  }
+  for (i = 0; i < 100; i++) {
+    got = reinterpret_cast<uintptr_t>(grpc_chttp2_stream_map_rand(&map));
+    if (n < 3) {
+      GPR_ASSERT(got == 0);
+    } else {
+      GPR_ASSERT(got != 0 && got % 3 == 0 && got <= n);
+    }
+  }
+  grpc_chttp2_stream_map_destroy(&map);
+}
+
 int main(int argc, char** argv) {
   uint32_t n = 1;
   uint32_t prev = 1;
@@ -182,6 +236,8 @@ int main(int argc, char** argv) {
     test_delete_evens_sweep(n);
     test_delete_evens_incremental(n);
     test_periodic_compaction(n);
+    test_delete_in_for_each(n);
+    test_rand(n);
 
     tmp = n;
     n += prev;
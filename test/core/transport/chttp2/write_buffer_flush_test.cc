@@ -0,0 +1,181 @@
+/*
+ *
+ * Copyright 2022 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <string.h>
+
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include <grpc/grpc.h>
+#include <grpc/grpc_security.h>
+#include <grpc/impl/codegen/grpc_types.h>
+#include <grpc/slice.h>
+#include <grpc/support/log.h>
+
+#include "src/core/lib/channel/channel_args.h"
+#include "src/core/lib/gprpp/host_port.h"
+#include "test/core/end2end/cq_verifier.h"
+#include "test/core/util/port.h"
+#include "test/core/util/test_config.h"
+
+namespace {
+
+void* tag(intptr_t t) { return reinterpret_cast<void*>(t); }
+
+// A client and server connected over http2, where the client channel may set
+// GRPC_ARG_HTTP2_WRITE_BUFFER_MAX_DELAY_MS.
+class WriteBufferFlushTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    cq_ = grpc_completion_queue_create_for_next(nullptr);
+    cqv_ = cq_verifier_create(cq_);
+    grpc_metadata_array_init(&request_metadata_recv_);
+    grpc_call_details_init(&call_details_);
+    server_ = grpc_server_create(nullptr, nullptr);
+    server_address_ =
+        grpc_core::JoinHostPort("localhost", grpc_pick_unused_port_or_die());
+    grpc_server_register_completion_queue(server_, cq_, nullptr);
+    grpc_server_credentials* server_creds =
+        grpc_insecure_server_credentials_create();
+    GPR_ASSERT(grpc_server_add_http2_port(server_, server_address_.c_str(),
+                                          server_creds));
+    grpc_server_credentials_release(server_creds);
+    grpc_server_start(server_);
+  }
+
+  void TearDown() override {
+    if (client_call_ != nullptr) grpc_call_unref(client_call_);
+    if (server_call_ != nullptr) grpc_call_unref(server_call_);
+    grpc_byte_buffer_destroy(request_payload_);
+    grpc_byte_buffer_destroy(request_payload_recv_);
+    grpc_metadata_array_destroy(&request_metadata_recv_);
+    grpc_call_details_destroy(&call_details_);
+    if (channel_ != nullptr) grpc_channel_destroy(channel_);
+    grpc_server_shutdown_and_notify(server_, cq_, tag(1000));
+    CQ_EXPECT_COMPLETION(cqv_, tag(1000), true);
+    cq_verify(cqv_);
+    grpc_server_destroy(server_);
+    cq_verifier_destroy(cqv_);
+    grpc_completion_queue_shutdown(cq_);
+    while (grpc_completion_queue_next(cq_, gpr_inf_future(GPR_CLOCK_REALTIME),
+                                      nullptr)
+               .type != GRPC_QUEUE_SHUTDOWN) {
+    }
+    grpc_completion_queue_destroy(cq_);
+  }
+
+  // Starts a call, and then sends one message on it with
+  // GRPC_WRITE_BUFFER_HINT and has the server wait for that message (tag 103).
+  void SendBufferedMessage(int max_delay_ms) {
+    grpc_arg arg = grpc_channel_arg_integer_create(
+        const_cast<char*>(GRPC_ARG_HTTP2_WRITE_BUFFER_MAX_DELAY_MS),
+        max_delay_ms);
+    grpc_channel_args client_args = {1, &arg};
+    grpc_channel_credentials* creds = grpc_insecure_credentials_create();
+    channel_ = grpc_channel_create(server_address_.c_str(), creds,
+                                   max_delay_ms > 0 ? &client_args : nullptr);
+    grpc_channel_credentials_release(creds);
+    client_call_ = grpc_channel_create_call(
+        channel_, nullptr, GRPC_PROPAGATE_DEFAULTS, cq_,
+        grpc_slice_from_static_string("/foo"), nullptr,
+        grpc_timeout_seconds_to_deadline(30), nullptr);
+    GPR_ASSERT(client_call_);
+
+    // Send the headers first, so that the stream is open when the buffered
+    // message is written.
+    grpc_op ops[1];
+    memset(ops, 0, sizeof(ops));
+    ops[0].op = GRPC_OP_SEND_INITIAL_METADATA;
+    ops[0].data.send_initial_metadata.count = 0;
+    GPR_ASSERT(GRPC_CALL_OK ==
+               grpc_call_start_batch(client_call_, ops, 1, tag(1), nullptr));
+    GPR_ASSERT(GRPC_CALL_OK ==
+               grpc_server_request_call(server_, &server_call_, &call_details_,
+                                        &request_metadata_recv_, cq_, cq_,
+                                        tag(101)));
+    CQ_EXPECT_COMPLETION(cqv_, tag(1), true);
+    CQ_EXPECT_COMPLETION(cqv_, tag(101), true);
+    cq_verify(cqv_);
+
+    grpc_slice request_payload_slice =
+        grpc_slice_from_copied_string("hello world");
+    request_payload_ = grpc_raw_byte_buffer_create(&request_payload_slice, 1);
+    grpc_slice_unref(request_payload_slice);
+    memset(ops, 0, sizeof(ops));
+    ops[0].op = GRPC_OP_SEND_MESSAGE;
+    ops[0].data.send_message.send_message = request_payload_;
+    ops[0].flags = GRPC_WRITE_BUFFER_HINT;
+    GPR_ASSERT(GRPC_CALL_OK ==
+               grpc_call_start_batch(client_call_, ops, 1, tag(2), nullptr));
+    memset(ops, 0, sizeof(ops));
+    ops[0].op = GRPC_OP_RECV_MESSAGE;
+    ops[0].data.recv_message.recv_message = &request_payload_recv_;
+    GPR_ASSERT(GRPC_CALL_OK ==
+               grpc_call_start_batch(server_call_, ops, 1, tag(103), nullptr));
+    // The buffered write completes as soon as it is queued.
+    CQ_EXPECT_COMPLETION(cqv_, tag(2), true);
+    cq_verify(cqv_);
+  }
+
+  void CancelCalls() {
+    grpc_call_cancel(client_call_, nullptr);
+    grpc_call_cancel(server_call_, nullptr);
+  }
+
+  grpc_completion_queue* cq_;
+  cq_verifier* cqv_;
+  grpc_server* server_;
+  std::string server_address_;
+  grpc_channel* channel_ = nullptr;
+  grpc_call* client_call_ = nullptr;
+  grpc_call* server_call_ = nullptr;
+  grpc_metadata_array request_metadata_recv_;
+  grpc_call_details call_details_;
+  grpc_byte_buffer* request_payload_ = nullptr;
+  grpc_byte_buffer* request_payload_recv_ = nullptr;
+};
+
+TEST_F(WriteBufferFlushTest, BufferedMessageWaitsWithoutMaxDelay) {
+  SendBufferedMessage(0);
+  // Nothing else is written on the stream, so the message stays buffered.
+  cq_verify_empty_timeout(cqv_, 2);
+  CancelCalls();
+  CQ_EXPECT_COMPLETION_ANY_STATUS(cqv_, tag(103));
+  cq_verify(cqv_);
+}
+
+TEST_F(WriteBufferFlushTest, BufferedMessageIsFlushedAfterMaxDelay) {
+  SendBufferedMessage(100);
+  // The flush timer writes the message without waiting for another write.
+  CQ_EXPECT_COMPLETION(cqv_, tag(103), true);
+  cq_verify(cqv_, 5);
+  EXPECT_TRUE(byte_buffer_eq_string(request_payload_recv_, "hello world"));
+  CancelCalls();
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  grpc::testing::TestEnvironment env(&argc, argv);
+  grpc_init();
+  int result = RUN_ALL_TESTS();
+  grpc_shutdown();
+  return result;
+}
@@ -0,0 +1,197 @@
+/*
+ *
+ * Copyright 2022 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <grpc/grpc.h>
+#include <grpc/support/alloc.h>
+
+#include "src/core/ext/transport/chttp2/transport/chttp2_transport.h"
+#include "src/core/ext/transport/chttp2/transport/internal.h"
+#include "src/core/lib/channel/channel_args.h"
+#include "src/core/lib/config/core_configuration.h"
+#include "src/core/lib/slice/slice_internal.h"
+#include "src/core/lib/transport/transport.h"
+#include "test/core/util/mock_endpoint.h"
+#include "test/core/util/slice_splitter.h"
+#include "test/core/util/test_config.h"
+
+namespace grpc_core {
+namespace testing {
+namespace {
+
+void discard_write(grpc_slice /*slice*/) {}
+
+// (stream id, payload length) of a DATA frame.
+using DataFrame = std::pair<uint32_t, uint32_t>;
+
+// Drives the chttp2 write path directly: streams are given pending data and
+// queued as writable, and the DATA frames produced by grpc_chttp2_begin_write
+// are read back out of the transport's output buffer.
+class WriteSchedulingTest : public ::testing::Test {
+ protected:
+  void CreateTransport(int write_quantum) {
+    grpc_arg arg = grpc_channel_arg_integer_create(
+        const_cast<char*>(GRPC_ARG_HTTP2_WRITE_QUANTUM_BYTES), write_quantum);
+    grpc_channel_args quantum_args = {1, &arg};
+    const grpc_channel_args* args = CoreConfiguration::Get()
+                                        .channel_args_preconditioning()
+                                        .PreconditionChannelArgs(&quantum_args)
+                                        .ToC();
+    transport_ = grpc_create_chttp2_transport(
+        args, grpc_mock_endpoint_create(discard_write), true);
+    grpc_channel_args_destroy(args);
+    GRPC_STREAM_REF_INIT(&ref_, 1, nullptr, nullptr, "phony ref");
+    // Let the initial settings write finish so the transport is idle.
+    ExecCtx::Get()->Flush();
+  }
+
+  void TearDown() override {
+    ExecCtx exec_ctx;
+    for (grpc_chttp2_stream* s : streams_) {
+      // The streams were never registered in the stream map.
+      s->id = 0;
+      grpc_transport_destroy_stream(transport_,
+                                    reinterpret_cast<grpc_stream*>(s), nullptr);
+      exec_ctx.Flush();
+      gpr_free(s);
+    }
+    grpc_transport_destroy(transport_);
+    exec_ctx.Flush();
+  }
+
+  // Adds a stream with length bytes of DATA ready to send and queues it as
+  // writable.
+  grpc_chttp2_stream* AddWritableStream(grpc_chttp2_write_priority priority,
+                                        size_t length) {
+    auto* s = static_cast<grpc_chttp2_stream*>(
+        gpr_malloc(grpc_transport_stream_size(transport_)));
+    grpc_transport_init_stream(transport_, reinterpret_cast<grpc_stream*>(s),
+                               &ref_, nullptr, nullptr);
+    streams_.push_back(s);
+    s->id = 2 * streams_.size() - 1;
+    s->sent_initial_metadata = true;
+    s->write_priority = priority;
+    std::string data(length, 'a');
+    grpc_slice_buffer_add(&s->flow_controlled_buffer,
+                          grpc_slice_from_copied_buffer(data.data(), length));
+    GRPC_CHTTP2_STREAM_REF(s, "chttp2_writing:become");
+    EXPECT_TRUE(grpc_chttp2_list_add_writable_stream(t(), s));
+    return s;
+  }
+
+  // Runs one write and returns the DATA frames it produced, in order.
+  std::vector<DataFrame> Write() {
+    grpc_chttp2_begin_write(t());
+    std::vector<DataFrame> frames;
+    grpc_slice merged = grpc_slice_merge(t()->outbuf.slices, t()->outbuf.count);
+    const uint8_t* p = GRPC_SLICE_START_PTR(merged);
+    const uint8_t* end = GRPC_SLICE_END_PTR(merged);
+    while (p + 9 <= end) {
+      uint32_t length = (p[0] << 16) | (p[1] << 8) | p[2];
+      uint32_t stream_id =
+          ((p[5] & 0x7f) << 24) | (p[6] << 16) | (p[7] << 8) | p[8];
+      if (p[3] == GRPC_CHTTP2_FRAME_DATA) {
+        frames.emplace_back(stream_id, length);
+      }
+      p += 9 + length;
+    }
+    grpc_slice_unref_internal(merged);
+    grpc_chttp2_end_write(t(), GRPC_ERROR_NONE);
+    return frames;
+  }
+
+  grpc_chttp2_transport* t() {
+    return reinterpret_cast<grpc_chttp2_transport*>(transport_);
+  }
+
+ private:
+  grpc_transport* transport_ = nullptr;
+  grpc_stream_refcount ref_;
+  std::vector<grpc_chttp2_stream*> streams_;
+};
+
+TEST_F(WriteSchedulingTest, QuantumInterleavesStreams) {
+  ExecCtx exec_ctx;
+  CreateTransport(1024);
+  for (int i = 0; i < 3; i++) {
+    AddWritableStream(GRPC_CHTTP2_WRITE_PRIORITY_NORMAL, 3 * 1024);
+  }
+  // Each turn writes one quantum, then the stream goes to the back of the
+  // list.
+  EXPECT_EQ(Write(), std::vector<DataFrame>({{1, 1024},
+                                             {3, 1024},
+                                             {5, 1024},
+                                             {1, 1024},
+                                             {3, 1024},
+                                             {5, 1024},
+                                             {1, 1024},
+                                             {3, 1024},
+                                             {5, 1024}}));
+}
+
+TEST_F(WriteSchedulingTest, ShorterStreamLeavesTheRotation) {
+  ExecCtx exec_ctx;
+  CreateTransport(1024);
+  AddWritableStream(GRPC_CHTTP2_WRITE_PRIORITY_NORMAL, 1536);
+  AddWritableStream(GRPC_CHTTP2_WRITE_PRIORITY_NORMAL, 2048);
+  EXPECT_EQ(Write(), std::vector<DataFrame>(
+                         {{1, 1024}, {3, 1024}, {1, 512}, {3, 1024}}));
+}
+
+TEST_F(WriteSchedulingTest, ZeroQuantumWritesWholeWindow) {
+  ExecCtx exec_ctx;
+  CreateTransport(0);
+  AddWritableStream(GRPC_CHTTP2_WRITE_PRIORITY_NORMAL, 4096);
+  AddWritableStream(GRPC_CHTTP2_WRITE_PRIORITY_NORMAL, 4096);
+  EXPECT_EQ(Write(), std::vector<DataFrame>({{1, 4096}, {3, 4096}}));
+}
+
+TEST_F(WriteSchedulingTest, HigherPriorityWritesFirst) {
+  ExecCtx exec_ctx;
+  CreateTransport(1024);
+  AddWritableStream(GRPC_CHTTP2_WRITE_PRIORITY_LOW, 2048);
+  AddWritableStream(GRPC_CHTTP2_WRITE_PRIORITY_NORMAL, 2048);
+  AddWritableStream(GRPC_CHTTP2_WRITE_PRIORITY_HIGH, 2048);
+  // The high priority stream drains before the normal one gets a turn,
+  // even though it has to come back for a second quantum, and the low
+  // priority stream goes last.
+  EXPECT_EQ(Write(), std::vector<DataFrame>({{5, 1024},
+                                             {5, 1024},
+                                             {3, 1024},
+                                             {3, 1024},
+                                             {1, 1024},
+                                             {1, 1024}}));
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace grpc_core
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  grpc::testing::TestEnvironment env(&argc, argv);
+  grpc_init();
+  int ret = RUN_ALL_TESTS();
+  grpc_shutdown();
+  return ret;
+}
@@ -504,6 +504,102 @@ static void privacy_integrity_unsync_seal_unseal(
   alts_iovec_record_protocol_test_var_destroy(var);
 }
 
+static void privacy_integrity_batch_seal_unseal(
+    alts_iovec_record_protocol* sender, alts_iovec_record_protocol* receiver) {
+  for (size_t i = 0; i < kSealRepeatTimes; i++) {
+    alts_iovec_record_protocol_test_var* var =
+        alts_iovec_record_protocol_test_var_create();
+    size_t max_frame_size =
+        gsec_test_bias_random_uint32(static_cast<uint32_t>(var->data_length)) +
+        1;
+    size_t num_frames =
+        (var->data_length + max_frame_size - 1) / max_frame_size;
+    size_t frames_length = alts_iovec_record_protocol_protected_frames_length(
+        sender, var->data_length, max_frame_size);
+    GPR_ASSERT(frames_length ==
+               var->data_length +
+                   num_frames * (var->header_length + var->tag_length));
+    auto* frames_buf = static_cast<uint8_t*>(gpr_malloc(frames_length));
+    iovec_t frames_iovec = {frames_buf, frames_length};
+    /* Seals all frames in one call.  */
+    grpc_status_code status =
+        alts_iovec_record_protocol_privacy_integrity_protect_frames(
+            sender, var->data_iovec, var->data_iovec_length, max_frame_size,
+            frames_iovec, nullptr);
+    GPR_ASSERT(status == GRPC_STATUS_OK);
+    /* Unseals all frames in place.  */
+    auto* unprotected =
+        static_cast<iovec_t*>(gpr_malloc(num_frames * sizeof(iovec_t)));
+    size_t frames_unprotected = 0;
+    status = alts_iovec_record_protocol_privacy_integrity_unprotect_frames(
+        receiver, frames_iovec, unprotected, num_frames, &frames_unprotected,
+        nullptr);
+    GPR_ASSERT(status == GRPC_STATUS_OK);
+    GPR_ASSERT(frames_unprotected == num_frames);
+    /* Makes sure unprotected data are the same as the original.  */
+    size_t offset = 0;
+    for (size_t j = 0; j < num_frames; j++) {
+      GPR_ASSERT(unprotected[j].iov_len <= max_frame_size);
+      GPR_ASSERT(memcmp(unprotected[j].iov_base, var->dup_buf + offset,
+                        unprotected[j].iov_len) == 0);
+      offset += unprotected[j].iov_len;
+    }
+    GPR_ASSERT(offset == var->data_length);
+    gpr_free(unprotected);
+    gpr_free(frames_buf);
+    alts_iovec_record_protocol_test_var_destroy(var);
+  }
+}
+
+static void privacy_integrity_batch_corrupted_data(
+    alts_iovec_record_protocol* sender, alts_iovec_record_protocol* receiver) {
+  /* Seals two frames.  */
+  uint8_t data[kMaxDataSize];
+  gsec_test_random_bytes(data, kMaxDataSize);
+  iovec_t data_iovec = {data, kMaxDataSize};
+  size_t max_frame_size = kMaxDataSize / 2 + 1;
+  size_t frames_length = alts_iovec_record_protocol_protected_frames_length(
+      sender, kMaxDataSize, max_frame_size);
+  auto* frames_buf = static_cast<uint8_t*>(gpr_malloc(frames_length));
+  iovec_t frames_iovec = {frames_buf, frames_length};
+  grpc_status_code status =
+      alts_iovec_record_protocol_privacy_integrity_protect_frames(
+          sender, &data_iovec, 1, max_frame_size, frames_iovec, nullptr);
+  GPR_ASSERT(status == GRPC_STATUS_OK);
+  iovec_t unprotected[2];
+  size_t frames_unprotected = 0;
+  /* A partial frame is rejected before anything is decrypted.  */
+  char* error_message = nullptr;
+  iovec_t partial_iovec = {frames_buf, frames_length - 1};
+  status = alts_iovec_record_protocol_privacy_integrity_unprotect_frames(
+      receiver, partial_iovec, unprotected, 2, &frames_unprotected,
+      &error_message);
+  GPR_ASSERT(gsec_test_expect_compare_code_and_substr(
+      status, GRPC_STATUS_INVALID_ARGUMENT, error_message,
+      "Protected frames end in a partial frame."));
+  gpr_free(error_message);
+  /* So is a batch with more frames than the output array can hold.  */
+  status = alts_iovec_record_protocol_privacy_integrity_unprotect_frames(
+      receiver, frames_iovec, unprotected, 1, &frames_unprotected,
+      &error_message);
+  GPR_ASSERT(gsec_test_expect_compare_code_and_substr(
+      status, GRPC_STATUS_INVALID_ARGUMENT, error_message,
+      "Unprotected data array is too small."));
+  gpr_free(error_message);
+  /* Corrupted ciphertext fails decryption.  */
+  alter_random_byte(
+      frames_buf + alts_iovec_record_protocol_get_header_length(),
+      max_frame_size);
+  status = alts_iovec_record_protocol_privacy_integrity_unprotect_frames(
+      receiver, frames_iovec, unprotected, 2, &frames_unprotected,
+      &error_message);
+  GPR_ASSERT(gsec_test_expect_compare_code_and_substr(
+      status, GRPC_STATUS_INTERNAL, error_message, "Frame decryption failed."));
+  GPR_ASSERT(frames_unprotected == 0);
+  gpr_free(error_message);
+  gpr_free(frames_buf);
+}
+
 static void privacy_integrity_corrupted_data(
     alts_iovec_record_protocol* sender, alts_iovec_record_protocol* receiver) {
   /* Seals the data first.  */
@@ -766,6 +862,27 @@ static void alts_iovec_record_protocol_random_seal_unseal_tests() {
   alts_iovec_record_protocol_test_fixture_destroy(fixture);
 }
 
+static void alts_iovec_record_protocol_batch_seal_unseal_test(bool rekey) {
+  alts_iovec_record_protocol_test_fixture* fixture =
+      alts_iovec_record_protocol_test_fixture_create(rekey,
+                                                     /*integrity_only=*/false);
+  privacy_integrity_batch_seal_unseal(fixture->client_protect,
+                                      fixture->server_unprotect);
+  privacy_integrity_batch_seal_unseal(fixture->server_protect,
+                                      fixture->client_unprotect);
+  /* Batched and single frame operations share the frame counter.  */
+  privacy_integrity_random_seal_unseal(fixture->client_protect,
+                                       fixture->server_unprotect);
+  privacy_integrity_batch_corrupted_data(fixture->client_protect,
+                                         fixture->server_unprotect);
+  alts_iovec_record_protocol_test_fixture_destroy(fixture);
+}
+
+static void alts_iovec_record_protocol_batch_seal_unseal_tests() {
+  alts_iovec_record_protocol_batch_seal_unseal_test(/*rekey=*/false);
+  alts_iovec_record_protocol_batch_seal_unseal_test(/*rekey=*/true);
+}
+
 static void alts_iovec_record_protocol_empty_seal_unseal_tests() {
   alts_iovec_record_protocol_test_fixture* fixture =
       alts_iovec_record_protocol_test_fixture_create(
@@ -920,6 +1037,7 @@ static void alts_iovec_record_protocol_mix_operations_tests() {
 
 int main(int /*argc*/, char** /*argv*/) {
   alts_iovec_record_protocol_random_seal_unseal_tests();
+  alts_iovec_record_protocol_batch_seal_unseal_tests();
   alts_iovec_record_protocol_empty_seal_unseal_tests();
   alts_iovec_record_protocol_unsync_seal_unseal_tests();
   alts_iovec_record_protocol_corrupted_data_tests();
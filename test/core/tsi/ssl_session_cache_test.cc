@@ -18,6 +18,8 @@
 
 #include "src/core/tsi/ssl/session_cache/ssl_session_cache.h"
 
+#include <time.h>
+
 #include <string>
 #include <unordered_set>
 
@@ -26,6 +28,8 @@
 #include <grpc/grpc.h>
 #include <grpc/support/log.h>
 
+#include "src/core/lib/debug/stats.h"
+#include "src/core/lib/iomgr/exec_ctx.h"
 #include "test/core/util/test_config.h"
 
 namespace grpc_core {
@@ -142,6 +146,64 @@ TEST(SslSessionCacheTest, LruCache) {
   EXPECT_EQ(tracker.AliveCount(), 0);
 }
 
+TEST(SslSessionCacheTest, ShardedCacheKeepsCapacity) {
+  SessionTracker tracker;
+  {
+    RefCountedPtr<tsi::SslSessionLRUCache> cache =
+        tsi::SslSessionLRUCache::Create(1024);
+    for (long id = 0; id < 4096; id++) {
+      std::string domain = std::to_string(id) + ".random.domain";
+      cache->Put(domain.c_str(), tracker.NewSession(id));
+    }
+    EXPECT_EQ(cache->Size(), 1024);
+    EXPECT_EQ(tracker.AliveCount(), 1024);
+    // The most recent session is never the one evicted.
+    EXPECT_TRUE(cache->Get("4095.random.domain"));
+  }
+  EXPECT_EQ(tracker.AliveCount(), 0);
+}
+
+TEST(SslSessionCacheTest, ExpiredSessionIsDropped) {
+  SessionTracker tracker;
+  RefCountedPtr<tsi::SslSessionLRUCache> cache =
+      tsi::SslSessionLRUCache::Create(3);
+  cache->Put("live.dropbox.com", tracker.NewSession(1));
+  tsi::SslSessionPtr expired = tracker.NewSession(2);
+  SSL_SESSION_set_time(expired.get(), time(nullptr) - 100);
+  SSL_SESSION_set_timeout(expired.get(), 10);
+  cache->Put("expired.dropbox.com", std::move(expired));
+  EXPECT_FALSE(cache->Get("expired.dropbox.com"));
+  EXPECT_FALSE(tracker.IsAlive(2));
+  EXPECT_TRUE(cache->Get("live.dropbox.com"));
+  EXPECT_EQ(cache->Size(), 1);
+}
+
+#if defined(GRPC_COLLECT_STATS) || !defined(NDEBUG)
+TEST(SslSessionCacheTest, Stats) {
+  ExecCtx exec_ctx;
+  SessionTracker tracker;
+  grpc_stats_data before;
+  grpc_stats_collect(&before);
+  RefCountedPtr<tsi::SslSessionLRUCache> cache =
+      tsi::SslSessionLRUCache::Create(1);
+  cache->Put("first.dropbox.com", tracker.NewSession(1));
+  EXPECT_TRUE(cache->Get("first.dropbox.com"));
+  cache->Put("second.dropbox.com", tracker.NewSession(2));
+  EXPECT_FALSE(cache->Get("first.dropbox.com"));
+  grpc_stats_data after;
+  grpc_stats_collect(&after);
+  EXPECT_EQ(after.counters[GRPC_STATS_COUNTER_SSL_SESSION_CACHE_HITS] -
+                before.counters[GRPC_STATS_COUNTER_SSL_SESSION_CACHE_HITS],
+            1);
+  EXPECT_EQ(after.counters[GRPC_STATS_COUNTER_SSL_SESSION_CACHE_MISSES] -
+                before.counters[GRPC_STATS_COUNTER_SSL_SESSION_CACHE_MISSES],
+            1);
+  EXPECT_EQ(after.counters[GRPC_STATS_COUNTER_SSL_SESSION_CACHE_EVICTIONS] -
+                before.counters[GRPC_STATS_COUNTER_SSL_SESSION_CACHE_EVICTIONS],
+            1);
+}
+#endif
+
 }  // namespace
 }  // namespace grpc_core
 
@@ -22,6 +22,14 @@
 #include <stdio.h>
 #include <string.h>
 
+#include <algorithm>
+
+#ifdef GPR_LINUX
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
 #include <openssl/crypto.h>
 #include <openssl/err.h>
 #include <openssl/pem.h>
@@ -35,8 +43,10 @@
 #include "src/core/lib/iomgr/load_file.h"
 #include "src/core/lib/security/security_connector/security_connector.h"
 #include "src/core/tsi/transport_security.h"
+#include "src/core/tsi/transport_security_grpc.h"
 #include "src/core/tsi/transport_security_interface.h"
 #include "test/core/tsi/transport_security_test_lib.h"
+#include "test/core/util/slice_splitter.h"
 #include "test/core/util/test_config.h"
 
 #define SSL_TSI_TEST_ALPN1 "foo"
@@ -99,6 +109,7 @@ typedef struct ssl_tsi_test_fixture {
   bool session_reused;
   const char* session_ticket_key;
   size_t session_ticket_key_size;
+  const char* rotated_session_ticket_key;
   size_t network_bio_buf_size;
   size_t ssl_bio_buf_size;
   tsi_ssl_server_handshaker_factory* server_handshaker_factory;
@@ -172,6 +183,12 @@ static void ssl_test_setup_handshakers(tsi_test_fixture* fixture) {
   GPR_ASSERT(tsi_create_ssl_server_handshaker_factory_with_options(
                  &server_options, &ssl_fixture->server_handshaker_factory) ==
              TSI_OK);
+  if (ssl_fixture->rotated_session_ticket_key != nullptr) {
+    GPR_ASSERT(tsi_ssl_server_handshaker_factory_rotate_session_ticket_key(
+                   ssl_fixture->server_handshaker_factory,
+                   ssl_fixture->rotated_session_ticket_key,
+                   ssl_fixture->session_ticket_key_size) == TSI_OK);
+  }
   /* Create server and client handshakers. */
   GPR_ASSERT(tsi_ssl_client_handshaker_factory_create_handshaker(
                  ssl_fixture->client_handshaker_factory,
@@ -505,6 +522,7 @@ static tsi_test_fixture* ssl_tsi_test_fixture_create() {
   ssl_fixture->session_reused = false;
   ssl_fixture->session_ticket_key = nullptr;
   ssl_fixture->session_ticket_key_size = 0;
+  ssl_fixture->rotated_session_ticket_key = nullptr;
   ssl_fixture->force_client_auth = false;
   ssl_fixture->network_bio_buf_size = 0;
   ssl_fixture->ssl_bio_buf_size = 0;
@@ -746,6 +764,321 @@ void ssl_tsi_test_do_round_trip_odd_buffer_size() {
   }
 }
 
+// Returns a slice of \a size bytes counting up from \a *next.
+static grpc_slice make_counting_slice(size_t size, uint8_t* next) {
+  grpc_slice slice = grpc_slice_malloc(size);
+  for (size_t i = 0; i < size; i++) GRPC_SLICE_START_PTR(slice)[i] = (*next)++;
+  return slice;
+}
+
+// Protects a mix of small and large slices on one side and unprotects them
+// on the other, delivering the protected bytes in odd sized pieces.
+static void zero_copy_round_trip(tsi_zero_copy_grpc_protector* sender,
+                                 tsi_zero_copy_grpc_protector* receiver) {
+  const size_t slice_sizes[] = {1, 100, 40000, 7, 16384, 20000, 3};
+  grpc_slice_buffer plaintext;
+  grpc_slice_buffer to_protect;
+  grpc_slice_buffer protected_slices;
+  grpc_slice_buffer protected_piece;
+  grpc_slice_buffer received;
+  grpc_slice_buffer_init(&plaintext);
+  grpc_slice_buffer_init(&to_protect);
+  grpc_slice_buffer_init(&protected_slices);
+  grpc_slice_buffer_init(&protected_piece);
+  grpc_slice_buffer_init(&received);
+  uint8_t next = 0;
+  for (size_t size : slice_sizes) {
+    grpc_slice slice = make_counting_slice(size, &next);
+    grpc_slice_buffer_add(&plaintext, grpc_slice_ref(slice));
+    grpc_slice_buffer_add(&to_protect, slice);
+  }
+  GPR_ASSERT(tsi_zero_copy_grpc_protector_protect(sender, &to_protect,
+                                                  &protected_slices) == TSI_OK);
+  GPR_ASSERT(to_protect.length == 0);
+  size_t max_frame_size;
+  GPR_ASSERT(tsi_zero_copy_grpc_protector_max_frame_size(
+                 sender, &max_frame_size) == TSI_OK);
+  for (size_t i = 0; i < protected_slices.count; i++) {
+    GPR_ASSERT(GRPC_SLICE_LENGTH(protected_slices.slices[i]) <= max_frame_size);
+  }
+  while (protected_slices.length > 0) {
+    grpc_slice_buffer_move_first(
+        &protected_slices, std::min<size_t>(protected_slices.length, 4103),
+        &protected_piece);
+    GPR_ASSERT(tsi_zero_copy_grpc_protector_unprotect(
+                   receiver, &protected_piece, &received) == TSI_OK);
+    GPR_ASSERT(protected_piece.length == 0);
+  }
+  GPR_ASSERT(received.length == plaintext.length);
+  grpc_slice expected = grpc_slice_merge(plaintext.slices, plaintext.count);
+  grpc_slice actual = grpc_slice_merge(received.slices, received.count);
+  GPR_ASSERT(grpc_slice_eq(expected, actual));
+  grpc_slice_unref(expected);
+  grpc_slice_unref(actual);
+  grpc_slice_buffer_destroy(&plaintext);
+  grpc_slice_buffer_destroy(&to_protect);
+  grpc_slice_buffer_destroy(&protected_slices);
+  grpc_slice_buffer_destroy(&protected_piece);
+  grpc_slice_buffer_destroy(&received);
+}
+
+void ssl_tsi_test_do_zero_copy_protector_is_opt_in() {
+  gpr_log(GPR_INFO, "ssl_tsi_test_do_zero_copy_protector_is_opt_in");
+  tsi_test_fixture* fixture = ssl_tsi_test_fixture_create();
+  fixture->test_unused_bytes = false;
+  tsi_test_do_handshake(fixture);
+  tsi_frame_protector_type type;
+  GPR_ASSERT(tsi_handshaker_result_get_frame_protector_type(
+                 fixture->client_result, &type) == TSI_OK);
+  GPR_ASSERT(type == TSI_FRAME_PROTECTOR_NORMAL);
+  GPR_GLOBAL_CONFIG_SET(grpc_experimental_ssl_zero_copy_protector, true);
+  GPR_ASSERT(tsi_handshaker_result_get_frame_protector_type(
+                 fixture->client_result, &type) == TSI_OK);
+  GPR_ASSERT(type == TSI_FRAME_PROTECTOR_NORMAL_OR_ZERO_COPY);
+  GPR_GLOBAL_CONFIG_SET(grpc_experimental_ssl_zero_copy_protector, false);
+  tsi_test_fixture_destroy(fixture);
+}
+
+// Completes a handshake and creates zero-copy protectors for both ends.
+static tsi_test_fixture* zero_copy_protectors_create(
+    tsi_zero_copy_grpc_protector** client_protector,
+    tsi_zero_copy_grpc_protector** server_protector) {
+  tsi_test_fixture* fixture = ssl_tsi_test_fixture_create();
+  fixture->test_unused_bytes = false;
+  tsi_test_do_handshake(fixture);
+  GPR_ASSERT(tsi_handshaker_result_create_zero_copy_grpc_protector(
+                 fixture->client_result, nullptr, client_protector) == TSI_OK);
+  GPR_ASSERT(tsi_handshaker_result_create_zero_copy_grpc_protector(
+                 fixture->server_result, nullptr, server_protector) == TSI_OK);
+  return fixture;
+}
+
+void ssl_tsi_test_do_zero_copy_round_trip() {
+  gpr_log(GPR_INFO, "ssl_tsi_test_do_zero_copy_round_trip");
+  tsi_zero_copy_grpc_protector* client_protector = nullptr;
+  tsi_zero_copy_grpc_protector* server_protector = nullptr;
+  tsi_test_fixture* fixture =
+      zero_copy_protectors_create(&client_protector, &server_protector);
+  zero_copy_round_trip(client_protector, server_protector);
+  zero_copy_round_trip(server_protector, client_protector);
+  tsi_zero_copy_grpc_protector_destroy(client_protector);
+  tsi_zero_copy_grpc_protector_destroy(server_protector);
+  tsi_test_fixture_destroy(fixture);
+}
+
+// Delivers several protected records one byte per slice, so that every record
+// header and body is split across slices.
+void ssl_tsi_test_do_zero_copy_unprotect_records_split_across_slices() {
+  gpr_log(GPR_INFO,
+          "ssl_tsi_test_do_zero_copy_unprotect_records_split_across_slices");
+  tsi_zero_copy_grpc_protector* client_protector = nullptr;
+  tsi_zero_copy_grpc_protector* server_protector = nullptr;
+  tsi_test_fixture* fixture =
+      zero_copy_protectors_create(&client_protector, &server_protector);
+  uint8_t next = 0;
+  grpc_slice plaintext = make_counting_slice(40000, &next);
+  grpc_slice_buffer to_protect;
+  grpc_slice_buffer protected_slices;
+  grpc_slice_buffer split;
+  grpc_slice_buffer received;
+  grpc_slice_buffer_init(&to_protect);
+  grpc_slice_buffer_init(&protected_slices);
+  grpc_slice_buffer_init(&split);
+  grpc_slice_buffer_init(&received);
+  grpc_slice_buffer_add(&to_protect, grpc_slice_ref(plaintext));
+  GPR_ASSERT(tsi_zero_copy_grpc_protector_protect(
+                 client_protector, &to_protect, &protected_slices) == TSI_OK);
+  GPR_ASSERT(protected_slices.count > 1);
+  grpc_split_slice_buffer(GRPC_SLICE_SPLIT_ONE_BYTE, &protected_slices, &split);
+  GPR_ASSERT(tsi_zero_copy_grpc_protector_unprotect(
+                 server_protector, &split, &received) == TSI_OK);
+  GPR_ASSERT(split.length == 0);
+  grpc_slice actual = grpc_slice_merge(received.slices, received.count);
+  GPR_ASSERT(grpc_slice_eq(plaintext, actual));
+  grpc_slice_unref(actual);
+  grpc_slice_unref(plaintext);
+  grpc_slice_buffer_destroy(&to_protect);
+  grpc_slice_buffer_destroy(&protected_slices);
+  grpc_slice_buffer_destroy(&split);
+  grpc_slice_buffer_destroy(&received);
+  tsi_zero_copy_grpc_protector_destroy(client_protector);
+  tsi_zero_copy_grpc_protector_destroy(server_protector);
+  tsi_test_fixture_destroy(fixture);
+}
+
+// Delivers a record in pieces, and checks that nothing is unprotected until
+// its last byte arrives.
+void ssl_tsi_test_do_zero_copy_unprotect_partial_records() {
+  gpr_log(GPR_INFO, "ssl_tsi_test_do_zero_copy_unprotect_partial_records");
+  tsi_zero_copy_grpc_protector* client_protector = nullptr;
+  tsi_zero_copy_grpc_protector* server_protector = nullptr;
+  tsi_test_fixture* fixture =
+      zero_copy_protectors_create(&client_protector, &server_protector);
+  uint8_t next = 0;
+  grpc_slice plaintext = make_counting_slice(1000, &next);
+  grpc_slice_buffer to_protect;
+  grpc_slice_buffer protected_slices;
+  grpc_slice_buffer piece;
+  grpc_slice_buffer received;
+  grpc_slice_buffer_init(&to_protect);
+  grpc_slice_buffer_init(&protected_slices);
+  grpc_slice_buffer_init(&piece);
+  grpc_slice_buffer_init(&received);
+  grpc_slice_buffer_add(&to_protect, grpc_slice_ref(plaintext));
+  GPR_ASSERT(tsi_zero_copy_grpc_protector_protect(
+                 client_protector, &to_protect, &protected_slices) == TSI_OK);
+  const size_t record_length = protected_slices.length;
+  // Part of the record header, then the rest of the header and part of the
+  // body, then all but the last byte.
+  const size_t cut_points[] = {3, 10, record_length - 1};
+  size_t delivered = 0;
+  for (size_t cut : cut_points) {
+    grpc_slice_buffer_move_first(&protected_slices, cut - delivered, &piece);
+    delivered = cut;
+    GPR_ASSERT(tsi_zero_copy_grpc_protector_unprotect(
+                   server_protector, &piece, &received) == TSI_OK);
+    GPR_ASSERT(piece.length == 0);
+    GPR_ASSERT(received.length == 0);
+  }
+  GPR_ASSERT(protected_slices.length == 1);
+  GPR_ASSERT(tsi_zero_copy_grpc_protector_unprotect(
+                 server_protector, &protected_slices, &received) == TSI_OK);
+  grpc_slice actual = grpc_slice_merge(received.slices, received.count);
+  GPR_ASSERT(grpc_slice_eq(plaintext, actual));
+  grpc_slice_unref(actual);
+  grpc_slice_unref(plaintext);
+  grpc_slice_buffer_destroy(&to_protect);
+  grpc_slice_buffer_destroy(&protected_slices);
+  grpc_slice_buffer_destroy(&piece);
+  grpc_slice_buffer_destroy(&received);
+  tsi_zero_copy_grpc_protector_destroy(client_protector);
+  tsi_zero_copy_grpc_protector_destroy(server_protector);
+  tsi_test_fixture_destroy(fixture);
+}
+
+#ifdef GPR_LINUX
+
+// Connects two TCP sockets over the loopback interface.
+static void create_loopback_tcp_pair(int* client_fd, int* server_fd) {
+  int listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+  GPR_ASSERT(listen_fd >= 0);
+  struct sockaddr_in addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  socklen_t addr_len = sizeof(addr);
+  GPR_ASSERT(bind(listen_fd, reinterpret_cast<struct sockaddr*>(&addr),
+                  addr_len) == 0);
+  GPR_ASSERT(listen(listen_fd, 1) == 0);
+  GPR_ASSERT(getsockname(listen_fd, reinterpret_cast<struct sockaddr*>(&addr),
+                         &addr_len) == 0);
+  *client_fd = socket(AF_INET, SOCK_STREAM, 0);
+  GPR_ASSERT(*client_fd >= 0);
+  GPR_ASSERT(connect(*client_fd, reinterpret_cast<struct sockaddr*>(&addr),
+                     addr_len) == 0);
+  *server_fd = accept(listen_fd, nullptr, nullptr);
+  GPR_ASSERT(*server_fd >= 0);
+  close(listen_fd);
+}
+
+// Sends a message of several TLS records from sender_fd to receiver_fd. A
+// side without a protector has been offloaded to the kernel, and writes or
+// reads plaintext.
+static void kernel_offload_send(int sender_fd,
+                                tsi_zero_copy_grpc_protector* sender,
+                                int receiver_fd,
+                                tsi_zero_copy_grpc_protector* receiver) {
+  const size_t kMessageSize = 40000;
+  grpc_slice message = grpc_slice_malloc(kMessageSize);
+  for (size_t i = 0; i < kMessageSize; i++) {
+    GRPC_SLICE_START_PTR(message)[i] = static_cast<uint8_t>(i);
+  }
+  grpc_slice_buffer to_send;
+  grpc_slice_buffer received;
+  grpc_slice_buffer plaintext;
+  grpc_slice_buffer_init(&to_send);
+  grpc_slice_buffer_init(&received);
+  grpc_slice_buffer_init(&plaintext);
+  if (sender != nullptr) {
+    grpc_slice_buffer_add(&plaintext, grpc_slice_ref(message));
+    GPR_ASSERT(tsi_zero_copy_grpc_protector_protect(sender, &plaintext,
+                                                    &to_send) == TSI_OK);
+  } else {
+    grpc_slice_buffer_add(&to_send, grpc_slice_ref(message));
+  }
+  for (size_t i = 0; i < to_send.count; i++) {
+    const uint8_t* p = GRPC_SLICE_START_PTR(to_send.slices[i]);
+    size_t remaining = GRPC_SLICE_LENGTH(to_send.slices[i]);
+    while (remaining > 0) {
+      ssize_t written = write(sender_fd, p, remaining);
+      GPR_ASSERT(written > 0);
+      p += written;
+      remaining -= written;
+    }
+  }
+  while (plaintext.length < kMessageSize) {
+    uint8_t buf[4096];
+    ssize_t read_bytes = read(receiver_fd, buf, sizeof(buf));
+    GPR_ASSERT(read_bytes > 0);
+    grpc_slice_buffer_add(&received,
+                          grpc_slice_from_copied_buffer(
+                              reinterpret_cast<const char*>(buf), read_bytes));
+    if (receiver != nullptr) {
+      GPR_ASSERT(tsi_zero_copy_grpc_protector_unprotect(
+                     receiver, &received, &plaintext) == TSI_OK);
+    } else {
+      grpc_slice_buffer_move_into(&received, &plaintext);
+    }
+  }
+  grpc_slice actual = grpc_slice_merge(plaintext.slices, plaintext.count);
+  GPR_ASSERT(grpc_slice_eq(message, actual));
+  grpc_slice_unref(actual);
+  grpc_slice_unref(message);
+  grpc_slice_buffer_destroy(&to_send);
+  grpc_slice_buffer_destroy(&received);
+  grpc_slice_buffer_destroy(&plaintext);
+}
+
+// Hands the connection to the kernel after an in-memory handshake and
+// exchanges records over a loopback TCP connection. TLS 1.3 clients keep
+// user space protection, because the server may send them post-handshake
+// messages.
+void ssl_tsi_test_do_kernel_offload_round_trip() {
+  gpr_log(GPR_INFO, "ssl_tsi_test_do_kernel_offload_round_trip");
+  tsi_test_fixture* fixture = ssl_tsi_test_fixture_create();
+  fixture->test_unused_bytes = false;
+  tsi_test_do_handshake(fixture);
+  int client_fd;
+  int server_fd;
+  create_loopback_tcp_pair(&client_fd, &server_fd);
+  tsi_result result = tsi_handshaker_result_offload_to_kernel(
+      fixture->server_result, server_fd);
+  if (result == TSI_UNIMPLEMENTED || result == TSI_FAILED_PRECONDITION) {
+    gpr_log(GPR_INFO, "Kernel TLS is not available, skipping.");
+  } else {
+    GPR_ASSERT(result == TSI_OK);
+    tsi_zero_copy_grpc_protector* client_protector = nullptr;
+    result = tsi_handshaker_result_offload_to_kernel(fixture->client_result,
+                                                     client_fd);
+    if (test_tls_version == tsi_tls_version::TSI_TLS1_3) {
+      GPR_ASSERT(result == TSI_FAILED_PRECONDITION);
+      GPR_ASSERT(tsi_handshaker_result_create_zero_copy_grpc_protector(
+                     fixture->client_result, nullptr, &client_protector) ==
+                 TSI_OK);
+    } else {
+      GPR_ASSERT(result == TSI_OK);
+    }
+    kernel_offload_send(client_fd, client_protector, server_fd, nullptr);
+    kernel_offload_send(server_fd, nullptr, client_fd, client_protector);
+    tsi_zero_copy_grpc_protector_destroy(client_protector);
+  }
+  close(client_fd);
+  close(server_fd);
+  tsi_test_fixture_destroy(fixture);
+}
+
+#endif /* GPR_LINUX */
+
 void ssl_tsi_test_do_handshake_session_cache() {
   gpr_log(GPR_INFO, "ssl_tsi_test_do_handshake_session_cache");
   tsi_ssl_session_cache* session_cache = tsi_ssl_session_cache_create_lru(16);
@@ -779,6 +1112,40 @@ void ssl_tsi_test_do_handshake_session_cache() {
   tsi_ssl_session_cache_unref(session_cache);
 }
 
+void ssl_tsi_test_do_handshake_session_ticket_key_rotation() {
+  gpr_log(GPR_INFO, "ssl_tsi_test_do_handshake_session_ticket_key_rotation");
+  tsi_ssl_session_cache* session_cache = tsi_ssl_session_cache_create_lru(16);
+  char old_key[kSessionTicketEncryptionKeySize];
+  char new_key[kSessionTicketEncryptionKeySize];
+  auto do_handshake = [&session_cache](const char* key,
+                                       const char* rotated_key,
+                                       bool session_reused) {
+    tsi_test_fixture* fixture = ssl_tsi_test_fixture_create();
+    ssl_tsi_test_fixture* ssl_fixture =
+        reinterpret_cast<ssl_tsi_test_fixture*>(fixture);
+    ssl_fixture->server_name_indication =
+        const_cast<char*>("waterzooi.test.google.be");
+    ssl_fixture->session_ticket_key = key;
+    ssl_fixture->session_ticket_key_size = kSessionTicketEncryptionKeySize;
+    ssl_fixture->rotated_session_ticket_key = rotated_key;
+    tsi_ssl_session_cache_ref(session_cache);
+    ssl_fixture->session_cache = session_cache;
+    ssl_fixture->session_reused = session_reused;
+    tsi_test_do_round_trip(&ssl_fixture->base);
+    tsi_test_fixture_destroy(fixture);
+  };
+  memset(old_key, 'a', sizeof(old_key));
+  memset(new_key, 'b', sizeof(new_key));
+  do_handshake(old_key, nullptr, false);
+  // A ticket issued under the replaced key is still accepted.
+  do_handshake(old_key, new_key, true);
+  // Tickets under keys the server no longer has are not.
+  memset(old_key, 'c', sizeof(old_key));
+  memset(new_key, 'd', sizeof(new_key));
+  do_handshake(old_key, new_key, false);
+  tsi_ssl_session_cache_unref(session_cache);
+}
+
 static const tsi_ssl_handshaker_factory_vtable* original_vtable;
 static bool handshaker_factory_destructor_called;
 
@@ -1082,9 +1449,17 @@ int main(int argc, char** argv) {
     ssl_tsi_test_do_handshake_alpn_server_no_client();
     ssl_tsi_test_do_handshake_alpn_client_server_ok();
     ssl_tsi_test_do_handshake_session_cache();
+    ssl_tsi_test_do_handshake_session_ticket_key_rotation();
     ssl_tsi_test_do_round_trip_for_all_configs();
     ssl_tsi_test_do_round_trip_with_error_on_stack();
     ssl_tsi_test_do_round_trip_odd_buffer_size();
+    ssl_tsi_test_do_zero_copy_protector_is_opt_in();
+    ssl_tsi_test_do_zero_copy_round_trip();
+    ssl_tsi_test_do_zero_copy_unprotect_records_split_across_slices();
+    ssl_tsi_test_do_zero_copy_unprotect_partial_records();
+#ifdef GPR_LINUX
+    ssl_tsi_test_do_kernel_offload_round_trip();
+#endif
     ssl_tsi_test_handshaker_factory_internals();
     ssl_tsi_test_duplicate_root_certificates();
     ssl_tsi_test_extract_x509_subject_names();
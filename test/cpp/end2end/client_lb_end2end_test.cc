@@ -86,12 +86,22 @@ class MyTestServiceImpl : public TestServiceImpl {
   Status Echo(ServerContext* context, const EchoRequest* request,
               EchoResponse* response) override {
     const xds::data::orca::v3::OrcaLoadReport* load_report = nullptr;
+    bool fail_rpcs;
     {
       grpc::internal::MutexLock lock(&mu_);
       ++request_count_;
       load_report = load_report_;
+      fail_rpcs = fail_rpcs_;
+      if (rpcs_to_hold_ > 0) {
+        --rpcs_to_hold_;
+        ++held_rpcs_;
+        while (held_rpcs_ > 0) held_cond_.Wait(&mu_);
+      }
     }
     AddClient(context->peer());
+    if (fail_rpcs) {
+      return Status(StatusCode::UNAVAILABLE, "backend configured to fail");
+    }
     if (load_report != nullptr) {
       // TODO(roth): Once we provide a more standard server-side API for
       // populating this data, use that API here.
@@ -121,6 +131,29 @@ class MyTestServiceImpl : public TestServiceImpl {
     load_report_ = load_report;
   }
 
+  void set_fail_rpcs(bool fail_rpcs) {
+    grpc::internal::MutexLock lock(&mu_);
+    fail_rpcs_ = fail_rpcs;
+  }
+
+  // The next count RPCs do not complete until ReleaseHeldRpcs() is called.
+  void HoldNextRpcs(int count) {
+    grpc::internal::MutexLock lock(&mu_);
+    rpcs_to_hold_ = count;
+  }
+
+  int held_rpcs() {
+    grpc::internal::MutexLock lock(&mu_);
+    return held_rpcs_;
+  }
+
+  void ReleaseHeldRpcs() {
+    grpc::internal::MutexLock lock(&mu_);
+    rpcs_to_hold_ = 0;
+    held_rpcs_ = 0;
+    held_cond_.SignalAll();
+  }
+
  private:
   void AddClient(const std::string& client) {
     grpc::internal::MutexLock lock(&clients_mu_);
@@ -130,6 +163,10 @@ class MyTestServiceImpl : public TestServiceImpl {
   grpc::internal::Mutex mu_;
   int request_count_ = 0;
   const xds::data::orca::v3::OrcaLoadReport* load_report_ = nullptr;
+  bool fail_rpcs_ = false;
+  int rpcs_to_hold_ = 0;
+  int held_rpcs_ = 0;
+  grpc::internal::CondVar held_cond_;
   grpc::internal::Mutex clients_mu_;
   std::set<std::string> clients_;
 };
@@ -1851,6 +1888,215 @@ TEST_F(RoundRobinTest,
   EnableDefaultHealthCheckService(false);
 }
 
+//
+// least_request tests
+//
+
+using LeastRequestTest = ClientLbEnd2endTest;
+
+TEST_F(LeastRequestTest, Basic) {
+  const int kNumServers = 3;
+  StartServers(kNumServers);
+  auto response_generator = BuildResolverResponseGenerator();
+  auto channel = BuildChannel("least_request_experimental", response_generator);
+  auto stub = BuildStub(channel);
+  response_generator.SetNextResolution(GetServersPorts());
+  // With no load on any backend, random choices should reach all of them.
+  WaitForServers(stub, 0, kNumServers, DEBUG_LOCATION);
+  EXPECT_EQ("least_request_experimental",
+            channel->GetLoadBalancingPolicyName());
+}
+
+TEST_F(LeastRequestTest, Updates) {
+  const int kNumServers = 3;
+  StartServers(kNumServers);
+  auto response_generator = BuildResolverResponseGenerator();
+  auto channel = BuildChannel("least_request_experimental", response_generator);
+  auto stub = BuildStub(channel);
+  // Start with only server 0.
+  response_generator.SetNextResolution({servers_[0]->port_});
+  WaitForServer(stub, 0, DEBUG_LOCATION);
+  for (int i = 0; i < 10; ++i) CheckRpcSendOk(stub, DEBUG_LOCATION);
+  EXPECT_EQ(10, servers_[0]->service_.request_count());
+  ResetCounters();
+  // Switch to servers 1 and 2.
+  response_generator.SetNextResolution(
+      {servers_[1]->port_, servers_[2]->port_});
+  WaitForServers(stub, 1, 3, DEBUG_LOCATION);
+  for (int i = 0; i < 10; ++i) CheckRpcSendOk(stub, DEBUG_LOCATION);
+  EXPECT_EQ(0, servers_[0]->service_.request_count());
+}
+
+TEST_F(LeastRequestTest, AvoidsLoadedBackend) {
+  const int kNumServers = 3;
+  const int kNumRpcs = 30;
+  StartServers(kNumServers);
+  auto response_generator = BuildResolverResponseGenerator();
+  auto channel = BuildChannel("", response_generator);
+  auto stub = BuildStub(channel);
+  // Compare the loads of every backend on each pick, with high probability.
+  response_generator.SetNextResolution(
+      GetServersPorts(),
+      "{\"loadBalancingConfig\": [{\"least_request_experimental\": "
+      "{\"choiceCount\": 10}}]}");
+  WaitForServers(stub, 0, kNumServers, DEBUG_LOCATION);
+  ResetCounters();
+  // Hold a call open on server 0. RPCs that land on the other backends
+  // finish at once, so keep sending until one reaches server 0.
+  servers_[0]->service_.HoldNextRpcs(1);
+  auto received = [&]() {
+    int count = 0;
+    for (const auto& server : servers_) {
+      count += server->service_.request_count();
+    }
+    return count;
+  };
+  std::thread held_rpc;
+  for (int sent = 1; !held_rpc.joinable(); ++sent) {
+    // The held call must outlive the RPCs below, so give it a long deadline.
+    std::thread rpc([&]() {
+      Status status;
+      EXPECT_TRUE(SendRpc(stub, nullptr, 30000, &status))
+          << status.error_message();
+    });
+    while (received() < sent) {
+      gpr_sleep_until(grpc_timeout_milliseconds_to_deadline(1));
+    }
+    if (servers_[0]->service_.held_rpcs() > 0) {
+      held_rpc = std::move(rpc);
+    } else {
+      rpc.join();
+    }
+  }
+  ResetCounters();
+  // New RPCs go to the idle backends. Server 0 is only picked if all ten
+  // random choices land on it, which is vanishingly unlikely to happen twice.
+  for (int i = 0; i < kNumRpcs; ++i) CheckRpcSendOk(stub, DEBUG_LOCATION);
+  EXPECT_LE(servers_[0]->service_.request_count(), 1);
+  EXPECT_GT(servers_[1]->service_.request_count(), 0);
+  EXPECT_GT(servers_[2]->service_.request_count(), 0);
+  servers_[0]->service_.ReleaseHeldRpcs();
+  held_rpc.join();
+}
+
+//
+// weighted_round_robin tests
+//
+
+using WeightedRoundRobinTest = ClientLbEnd2endTest;
+
+TEST_F(WeightedRoundRobinTest, Basic) {
+  const int kNumServers = 3;
+  StartServers(kNumServers);
+  auto response_generator = BuildResolverResponseGenerator();
+  auto channel =
+      BuildChannel("weighted_round_robin_experimental", response_generator);
+  auto stub = BuildStub(channel);
+  response_generator.SetNextResolution(GetServersPorts());
+  // Without any backend metrics, the policy behaves like round_robin.
+  WaitForServers(stub, 0, kNumServers, DEBUG_LOCATION);
+  ResetCounters();
+  for (int i = 0; i < kNumServers * 10; ++i) {
+    CheckRpcSendOk(stub, DEBUG_LOCATION);
+  }
+  for (const auto& server : servers_) {
+    EXPECT_EQ(10, server->service_.request_count());
+  }
+  EXPECT_EQ("weighted_round_robin_experimental",
+            channel->GetLoadBalancingPolicyName());
+}
+
+TEST_F(WeightedRoundRobinTest, PerCallLoadReports) {
+  const int kNumServers = 2;
+  StartServers(kNumServers);
+  // Both servers report the same QPS, but server 0 is using 9 times as
+  // much CPU, so server 1 should get about 9 times as many requests.
+  xds::data::orca::v3::OrcaLoadReport load_report0;
+  load_report0.set_rps(100);
+  load_report0.set_cpu_utilization(0.9);
+  servers_[0]->service_.set_load_report(&load_report0);
+  xds::data::orca::v3::OrcaLoadReport load_report1;
+  load_report1.set_rps(100);
+  load_report1.set_cpu_utilization(0.1);
+  servers_[1]->service_.set_load_report(&load_report1);
+  const char* kServiceConfigJson =
+      "{\"loadBalancingConfig\":[{\"weighted_round_robin_experimental\":{"
+      "  \"blackoutPeriod\":\"0s\","
+      "  \"weightUpdatePeriod\":\"0.1s\""
+      "}}]}";
+  auto response_generator = BuildResolverResponseGenerator();
+  auto channel = BuildChannel("", response_generator);
+  auto stub = BuildStub(channel);
+  response_generator.SetNextResolution(GetServersPorts(), kServiceConfigJson);
+  WaitForServers(stub, 0, kNumServers, DEBUG_LOCATION);
+  // Send RPCs until the weights from the load reports are picked up.
+  const int kNumRpcs = 100;
+  const auto deadline =
+      absl::Now() + absl::Seconds(5 * grpc_test_slowdown_factor());
+  while (true) {
+    ResetCounters();
+    for (int i = 0; i < kNumRpcs; ++i) CheckRpcSendOk(stub, DEBUG_LOCATION);
+    if (servers_[1]->service_.request_count() >=
+        4 * servers_[0]->service_.request_count()) {
+      break;
+    }
+    ASSERT_LT(absl::Now(), deadline)
+        << "server 0: " << servers_[0]->service_.request_count()
+        << " server 1: " << servers_[1]->service_.request_count();
+    gpr_sleep_until(grpc_timeout_milliseconds_to_deadline(100));
+  }
+  // Server 0 still gets some traffic.
+  EXPECT_GT(servers_[0]->service_.request_count(), 0);
+}
+
+//
+// outlier_detection tests
+//
+
+using OutlierDetectionTest = ClientLbEnd2endTest;
+
+TEST_F(OutlierDetectionTest, EjectsFailingBackend) {
+  const int kNumServers = 3;
+  StartServers(kNumServers);
+  servers_[0]->service_.set_fail_rpcs(true);
+  const char* kServiceConfigJson =
+      "{\"loadBalancingConfig\":[{\"outlier_detection_experimental\":{"
+      "  \"interval\":\"0.1s\","
+      "  \"baseEjectionTime\":\"30s\","
+      "  \"maxEjectionPercent\":50,"
+      "  \"failurePercentageEjection\":{"
+      "    \"threshold\":50,"
+      "    \"minimumHosts\":1,"
+      "    \"requestVolume\":1"
+      "  },"
+      "  \"childPolicy\":[{\"round_robin\":{}}]"
+      "}}]}";
+  auto response_generator = BuildResolverResponseGenerator();
+  auto channel = BuildChannel("", response_generator);
+  auto stub = BuildStub(channel);
+  response_generator.SetNextResolution(GetServersPorts(), kServiceConfigJson);
+  WaitForServers(stub, 0, kNumServers, DEBUG_LOCATION,
+                 /*ignore_failure=*/true);
+  // Once the failing backend is ejected, all RPCs should succeed.
+  const int kNumRpcs = 10;
+  int consecutive_successes = 0;
+  const auto deadline =
+      absl::Now() + (absl::Seconds(10) * grpc_test_slowdown_factor());
+  while (consecutive_successes < kNumRpcs) {
+    if (SendRpc(stub)) {
+      ++consecutive_successes;
+    } else {
+      consecutive_successes = 0;
+    }
+    ASSERT_LE(absl::Now(), deadline) << "failing backend not ejected";
+  }
+  ResetCounters();
+  for (int i = 0; i < kNumRpcs; ++i) CheckRpcSendOk(stub, DEBUG_LOCATION);
+  EXPECT_EQ(0, servers_[0]->service_.request_count());
+  EXPECT_EQ("outlier_detection_experimental",
+            channel->GetLoadBalancingPolicyName());
+}
+
 //
 // LB policy pick args
 //
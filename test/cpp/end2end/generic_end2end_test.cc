@@ -17,7 +17,9 @@
  */
 
 #include <memory>
+#include <string>
 #include <thread>
+#include <vector>
 
 #include <gtest/gtest.h>
 
@@ -390,6 +392,59 @@ TEST_F(GenericEnd2endTest, SimpleBidiStreaming) {
   EXPECT_TRUE(recv_status.ok());
 }
 
+// A large message arrives over HTTP/2 in many reads. The server receives it
+// in the slices the transport read it into, without the call surface
+// flattening it into one buffer.
+TEST_F(GenericEnd2endTest, LargeMessageIsReceivedInTransportSlices) {
+  ResetStub();
+
+  const std::string kMethodName(
+      "/grpc.cpp.test.util.EchoTestService/BidiStream");
+  ClientContext cli_ctx;
+  GenericServerContext srv_ctx;
+  GenericServerAsyncReaderWriter srv_stream(&srv_ctx);
+  Status recv_status;
+
+  std::thread request_call([this]() { server_ok(2); });
+  std::unique_ptr<GenericClientAsyncReaderWriter> cli_stream =
+      generic_stub_->PrepareCall(&cli_ctx, kMethodName, &cli_cq_);
+  cli_stream->StartCall(tag(1));
+  client_ok(1);
+  generic_service_.RequestCall(&srv_ctx, &srv_stream, srv_cq_.get(),
+                               srv_cq_.get(), tag(2));
+  request_call.join();
+
+  std::string payload(1024 * 1024, '\0');
+  for (size_t i = 0; i < payload.size(); i++) {
+    payload[i] = static_cast<char>(i % 251);
+  }
+  Slice send_slice(payload);
+  ByteBuffer send_buffer(&send_slice, 1);
+  cli_stream->Write(send_buffer, tag(3));
+  client_ok(3);
+
+  ByteBuffer recv_buffer;
+  srv_stream.Read(&recv_buffer, tag(4));
+  server_ok(4);
+  std::vector<Slice> recv_slices;
+  EXPECT_TRUE(recv_buffer.Dump(&recv_slices).ok());
+  EXPECT_GT(recv_slices.size(), 1u);
+  std::string received;
+  for (const Slice& slice : recv_slices) {
+    received.append(reinterpret_cast<const char*>(slice.begin()),
+                    slice.size());
+  }
+  EXPECT_EQ(received, payload);
+
+  cli_stream->WritesDone(tag(5));
+  client_ok(5);
+  srv_stream.Finish(Status::OK, tag(6));
+  server_ok(6);
+  cli_stream->Finish(&recv_status, tag(7));
+  client_ok(7);
+  EXPECT_TRUE(recv_status.ok());
+}
+
 TEST_F(GenericEnd2endTest, Deadline) {
   ResetStub();
   SendRpc(1, true,
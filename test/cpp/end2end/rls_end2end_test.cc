@@ -1227,6 +1227,62 @@ TEST_F(RlsEnd2endTest, CacheSizeLimit) {
   EXPECT_EQ(backends_[1]->service_.request_count(), 2);
 }
 
+TEST_F(RlsEnd2endTest, CacheEvictionSkipsRecentlyUsedEntries) {
+  StartBackends(1);
+  // Long key values make the key dominate the size of a cache entry, so
+  // that the cache holds three entries but not four.
+  const size_t kValueLength = 4000;
+  const std::vector<std::string> values = {
+      std::string(kValueLength, 'a'), std::string(kValueLength, 'b'),
+      std::string(kValueLength, 'c'), std::string(kValueLength, 'd'),
+      std::string(kValueLength, 'e')};
+  SetNextResolution(
+      MakeServiceConfigBuilder()
+          .AddKeyBuilder(absl::StrFormat("\"names\":[{"
+                                         "  \"service\":\"%s\","
+                                         "  \"method\":\"%s\""
+                                         "}],"
+                                         "\"headers\":["
+                                         "  {"
+                                         "    \"key\":\"%s\","
+                                         "    \"names\":["
+                                         "      \"key1\""
+                                         "    ]"
+                                         "  }"
+                                         "]",
+                                         kServiceValue, kMethodValue, kTestKey))
+          .set_cache_size_bytes(30000)
+          .Build());
+  for (const std::string& value : values) {
+    rls_server_->service_.SetResponse(
+        BuildRlsRequest({{kTestKey, value}}),
+        BuildRlsResponse({TargetStringForPort(backends_[0]->port_)}));
+  }
+  auto send_rpc = [&](int index) {
+    CheckRpcSendOk(DEBUG_LOCATION,
+                   RpcOptions().set_metadata({{"key1", values[index]}}));
+  };
+  // Fill the cache with a, b and c.
+  for (int i = 0; i < 3; ++i) send_rpc(i);
+  EXPECT_EQ(rls_server_->service_.request_count(), 3);
+  // Wait for min_eviction_time to elapse.
+  gpr_sleep_until(grpc_timeout_seconds_to_deadline(6));
+  // Adding d evicts a, the oldest entry.  Every entry was used since it was
+  // added, so all of them got a second chance before a was evicted.
+  send_rpc(3);
+  EXPECT_EQ(rls_server_->service_.request_count(), 4);
+  // Use b, which is now the oldest entry, from the cache.
+  send_rpc(1);
+  EXPECT_EQ(rls_server_->service_.request_count(), 4);
+  // Adding e skips b, which was used since the last eviction, and evicts c.
+  send_rpc(4);
+  EXPECT_EQ(rls_server_->service_.request_count(), 5);
+  send_rpc(1);
+  EXPECT_EQ(rls_server_->service_.request_count(), 5);
+  send_rpc(2);
+  EXPECT_EQ(rls_server_->service_.request_count(), 6);
+}
+
 TEST_F(RlsEnd2endTest, MultipleTargets) {
   StartBackends(1);
   SetNextResolution(
@@ -66,6 +66,26 @@ static void BM_Arena_Batch(benchmark::State& state) {
 }
 BENCHMARK(BM_Arena_Batch)->Ranges({{1, 64 * 1024}, {1, 64}, {1, 1024}});
 
+// Per-call arena lifecycle with and without the block pool: an initial zone
+// of range(1) bytes, grown by a second zone, then destroyed.
+static void BM_Arena_BlockPool(benchmark::State& state) {
+  grpc_core::ArenaBlockPool* pool = grpc_core::ArenaBlockPool::Get();
+  pool->TestOnlySetEnabled(state.range(0) != 0);
+  const size_t system_allocs_before = pool->system_allocs();
+  for (auto _ : state) {
+    Arena* a = Arena::Create(state.range(1), g_memory_allocator);
+    a->Alloc(state.range(1));
+    a->Alloc(state.range(1));
+    a->Destroy();
+  }
+  state.counters["system_allocs"] = benchmark::Counter(
+      static_cast<double>(pool->system_allocs() - system_allocs_before),
+      benchmark::Counter::kAvgIterations);
+  pool->Drain();
+  pool->TestOnlySetEnabled(true);
+}
+BENCHMARK(BM_Arena_BlockPool)->Ranges({{0, 1}, {256, 16 * 1024}});
+
 // Some distros have RunSpecifiedBenchmarks under the benchmark namespace,
 // and others do not. This allows us to support both modes.
 namespace benchmark {
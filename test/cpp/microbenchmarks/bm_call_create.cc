@@ -44,6 +44,7 @@
 #include "src/core/lib/config/core_configuration.h"
 #include "src/core/lib/iomgr/call_combiner.h"
 #include "src/core/lib/profiling/timers.h"
+#include "src/core/lib/resource_quota/arena.h"
 #include "src/core/lib/resource_quota/resource_quota.h"
 #include "src/core/lib/surface/channel.h"
 #include "src/core/lib/transport/transport_impl.h"
@@ -114,25 +115,35 @@ class LameChannel : public BaseChannelFixture {
             "localhost:1234", GRPC_STATUS_UNAUTHENTICATED, "blah")) {}
 };
 
+// range(0) selects whether call arenas are recycled through the block pool.
 template <class Fixture>
 static void BM_CallCreateDestroy(benchmark::State& state) {
   TrackCounters track_counters;
+  grpc_core::ArenaBlockPool* pool = grpc_core::ArenaBlockPool::Get();
+  pool->TestOnlySetEnabled(state.range(0) != 0);
   Fixture fixture;
   grpc_completion_queue* cq = grpc_completion_queue_create_for_next(nullptr);
   gpr_timespec deadline = gpr_inf_future(GPR_CLOCK_MONOTONIC);
   void* method_hdl = grpc_channel_register_call(fixture.channel(), "/foo/bar",
                                                 nullptr, nullptr);
+  const size_t system_allocs_before = pool->system_allocs();
   for (auto _ : state) {
     grpc_call_unref(grpc_channel_create_registered_call(
         fixture.channel(), nullptr, GRPC_PROPAGATE_DEFAULTS, cq, method_hdl,
         deadline, nullptr));
   }
+  const size_t system_allocs = pool->system_allocs() - system_allocs_before;
   grpc_completion_queue_destroy(cq);
+  pool->Drain();
+  pool->TestOnlySetEnabled(true);
+  state.counters["arena_system_allocs"] =
+      benchmark::Counter(static_cast<double>(system_allocs),
+                         benchmark::Counter::kAvgIterations);
   track_counters.Finish(state);
 }
 
-BENCHMARK_TEMPLATE(BM_CallCreateDestroy, InsecureChannel);
-BENCHMARK_TEMPLATE(BM_CallCreateDestroy, LameChannel);
+BENCHMARK_TEMPLATE(BM_CallCreateDestroy, InsecureChannel)->Arg(0)->Arg(1);
+BENCHMARK_TEMPLATE(BM_CallCreateDestroy, LameChannel)->Arg(0)->Arg(1);
 
 ////////////////////////////////////////////////////////////////////////////////
 // Benchmarks isolating individual filters
@@ -22,6 +22,7 @@
 
 #include <memory>
 #include <sstream>
+#include <string>
 
 #include <benchmark/benchmark.h>
 
@@ -29,6 +30,7 @@
 #include <grpc/support/alloc.h>
 #include <grpc/support/log.h>
 
+#include "src/core/ext/transport/chttp2/transport/bin_encoder.h"
 #include "src/core/ext/transport/chttp2/transport/hpack_encoder.h"
 #include "src/core/ext/transport/chttp2/transport/hpack_parser.h"
 #include "src/core/lib/gprpp/time.h"
@@ -54,6 +56,18 @@ static grpc_slice MakeSlice(const std::vector<uint8_t>& bytes) {
   return s;
 }
 
+// A header-safe string of the given length, shaped like a long :path or an
+// auth token.
+static std::string MakeHeaderValue(int length) {
+  static const char kChars[] =
+      "/abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789-._~";
+  std::string value;
+  for (int i = 0; i < length; i++) {
+    value.push_back(kChars[(i * 7) % (sizeof(kChars) - 1)]);
+  }
+  return value;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // HPACK encoder
 //
@@ -341,6 +355,19 @@ BENCHMARK_TEMPLATE(BM_HpackEncoderEncodeHeader,
 
 }  // namespace hpack_encoder_fixtures
 
+static void BM_HpackHuffmanCompress(benchmark::State& state) {
+  TrackCounters track_counters;
+  grpc_slice input =
+      grpc_slice_from_cpp_string(MakeHeaderValue(state.range(0)));
+  for (auto _ : state) {
+    grpc_slice_unref(grpc_chttp2_huffman_compress(input));
+  }
+  grpc_slice_unref(input);
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+  track_counters.Finish(state);
+}
+BENCHMARK(BM_HpackHuffmanCompress)->Range(8, 4096);
+
 ////////////////////////////////////////////////////////////////////////////////
 // HPACK parser
 //
@@ -625,6 +652,36 @@ using RepresentativeServerTrailingMetadata = FromEncoderFixture<
 using MoreRepresentativeClientInitialMetadata = FromEncoderFixture<
     hpack_encoder_fixtures::MoreRepresentativeClientInitialMetadata>;
 
+// Literal header with a huffman coded value of kLength characters, the
+// common shape of long :path and authorization headers.
+template <int kLength>
+class NonIndexedHuffmanElem {
+ public:
+  static std::vector<grpc_slice> GetInitSlices() { return {}; }
+  static std::vector<grpc_slice> GetBenchmarkSlices() {
+    grpc_slice value = grpc_slice_from_cpp_string(MakeHeaderValue(kLength));
+    grpc_slice huff = grpc_chttp2_huffman_compress(value);
+    std::vector<uint8_t> v = {0x00, 0x03, 'a', 'b', 'c'};
+    // String length as a 7-bit prefix integer, with the huffman bit set.
+    size_t length = GRPC_SLICE_LENGTH(huff);
+    if (length < 0x7f) {
+      v.push_back(static_cast<uint8_t>(0x80 | length));
+    } else {
+      v.push_back(0xff);
+      length -= 0x7f;
+      while (length >= 0x80) {
+        v.push_back(static_cast<uint8_t>(0x80 | (length & 0x7f)));
+        length >>= 7;
+      }
+      v.push_back(static_cast<uint8_t>(length));
+    }
+    v.insert(v.end(), GRPC_SLICE_START_PTR(huff), GRPC_SLICE_END_PTR(huff));
+    grpc_slice_unref(value);
+    grpc_slice_unref(huff);
+    return {MakeSlice(v)};
+  }
+};
+
 // Send the same deadline repeatedly
 class SameDeadline {
  public:
@@ -672,6 +729,9 @@ BENCHMARK_TEMPLATE(BM_HpackParserParseHeader,
 BENCHMARK_TEMPLATE(BM_HpackParserParseHeader,
                    RepresentativeServerInitialMetadata);
 BENCHMARK_TEMPLATE(BM_HpackParserParseHeader, SameDeadline);
+BENCHMARK_TEMPLATE(BM_HpackParserParseHeader, NonIndexedHuffmanElem<16>);
+BENCHMARK_TEMPLATE(BM_HpackParserParseHeader, NonIndexedHuffmanElem<128>);
+BENCHMARK_TEMPLATE(BM_HpackParserParseHeader, NonIndexedHuffmanElem<1024>);
 
 }  // namespace hpack_parser_fixtures
 
@@ -0,0 +1,118 @@
+/*
+ *
+ * Copyright 2022 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+/* Benchmark the chttp2 stream map at high concurrent stream counts */
+
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "src/core/ext/transport/chttp2/transport/stream_map.h"
+#include "test/core/util/test_config.h"
+#include "test/cpp/microbenchmarks/helpers.h"
+#include "test/cpp/util/test_config.h"
+
+namespace grpc {
+namespace testing {
+
+// Cheap pseudo-random sequence, so that lookups do not walk the table in
+// order.
+static uint64_t NextRandom(uint64_t* state) {
+  *state ^= *state << 13;
+  *state ^= *state >> 7;
+  *state ^= *state << 17;
+  return *state;
+}
+
+static void* ValueFor(uint32_t id) {
+  return reinterpret_cast<void*>(static_cast<uintptr_t>(id));
+}
+
+// Fill map with n client stream ids (odd, increasing), returning them.
+static std::vector<uint32_t> Fill(grpc_chttp2_stream_map* map, int n) {
+  std::vector<uint32_t> ids;
+  for (int i = 0; i < n; i++) {
+    uint32_t id = 2 * i + 1;
+    grpc_chttp2_stream_map_add(map, id, ValueFor(id));
+    ids.push_back(id);
+  }
+  return ids;
+}
+
+static void BM_StreamMapFind(benchmark::State& state) {
+  grpc_chttp2_stream_map map;
+  grpc_chttp2_stream_map_init(&map, 8);
+  std::vector<uint32_t> ids = Fill(&map, state.range(0));
+  uint64_t rng = 0x9e3779b97f4a7c15;
+  for (auto _ : state) {
+    uint32_t id = ids[NextRandom(&rng) % ids.size()];
+    benchmark::DoNotOptimize(grpc_chttp2_stream_map_find(&map, id));
+  }
+  grpc_chttp2_stream_map_destroy(&map);
+}
+BENCHMARK(BM_StreamMapFind)->RangeMultiplier(10)->Range(10, 100000);
+
+// Steady state: each iteration closes a random live stream and opens a new
+// one, as on a busy connection with long- and short-lived streams mixed.
+static void BM_StreamMapChurn(benchmark::State& state) {
+  grpc_chttp2_stream_map map;
+  grpc_chttp2_stream_map_init(&map, 8);
+  std::vector<uint32_t> ids = Fill(&map, state.range(0));
+  uint32_t next_id = ids.back() + 2;
+  uint64_t rng = 0x9e3779b97f4a7c15;
+  for (auto _ : state) {
+    size_t victim = NextRandom(&rng) % ids.size();
+    benchmark::DoNotOptimize(
+        grpc_chttp2_stream_map_delete(&map, ids[victim]));
+    grpc_chttp2_stream_map_add(&map, next_id, ValueFor(next_id));
+    ids[victim] = next_id;
+    next_id += 2;
+  }
+  grpc_chttp2_stream_map_destroy(&map);
+}
+BENCHMARK(BM_StreamMapChurn)->RangeMultiplier(10)->Range(10, 100000);
+
+static void BM_StreamMapRand(benchmark::State& state) {
+  grpc_chttp2_stream_map map;
+  grpc_chttp2_stream_map_init(&map, 8);
+  Fill(&map, state.range(0));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(grpc_chttp2_stream_map_rand(&map));
+  }
+  grpc_chttp2_stream_map_destroy(&map);
+}
+BENCHMARK(BM_StreamMapRand)->RangeMultiplier(10)->Range(10, 100000);
+
+}  // namespace testing
+}  // namespace grpc
+
+// Some distros have RunSpecifiedBenchmarks under the benchmark namespace,
+// and others do not. This allows us to support both modes.
+namespace benchmark {
+void RunTheBenchmarksNamespaced() { RunSpecifiedBenchmarks(); }
+}  // namespace benchmark
+
+int main(int argc, char** argv) {
+  grpc::testing::TestEnvironment env(&argc, argv);
+  LibraryInitializer libInit;
+  ::benchmark::Initialize(&argc, argv);
+  grpc::testing::InitTest(&argc, &argv, false);
+
+  benchmark::RunTheBenchmarksNamespaced();
+  return 0;
+}
@@ -48,6 +48,10 @@ static auto* g_memory_allocator = new grpc_core::MemoryAllocator(
 // Helper classes
 //
 
+// Writes made by PhonyEndpoint, and the slices that they carried.
+static int64_t g_endpoint_writes;
+static int64_t g_endpoint_write_slices;
+
 class PhonyEndpoint : public grpc_endpoint {
  public:
   PhonyEndpoint() {
@@ -101,8 +105,10 @@ class PhonyEndpoint : public grpc_endpoint {
     static_cast<PhonyEndpoint*>(ep)->QueueRead(slices, cb);
   }
 
-  static void write(grpc_endpoint* /*ep*/, grpc_slice_buffer* /*slices*/,
+  static void write(grpc_endpoint* /*ep*/, grpc_slice_buffer* slices,
                     grpc_closure* cb, void* /*arg*/) {
+    ++g_endpoint_writes;
+    g_endpoint_write_slices += slices->count;
     grpc_core::ExecCtx::Run(DEBUG_LOCATION, cb, GRPC_ERROR_NONE);
   }
 
@@ -412,7 +418,7 @@ static void BM_TransportEmptyOp(benchmark::State& state) {
 }
 BENCHMARK(BM_TransportEmptyOp);
 
-static void BM_TransportStreamSend(benchmark::State& state) {
+static void TransportStreamSend(benchmark::State& state, uint32_t flags) {
   TrackCounters track_counters;
   grpc_core::ExecCtx exec_ctx;
   Fixture f(grpc::ChannelArguments(), true);
@@ -447,7 +453,7 @@ static void BM_TransportStreamSend(benchmark::State& state) {
         grpc_slice_buffer send_buffer;
         grpc_slice_buffer_init(&send_buffer);
         grpc_slice_buffer_add(&send_buffer, grpc_slice_ref(send_slice));
-        send_stream.Init(&send_buffer, 0);
+        send_stream.Init(&send_buffer, flags);
         grpc_slice_buffer_destroy(&send_buffer);
         // force outgoing window to be yuge
         s->chttp2_stream()->flow_control->TestOnlyForceHugeWindow();
@@ -465,9 +471,16 @@ static void BM_TransportStreamSend(benchmark::State& state) {
   op.on_complete = c.get();
   s->Op(&op);
 
+  const int64_t writes_before = g_endpoint_writes;
+  const int64_t write_slices_before = g_endpoint_write_slices;
   f.FlushExecCtx();
   gpr_event_wait(bm_done, gpr_inf_future(GPR_CLOCK_REALTIME));
   done_events.emplace_back(bm_done);
+  const double writes = g_endpoint_writes - writes_before;
+  state.counters["writes_per_message"] =
+      benchmark::Counter(writes, benchmark::Counter::kAvgIterations);
+  const double write_slices = g_endpoint_write_slices - write_slices_before;
+  state.counters["slices_per_write"] = writes == 0 ? 0 : write_slices / writes;
 
   reset_op();
   op.cancel_stream = true;
@@ -490,8 +503,19 @@ static void BM_TransportStreamSend(benchmark::State& state) {
   track_counters.Finish(state);
   grpc_slice_unref(send_slice);
 }
+
+static void BM_TransportStreamSend(benchmark::State& state) {
+  TransportStreamSend(state, 0);
+}
 BENCHMARK(BM_TransportStreamSend)->Range(0, 128 * 1024 * 1024);
 
+// Small messages written with GRPC_WRITE_BUFFER_HINT, which the transport
+// packs together into shared frames and writes.
+static void BM_TransportStreamSendBuffered(benchmark::State& state) {
+  TransportStreamSend(state, GRPC_WRITE_BUFFER_HINT);
+}
+BENCHMARK(BM_TransportStreamSendBuffered)->Range(16, 4096);
+
 #define SLICE_FROM_BUFFER(s) grpc_slice_from_static_buffer(s, sizeof(s) - 1)
 
 static grpc_slice CreateIncomingDataSlice(size_t length, size_t frame_size) {
@@ -111,7 +111,7 @@ static const grpc_event_engine_vtable* init_engine_vtable(bool) {
   return &g_vtable;
 }
 
-static void setup() {
+static void setup(int num_shards) {
   // This test should only ever be run with a non or any polling engine
   // Override the polling engine for the non-polling engine
   // and add a custom polling engine
@@ -124,7 +124,14 @@ static void setup() {
              strcmp(grpc_get_poll_strategy_name(), "bm_cq_multiple_threads") ==
                  0);
 
-  g_cq = grpc_completion_queue_create_for_next(nullptr);
+  grpc_completion_queue_attributes attr;
+  attr.version = GRPC_CQ_CURRENT_VERSION;
+  attr.cq_completion_type = GRPC_CQ_NEXT;
+  attr.cq_polling_type = GRPC_CQ_DEFAULT_POLLING;
+  attr.cq_shutdown_cb = nullptr;
+  attr.cq_num_shards = num_shards;
+  g_cq = grpc_completion_queue_create(
+      grpc_completion_queue_factory_lookup(&attr), &attr, nullptr);
 }
 
 static void teardown() {
@@ -168,7 +175,7 @@ static void BM_Cq_Throughput(benchmark::State& state) {
   gpr_mu_lock(&g_mu);
   g_threads_active++;
   if (thd_idx == 0) {
-    setup();
+    setup(state.range(0));
     g_active = true;
     gpr_cv_broadcast(&g_cv);
   } else {
@@ -207,7 +214,13 @@ static void BM_Cq_Throughput(benchmark::State& state) {
   }
 }
 
-BENCHMARK(BM_Cq_Throughput)->ThreadRange(1, 16)->UseRealTime();
+// Arg: number of completion queue shards (capped at the number of cores)
+BENCHMARK(BM_Cq_Throughput)
+    ->ArgName("shards")
+    ->Arg(1)
+    ->Arg(16)
+    ->ThreadRange(1, 16)
+    ->UseRealTime();
 
 }  // namespace testing
 }  // namespace grpc
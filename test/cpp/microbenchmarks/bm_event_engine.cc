@@ -0,0 +1,371 @@
+// Copyright 2022 gRPC authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Compares the PosixEventEngine against the iomgr primitives it replaces:
+// callback scheduling, timers, and TCP endpoint throughput.
+
+#include <netinet/in.h>
+#include <string.h>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "absl/memory/memory.h"
+#include "absl/synchronization/notification.h"
+#include "absl/time/clock.h"
+
+#include <grpc/event_engine/endpoint_config.h>
+#include <grpc/event_engine/event_engine.h>
+#include <grpc/grpc.h>
+#include <grpc/slice_buffer.h>
+#include <grpc/support/alloc.h>
+#include <grpc/support/log.h>
+
+#include "src/core/lib/event_engine/posix_engine/posix_engine.h"
+#include "src/core/lib/gprpp/time.h"
+#include "src/core/lib/iomgr/closure.h"
+#include "src/core/lib/iomgr/endpoint.h"
+#include "src/core/lib/iomgr/endpoint_pair.h"
+#include "src/core/lib/iomgr/exec_ctx.h"
+#include "src/core/lib/iomgr/executor.h"
+#include "src/core/lib/iomgr/pollset.h"
+#include "src/core/lib/iomgr/timer.h"
+#include "src/core/lib/resource_quota/memory_quota.h"
+#include "test/core/util/test_config.h"
+#include "test/cpp/microbenchmarks/helpers.h"
+#include "test/cpp/util/test_config.h"
+
+namespace {
+
+using ::grpc_event_engine::experimental::EndpointConfig;
+using ::grpc_event_engine::experimental::EventEngine;
+using ::grpc_event_engine::experimental::MemoryAllocator;
+using ::grpc_event_engine::experimental::PosixEventEngine;
+using ::grpc_event_engine::experimental::SliceBuffer;
+
+class EmptyEndpointConfig : public EndpointConfig {
+ public:
+  Setting Get(absl::string_view /*key*/) const override {
+    return absl::monostate();
+  }
+};
+
+// -- Callback scheduling --
+
+void BM_EventEngineRun(benchmark::State& state) {
+  TrackCounters track_counters;
+  PosixEventEngine engine;
+  const int batch = state.range(0);
+  for (auto _ : state) {
+    std::atomic<int> remaining{batch};
+    absl::Notification done;
+    for (int i = 0; i < batch; i++) {
+      engine.Run([&remaining, &done]() {
+        if (remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+          done.Notify();
+        }
+      });
+    }
+    done.WaitForNotification();
+  }
+  state.SetItemsProcessed(state.iterations() * batch);
+  track_counters.Finish(state);
+}
+BENCHMARK(BM_EventEngineRun)->Range(1, 4096);
+
+struct ExecutorBatch {
+  std::atomic<int> remaining;
+  absl::Notification done;
+};
+
+void ExecutorCallback(void* arg, grpc_error_handle /*error*/) {
+  auto* batch = static_cast<ExecutorBatch*>(arg);
+  if (batch->remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+    batch->done.Notify();
+  }
+}
+
+void BM_IomgrExecutorRun(benchmark::State& state) {
+  TrackCounters track_counters;
+  const int batch = state.range(0);
+  std::vector<grpc_closure> closures(batch);
+  for (auto _ : state) {
+    ExecutorBatch b;
+    b.remaining.store(batch, std::memory_order_relaxed);
+    {
+      grpc_core::ExecCtx exec_ctx;
+      for (int i = 0; i < batch; i++) {
+        grpc_core::Executor::Run(
+            GRPC_CLOSURE_INIT(&closures[i], ExecutorCallback, &b, nullptr),
+            GRPC_ERROR_NONE);
+      }
+    }
+    b.done.WaitForNotification();
+  }
+  state.SetItemsProcessed(state.iterations() * batch);
+  track_counters.Finish(state);
+}
+BENCHMARK(BM_IomgrExecutorRun)->Range(1, 4096);
+
+// -- Timers --
+
+void BM_EventEngineRunAtCancel(benchmark::State& state) {
+  TrackCounters track_counters;
+  PosixEventEngine engine;
+  for (auto _ : state) {
+    auto handle = engine.RunAt(absl::Now() + absl::Hours(1), []() {});
+    GPR_ASSERT(engine.Cancel(handle));
+  }
+  track_counters.Finish(state);
+}
+BENCHMARK(BM_EventEngineRunAtCancel);
+
+void DoNothing(void* /*arg*/, grpc_error_handle /*error*/) {}
+
+void BM_IomgrTimerInitCancel(benchmark::State& state) {
+  TrackCounters track_counters;
+  grpc_core::ExecCtx exec_ctx;
+  grpc_timer timer;
+  grpc_closure closure;
+  GRPC_CLOSURE_INIT(&closure, DoNothing, nullptr, grpc_schedule_on_exec_ctx);
+  for (auto _ : state) {
+    grpc_timer_init(&timer,
+                    grpc_core::ExecCtx::Get()->Now() +
+                        grpc_core::Duration::Hours(1),
+                    &closure);
+    grpc_timer_cancel(&timer);
+    grpc_core::ExecCtx::Get()->Flush();
+  }
+  track_counters.Finish(state);
+}
+BENCHMARK(BM_IomgrTimerInitCancel);
+
+// -- Endpoint throughput --
+
+EventEngine::ResolvedAddress LoopbackAddress(int port) {
+  sockaddr_in addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  addr.sin_port = htons(port);
+  return EventEngine::ResolvedAddress(reinterpret_cast<sockaddr*>(&addr),
+                                      sizeof(addr));
+}
+
+void AddPayload(grpc_slice_buffer* buffer, size_t size) {
+  static constexpr size_t kSliceSize = 64 * 1024;
+  for (size_t offset = 0; offset < size; offset += kSliceSize) {
+    grpc_slice slice = GRPC_SLICE_MALLOC(std::min(kSliceSize, size - offset));
+    memset(GRPC_SLICE_START_PTR(slice), 'a', GRPC_SLICE_LENGTH(slice));
+    grpc_slice_buffer_add(buffer, slice);
+  }
+}
+
+void BM_EventEngineEndpointThroughput(benchmark::State& state) {
+  TrackCounters track_counters;
+  const size_t size = state.range(0);
+  PosixEventEngine engine;
+  EmptyEndpointConfig config;
+  grpc_core::MemoryQuota memory_quota("bm");
+  std::unique_ptr<EventEngine::Endpoint> client;
+  std::unique_ptr<EventEngine::Endpoint> server;
+  absl::Notification accepted;
+  auto listener = engine.CreateListener(
+      [&server, &accepted](std::unique_ptr<EventEngine::Endpoint> ep,
+                           MemoryAllocator /*allocator*/) {
+        server = std::move(ep);
+        accepted.Notify();
+      },
+      [](absl::Status /*status*/) {}, config,
+      absl::make_unique<grpc_core::MemoryQuota>("bm_listener"));
+  GPR_ASSERT(listener.ok());
+  auto port = (*listener)->Bind(LoopbackAddress(0));
+  GPR_ASSERT(port.ok());
+  GPR_ASSERT((*listener)->Start().ok());
+  absl::Notification connected;
+  engine.Connect(
+      [&client, &connected](
+          absl::StatusOr<std::unique_ptr<EventEngine::Endpoint>> ep) {
+        GPR_ASSERT(ep.ok());
+        client = std::move(*ep);
+        connected.Notify();
+      },
+      LoopbackAddress(*port), config,
+      memory_quota.CreateMemoryAllocator("bm_client"),
+      absl::Now() + absl::Seconds(10));
+  connected.WaitForNotification();
+  accepted.WaitForNotification();
+
+  grpc_slice_buffer outgoing;
+  grpc_slice_buffer incoming;
+  grpc_slice_buffer_init(&outgoing);
+  grpc_slice_buffer_init(&incoming);
+  SliceBuffer out_buffer(&outgoing);
+  SliceBuffer in_buffer(&incoming);
+  for (auto _ : state) {
+    AddPayload(&outgoing, size);
+    absl::Notification write_done;
+    client->Write(
+        [&write_done](absl::Status /*status*/) { write_done.Notify(); },
+        &out_buffer);
+    size_t received = 0;
+    while (received < size) {
+      absl::Notification read_done;
+      server->Read(
+          [&read_done](absl::Status status) {
+            GPR_ASSERT(status.ok());
+            read_done.Notify();
+          },
+          &in_buffer);
+      read_done.WaitForNotification();
+      received += incoming.length;
+      grpc_slice_buffer_reset_and_unref(&incoming);
+    }
+    write_done.WaitForNotification();
+    grpc_slice_buffer_reset_and_unref(&outgoing);
+  }
+  state.SetBytesProcessed(state.iterations() * size);
+  client.reset();
+  server.reset();
+  listener->reset();
+  grpc_slice_buffer_destroy(&outgoing);
+  grpc_slice_buffer_destroy(&incoming);
+  track_counters.Finish(state);
+}
+BENCHMARK(BM_EventEngineEndpointThroughput)->Range(1, 16 * 1024 * 1024);
+
+struct IomgrTransfer {
+  gpr_mu* mu;
+  grpc_pollset* pollset;
+  grpc_endpoint* reader;
+  grpc_slice_buffer incoming;
+  grpc_closure on_read;
+  grpc_closure on_write;
+  size_t expected = 0;
+  size_t received = 0;
+  bool read_done = false;
+  bool write_done = false;
+};
+
+void IomgrOnWrite(void* arg, grpc_error_handle error) {
+  auto* t = static_cast<IomgrTransfer*>(arg);
+  GPR_ASSERT(error == GRPC_ERROR_NONE);
+  gpr_mu_lock(t->mu);
+  t->write_done = true;
+  GRPC_LOG_IF_ERROR("pollset_kick", grpc_pollset_kick(t->pollset, nullptr));
+  gpr_mu_unlock(t->mu);
+}
+
+void IomgrOnRead(void* arg, grpc_error_handle error) {
+  auto* t = static_cast<IomgrTransfer*>(arg);
+  GPR_ASSERT(error == GRPC_ERROR_NONE);
+  t->received += t->incoming.length;
+  grpc_slice_buffer_reset_and_unref(&t->incoming);
+  if (t->received < t->expected) {
+    grpc_endpoint_read(t->reader, &t->incoming, &t->on_read, /*urgent=*/false,
+                       /*min_progress_size=*/1);
+    return;
+  }
+  gpr_mu_lock(t->mu);
+  t->read_done = true;
+  GRPC_LOG_IF_ERROR("pollset_kick", grpc_pollset_kick(t->pollset, nullptr));
+  gpr_mu_unlock(t->mu);
+}
+
+void DestroyPollset(void* pollset, grpc_error_handle /*error*/) {
+  grpc_pollset_destroy(static_cast<grpc_pollset*>(pollset));
+}
+
+void BM_IomgrEndpointThroughput(benchmark::State& state) {
+  TrackCounters track_counters;
+  const size_t size = state.range(0);
+  grpc_core::ExecCtx exec_ctx;
+  grpc_endpoint_pair pair = grpc_iomgr_create_endpoint_pair("bm", nullptr);
+  IomgrTransfer t;
+  t.pollset = static_cast<grpc_pollset*>(gpr_zalloc(grpc_pollset_size()));
+  grpc_pollset_init(t.pollset, &t.mu);
+  grpc_endpoint_add_to_pollset(pair.client, t.pollset);
+  grpc_endpoint_add_to_pollset(pair.server, t.pollset);
+  t.reader = pair.server;
+  grpc_slice_buffer_init(&t.incoming);
+  GRPC_CLOSURE_INIT(&t.on_read, IomgrOnRead, &t, grpc_schedule_on_exec_ctx);
+  GRPC_CLOSURE_INIT(&t.on_write, IomgrOnWrite, &t, grpc_schedule_on_exec_ctx);
+  grpc_slice_buffer outgoing;
+  grpc_slice_buffer_init(&outgoing);
+  for (auto _ : state) {
+    AddPayload(&outgoing, size);
+    t.expected = size;
+    t.received = 0;
+    t.read_done = false;
+    t.write_done = false;
+    grpc_endpoint_read(pair.server, &t.incoming, &t.on_read, /*urgent=*/false,
+                       /*min_progress_size=*/1);
+    grpc_endpoint_write(pair.client, &outgoing, &t.on_write, nullptr);
+    grpc_core::ExecCtx::Get()->Flush();
+    gpr_mu_lock(t.mu);
+    while (!t.read_done || !t.write_done) {
+      grpc_pollset_worker* worker = nullptr;
+      GRPC_LOG_IF_ERROR(
+          "pollset_work",
+          grpc_pollset_work(t.pollset, &worker,
+                            grpc_core::Timestamp::InfFuture()));
+      gpr_mu_unlock(t.mu);
+      grpc_core::ExecCtx::Get()->Flush();
+      gpr_mu_lock(t.mu);
+    }
+    gpr_mu_unlock(t.mu);
+    grpc_slice_buffer_reset_and_unref(&outgoing);
+  }
+  state.SetBytesProcessed(state.iterations() * size);
+  grpc_endpoint_shutdown(pair.client,
+                         GRPC_ERROR_CREATE_FROM_STATIC_STRING("bm"));
+  grpc_endpoint_shutdown(pair.server,
+                         GRPC_ERROR_CREATE_FROM_STATIC_STRING("bm"));
+  grpc_endpoint_destroy(pair.client);
+  grpc_endpoint_destroy(pair.server);
+  grpc_core::ExecCtx::Get()->Flush();
+  grpc_closure destroyed;
+  GRPC_CLOSURE_INIT(&destroyed, DestroyPollset, t.pollset,
+                    grpc_schedule_on_exec_ctx);
+  gpr_mu_lock(t.mu);
+  grpc_pollset_shutdown(t.pollset, &destroyed);
+  gpr_mu_unlock(t.mu);
+  grpc_core::ExecCtx::Get()->Flush();
+  gpr_free(t.pollset);
+  grpc_slice_buffer_destroy(&outgoing);
+  grpc_slice_buffer_destroy(&t.incoming);
+  track_counters.Finish(state);
+}
+BENCHMARK(BM_IomgrEndpointThroughput)->Range(1, 16 * 1024 * 1024);
+
+}  // namespace
+
+// Some distros have RunSpecifiedBenchmarks under the benchmark namespace,
+// and others do not. This allows us to support both modes.
+namespace benchmark {
+void RunTheBenchmarksNamespaced() { RunSpecifiedBenchmarks(); }
+}  // namespace benchmark
+
+int main(int argc, char** argv) {
+  grpc::testing::TestEnvironment env(&argc, argv);
+  LibraryInitializer libInit;
+  ::benchmark::Initialize(&argc, argv);
+  grpc::testing::InitTest(&argc, &argv, false);
+  benchmark::RunTheBenchmarksNamespaced();
+  return 0;
+}
@@ -0,0 +1,184 @@
+/*
+ *
+ * Copyright 2022 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+/* Benchmark how quickly flow control windows ramp up to a link's
+ * bandwidth-delay product. The link is emulated in simulated time: every
+ * round trip the receiver gets min(window, bandwidth * rtt) bytes, and BDP
+ * pings take one round trip, so that high latency links can be modelled
+ * without waiting for them. */
+
+#include <math.h>
+
+#include <algorithm>
+
+#include <benchmark/benchmark.h>
+
+#include <grpc/support/time.h>
+
+#include "src/core/ext/transport/chttp2/transport/flow_control.h"
+#include "src/core/lib/gpr/useful.h"
+#include "src/core/lib/iomgr/exec_ctx.h"
+#include "src/core/lib/iomgr/timer_manager.h"
+#include "src/core/lib/transport/bdp_estimator.h"
+#include "src/core/lib/transport/pid_controller.h"
+#include "test/core/util/test_config.h"
+#include "test/cpp/microbenchmarks/helpers.h"
+#include "test/cpp/util/test_config.h"
+
+extern gpr_timespec (*gpr_now_impl)(gpr_clock_type clock_type);
+
+namespace grpc {
+namespace testing {
+
+static gpr_timespec g_fake_now;
+
+static gpr_timespec FakeNow(gpr_clock_type clock_type) {
+  gpr_timespec now = g_fake_now;
+  now.clock_type = clock_type;
+  return now;
+}
+
+static void AdvanceFakeTime(double seconds) {
+  g_fake_now = gpr_time_add(
+      g_fake_now, gpr_time_from_nanos(static_cast<int64_t>(seconds * 1e9),
+                                      GPR_TIMESPAN));
+  grpc_core::ExecCtx::Get()->InvalidateNow();
+}
+
+// Mirrors TransportFlowControl's default estimator with no memory pressure:
+// the ping's BDP estimate, in log space, smoothed by a PID controller.
+class PidWindow {
+ public:
+  explicit PidWindow(const grpc_core::BdpEstimator* estimator)
+      : estimator_(estimator),
+        pid_controller_(grpc_core::PidController::Args()
+                            .set_gain_p(4)
+                            .set_gain_i(8)
+                            .set_gain_d(0)
+                            .set_initial_control_value(TargetLogBdp())
+                            .set_min_control_value(-1)
+                            .set_max_control_value(25)
+                            .set_integral_range(10)),
+        last_update_(grpc_core::ExecCtx::Get()->Now()) {}
+
+  double Update() {
+    grpc_core::Timestamp now = grpc_core::ExecCtx::Get()->Now();
+    const double dt = std::min((now - last_update_).seconds(), 0.1);
+    last_update_ = now;
+    const double target = TargetLogBdp();
+    return pow(2, pid_controller_.Update(
+                      target - pid_controller_.last_control_value(), dt));
+  }
+
+ private:
+  double TargetLogBdp() const {
+    // Without memory pressure, small estimates are pulled up to 2^22.
+    return std::max(22.0, 1 + log2(estimator_->EstimateBdp()));
+  }
+
+  const grpc_core::BdpEstimator* const estimator_;
+  grpc_core::PidController pid_controller_;
+  grpc_core::Timestamp last_update_;
+};
+
+// range(0): 0 for the PID estimator, 1 for the delivery rate estimator.
+// range(1): round trip time in milliseconds.
+// range(2): link bandwidth in megabits per second.
+static void BM_FlowControlRamp(benchmark::State& state) {
+  const bool delivery_rate = state.range(0) != 0;
+  const double rtt = state.range(1) / 1000.0;
+  const double bdp = state.range(2) * 125000.0 * rtt;
+  // A window within 5% of the bandwidth-delay product counts as full
+  // throughput; give up on links the estimator never fills.
+  const double kFullThroughput = 0.95;
+  const int kMaxRounds = 100000;
+  auto* real_now = gpr_now_impl;
+  g_fake_now = real_now(GPR_CLOCK_MONOTONIC);
+  gpr_now_impl = FakeNow;
+  grpc_core::ExecCtx exec_ctx;
+  int64_t total_rounds = 0;
+  for (auto _ : state) {
+    grpc_core::BdpEstimator estimator("bm_flow_control_ramp");
+    PidWindow pid_window(&estimator);
+    grpc_core::Timestamp next_ping = grpc_core::ExecCtx::Get()->Now();
+    double window = grpc_core::chttp2::kDefaultWindow;
+    int rounds = 0;
+    while (std::min(window, bdp) < kFullThroughput * bdp &&
+           rounds < kMaxRounds) {
+      ++rounds;
+      const bool ping = grpc_core::ExecCtx::Get()->Now() >= next_ping;
+      if (ping) {
+        estimator.SchedulePing();
+        estimator.StartPing();
+      }
+      estimator.AddIncomingBytes(static_cast<int64_t>(std::min(window, bdp)));
+      AdvanceFakeTime(rtt);
+      if (ping) {
+        next_ping = estimator.CompletePing();
+        double target =
+            delivery_rate
+                ? std::max(estimator.delivery_rate().TargetWindow(),
+                           double(grpc_core::chttp2::kDefaultWindow))
+                : pid_window.Update();
+        window = grpc_core::Clamp(
+            target, double(grpc_core::chttp2::kMinInitialWindowSize),
+            double(grpc_core::chttp2::kMaxInitialWindowSize));
+      }
+    }
+    total_rounds += rounds;
+  }
+  gpr_now_impl = real_now;
+  state.counters["rtts_to_full"] = benchmark::Counter(
+      static_cast<double>(total_rounds), benchmark::Counter::kAvgIterations);
+  state.counters["ms_to_full"] =
+      benchmark::Counter(static_cast<double>(total_rounds) * rtt * 1000,
+                         benchmark::Counter::kAvgIterations);
+}
+
+static void FlowControlRampArgs(benchmark::internal::Benchmark* b) {
+  for (int delivery_rate = 0; delivery_rate <= 1; ++delivery_rate) {
+    for (int rtt_ms : {1, 20, 80, 200}) {
+      for (int mbps : {100, 1000}) {
+        b->Args({delivery_rate, rtt_ms, mbps});
+      }
+    }
+  }
+}
+BENCHMARK(BM_FlowControlRamp)->Apply(FlowControlRampArgs);
+
+}  // namespace testing
+}  // namespace grpc
+
+// Some distros have RunSpecifiedBenchmarks under the benchmark namespace,
+// and others do not. This allows us to support both modes.
+namespace benchmark {
+void RunTheBenchmarksNamespaced() { RunSpecifiedBenchmarks(); }
+}  // namespace benchmark
+
+int main(int argc, char** argv) {
+  grpc::testing::TestEnvironment env(&argc, argv);
+  LibraryInitializer libInit;
+  ::benchmark::Initialize(&argc, argv);
+  grpc::testing::InitTest(&argc, &argv, false);
+
+  // Simulated time must not be observed by the timer threads.
+  grpc_timer_manager_set_threading(false);
+  benchmark::RunTheBenchmarksNamespaced();
+  grpc_timer_manager_set_threading(true);
+  return 0;
+}
@@ -0,0 +1,82 @@
+/*
+ *
+ * Copyright 2022 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+/* Benchmark gRPC end2end streaming over TLS */
+
+#include <grpcpp/security/credentials.h>
+#include <grpcpp/security/server_credentials.h>
+
+#include "test/core/end2end/data/ssl_test_data.h"
+#include "test/core/util/test_config.h"
+#include "test/cpp/microbenchmarks/fullstack_streaming_pump.h"
+#include "test/cpp/util/test_config.h"
+
+namespace grpc {
+namespace testing {
+
+static FixtureCredentials TlsCredentials() {
+  FixtureCredentials credentials;
+  SslServerCredentialsOptions server_options;
+  server_options.pem_key_cert_pairs.push_back(
+      {test_server1_key, test_server1_cert});
+  credentials.server = SslServerCredentials(server_options);
+  SslCredentialsOptions channel_options;
+  channel_options.pem_root_certs = test_root_cert;
+  credentials.channel = SslCredentials(channel_options);
+  credentials.ssl_target_name_override = "foo.test.google.fr";
+  return credentials;
+}
+
+class TLS : public TCP {
+ public:
+  explicit TLS(Service* service,
+               const FixtureConfiguration& fixture_configuration =
+                   FixtureConfiguration())
+      : TCP(service, fixture_configuration, TlsCredentials()) {}
+};
+
+typedef MinStackize<TLS> MinTLS;
+
+/*******************************************************************************
+ * CONFIGURATIONS
+ */
+
+BENCHMARK_TEMPLATE(BM_PumpStreamClientToServer, TLS)
+    ->Range(0, 128 * 1024 * 1024);
+BENCHMARK_TEMPLATE(BM_PumpStreamServerToClient, TLS)
+    ->Range(0, 128 * 1024 * 1024);
+BENCHMARK_TEMPLATE(BM_PumpStreamClientToServer, MinTLS)->Arg(0);
+BENCHMARK_TEMPLATE(BM_PumpStreamServerToClient, MinTLS)->Arg(0);
+
+}  // namespace testing
+}  // namespace grpc
+
+// Some distros have RunSpecifiedBenchmarks under the benchmark namespace,
+// and others do not. This allows us to support both modes.
+namespace benchmark {
+void RunTheBenchmarksNamespaced() { RunSpecifiedBenchmarks(); }
+}  // namespace benchmark
+
+int main(int argc, char** argv) {
+  grpc::testing::TestEnvironment env(&argc, argv);
+  LibraryInitializer libInit;
+  ::benchmark::Initialize(&argc, argv);
+  grpc::testing::InitTest(&argc, &argv, false);
+  benchmark::RunTheBenchmarksNamespaced();
+  return 0;
+}
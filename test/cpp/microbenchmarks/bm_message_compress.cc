@@ -0,0 +1,158 @@
+/*
+ *
+ * Copyright 2022 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+/* Benchmark message compression ratio and throughput for each algorithm that
+ * is built in, over protobuf-like messages of typical RPC sizes. */
+
+#include <string.h>
+
+#include <string>
+
+#include <benchmark/benchmark.h>
+
+#include <grpc/compression.h>
+#include <grpc/slice_buffer.h>
+
+#include "src/core/lib/compression/message_compress.h"
+#include "src/core/lib/iomgr/exec_ctx.h"
+#include "test/core/util/test_config.h"
+#include "test/cpp/microbenchmarks/helpers.h"
+#include "test/cpp/util/test_config.h"
+
+namespace grpc {
+namespace testing {
+
+// Builds a message of about 'size' bytes shaped like a serialized protobuf:
+// tagged varints, short repeated strings and some incompressible bytes.
+static std::string MakeMessage(size_t size) {
+  static const char* const kWords[] = {"user",   "account", "status",
+                                       "active", "region",  "us-east-1",
+                                       "reader", "writer",  "timestamp"};
+  std::string message;
+  uint32_t rng = 12345;
+  auto next = [&rng]() {
+    rng = rng * 1103515245 + 12345;
+    return rng >> 16;
+  };
+  while (message.size() < size) {
+    switch (next() % 3) {
+      case 0:  // varint field
+        message.push_back(0x08);
+        message.push_back(static_cast<char>(next() & 0x7f));
+        break;
+      case 1: {  // string field
+        const char* word = kWords[next() % GPR_ARRAY_SIZE(kWords)];
+        message.push_back(0x12);
+        message.push_back(static_cast<char>(strlen(word)));
+        message += word;
+        break;
+      }
+      case 2:  // bytes field
+        message.push_back(0x1a);
+        message.push_back(8);
+        for (int i = 0; i < 8; i++) {
+          message.push_back(static_cast<char>(next()));
+        }
+        break;
+    }
+  }
+  message.resize(size);
+  return message;
+}
+
+static void BM_MessageCompress(benchmark::State& state) {
+  auto algorithm = static_cast<grpc_compression_algorithm>(state.range(0));
+  std::string message = MakeMessage(state.range(1));
+  grpc_core::ExecCtx exec_ctx;
+  grpc_slice_buffer input;
+  grpc_slice_buffer output;
+  grpc_slice_buffer_init(&input);
+  grpc_slice_buffer_init(&output);
+  grpc_slice_buffer_add(&input, grpc_slice_from_copied_buffer(
+                                    message.data(), message.size()));
+  size_t compressed_size = 0;
+  for (auto _ : state) {
+    grpc_msg_compress(algorithm, &input, &output);
+    compressed_size = output.length;
+    grpc_slice_buffer_reset_and_unref(&output);
+  }
+  state.SetBytesProcessed(state.iterations() * message.size());
+  state.counters["ratio"] =
+      static_cast<double>(message.size()) / compressed_size;
+  grpc_slice_buffer_destroy(&input);
+  grpc_slice_buffer_destroy(&output);
+}
+
+static void BM_MessageDecompress(benchmark::State& state) {
+  auto algorithm = static_cast<grpc_compression_algorithm>(state.range(0));
+  std::string message = MakeMessage(state.range(1));
+  grpc_core::ExecCtx exec_ctx;
+  grpc_slice_buffer input;
+  grpc_slice_buffer compressed;
+  grpc_slice_buffer output;
+  grpc_slice_buffer_init(&input);
+  grpc_slice_buffer_init(&compressed);
+  grpc_slice_buffer_init(&output);
+  grpc_slice_buffer_add(&input, grpc_slice_from_copied_buffer(
+                                    message.data(), message.size()));
+  if (!grpc_msg_compress(algorithm, &input, &compressed)) {
+    algorithm = GRPC_COMPRESS_NONE;
+  }
+  for (auto _ : state) {
+    GPR_ASSERT(grpc_msg_decompress(algorithm, &compressed, &output));
+    grpc_slice_buffer_reset_and_unref(&output);
+  }
+  state.SetBytesProcessed(state.iterations() * message.size());
+  grpc_slice_buffer_destroy(&input);
+  grpc_slice_buffer_destroy(&compressed);
+  grpc_slice_buffer_destroy(&output);
+}
+
+static void CompressionArgs(benchmark::internal::Benchmark* b) {
+  for (int algorithm = GRPC_COMPRESS_DEFLATE;
+       algorithm < GRPC_COMPRESS_ALGORITHMS_COUNT; algorithm++) {
+    if (!grpc_core::CompressionAlgorithmSet::Supported().IsSet(
+            static_cast<grpc_compression_algorithm>(algorithm))) {
+      continue;
+    }
+    for (int size = 4 * 1024; size <= 64 * 1024; size *= 4) {
+      b->Args({algorithm, size});
+    }
+  }
+}
+BENCHMARK(BM_MessageCompress)->Apply(CompressionArgs);
+BENCHMARK(BM_MessageDecompress)->Apply(CompressionArgs);
+
+}  // namespace testing
+}  // namespace grpc
+
+// Some distros have RunSpecifiedBenchmarks under the benchmark namespace,
+// and others do not. This allows us to support both modes.
+namespace benchmark {
+void RunTheBenchmarksNamespaced() { RunSpecifiedBenchmarks(); }
+}  // namespace benchmark
+
+int main(int argc, char** argv) {
+  grpc::testing::TestEnvironment env(&argc, argv);
+  LibraryInitializer libInit;
+  ::benchmark::Initialize(&argc, argv);
+  grpc::testing::InitTest(&argc, &argv, false);
+
+  benchmark::RunTheBenchmarksNamespaced();
+  return 0;
+}
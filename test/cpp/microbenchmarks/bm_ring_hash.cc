@@ -0,0 +1,128 @@
+/*
+ *
+ * Copyright 2022 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+/* Benchmark building ring_hash lookup tables and looking up request hashes
+ * in them, for the ketama ring and the Maglev table. */
+
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "absl/strings/str_cat.h"
+
+#include "src/core/ext/filters/client_channel/lb_policy/ring_hash/ring_hash.h"
+#include "test/core/util/test_config.h"
+#include "test/cpp/microbenchmarks/helpers.h"
+#include "test/cpp/util/test_config.h"
+
+namespace grpc {
+namespace testing {
+
+// Defaults of the ring_hash policy config.
+constexpr size_t kMinRingSize = 1024;
+constexpr size_t kMaxRingSize = 8388608;
+
+static std::vector<grpc_core::RingHashEndpoint> MakeEndpoints(size_t count) {
+  std::vector<grpc_core::RingHashEndpoint> endpoints(count);
+  for (size_t i = 0; i < count; ++i) {
+    endpoints[i].key =
+        absl::StrCat("10.", (i >> 16) & 0xff, ".", (i >> 8) & 0xff, ".",
+                     i & 0xff, ":443");
+  }
+  return endpoints;
+}
+
+// Maglev tables should be about 100 times larger than the number of
+// endpoints, and must be prime.
+static size_t MaglevTableSize(size_t num_endpoints) {
+  if (num_endpoints <= 1000) return 100003;
+  if (num_endpoints <= 10000) return 1000003;
+  return 8388593;
+}
+
+static grpc_core::RingHashTable MakeTable(bool maglev, size_t num_endpoints) {
+  auto endpoints = MakeEndpoints(num_endpoints);
+  if (maglev) {
+    return grpc_core::RingHashTable::MakeMaglev(
+        endpoints, MaglevTableSize(num_endpoints));
+  }
+  return grpc_core::RingHashTable::MakeRing(endpoints, kMinRingSize,
+                                            kMaxRingSize);
+}
+
+static void BM_RingHashTableBuild(benchmark::State& state) {
+  const bool maglev = state.range(0) != 0;
+  auto endpoints = MakeEndpoints(state.range(1));
+  size_t table_size = 0;
+  for (auto _ : state) {
+    grpc_core::RingHashTable table =
+        maglev ? grpc_core::RingHashTable::MakeMaglev(
+                     endpoints, MaglevTableSize(endpoints.size()))
+               : grpc_core::RingHashTable::MakeRing(endpoints, kMinRingSize,
+                                                    kMaxRingSize);
+    table_size = table.size();
+    benchmark::DoNotOptimize(table_size);
+  }
+  state.counters["table_size"] = table_size;
+}
+
+static void BM_RingHashTableLookup(benchmark::State& state) {
+  const grpc_core::RingHashTable table =
+      MakeTable(state.range(0) != 0, state.range(1));
+  uint64_t hash = 0x9e3779b97f4a7c15;
+  for (auto _ : state) {
+    // Vary the hash so that lookups do not all hit the same cache lines.
+    hash ^= hash << 13;
+    hash ^= hash >> 7;
+    hash ^= hash << 17;
+    benchmark::DoNotOptimize(table.endpoint_index(table.Lookup(hash)));
+  }
+}
+
+static void RingHashTableArgs(benchmark::internal::Benchmark* b) {
+  for (int maglev = 0; maglev <= 1; ++maglev) {
+    for (int num_endpoints = 1000; num_endpoints <= 100000;
+         num_endpoints *= 10) {
+      b->Args({maglev, num_endpoints});
+    }
+  }
+}
+BENCHMARK(BM_RingHashTableBuild)
+    ->Apply(RingHashTableArgs)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_RingHashTableLookup)->Apply(RingHashTableArgs);
+
+}  // namespace testing
+}  // namespace grpc
+
+// Some distros have RunSpecifiedBenchmarks under the benchmark namespace,
+// and others do not. This allows us to support both modes.
+namespace benchmark {
+void RunTheBenchmarksNamespaced() { RunSpecifiedBenchmarks(); }
+}  // namespace benchmark
+
+int main(int argc, char** argv) {
+  grpc::testing::TestEnvironment env(&argc, argv);
+  LibraryInitializer libInit;
+  ::benchmark::Initialize(&argc, argv);
+  grpc::testing::InitTest(&argc, &argv, false);
+
+  benchmark::RunTheBenchmarksNamespaced();
+  return 0;
+}
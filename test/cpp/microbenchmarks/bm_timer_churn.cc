@@ -0,0 +1,126 @@
+/*
+ *
+ * Copyright 2022 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+/* Benchmark grpc_timer set/cancel churn with many outstanding deadlines, as on
+ * a server where nearly every call deadline is cancelled before it expires. */
+
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "src/core/lib/gprpp/time.h"
+#include "src/core/lib/iomgr/exec_ctx.h"
+#include "src/core/lib/iomgr/timer.h"
+#include "src/core/lib/iomgr/timer_manager.h"
+#include "test/core/util/test_config.h"
+#include "test/cpp/microbenchmarks/helpers.h"
+#include "test/cpp/util/test_config.h"
+
+extern grpc_timer_vtable grpc_generic_timer_vtable;
+extern grpc_timer_vtable grpc_wheel_timer_vtable;
+
+namespace grpc {
+namespace testing {
+
+static grpc_timer_vtable* TimerImpl(int64_t backend) {
+  return backend == 0 ? &grpc_generic_timer_vtable : &grpc_wheel_timer_vtable;
+}
+
+static uint64_t NextRandom(uint64_t* state) {
+  *state ^= *state << 13;
+  *state ^= *state >> 7;
+  *state ^= *state << 17;
+  return *state;
+}
+
+// Deadlines between 1 and 60 seconds out, so that nothing expires while the
+// benchmark runs.
+static grpc_core::Timestamp RandomDeadline(grpc_core::Timestamp now,
+                                           uint64_t* rng) {
+  return now +
+         grpc_core::Duration::Milliseconds(1000 + NextRandom(rng) % 59000);
+}
+
+static void DoNothing(void* /*arg*/, grpc_error_handle /*error*/) {}
+
+// Each iteration cancels a random outstanding timer and sets it again with a
+// new deadline.
+static void BM_TimerChurn(benchmark::State& state) {
+  grpc_timer_vtable* impl = TimerImpl(state.range(0));
+  const size_t outstanding = state.range(1);
+  grpc_core::ExecCtx exec_ctx;
+  impl->list_init();
+  std::vector<grpc_timer> timers(outstanding);
+  std::vector<grpc_closure> closures(outstanding);
+  uint64_t rng = 0x9e3779b97f4a7c15;
+  const grpc_core::Timestamp now = grpc_core::ExecCtx::Get()->Now();
+  for (size_t i = 0; i < outstanding; i++) {
+    GRPC_CLOSURE_INIT(&closures[i], DoNothing, nullptr,
+                      grpc_schedule_on_exec_ctx);
+    impl->init(&timers[i], RandomDeadline(now, &rng), &closures[i]);
+  }
+  for (auto _ : state) {
+    size_t victim = NextRandom(&rng) % outstanding;
+    impl->cancel(&timers[victim]);
+    // Run the cancelled closure before it is scheduled again.
+    grpc_core::ExecCtx::Get()->Flush();
+    impl->init(&timers[victim], RandomDeadline(now, &rng), &closures[victim]);
+  }
+  impl->list_shutdown();
+  grpc_core::ExecCtx::Get()->Flush();
+}
+
+static void TimerChurnArgs(benchmark::internal::Benchmark* b) {
+  for (int backend = 0; backend <= 1; ++backend) {
+    for (int outstanding = 1 << 10; outstanding <= 1 << 22; outstanding <<= 3) {
+      b->Args({backend, outstanding});
+    }
+  }
+}
+BENCHMARK(BM_TimerChurn)->Apply(TimerChurnArgs);
+
+}  // namespace testing
+}  // namespace grpc
+
+// Some distros have RunSpecifiedBenchmarks under the benchmark namespace,
+// and others do not. This allows us to support both modes.
+namespace benchmark {
+void RunTheBenchmarksNamespaced() { RunSpecifiedBenchmarks(); }
+}  // namespace benchmark
+
+int main(int argc, char** argv) {
+  grpc::testing::TestEnvironment env(&argc, argv);
+  LibraryInitializer libInit;
+  ::benchmark::Initialize(&argc, argv);
+  grpc::testing::InitTest(&argc, &argv, false);
+
+  // The benchmarks bring up their own timer lists, so park the timer threads
+  // and the library's list for the duration.
+  grpc_timer_manager_set_threading(false);
+  {
+    grpc_core::ExecCtx exec_ctx;
+    grpc_timer_list_shutdown();
+  }
+  benchmark::RunTheBenchmarksNamespaced();
+  {
+    grpc_core::ExecCtx exec_ctx;
+    grpc_timer_list_init();
+  }
+  grpc_timer_manager_set_threading(true);
+  return 0;
+}
@@ -63,13 +63,24 @@ class FixtureConfiguration {
 
 class BaseFixture : public TrackCounters {};
 
+// Credentials of a FullstackFixture's server and channel.
+struct FixtureCredentials {
+  std::shared_ptr<ServerCredentials> server = InsecureServerCredentials();
+  std::shared_ptr<ChannelCredentials> channel = InsecureChannelCredentials();
+  // Name the server's certificate is issued for, if it differs from the
+  // address.
+  std::string ssl_target_name_override;
+};
+
 class FullstackFixture : public BaseFixture {
  public:
-  FullstackFixture(Service* service, const FixtureConfiguration& config,
-                   const std::string& address) {
+  FullstackFixture(
+      Service* service, const FixtureConfiguration& config,
+      const std::string& address,
+      const FixtureCredentials& credentials = FixtureCredentials()) {
     ServerBuilder b;
     if (address.length() > 0) {
-      b.AddListeningPort(address, InsecureServerCredentials());
+      b.AddListeningPort(address, credentials.server);
     }
     cq_ = b.AddCompletionQueue(true);
     b.RegisterService(service);
@@ -77,9 +88,11 @@ class FullstackFixture : public BaseFixture {
     server_ = b.BuildAndStart();
     ChannelArguments args;
     config.ApplyCommonChannelArguments(&args);
+    if (!credentials.ssl_target_name_override.empty()) {
+      args.SetSslTargetNameOverride(credentials.ssl_target_name_override);
+    }
     if (address.length() > 0) {
-      channel_ = grpc::CreateCustomChannel(address,
-                                           InsecureChannelCredentials(), args);
+      channel_ = grpc::CreateCustomChannel(address, credentials.channel, args);
     } else {
       channel_ = server_->InProcessChannel(args);
     }
@@ -114,8 +127,10 @@ class TCP : public FullstackFixture {
  public:
   explicit TCP(Service* service,
                const FixtureConfiguration& fixture_configuration =
-                   FixtureConfiguration())
-      : FullstackFixture(service, fixture_configuration, MakeAddress(&port_)) {}
+                   FixtureConfiguration(),
+               const FixtureCredentials& credentials = FixtureCredentials())
+      : FullstackFixture(service, fixture_configuration, MakeAddress(&port_),
+                         credentials) {}
 
   ~TCP() override { grpc_recycle_unused_port(port_); }
 
@@ -315,6 +315,15 @@ def massage_qps_stats(scenario_result):
             stats[
                 "core_cq_ev_queue_transient_pop_failures"] = massage_qps_stats_helpers.counter(
                     core_stats, "cq_ev_queue_transient_pop_failures")
+            stats[
+                "core_ssl_session_cache_hits"] = massage_qps_stats_helpers.counter(
+                    core_stats, "ssl_session_cache_hits")
+            stats[
+                "core_ssl_session_cache_misses"] = massage_qps_stats_helpers.counter(
+                    core_stats, "ssl_session_cache_misses")
+            stats[
+                "core_ssl_session_cache_evictions"] = massage_qps_stats_helpers.counter(
+                    core_stats, "ssl_session_cache_evictions")
             h = massage_qps_stats_helpers.histogram(core_stats,
                                                     "call_initial_size")
             stats["core_call_initial_size"] = ",".join(